@@ -196,31 +196,35 @@ bool LoadCustomScene(Scene& scene, Camera& camera)
 
     // heterogenous absorption medium
     {
-        auto densityBitmap = helpers::LoadBitmapObject(gOptions.dataPath, "TEXTURES/Volume/Clouds/wdas_cloud_half.vdb");
-        //auto densityBitmap = helpers::LoadBitmapObject(gOptions.dataPath, "TEXTURES/Volume/sphere.vdb");
-
-        const float density = 20.0f;
-        const Vec4f scattering = Vec4f(1.0f, 1.0f, 1.0f) * density;
-        const Vec4f attenuation = Vec4f(0.0f, 0.0f, 0.0f) * density;
-
-        const Vec4f extintion = attenuation + scattering;
-        const Vec4f scatteringAlbedo(0.65f, 0.53f, 0.351f);
-
-        const Plane plane(Vec4f(0.0f, 1.0f, 0.0f), Vec4f(0.0f, 0.0f, 0.0f));
-        TexturePtr texture = MakeSharedPtr<BitmapTexture3D>(densityBitmap);
-        //TexturePtr texture = MakeSharedPtr<NoiseTexture3D>(Vec4f(0.0f, 0.0f, 0.0f), Vec4f(1.0f, 1.0f, 1.0f), 5);
-        //TexturePtr texture = MakeSharedPtr<CheckerboardTexture>(Vec4f(0.0f, 0.0f, 0.0f), Vec4f(1.0f, 1.0f, 1.0f));
-        //TexturePtr texture = MakeSharedPtr<GradientTexture>(Vec4f(0.1f, 0.2, 0.3f), Vec4f(0.0f), plane, 11.0f);
-        ShapePtr shape = MakeUniquePtr<BoxShape>(Vec4f(1.25f, 0.85f, 1.53f));
-
-        //MediumPtr medium = MakeUniquePtr<HeterogeneousAbsorptiveMedium>(texture, extintion);
-        //MediumPtr medium = MakeUniquePtr<HomogenousAbsorptiveMedium>(Vec4f(1.0f, 0.5f, 0.25f));
-        MediumPtr medium = MakeUniquePtr<HeterogeneousScatteringMedium>(texture, extintion, scatteringAlbedo);
-
-        auto object = MakeUniquePtr<ShapeSceneObject>(std::move(shape));
-        object->BindMedium(medium);
-        object->SetTransform(Matrix4::MakeTranslation(Vec4f(0.0f, 0.0f, 0.0f)));
-        scene.AddObject(std::move(object));
+        const String densityVolumePath = gOptions.dataPath.ToView() + StringView("TEXTURES/Volume/Clouds/wdas_cloud_half.vdb");
+        //const String densityVolumePath = gOptions.dataPath.ToView() + StringView("TEXTURES/Volume/sphere.vdb");
+        SparseVolumePtr densityVolume = MakeSharedPtr<SparseVolume>(densityVolumePath.Str());
+        // the medium is skipped if the volume is missing (error is already logged)
+        if (densityVolume->Load(densityVolumePath.Str()))
+        {
+            const float density = 20.0f;
+            const Vec4f scattering = Vec4f(1.0f, 1.0f, 1.0f) * density;
+            const Vec4f attenuation = Vec4f(0.0f, 0.0f, 0.0f) * density;
+
+            const Vec4f extintion = attenuation + scattering;
+            const Vec4f scatteringAlbedo(0.65f, 0.53f, 0.351f);
+
+            const Plane plane(Vec4f(0.0f, 1.0f, 0.0f), Vec4f(0.0f, 0.0f, 0.0f));
+            TexturePtr texture = MakeSharedPtr<BitmapTexture3D>(densityVolume);
+            //TexturePtr texture = MakeSharedPtr<NoiseTexture3D>(Vec4f(0.0f, 0.0f, 0.0f), Vec4f(1.0f, 1.0f, 1.0f), 5);
+            //TexturePtr texture = MakeSharedPtr<CheckerboardTexture>(Vec4f(0.0f, 0.0f, 0.0f), Vec4f(1.0f, 1.0f, 1.0f));
+            //TexturePtr texture = MakeSharedPtr<GradientTexture>(Vec4f(0.1f, 0.2, 0.3f), Vec4f(0.0f), plane, 11.0f);
+            ShapePtr shape = MakeUniquePtr<BoxShape>(Vec4f(1.25f, 0.85f, 1.53f));
+
+            //MediumPtr medium = MakeUniquePtr<HeterogeneousAbsorptiveMedium>(texture, extintion);
+            //MediumPtr medium = MakeUniquePtr<HomogenousAbsorptiveMedium>(Vec4f(1.0f, 0.5f, 0.25f));
+            MediumPtr medium = MakeUniquePtr<HeterogeneousScatteringMedium>(texture, extintion, scatteringAlbedo);
+
+            auto object = MakeUniquePtr<ShapeSceneObject>(std::move(shape));
+            object->BindMedium(medium);
+            object->SetTransform(Matrix4::MakeTranslation(Vec4f(0.0f, 0.0f, 0.0f)));
+            scene.AddObject(std::move(object));
+        }
     }
 
     /*
@@ -17,6 +17,8 @@ struct Options
     Common::String dataPath;
 
     bool enablePacketTracing = false;
+    bool useLargePages = false;
+    bool trackMemory = false;
     Common::String rendererName{ "Path Tracer" };
 
     Common::String sceneName;
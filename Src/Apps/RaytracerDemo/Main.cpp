@@ -3,6 +3,7 @@
 
 #include "Engine/Common/Logger/Logger.hpp"
 #include "Engine/Common/FileSystem/FileSystem.hpp"
+#include "Engine/Common/Memory/DefaultAllocator.hpp"
 
 #include <cxxopts.hpp>
 
@@ -21,6 +22,8 @@ bool ParseOptions(int argc, char** argv, Options& outOptions)
         ("renderer", "Renderer name", cxxopts::value<std::string>())
         ("p,packet-tracing", "Use ray packet tracing by default", cxxopts::value<bool>())
         ("data", "Data path", cxxopts::value<std::string>())
+        ("large-pages", "Use large (huge) pages for big buffers", cxxopts::value<bool>())
+        ("track-memory", "Track memory usage per subsystem and report it on exit", cxxopts::value<bool>())
         ;
 
     try
@@ -43,6 +46,8 @@ bool ParseOptions(int argc, char** argv, Options& outOptions)
             outOptions.rendererName = result["renderer"].as<std::string>().c_str();
 
         outOptions.enablePacketTracing = result["p"].count() > 0;
+        outOptions.useLargePages = result["large-pages"].count() > 0;
+        outOptions.trackMemory = result["track-memory"].count() > 0;
     }
     catch (cxxopts::OptionParseException& e)
     {
@@ -78,6 +83,16 @@ int main(int argc, char* argv[])
         return 1;
     }
 
+    if (gOptions.useLargePages)
+    {
+        NFE::Common::DefaultAllocator::GetInstance().EnableLargePages();
+    }
+
+    if (gOptions.trackMemory)
+    {
+        NFE::Common::DefaultAllocator::GetInstance().EnableTracking(true);
+    }
+
     {
         DemoWindow demo;
 
@@ -96,6 +111,12 @@ int main(int argc, char* argv[])
 
     NFE_LOG_INFO("Closing.");
 
+    if (gOptions.trackMemory)
+    {
+        // the scene and the viewport are already destroyed, so their tags should not hold any memory
+        NFE::Common::DefaultAllocator::GetInstance().ReportAllocations();
+    }
+
     NFE::Common::ShutdownSubsystems();
 
     NFE_ASSERT(Math::GetFlushDenormalsToZero(), "Something disabled flushing denormal float to zero");
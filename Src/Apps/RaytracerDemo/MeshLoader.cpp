@@ -2,6 +2,7 @@
 #include "MeshLoader.h"
 
 #include "Engine/Raytracer/Utils/Bitmap.h"
+#include "Engine/Raytracer/Utils/BitmapLoader.h"
 #include "Engine/Raytracer/Textures/BitmapTexture.h"
 #include "Engine/Common/Logger/Logger.hpp"
 #include "Engine/Common/System/Timer.hpp"
@@ -35,33 +36,35 @@ struct TriangleIndicesHash
     }
 };
 
-BitmapPtr LoadBitmapObject(const StringView& baseDir, const StringView& path)
-{
-    if (path.Empty())
-    {
-        return nullptr;
-    }
+// all bitmaps are loaded via single loader, so each file is loaded only once
+static BitmapLoader gBitmapLoader;
 
+static String ResolveBitmapPath(const StringView& baseDir, const StringView& path)
+{
     String fullPath = baseDir + path;
     if (fullPath.ToView().EndsWith(StringView(".png")) || fullPath.ToView().EndsWith(StringView(".jpg")))
     {
         fullPath.Replace(fullPath.Length() - 4, 4, ".bmp");
     }
+    return fullPath;
+}
 
-    // cache bitmaps so they are loaded only once
-    static HashMap<String, BitmapPtr> bitmapsList;
-    BitmapPtr& bitmapPtr = bitmapsList.Insert(fullPath, BitmapPtr()).iterator->second;
+void RequestBitmap(const StringView& baseDir, const StringView& path)
+{
+    if (!path.Empty())
+    {
+        gBitmapLoader.Request(ResolveBitmapPath(baseDir, path));
+    }
+}
 
-    if (!bitmapPtr)
+BitmapPtr LoadBitmapObject(const StringView& baseDir, const StringView& path)
+{
+    if (path.Empty())
     {
-        bitmapPtr = MakeSharedPtr<Bitmap>(fullPath.Str());
-        if (!bitmapPtr->Load(fullPath.Str()))
-        {
-            return nullptr;
-        }
+        return nullptr;
     }
 
-    return bitmapPtr;
+    return gBitmapLoader.Get(ResolveBitmapPath(baseDir, path));
 }
 
 TexturePtr LoadTexture(const StringView& baseDir, const StringView& path)
@@ -260,6 +263,14 @@ public:
 
         ComputeTangentVectors();
 
+        // start loading all textures in parallel
+        for (const tinyobj::material_t& material : materials)
+        {
+            RequestBitmap(meshBaseDir, material.diffuse_texname.c_str());
+            RequestBitmap(meshBaseDir, material.normal_texname.c_str());
+            RequestBitmap(meshBaseDir, material.alpha_texname.c_str());
+        }
+
         // load materials
         mMaterialPointers.Reserve((uint32)materials.size());
         for (size_t i = 0; i < materials.size(); i++)
@@ -10,6 +10,9 @@ namespace helpers {
 
 using MaterialsMap = Common::HashMap<Common::String, RT::MaterialPtr>;
 
+// start loading bitmap in the background
+void RequestBitmap(const Common::StringView& baseDir, const Common::StringView& path);
+
 RT::BitmapPtr LoadBitmapObject(const Common::StringView& baseDir, const Common::StringView& path);
 RT::TexturePtr LoadTexture(const Common::StringView& baseDir, const Common::StringView& path);
 RT::MeshShapePtr LoadMesh(const Common::String& filePath, MaterialsMap& outMaterials, const float scale = 1.0f);
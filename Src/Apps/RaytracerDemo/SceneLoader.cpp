@@ -808,6 +808,17 @@ bool LoadScene(const String& path, Scene& scene, RT::Camera& camera)
         const rapidjson::Value& texturesArray = d["textures"];
         if (texturesArray.IsArray())
         {
+            // start loading all bitmaps in parallel
+            for (rapidjson::SizeType i = 0; i < texturesArray.Size(); i++)
+            {
+                const rapidjson::Value& value = texturesArray[i];
+                if (value.IsObject() && value.HasMember("type") && value["type"].IsString() && strcmp(value["type"].GetString(), "bitmap") == 0 &&
+                    value.HasMember("path") && value["path"].IsString())
+                {
+                    RequestBitmap(gOptions.dataPath, StringView(value["path"].GetString()));
+                }
+            }
+
             for (rapidjson::SizeType i = 0; i < texturesArray.Size(); i++)
             {
                 String name;
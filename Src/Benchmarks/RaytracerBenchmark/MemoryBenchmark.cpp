@@ -1,6 +1,7 @@
 #include "PCH.h"
 #include "../Core/Utils/Memory.h"
 #include "../Core/Utils/MemoryHelpers.h"
+#include "../../Engine/Common/Memory/DefaultAllocator.hpp"
 
 #include <benchmark/benchmark.h>
 
@@ -39,3 +40,46 @@ static void Benchmark_Memcpy_Std(benchmark::State& state)
     DefaultAllocator::Free(src);
 }
 BENCHMARK(Benchmark_Memcpy_Std)->RangeMultiplier(2)->Range(1, 128);
+
+
+// Allocate and free small blocks of mixed sizes, each thread keeps a window of live blocks
+// (so the blocks are not immediately reused), simulating events, shared pointer blocks, components, etc.
+template<typename AllocFunc, typename FreeFunc>
+static void MixedSizeAllocations(benchmark::State& state, const AllocFunc& allocFunc, const FreeFunc& freeFunc)
+{
+    const uint32_t windowSize = 256;
+    void* blocks[windowSize] = { nullptr };
+    uint32_t index = 0;
+
+    for (auto _ : state)
+    {
+        const uint32_t slot = index % windowSize;
+        freeFunc(blocks[slot]);
+        blocks[slot] = allocFunc(16 + (index * 7919u) % 1024u);
+        benchmark::DoNotOptimize(blocks[slot]);
+        index++;
+    }
+
+    for (void* ptr : blocks)
+    {
+        freeFunc(ptr);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void Benchmark_Malloc_Default(benchmark::State& state)
+{
+    MixedSizeAllocations(state,
+        [] (size_t size) { return NFE_MALLOC(size, 16); },
+        [] (void* ptr) { NFE_FREE(ptr); });
+}
+BENCHMARK(Benchmark_Malloc_Default)->ThreadRange(1, 16)->UseRealTime();
+
+static void Benchmark_Malloc_System(benchmark::State& state)
+{
+    MixedSizeAllocations(state,
+        [] (size_t size) { return malloc(size); },
+        [] (void* ptr) { free(ptr); });
+}
+BENCHMARK(Benchmark_Malloc_System)->ThreadRange(1, 16)->UseRealTime();
@@ -2,6 +2,8 @@
 #include "../Core/Math/Packed.h"
 #include "../Core/Math/Random.h"
 #include "../Core/Math/SamplingHelpers.h"
+#include "../Engine/Raytracer/Utils/Bitmap.h"
+#include "../Engine/Common/Containers/DynArray.hpp"
 
 #include <benchmark/benchmark.h>
 
@@ -38,3 +40,69 @@ static void Benchmark_Packed_ColorRgbHdr(benchmark::State& state)
     benchmark::DoNotOptimize(x);
 }
 BENCHMARK(Benchmark_Packed_ColorRgbHdr);
+
+
+// bulk pixel format conversion, argument is the format
+static void Benchmark_Bitmap_DecodePixels(benchmark::State& state)
+{
+    const NFE::RT::Bitmap::Format format = static_cast<NFE::RT::Bitmap::Format>(state.range(0));
+    const uint32_t numPixels = 4096;
+
+    NFE::Common::DynArray<uint8_t> packed;
+    packed.Resize(numPixels * NFE::RT::Bitmap::BitsPerPixel(format) / 8);
+    for (uint32_t i = 0; i < packed.Size(); ++i)
+    {
+        packed[i] = static_cast<uint8_t>(i * 7u);
+    }
+
+    NFE::Common::DynArray<NFE::Math::Vec4f> pixels;
+    pixels.Resize(numPixels);
+
+    for (auto _ : state)
+    {
+        NFE::RT::Bitmap::DecodePixels(format, packed.Data(), pixels.Data(), numPixels);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * numPixels);
+    state.SetLabel(NFE::RT::Bitmap::FormatToString(format));
+}
+
+static void Benchmark_Bitmap_EncodePixels(benchmark::State& state)
+{
+    const NFE::RT::Bitmap::Format format = static_cast<NFE::RT::Bitmap::Format>(state.range(0));
+    const uint32_t numPixels = 4096;
+
+    NFE::Common::DynArray<NFE::Math::Vec4f> pixels;
+    pixels.Resize(numPixels);
+    for (uint32_t i = 0; i < numPixels; ++i)
+    {
+        pixels[i] = NFE::Math::Vec4f(static_cast<float>(i % 256) / 255.0f, 0.5f, 0.25f, 1.0f);
+    }
+
+    NFE::Common::DynArray<uint8_t> packed;
+    packed.Resize(numPixels * NFE::RT::Bitmap::BitsPerPixel(format) / 8);
+
+    for (auto _ : state)
+    {
+        NFE::RT::Bitmap::EncodePixels(format, pixels.Data(), packed.Data(), numPixels);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * numPixels);
+    state.SetLabel(NFE::RT::Bitmap::FormatToString(format));
+}
+
+static void BitmapFormatArguments(benchmark::internal::Benchmark* b)
+{
+    using Format = NFE::RT::Bitmap::Format;
+    for (const Format format : { Format::R8_UNorm, Format::B8G8R8_UNorm, Format::B8G8R8A8_UNorm, Format::R8G8B8A8_UNorm,
+                                 Format::R16_UNorm, Format::R16G16B16A16_UNorm, Format::R32_Float, Format::R11G11B10_Float,
+                                 Format::R16_Half, Format::R16G16B16A16_Half, Format::R9G9B9E5_SharedExp })
+    {
+        b->Arg(static_cast<int>(format));
+    }
+}
+
+BENCHMARK(Benchmark_Bitmap_DecodePixels)->Apply(BitmapFormatArguments);
+BENCHMARK(Benchmark_Bitmap_EncodePixels)->Apply(BitmapFormatArguments);
@@ -8,6 +8,7 @@
 
 #include "ConfigInterface.hpp"
 #include "../Containers/DynArray.hpp"
+#include "../Containers/SegmentedArray.hpp"
 #include "../Containers/UniquePtr.hpp"
 #include "../Containers/String.hpp"
 
@@ -26,10 +27,11 @@ class NFCOMMON_API Config : public IConfig
 
     ConfigObjectNodePtr mRootNode;
 
-    /// Buffers of the config elements:
-    DynArray<ConfigValue> mValues;
-    DynArray<ConfigObjectNode> mObjectNodes;
-    DynArray<ConfigArrayNode> mArrayNodes;
+    /// Buffers of the config elements (segmented, so big configs don't reallocate):
+    static constexpr uint32 ElementsPerSegment = 256;
+    SegmentedArray<ConfigValue, ElementsPerSegment> mValues;
+    SegmentedArray<ConfigObjectNode, ElementsPerSegment> mObjectNodes;
+    SegmentedArray<ConfigArrayNode, ElementsPerSegment> mArrayNodes;
 
     /// Methods for allocations of config elements:
     ConfigValuePtr AllocateValue();
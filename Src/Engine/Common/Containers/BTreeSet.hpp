@@ -0,0 +1,252 @@
+/**
+ * @file
+ * @author Witek902 (witek902@gmail.com)
+ * @brief  BTreeSet data container declaration
+ */
+
+#pragma once
+
+#include "Comparator.hpp"
+
+#include "../nfCommon.hpp"
+
+
+namespace NFE {
+namespace Common {
+
+/**
+ * Sorted set container (like std::set).
+ * Implementation is based on B-tree with wide nodes (about 256 bytes of keys per node), so a lookup
+ * touches only a few cache-friendly nodes instead of O(log n) scattered ones (as in Set).
+ * The API is the same as Set's, so it can be used as a drop-in replacement.
+ *
+ * @note    Unlike in Set, keys are moved between nodes, so iterators are invalidated on insertion and erasure.
+ */
+template<typename KeyType, typename Comparator = DefaultComparator<KeyType>>
+class BTreeSet final
+{
+    struct Node;
+
+public:
+    // maximum number of keys in a node (odd, so a full node can be split evenly)
+    static constexpr uint32 MaxKeys = (256 / sizeof(KeyType) < 3) ? 3u :
+        (256 / sizeof(KeyType) > 127) ? 127u : static_cast<uint32>(((256 / sizeof(KeyType)) - 1) | 1);
+
+    // minimum number of keys in a non-root node
+    static constexpr uint32 MinKeys = MaxKeys / 2;
+
+    // iterator with read-only access
+    class ConstIterator
+    {
+        friend class BTreeSet;
+    public:
+        // C++ standard iterator traits
+        using self_type = ConstIterator;
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = KeyType;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const KeyType*;
+        using reference = const KeyType&;
+
+        NFE_INLINE ConstIterator();
+        NFE_INLINE bool operator == (const ConstIterator& other) const;
+        NFE_INLINE bool operator != (const ConstIterator& other) const;
+        NFE_INLINE const KeyType& operator * () const;
+        NFE_INLINE const KeyType* operator -> () const;
+        NFE_INLINE ConstIterator& operator++();
+        NFE_INLINE ConstIterator operator++(int);
+    private:
+        NFE_INLINE ConstIterator(const BTreeSet* set, Node* node, uint32 index);
+        const BTreeSet* mSet;   // set we are iterating
+        Node* mNode;            // current node (nullptr for the end)
+        uint32 mIndex;          // key index within the node
+    };
+
+    // iterator with read-write access
+    class Iterator : public ConstIterator
+    {
+        friend class BTreeSet;
+    public:
+        // C++ standard iterator traits
+        using self_type = Iterator;
+        using pointer = KeyType*;
+        using reference = KeyType&;
+
+        NFE_INLINE KeyType& operator * () const;
+        NFE_INLINE KeyType* operator -> () const;
+    private:
+        NFE_INLINE Iterator(const BTreeSet* set, Node* node, uint32 index);
+    };
+
+    // insertion information
+    struct InsertResult final
+    {
+        // iterator to the inserted node
+        const ConstIterator iterator;
+
+        // set to true if the node with given value already existed
+        const bool replaced;
+
+        explicit InsertResult(const ConstIterator& iterator, bool replaced = false)
+            : iterator(iterator)
+            , replaced(replaced)
+        { }
+    };
+
+    // basic constructors and assignment operators
+
+    BTreeSet();
+    ~BTreeSet();
+    BTreeSet(const BTreeSet& other);
+    BTreeSet(BTreeSet&& other);
+    BTreeSet& operator = (const BTreeSet& other);
+    BTreeSet& operator = (BTreeSet&& other);
+
+    /**
+     * Get number of inserted values.
+     */
+    NFE_INLINE uint32 Size() const { return mSize; }
+
+    /**
+     * Check if the set is empty.
+     */
+    NFE_INLINE bool Empty() const { return mSize == 0; }
+
+    /**
+     * Remove all the values and free allocated memory.
+     */
+    void Clear();
+
+    /**
+     * Get iterator to the beginning (smallest value).
+     * @note    This operation takes O(log n) time.
+     */
+    ConstIterator Begin() const;
+    Iterator Begin();
+
+    /**
+     * Get iterator to the end (one past the highest value).
+     * @note    This operation takes O(1) time.
+     */
+    NFE_INLINE ConstIterator End() const;
+    NFE_INLINE Iterator End();
+
+    /**
+     * Find element by value.
+     * @note    This operation takes O(log n) time.
+     * @return  Iterator to the found element, or iterator to the end if the element does not exist.
+     */
+    ConstIterator Find(const KeyType& key) const;
+    Iterator Find(const KeyType& key);
+
+    /**
+     * Check if a given key exists.
+     * @note    This operation takes O(log n) time.
+     */
+    bool Exists(const KeyType& key) const;
+
+    /**
+     * Insert a new element to the set.
+     * @note    This operation takes O(log n) time.
+     * @note    If the element already existed, the method will fail.
+     * @return  Structure with insertion information.
+     */
+    InsertResult Insert(const KeyType& key);
+    InsertResult Insert(KeyType&& key);
+
+    /**
+     * Insert a new element to the set or replace existing.
+     * @note    This operation takes O(log n) time.
+     * @return  Structure with insertion information.
+     */
+    InsertResult InsertOrReplace(const KeyType& key);
+    InsertResult InsertOrReplace(KeyType&& key);
+
+    /**
+     * Erase an element by value.
+     * @note    This operation takes O(log n) time.
+     * @return  True if the element was found and has been removed.
+     */
+    bool Erase(const KeyType& key);
+
+    /**
+     * Erase an element by iterator.
+     * @note    This operation takes O(log n) time.
+     * @return  True if the element has been removed.
+     */
+    bool Erase(const ConstIterator& iterator);
+
+    // lower-case aliases for Begin()/End(), required by C++
+    NFE_INLINE ConstIterator begin() const { return Begin(); }
+    NFE_INLINE ConstIterator end() const { return End(); }
+    NFE_INLINE Iterator begin() { return Begin(); }
+    NFE_INLINE Iterator end() { return End(); }
+
+    /**
+     * Verify internal tree structure. For debugging only.
+     */
+    bool Verify() const;
+
+private:
+
+    // tree node (leaf nodes are allocated without children array)
+    struct Node
+    {
+        Node* parent;
+        uint8 parentIndex;      // index in parent's children array
+        uint8 numKeys;
+        bool isLeaf;
+        alignas(KeyType) uint8 keysStorage[MaxKeys * sizeof(KeyType)];
+
+        NFE_FORCE_INLINE KeyType* Keys() { return reinterpret_cast<KeyType*>(keysStorage); }
+        NFE_FORCE_INLINE const KeyType* Keys() const { return reinterpret_cast<const KeyType*>(keysStorage); }
+        NFE_FORCE_INLINE Node** Children();
+    };
+
+    struct InternalNode : public Node
+    {
+        Node* children[MaxKeys + 1];
+    };
+
+    Node* mRoot;
+    uint32 mSize;
+
+    Node* AllocateNode(bool isLeaf);
+    void FreeNode(Node* node);
+
+    // destroy keys and free a whole subtree
+    void FreeSubtree(Node* node);
+
+    // deep copy of a subtree
+    Node* CloneSubtree(const Node* source, Node* parent);
+
+    // find first key in a node that is not less than given key
+    NFE_INLINE uint32 LowerBound(const Node* node, const KeyType& key) const;
+
+    // find a key in the tree (returns nullptr node if not found)
+    void FindInternal(const KeyType& key, Node*& outNode, uint32& outIndex) const;
+
+    template<typename KeyTypeRef>
+    InsertResult InsertInternal(KeyTypeRef&& key, bool replace);
+
+    // insert a key (with its right child for internal nodes) into a node, splitting the node if needed
+    template<typename KeyTypeRef>
+    void InsertIntoNode(Node* node, uint32 index, KeyTypeRef&& key, Node* rightChild, Node*& outNode, uint32& outIndex);
+
+    // set child pointer with parent back-link
+    NFE_FORCE_INLINE static void SetChild(Node* node, uint32 index, Node* child);
+
+    // fix underflow of a node after erasure
+    void Rebalance(Node* node);
+
+    // merge child (index + 1) into child (index) along with the separator key
+    void MergeChildren(Node* parent, uint32 index);
+
+    bool VerifyNode(const Node* node, const KeyType* lowerBound, const KeyType* upperBound, uint32 depth, uint32& leafDepth, uint32& numKeys) const;
+};
+
+} // namespace Common
+} // namespace NFE
+
+// BTreeSet class definitions go here:
+#include "BTreeSetImpl.hpp"
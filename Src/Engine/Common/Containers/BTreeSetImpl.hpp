@@ -0,0 +1,840 @@
+/**
+ * @file
+ * @author Witek902 (witek902@gmail.com)
+ * @brief  BTreeSet data container definitions
+ */
+
+#pragma once
+
+#include "BTreeSet.hpp"
+#include "../System/Assertion.hpp"
+#include "../Memory/MemoryHelpers.hpp"
+#include "../Memory/DefaultAllocator.hpp"
+#include "../Logger/Logger.hpp"
+
+
+namespace NFE {
+namespace Common {
+
+
+// BTreeSet::ConstIterator ////////////////////////////////////////////////////////////////////////////
+
+template<typename KeyType, typename Comparator>
+BTreeSet<KeyType, Comparator>::ConstIterator::ConstIterator()
+    : mSet(nullptr)
+    , mNode(nullptr)
+    , mIndex(0)
+{ }
+
+template<typename KeyType, typename Comparator>
+BTreeSet<KeyType, Comparator>::ConstIterator::ConstIterator(const BTreeSet* set, Node* node, uint32 index)
+    : mSet(set)
+    , mNode(node)
+    , mIndex(index)
+{ }
+
+template<typename KeyType, typename Comparator>
+bool BTreeSet<KeyType, Comparator>::ConstIterator::operator == (const ConstIterator& other) const
+{
+    return (mSet == other.mSet) && (mNode == other.mNode) && (mIndex == other.mIndex);
+}
+
+template<typename KeyType, typename Comparator>
+bool BTreeSet<KeyType, Comparator>::ConstIterator::operator != (const ConstIterator& other) const
+{
+    return (mSet != other.mSet) || (mNode != other.mNode) || (mIndex != other.mIndex);
+}
+
+template<typename KeyType, typename Comparator>
+const KeyType& BTreeSet<KeyType, Comparator>::ConstIterator::operator * () const
+{
+    NFE_ASSERT(mNode, "Trying to dereference 'end' iterator");
+    return mNode->Keys()[mIndex];
+}
+
+template<typename KeyType, typename Comparator>
+const KeyType* BTreeSet<KeyType, Comparator>::ConstIterator::operator -> () const
+{
+    NFE_ASSERT(mNode, "Trying to dereference 'end' iterator");
+    return mNode->Keys() + mIndex;
+}
+
+template<typename KeyType, typename Comparator>
+typename BTreeSet<KeyType, Comparator>::ConstIterator& BTreeSet<KeyType, Comparator>::ConstIterator::operator++()
+{
+    if (!mNode) // update only when not pointing to the end
+    {
+        return *this;
+    }
+
+    if (!mNode->isLeaf)
+    {
+        // go to the leftmost key of the right subtree
+        mNode = mNode->Children()[mIndex + 1];
+        while (!mNode->isLeaf)
+        {
+            mNode = mNode->Children()[0];
+        }
+        mIndex = 0;
+    }
+    else if (mIndex + 1 < mNode->numKeys)
+    {
+        mIndex++;
+    }
+    else
+    {
+        // leaf exhausted - go up until we come from a subtree that is not the rightmost one
+        while (mNode->parent && mNode->parentIndex == mNode->parent->numKeys)
+        {
+            mNode = mNode->parent;
+        }
+
+        if (mNode->parent)
+        {
+            mIndex = mNode->parentIndex;
+            mNode = mNode->parent;
+        }
+        else
+        {
+            mNode = nullptr;
+            mIndex = 0;
+        }
+    }
+
+    return *this;
+}
+
+template<typename KeyType, typename Comparator>
+typename BTreeSet<KeyType, Comparator>::ConstIterator BTreeSet<KeyType, Comparator>::ConstIterator::operator++(int)
+{
+    ConstIterator tmp(*this);
+    operator++();
+    return tmp;
+}
+
+
+// BTreeSet::Iterator /////////////////////////////////////////////////////////////////////////////////
+
+template<typename KeyType, typename Comparator>
+BTreeSet<KeyType, Comparator>::Iterator::Iterator(const BTreeSet* set, Node* node, uint32 index)
+    : ConstIterator(set, node, index)
+{ }
+
+template<typename KeyType, typename Comparator>
+KeyType& BTreeSet<KeyType, Comparator>::Iterator::operator * () const
+{
+    NFE_ASSERT(this->mNode, "Trying to dereference 'end' iterator");
+    return this->mNode->Keys()[this->mIndex];
+}
+
+template<typename KeyType, typename Comparator>
+KeyType* BTreeSet<KeyType, Comparator>::Iterator::operator -> () const
+{
+    NFE_ASSERT(this->mNode, "Trying to dereference 'end' iterator");
+    return this->mNode->Keys() + this->mIndex;
+}
+
+
+// BTreeSet ///////////////////////////////////////////////////////////////////////////////////////////
+
+template<typename KeyType, typename Comparator>
+typename BTreeSet<KeyType, Comparator>::Node** BTreeSet<KeyType, Comparator>::Node::Children()
+{
+    NFE_ASSERT(!isLeaf, "Leaf nodes have no children");
+    return static_cast<InternalNode*>(this)->children;
+}
+
+template<typename KeyType, typename Comparator>
+BTreeSet<KeyType, Comparator>::BTreeSet()
+    : mRoot(nullptr)
+    , mSize(0)
+{
+}
+
+template<typename KeyType, typename Comparator>
+BTreeSet<KeyType, Comparator>::~BTreeSet()
+{
+    Clear();
+}
+
+template<typename KeyType, typename Comparator>
+BTreeSet<KeyType, Comparator>::BTreeSet(const BTreeSet& other)
+    : mRoot(nullptr)
+    , mSize(other.mSize)
+{
+    if (other.mRoot)
+    {
+        mRoot = CloneSubtree(other.mRoot, nullptr);
+    }
+}
+
+template<typename KeyType, typename Comparator>
+BTreeSet<KeyType, Comparator>::BTreeSet(BTreeSet&& other)
+    : mRoot(other.mRoot)
+    , mSize(other.mSize)
+{
+    other.mRoot = nullptr;
+    other.mSize = 0;
+}
+
+template<typename KeyType, typename Comparator>
+BTreeSet<KeyType, Comparator>& BTreeSet<KeyType, Comparator>::operator = (const BTreeSet& other)
+{
+    if (this != &other)
+    {
+        Clear();
+
+        if (other.mRoot)
+        {
+            mRoot = CloneSubtree(other.mRoot, nullptr);
+            mSize = other.mSize;
+        }
+    }
+
+    return *this;
+}
+
+template<typename KeyType, typename Comparator>
+BTreeSet<KeyType, Comparator>& BTreeSet<KeyType, Comparator>::operator = (BTreeSet&& other)
+{
+    if (this != &other)
+    {
+        Clear();
+
+        mRoot = other.mRoot;
+        mSize = other.mSize;
+
+        other.mRoot = nullptr;
+        other.mSize = 0;
+    }
+
+    return *this;
+}
+
+template<typename KeyType, typename Comparator>
+void BTreeSet<KeyType, Comparator>::Clear()
+{
+    if (mRoot)
+    {
+        FreeSubtree(mRoot);
+        mRoot = nullptr;
+    }
+
+    mSize = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<typename KeyType, typename Comparator>
+typename BTreeSet<KeyType, Comparator>::Node* BTreeSet<KeyType, Comparator>::AllocateNode(bool isLeaf)
+{
+    const size_t size = isLeaf ? sizeof(Node) : sizeof(InternalNode);
+    void* memory = NFE_MALLOC(size, alignof(InternalNode));
+    if (!memory)
+    {
+        NFE_LOG_ERROR("Failed to allocate B-tree node");
+        return nullptr;
+    }
+
+    Node* node = isLeaf ? new (memory) Node : new (memory) InternalNode;
+    node->parent = nullptr;
+    node->parentIndex = 0;
+    node->numKeys = 0;
+    node->isLeaf = isLeaf;
+    return node;
+}
+
+template<typename KeyType, typename Comparator>
+void BTreeSet<KeyType, Comparator>::FreeNode(Node* node)
+{
+    // keys must be already destroyed or moved out
+    NFE_FREE(node);
+}
+
+template<typename KeyType, typename Comparator>
+void BTreeSet<KeyType, Comparator>::FreeSubtree(Node* node)
+{
+    if (!node->isLeaf)
+    {
+        for (uint32 i = 0; i <= node->numKeys; ++i)
+        {
+            FreeSubtree(node->Children()[i]);
+        }
+    }
+
+    for (uint32 i = 0; i < node->numKeys; ++i)
+    {
+        node->Keys()[i].~KeyType();
+    }
+
+    FreeNode(node);
+}
+
+template<typename KeyType, typename Comparator>
+typename BTreeSet<KeyType, Comparator>::Node* BTreeSet<KeyType, Comparator>::CloneSubtree(const Node* source, Node* parent)
+{
+    Node* node = AllocateNode(source->isLeaf);
+    NFE_ASSERT(node, "Failed to clone B-tree node");
+
+    node->parent = parent;
+    node->parentIndex = source->parentIndex;
+    node->numKeys = source->numKeys;
+
+    for (uint32 i = 0; i < source->numKeys; ++i)
+    {
+        new (node->Keys() + i) KeyType(source->Keys()[i]);
+    }
+
+    if (!source->isLeaf)
+    {
+        Node* const* sourceChildren = static_cast<const InternalNode*>(source)->children;
+        for (uint32 i = 0; i <= source->numKeys; ++i)
+        {
+            node->Children()[i] = CloneSubtree(sourceChildren[i], node);
+        }
+    }
+
+    return node;
+}
+
+template<typename KeyType, typename Comparator>
+void BTreeSet<KeyType, Comparator>::SetChild(Node* node, uint32 index, Node* child)
+{
+    node->Children()[index] = child;
+    child->parent = node;
+    child->parentIndex = static_cast<uint8>(index);
+}
+
+template<typename KeyType, typename Comparator>
+uint32 BTreeSet<KeyType, Comparator>::LowerBound(const Node* node, const KeyType& key) const
+{
+    const Comparator comparator;
+    const KeyType* keys = node->Keys();
+
+    uint32 first = 0;
+    uint32 count = node->numKeys;
+    while (count > 0)
+    {
+        const uint32 step = count / 2;
+        if (comparator.Less(keys[first + step], key))
+        {
+            first += step + 1;
+            count -= step + 1;
+        }
+        else
+        {
+            count = step;
+        }
+    }
+
+    return first;
+}
+
+template<typename KeyType, typename Comparator>
+void BTreeSet<KeyType, Comparator>::FindInternal(const KeyType& key, Node*& outNode, uint32& outIndex) const
+{
+    const Comparator comparator;
+
+    Node* node = mRoot;
+    while (node)
+    {
+        const uint32 index = LowerBound(node, key);
+        if (index < node->numKeys && comparator.Equal(node->Keys()[index], key))
+        {
+            outNode = node;
+            outIndex = index;
+            return;
+        }
+
+        node = node->isLeaf ? nullptr : node->Children()[index];
+    }
+
+    outNode = nullptr;
+    outIndex = 0;
+}
+
+template<typename KeyType, typename Comparator>
+typename BTreeSet<KeyType, Comparator>::ConstIterator BTreeSet<KeyType, Comparator>::Begin() const
+{
+    Node* node = mRoot;
+    if (node)
+    {
+        while (!node->isLeaf)
+        {
+            node = node->Children()[0];
+        }
+    }
+
+    return ConstIterator(this, node, 0);
+}
+
+template<typename KeyType, typename Comparator>
+typename BTreeSet<KeyType, Comparator>::Iterator BTreeSet<KeyType, Comparator>::Begin()
+{
+    const ConstIterator iter = static_cast<const BTreeSet*>(this)->Begin();
+    return Iterator(this, iter.mNode, iter.mIndex);
+}
+
+template<typename KeyType, typename Comparator>
+typename BTreeSet<KeyType, Comparator>::ConstIterator BTreeSet<KeyType, Comparator>::End() const
+{
+    return ConstIterator(this, nullptr, 0);
+}
+
+template<typename KeyType, typename Comparator>
+typename BTreeSet<KeyType, Comparator>::Iterator BTreeSet<KeyType, Comparator>::End()
+{
+    return Iterator(this, nullptr, 0);
+}
+
+template<typename KeyType, typename Comparator>
+typename BTreeSet<KeyType, Comparator>::ConstIterator BTreeSet<KeyType, Comparator>::Find(const KeyType& key) const
+{
+    Node* node;
+    uint32 index;
+    FindInternal(key, node, index);
+    return ConstIterator(this, node, index);
+}
+
+template<typename KeyType, typename Comparator>
+typename BTreeSet<KeyType, Comparator>::Iterator BTreeSet<KeyType, Comparator>::Find(const KeyType& key)
+{
+    Node* node;
+    uint32 index;
+    FindInternal(key, node, index);
+    return Iterator(this, node, index);
+}
+
+template<typename KeyType, typename Comparator>
+bool BTreeSet<KeyType, Comparator>::Exists(const KeyType& key) const
+{
+    Node* node;
+    uint32 index;
+    FindInternal(key, node, index);
+    return node != nullptr;
+}
+
+template<typename KeyType, typename Comparator>
+typename BTreeSet<KeyType, Comparator>::InsertResult BTreeSet<KeyType, Comparator>::Insert(const KeyType& key)
+{
+    return InsertInternal(key, false);
+}
+
+template<typename KeyType, typename Comparator>
+typename BTreeSet<KeyType, Comparator>::InsertResult BTreeSet<KeyType, Comparator>::Insert(KeyType&& key)
+{
+    return InsertInternal(std::move(key), false);
+}
+
+template<typename KeyType, typename Comparator>
+typename BTreeSet<KeyType, Comparator>::InsertResult BTreeSet<KeyType, Comparator>::InsertOrReplace(const KeyType& key)
+{
+    return InsertInternal(key, true);
+}
+
+template<typename KeyType, typename Comparator>
+typename BTreeSet<KeyType, Comparator>::InsertResult BTreeSet<KeyType, Comparator>::InsertOrReplace(KeyType&& key)
+{
+    return InsertInternal(std::move(key), true);
+}
+
+template<typename KeyType, typename Comparator>
+template<typename KeyTypeRef>
+typename BTreeSet<KeyType, Comparator>::InsertResult BTreeSet<KeyType, Comparator>::InsertInternal(KeyTypeRef&& key, bool replace)
+{
+    const Comparator comparator;
+
+    if (!mRoot)
+    {
+        mRoot = AllocateNode(true);
+        if (!mRoot)
+        {
+            return InsertResult(End());
+        }
+    }
+
+    // find the leaf to insert to
+    Node* node = mRoot;
+    uint32 index;
+    for (;;)
+    {
+        index = LowerBound(node, key);
+        if (index < node->numKeys && comparator.Equal(node->Keys()[index], key))
+        {
+            if (!replace)
+            {
+                // Insert method cannot replace
+                return InsertResult(End());
+            }
+
+            KeyType* existingKey = node->Keys() + index;
+            existingKey->~KeyType();
+            new (existingKey) KeyType(std::forward<KeyTypeRef>(key));
+            return InsertResult(ConstIterator(this, node, index), true);
+        }
+
+        if (node->isLeaf)
+        {
+            break;
+        }
+
+        node = node->Children()[index];
+    }
+
+    Node* insertedNode = nullptr;
+    uint32 insertedIndex = 0;
+    InsertIntoNode(node, index, std::forward<KeyTypeRef>(key), nullptr, insertedNode, insertedIndex);
+    mSize++;
+
+    return InsertResult(ConstIterator(this, insertedNode, insertedIndex));
+}
+
+template<typename KeyType, typename Comparator>
+template<typename KeyTypeRef>
+void BTreeSet<KeyType, Comparator>::InsertIntoNode(Node* node, uint32 index, KeyTypeRef&& key, Node* rightChild, Node*& outNode, uint32& outIndex)
+{
+    if (node->numKeys < MaxKeys)
+    {
+        KeyType* keys = node->Keys();
+        for (uint32 i = node->numKeys; i > index; --i)
+        {
+            MemoryHelpers::Move<KeyType>(keys + i, keys + i - 1);
+        }
+        new (keys + index) KeyType(std::forward<KeyTypeRef>(key));
+
+        if (!node->isLeaf)
+        {
+            for (uint32 i = node->numKeys + 1; i > index + 1; --i)
+            {
+                SetChild(node, i, node->Children()[i - 1]);
+            }
+            SetChild(node, index + 1, rightChild);
+        }
+
+        node->numKeys++;
+        outNode = node;
+        outIndex = index;
+        return;
+    }
+
+    // the node is full - split it in half and move the median key up
+    constexpr uint32 splitIndex = MaxKeys / 2;
+
+    Node* rightNode = AllocateNode(node->isLeaf);
+    NFE_ASSERT(rightNode, "Failed to allocate B-tree node");
+
+    KeyType* keys = node->Keys();
+    for (uint32 i = splitIndex + 1; i < MaxKeys; ++i)
+    {
+        MemoryHelpers::Move<KeyType>(rightNode->Keys() + (i - splitIndex - 1), keys + i);
+    }
+
+    if (!node->isLeaf)
+    {
+        for (uint32 i = splitIndex + 1; i <= MaxKeys; ++i)
+        {
+            SetChild(rightNode, i - splitIndex - 1, node->Children()[i]);
+        }
+    }
+
+    node->numKeys = static_cast<uint8>(splitIndex);
+    rightNode->numKeys = static_cast<uint8>(MaxKeys - splitIndex - 1);
+
+    KeyType median(std::move(keys[splitIndex]));
+    keys[splitIndex].~KeyType();
+
+    // both halves have free space now
+    if (index <= splitIndex)
+    {
+        InsertIntoNode(node, index, std::forward<KeyTypeRef>(key), rightChild, outNode, outIndex);
+    }
+    else
+    {
+        InsertIntoNode(rightNode, index - splitIndex - 1, std::forward<KeyTypeRef>(key), rightChild, outNode, outIndex);
+    }
+
+    Node* parent = node->parent;
+    if (!parent)
+    {
+        // splitting the root - tree grows by one level
+        parent = AllocateNode(false);
+        NFE_ASSERT(parent, "Failed to allocate B-tree node");
+
+        SetChild(parent, 0, node);
+        mRoot = parent;
+    }
+
+    Node* unusedNode;
+    uint32 unusedIndex;
+    InsertIntoNode(parent, node->parentIndex, std::move(median), rightNode, unusedNode, unusedIndex);
+}
+
+template<typename KeyType, typename Comparator>
+bool BTreeSet<KeyType, Comparator>::Erase(const KeyType& key)
+{
+    return Erase(Find(key));
+}
+
+template<typename KeyType, typename Comparator>
+bool BTreeSet<KeyType, Comparator>::Erase(const ConstIterator& iterator)
+{
+    if (iterator.mSet != this || !iterator.mNode)
+    {
+        return false;
+    }
+
+    Node* node = iterator.mNode;
+    uint32 index = iterator.mIndex;
+    NFE_ASSERT(index < node->numKeys, "Invalid iterator");
+
+    node->Keys()[index].~KeyType();
+
+    if (!node->isLeaf)
+    {
+        // replace with the predecessor (the rightmost key in the left subtree), which is always in a leaf
+        Node* leaf = node->Children()[index];
+        while (!leaf->isLeaf)
+        {
+            leaf = leaf->Children()[leaf->numKeys];
+        }
+
+        MemoryHelpers::Move<KeyType>(node->Keys() + index, leaf->Keys() + leaf->numKeys - 1);
+        node = leaf;
+        index = leaf->numKeys - 1;
+    }
+
+    // remove the gap in the leaf
+    KeyType* keys = node->Keys();
+    for (uint32 i = index + 1; i < node->numKeys; ++i)
+    {
+        MemoryHelpers::Move<KeyType>(keys + i - 1, keys + i);
+    }
+    node->numKeys--;
+    mSize--;
+
+    Rebalance(node);
+    return true;
+}
+
+template<typename KeyType, typename Comparator>
+void BTreeSet<KeyType, Comparator>::Rebalance(Node* node)
+{
+    while (node != mRoot && node->numKeys < MinKeys)
+    {
+        Node* parent = node->parent;
+        const uint32 index = node->parentIndex;
+
+        Node* leftSibling = index > 0 ? parent->Children()[index - 1] : nullptr;
+        Node* rightSibling = index < parent->numKeys ? parent->Children()[index + 1] : nullptr;
+
+        if (leftSibling && leftSibling->numKeys > MinKeys)
+        {
+            // borrow from the left sibling through the parent
+            KeyType* keys = node->Keys();
+            for (uint32 i = node->numKeys; i > 0; --i)
+            {
+                MemoryHelpers::Move<KeyType>(keys + i, keys + i - 1);
+            }
+            MemoryHelpers::Move<KeyType>(keys, parent->Keys() + index - 1);
+            MemoryHelpers::Move<KeyType>(parent->Keys() + index - 1, leftSibling->Keys() + leftSibling->numKeys - 1);
+
+            if (!node->isLeaf)
+            {
+                for (uint32 i = node->numKeys + 1; i > 0; --i)
+                {
+                    SetChild(node, i, node->Children()[i - 1]);
+                }
+                SetChild(node, 0, leftSibling->Children()[leftSibling->numKeys]);
+            }
+
+            node->numKeys++;
+            leftSibling->numKeys--;
+            return;
+        }
+
+        if (rightSibling && rightSibling->numKeys > MinKeys)
+        {
+            // borrow from the right sibling through the parent
+            MemoryHelpers::Move<KeyType>(node->Keys() + node->numKeys, parent->Keys() + index);
+            MemoryHelpers::Move<KeyType>(parent->Keys() + index, rightSibling->Keys());
+
+            KeyType* siblingKeys = rightSibling->Keys();
+            for (uint32 i = 1; i < rightSibling->numKeys; ++i)
+            {
+                MemoryHelpers::Move<KeyType>(siblingKeys + i - 1, siblingKeys + i);
+            }
+
+            if (!node->isLeaf)
+            {
+                SetChild(node, node->numKeys + 1, rightSibling->Children()[0]);
+                for (uint32 i = 1; i <= rightSibling->numKeys; ++i)
+                {
+                    SetChild(rightSibling, i - 1, rightSibling->Children()[i]);
+                }
+            }
+
+            node->numKeys++;
+            rightSibling->numKeys--;
+            return;
+        }
+
+        // both siblings are minimal - merge with one of them
+        MergeChildren(parent, leftSibling ? index - 1 : index);
+        node = parent;
+    }
+
+    if (mRoot->numKeys == 0)
+    {
+        Node* oldRoot = mRoot;
+        if (oldRoot->isLeaf)
+        {
+            mRoot = nullptr;
+        }
+        else
+        {
+            mRoot = oldRoot->Children()[0];
+            mRoot->parent = nullptr;
+            mRoot->parentIndex = 0;
+        }
+        FreeNode(oldRoot);
+    }
+}
+
+template<typename KeyType, typename Comparator>
+void BTreeSet<KeyType, Comparator>::MergeChildren(Node* parent, uint32 index)
+{
+    Node* left = parent->Children()[index];
+    Node* right = parent->Children()[index + 1];
+    NFE_ASSERT(left->numKeys + right->numKeys + 1 <= MaxKeys, "Merged node would overflow");
+
+    // separator key goes down
+    const uint32 offset = left->numKeys + 1;
+    MemoryHelpers::Move<KeyType>(left->Keys() + left->numKeys, parent->Keys() + index);
+
+    for (uint32 i = 0; i < right->numKeys; ++i)
+    {
+        MemoryHelpers::Move<KeyType>(left->Keys() + offset + i, right->Keys() + i);
+    }
+
+    if (!left->isLeaf)
+    {
+        for (uint32 i = 0; i <= right->numKeys; ++i)
+        {
+            SetChild(left, offset + i, right->Children()[i]);
+        }
+    }
+
+    left->numKeys = static_cast<uint8>(offset + right->numKeys);
+
+    // remove the separator and the right child from the parent
+    KeyType* parentKeys = parent->Keys();
+    for (uint32 i = index + 1; i < parent->numKeys; ++i)
+    {
+        MemoryHelpers::Move<KeyType>(parentKeys + i - 1, parentKeys + i);
+    }
+    for (uint32 i = index + 2; i <= parent->numKeys; ++i)
+    {
+        SetChild(parent, i - 1, parent->Children()[i]);
+    }
+    parent->numKeys--;
+
+    FreeNode(right);
+}
+
+template<typename KeyType, typename Comparator>
+bool BTreeSet<KeyType, Comparator>::VerifyNode(const Node* node, const KeyType* lowerBound, const KeyType* upperBound,
+                                               uint32 depth, uint32& leafDepth, uint32& numKeys) const
+{
+    const Comparator comparator;
+
+    if (node != mRoot && (node->numKeys < MinKeys || node->numKeys > MaxKeys))
+    {
+        NFE_LOG_ERROR("B-tree node has invalid number of keys: %u", node->numKeys);
+        return false;
+    }
+
+    const KeyType* keys = node->Keys();
+    for (uint32 i = 0; i < node->numKeys; ++i)
+    {
+        const KeyType* prev = i > 0 ? keys + i - 1 : lowerBound;
+        if (prev && !comparator.Less(*prev, keys[i]))
+        {
+            NFE_LOG_ERROR("B-tree keys are not sorted");
+            return false;
+        }
+    }
+
+    if (upperBound && node->numKeys > 0 && !comparator.Less(keys[node->numKeys - 1], *upperBound))
+    {
+        NFE_LOG_ERROR("B-tree keys are not sorted");
+        return false;
+    }
+
+    numKeys += node->numKeys;
+
+    if (node->isLeaf)
+    {
+        if (leafDepth == UINT32_MAX)
+        {
+            leafDepth = depth;
+        }
+        else if (leafDepth != depth)
+        {
+            NFE_LOG_ERROR("B-tree leaves are not on the same level");
+            return false;
+        }
+        return true;
+    }
+
+    Node* const* children = static_cast<const InternalNode*>(node)->children;
+    for (uint32 i = 0; i <= node->numKeys; ++i)
+    {
+        if (children[i]->parent != node || children[i]->parentIndex != i)
+        {
+            NFE_LOG_ERROR("B-tree node has invalid parent link");
+            return false;
+        }
+
+        const KeyType* childLowerBound = i > 0 ? keys + i - 1 : lowerBound;
+        const KeyType* childUpperBound = i < node->numKeys ? keys + i : upperBound;
+        if (!VerifyNode(children[i], childLowerBound, childUpperBound, depth + 1, leafDepth, numKeys))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template<typename KeyType, typename Comparator>
+bool BTreeSet<KeyType, Comparator>::Verify() const
+{
+    if (!mRoot)
+    {
+        return mSize == 0;
+    }
+
+    if (mRoot->parent)
+    {
+        NFE_LOG_ERROR("B-tree root has a parent");
+        return false;
+    }
+
+    uint32 leafDepth = UINT32_MAX;
+    uint32 numKeys = 0;
+    if (!VerifyNode(mRoot, nullptr, nullptr, 0, leafDepth, numKeys))
+    {
+        return false;
+    }
+
+    if (numKeys != mSize)
+    {
+        NFE_LOG_ERROR("Counted elements number does not match. B-tree corruption");
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace Common
+} // namespace NFE
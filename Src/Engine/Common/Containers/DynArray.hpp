@@ -8,7 +8,7 @@
 
 #include "../nfCommon.hpp"
 #include "ArrayView.hpp"
-#include "../Memory/DefaultAllocator.hpp"
+#include "../Memory/Allocator.hpp"
 #include "../Logger/Logger.hpp"
 
 
@@ -17,6 +17,8 @@ namespace Common {
 
 /**
  * Dynamic array (like std::vector).
+ * Memory is allocated with the allocator passed in constructor (default allocator if null).
+ * Move construction takes over the other array's allocator, so the allocator must outlive the new array too.
  */
 template<typename ElementType>
 class DynArray : public ArrayView<ElementType>
@@ -33,6 +35,9 @@ public:
     NFE_INLINE DynArray& operator = (const DynArray& other);
     NFE_INLINE DynArray& operator = (DynArray&& other);
 
+    // initialize empty array using custom allocator
+    NFE_INLINE explicit DynArray(IAllocator* allocator);
+
     // initialize using initializer list
     DynArray(const std::initializer_list<ElementType>& list);
 
@@ -118,10 +123,21 @@ public:
 
     /**
      * Reserve space.
+     * @note    If the allocator supports it, the buffer is grown in place (without moving elements).
      * @return  'false' if memory allocation failed.
      */
     bool Reserve(uint32 size);
 
+    /**
+     * Get number of elements that can be stored without reallocation.
+     */
+    NFE_INLINE uint32 Capacity() const { return mAllocSize; }
+
+    /**
+     * Get allocator used by this array (null means default allocator).
+     */
+    NFE_INLINE IAllocator* GetAllocator() const { return mAllocator; }
+
     /**
      * Resize the array.
      * Element type must have default constructor.
@@ -144,7 +160,7 @@ public:
 
     /**
      * Replace contents of two arrays.
-     * @note Does not call any constructor or destructor, just pointers are swapped.
+     * @note Does not call any constructor or destructor, just pointers are swapped (unless the arrays use different allocators).
      */
     void Swap(DynArray& other);
 
@@ -160,8 +176,14 @@ private:
 
     bool ContainsElement(const ElementType& element) const;
 
+    // move elements from other array (which uses a different allocator)
+    void MoveElementsFrom(DynArray& other);
+
     // allocated size
     uint32 mAllocSize;
+
+    // memory allocator (null means default allocator)
+    IAllocator* mAllocator;
 };
 
 
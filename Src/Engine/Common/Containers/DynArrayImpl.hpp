@@ -18,6 +18,14 @@ namespace Common {
 template<typename ElementType>
 DynArray<ElementType>::DynArray()
     : mAllocSize(0)
+    , mAllocator(nullptr)
+{
+}
+
+template<typename ElementType>
+DynArray<ElementType>::DynArray(IAllocator* allocator)
+    : mAllocSize(0)
+    , mAllocator(allocator)
 {
 }
 
@@ -32,6 +40,7 @@ DynArray<ElementType>::DynArray(const DynArray& other)
     : ArrayView<ElementType>()
 {
     mAllocSize = 0;
+    mAllocator = nullptr;
     this->mElements = nullptr;
     this->mSize = 0;
 
@@ -51,13 +60,23 @@ DynArray<ElementType>::DynArray(const DynArray& other)
 template<typename ElementType>
 DynArray<ElementType>::DynArray(DynArray&& other)
     : ArrayView<ElementType>()
+    , mAllocSize(0)
+    , mAllocator(nullptr)
 {
-    // don't free memory if not needed
-    Clear(true);
+    if (other.mAllocator && !other.mAllocator->IsTransferable())
+    {
+        // allocator lives inside the source array (e.g. InlineDynArray), so the elements must be moved to own buffer
+        this->mElements = nullptr;
+        this->mSize = 0;
+        MoveElementsFrom(other);
+        return;
+    }
 
+    // take over the buffer together with the allocator that owns it
+    mAllocSize = other.mAllocSize;
+    mAllocator = other.mAllocator;
     this->mElements = other.mElements;
     this->mSize = other.mSize;
-    mAllocSize = other.mAllocSize;
 
     other.mElements = nullptr;
     other.mSize = 0;
@@ -90,6 +109,16 @@ DynArray<ElementType>& DynArray<ElementType>::operator = (const DynArray& other)
 template<typename ElementType>
 DynArray<ElementType>& DynArray<ElementType>::operator = (DynArray&& other)
 {
+    if (&other == this)
+        return *this;
+
+    if (mAllocator != other.mAllocator)
+    {
+        Clear();
+        MoveElementsFrom(other);
+        return *this;
+    }
+
     // don't free memory if not needed
     Clear(true);
 
@@ -194,7 +223,7 @@ void DynArray<ElementType>::Clear(bool freeMemory)
 
     if (freeMemory)
     {
-        NFE_FREE(this->mElements);
+        AllocatorFree(mAllocator, this->mElements);
         this->mElements = nullptr;
         mAllocSize = 0;
     }
@@ -206,6 +235,22 @@ bool DynArray<ElementType>::ContainsElement(const ElementType& element) const
     return (&element - this->mElements >= 0) && (&element < this->mElements + this->mSize);
 }
 
+template<typename ElementType>
+void DynArray<ElementType>::MoveElementsFrom(DynArray& other)
+{
+    NFE_ASSERT(this->mSize == 0, "Target array must be empty");
+
+    if (!Reserve(other.mSize))
+    {
+        NFE_LOG_ERROR("Failed to reserve memory for DynArray");
+        return;
+    }
+
+    MemoryHelpers::MoveArray<ElementType>(this->mElements, other.mElements, other.mSize);
+    this->mSize = other.mSize;
+    other.mSize = 0;
+}
+
 template<typename ElementType>
 typename DynArray<ElementType>::IteratorType DynArray<ElementType>::PushBack(const ElementType& element)
 {
@@ -425,14 +470,17 @@ bool DynArray<ElementType>::Reserve(uint32 size)
         return true;
     }
 
-    uint32 newAllocSize = mAllocSize;
-    while (size > newAllocSize)
+    // grow by at least 50%
+    const uint32 newAllocSize = Math::Max<uint32>(size, mAllocSize + mAllocSize / 2);
+
+    // try to grow the buffer without moving the elements
+    if (AllocatorTryResize(mAllocator, this->mElements, mAllocSize * sizeof(ElementType), newAllocSize * sizeof(ElementType)))
     {
-        // grow by 50%
-        newAllocSize += Math::Max<uint32>(1, newAllocSize / 2);
+        mAllocSize = newAllocSize;
+        return true;
     }
 
-    ElementType* newBuffer = static_cast<ElementType*>(NFE_MALLOC(newAllocSize * sizeof(ElementType), alignof(ElementType)));
+    ElementType* newBuffer = static_cast<ElementType*>(AllocatorMalloc(mAllocator, newAllocSize * sizeof(ElementType), alignof(ElementType)));
     if (!newBuffer)
     {
         // memory allocation failed
@@ -443,7 +491,7 @@ bool DynArray<ElementType>::Reserve(uint32 size)
     MemoryHelpers::MoveArray<ElementType>(newBuffer, this->mElements, this->mSize);
 
     // replace buffer
-    NFE_FREE(this->mElements);
+    AllocatorFree(mAllocator, this->mElements);
     this->mElements = newBuffer;
     mAllocSize = newAllocSize;
     return true;
@@ -524,8 +572,17 @@ bool DynArray<ElementType>::Resize_SkipConstructor(uint32 size)
 template<typename ElementType>
 void DynArray<ElementType>::Swap(DynArray& other)
 {
-    std::swap(this->mElements, other->mElements);
-    std::swap(this->mSize, other->mSize);
+    if (mAllocator != other.mAllocator)
+    {
+        // buffers can't be exchanged
+        DynArray temp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(temp);
+        return;
+    }
+
+    std::swap(this->mElements, other.mElements);
+    std::swap(this->mSize, other.mSize);
     std::swap(mAllocSize, other.mAllocSize);
 }
 
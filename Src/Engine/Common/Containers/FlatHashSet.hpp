@@ -0,0 +1,347 @@
+/**
+ * @file
+ * @author Witek902 (witek902@gmail.com)
+ * @brief  FlatHashSet data container declaration
+ */
+
+#pragma once
+
+#include "../nfCommon.hpp"
+#include "Hash.hpp"
+
+#include <functional>
+
+#if defined(NFE_USE_AVX2)
+#include <immintrin.h>
+#elif defined(NFE_USE_SSE)
+#include <emmintrin.h>
+#endif
+
+
+namespace NFE {
+namespace Common {
+
+namespace detail {
+
+/**
+ * Group of FlatHashSet control bytes, probed at once.
+ * Control byte of a full slot stores lowest 7 bits of the key's hash, so most of the mismatching keys
+ * are rejected without touching the keys array.
+ */
+struct FlatHashGroup
+{
+    static constexpr uint8 Empty = 0x80;
+    static constexpr uint8 Deleted = 0xFE;
+
+#if defined(NFE_USE_AVX2)
+
+    static constexpr uint32 Width = 32;
+
+    __m256i ctrl;
+
+    NFE_FORCE_INLINE explicit FlatHashGroup(const uint8* ptr)
+        : ctrl(_mm256_load_si256(reinterpret_cast<const __m256i*>(ptr)))
+    { }
+
+    // bit mask of slots with given control byte value
+    NFE_FORCE_INLINE uint32 Match(uint8 value) const
+    {
+        return static_cast<uint32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(ctrl, _mm256_set1_epi8(static_cast<char>(value)))));
+    }
+
+    // bit mask of empty or deleted slots (control bytes with the highest bit set)
+    NFE_FORCE_INLINE uint32 MatchEmptyOrDeleted() const
+    {
+        return static_cast<uint32>(_mm256_movemask_epi8(ctrl));
+    }
+
+#elif defined(NFE_USE_SSE)
+
+    static constexpr uint32 Width = 16;
+
+    __m128i ctrl;
+
+    NFE_FORCE_INLINE explicit FlatHashGroup(const uint8* ptr)
+        : ctrl(_mm_load_si128(reinterpret_cast<const __m128i*>(ptr)))
+    { }
+
+    NFE_FORCE_INLINE uint32 Match(uint8 value) const
+    {
+        return static_cast<uint32>(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(static_cast<char>(value)))));
+    }
+
+    NFE_FORCE_INLINE uint32 MatchEmptyOrDeleted() const
+    {
+        return static_cast<uint32>(_mm_movemask_epi8(ctrl));
+    }
+
+#else // portable fallback
+
+    static constexpr uint32 Width = 16;
+
+    const uint8* ctrl;
+
+    NFE_FORCE_INLINE explicit FlatHashGroup(const uint8* ptr)
+        : ctrl(ptr)
+    { }
+
+    NFE_FORCE_INLINE uint32 Match(uint8 value) const
+    {
+        uint32 mask = 0;
+        for (uint32 i = 0; i < Width; ++i)
+        {
+            mask |= static_cast<uint32>(ctrl[i] == value) << i;
+        }
+        return mask;
+    }
+
+    NFE_FORCE_INLINE uint32 MatchEmptyOrDeleted() const
+    {
+        uint32 mask = 0;
+        for (uint32 i = 0; i < Width; ++i)
+        {
+            mask |= static_cast<uint32>(ctrl[i] >> 7) << i;
+        }
+        return mask;
+    }
+
+#endif
+
+    NFE_FORCE_INLINE uint32 MatchEmpty() const
+    {
+        return Match(Empty);
+    }
+
+    NFE_FORCE_INLINE uint32 MatchFull() const
+    {
+        return ~MatchEmptyOrDeleted() & FullMask;
+    }
+
+    static constexpr uint32 FullMask = Width == 32 ? 0xFFFFFFFFu : ((1u << Width) - 1u);
+};
+
+} // namespace detail
+
+
+/**
+ * Hashed (unordered) set container with open addressing (Swiss table).
+ *
+ * Keys are stored in a flat array with a parallel array of one byte control codes, which are probed
+ * with SIMD instructions a group at a time. Compared to HashSet (separate chaining) lookups do not follow
+ * linked lists and iteration skips empty slots quickly, at the cost of keys being moved on rehash.
+ *
+ * @note    Iterators and pointers to keys are invalidated on insertion.
+ */
+template<
+    typename KeyType,
+    typename HashPolicy = DefaultHashPolicy<KeyType>,
+    typename EqualsPolicy = std::equal_to<KeyType>>
+class FlatHashSet final
+{
+public:
+
+    using Group = detail::FlatHashGroup;
+
+    static constexpr uint32 InvalidID = static_cast<uint32>(-1);
+
+    // Maximum load factor in quotient form (7/8)
+    // If the set usage (including deleted slots) exceeds capacity times this coefficient, rehash will be performed.
+    static constexpr uint32 MaxLoadNumerator = 7;
+    static constexpr uint32 MaxLoadDenominator = 8;
+
+    // iterator with read-only access
+    class ConstIterator
+    {
+        friend class FlatHashSet;
+    public:
+        // C++ standard iterator traits
+        using self_type = ConstIterator;
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = KeyType;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const KeyType*;
+        using reference = const KeyType&;
+
+        NFE_INLINE ConstIterator();
+        NFE_INLINE bool operator == (const ConstIterator& other) const;
+        NFE_INLINE bool operator != (const ConstIterator& other) const;
+        NFE_INLINE const KeyType& operator * () const;
+        NFE_INLINE const KeyType* operator -> () const;
+        NFE_INLINE ConstIterator& operator++();
+        NFE_INLINE ConstIterator operator++(int);
+    private:
+        NFE_INLINE ConstIterator(const FlatHashSet* set, uint32 index);
+        const FlatHashSet* mSet;    // container we are iterating
+        uint32 mIndex;              // slot index
+    };
+
+    // iterator with read-write access
+    class Iterator : public ConstIterator
+    {
+        friend class FlatHashSet;
+    public:
+        // C++ standard iterator traits
+        using self_type = Iterator;
+        using pointer = KeyType*;
+        using reference = KeyType&;
+
+        NFE_INLINE Iterator();
+        NFE_INLINE KeyType& operator * () const;
+        NFE_INLINE KeyType* operator -> () const;
+        NFE_INLINE Iterator& operator++();
+        NFE_INLINE Iterator operator++(int);
+    private:
+        NFE_INLINE Iterator(const FlatHashSet* set, uint32 index);
+    };
+
+    // insertion information
+    struct InsertResult final
+    {
+        Iterator iterator;  // iterator to the inserted node
+        bool replaced;      // set to true if the node with given key already existed
+
+        explicit InsertResult(const Iterator& iterator, bool replaced = false)
+            : iterator(iterator), replaced(replaced)
+        { }
+    };
+
+    // basic constructors and assignment operators
+    FlatHashSet();
+    ~FlatHashSet();
+    FlatHashSet(const FlatHashSet& other);
+    FlatHashSet(FlatHashSet&& other);
+    FlatHashSet& operator = (const FlatHashSet& other);
+    FlatHashSet& operator = (FlatHashSet&& other);
+
+    /**
+     * Get number of inserted keys.
+     */
+    NFE_INLINE uint32 Size() const { return mSize; }
+
+    /**
+     * Check if the set is empty.
+     */
+    NFE_INLINE bool Empty() const { return mSize == 0; }
+
+    /**
+     * Get number of allocated slots.
+     */
+    NFE_INLINE uint32 GetCapacity() const { return mCapacity; }
+
+    /**
+     * Remove all the keys and free allocated memory.
+     */
+    void Clear();
+
+    /**
+     * Get iterator to the beginning.
+     */
+    NFE_INLINE ConstIterator Begin() const;
+    NFE_INLINE Iterator Begin();
+
+    /**
+     * Get iterator to the end.
+     */
+    NFE_INLINE ConstIterator End() const;
+    NFE_INLINE Iterator End();
+
+    /**
+     * Find element by value.
+     * @return  Iterator to the found element, or iterator to the end if the element does not exist.
+     */
+    NFE_INLINE ConstIterator Find(const KeyType& key) const;
+    NFE_INLINE Iterator Find(const KeyType& key);
+
+    /**
+     * Check if given key exists in the set.
+     */
+    NFE_INLINE bool Exists(const KeyType& key) const;
+
+    /**
+     * Insert a new element to the set.
+     * @return  Structure with insertion information (iterator to the end if the key already exists).
+     */
+    NFE_INLINE InsertResult Insert(const KeyType& key);
+    NFE_INLINE InsertResult Insert(KeyType&& key);
+
+    /**
+     * Insert a new element to the set or replace existing.
+     * @return  Structure with insertion information.
+     */
+    NFE_INLINE InsertResult InsertOrReplace(const KeyType& key);
+    NFE_INLINE InsertResult InsertOrReplace(KeyType&& key);
+
+    /**
+     * Erase an element by value.
+     * @return  True if the element was found and has been removed.
+     */
+    NFE_INLINE bool Erase(const KeyType& key);
+
+    /**
+     * Erase an element by iterator.
+     * @return  True if the element has been removed.
+     */
+    bool Erase(const ConstIterator& iterator);
+
+    // lower-case aliases for Begin()/End(), required by C++
+    NFE_INLINE ConstIterator cbegin() const { return Begin(); }
+    NFE_INLINE ConstIterator cend() const { return End(); }
+    NFE_INLINE ConstIterator begin() const { return Begin(); }
+    NFE_INLINE ConstIterator end() const { return End(); }
+    NFE_INLINE Iterator begin() { return Begin(); }
+    NFE_INLINE Iterator end() { return End(); }
+
+    /**
+     * Make sure that given number of keys can be inserted without rehashing.
+     */
+    bool Reserve(uint32 size);
+
+    // for debugging purposes
+    bool Verify() const;
+
+private:
+
+    // hash policy result is mixed, because both the lowest and the highest bits of the hash are used
+    NFE_FORCE_INLINE static uint32 CalculateHash(const KeyType& key)
+    {
+        HashPolicy hashPolicy;
+        return MixHash32(hashPolicy(key));
+    }
+
+    // split hash into group index part and control byte part
+    NFE_FORCE_INLINE static uint32 GetGroupHash(uint32 hash) { return hash >> 7; }
+    NFE_FORCE_INLINE static uint8 GetControlHash(uint32 hash) { return static_cast<uint8>(hash & 0x7F); }
+
+    // find slot with given key (returns InvalidID if not found)
+    uint32 FindSlot(const KeyType& key, uint32 hash) const;
+
+    // find empty or deleted slot for a new key (there must be one)
+    uint32 FindInsertSlot(uint32 hash) const;
+
+    // find first full slot starting from given index (returns InvalidID if not found)
+    uint32 FindNextFullSlot(uint32 index) const;
+
+    template<typename KeyTypeRef>
+    InsertResult InsertInternal(KeyTypeRef&& key, bool replace);
+
+    // reallocate slots and move the keys
+    bool Rehash(uint32 newCapacity);
+
+    NFE_FORCE_INLINE static uint32 CalculateGrowthLimit(uint32 capacity)
+    {
+        return capacity / MaxLoadDenominator * MaxLoadNumerator;
+    }
+
+    uint8* mControl;        // control byte per slot (empty, deleted or 7 bits of the key's hash)
+    KeyType* mKeys;         // keys (in the same memory block as control bytes)
+    uint32 mCapacity;       // number of slots (power of two, multiple of group width)
+    uint32 mSize;           // number of inserted keys
+    uint32 mGrowthLeft;     // number of keys that can be inserted before rehash
+};
+
+} // namespace Common
+} // namespace NFE
+
+
+// FlatHashSet class definitions go here:
+#include "FlatHashSetImpl.hpp"
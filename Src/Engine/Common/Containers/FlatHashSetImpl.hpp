@@ -0,0 +1,598 @@
+/**
+ * @file
+ * @author Witek902 (witek902@gmail.com)
+ * @brief  FlatHashSet data container definitions
+ */
+
+#pragma once
+
+#include "FlatHashSet.hpp"
+#include "../System/Assertion.hpp"
+#include "../Memory/MemoryHelpers.hpp"
+#include "../Memory/DefaultAllocator.hpp"
+#include "../Logger/Logger.hpp"
+#include "../Utils/BitUtils.hpp"
+
+#include <string.h>
+
+
+namespace NFE {
+namespace Common {
+
+
+// FlatHashSet::ConstIterator /////////////////////////////////////////////////////////////////////////
+
+template<typename KeyType, typename HashPolicy, typename EqualsPolicy>
+FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::ConstIterator::ConstIterator()
+    : mSet(nullptr)
+    , mIndex(InvalidID)
+{ }
+
+template<typename KeyType, typename HashPolicy, typename EqualsPolicy>
+FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::ConstIterator::ConstIterator(const FlatHashSet* set, uint32 index)
+    : mSet(set)
+    , mIndex(index)
+{ }
+
+template<typename KeyType, typename HashPolicy, typename EqualsPolicy>
+bool FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::ConstIterator::operator == (const ConstIterator& other) const
+{
+    return (mSet == other.mSet) && (mIndex == other.mIndex);
+}
+
+template<typename KeyType, typename HashPolicy, typename EqualsPolicy>
+bool FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::ConstIterator::operator != (const ConstIterator& other) const
+{
+    return (mSet != other.mSet) || (mIndex != other.mIndex);
+}
+
+template<typename KeyType, typename HashPolicy, typename EqualsPolicy>
+const KeyType& FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::ConstIterator::operator * () const
+{
+    NFE_ASSERT(mIndex != InvalidID, "Trying to dereference 'end' iterator");
+    return mSet->mKeys[mIndex];
+}
+
+template<typename KeyType, typename HashPolicy, typename EqualsPolicy>
+const KeyType* FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::ConstIterator::operator -> () const
+{
+    NFE_ASSERT(mIndex != InvalidID, "Trying to dereference 'end' iterator");
+    return mSet->mKeys + mIndex;
+}
+
+template<typename KeyType, typename HashPolicy, typename EqualsPolicy>
+typename FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::ConstIterator& FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::ConstIterator::operator++()
+{
+    if (mIndex != InvalidID) // update only when not pointing to the end
+    {
+        mIndex = mSet->FindNextFullSlot(mIndex + 1);
+    }
+
+    return *this;
+}
+
+template<typename KeyType, typename HashPolicy, typename EqualsPolicy>
+typename FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::ConstIterator FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::ConstIterator::operator++(int)
+{
+    ConstIterator tmp(*this);
+    operator++();
+    return tmp;
+}
+
+
+// FlatHashSet::Iterator //////////////////////////////////////////////////////////////////////////////
+
+template<typename KeyType, typename HashPolicy, typename EqualsPolicy>
+FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::Iterator::Iterator()
+    : ConstIterator()
+{ }
+
+template<typename KeyType, typename HashPolicy, typename EqualsPolicy>
+FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::Iterator::Iterator(const FlatHashSet* set, uint32 index)
+    : ConstIterator(set, index)
+{ }
+
+template<typename KeyType, typename HashPolicy, typename EqualsPolicy>
+KeyType& FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::Iterator::operator * () const
+{
+    NFE_ASSERT(this->mIndex != InvalidID, "Trying to dereference 'end' iterator");
+    return this->mSet->mKeys[this->mIndex];
+}
+
+template<typename KeyType, typename HashPolicy, typename EqualsPolicy>
+KeyType* FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::Iterator::operator -> () const
+{
+    NFE_ASSERT(this->mIndex != InvalidID, "Trying to dereference 'end' iterator");
+    return this->mSet->mKeys + this->mIndex;
+}
+
+template<typename KeyType, typename HashPolicy, typename EqualsPolicy>
+typename FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::Iterator& FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::Iterator::operator++()
+{
+    ConstIterator::operator++();
+    return *this;
+}
+
+template<typename KeyType, typename HashPolicy, typename EqualsPolicy>
+typename FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::Iterator FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::Iterator::operator++(int)
+{
+    Iterator tmp(*this);
+    ConstIterator::operator++();
+    return tmp;
+}
+
+
+// FlatHashSet ////////////////////////////////////////////////////////////////////////////////////////
+
+template<typename KeyType, typename HashPolicy, typename EqualsPolicy>
+FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::FlatHashSet()
+    : mControl(nullptr)
+    , mKeys(nullptr)
+    , mCapacity(0)
+    , mSize(0)
+    , mGrowthLeft(0)
+{
+}
+
+template<typename KeyType, typename HashPolicy, typename EqualsPolicy>
+FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::~FlatHashSet()
+{
+    Clear();
+}
+
+template<typename KeyType, typename HashPolicy, typename EqualsPolicy>
+FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::FlatHashSet(const FlatHashSet& other)
+    : FlatHashSet()
+{
+    Reserve(other.Size());
+
+    for (const KeyType& key : other)
+    {
+        const InsertResult result = Insert(key);
+        NFE_ASSERT(result.iterator.mIndex != InvalidID, "Failed to copy element from the other hash set");
+        NFE_UNUSED(result);
+    }
+}
+
+template<typename KeyType, typename HashPolicy, typename EqualsPolicy>
+FlatHashSet<KeyType, HashPolicy, EqualsPolicy>& FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::operator = (const FlatHashSet& other)
+{
+    if (this != &other)
+    {
+        Clear();
+        Reserve(other.Size());
+
+        for (const KeyType& key : other)
+        {
+            const InsertResult result = Insert(key);
+            NFE_ASSERT(result.iterator.mIndex != InvalidID, "Failed to copy element from the other hash set");
+            NFE_UNUSED(result);
+        }
+    }
+
+    return *this;
+}
+
+template<typename KeyType, typename HashPolicy, typename EqualsPolicy>
+FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::FlatHashSet(FlatHashSet&& other)
+    : mControl(other.mControl)
+    , mKeys(other.mKeys)
+    , mCapacity(other.mCapacity)
+    , mSize(other.mSize)
+    , mGrowthLeft(other.mGrowthLeft)
+{
+    other.mControl = nullptr;
+    other.mKeys = nullptr;
+    other.mCapacity = 0;
+    other.mSize = 0;
+    other.mGrowthLeft = 0;
+}
+
+template<typename KeyType, typename HashPolicy, typename EqualsPolicy>
+FlatHashSet<KeyType, HashPolicy, EqualsPolicy>& FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::operator = (FlatHashSet&& other)
+{
+    if (this != &other)
+    {
+        Clear();
+
+        mControl = other.mControl;
+        mKeys = other.mKeys;
+        mCapacity = other.mCapacity;
+        mSize = other.mSize;
+        mGrowthLeft = other.mGrowthLeft;
+
+        other.mControl = nullptr;
+        other.mKeys = nullptr;
+        other.mCapacity = 0;
+        other.mSize = 0;
+        other.mGrowthLeft = 0;
+    }
+
+    return *this;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<typename KeyType, typename HashPolicy, typename EqualsPolicy>
+void FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::Clear()
+{
+    if (!std::is_trivially_destructible_v<KeyType>)
+    {
+        for (uint32 i = FindNextFullSlot(0); i != InvalidID; i = FindNextFullSlot(i + 1))
+        {
+            mKeys[i].~KeyType();
+        }
+    }
+
+    // keys are allocated in the same memory block
+    NFE_FREE(mControl);
+
+    mControl = nullptr;
+    mKeys = nullptr;
+    mCapacity = 0;
+    mSize = 0;
+    mGrowthLeft = 0;
+}
+
+template<typename KeyType, typename HashPolicy, typename EqualsPolicy>
+typename FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::ConstIterator FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::Begin() const
+{
+    return ConstIterator(this, FindNextFullSlot(0));
+}
+
+template<typename KeyType, typename HashPolicy, typename EqualsPolicy>
+typename FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::Iterator FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::Begin()
+{
+    return Iterator(this, FindNextFullSlot(0));
+}
+
+template<typename KeyType, typename HashPolicy, typename EqualsPolicy>
+typename FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::ConstIterator FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::End() const
+{
+    return ConstIterator(this, InvalidID);
+}
+
+template<typename KeyType, typename HashPolicy, typename EqualsPolicy>
+typename FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::Iterator FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::End()
+{
+    return Iterator(this, InvalidID);
+}
+
+template<typename KeyType, typename HashPolicy, typename EqualsPolicy>
+typename FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::ConstIterator FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::Find(const KeyType& key) const
+{
+    return ConstIterator(this, FindSlot(key, CalculateHash(key)));
+}
+
+template<typename KeyType, typename HashPolicy, typename EqualsPolicy>
+typename FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::Iterator FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::Find(const KeyType& key)
+{
+    return Iterator(this, FindSlot(key, CalculateHash(key)));
+}
+
+template<typename KeyType, typename HashPolicy, typename EqualsPolicy>
+bool FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::Exists(const KeyType& key) const
+{
+    return FindSlot(key, CalculateHash(key)) != InvalidID;
+}
+
+template<typename KeyType, typename HashPolicy, typename EqualsPolicy>
+typename FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::InsertResult FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::Insert(const KeyType& key)
+{
+    return InsertInternal(key, false);
+}
+
+template<typename KeyType, typename HashPolicy, typename EqualsPolicy>
+typename FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::InsertResult FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::Insert(KeyType&& key)
+{
+    return InsertInternal(std::move(key), false);
+}
+
+template<typename KeyType, typename HashPolicy, typename EqualsPolicy>
+typename FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::InsertResult FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::InsertOrReplace(const KeyType& key)
+{
+    return InsertInternal(key, true);
+}
+
+template<typename KeyType, typename HashPolicy, typename EqualsPolicy>
+typename FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::InsertResult FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::InsertOrReplace(KeyType&& key)
+{
+    return InsertInternal(std::move(key), true);
+}
+
+template<typename KeyType, typename HashPolicy, typename EqualsPolicy>
+template<typename KeyTypeRef>
+typename FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::InsertResult FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::InsertInternal(KeyTypeRef&& key, bool replace)
+{
+    const uint32 hash = CalculateHash(key);
+
+    uint32 slot = FindSlot(key, hash);
+    if (slot != InvalidID)
+    {
+        if (!replace)
+        {
+            // replacing is not supported by this method
+            return InsertResult(End());
+        }
+
+        mKeys[slot].~KeyType();
+        new (mKeys + slot) KeyType(std::forward<KeyTypeRef>(key));
+        return InsertResult(Iterator(this, slot), true);
+    }
+
+    if (mGrowthLeft == 0)
+    {
+        uint32 newCapacity = Group::Width;
+        if (mCapacity > 0)
+        {
+            // if enough of the used slots are deleted ones, just clean them up without growing
+            // (at least 3/32 of the capacity will be freed, so rehashing cost is amortized)
+            const bool rehashInPlace = static_cast<uint64>(mSize) * 32u <= static_cast<uint64>(mCapacity) * 25u;
+            newCapacity = rehashInPlace ? mCapacity : 2 * mCapacity;
+        }
+
+        if (!Rehash(newCapacity))
+        {
+            return InsertResult(End());
+        }
+    }
+
+    slot = FindInsertSlot(hash);
+    NFE_ASSERT(slot != InvalidID, "Free slot not found. Hash set corruption");
+
+    if (mControl[slot] == Group::Empty)
+    {
+        // reusing deleted slots does not change the probe sequences length
+        mGrowthLeft--;
+    }
+
+    mControl[slot] = GetControlHash(hash);
+    new (mKeys + slot) KeyType(std::forward<KeyTypeRef>(key));
+    mSize++;
+
+    return InsertResult(Iterator(this, slot));
+}
+
+template<typename KeyType, typename HashPolicy, typename EqualsPolicy>
+bool FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::Erase(const KeyType& key)
+{
+    return Erase(Find(key));
+}
+
+template<typename KeyType, typename HashPolicy, typename EqualsPolicy>
+bool FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::Erase(const ConstIterator& iterator)
+{
+    if (iterator.mSet != this || iterator.mIndex >= mCapacity)
+    {
+        return false;
+    }
+
+    const uint32 slot = iterator.mIndex;
+    NFE_ASSERT(mControl[slot] < Group::Empty, "Trying to erase non-existing key");
+
+    mKeys[slot].~KeyType();
+    mSize--;
+
+    // Probing is group-aligned and stops at the first group with an empty slot. If the group already has an
+    // empty slot, no probe sequence could have passed through it, so the slot can be marked as empty again.
+    // Otherwise a tombstone must be left, so keys inserted further in the probe sequence can be still found.
+    const Group group(mControl + (slot & ~(Group::Width - 1)));
+    if (group.MatchEmpty())
+    {
+        mControl[slot] = Group::Empty;
+        mGrowthLeft++;
+    }
+    else
+    {
+        mControl[slot] = Group::Deleted;
+    }
+
+    return true;
+}
+
+template<typename KeyType, typename HashPolicy, typename EqualsPolicy>
+bool FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::Reserve(uint32 size)
+{
+    uint32 targetCapacity = Group::Width;
+    while (CalculateGrowthLimit(targetCapacity) < size)
+    {
+        targetCapacity *= 2;
+    }
+
+    if (targetCapacity <= mCapacity)
+    {
+        // no need to rehash
+        return true;
+    }
+
+    return Rehash(targetCapacity);
+}
+
+template<typename KeyType, typename HashPolicy, typename EqualsPolicy>
+uint32 FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::FindSlot(const KeyType& key, uint32 hash) const
+{
+    if (mSize == 0)
+    {
+        return InvalidID;
+    }
+
+    EqualsPolicy equalsPolicy;
+    const uint8 controlHash = GetControlHash(hash);
+    const uint32 groupMask = mCapacity / Group::Width - 1;
+    uint32 groupIndex = GetGroupHash(hash) & groupMask;
+
+    // triangular probing - visits every group exactly once for power-of-two number of groups
+    for (uint32 i = 1; i <= groupMask + 1; ++i)
+    {
+        const uint32 groupStart = groupIndex * Group::Width;
+        const Group group(mControl + groupStart);
+
+        for (uint32 mask = group.Match(controlHash); mask; mask &= mask - 1)
+        {
+            const uint32 slot = groupStart + BitUtils<uint32>::CountTrailingZeros(mask);
+            if (equalsPolicy(mKeys[slot], key))
+            {
+                return slot;
+            }
+        }
+
+        if (group.MatchEmpty())
+        {
+            break;
+        }
+
+        groupIndex = (groupIndex + i) & groupMask;
+    }
+
+    return InvalidID;
+}
+
+template<typename KeyType, typename HashPolicy, typename EqualsPolicy>
+uint32 FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::FindInsertSlot(uint32 hash) const
+{
+    const uint32 groupMask = mCapacity / Group::Width - 1;
+    uint32 groupIndex = GetGroupHash(hash) & groupMask;
+
+    for (uint32 i = 1; i <= groupMask + 1; ++i)
+    {
+        const uint32 groupStart = groupIndex * Group::Width;
+        const uint32 mask = Group(mControl + groupStart).MatchEmptyOrDeleted();
+        if (mask)
+        {
+            return groupStart + BitUtils<uint32>::CountTrailingZeros(mask);
+        }
+
+        groupIndex = (groupIndex + i) & groupMask;
+    }
+
+    return InvalidID;
+}
+
+template<typename KeyType, typename HashPolicy, typename EqualsPolicy>
+uint32 FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::FindNextFullSlot(uint32 index) const
+{
+    if (index >= mCapacity)
+    {
+        return InvalidID;
+    }
+
+    uint32 groupStart = index & ~(Group::Width - 1);
+    uint32 mask = Group(mControl + groupStart).MatchFull() & (Group::FullMask << (index - groupStart));
+
+    for (;;)
+    {
+        if (mask)
+        {
+            return groupStart + BitUtils<uint32>::CountTrailingZeros(mask);
+        }
+
+        groupStart += Group::Width;
+        if (groupStart >= mCapacity)
+        {
+            return InvalidID;
+        }
+
+        mask = Group(mControl + groupStart).MatchFull();
+    }
+}
+
+template<typename KeyType, typename HashPolicy, typename EqualsPolicy>
+bool FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::Rehash(uint32 newCapacity)
+{
+    NFE_ASSERT(newCapacity >= Group::Width && (newCapacity & (newCapacity - 1)) == 0, "Invalid capacity");
+    NFE_ASSERT(CalculateGrowthLimit(newCapacity) >= mSize, "Capacity is too small");
+
+    // single allocation: control bytes followed by the keys
+    const size_t alignment = Group::Width > alignof(KeyType) ? Group::Width : alignof(KeyType);
+    const size_t keysOffset = (static_cast<size_t>(newCapacity) + alignof(KeyType) - 1) & ~(alignof(KeyType) - 1);
+    const size_t allocationSize = keysOffset + sizeof(KeyType) * static_cast<size_t>(newCapacity);
+
+    uint8* newControl = reinterpret_cast<uint8*>(NFE_MALLOC(allocationSize, alignment));
+    if (!newControl)
+    {
+        NFE_LOG_ERROR("Could not allocate space for hash set (capacity: %u)", newCapacity);
+        return false;
+    }
+
+    memset(newControl, Group::Empty, newCapacity);
+
+    uint8* oldControl = mControl;
+    KeyType* oldKeys = mKeys;
+    const uint32 oldCapacity = mCapacity;
+
+    mControl = newControl;
+    mKeys = reinterpret_cast<KeyType*>(newControl + keysOffset);
+    mCapacity = newCapacity;
+    mGrowthLeft = CalculateGrowthLimit(newCapacity) - mSize;
+
+    // move keys from the old buffer
+    for (uint32 i = 0; i < oldCapacity; ++i)
+    {
+        if (oldControl[i] < Group::Empty)
+        {
+            const uint32 hash = CalculateHash(oldKeys[i]);
+            const uint32 slot = FindInsertSlot(hash);
+            NFE_ASSERT(slot != InvalidID, "Failed to move hash set key to new buffer");
+
+            mControl[slot] = GetControlHash(hash);
+            MemoryHelpers::Move<KeyType>(mKeys + slot, oldKeys + i);
+        }
+    }
+
+    NFE_FREE(oldControl);
+    return true;
+}
+
+template<typename KeyType, typename HashPolicy, typename EqualsPolicy>
+bool FlatHashSet<KeyType, HashPolicy, EqualsPolicy>::Verify() const
+{
+    uint32 numFull = 0;
+    uint32 numEmpty = 0;
+    for (uint32 i = 0; i < mCapacity; ++i)
+    {
+        const uint8 control = mControl[i];
+        if (control == Group::Empty)
+        {
+            numEmpty++;
+        }
+        else if (control < Group::Empty)
+        {
+            numFull++;
+
+            const uint32 hash = CalculateHash(mKeys[i]);
+            if (control != GetControlHash(hash))
+            {
+                NFE_LOG_ERROR("Control byte does not match key's hash. Hash set corruption");
+                return false;
+            }
+
+            if (FindSlot(mKeys[i], hash) != i)
+            {
+                NFE_LOG_ERROR("Key is not reachable. Hash set corruption");
+                return false;
+            }
+        }
+        else if (control != Group::Deleted)
+        {
+            NFE_LOG_ERROR("Invalid control byte. Hash set corruption");
+            return false;
+        }
+    }
+
+    if (numFull != mSize)
+    {
+        NFE_LOG_ERROR("Counted elements number does not match. Hash set corruption");
+        return false;
+    }
+
+    if (mCapacity > 0 && mCapacity - numEmpty + mGrowthLeft != CalculateGrowthLimit(mCapacity))
+    {
+        NFE_LOG_ERROR("Growth limit does not match number of used slots. Hash set corruption");
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace Common
+} // namespace NFE
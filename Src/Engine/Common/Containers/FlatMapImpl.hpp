@@ -0,0 +1,147 @@
+/**
+ * @file
+ * @author Witek902 (witek902@gmail.com)
+ * @brief  FlatMap data container definitions
+ */
+
+#pragma once
+
+#include "FlatMap.hpp"
+
+
+namespace NFE {
+namespace Common {
+
+
+template<typename KeyType, typename ValueType, typename Comparator>
+uint32 FlatMap<KeyType, ValueType, Comparator>::Size() const
+{
+    return mSet.Size();
+}
+
+template<typename KeyType, typename ValueType, typename Comparator>
+bool FlatMap<KeyType, ValueType, Comparator>::Empty() const
+{
+    return mSet.Empty();
+}
+
+template<typename KeyType, typename ValueType, typename Comparator>
+void FlatMap<KeyType, ValueType, Comparator>::Clear()
+{
+    mSet.Clear();
+}
+
+template<typename KeyType, typename ValueType, typename Comparator>
+typename FlatMap<KeyType, ValueType, Comparator>::ConstIterator FlatMap<KeyType, ValueType, Comparator>::Begin() const
+{
+    return mSet.Begin();
+}
+
+template<typename KeyType, typename ValueType, typename Comparator>
+typename FlatMap<KeyType, ValueType, Comparator>::Iterator FlatMap<KeyType, ValueType, Comparator>::Begin()
+{
+    return mSet.Begin();
+}
+
+template<typename KeyType, typename ValueType, typename Comparator>
+typename FlatMap<KeyType, ValueType, Comparator>::ConstIterator FlatMap<KeyType, ValueType, Comparator>::End() const
+{
+    return mSet.End();
+}
+
+template<typename KeyType, typename ValueType, typename Comparator>
+typename FlatMap<KeyType, ValueType, Comparator>::Iterator FlatMap<KeyType, ValueType, Comparator>::End()
+{
+    return mSet.End();
+}
+
+template<typename KeyType, typename ValueType, typename Comparator>
+bool FlatMap<KeyType, ValueType, Comparator>::Exists(const KeyType& key) const
+{
+    const InternalKey internalKey(key, ValueType());
+    return mSet.Exists(internalKey);
+}
+
+template<typename KeyType, typename ValueType, typename Comparator>
+typename FlatMap<KeyType, ValueType, Comparator>::ConstIterator FlatMap<KeyType, ValueType, Comparator>::Find(const KeyType& key) const
+{
+    const InternalKey internalKey(key, ValueType());
+    return mSet.Find(internalKey);
+}
+
+template<typename KeyType, typename ValueType, typename Comparator>
+typename FlatMap<KeyType, ValueType, Comparator>::Iterator FlatMap<KeyType, ValueType, Comparator>::Find(const KeyType& key)
+{
+    const InternalKey internalKey(key, ValueType());
+    return mSet.Find(internalKey);
+}
+
+template<typename KeyType, typename ValueType, typename Comparator>
+typename FlatMap<KeyType, ValueType, Comparator>::InsertResult FlatMap<KeyType, ValueType, Comparator>::Insert(const KeyType& key, const ValueType& value)
+{
+    return mSet.Insert(InternalKey(key, value));
+}
+
+
+template<typename KeyType, typename ValueType, typename Comparator>
+typename FlatMap<KeyType, ValueType, Comparator>::InsertResult FlatMap<KeyType, ValueType, Comparator>::Insert(const KeyType& key, ValueType&& value)
+{
+    return mSet.Insert(std::move(InternalKey(key, std::move(value))));
+}
+
+template<typename KeyType, typename ValueType, typename Comparator>
+typename FlatMap<KeyType, ValueType, Comparator>::InsertResult FlatMap<KeyType, ValueType, Comparator>::InsertOrReplace(const KeyType& key, const ValueType& value)
+{
+    return mSet.InsertOrReplace(InternalKey(key, value));
+}
+
+
+template<typename KeyType, typename ValueType, typename Comparator>
+typename FlatMap<KeyType, ValueType, Comparator>::InsertResult FlatMap<KeyType, ValueType, Comparator>::InsertOrReplace(const KeyType& key, ValueType&& value)
+{
+    return mSet.InsertOrReplace(std::move(InternalKey(key, std::move(value))));
+}
+
+template<typename KeyType, typename ValueType, typename Comparator>
+ValueType& FlatMap<KeyType, ValueType, Comparator>::operator[](const KeyType& key)
+{
+    const InternalKey tempKey(key, ValueType());
+    const Iterator iter = mSet.Find(tempKey);
+
+    NFE_ASSERT(iter != mSet.End(), "Given key does not exist in the map");
+
+    return (*iter).second;
+}
+
+template<typename KeyType, typename ValueType, typename Comparator>
+const ValueType& FlatMap<KeyType, ValueType, Comparator>::operator[](const KeyType& key) const
+{
+    const InternalKey tempKey(key, ValueType());
+    const ConstIterator iter = mSet.Find(tempKey);
+
+    NFE_ASSERT(iter != mSet.End(), "Given key does not exist in the map");
+
+    return (*iter).second;
+}
+
+template<typename KeyType, typename ValueType, typename Comparator>
+bool FlatMap<KeyType, ValueType, Comparator>::Erase(const KeyType& key)
+{
+    const InternalKey tempKey(key, ValueType());
+    return mSet.Erase(tempKey);
+}
+
+template<typename KeyType, typename ValueType, typename Comparator>
+bool FlatMap<KeyType, ValueType, Comparator>::Erase(const ConstIterator& iterator)
+{
+    return mSet.Erase(iterator);
+}
+
+template<typename KeyType, typename ValueType, typename Comparator>
+bool FlatMap<KeyType, ValueType, Comparator>::Erase(const Iterator& iterator)
+{
+    return mSet.Erase(iterator);
+}
+
+} // namespace Common
+} // namespace NFE
\ No newline at end of file
@@ -0,0 +1,163 @@
+/**
+ * @file
+ * @author Witek902 (witek902@gmail.com)
+ * @brief  FlatSet data container declaration
+ */
+
+#pragma once
+
+#include "Comparator.hpp"
+#include "DynArray.hpp"
+
+#include "../nfCommon.hpp"
+
+
+namespace NFE {
+namespace Common {
+
+/**
+ * Sorted set container stored in a contiguous sorted array.
+ * Lookups are binary searches over a single buffer and iteration is linear, but insertion and erasure
+ * take O(n) time, so it's intended for read-mostly data (e.g. registries built once).
+ * The API is the same as Set's, so it can be used as a drop-in replacement.
+ *
+ * @note    Iterators are invalidated on insertion and erasure.
+ */
+template<typename KeyType, typename Comparator = DefaultComparator<KeyType>>
+class FlatSet final
+{
+public:
+    using ConstIterator = typename DynArray<KeyType>::ConstIteratorType;
+    using Iterator = typename DynArray<KeyType>::IteratorType;
+
+    // insertion information
+    struct InsertResult final
+    {
+        // iterator to the inserted element
+        const ConstIterator iterator;
+
+        // set to true if the element with given value already existed
+        const bool replaced;
+
+        explicit InsertResult(const ConstIterator& iterator, bool replaced = false)
+            : iterator(iterator)
+            , replaced(replaced)
+        { }
+    };
+
+    FlatSet() = default;
+    FlatSet(const FlatSet& other) = default;
+    FlatSet(FlatSet&& other) = default;
+    FlatSet& operator = (const FlatSet& other) = default;
+    FlatSet& operator = (FlatSet&& other) = default;
+
+    /**
+     * Get number of inserted values.
+     */
+    NFE_INLINE uint32 Size() const { return mKeys.Size(); }
+
+    /**
+     * Check if the set is empty.
+     */
+    NFE_INLINE bool Empty() const { return mKeys.Empty(); }
+
+    /**
+     * Remove all the values and free allocated memory.
+     */
+    NFE_INLINE void Clear() { mKeys.Clear(true); }
+
+    /**
+     * Preallocate memory for given number of values.
+     */
+    NFE_INLINE bool Reserve(uint32 size) { return mKeys.Reserve(size); }
+
+    /**
+     * Replace set content with given keys (sorted in O(n log n) time).
+     * @note    If there are duplicated keys, only the first one is kept.
+     */
+    void Build(DynArray<KeyType>&& keys);
+
+    /**
+     * Get keys as sorted array.
+     */
+    NFE_INLINE const ArrayView<const KeyType> GetKeys() const { return ArrayView<const KeyType>(mKeys.Data(), mKeys.Size()); }
+
+    NFE_INLINE ConstIterator Begin() const { return mKeys.Begin(); }
+    NFE_INLINE Iterator Begin() { return mKeys.Begin(); }
+    NFE_INLINE ConstIterator End() const { return mKeys.End(); }
+    NFE_INLINE Iterator End() { return mKeys.End(); }
+
+    /**
+     * Find element by value.
+     * @note    This operation takes O(log n) time.
+     * @return  Iterator to the found element, or iterator to the end if the element does not exist.
+     */
+    ConstIterator Find(const KeyType& key) const;
+    Iterator Find(const KeyType& key);
+
+    /**
+     * Check if a given key exists.
+     * @note    This operation takes O(log n) time.
+     */
+    NFE_INLINE bool Exists(const KeyType& key) const { return FindIndex(key) != UINT32_MAX; }
+
+    /**
+     * Insert a new element to the set.
+     * @note    This operation takes O(n) time.
+     * @note    If the element already existed, the method will fail.
+     * @return  Structure with insertion information.
+     */
+    InsertResult Insert(const KeyType& key);
+    InsertResult Insert(KeyType&& key);
+
+    /**
+     * Insert a new element to the set or replace existing.
+     * @note    This operation takes O(n) time.
+     * @return  Structure with insertion information.
+     */
+    InsertResult InsertOrReplace(const KeyType& key);
+    InsertResult InsertOrReplace(KeyType&& key);
+
+    /**
+     * Erase an element by value.
+     * @note    This operation takes O(n) time.
+     * @return  True if the element was found and has been removed.
+     */
+    bool Erase(const KeyType& key);
+
+    /**
+     * Erase an element by iterator.
+     * @note    This operation takes O(n) time.
+     * @return  True if the element has been removed.
+     */
+    bool Erase(const ConstIterator& iterator);
+
+    // lower-case aliases for Begin()/End(), required by C++
+    NFE_INLINE ConstIterator begin() const { return Begin(); }
+    NFE_INLINE ConstIterator end() const { return End(); }
+    NFE_INLINE Iterator begin() { return Begin(); }
+    NFE_INLINE Iterator end() { return End(); }
+
+    /**
+     * Verify if the keys are sorted. For debugging only.
+     */
+    bool Verify() const;
+
+private:
+    DynArray<KeyType> mKeys;
+
+    // find first key that is not less than given key
+    uint32 LowerBound(const KeyType& key) const;
+
+    // returns UINT32_MAX if not found
+    uint32 FindIndex(const KeyType& key) const;
+
+    template<typename KeyTypeRef>
+    InsertResult InsertInternal(KeyTypeRef&& key, bool replace);
+};
+
+} // namespace Common
+} // namespace NFE
+
+// FlatSet class definitions go here:
+#include "FlatSetImpl.hpp"
@@ -0,0 +1,195 @@
+/**
+ * @file
+ * @author Witek902 (witek902@gmail.com)
+ * @brief  FlatSet data container definitions
+ */
+
+#pragma once
+
+#include "FlatSet.hpp"
+#include "../Logger/Logger.hpp"
+
+#include <algorithm>
+
+
+namespace NFE {
+namespace Common {
+
+
+template<typename KeyType, typename Comparator>
+void FlatSet<KeyType, Comparator>::Build(DynArray<KeyType>&& keys)
+{
+    const Comparator comparator;
+
+    mKeys = std::move(keys);
+    std::stable_sort(mKeys.Begin(), mKeys.End(), [&comparator] (const KeyType& a, const KeyType& b)
+    {
+        return comparator.Less(a, b);
+    });
+
+    // remove duplicates
+    uint32 numUnique = 0;
+    for (uint32 i = 0; i < mKeys.Size(); ++i)
+    {
+        if (numUnique > 0 && comparator.Equal(mKeys[numUnique - 1], mKeys[i]))
+        {
+            continue;
+        }
+
+        if (numUnique != i)
+        {
+            mKeys[numUnique] = std::move(mKeys[i]);
+        }
+        numUnique++;
+    }
+
+    mKeys.Erase(mKeys.Begin() + numUnique, mKeys.End());
+}
+
+template<typename KeyType, typename Comparator>
+uint32 FlatSet<KeyType, Comparator>::LowerBound(const KeyType& key) const
+{
+    const Comparator comparator;
+
+    uint32 first = 0;
+    uint32 count = mKeys.Size();
+    while (count > 0)
+    {
+        const uint32 step = count / 2;
+        if (comparator.Less(mKeys[first + step], key))
+        {
+            first += step + 1;
+            count -= step + 1;
+        }
+        else
+        {
+            count = step;
+        }
+    }
+
+    return first;
+}
+
+template<typename KeyType, typename Comparator>
+uint32 FlatSet<KeyType, Comparator>::FindIndex(const KeyType& key) const
+{
+    const Comparator comparator;
+
+    const uint32 index = LowerBound(key);
+    if (index < mKeys.Size() && comparator.Equal(mKeys[index], key))
+    {
+        return index;
+    }
+
+    return UINT32_MAX;
+}
+
+template<typename KeyType, typename Comparator>
+typename FlatSet<KeyType, Comparator>::ConstIterator FlatSet<KeyType, Comparator>::Find(const KeyType& key) const
+{
+    const uint32 index = FindIndex(key);
+    return index != UINT32_MAX ? (mKeys.Begin() + index) : mKeys.End();
+}
+
+template<typename KeyType, typename Comparator>
+typename FlatSet<KeyType, Comparator>::Iterator FlatSet<KeyType, Comparator>::Find(const KeyType& key)
+{
+    const uint32 index = FindIndex(key);
+    return index != UINT32_MAX ? (mKeys.Begin() + index) : mKeys.End();
+}
+
+template<typename KeyType, typename Comparator>
+typename FlatSet<KeyType, Comparator>::InsertResult FlatSet<KeyType, Comparator>::Insert(const KeyType& key)
+{
+    return InsertInternal(key, false);
+}
+
+template<typename KeyType, typename Comparator>
+typename FlatSet<KeyType, Comparator>::InsertResult FlatSet<KeyType, Comparator>::Insert(KeyType&& key)
+{
+    return InsertInternal(std::move(key), false);
+}
+
+template<typename KeyType, typename Comparator>
+typename FlatSet<KeyType, Comparator>::InsertResult FlatSet<KeyType, Comparator>::InsertOrReplace(const KeyType& key)
+{
+    return InsertInternal(key, true);
+}
+
+template<typename KeyType, typename Comparator>
+typename FlatSet<KeyType, Comparator>::InsertResult FlatSet<KeyType, Comparator>::InsertOrReplace(KeyType&& key)
+{
+    return InsertInternal(std::move(key), true);
+}
+
+template<typename KeyType, typename Comparator>
+template<typename KeyTypeRef>
+typename FlatSet<KeyType, Comparator>::InsertResult FlatSet<KeyType, Comparator>::InsertInternal(KeyTypeRef&& key, bool replace)
+{
+    const Comparator comparator;
+
+    const uint32 index = LowerBound(key);
+    if (index < mKeys.Size() && comparator.Equal(mKeys[index], key))
+    {
+        if (!replace)
+        {
+            // Insert method cannot replace
+            return InsertResult(End());
+        }
+
+        mKeys[index] = std::forward<KeyTypeRef>(key);
+        return InsertResult(mKeys.Begin() + index, true);
+    }
+
+    const Iterator iter = mKeys.InsertAt(index, std::forward<KeyTypeRef>(key));
+    if (iter == mKeys.End())
+    {
+        NFE_LOG_ERROR("Failed to insert key into flat set");
+        return InsertResult(End());
+    }
+
+    return InsertResult(iter);
+}
+
+template<typename KeyType, typename Comparator>
+bool FlatSet<KeyType, Comparator>::Erase(const KeyType& key)
+{
+    const uint32 index = FindIndex(key);
+    if (index == UINT32_MAX)
+    {
+        return false;
+    }
+
+    return mKeys.Erase(mKeys.Begin() + index);
+}
+
+template<typename KeyType, typename Comparator>
+bool FlatSet<KeyType, Comparator>::Erase(const ConstIterator& iterator)
+{
+    if (iterator == End())
+    {
+        return false;
+    }
+
+    return mKeys.Erase(iterator);
+}
+
+template<typename KeyType, typename Comparator>
+bool FlatSet<KeyType, Comparator>::Verify() const
+{
+    const Comparator comparator;
+
+    for (uint32 i = 1; i < mKeys.Size(); ++i)
+    {
+        if (!comparator.Less(mKeys[i - 1], mKeys[i]))
+        {
+            NFE_LOG_ERROR("Flat set keys are not sorted");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace Common
+} // namespace NFE
@@ -13,8 +13,34 @@
 namespace NFE {
 namespace Common {
 
+/**
+ * Integer hash mixers (full avalanche).
+ * Based on "hash prospector" results (https://github.com/skeeto/hash-prospector) and SplitMix64 finalizer.
+ */
+NFE_INLINE constexpr uint32 MixHash32(uint32 x)
+{
+    x ^= x >> 16;
+    x *= 0x7FEB352Du;
+    x ^= x >> 15;
+    x *= 0x846CA68Bu;
+    x ^= x >> 16;
+    return x;
+}
+
+NFE_INLINE constexpr uint32 MixHash64(uint64 x)
+{
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ull;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBull;
+    x ^= x >> 31;
+    return static_cast<uint32>(x);
+}
+
 /**
  * Generic hash function.
+ * Note: integers are hashed with identity function (which is optimal for HashSet with sequential keys),
+ * so containers relying on all the hash bits (e.g. FlatHashSet) must mix the hash with MixHash32().
  */
 template<typename T>
 uint32 GetHash(const T& x);
@@ -70,11 +96,12 @@ NFE_INLINE constexpr uint32 GetHash<int64>(const int64& x)
 
 /**
  * Hash function for pointers.
+ * Lowest bits of pointers are usually zero due to alignment, so the address must be mixed.
  */
 template<typename T>
-uint32 constexpr GetHash(T* x)
+NFE_INLINE uint32 GetHash(T* x)
 {
-    return GetHash(reinterpret_cast<size_t>(x));
+    return MixHash64(static_cast<uint64>(reinterpret_cast<uintptr_t>(x)));
 }
 
 template<>
@@ -82,7 +109,7 @@ NFE_INLINE uint32 GetHash<float>(const float& x)
 {
     Common::FundamentalTypesUnion bits;
     bits.f = x;
-    return bits.u32;
+    return MixHash32(bits.u32);
 }
 
 template<>
@@ -90,14 +117,20 @@ NFE_INLINE uint32 GetHash<double>(const double& x)
 {
     Common::FundamentalTypesUnion bits;
     bits.d = x;
-    return GetHash(bits.u64);
+    return MixHash64(bits.u64);
 }
 
-
-// TODO hash functions for:
-//  String
-//  pointers
-//  DynArray
+/**
+ * Default hash policy is to call GetHash() global function on key element.
+ */
+template<typename T>
+struct DefaultHashPolicy
+{
+    uint32 operator() (const T& in) const
+    {
+        return GetHash(in);
+    }
+};
 
 
 } // namespace Common
@@ -79,6 +79,11 @@ public:
     using ConstIterator = typename InternalSet::ConstIterator;
     using Iterator = typename InternalSet::Iterator;
 
+    HashMap() = default;
+
+    // initialize empty map using custom allocator
+    NFE_INLINE explicit HashMap(IAllocator* allocator) : mSet(allocator) { }
+
     NFE_INLINE uint32 Size() const;
     NFE_INLINE bool Empty() const;
     NFE_INLINE void Clear();
@@ -7,25 +7,16 @@
 #pragma once
 
 #include "../nfCommon.hpp"
+#include "../Memory/Allocator.hpp"
 #include "Hash.hpp"
 
 namespace NFE {
 namespace Common {
 
-/**
- * Default hash policy is to call GetHash() global function on key element.
- */
-template<typename T>
-struct DefaultHashPolicy
-{
-    uint32 operator() (const T& in) const
-    {
-        return GetHash(in);
-    }
-};
-
 /**
  * Hashed (unordered) set container (like std::unordered_set).
+ * Memory is allocated with the allocator passed in constructor (default allocator if null).
+ * Moved-to set takes over the allocator of the source set.
  */
 template<
     typename KeyType,
@@ -98,6 +89,7 @@ public:
     // basic constructors and assignment operators
     HashSet();
     ~HashSet();
+    explicit HashSet(IAllocator* allocator);
     HashSet(const HashSet& other);
     HashSet(HashSet&& other);
     HashSet& operator = (const HashSet& other);
@@ -232,6 +224,8 @@ private:
     ElementID mFirstFreeElement;    // first free element in the free list (for bucket data)
     ElementID mFirstFreeKey;        // first free key in the keys free list
 
+    IAllocator* mAllocator;         // memory allocator (null means default allocator)
+
     uint32 mNumKeys;                // number of keys inserted to the set
     uint8 mHashBits;                // number of bits of hash in use (this determines number of buckets / allocated elements)
 };
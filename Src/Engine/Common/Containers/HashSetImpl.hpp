@@ -143,11 +143,19 @@ HashSet<KeyType, HashFunction, EqualsPolicy>::HashSet()
     , mBuckets(nullptr)
     , mFirstFreeElement(InvalidID)
     , mFirstFreeKey(InvalidID)
+    , mAllocator(nullptr)
     , mNumKeys(0)
     , mHashBits(0)
 {
 }
 
+template<typename KeyType, typename HashFunction, typename EqualsPolicy>
+HashSet<KeyType, HashFunction, EqualsPolicy>::HashSet(IAllocator* allocator)
+    : HashSet()
+{
+    mAllocator = allocator;
+}
+
 template<typename KeyType, typename HashFunction, typename EqualsPolicy>
 HashSet<KeyType, HashFunction, EqualsPolicy>::~HashSet()
 {
@@ -190,6 +198,7 @@ HashSet<KeyType, HashFunction, EqualsPolicy>& HashSet<KeyType, HashFunction, Equ
 template<typename KeyType, typename HashFunction, typename EqualsPolicy>
 HashSet<KeyType, HashFunction, EqualsPolicy>::HashSet(HashSet&& other)
 {
+    mAllocator = other.mAllocator;
     mKeys = other.mKeys;
     mNextElements = other.mNextElements;
     mBuckets = other.mBuckets;
@@ -210,9 +219,28 @@ HashSet<KeyType, HashFunction, EqualsPolicy>::HashSet(HashSet&& other)
 template<typename KeyType, typename HashFunction, typename EqualsPolicy>
 HashSet<KeyType, HashFunction, EqualsPolicy>& HashSet<KeyType, HashFunction, EqualsPolicy>::operator = (HashSet&& other)
 {
+    if (&other == this)
+        return *this;
+
     // TODO reuse already allocated memory
     Clear();
 
+    if (mAllocator != other.mAllocator)
+    {
+        // memory blocks can't be taken over, move keys one by one
+        Reserve(other.Size());
+
+        for (KeyType& key : other)
+        {
+            const auto insertResult = InsertOrReplace_Internal(key);
+            NFE_ASSERT(insertResult.iterator.mElement != InvalidID, "Failed to move element from the other hash set");
+            new (mKeys + insertResult.iterator.mElement) KeyType(std::move(key));
+        }
+
+        other.Clear();
+        return *this;
+    }
+
     mKeys = other.mKeys;
     mNextElements = other.mNextElements;
     mBuckets = other.mBuckets;
@@ -273,12 +301,12 @@ void HashSet<KeyType, HashFunction, EqualsPolicy>::Clear()
             (*iter).~KeyType();
         }
 
-        NFE_FREE(mKeys);
+        AllocatorFree(mAllocator, mKeys);
         mKeys = nullptr;
     }
 
-    NFE_FREE(mNextElements);
-    NFE_FREE(mBuckets);
+    AllocatorFree(mAllocator, mNextElements);
+    AllocatorFree(mAllocator, mBuckets);
 
     mNextElements = nullptr;
     mBuckets = nullptr;
@@ -508,7 +536,7 @@ bool HashSet<KeyType, HashFunction, EqualsPolicy>::Reserve(uint32 size)
 
     // TODO single malloc
 
-    mKeys = reinterpret_cast<KeyType*>(NFE_MALLOC(sizeof(KeyType) * targetSize, alignof(KeyType)));
+    mKeys = reinterpret_cast<KeyType*>(AllocatorMalloc(mAllocator, sizeof(KeyType) * targetSize, alignof(KeyType)));
     if (!mKeys)
     {
         NFE_LOG_ERROR("Could not allocate space for hash set keys");
@@ -517,7 +545,7 @@ bool HashSet<KeyType, HashFunction, EqualsPolicy>::Reserve(uint32 size)
 
     // initialize bucket heads
     {
-        mBuckets = reinterpret_cast<ElementID*>(NFE_MALLOC(sizeof(ElementID) * targetSize, alignof(ElementID)));
+        mBuckets = reinterpret_cast<ElementID*>(AllocatorMalloc(mAllocator, sizeof(ElementID) * targetSize, alignof(ElementID)));
         if (!mBuckets)
         {
             NFE_LOG_ERROR("Could not allocate space for buckets heads");
@@ -532,7 +560,7 @@ bool HashSet<KeyType, HashFunction, EqualsPolicy>::Reserve(uint32 size)
 
     // initialize linked list
     {
-        mNextElements = reinterpret_cast<ElementID*>(NFE_MALLOC(sizeof(ElementID) * targetSize, alignof(ElementID)));
+        mNextElements = reinterpret_cast<ElementID*>(AllocatorMalloc(mAllocator, sizeof(ElementID) * targetSize, alignof(ElementID)));
         if (!mNextElements)
         {
             NFE_LOG_ERROR("Could not allocate space for next elements indices");
@@ -561,7 +589,7 @@ bool HashSet<KeyType, HashFunction, EqualsPolicy>::Reserve(uint32 size)
 
     NFE_ASSERT(mNumKeys == oldSet.mNumKeys, "Some elements have been lost when moving from old set");
 
-    NFE_FREE(oldSet.mKeys);
+    AllocatorFree(mAllocator, oldSet.mKeys);
     oldSet.mKeys = nullptr;
     oldSet.mNumKeys = 0;
 
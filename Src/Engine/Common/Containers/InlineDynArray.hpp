@@ -0,0 +1,90 @@
+/**
+ * @file
+ * @author Witek902 (witek902@gmail.com)
+ * @brief  Dynamic array with inline storage declaration
+ */
+
+#pragma once
+
+#include "DynArray.hpp"
+#include "../Memory/InlineAllocator.hpp"
+
+
+namespace NFE {
+namespace Common {
+
+/**
+ * Dynamic array that keeps up to N elements inside the object itself (small buffer optimization).
+ * Exceeding the inline capacity moves the elements to a buffer from the upstream allocator.
+ * Can be passed anywhere a DynArray reference is expected. Intended for temporary arrays in hot paths.
+ *
+ * @note    Moving an inline array moves the elements one by one.
+ */
+template<typename ElementType, uint32 N>
+class InlineDynArray final : public DynArray<ElementType>
+{
+public:
+    static_assert(N > 0, "Inline capacity must be greater than zero");
+
+    NFE_INLINE explicit InlineDynArray(IAllocator* upstream = nullptr)
+        : DynArray<ElementType>(&mInlineAllocator)
+        , mInlineAllocator(upstream)
+    {
+        this->Reserve(N);
+    }
+
+    NFE_INLINE InlineDynArray(const std::initializer_list<ElementType>& list)
+        : InlineDynArray()
+    {
+        this->Reserve(static_cast<uint32>(list.size()));
+        for (const ElementType& element : list)
+        {
+            this->PushBack(element);
+        }
+    }
+
+    NFE_INLINE InlineDynArray(const InlineDynArray& other)
+        : InlineDynArray()
+    {
+        DynArray<ElementType>::operator = (other);
+    }
+
+    NFE_INLINE InlineDynArray(InlineDynArray&& other)
+        : InlineDynArray()
+    {
+        DynArray<ElementType>::operator = (std::move(other));
+    }
+
+    // allow assignment from any DynArray
+    using DynArray<ElementType>::operator =;
+
+    NFE_INLINE InlineDynArray& operator = (const InlineDynArray& other)
+    {
+        DynArray<ElementType>::operator = (other);
+        return *this;
+    }
+
+    NFE_INLINE InlineDynArray& operator = (InlineDynArray&& other)
+    {
+        DynArray<ElementType>::operator = (std::move(other));
+        return *this;
+    }
+
+    NFE_INLINE ~InlineDynArray()
+    {
+        // release the buffer before the inline allocator is destroyed
+        this->Clear(true);
+    }
+
+    /**
+     * Check if the elements are stored in the inline buffer.
+     */
+    NFE_INLINE bool IsInline() const { return mInlineAllocator.OwnsBlock(this->Data()); }
+
+private:
+    InlineAllocator<sizeof(ElementType) * N, alignof(ElementType)> mInlineAllocator;
+};
+
+
+} // namespace Common
+} // namespace NFE
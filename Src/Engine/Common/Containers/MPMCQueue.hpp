@@ -0,0 +1,98 @@
+/**
+ * @file
+ * @author Witek902 (witek902@gmail.com)
+ * @brief  Lock-free multi-producer multi-consumer queue declaration
+ */
+
+#pragma once
+
+#include "../nfCommon.hpp"
+#include "../Memory/Allocator.hpp"
+
+#include <atomic>
+
+
+namespace NFE {
+namespace Common {
+
+/**
+ * Bounded lock-free queue for any number of producer and consumer threads.
+ *
+ * Ring buffer of cells, each with a sequence number telling which "lap" the cell is ready for
+ * (based on D. Vyukov's bounded MPMC queue). Producers and consumers claim positions with a CAS
+ * on their own counter, then publish the cell by storing the next sequence number with release
+ * semantics. There is no shared state other than the two counters and the cell being accessed.
+ *
+ * @note    Push/Pop may fail spuriously if a thread that claimed a position was preempted
+ *          before finishing the operation (the queue is not lock-free in a strict sense).
+ */
+template<typename ElementType>
+class MPMCQueue final
+{
+    NFE_MAKE_NONCOPYABLE(MPMCQueue)
+    NFE_MAKE_NONMOVEABLE(MPMCQueue)
+
+public:
+    /**
+     * @param capacity  Maximum number of elements (rounded up to a power of two, at least 2).
+     */
+    explicit MPMCQueue(uint32 capacity, IAllocator* allocator = nullptr);
+    ~MPMCQueue();
+
+    NFE_FORCE_INLINE uint32 GetCapacity() const { return mCells ? mMask + 1 : 0; }
+
+    /**
+     * Insert a new element at the end.
+     * @return  'False' if the queue is full.
+     */
+    bool Push(const ElementType& element);
+    bool Push(ElementType&& element);
+
+    /**
+     * In-place construct a new element at the end.
+     * @return  'False' if the queue is full.
+     */
+    template<typename ... Args>
+    bool Emplace(Args&& ... args);
+
+    /**
+     * Remove the front element.
+     * @return  'False' if the queue is empty.
+     */
+    bool Pop(ElementType& outElement);
+
+    /**
+     * Get number of elements. The value is approximate if the queue is being modified.
+     */
+    uint32 Size() const;
+    bool Empty() const { return Size() == 0; }
+
+private:
+    struct Cell
+    {
+        std::atomic<uint32> sequence;
+        alignas(ElementType) uint8 storage[sizeof(ElementType)];
+
+        NFE_FORCE_INLINE ElementType* GetElement() { return reinterpret_cast<ElementType*>(storage); }
+    };
+
+    struct NFE_ALIGN(NFE_CACHE_LINE_SIZE) Position
+    {
+        std::atomic<uint32> value;
+    };
+
+    Position mEnqueuePos;
+    Position mDequeuePos;
+
+    Cell* mCells;
+    uint32 mMask;
+    IAllocator* mAllocator;
+};
+
+
+} // namespace Common
+} // namespace NFE
+
+
+// MPMCQueue class definitions go here:
+#include "MPMCQueueImpl.hpp"
@@ -0,0 +1,175 @@
+/**
+ * @file
+ * @author Witek902 (witek902@gmail.com)
+ * @brief  Lock-free multi-producer multi-consumer queue definition
+ */
+
+#pragma once
+
+#include "MPMCQueue.hpp"
+#include "../Math/Math.hpp"
+#include "../Logger/Logger.hpp"
+#include "../System/Assertion.hpp"
+
+
+namespace NFE {
+namespace Common {
+
+template<typename ElementType>
+MPMCQueue<ElementType>::MPMCQueue(uint32 capacity, IAllocator* allocator)
+    : mCells(nullptr)
+    , mMask(0)
+    , mAllocator(allocator)
+{
+    mEnqueuePos.value.store(0, std::memory_order_relaxed);
+    mDequeuePos.value.store(0, std::memory_order_relaxed);
+
+    // positions are compared as signed differences, so the capacity must stay well below 2^31
+    NFE_ASSERT(capacity > 0 && capacity <= (1u << 30), "Invalid queue capacity");
+    capacity = Math::NextPowerOfTwo(Math::Max(capacity, 2u));
+
+    mCells = static_cast<Cell*>(AllocatorMalloc(mAllocator, sizeof(Cell) * capacity, alignof(Cell)));
+    if (!mCells)
+    {
+        NFE_LOG_ERROR("Failed to allocate memory for MPMCQueue");
+        return;
+    }
+
+    for (uint32 i = 0; i < capacity; ++i)
+    {
+        new (&mCells[i].sequence) std::atomic<uint32>(i);
+    }
+
+    mMask = capacity - 1;
+}
+
+template<typename ElementType>
+MPMCQueue<ElementType>::~MPMCQueue()
+{
+    if (mCells)
+    {
+        const uint32 enqueuePos = mEnqueuePos.value.load(std::memory_order_relaxed);
+        for (uint32 i = mDequeuePos.value.load(std::memory_order_relaxed); i != enqueuePos; ++i)
+        {
+            mCells[i & mMask].GetElement()->~ElementType();
+        }
+
+        AllocatorFree(mAllocator, mCells);
+    }
+}
+
+template<typename ElementType>
+bool MPMCQueue<ElementType>::Push(const ElementType& element)
+{
+    return Emplace(element);
+}
+
+template<typename ElementType>
+bool MPMCQueue<ElementType>::Push(ElementType&& element)
+{
+    return Emplace(std::move(element));
+}
+
+template<typename ElementType>
+template<typename ... Args>
+bool MPMCQueue<ElementType>::Emplace(Args&& ... args)
+{
+    if (!mCells)
+    {
+        return false;
+    }
+
+    Cell* cell;
+    uint32 pos = mEnqueuePos.value.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        cell = &mCells[pos & mMask];
+
+        // acquire: the consumer of the previous lap finished with the cell
+        const uint32 sequence = cell->sequence.load(std::memory_order_acquire);
+        const int32 diff = static_cast<int32>(sequence - pos);
+
+        if (diff == 0)
+        {
+            // the cell is free in this lap, try to claim the position
+            if (mEnqueuePos.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            // the cell is still occupied from the previous lap
+            return false;
+        }
+        else
+        {
+            // other producer claimed the position
+            pos = mEnqueuePos.value.load(std::memory_order_relaxed);
+        }
+    }
+
+    new (cell->GetElement()) ElementType(std::forward<Args>(args) ...);
+
+    // release: publish the element to consumers of this lap
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+template<typename ElementType>
+bool MPMCQueue<ElementType>::Pop(ElementType& outElement)
+{
+    if (!mCells)
+    {
+        return false;
+    }
+
+    Cell* cell;
+    uint32 pos = mDequeuePos.value.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        cell = &mCells[pos & mMask];
+
+        // acquire: pairs with the release in Emplace()
+        const uint32 sequence = cell->sequence.load(std::memory_order_acquire);
+        const int32 diff = static_cast<int32>(sequence - (pos + 1));
+
+        if (diff == 0)
+        {
+            if (mDequeuePos.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            // nothing was published in this cell yet
+            return false;
+        }
+        else
+        {
+            pos = mDequeuePos.value.load(std::memory_order_relaxed);
+        }
+    }
+
+    ElementType* element = cell->GetElement();
+    outElement = std::move(*element);
+    element->~ElementType();
+
+    // release: the cell can be reused by producers of the next lap
+    cell->sequence.store(pos + mMask + 1, std::memory_order_release);
+    return true;
+}
+
+template<typename ElementType>
+uint32 MPMCQueue<ElementType>::Size() const
+{
+    const uint32 dequeuePos = mDequeuePos.value.load(std::memory_order_acquire);
+    const uint32 enqueuePos = mEnqueuePos.value.load(std::memory_order_acquire);
+    const int32 size = static_cast<int32>(enqueuePos - dequeuePos);
+    return size > 0 ? static_cast<uint32>(size) : 0;
+}
+
+
+} // namespace Common
+} // namespace NFE
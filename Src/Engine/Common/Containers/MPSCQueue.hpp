@@ -0,0 +1,88 @@
+/**
+ * @file
+ * @author Witek902 (witek902@gmail.com)
+ * @brief  Lock-free multi-producer single-consumer queue declaration
+ */
+
+#pragma once
+
+#include "../nfCommon.hpp"
+#include "../Memory/Allocator.hpp"
+
+#include <atomic>
+
+
+namespace NFE {
+namespace Common {
+
+/**
+ * Unbounded lock-free queue for any number of producer threads and one consumer thread.
+ *
+ * Singly linked list of nodes (based on D. Vyukov's non-intrusive MPSC queue). A producer appends
+ * a node with a single atomic exchange of the head and then links it to the previous node with
+ * a release store. The consumer follows the links from the tail, the first node is always a dummy.
+ * Every element requires a node allocation.
+ *
+ * @note    An element is visible to the consumer only after its producer linked the node, so Pop()
+ *          can report an empty queue while a preempted producer is between the two steps.
+ */
+template<typename ElementType>
+class MPSCQueue final
+{
+    NFE_MAKE_NONCOPYABLE(MPSCQueue)
+    NFE_MAKE_NONMOVEABLE(MPSCQueue)
+
+public:
+    explicit MPSCQueue(IAllocator* allocator = nullptr);
+    ~MPSCQueue();
+
+    /**
+     * Producer: insert a new element at the end.
+     * @return  'False' on memory allocation failure.
+     */
+    bool Push(const ElementType& element);
+    bool Push(ElementType&& element);
+
+    /**
+     * Producer: in-place construct a new element at the end.
+     * @return  'False' on memory allocation failure.
+     */
+    template<typename ... Args>
+    bool Emplace(Args&& ... args);
+
+    /**
+     * Consumer: remove the front element.
+     * @return  'False' if the queue is empty.
+     */
+    bool Pop(ElementType& outElement);
+
+    /**
+     * Consumer: check if there is any element to pop.
+     */
+    bool Empty() const;
+
+private:
+    struct Node
+    {
+        std::atomic<Node*> next;
+        alignas(ElementType) uint8 storage[sizeof(ElementType)];
+
+        NFE_FORCE_INLINE ElementType* GetElement() { return reinterpret_cast<ElementType*>(storage); }
+    };
+
+    // most recently pushed node (written by producers)
+    NFE_ALIGN(NFE_CACHE_LINE_SIZE) std::atomic<Node*> mHead;
+
+    // dummy node preceding the front element (owned by the consumer)
+    NFE_ALIGN(NFE_CACHE_LINE_SIZE) Node* mTail;
+    Node mStub;
+    IAllocator* mAllocator;
+};
+
+
+} // namespace Common
+} // namespace NFE
+
+
+// MPSCQueue class definitions go here:
+#include "MPSCQueueImpl.hpp"
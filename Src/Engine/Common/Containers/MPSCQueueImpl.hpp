@@ -0,0 +1,118 @@
+/**
+ * @file
+ * @author Witek902 (witek902@gmail.com)
+ * @brief  Lock-free multi-producer single-consumer queue definition
+ */
+
+#pragma once
+
+#include "MPSCQueue.hpp"
+#include "../Logger/Logger.hpp"
+
+
+namespace NFE {
+namespace Common {
+
+template<typename ElementType>
+MPSCQueue<ElementType>::MPSCQueue(IAllocator* allocator)
+    : mHead(&mStub)
+    , mTail(&mStub)
+    , mAllocator(allocator)
+{
+    mStub.next.store(nullptr, std::memory_order_relaxed);
+}
+
+template<typename ElementType>
+MPSCQueue<ElementType>::~MPSCQueue()
+{
+    Node* node = mTail;
+
+    // the first node is a dummy (its element was popped already or it's the stub)
+    Node* next = node->next.load(std::memory_order_relaxed);
+    if (node != &mStub)
+    {
+        AllocatorFree(mAllocator, node);
+    }
+
+    while (next)
+    {
+        node = next;
+        next = node->next.load(std::memory_order_relaxed);
+
+        node->GetElement()->~ElementType();
+        if (node != &mStub)
+        {
+            AllocatorFree(mAllocator, node);
+        }
+    }
+}
+
+template<typename ElementType>
+bool MPSCQueue<ElementType>::Push(const ElementType& element)
+{
+    return Emplace(element);
+}
+
+template<typename ElementType>
+bool MPSCQueue<ElementType>::Push(ElementType&& element)
+{
+    return Emplace(std::move(element));
+}
+
+template<typename ElementType>
+template<typename ... Args>
+bool MPSCQueue<ElementType>::Emplace(Args&& ... args)
+{
+    Node* node = static_cast<Node*>(AllocatorMalloc(mAllocator, sizeof(Node), alignof(Node)));
+    if (!node)
+    {
+        NFE_LOG_ERROR("Failed to allocate node for MPSCQueue");
+        return false;
+    }
+
+    new (&node->next) std::atomic<Node*>(nullptr);
+    new (node->GetElement()) ElementType(std::forward<Args>(args) ...);
+
+    // serialize producers, acquire-release orders the link store below after the previous node's initialization
+    Node* prev = mHead.exchange(node, std::memory_order_acq_rel);
+
+    // release: publish the node (and the element) to the consumer
+    prev->next.store(node, std::memory_order_release);
+    return true;
+}
+
+template<typename ElementType>
+bool MPSCQueue<ElementType>::Pop(ElementType& outElement)
+{
+    Node* tail = mTail;
+
+    // acquire: pairs with the release in Emplace()
+    Node* next = tail->next.load(std::memory_order_acquire);
+    if (!next)
+    {
+        return false;
+    }
+
+    // the popped node becomes the new dummy
+    ElementType* element = next->GetElement();
+    outElement = std::move(*element);
+    element->~ElementType();
+    mTail = next;
+
+    if (tail != &mStub)
+    {
+        AllocatorFree(mAllocator, tail);
+    }
+
+    return true;
+}
+
+template<typename ElementType>
+bool MPSCQueue<ElementType>::Empty() const
+{
+    return mTail->next.load(std::memory_order_acquire) == nullptr;
+}
+
+
+} // namespace Common
+} // namespace NFE
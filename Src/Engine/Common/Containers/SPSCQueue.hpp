@@ -0,0 +1,96 @@
+/**
+ * @file
+ * @author Witek902 (witek902@gmail.com)
+ * @brief  Lock-free single-producer single-consumer queue declaration
+ */
+
+#pragma once
+
+#include "../nfCommon.hpp"
+#include "../Memory/Allocator.hpp"
+
+#include <atomic>
+
+
+namespace NFE {
+namespace Common {
+
+/**
+ * Bounded lock-free queue for exactly one producer thread and one consumer thread.
+ *
+ * Elements are stored in a ring buffer. The producer owns the tail index, the consumer owns the head index,
+ * each of them publishes its index with a release store and reads the other one with an acquire load.
+ * Both sides cache the last seen index of the other side, so the shared cache lines are touched only
+ * when the queue looks full (producer) or empty (consumer).
+ */
+template<typename ElementType>
+class SPSCQueue final
+{
+    NFE_MAKE_NONCOPYABLE(SPSCQueue)
+    NFE_MAKE_NONMOVEABLE(SPSCQueue)
+
+public:
+    /**
+     * @param capacity  Maximum number of elements (rounded up to a power of two).
+     */
+    explicit SPSCQueue(uint32 capacity, IAllocator* allocator = nullptr);
+    ~SPSCQueue();
+
+    NFE_FORCE_INLINE uint32 GetCapacity() const { return mCapacity; }
+
+    /**
+     * Producer: insert a new element at the end.
+     * @return  'False' if the queue is full.
+     */
+    bool Push(const ElementType& element);
+    bool Push(ElementType&& element);
+
+    /**
+     * Producer: in-place construct a new element at the end.
+     * @return  'False' if the queue is full.
+     */
+    template<typename ... Args>
+    bool Emplace(Args&& ... args);
+
+    /**
+     * Consumer: remove the front element.
+     * @return  'False' if the queue is empty.
+     */
+    bool Pop(ElementType& outElement);
+
+    /**
+     * Get number of elements. The value is approximate if the queue is being modified.
+     */
+    uint32 Size() const;
+    bool Empty() const { return Size() == 0; }
+
+private:
+    // indices grow monotonically and are wrapped with the mask when accessing the buffer
+    struct NFE_ALIGN(NFE_CACHE_LINE_SIZE) ProducerData
+    {
+        std::atomic<uint32> tail;
+        uint32 cachedHead;
+    };
+
+    struct NFE_ALIGN(NFE_CACHE_LINE_SIZE) ConsumerData
+    {
+        std::atomic<uint32> head;
+        uint32 cachedTail;
+    };
+
+    ProducerData mProducer;
+    ConsumerData mConsumer;
+
+    ElementType* mElements;
+    uint32 mCapacity;
+    uint32 mMask;
+    IAllocator* mAllocator;
+};
+
+
+} // namespace Common
+} // namespace NFE
+
+
+// SPSCQueue class definitions go here:
+#include "SPSCQueueImpl.hpp"
@@ -0,0 +1,126 @@
+/**
+ * @file
+ * @author Witek902 (witek902@gmail.com)
+ * @brief  Lock-free single-producer single-consumer queue definition
+ */
+
+#pragma once
+
+#include "SPSCQueue.hpp"
+#include "../Math/Math.hpp"
+#include "../Logger/Logger.hpp"
+#include "../System/Assertion.hpp"
+
+
+namespace NFE {
+namespace Common {
+
+template<typename ElementType>
+SPSCQueue<ElementType>::SPSCQueue(uint32 capacity, IAllocator* allocator)
+    : mElements(nullptr)
+    , mCapacity(0)
+    , mMask(0)
+    , mAllocator(allocator)
+{
+    mProducer.tail.store(0, std::memory_order_relaxed);
+    mProducer.cachedHead = 0;
+    mConsumer.head.store(0, std::memory_order_relaxed);
+    mConsumer.cachedTail = 0;
+
+    NFE_ASSERT(capacity > 0 && capacity <= (1u << 31), "Invalid queue capacity");
+    capacity = Math::NextPowerOfTwo(capacity);
+
+    mElements = static_cast<ElementType*>(AllocatorMalloc(mAllocator, sizeof(ElementType) * capacity, alignof(ElementType)));
+    if (!mElements)
+    {
+        // with zero capacity the queue is always full
+        NFE_LOG_ERROR("Failed to allocate memory for SPSCQueue");
+        return;
+    }
+
+    mCapacity = capacity;
+    mMask = capacity - 1;
+}
+
+template<typename ElementType>
+SPSCQueue<ElementType>::~SPSCQueue()
+{
+    const uint32 tail = mProducer.tail.load(std::memory_order_relaxed);
+    for (uint32 i = mConsumer.head.load(std::memory_order_relaxed); i != tail; ++i)
+    {
+        mElements[i & mMask].~ElementType();
+    }
+
+    AllocatorFree(mAllocator, mElements);
+}
+
+template<typename ElementType>
+bool SPSCQueue<ElementType>::Push(const ElementType& element)
+{
+    return Emplace(element);
+}
+
+template<typename ElementType>
+bool SPSCQueue<ElementType>::Push(ElementType&& element)
+{
+    return Emplace(std::move(element));
+}
+
+template<typename ElementType>
+template<typename ... Args>
+bool SPSCQueue<ElementType>::Emplace(Args&& ... args)
+{
+    const uint32 tail = mProducer.tail.load(std::memory_order_relaxed);
+
+    if (tail - mProducer.cachedHead >= mCapacity)
+    {
+        // acquire: the consumer finished reading the slot before publishing the head
+        mProducer.cachedHead = mConsumer.head.load(std::memory_order_acquire);
+        if (tail - mProducer.cachedHead >= mCapacity)
+        {
+            return false;
+        }
+    }
+
+    new (mElements + (tail & mMask)) ElementType(std::forward<Args>(args) ...);
+
+    // release: the element is constructed before the consumer can see it
+    mProducer.tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+template<typename ElementType>
+bool SPSCQueue<ElementType>::Pop(ElementType& outElement)
+{
+    const uint32 head = mConsumer.head.load(std::memory_order_relaxed);
+
+    if (head == mConsumer.cachedTail)
+    {
+        // acquire: pairs with the release in Emplace()
+        mConsumer.cachedTail = mProducer.tail.load(std::memory_order_acquire);
+        if (head == mConsumer.cachedTail)
+        {
+            return false;
+        }
+    }
+
+    ElementType& element = mElements[head & mMask];
+    outElement = std::move(element);
+    element.~ElementType();
+
+    // release: the slot is not accessed anymore, so the producer can reuse it
+    mConsumer.head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+template<typename ElementType>
+uint32 SPSCQueue<ElementType>::Size() const
+{
+    const uint32 head = mConsumer.head.load(std::memory_order_acquire);
+    const uint32 tail = mProducer.tail.load(std::memory_order_acquire);
+    return tail - head;
+}
+
+
+} // namespace Common
+} // namespace NFE
@@ -0,0 +1,214 @@
+/**
+ * @file
+ * @author Witek902 (witek902@gmail.com)
+ * @brief  Segmented array declarations
+ */
+
+#pragma once
+
+#include "../nfCommon.hpp"
+#include "../Memory/Allocator.hpp"
+#include "../System/Mutex.hpp"
+
+#include <atomic>
+
+
+namespace NFE {
+namespace Common {
+
+/**
+ * Get default number of elements in a segment of SegmentedArray (segments of about 64KB).
+ */
+constexpr uint32 GetDefaultSegmentSize(size_t elementSize)
+{
+    uint32 size = 16;
+    while (size < (1u << 20) && 2 * size * elementSize <= 64 * 1024)
+    {
+        size *= 2;
+    }
+    return size;
+}
+
+constexpr uint32 GetSegmentShift(uint32 segmentSize)
+{
+    uint32 shift = 0;
+    while ((1u << shift) < segmentSize)
+    {
+        shift++;
+    }
+    return shift;
+}
+
+/**
+ * Dynamic array stored in fixed-size segments.
+ *
+ * Growing the array only allocates new segments, so elements are never moved, pointers to them
+ * stay valid until the element is removed and there is no memory spike when a large array grows.
+ * Element access is O(1) (segment table lookup).
+ *
+ * Threading:
+ * ReserveRange() and EmplaceBackConcurrent() can be called from multiple threads at once and
+ * concurrently with the element access. Other modifying methods are not thread-safe.
+ * Elements reserved by one thread must not be accessed by other threads without synchronization.
+ *
+ * Memory is allocated with the allocator passed in constructor (default allocator if null).
+ */
+template<typename ElementType, uint32 SegmentSize = GetDefaultSegmentSize(sizeof(ElementType))>
+class SegmentedArray final
+{
+    static_assert(SegmentSize > 0 && (SegmentSize & (SegmentSize - 1)) == 0, "Segment size must be a power of two");
+
+public:
+    static constexpr uint32 InvalidIndex = UINT32_MAX;
+
+    template<typename ArrayType, typename ValueType>
+    class IteratorBase
+    {
+    public:
+        NFE_FORCE_INLINE IteratorBase() : mArray(nullptr), mIndex(0) { }
+        NFE_FORCE_INLINE IteratorBase(ArrayType* array, uint32 index) : mArray(array), mIndex(index) { }
+
+        NFE_FORCE_INLINE ValueType& operator * () const { return (*mArray)[mIndex]; }
+        NFE_FORCE_INLINE ValueType* operator -> () const { return &(*mArray)[mIndex]; }
+        NFE_FORCE_INLINE IteratorBase& operator ++ () { ++mIndex; return *this; }
+        NFE_FORCE_INLINE IteratorBase& operator -- () { --mIndex; return *this; }
+        NFE_FORCE_INLINE bool operator == (const IteratorBase& other) const { return mArray == other.mArray && mIndex == other.mIndex; }
+        NFE_FORCE_INLINE bool operator != (const IteratorBase& other) const { return !(*this == other); }
+        NFE_FORCE_INLINE uint32 GetIndex() const { return mIndex; }
+
+    private:
+        ArrayType* mArray;
+        uint32 mIndex;
+    };
+
+    using Iterator = IteratorBase<SegmentedArray, ElementType>;
+    using ConstIterator = IteratorBase<const SegmentedArray, const ElementType>;
+
+    NFE_INLINE SegmentedArray();
+    NFE_INLINE explicit SegmentedArray(IAllocator* allocator);
+    NFE_INLINE ~SegmentedArray();
+    SegmentedArray(const SegmentedArray& other);
+    SegmentedArray(SegmentedArray&& other);
+    SegmentedArray& operator = (const SegmentedArray& other);
+    SegmentedArray& operator = (SegmentedArray&& other);
+
+    NFE_FORCE_INLINE uint32 Size() const { return mSize.load(std::memory_order_relaxed); }
+    NFE_FORCE_INLINE bool Empty() const { return Size() == 0; }
+
+    /**
+     * Get number of elements that can be stored without allocating new segments.
+     */
+    NFE_FORCE_INLINE uint32 GetCapacity() const { return mSegmentsNum.load(std::memory_order_relaxed) * SegmentSize; }
+
+    // element access
+    NFE_FORCE_INLINE ElementType& operator[](uint32 index);
+    NFE_FORCE_INLINE const ElementType& operator[](uint32 index) const;
+    NFE_INLINE ElementType& Front();
+    NFE_INLINE const ElementType& Front() const;
+    NFE_INLINE ElementType& Back();
+    NFE_INLINE const ElementType& Back() const;
+
+    // iteration
+    NFE_INLINE Iterator Begin() { return Iterator(this, 0); }
+    NFE_INLINE Iterator End() { return Iterator(this, Size()); }
+    NFE_INLINE ConstIterator Begin() const { return ConstIterator(this, 0); }
+    NFE_INLINE ConstIterator End() const { return ConstIterator(this, Size()); }
+    NFE_INLINE Iterator begin() { return Begin(); }
+    NFE_INLINE Iterator end() { return End(); }
+    NFE_INLINE ConstIterator begin() const { return Begin(); }
+    NFE_INLINE ConstIterator end() const { return End(); }
+
+    /**
+     * Remove all the elements. Segment tables replaced during concurrent growth are released as well.
+     * @param freeMemory    Release the segments?
+     */
+    void Clear(bool freeMemory = false);
+
+    /**
+     * Insert a new element at the end.
+     * @return  Index of the inserted element, or InvalidIndex if the insertion failed.
+     */
+    uint32 PushBack(const ElementType& element);
+    uint32 PushBack(ElementType&& element);
+
+    /**
+     * In-place construct a new element at the end.
+     * @return  Index of the inserted element, or InvalidIndex if the insertion failed.
+     */
+    template<typename ... Args>
+    uint32 EmplaceBack(Args&& ... args);
+
+    /**
+     * Remove the last element.
+     * @return  'False' if the array was empty.
+     */
+    bool PopBack();
+
+    /**
+     * Change number of elements (new elements are default-constructed).
+     * @return  'True' on success, 'false' on memory allocation failure.
+     */
+    bool Resize(uint32 size);
+
+    /**
+     * Allocate segments for given number of elements.
+     * @return  'True' on success, 'false' on memory allocation failure.
+     */
+    bool Reserve(uint32 size);
+
+    /**
+     * Thread-safe: append 'count' default-constructed elements.
+     * Intended for parallel filling - each thread reserves a range and writes to it without contention.
+     * @return  Index of the first element of the range, or InvalidIndex on memory allocation failure.
+     */
+    uint32 ReserveRange(uint32 count);
+
+    /**
+     * Thread-safe: in-place construct a new element at the end.
+     * @return  Index of the inserted element, or InvalidIndex if the insertion failed.
+     */
+    template<typename ... Args>
+    uint32 EmplaceBackConcurrent(Args&& ... args);
+
+private:
+    static constexpr uint32 SegmentShift = GetSegmentShift(SegmentSize);
+    static constexpr uint32 SegmentMask = SegmentSize - 1;
+    static constexpr uint32 InitialTableCapacity = 8;
+
+    // segment pointers table, replaced tables are kept alive for concurrent readers
+    struct SegmentTable
+    {
+        SegmentTable* retired;
+        uint32 capacity;
+        ElementType* segments[1];
+    };
+
+    std::atomic<SegmentTable*> mTable;
+    std::atomic<uint32> mSegmentsNum;
+    std::atomic<uint32> mSize;
+    IAllocator* mAllocator;
+    Mutex mGrowLock;
+
+    // make sure there are enough segments for 'size' elements (thread-safe)
+    bool EnsureSegments(uint32 size);
+    bool GrowTable(uint32 segmentsNum);
+
+    // reserve a range of elements (thread-safe)
+    uint32 AcquireRange(uint32 count);
+
+    void DestroyElements(uint32 from, uint32 to);
+    void FreeSegments();
+
+    // release segment tables replaced by GrowTable (no concurrent readers can exist)
+    void FreeRetiredTables();
+
+    NFE_FORCE_INLINE ElementType* GetElementPtr(uint32 index) const;
+};
+
+
+} // namespace Common
+} // namespace NFE
+
+
+// SegmentedArray class definitions go here:
+#include "SegmentedArrayImpl.hpp"
@@ -0,0 +1,438 @@
+/**
+ * @file
+ * @author Witek902 (witek902@gmail.com)
+ * @brief  Segmented array definitions
+ */
+
+#pragma once
+
+#include "SegmentedArray.hpp"
+#include "../Memory/MemoryHelpers.hpp"
+#include "../Logger/Logger.hpp"
+#include "../System/Assertion.hpp"
+
+
+namespace NFE {
+namespace Common {
+
+template<typename ElementType, uint32 SegmentSize>
+SegmentedArray<ElementType, SegmentSize>::SegmentedArray()
+    : mTable(nullptr)
+    , mSegmentsNum(0)
+    , mSize(0)
+    , mAllocator(nullptr)
+{
+}
+
+template<typename ElementType, uint32 SegmentSize>
+SegmentedArray<ElementType, SegmentSize>::SegmentedArray(IAllocator* allocator)
+    : mTable(nullptr)
+    , mSegmentsNum(0)
+    , mSize(0)
+    , mAllocator(allocator)
+{
+}
+
+template<typename ElementType, uint32 SegmentSize>
+SegmentedArray<ElementType, SegmentSize>::~SegmentedArray()
+{
+    Clear(true);
+}
+
+template<typename ElementType, uint32 SegmentSize>
+SegmentedArray<ElementType, SegmentSize>::SegmentedArray(const SegmentedArray& other)
+    : SegmentedArray()
+{
+    *this = other;
+}
+
+template<typename ElementType, uint32 SegmentSize>
+SegmentedArray<ElementType, SegmentSize>::SegmentedArray(SegmentedArray&& other)
+    : SegmentedArray()
+{
+    *this = std::move(other);
+}
+
+template<typename ElementType, uint32 SegmentSize>
+SegmentedArray<ElementType, SegmentSize>& SegmentedArray<ElementType, SegmentSize>::operator = (const SegmentedArray& other)
+{
+    if (&other == this)
+        return *this;
+
+    Clear();
+
+    const uint32 size = other.Size();
+    if (!Reserve(size))
+    {
+        NFE_LOG_ERROR("Failed to reserve memory for SegmentedArray");
+        return *this;
+    }
+
+    for (uint32 i = 0; i < size; ++i)
+    {
+        new (GetElementPtr(i)) ElementType(other[i]);
+    }
+    mSize.store(size, std::memory_order_relaxed);
+
+    return *this;
+}
+
+template<typename ElementType, uint32 SegmentSize>
+SegmentedArray<ElementType, SegmentSize>& SegmentedArray<ElementType, SegmentSize>::operator = (SegmentedArray&& other)
+{
+    if (&other == this)
+        return *this;
+
+    if (mAllocator != other.mAllocator)
+    {
+        // segments can't be taken over
+        Clear();
+
+        const uint32 size = other.Size();
+        if (!Reserve(size))
+        {
+            NFE_LOG_ERROR("Failed to reserve memory for SegmentedArray");
+            return *this;
+        }
+
+        for (uint32 i = 0; i < size; ++i)
+        {
+            new (GetElementPtr(i)) ElementType(std::move(other[i]));
+        }
+        mSize.store(size, std::memory_order_relaxed);
+
+        other.Clear();
+        return *this;
+    }
+
+    Clear(true);
+
+    mTable.store(other.mTable.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    mSegmentsNum.store(other.mSegmentsNum.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    mSize.store(other.mSize.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+    other.mTable.store(nullptr, std::memory_order_relaxed);
+    other.mSegmentsNum.store(0, std::memory_order_relaxed);
+    other.mSize.store(0, std::memory_order_relaxed);
+
+    return *this;
+}
+
+template<typename ElementType, uint32 SegmentSize>
+ElementType* SegmentedArray<ElementType, SegmentSize>::GetElementPtr(uint32 index) const
+{
+    const SegmentTable* table = mTable.load(std::memory_order_acquire);
+    return table->segments[index >> SegmentShift] + (index & SegmentMask);
+}
+
+template<typename ElementType, uint32 SegmentSize>
+ElementType& SegmentedArray<ElementType, SegmentSize>::operator[](uint32 index)
+{
+    NFE_ASSERT(index < Size(), "Invalid index");
+    return *GetElementPtr(index);
+}
+
+template<typename ElementType, uint32 SegmentSize>
+const ElementType& SegmentedArray<ElementType, SegmentSize>::operator[](uint32 index) const
+{
+    NFE_ASSERT(index < Size(), "Invalid index");
+    return *GetElementPtr(index);
+}
+
+template<typename ElementType, uint32 SegmentSize>
+ElementType& SegmentedArray<ElementType, SegmentSize>::Front()
+{
+    NFE_ASSERT(!Empty(), "Array is empty");
+    return *GetElementPtr(0);
+}
+
+template<typename ElementType, uint32 SegmentSize>
+const ElementType& SegmentedArray<ElementType, SegmentSize>::Front() const
+{
+    NFE_ASSERT(!Empty(), "Array is empty");
+    return *GetElementPtr(0);
+}
+
+template<typename ElementType, uint32 SegmentSize>
+ElementType& SegmentedArray<ElementType, SegmentSize>::Back()
+{
+    NFE_ASSERT(!Empty(), "Array is empty");
+    return *GetElementPtr(Size() - 1);
+}
+
+template<typename ElementType, uint32 SegmentSize>
+const ElementType& SegmentedArray<ElementType, SegmentSize>::Back() const
+{
+    NFE_ASSERT(!Empty(), "Array is empty");
+    return *GetElementPtr(Size() - 1);
+}
+
+template<typename ElementType, uint32 SegmentSize>
+void SegmentedArray<ElementType, SegmentSize>::DestroyElements(uint32 from, uint32 to)
+{
+    if (!std::is_trivially_destructible<ElementType>::value)
+    {
+        for (uint32 i = from; i < to; ++i)
+        {
+            GetElementPtr(i)->~ElementType();
+        }
+    }
+}
+
+template<typename ElementType, uint32 SegmentSize>
+void SegmentedArray<ElementType, SegmentSize>::FreeSegments()
+{
+    SegmentTable* table = mTable.load(std::memory_order_relaxed);
+    const uint32 segmentsNum = mSegmentsNum.load(std::memory_order_relaxed);
+
+    for (uint32 i = 0; i < segmentsNum; ++i)
+    {
+        AllocatorFree(mAllocator, table->segments[i]);
+    }
+
+    FreeRetiredTables();
+    AllocatorFree(mAllocator, table);
+
+    mTable.store(nullptr, std::memory_order_relaxed);
+    mSegmentsNum.store(0, std::memory_order_relaxed);
+}
+
+template<typename ElementType, uint32 SegmentSize>
+void SegmentedArray<ElementType, SegmentSize>::FreeRetiredTables()
+{
+    SegmentTable* table = mTable.load(std::memory_order_relaxed);
+    if (!table)
+    {
+        return;
+    }
+
+    SegmentTable* retired = table->retired;
+    while (retired)
+    {
+        SegmentTable* next = retired->retired;
+        AllocatorFree(mAllocator, retired);
+        retired = next;
+    }
+
+    table->retired = nullptr;
+}
+
+template<typename ElementType, uint32 SegmentSize>
+void SegmentedArray<ElementType, SegmentSize>::Clear(bool freeMemory)
+{
+    DestroyElements(0, Size());
+    mSize.store(0, std::memory_order_relaxed);
+
+    if (freeMemory)
+    {
+        FreeSegments();
+    }
+    else
+    {
+        // Clear() can't be called concurrently with other operations, so nobody reads the old tables
+        FreeRetiredTables();
+    }
+}
+
+template<typename ElementType, uint32 SegmentSize>
+bool SegmentedArray<ElementType, SegmentSize>::GrowTable(uint32 segmentsNum)
+{
+    SegmentTable* oldTable = mTable.load(std::memory_order_relaxed);
+
+    uint32 newCapacity = oldTable ? 2 * oldTable->capacity : InitialTableCapacity;
+    while (newCapacity < segmentsNum)
+    {
+        newCapacity *= 2;
+    }
+
+    const size_t tableSize = sizeof(SegmentTable) + (newCapacity - 1) * sizeof(ElementType*);
+    SegmentTable* newTable = static_cast<SegmentTable*>(AllocatorMalloc(mAllocator, tableSize, alignof(SegmentTable)));
+    if (!newTable)
+    {
+        NFE_LOG_ERROR("Failed to allocate segment table for SegmentedArray");
+        return false;
+    }
+
+    newTable->retired = oldTable;
+    newTable->capacity = newCapacity;
+    if (oldTable)
+    {
+        memcpy(newTable->segments, oldTable->segments, mSegmentsNum.load(std::memory_order_relaxed) * sizeof(ElementType*));
+    }
+
+    // the old table can be still used by concurrent readers, so it's released in Clear() or in the destructor
+    mTable.store(newTable, std::memory_order_release);
+    return true;
+}
+
+template<typename ElementType, uint32 SegmentSize>
+bool SegmentedArray<ElementType, SegmentSize>::EnsureSegments(uint32 size)
+{
+    const uint32 requiredSegments = static_cast<uint32>((static_cast<uint64>(size) + SegmentMask) >> SegmentShift);
+
+    // fast path, synchronizes with publishing of the segments below
+    if (mSegmentsNum.load(std::memory_order_acquire) >= requiredSegments)
+    {
+        return true;
+    }
+
+    bool success = true;
+    mGrowLock.AcquireExclusive();
+
+    uint32 segmentsNum = mSegmentsNum.load(std::memory_order_relaxed);
+    if (segmentsNum < requiredSegments)
+    {
+        SegmentTable* table = mTable.load(std::memory_order_relaxed);
+        if (!table || table->capacity < requiredSegments)
+        {
+            success = GrowTable(requiredSegments);
+            table = mTable.load(std::memory_order_relaxed);
+        }
+
+        for (; success && segmentsNum < requiredSegments; ++segmentsNum)
+        {
+            void* segment = AllocatorMalloc(mAllocator, SegmentSize * sizeof(ElementType), alignof(ElementType));
+            if (!segment)
+            {
+                NFE_LOG_ERROR("Failed to allocate segment for SegmentedArray");
+                success = false;
+                break;
+            }
+
+            // readers never access slots above mSegmentsNum, so the table can be written in place
+            table->segments[segmentsNum] = static_cast<ElementType*>(segment);
+            mSegmentsNum.store(segmentsNum + 1, std::memory_order_release);
+        }
+    }
+
+    mGrowLock.ReleaseExclusive();
+    return success;
+}
+
+template<typename ElementType, uint32 SegmentSize>
+bool SegmentedArray<ElementType, SegmentSize>::Reserve(uint32 size)
+{
+    return EnsureSegments(size);
+}
+
+template<typename ElementType, uint32 SegmentSize>
+bool SegmentedArray<ElementType, SegmentSize>::Resize(uint32 size)
+{
+    const uint32 oldSize = Size();
+
+    if (size < oldSize)
+    {
+        DestroyElements(size, oldSize);
+    }
+    else if (size > oldSize)
+    {
+        if (!EnsureSegments(size))
+        {
+            return false;
+        }
+
+        for (uint32 i = oldSize; i < size; ++i)
+        {
+            new (GetElementPtr(i)) ElementType;
+        }
+    }
+
+    mSize.store(size, std::memory_order_relaxed);
+    return true;
+}
+
+template<typename ElementType, uint32 SegmentSize>
+uint32 SegmentedArray<ElementType, SegmentSize>::PushBack(const ElementType& element)
+{
+    return EmplaceBack(element);
+}
+
+template<typename ElementType, uint32 SegmentSize>
+uint32 SegmentedArray<ElementType, SegmentSize>::PushBack(ElementType&& element)
+{
+    return EmplaceBack(std::move(element));
+}
+
+template<typename ElementType, uint32 SegmentSize>
+template<typename ... Args>
+uint32 SegmentedArray<ElementType, SegmentSize>::EmplaceBack(Args&& ... args)
+{
+    const uint32 index = Size();
+    if (index == InvalidIndex || !EnsureSegments(index + 1))
+    {
+        return InvalidIndex;
+    }
+
+    new (GetElementPtr(index)) ElementType(std::forward<Args>(args) ...);
+    mSize.store(index + 1, std::memory_order_relaxed);
+    return index;
+}
+
+template<typename ElementType, uint32 SegmentSize>
+bool SegmentedArray<ElementType, SegmentSize>::PopBack()
+{
+    const uint32 size = Size();
+    if (size == 0)
+    {
+        return false;
+    }
+
+    GetElementPtr(size - 1)->~ElementType();
+    mSize.store(size - 1, std::memory_order_relaxed);
+    return true;
+}
+
+template<typename ElementType, uint32 SegmentSize>
+uint32 SegmentedArray<ElementType, SegmentSize>::AcquireRange(uint32 count)
+{
+    uint32 size = mSize.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        if (count >= InvalidIndex - size)
+        {
+            NFE_LOG_ERROR("SegmentedArray size limit exceeded");
+            return InvalidIndex;
+        }
+
+        // segments are allocated before the range is taken, so a failure leaves the array unchanged
+        if (!EnsureSegments(size + count))
+        {
+            return InvalidIndex;
+        }
+
+        if (mSize.compare_exchange_weak(size, size + count, std::memory_order_relaxed))
+        {
+            return size;
+        }
+    }
+}
+
+template<typename ElementType, uint32 SegmentSize>
+uint32 SegmentedArray<ElementType, SegmentSize>::ReserveRange(uint32 count)
+{
+    const uint32 first = AcquireRange(count);
+    if (first != InvalidIndex)
+    {
+        for (uint32 i = first; i < first + count; ++i)
+        {
+            new (GetElementPtr(i)) ElementType;
+        }
+    }
+    return first;
+}
+
+template<typename ElementType, uint32 SegmentSize>
+template<typename ... Args>
+uint32 SegmentedArray<ElementType, SegmentSize>::EmplaceBackConcurrent(Args&& ... args)
+{
+    const uint32 index = AcquireRange(1);
+    if (index != InvalidIndex)
+    {
+        new (GetElementPtr(index)) ElementType(std::forward<Args>(args) ...);
+    }
+    return index;
+}
+
+
+} // namespace Common
+} // namespace NFE
@@ -22,8 +22,7 @@ template<typename T>
 class SharedPtr final : public SharedPtrTypedBase<T>
 {
 public:
-    using DeleterFunc = typename SharedPtrTypedData<T>::DeleterFunc;
-    using SharedBlockType = SharedPtrTypedData<T>;
+    using DefaultDeleter = SharedPtrDefaultDeleter<T>;
 
     // Initialize with null pointer
     SharedPtr() { }
@@ -31,9 +30,11 @@ public:
 
     /**
      * Initialize with a raw pointer.
-     * @remarks Use with caution! MakeSharedPtr is recommended.
+     * @param   deleter Callable invoked with the pointer when the last strong reference is released.
+     * @remarks Use with caution! MakeSharedPtr is recommended, as it allocates the object and the control block at once.
      */
-    explicit SharedPtr(T* ptr, const DeleterFunc& deleter = SharedPtrTypedData<T>::GetDefaultDeleter());
+    template<typename Deleter = DefaultDeleter>
+    explicit SharedPtr(T* ptr, Deleter deleter = Deleter());
 
     SharedPtr(const SharedPtr& rhs);
     SharedPtr(SharedPtr&& rhs);
@@ -67,7 +68,8 @@ public:
     /**
      * Set a new object.
      */
-    void Reset(T* newPtr = nullptr, const DeleterFunc& deleter = SharedPtrTypedData<T>::GetDefaultDeleter());
+    template<typename Deleter = DefaultDeleter>
+    void Reset(T* newPtr = nullptr, Deleter deleter = Deleter());
 
     /**
      * Check if pointer is not null.
@@ -85,6 +87,12 @@ public:
     bool operator != (const T* other) const;
 
 private:
+    // release the current object (if any)
+    void Release();
+
+    template<typename U, typename ... Args>
+    friend SharedPtr<U> MakeSharedPtr(Args&& ... args);
+
     template<typename TargetType, typename SourceType>
     friend SharedPtr<TargetType> StaticCast(const SharedPtr<SourceType>&);
 
@@ -109,6 +117,7 @@ NFE_FORCE_INLINE bool operator != (const T* lhs, const SharedPtr<T>& rhs);
 
 /**
  * Create shared pointer.
+ * @note    The object is stored together with the control block, so only one allocation is made.
  */
 template<typename T, typename ... Args>
 NFE_INLINE SharedPtr<T> MakeSharedPtr(Args&& ... args);
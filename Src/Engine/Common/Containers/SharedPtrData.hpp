@@ -8,9 +8,9 @@
 
 #include "../nfCommon.hpp"
 #include "../System/Assertion.hpp"
+#include "../Memory/DefaultAllocator.hpp"
 
 #include <atomic>
-#include <functional>
 
 
 namespace NFE {
@@ -18,64 +18,147 @@ namespace Common {
 
 
 /**
-* Shared pointer control data block - contains reference counters and deleter.
-*/
+ * Shared pointer control data block - contains reference counters.
+ * Object destruction and block deallocation are type-erased via a single function pointer,
+ * so the block has no vtable and releasing a pointer costs one indirect call.
+ */
 class NFE_ALIGN(8) SharedPtrData
 {
 public:
     using RefCountType = int32;
 
-    NFCOMMON_API SharedPtrData();
+    enum class Operation : uint8
+    {
+        DestroyObject,  // called when the last strong reference is released
+        FreeBlock,      // called when the last weak reference is released
+    };
+
+    using ManagerFunc = void(*)(SharedPtrData* data, Operation operation);
 
-    NFCOMMON_API virtual ~SharedPtrData();
+    NFE_FORCE_INLINE explicit SharedPtrData(ManagerFunc manager)
+        : mStrongRefs(1)
+        , mWeakRefs(1)
+        , mManager(manager)
+    { }
+
+    NFE_FORCE_INLINE void DestroyObject()
+    {
+        mManager(this, Operation::DestroyObject);
+    }
+
+    NFE_FORCE_INLINE void FreeBlock()
+    {
+        NFE_ASSERT(mStrongRefs == 0, "Strong references counter expected to be equal to zero");
+        NFE_ASSERT(mWeakRefs == 0, "Weak references counter expected to be equal to zero");
+        mManager(this, Operation::FreeBlock);
+    }
 
     std::atomic<RefCountType> mStrongRefs;
     std::atomic<RefCountType> mWeakRefs;
+
+private:
+    ManagerFunc mManager;
 };
 
 /**
- * Shared pointer control data block - contains reference counters and deleter.
+ * Default deleter used by SharedPtr when constructed from a raw pointer.
  */
 template<typename T>
-class SharedPtrTypedData final : public SharedPtrData
+struct SharedPtrDefaultDeleter
 {
-public:
-    using DeleterFunc = std::function<void(T*)>;
+    NFE_FORCE_INLINE void operator()(T* object) const
+    {
+        if (object)
+        {
+            object->~T();
+            NFE_FREE(object);
+        }
+    }
+};
 
-    NFE_FORCE_INLINE SharedPtrTypedData(T* pointer, const DeleterFunc& deleter)
-        : mPointer(pointer)
-        , mDeleter(deleter)
+/**
+ * Control data block for an externally allocated object (SharedPtr created from a raw pointer).
+ */
+template<typename T, typename Deleter>
+class SharedPtrExternalData final : public SharedPtrData
+{
+public:
+    NFE_FORCE_INLINE SharedPtrExternalData(T* pointer, Deleter&& deleter)
+        : SharedPtrData(&Manage)
+        , mPointer(pointer)
+        , mDeleter(std::move(deleter))
     { }
 
-    NFE_FORCE_INLINE T* GetPointer() const
+    static SharedPtrData* Create(T* pointer, Deleter&& deleter)
+    {
+        void* memory = NFE_MALLOC(sizeof(SharedPtrExternalData), alignof(SharedPtrExternalData));
+        NFE_ASSERT(memory, "Failed to allocate shared pointer data block");
+        return new (memory) SharedPtrExternalData(pointer, std::move(deleter));
+    }
+
+private:
+    T* mPointer;
+    Deleter mDeleter;
+
+    static void Manage(SharedPtrData* data, Operation operation)
     {
-        return mPointer;
+        SharedPtrExternalData* self = static_cast<SharedPtrExternalData*>(data);
+        if (operation == Operation::DestroyObject)
+        {
+            self->mDeleter(self->mPointer);
+        }
+        else
+        {
+            self->~SharedPtrExternalData();
+            NFE_FREE(self);
+        }
     }
+};
 
-    NFE_FORCE_INLINE const DeleterFunc& GetDeleter() const
+/**
+ * Control data block with the object stored inline (used by MakeSharedPtr).
+ * The object and the reference counters share one allocation.
+ */
+template<typename T>
+class SharedPtrInlineData final : public SharedPtrData
+{
+public:
+    template<typename ... Args>
+    static SharedPtrInlineData* Create(Args&& ... args)
     {
-        return mDeleter;
+        void* memory = NFE_MALLOC(sizeof(SharedPtrInlineData), alignof(SharedPtrInlineData));
+        NFE_ASSERT(memory, "Failed to allocate shared pointer data block");
+
+        SharedPtrInlineData* data = new (memory) SharedPtrInlineData;
+        new (data->GetObject()) T(std::forward<Args>(args) ...);
+        return data;
     }
 
-    static DeleterFunc GetDefaultDeleter()
+    NFE_FORCE_INLINE T* GetObject()
     {
-        static const auto defaultDeleter = [](T* object)
-        {
-            if (object)
-            {
-                object->~T();
-                NFE_FREE(object);
-            }
-        };
-
-        return defaultDeleter;
+        return reinterpret_cast<T*>(mStorage);
     }
 
 private:
-    T* mPointer;
+    alignas(T) uint8 mStorage[sizeof(T)];
 
-    // deleter function
-    DeleterFunc mDeleter;
+    NFE_FORCE_INLINE SharedPtrInlineData()
+        : SharedPtrData(&Manage)
+    { }
+
+    static void Manage(SharedPtrData* data, Operation operation)
+    {
+        SharedPtrInlineData* self = static_cast<SharedPtrInlineData*>(data);
+        if (operation == Operation::DestroyObject)
+        {
+            self->GetObject()->~T();
+        }
+        else
+        {
+            self->~SharedPtrInlineData();
+            NFE_FREE(self);
+        }
+    }
 };
 
 
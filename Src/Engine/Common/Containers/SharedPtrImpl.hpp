@@ -15,12 +15,13 @@ namespace Common {
 
 
 template<typename T>
-SharedPtr<T>::SharedPtr(T* ptr, const DeleterFunc& deleter)
+template<typename Deleter>
+SharedPtr<T>::SharedPtr(T* ptr, Deleter deleter)
     : SharedPtrTypedBase<T>(ptr, nullptr)
 {
     if (this->mPointer)
     {
-        this->mData = new SharedBlockType(ptr, deleter);
+        this->mData = SharedPtrExternalData<T, Deleter>::Create(ptr, std::move(deleter));
     }
 }
 
@@ -69,7 +70,7 @@ SharedPtr<T>::SharedPtr(const SharedPtr<SourceType>& rhs)
 template<typename T>
 SharedPtr<T>::~SharedPtr()
 {
-    Reset();
+    Release();
 }
 
 template<typename T>
@@ -77,7 +78,7 @@ SharedPtr<T>& SharedPtr<T>::operator = (const SharedPtr& rhs)
 {
     if (&rhs != this)
     {
-        Reset();
+        Release();
 
         this->mData = rhs.mData;
         this->mPointer = rhs.mPointer;
@@ -95,7 +96,7 @@ SharedPtr<T>& SharedPtr<T>::operator = (const SharedPtr& rhs)
 template<typename T>
 SharedPtr<T>& SharedPtr<T>::operator = (SharedPtr&& rhs)
 {
-    Reset();
+    Release();
 
     this->mPointer = rhs.mPointer;
     this->mData = rhs.mData;
@@ -124,38 +125,43 @@ SharedPtr<T>& SharedPtr<T>::operator = (const SharedPtr<SourceType>& rhs)
 }
 
 template<typename T>
-void SharedPtr<T>::Reset(T* newPtr, const DeleterFunc& deleter)
+void SharedPtr<T>::Release()
 {
     if (this->mData)
     {
-        SharedBlockType* data = static_cast<SharedBlockType*>(this->mData);
-        T* ptr = data->GetPointer();
+        SharedPtrData* data = this->mData;
         this->mData = nullptr;
         this->mPointer = nullptr;
 
         const int32 strongRefsBefore = data->mStrongRefs--;
-        const int32 weakRefsBefore = data->mWeakRefs--;
-
         NFE_ASSERT(strongRefsBefore > 0, "Strong references counter underflow");
-        NFE_ASSERT(weakRefsBefore > 0, "Weak references counter underflow");
 
         if (strongRefsBefore == 1)
         {
-            const auto& oldObjectDeleter = data->GetDeleter();
-            oldObjectDeleter(ptr);
+            data->DestroyObject();
         }
 
+        // weak counter must be decremented after the object is destroyed, because the block (and inline object) may be freed
+        const int32 weakRefsBefore = data->mWeakRefs--;
+        NFE_ASSERT(weakRefsBefore > 0, "Weak references counter underflow");
+
         if (weakRefsBefore == 1)
         {
-            delete data;
+            data->FreeBlock();
         }
     }
+}
+
+template<typename T>
+template<typename Deleter>
+void SharedPtr<T>::Reset(T* newPtr, Deleter deleter)
+{
+    Release();
 
     if (newPtr)
     {
         this->mPointer = newPtr;
-        this->mData = new SharedBlockType(newPtr, deleter);
-        // TODO possible optimization: reuse SharedPtrData
+        this->mData = SharedPtrExternalData<T, Deleter>::Create(newPtr, std::move(deleter));
     }
 }
 
@@ -240,9 +246,12 @@ bool operator != (const T* lhs, const SharedPtr<T>& rhs)
 template<typename T, typename ... Args>
 SharedPtr<T> MakeSharedPtr(Args&& ... args)
 {
-    void* memory = NFE_MALLOC(sizeof(T), alignof(T));
-    T* ptr = new (memory) T(std::forward<Args>(args) ...);
-    return SharedPtr<T>(ptr);
+    SharedPtrInlineData<T>* data = SharedPtrInlineData<T>::Create(std::forward<Args>(args) ...);
+
+    SharedPtr<T> result;
+    result.mData = data;
+    result.mPointer = data->GetObject();
+    return result;
 }
 
 template<typename TargetType, typename SourceType>
@@ -18,7 +18,7 @@ String::~String()
 {
     if (!IsInternal())
     {
-        NFE_FREE(mExternalData.data);
+        AllocatorFree(mAllocator, mExternalData.data);
         mExternalData.data = nullptr;
     }
 }
@@ -29,22 +29,38 @@ String::String(const char* string)
 }
 
 String::String(String&& other)
+    : mAllocator(other.mAllocator)
 {
     mPackedData.a = other.mPackedData.a;
     mPackedData.b = other.mPackedData.b;
+    mPackedData.c = other.mPackedData.c;
     other.mInternalData = InternalData();
 }
 
 String& String::operator=(String&& other)
 {
+    if (&other == this)
+    {
+        return *this;
+    }
+
+    if (!other.IsInternal() && mAllocator != other.mAllocator)
+    {
+        // external buffer can't be taken over, because it comes from a different allocator
+        *this = other.ToView();
+        other.Clear();
+        return *this;
+    }
+
     if (!IsInternal())
     {
-        NFE_FREE(mExternalData.data);
+        AllocatorFree(mAllocator, mExternalData.data);
         mExternalData.data = nullptr;
     }
 
     mPackedData.a = other.mPackedData.a;
     mPackedData.b = other.mPackedData.b;
+    mPackedData.c = other.mPackedData.c;
     other.mInternalData = InternalData();
 
     return *this;
@@ -57,6 +73,7 @@ String::String(const String& string)
 
 String::String(const StringView& view)
     : mInternalData()
+    , mAllocator(nullptr)
 {
     const uint32 length = view.Length();
     if (length <= MaxInternalLength)
@@ -78,6 +95,7 @@ String::String(const StringView& view)
 
 String::String(const char* str, uint32 length)
     : mInternalData()
+    , mAllocator(nullptr)
 {
     if (length <= MaxInternalLength)
     {
@@ -141,7 +159,7 @@ void String::Clear()
 {
     if (!IsInternal())
     {
-        NFE_FREE(mExternalData.data);
+        AllocatorFree(mAllocator, mExternalData.data);
     }
 
     mInternalData = InternalData();
@@ -416,7 +434,14 @@ bool String::Reserve(uint32 length)
     while (size < length)
         size <<= 1;
 
-    char* newBuffer = static_cast<char*>(NFE_MALLOC(size, 1));
+    // try to grow the buffer in place
+    if (!IsInternal() && AllocatorTryResize(mAllocator, mExternalData.data, mExternalData.allocSize, size))
+    {
+        mExternalData.allocSize = size;
+        return true;
+    }
+
+    char* newBuffer = static_cast<char*>(AllocatorMalloc(mAllocator, size, 1));
     if (!newBuffer)
     {
         return false;
@@ -433,7 +458,7 @@ bool String::Reserve(uint32 length)
     else
     {
         // free old buffer
-        NFE_FREE(mExternalData.data);
+        AllocatorFree(mAllocator, mExternalData.data);
     }
 
     // update external buffer state
@@ -7,18 +7,20 @@
 #pragma once
 
 #include "StringView.hpp"
+#include "../Memory/Allocator.hpp"
 
 namespace NFE {
 namespace Common {
 
 /**
  * Dynamic ASCII/UTF-8 string.
+ * External buffer is allocated with the allocator passed in constructor (default allocator if null).
  */
 class NFCOMMON_API String
 {
 public:
     // maximum length of a string (without null-terminator) that can be kept in internal storage
-    static constexpr uint32 MaxInternalLength = 11;
+    static constexpr uint32 MaxInternalLength = 19;
 
     ~String();
 
@@ -34,6 +36,9 @@ public:
     String(const char* str, uint32 length);
     String(const String& string);
 
+    // initialize empty string using custom allocator
+    NFE_INLINE explicit String(IAllocator* allocator);
+
     // construct a string from a fixed-sized array
     // array size must be less than MaxInternalLength
     template<uint32 N>
@@ -135,6 +140,11 @@ public:
      */
     NFE_INLINE bool IsInternal() const;
 
+    /**
+     * Get allocator used for external buffer (null means default allocator).
+     */
+    NFE_INLINE IAllocator* GetAllocator() const { return mAllocator; }
+
     /**
      * Character access operator.
      * @note The index must be valid. Otherwise it will cause an assertion.
@@ -166,7 +176,7 @@ private:
         NFE_INLINE ExternalData();
     };
 
-    // string buffer is hold inside the String object itself (up to 12 characters, including null-termination)
+    // string buffer is hold inside the String object itself (up to 20 characters, including null-termination)
     struct InternalData
     {
         uint32 length : 31;                 // string length (without null termination)
@@ -177,13 +187,14 @@ private:
         NFE_INLINE InternalData(char c);
     };
 
-    static_assert(sizeof(InternalData) == 16UL, "Invalid InternalData type size");
+    static_assert(sizeof(InternalData) == 24UL, "Invalid InternalData type size");
 
     // for easy move
     struct PackedData
     {
         uint64 a;
         uint64 b;
+        uint64 c;
     };
 
     union
@@ -193,11 +204,14 @@ private:
         PackedData   mPackedData;
     };
 
+    // external buffer allocator (null means default allocator)
+    IAllocator* mAllocator;
+
     NFE_INLINE void SetLength(uint32 length);
 };
 
 
-static_assert(sizeof(String) == 16UL, "Invalid String type size");
+static_assert(sizeof(String) == 32UL, "Invalid String type size");
 
 
 // concatenation operators (const StringView& and String&&)
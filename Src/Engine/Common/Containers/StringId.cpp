@@ -0,0 +1,282 @@
+/**
+ * @file
+ * @author Witek902 (witek902@gmail.com)
+ * @brief  Interned string identifier definitions.
+ */
+
+#include "PCH.hpp"
+#include "StringId.hpp"
+#include "../Memory/DefaultAllocator.hpp"
+#include "../System/RWLock.hpp"
+#include "../Utils/ScopedLock.hpp"
+#include "../Logger/Logger.hpp"
+
+
+namespace NFE {
+namespace Common {
+
+/**
+ * Global table of interned strings.
+ * Open addressing hash table of pointers to entries. Entries are allocated from big chunks.
+ */
+class StringIdTable final
+{
+    NFE_MAKE_NONCOPYABLE(StringIdTable)
+    NFE_MAKE_NONMOVEABLE(StringIdTable)
+
+public:
+    using Entry = StringId::Entry;
+
+    static StringIdTable& GetInstance()
+    {
+        static StringIdTable table;
+        return table;
+    }
+
+    const Entry* Find(const StringView& str, uint32 hash) const;
+    const Entry* Intern(const StringView& str, uint32 hash);
+
+    uint32 GetSize() const
+    {
+        NFE_SCOPED_SHARED_LOCK(mLock);
+        return mSize;
+    }
+
+private:
+    static constexpr uint32 InitialCapacity = 1024;
+    static constexpr size_t ChunkSize = 64 * 1024;
+
+    // strings longer than this are allocated separately
+    static constexpr size_t MaxChunkEntrySize = ChunkSize / 8;
+
+    struct Chunk
+    {
+        Chunk* next;
+    };
+
+    mutable RWLock mLock;
+    const Entry** mSlots;
+    uint32 mCapacity;
+    uint32 mSize;
+
+    // entries storage
+    Chunk* mChunks;
+    size_t mChunkUsed;
+
+    StringIdTable();
+    ~StringIdTable();
+
+    const Entry* FindInternal(const StringView& str, uint32 hash) const;
+    Entry* AllocateEntry(size_t size);
+    bool Grow();
+};
+
+
+StringIdTable::StringIdTable()
+    : mSlots(nullptr)
+    , mCapacity(0)
+    , mSize(0)
+    , mChunks(nullptr)
+    , mChunkUsed(ChunkSize)
+{
+    // Note: allocating here makes sure the allocator outlives the table
+    mSlots = static_cast<const Entry**>(NFE_MALLOC(InitialCapacity * sizeof(Entry*), NFE_CACHE_LINE_SIZE));
+    if (mSlots)
+    {
+        memset(mSlots, 0, InitialCapacity * sizeof(Entry*));
+        mCapacity = InitialCapacity;
+    }
+}
+
+StringIdTable::~StringIdTable()
+{
+    // separately allocated entries are not tracked in chunks
+    for (uint32 i = 0; i < mCapacity; ++i)
+    {
+        const Entry* entry = mSlots[i];
+        if (entry && offsetof(Entry, data) + entry->length + 1 > MaxChunkEntrySize)
+        {
+            NFE_FREE(const_cast<Entry*>(entry));
+        }
+    }
+
+    while (mChunks)
+    {
+        Chunk* next = mChunks->next;
+        NFE_FREE(mChunks);
+        mChunks = next;
+    }
+
+    NFE_FREE(mSlots);
+}
+
+const StringIdTable::Entry* StringIdTable::FindInternal(const StringView& str, uint32 hash) const
+{
+    if (mCapacity == 0)
+    {
+        return nullptr;
+    }
+
+    const uint32 mask = mCapacity - 1;
+    for (uint32 i = hash & mask; ; i = (i + 1) & mask)
+    {
+        const Entry* entry = mSlots[i];
+        if (!entry)
+        {
+            return nullptr;
+        }
+
+        if (entry->hash == hash && entry->length == str.Length() && memcmp(entry->data, str.Data(), str.Length()) == 0)
+        {
+            return entry;
+        }
+    }
+}
+
+const StringIdTable::Entry* StringIdTable::Find(const StringView& str, uint32 hash) const
+{
+    NFE_SCOPED_SHARED_LOCK(mLock);
+    return FindInternal(str, hash);
+}
+
+const StringIdTable::Entry* StringIdTable::Intern(const StringView& str, uint32 hash)
+{
+    // fast path - the string is usually interned already
+    if (const Entry* entry = Find(str, hash))
+    {
+        return entry;
+    }
+
+    NFE_SCOPED_LOCK(mLock);
+
+    // other thread could intern the string in the meantime
+    if (const Entry* entry = FindInternal(str, hash))
+    {
+        return entry;
+    }
+
+    // keep load factor below 50%
+    if (2 * (mSize + 1) > mCapacity && !Grow())
+    {
+        return nullptr;
+    }
+
+    Entry* entry = AllocateEntry(offsetof(Entry, data) + str.Length() + 1);
+    if (!entry)
+    {
+        NFE_LOG_ERROR("Failed to allocate interned string");
+        return nullptr;
+    }
+
+    entry->hash = hash;
+    entry->length = str.Length();
+    memcpy(entry->data, str.Data(), str.Length());
+    entry->data[str.Length()] = '\0';
+
+    const uint32 mask = mCapacity - 1;
+    uint32 i = hash & mask;
+    while (mSlots[i])
+    {
+        i = (i + 1) & mask;
+    }
+
+    mSlots[i] = entry;
+    mSize++;
+
+    return entry;
+}
+
+StringIdTable::Entry* StringIdTable::AllocateEntry(size_t size)
+{
+    if (size > MaxChunkEntrySize)
+    {
+        return static_cast<Entry*>(NFE_MALLOC(size, alignof(Entry)));
+    }
+
+    size = (size + alignof(Entry) - 1) & ~(alignof(Entry) - 1);
+
+    if (mChunkUsed + size > ChunkSize)
+    {
+        Chunk* chunk = static_cast<Chunk*>(NFE_MALLOC(ChunkSize, NFE_CACHE_LINE_SIZE));
+        if (!chunk)
+        {
+            return nullptr;
+        }
+
+        chunk->next = mChunks;
+        mChunks = chunk;
+        mChunkUsed = sizeof(Chunk);
+    }
+
+    Entry* entry = reinterpret_cast<Entry*>(reinterpret_cast<uint8*>(mChunks) + mChunkUsed);
+    mChunkUsed += size;
+    return entry;
+}
+
+bool StringIdTable::Grow()
+{
+    const uint32 newCapacity = mCapacity ? 2 * mCapacity : InitialCapacity;
+    const Entry** newSlots = static_cast<const Entry**>(NFE_MALLOC(newCapacity * sizeof(Entry*), NFE_CACHE_LINE_SIZE));
+    if (!newSlots)
+    {
+        NFE_LOG_ERROR("Failed to grow string intern table");
+        return false;
+    }
+
+    memset(newSlots, 0, newCapacity * sizeof(Entry*));
+
+    const uint32 mask = newCapacity - 1;
+    for (uint32 i = 0; i < mCapacity; ++i)
+    {
+        if (const Entry* entry = mSlots[i])
+        {
+            uint32 j = entry->hash & mask;
+            while (newSlots[j])
+            {
+                j = (j + 1) & mask;
+            }
+            newSlots[j] = entry;
+        }
+    }
+
+    NFE_FREE(mSlots);
+    mSlots = newSlots;
+    mCapacity = newCapacity;
+    return true;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+
+StringId::StringId(const StringView& str)
+    : mEntry(nullptr)
+{
+    if (!str.Empty())
+    {
+        mEntry = StringIdTable::GetInstance().Intern(str, Common::GetHash(str));
+    }
+}
+
+StringId::StringId(const char* str)
+    : StringId(StringView(str))
+{
+}
+
+StringId StringId::Find(const StringView& str)
+{
+    if (str.Empty())
+    {
+        return StringId();
+    }
+
+    return StringId(StringIdTable::GetInstance().Find(str, Common::GetHash(str)));
+}
+
+uint32 StringId::GetInternedStringsNum()
+{
+    return StringIdTable::GetInstance().GetSize();
+}
+
+
+} // namespace Common
+} // namespace NFE
@@ -0,0 +1,84 @@
+/**
+ * @file
+ * @author Witek902 (witek902@gmail.com)
+ * @brief  Interned string identifier declaration.
+ */
+
+#pragma once
+
+#include "StringView.hpp"
+
+
+namespace NFE {
+namespace Common {
+
+/**
+ * Identifier of a string stored in the global intern table.
+ *
+ * Every distinct string is stored only once, so two identifiers are equal if and only if
+ * they point to the same entry - comparison is a single pointer compare and the hash is computed
+ * only once, when the string is interned. Interning is thread-safe. Interned strings are never released,
+ * so the type is intended for a bounded set of names (type and member names, config keys, resource names),
+ * not for arbitrary runtime text.
+ */
+class NFCOMMON_API StringId final
+{
+public:
+    // create empty identifier (equal to identifier of an empty string)
+    NFE_FORCE_INLINE StringId() : mEntry(nullptr) { }
+
+    // intern a string
+    explicit StringId(const StringView& str);
+    explicit StringId(const char* str);
+
+    /**
+     * Find already interned string.
+     * @return  Identifier of the string or empty identifier if the string was not interned.
+     */
+    static StringId Find(const StringView& str);
+
+    /**
+     * Get number of strings in the intern table.
+     */
+    static uint32 GetInternedStringsNum();
+
+    NFE_FORCE_INLINE bool Empty() const { return mEntry == nullptr; }
+
+    // get null-terminated string
+    NFE_FORCE_INLINE const char* Str() const { return mEntry ? mEntry->data : ""; }
+    NFE_FORCE_INLINE uint32 Length() const { return mEntry ? mEntry->length : 0u; }
+    NFE_FORCE_INLINE StringView ToView() const { return mEntry ? StringView(mEntry->data, mEntry->length) : StringView(); }
+
+    // get precomputed hash (the same as GetHash() of the string view, zero for empty identifier)
+    NFE_FORCE_INLINE uint32 GetHash() const { return mEntry ? mEntry->hash : 0u; }
+
+    NFE_FORCE_INLINE bool operator == (const StringId& other) const { return mEntry == other.mEntry; }
+    NFE_FORCE_INLINE bool operator != (const StringId& other) const { return mEntry != other.mEntry; }
+
+    // arbitrary order (not lexicographical), stable during application lifetime
+    NFE_FORCE_INLINE bool operator < (const StringId& other) const { return mEntry < other.mEntry; }
+
+private:
+    friend class StringIdTable;
+
+    struct Entry
+    {
+        uint32 hash;
+        uint32 length;
+        char data[1];   // null-terminated
+    };
+
+    const Entry* mEntry;
+
+    NFE_FORCE_INLINE explicit StringId(const Entry* entry) : mEntry(entry) { }
+};
+
+// hashing function for StringId class
+NFE_FORCE_INLINE uint32 GetHash(const StringId& id)
+{
+    return id.GetHash();
+}
+
+
+} // namespace Common
+} // namespace NFE
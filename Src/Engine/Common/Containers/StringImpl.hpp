@@ -39,11 +39,19 @@ String::InternalData::InternalData(char c)
 
 String::String()
     : mInternalData()
+    , mAllocator(nullptr)
 {
 }
 
 String::String(char c)
     : mInternalData(c)
+    , mAllocator(nullptr)
+{
+}
+
+String::String(IAllocator* allocator)
+    : mInternalData()
+    , mAllocator(allocator)
 {
 }
 
@@ -7,6 +7,7 @@
 #include "PCH.hpp"
 #include "StringView.hpp"
 #include "String.hpp"
+#include "Hash.hpp"
 
 
 namespace NFE {
@@ -290,17 +291,36 @@ StringViewToCStringHelper::StringViewToCStringHelper(const StringView stringView
 uint32 GetHash(const StringView& stringView)
 {
     const uint32 length = stringView.Length();
+    const char* data = stringView.Data();
 
-    // djb2 hash function
-    // http://www.cse.yorku.ca/~oz/hash.html
+    // Process 8 bytes per iteration (multiply-rotate, similar to FxHash), then apply full avalanche.
+    // This is much faster than byte-wise hashing (eg. djb2) for longer strings.
 
-    uint32 hash = 5381u;
-    for (uint32 i = 0; i < length; ++i)
+    const auto mixChunk = [] (uint64 hash, uint64 chunk)
     {
-        hash = hash * 33u + static_cast<uint32>(stringView[i]);
+        hash ^= chunk * 0x9E3779B97F4A7C15ull;
+        hash = (hash << 27) | (hash >> 37);
+        return hash * 0xBF58476D1CE4E5B9ull;
+    };
+
+    uint64 hash = 0xCBF29CE484222325ull ^ length;
+
+    uint32 i = 0;
+    for (; i + sizeof(uint64) <= length; i += sizeof(uint64))
+    {
+        uint64 chunk;
+        memcpy(&chunk, data + i, sizeof(uint64));
+        hash = mixChunk(hash, chunk);
+    }
+
+    if (i < length)
+    {
+        uint64 chunk = 0;
+        memcpy(&chunk, data + i, length - i);
+        hash = mixChunk(hash, chunk);
     }
 
-    return hash;
+    return MixHash64(hash);
 }
 
 
@@ -17,9 +17,6 @@ template<typename T>
 class WeakPtr final : public SharedPtrTypedBase<T>
 {
 public:
-    using DeleterFunc = typename SharedPtrTypedData<T>::DeleterFunc;
-    using SharedBlockType = SharedPtrTypedData<T>;
-
     NFE_FORCE_INLINE WeakPtr() = default;
     NFE_FORCE_INLINE WeakPtr(std::nullptr_t) : WeakPtr() { }
 
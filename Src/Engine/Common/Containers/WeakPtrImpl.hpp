@@ -123,7 +123,7 @@ void WeakPtr<T>::Reset()
 
         if (weakRefsBefore == 1)
         {
-            delete this->mData;
+            this->mData->FreeBlock();
         }
 
         this->mData = nullptr;
@@ -57,6 +57,8 @@ class LogScope;
 // Memory
 class Buffer;
 class DefaultAllocator;
+class IAllocator;
+class ArenaAllocator;
 struct AllocationDebugInfo;
 struct AllocatorStats;
 
@@ -32,8 +32,8 @@ NFE_FORCE_INLINE const Vec4f Vec4f_Load_Vec3f_Unsafe(const Vec3f& src)
 NFE_FORCE_INLINE const Vec4f Vec4f_Load_Half2(const Half2& src)
 {
 #ifdef NFE_USE_FP16C
-    uint32 value = (uint32)src.x.value | ((uint32)(src.y.value) << 16);
-    return _mm_cvtph_ps(_mm_set1_epi32(value));
+    const uint32 value = (uint32)src.x.value | ((uint32)(src.y.value) << 16);
+    return _mm_cvtph_ps(_mm_cvtsi32_si128(value));
 #else // NFE_USE_FP16C
     return Vec4f(src.x.ToFloat(), src.y.ToFloat(), 0.0f, 0.0f);
 #endif // NFE_USE_FP16C
@@ -44,11 +44,21 @@ NFE_FORCE_INLINE const Vec4f Vec4f_Load_Half2(const Half2* src)
     return Vec4f_Load_Half2(*src);
 }
 
+NFE_FORCE_INLINE const Vec4f Vec4f_Load_Half3(const Half3& src)
+{
+#ifdef NFE_USE_FP16C
+    const uint64 value = (uint64)src.x.value | ((uint64)(src.y.value) << 16) | ((uint64)(src.z.value) << 32);
+    return _mm_cvtph_ps(_mm_set_epi64x(0, static_cast<int64>(value)));
+#else // NFE_USE_FP16C
+    return Vec4f(src.x.ToFloat(), src.y.ToFloat(), src.z.ToFloat(), 0.0f);
+#endif // NFE_USE_FP16C
+}
+
 NFE_FORCE_INLINE const Vec4f Vec4f_Load_Half4(const Half4& src)
 {
 #ifdef NFE_USE_FP16C
 #if defined(NFE_ARCH_X64)
-    uint32 value = (uint64)src.x.value | ((uint64)(src.y.value) << 16) | ((uint64)(src.z.value) << 32) | ((uint64)(src.w.value) << 24);
+    const uint64 value = (uint64)src.x.value | ((uint64)(src.y.value) << 16) | ((uint64)(src.z.value) << 32) | ((uint64)(src.w.value) << 48);
     return _mm_cvtph_ps(_mm_cvtsi64_si128(value));
 #elif defined(NFE_ARCH_X86)
     return _mm_cvtph_ps(_mm_set_epi64x(0, src.packed));
@@ -286,10 +296,15 @@ NFE_INLINE const Vec4f LoadVec4f(const PackedColorRgbHdr& src)
 
 NFE_INLINE const Vec4f LoadVec4f(const PackedUFloat3_11_11_10& src)
 {
-    uint32 x = ((src.xe + 112) << 23) | (src.xm << 17);
-    uint32 y = ((src.ye + 112) << 23) | (src.ym << 17);
-    uint32 z = ((src.ze + 112) << 23) | (src.zm << 17);
-    return Vec4f(x, y, z, 0u);
+    // zero exponent encodes denormal value (or zero), those are decoded separately
+    const uint32 x = src.xe ? (((src.xe + 112) << 23) | (src.xm << 17)) : 0u;
+    const uint32 y = src.ye ? (((src.ye + 112) << 23) | (src.ym << 17)) : 0u;
+    const uint32 z = src.ze ? (((src.ze + 112) << 23) | (src.zm << 18)) : 0u;
+
+    const Vec4f denormalScale(1.0f / 1048576.0f, 1.0f / 1048576.0f, 1.0f / 524288.0f, 0.0f);
+    const Vec4f denormals = Vec4f::FromIntegers(src.xe ? 0 : src.xm, src.ye ? 0 : src.ym, src.ze ? 0 : src.zm, 0) * denormalScale;
+
+    return Vec4f(x, y, z, 0u) + denormals;
 }
 
 NFE_INLINE const Vec4f LoadVec4f(const PackedUFloat3_9_9_9_5& src)
@@ -253,10 +253,10 @@ const Half4 Vec4f::ToHalf4() const
 #ifdef NFE_USE_FP16C
 #if defined(NFE_ARCH_X64)
     const uint64 val = _mm_cvtsi128_si64(_mm_cvtps_ph(v, 0));
-    halfs.x = (uint16)(val >> 0);
-    halfs.y = (uint16)(val >> 16);
-    halfs.z = (uint16)(val >> 32);
-    halfs.w = (uint16)(val>> 24);
+    halfs.x = Half((uint16)(val >> 0));
+    halfs.y = Half((uint16)(val >> 16));
+    halfs.z = Half((uint16)(val >> 32));
+    halfs.w = Half((uint16)(val >> 48));
 #elif defined(NFE_ARCH_X86)
 #error "Not defined"
 #endif
@@ -0,0 +1,263 @@
+/**
+ * @file
+ * @author Witek902 (witek902@gmail.com)
+ * @brief  Tagged memory allocation tracker definition.
+ */
+
+#include "PCH.hpp"
+#include "AllocationTracker.hpp"
+#include "../Logger/Logger.hpp"
+#include "../System/Assertion.hpp"
+#include "../Math/Math.hpp"
+
+
+namespace NFE {
+namespace Common {
+
+struct NFE_ALIGN(NFE_CACHE_LINE_SIZE) AllocationTracker::GlobalCounters
+{
+    const char* name;
+    std::atomic<int64> bytesAllocated;
+    std::atomic<int64> peakBytesAllocated;
+    std::atomic<int64> allocationsNum;
+    std::atomic<uint64> totalBytesAllocated;
+    std::atomic<uint64> totalAllocationsNum;
+};
+
+struct AllocationTracker::ThreadCounters
+{
+    struct Tag
+    {
+        int64 bytesAllocated;
+        uint64 newBytes;
+        int32 allocationsNum;
+        uint32 newAllocations;
+        uint32 operationsNum;
+    };
+
+    Tag tags[MaxTags];
+    bool registered;
+    bool released;
+};
+
+struct AllocationTracker::ThreadCountersGuard
+{
+    bool active = false;
+
+    ~ThreadCountersGuard()
+    {
+        AllocationTracker::GetInstance().Flush();
+        sThreadCounters.released = true;
+    }
+};
+
+// zero-initialized, trivially destructible - it stays accessible until the thread really terminates
+thread_local AllocationTracker::ThreadCounters AllocationTracker::sThreadCounters;
+thread_local AllocationTracker::ThreadCountersGuard AllocationTracker::sThreadCountersGuard;
+thread_local MemoryTag AllocationTracker::sCurrentTag = AllocationTracker::UntaggedTag;
+
+
+AllocationTracker::AllocationTracker()
+    : mTagsNum(1)
+    , mReportedAllocationsNum{}
+    , mReportedBytes{}
+{
+    // Note: the tracker is used by the allocator, so it can't allocate anything by itself
+    static GlobalCounters counters[MaxTags];
+    mCounters = counters;
+    mCounters[UntaggedTag].name = "Untagged";
+
+    mReportTimer.Start();
+}
+
+AllocationTracker::~AllocationTracker() = default;
+
+AllocationTracker& AllocationTracker::GetInstance()
+{
+    static AllocationTracker tracker;
+    return tracker;
+}
+
+MemoryTag AllocationTracker::RegisterTag(const char* name)
+{
+    NFE_ASSERT(name, "Invalid tag name");
+
+    mRegisterLock.AcquireExclusive();
+
+    const uint32 tagsNum = mTagsNum.load(std::memory_order_relaxed);
+    MemoryTag tag = UntaggedTag;
+
+    for (uint32 i = 0; i < tagsNum; ++i)
+    {
+        if (strcmp(mCounters[i].name, name) == 0)
+        {
+            tag = static_cast<MemoryTag>(i);
+            break;
+        }
+    }
+
+    if (tag == UntaggedTag && tagsNum < MaxTags)
+    {
+        tag = static_cast<MemoryTag>(tagsNum);
+        mCounters[tag].name = name;
+        mTagsNum.store(tagsNum + 1, std::memory_order_release);
+    }
+
+    mRegisterLock.ReleaseExclusive();
+
+    return tag;
+}
+
+MemoryTag AllocationTracker::GetCurrentTag()
+{
+    return sCurrentTag;
+}
+
+void AllocationTracker::SetCurrentTag(MemoryTag tag)
+{
+    NFE_ASSERT(tag < MaxTags, "Invalid memory tag");
+    sCurrentTag = tag;
+}
+
+void AllocationTracker::OnAllocate(MemoryTag tag, size_t size)
+{
+    ThreadCounters& counters = sThreadCounters;
+    ThreadCounters::Tag& tagCounters = counters.tags[tag];
+
+    tagCounters.bytesAllocated += static_cast<int64>(size);
+    tagCounters.newBytes += size;
+    tagCounters.allocationsNum++;
+    tagCounters.newAllocations++;
+
+    if (!counters.registered)
+    {
+        RegisterThread(counters);
+    }
+
+    if (++tagCounters.operationsNum >= FlushInterval || tagCounters.bytesAllocated >= FlushThreshold || counters.released)
+    {
+        FlushTag(counters, tag);
+    }
+}
+
+void AllocationTracker::OnFree(MemoryTag tag, size_t size)
+{
+    ThreadCounters& counters = sThreadCounters;
+    ThreadCounters::Tag& tagCounters = counters.tags[tag];
+
+    tagCounters.bytesAllocated -= static_cast<int64>(size);
+    tagCounters.allocationsNum--;
+
+    if (!counters.registered)
+    {
+        RegisterThread(counters);
+    }
+
+    if (++tagCounters.operationsNum >= FlushInterval || tagCounters.bytesAllocated <= -FlushThreshold || counters.released)
+    {
+        FlushTag(counters, tag);
+    }
+}
+
+void AllocationTracker::FlushTag(ThreadCounters& counters, MemoryTag tag)
+{
+    ThreadCounters::Tag& tagCounters = counters.tags[tag];
+    GlobalCounters& globalCounters = mCounters[tag];
+
+    const int64 bytesAllocated = globalCounters.bytesAllocated.fetch_add(tagCounters.bytesAllocated) + tagCounters.bytesAllocated;
+    globalCounters.allocationsNum.fetch_add(tagCounters.allocationsNum);
+    globalCounters.totalBytesAllocated.fetch_add(tagCounters.newBytes);
+    globalCounters.totalAllocationsNum.fetch_add(tagCounters.newAllocations);
+
+    int64 peak = globalCounters.peakBytesAllocated.load(std::memory_order_relaxed);
+    while (bytesAllocated > peak && !globalCounters.peakBytesAllocated.compare_exchange_weak(peak, bytesAllocated))
+    {
+    }
+
+    tagCounters = ThreadCounters::Tag();
+}
+
+void AllocationTracker::RegisterThread(ThreadCounters& counters)
+{
+    counters.registered = true;
+
+    // make sure the counters are flushed on thread exit
+    if (!counters.released)
+    {
+        sThreadCountersGuard.active = true;
+    }
+}
+
+void AllocationTracker::Flush()
+{
+    ThreadCounters& counters = sThreadCounters;
+    const uint32 tagsNum = mTagsNum.load(std::memory_order_acquire);
+
+    for (uint32 i = 0; i < tagsNum; ++i)
+    {
+        if (counters.tags[i].operationsNum > 0)
+        {
+            FlushTag(counters, static_cast<MemoryTag>(i));
+        }
+    }
+}
+
+uint32 AllocationTracker::GetTagsNum() const
+{
+    return mTagsNum.load(std::memory_order_acquire);
+}
+
+bool AllocationTracker::GetTagStats(MemoryTag tag, MemoryTagStats& outStats) const
+{
+    if (tag >= GetTagsNum())
+    {
+        return false;
+    }
+
+    const GlobalCounters& counters = mCounters[tag];
+    outStats.name = counters.name;
+    outStats.bytesAllocated = static_cast<size_t>(Math::Max<int64>(counters.bytesAllocated.load(), 0));
+    outStats.peakBytesAllocated = static_cast<size_t>(Math::Max<int64>(counters.peakBytesAllocated.load(), 0));
+    outStats.allocationsNum = static_cast<size_t>(Math::Max<int64>(counters.allocationsNum.load(), 0));
+    outStats.totalBytesAllocated = counters.totalBytesAllocated.load();
+    outStats.totalAllocationsNum = counters.totalAllocationsNum.load();
+    return true;
+}
+
+void AllocationTracker::Report()
+{
+    Flush();
+
+    mReportLock.AcquireExclusive();
+
+    const double elapsedTime = Math::Max(mReportTimer.Restart(), 1.0e-6);
+
+    NFE_LOG_INFO("Memory usage by tag (allocation rate over last %.2f s):", elapsedTime);
+
+    const uint32 tagsNum = GetTagsNum();
+    for (uint32 i = 0; i < tagsNum; ++i)
+    {
+        MemoryTagStats stats;
+        GetTagStats(static_cast<MemoryTag>(i), stats);
+
+        if (stats.totalAllocationsNum == 0)
+        {
+            continue;
+        }
+
+        const double allocationRate = static_cast<double>(stats.totalAllocationsNum - mReportedAllocationsNum[i]) / elapsedTime;
+        const double bytesRate = static_cast<double>(stats.totalBytesAllocated - mReportedBytes[i]) / elapsedTime;
+        mReportedAllocationsNum[i] = stats.totalAllocationsNum;
+        mReportedBytes[i] = stats.totalBytesAllocated;
+
+        NFE_LOG_INFO("    %-24s %zu blocks (%zu bytes), peak %zu bytes, %.0f allocations/s (%.2f MB/s)",
+            stats.name, stats.allocationsNum, stats.bytesAllocated, stats.peakBytesAllocated,
+            allocationRate, bytesRate / (1024.0 * 1024.0));
+    }
+
+    mReportLock.ReleaseExclusive();
+}
+
+
+} // namespace Common
+} // namespace NFE
@@ -0,0 +1,149 @@
+/**
+ * @file
+ * @author Witek902 (witek902@gmail.com)
+ * @brief  Tagged memory allocation tracker declaration.
+ */
+
+#pragma once
+
+#include "../nfCommon.hpp"
+#include "../System/Mutex.hpp"
+#include "../System/Timer.hpp"
+
+#include <atomic>
+
+
+namespace NFE {
+namespace Common {
+
+using MemoryTag = uint16;
+
+struct MemoryTagStats
+{
+    const char* name;
+    size_t bytesAllocated;          // currently allocated bytes
+    size_t peakBytesAllocated;
+    size_t allocationsNum;          // currently allocated blocks
+    uint64 totalBytesAllocated;     // since the tracking was enabled
+    uint64 totalAllocationsNum;
+};
+
+/**
+ * Per-tag memory usage counters.
+ *
+ * When tracking is enabled in the DefaultAllocator, every allocation is attributed to the current tag
+ * of the calling thread (see MemoryTagScope). Counters are accumulated per thread and flushed to
+ * the global counters in batches, so the values (including peak usage) may be behind by up
+ * to FlushThreshold bytes per thread.
+ */
+class NFCOMMON_API AllocationTracker final
+{
+    NFE_MAKE_NONCOPYABLE(AllocationTracker)
+    NFE_MAKE_NONMOVEABLE(AllocationTracker)
+
+public:
+    static constexpr MemoryTag UntaggedTag = 0;
+    static constexpr uint32 MaxTags = 128;
+
+    // thread counters of a tag are flushed after this many operations or bytes
+    static constexpr uint32 FlushInterval = 256;
+    static constexpr int64 FlushThreshold = 1024 * 1024;
+
+    static AllocationTracker& GetInstance();
+
+    /**
+     * Register a new tag or get existing one with the same name.
+     * @param name  Tag name. Must be a string literal (the pointer is stored).
+     * @return      Registered tag or UntaggedTag if the limit of tags is reached.
+     */
+    MemoryTag RegisterTag(const char* name);
+
+    /**
+     * Get/set tag assigned to allocations made by the calling thread.
+     */
+    static MemoryTag GetCurrentTag();
+    static void SetCurrentTag(MemoryTag tag);
+
+    // called by the allocator
+    void OnAllocate(MemoryTag tag, size_t size);
+    void OnFree(MemoryTag tag, size_t size);
+
+    /**
+     * Flush counters of the calling thread to the global counters.
+     */
+    void Flush();
+
+    /**
+     * Get number of registered tags (including UntaggedTag).
+     */
+    uint32 GetTagsNum() const;
+
+    /**
+     * Get usage statistics of a tag.
+     */
+    bool GetTagStats(MemoryTag tag, MemoryTagStats& outStats) const;
+
+    /**
+     * Log usage of all the tags and allocation rate since the previous report.
+     */
+    void Report();
+
+private:
+    struct GlobalCounters;
+    struct ThreadCounters;
+    struct ThreadCountersGuard;
+
+    static thread_local ThreadCounters sThreadCounters;
+    static thread_local ThreadCountersGuard sThreadCountersGuard;
+    static thread_local MemoryTag sCurrentTag;
+
+    GlobalCounters* mCounters;
+    std::atomic<uint32> mTagsNum;
+    Mutex mRegisterLock;
+
+    // for allocation rate
+    Mutex mReportLock;
+    Timer mReportTimer;
+    uint64 mReportedAllocationsNum[MaxTags];
+    uint64 mReportedBytes[MaxTags];
+
+    AllocationTracker();
+    ~AllocationTracker();
+
+    void RegisterThread(ThreadCounters& counters);
+    void FlushTag(ThreadCounters& counters, MemoryTag tag);
+};
+
+/**
+ * Assign a memory tag to allocations made by the current thread within a scope.
+ */
+class MemoryTagScope final
+{
+    NFE_MAKE_NONCOPYABLE(MemoryTagScope)
+    NFE_MAKE_NONMOVEABLE(MemoryTagScope)
+
+public:
+    NFE_FORCE_INLINE explicit MemoryTagScope(MemoryTag tag)
+        : mPrevTag(AllocationTracker::GetCurrentTag())
+    {
+        AllocationTracker::SetCurrentTag(tag);
+    }
+
+    NFE_FORCE_INLINE ~MemoryTagScope()
+    {
+        AllocationTracker::SetCurrentTag(mPrevTag);
+    }
+
+private:
+    MemoryTag mPrevTag;
+};
+
+
+} // namespace Common
+} // namespace NFE
+
+
+// Tag allocations made in the current scope. The tag is registered once per call site.
+#define NFE_MEMORY_TAG_SCOPE(name)                                                                                          \
+    static const NFE::Common::MemoryTag NFE_UNIQUE_NAME(__memoryTag) = NFE::Common::AllocationTracker::GetInstance().RegisterTag(name); \
+    NFE::Common::MemoryTagScope NFE_UNIQUE_NAME(__memoryTagScope)(NFE_UNIQUE_NAME(__memoryTag))
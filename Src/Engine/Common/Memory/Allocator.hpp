@@ -0,0 +1,102 @@
+/**
+ * @file
+ * @author Witek902 (witek902@gmail.com)
+ * @brief  Polymorphic memory allocator interface.
+ */
+
+#pragma once
+
+#include "DefaultAllocator.hpp"
+
+
+namespace NFE {
+namespace Common {
+
+/**
+ * Polymorphic memory allocator interface.
+ * Containers (DynArray, HashSet, HashMap, String) can be given a pointer to an allocator,
+ * so temporary data can be placed on a stack buffer or in an arena instead of the global heap.
+ * Null allocator pointer means the DefaultAllocator.
+ *
+ * @note    The allocator must outlive all the containers using it.
+ */
+class IAllocator
+{
+public:
+    virtual ~IAllocator() = default;
+
+    /**
+     * Allocate memory block.
+     * @return nullptr on error or valid memory block pointer.
+     */
+    virtual void* Malloc(size_t size, size_t alignment) = 0;
+
+    /**
+     * Free memory block allocated with @p Malloc method.
+     */
+    virtual void Free(void* ptr) = 0;
+
+    /**
+     * Try to resize a memory block in place, without moving it.
+     * @return  True if the block now has at least 'newSize' bytes.
+     */
+    virtual bool TryResize(void* ptr, size_t oldSize, size_t newSize)
+    {
+        NFE_UNUSED(ptr);
+        NFE_UNUSED(oldSize);
+        NFE_UNUSED(newSize);
+        return false;
+    }
+
+    /**
+     * Check if a container can take over memory blocks of this allocator when it is moved.
+     * False for allocators that live inside the container owning them (e.g. InlineAllocator).
+     */
+    virtual bool IsTransferable() const
+    {
+        return true;
+    }
+};
+
+
+// allocate memory with given allocator or the default allocator if null
+NFE_FORCE_INLINE void* AllocatorMalloc(IAllocator* allocator, size_t size, size_t alignment)
+{
+    if (allocator)
+    {
+        return allocator->Malloc(size, alignment);
+    }
+
+    return NFE_MALLOC(size, alignment);
+}
+
+// free memory with given allocator or the default allocator if null
+NFE_FORCE_INLINE void AllocatorFree(IAllocator* allocator, void* ptr)
+{
+    if (allocator)
+    {
+        if (ptr)
+        {
+            allocator->Free(ptr);
+        }
+    }
+    else
+    {
+        NFE_FREE(ptr);
+    }
+}
+
+// try to resize a memory block in place (the default allocator never does it)
+NFE_FORCE_INLINE bool AllocatorTryResize(IAllocator* allocator, void* ptr, size_t oldSize, size_t newSize)
+{
+    if (allocator && ptr)
+    {
+        return allocator->TryResize(ptr, oldSize, newSize);
+    }
+
+    return false;
+}
+
+
+} // namespace Common
+} // namespace NFE
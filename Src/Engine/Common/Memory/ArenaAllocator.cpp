@@ -0,0 +1,292 @@
+/**
+ * @file
+ * @author Witek902 (witek902@gmail.com)
+ * @brief  Linear (arena) allocator definition.
+ */
+
+#include "PCH.hpp"
+#include "ArenaAllocator.hpp"
+#include "Logger/Logger.hpp"
+
+
+namespace NFE {
+namespace Common {
+
+struct ArenaAllocator::ChunkHeader
+{
+    ChunkHeader* next;
+    size_t size;    // usable size (excluding header)
+
+    NFE_FORCE_INLINE uint8* GetData()
+    {
+        return reinterpret_cast<uint8*>(this) + sizeof(ChunkHeader);
+    }
+
+    NFE_FORCE_INLINE uint8* GetEnd()
+    {
+        return GetData() + size;
+    }
+};
+
+static constexpr size_t ChunkAlignment = 64;
+
+static_assert(sizeof(ArenaAllocator::Marker) == 2 * sizeof(void*), "Unexpected marker size");
+
+
+ArenaAllocator::ArenaAllocator(size_t chunkSize)
+    : mFirstChunk(nullptr)
+    , mCurrentChunk(nullptr)
+    , mCurrentPtr(nullptr)
+    , mCurrentEnd(nullptr)
+    , mLastAllocation(nullptr)
+    , mChunkSize(chunkSize)
+    , mBytesUsedInPrevChunks(0)
+    , mPeakBytesUsed(0)
+    , mResetsNum(0)
+{
+    NFE_ASSERT(chunkSize > 0, "Invalid chunk size");
+}
+
+ArenaAllocator::ArenaAllocator(ArenaAllocator&& other)
+    : mFirstChunk(other.mFirstChunk)
+    , mCurrentChunk(other.mCurrentChunk)
+    , mCurrentPtr(other.mCurrentPtr)
+    , mCurrentEnd(other.mCurrentEnd)
+    , mLastAllocation(other.mLastAllocation)
+    , mChunkSize(other.mChunkSize)
+    , mBytesUsedInPrevChunks(other.mBytesUsedInPrevChunks)
+    , mPeakBytesUsed(other.mPeakBytesUsed)
+    , mResetsNum(other.mResetsNum)
+{
+    other.mFirstChunk = nullptr;
+    other.mCurrentChunk = nullptr;
+    other.mCurrentPtr = nullptr;
+    other.mCurrentEnd = nullptr;
+    other.mLastAllocation = nullptr;
+    other.mBytesUsedInPrevChunks = 0;
+    other.mPeakBytesUsed = 0;
+    other.mResetsNum = 0;
+}
+
+ArenaAllocator& ArenaAllocator::operator = (ArenaAllocator&& other)
+{
+    if (this != &other)
+    {
+        Release();
+
+        std::swap(mFirstChunk, other.mFirstChunk);
+        std::swap(mCurrentChunk, other.mCurrentChunk);
+        std::swap(mCurrentPtr, other.mCurrentPtr);
+        std::swap(mCurrentEnd, other.mCurrentEnd);
+        std::swap(mLastAllocation, other.mLastAllocation);
+        std::swap(mChunkSize, other.mChunkSize);
+        std::swap(mBytesUsedInPrevChunks, other.mBytesUsedInPrevChunks);
+        std::swap(mPeakBytesUsed, other.mPeakBytesUsed);
+        std::swap(mResetsNum, other.mResetsNum);
+    }
+
+    return *this;
+}
+
+ArenaAllocator::~ArenaAllocator()
+{
+    Release();
+}
+
+void ArenaAllocator::SetCurrentChunk(ChunkHeader* chunk, size_t bytesUsedInPrevChunks)
+{
+    mCurrentChunk = chunk;
+    mCurrentPtr = chunk ? chunk->GetData() : nullptr;
+    mCurrentEnd = chunk ? chunk->GetEnd() : nullptr;
+    mBytesUsedInPrevChunks = bytesUsedInPrevChunks;
+    mLastAllocation = nullptr;
+}
+
+void* ArenaAllocator::MallocSlow(size_t size, size_t alignment)
+{
+    if (size == 0)
+    {
+        NFE_LOG_ERROR("Allocated memory block must be greater than 0 bytes.");
+        return nullptr;
+    }
+
+    UpdatePeakUsage();
+
+    // try chunks left over after Rewind()
+    while (mCurrentChunk && mCurrentChunk->next)
+    {
+        SetCurrentChunk(mCurrentChunk->next, mBytesUsedInPrevChunks + mCurrentChunk->size);
+
+        uint8* ptr = reinterpret_cast<uint8*>((reinterpret_cast<size_t>(mCurrentPtr) + alignment - 1) & ~(alignment - 1));
+        if (ptr + size <= mCurrentEnd)
+        {
+            mCurrentPtr = ptr + size;
+            mLastAllocation = ptr;
+            return ptr;
+        }
+    }
+
+    // allocate new chunk
+    const size_t chunkSize = Math::Max(mChunkSize, size + alignment);
+    void* memory = NFE_MALLOC(sizeof(ChunkHeader) + chunkSize, ChunkAlignment);
+    if (!memory)
+    {
+        NFE_LOG_ERROR("Failed to allocate arena chunk (%zu bytes)", chunkSize);
+        return nullptr;
+    }
+
+    ChunkHeader* chunk = new (memory) ChunkHeader;
+    chunk->next = nullptr;
+    chunk->size = chunkSize;
+
+    if (mCurrentChunk)
+    {
+        mCurrentChunk->next = chunk;
+        SetCurrentChunk(chunk, mBytesUsedInPrevChunks + mCurrentChunk->size);
+    }
+    else
+    {
+        mFirstChunk = chunk;
+        SetCurrentChunk(chunk, 0);
+    }
+
+    uint8* ptr = reinterpret_cast<uint8*>((reinterpret_cast<size_t>(mCurrentPtr) + alignment - 1) & ~(alignment - 1));
+    NFE_ASSERT(ptr + size <= mCurrentEnd, "Arena chunk is too small");
+
+    mCurrentPtr = ptr + size;
+    mLastAllocation = ptr;
+    return ptr;
+}
+
+void ArenaAllocator::Free(void* ptr)
+{
+    // only the most recent allocation can be reclaimed
+    if (ptr && ptr == mLastAllocation)
+    {
+        UpdatePeakUsage();
+        mCurrentPtr = static_cast<uint8*>(ptr);
+        mLastAllocation = nullptr;
+    }
+}
+
+bool ArenaAllocator::TryResize(void* ptr, size_t oldSize, size_t newSize)
+{
+    NFE_UNUSED(oldSize);
+
+    if (ptr && ptr == mLastAllocation)
+    {
+        uint8* newEnd = static_cast<uint8*>(ptr) + newSize;
+        if (newEnd <= mCurrentEnd)
+        {
+            UpdatePeakUsage();
+            mCurrentPtr = newEnd;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ArenaAllocator::Rewind(const Marker& marker)
+{
+    UpdatePeakUsage();
+
+    ChunkHeader* markerChunk = static_cast<ChunkHeader*>(marker.chunk);
+    if (!markerChunk)
+    {
+        // the arena was empty when the marker was taken
+        SetCurrentChunk(mFirstChunk, 0);
+        return;
+    }
+
+    if (markerChunk != mCurrentChunk)
+    {
+        size_t bytesUsedInPrevChunks = 0;
+        for (ChunkHeader* chunk = mFirstChunk; chunk != markerChunk; chunk = chunk->next)
+        {
+            NFE_ASSERT(chunk, "Marker does not belong to this arena");
+            bytesUsedInPrevChunks += chunk->size;
+        }
+
+        SetCurrentChunk(markerChunk, bytesUsedInPrevChunks);
+    }
+
+    NFE_ASSERT(marker.ptr >= markerChunk->GetData() && marker.ptr <= markerChunk->GetEnd(), "Invalid marker");
+    mCurrentPtr = marker.ptr;
+    mLastAllocation = nullptr;
+}
+
+void ArenaAllocator::Reset()
+{
+    UpdatePeakUsage();
+    mResetsNum++;
+
+    if (mFirstChunk && mFirstChunk->next)
+    {
+        // merge chunks into a single one, so the next frame won't need to allocate anything
+        size_t totalSize = 0;
+        for (ChunkHeader* chunk = mFirstChunk; chunk; chunk = chunk->next)
+        {
+            totalSize += chunk->size;
+        }
+
+        const size_t chunkSize = mChunkSize;
+        Release();
+        mChunkSize = totalSize;
+        MallocSlow(1, 1);
+        mChunkSize = chunkSize;
+    }
+
+    SetCurrentChunk(mFirstChunk, 0);
+}
+
+void ArenaAllocator::Release()
+{
+    ChunkHeader* chunk = mFirstChunk;
+    while (chunk)
+    {
+        ChunkHeader* next = chunk->next;
+        NFE_FREE(chunk);
+        chunk = next;
+    }
+
+    mFirstChunk = nullptr;
+    SetCurrentChunk(nullptr, 0);
+}
+
+size_t ArenaAllocator::GetBytesUsed() const
+{
+    if (!mCurrentChunk)
+    {
+        return 0;
+    }
+
+    return mBytesUsedInPrevChunks + static_cast<size_t>(mCurrentPtr - mCurrentChunk->GetData());
+}
+
+void ArenaAllocator::UpdatePeakUsage()
+{
+    mPeakBytesUsed = Math::Max(mPeakBytesUsed, GetBytesUsed());
+}
+
+ArenaAllocatorStats ArenaAllocator::GetStats() const
+{
+    ArenaAllocatorStats stats;
+    stats.bytesUsed = GetBytesUsed();
+    stats.peakBytesUsed = Math::Max(mPeakBytesUsed, stats.bytesUsed);
+    stats.bytesReserved = 0;
+    stats.chunksNum = 0;
+    stats.resetsNum = mResetsNum;
+
+    for (ChunkHeader* chunk = mFirstChunk; chunk; chunk = chunk->next)
+    {
+        stats.bytesReserved += chunk->size;
+        stats.chunksNum++;
+    }
+
+    return stats;
+}
+
+
+} // namespace Common
+} // namespace NFE
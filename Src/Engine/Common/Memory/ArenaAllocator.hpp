@@ -0,0 +1,161 @@
+/**
+ * @file
+ * @author Witek902 (witek902@gmail.com)
+ * @brief  Linear (arena) allocator declaration.
+ */
+
+#pragma once
+
+#include "Allocator.hpp"
+#include "../Math/Math.hpp"
+#include "../System/Assertion.hpp"
+
+
+namespace NFE {
+namespace Common {
+
+struct ArenaAllocatorStats
+{
+    size_t bytesUsed;       // bytes allocated since the last reset (including alignment padding)
+    size_t peakBytesUsed;   // high-water mark of 'bytesUsed' over the arena's lifetime
+    size_t bytesReserved;   // total size of memory chunks owned by the arena
+    uint32 chunksNum;
+    uint32 resetsNum;
+};
+
+/**
+ * Linear (bump-pointer) allocator for short-lived, frame- or pass-scoped data.
+ *
+ * Allocation is just a pointer increment, individual Free calls are no-ops (except the last block,
+ * which is rolled back). All the memory is released at once with Reset() or rewound to a marker.
+ * Memory is taken from the default allocator in chunks. On Reset() the chunks are coalesced into
+ * a single one big enough for the previous usage, so in a steady state the arena does not
+ * touch the global heap at all.
+ *
+ * @note    The arena is not thread-safe - use one arena per thread.
+ */
+class NFCOMMON_API ArenaAllocator final : public IAllocator
+{
+public:
+    static constexpr size_t DefaultChunkSize = 64 * 1024;
+
+    // allocation state that can be restored with Rewind()
+    struct Marker
+    {
+        void* chunk;
+        uint8* ptr;
+    };
+
+    explicit ArenaAllocator(size_t chunkSize = DefaultChunkSize);
+    ArenaAllocator(ArenaAllocator&& other);
+    ArenaAllocator& operator = (ArenaAllocator&& other);
+    ~ArenaAllocator();
+
+    ArenaAllocator(const ArenaAllocator&) = delete;
+    ArenaAllocator& operator = (const ArenaAllocator&) = delete;
+
+    void* Malloc(size_t size, size_t alignment) override;
+    void Free(void* ptr) override;
+    bool TryResize(void* ptr, size_t oldSize, size_t newSize) override;
+
+    /**
+     * Allocate uninitialized array of objects.
+     */
+    template<typename T>
+    NFE_FORCE_INLINE T* AllocateArray(size_t count)
+    {
+        return static_cast<T*>(Malloc(count * sizeof(T), alignof(T)));
+    }
+
+    /**
+     * Get current allocation state.
+     */
+    NFE_FORCE_INLINE Marker GetMarker() const
+    {
+        return { mCurrentChunk, mCurrentPtr };
+    }
+
+    /**
+     * Free all the allocations made after the marker was obtained.
+     * The memory chunks are kept for reuse.
+     */
+    void Rewind(const Marker& marker);
+
+    /**
+     * Free all the allocations at once. Memory chunks are merged and kept for reuse.
+     */
+    void Reset();
+
+    /**
+     * Free all the allocations and release memory chunks.
+     */
+    void Release();
+
+    /**
+     * Get arena statistics.
+     */
+    ArenaAllocatorStats GetStats() const;
+
+private:
+    struct ChunkHeader;
+
+    ChunkHeader* mFirstChunk;
+    ChunkHeader* mCurrentChunk;
+    uint8* mCurrentPtr;
+    uint8* mCurrentEnd;
+    void* mLastAllocation;
+
+    size_t mChunkSize;
+    size_t mBytesUsedInPrevChunks;  // capacity of chunks preceding the current one
+    size_t mPeakBytesUsed;
+    uint32 mResetsNum;
+
+    void* MallocSlow(size_t size, size_t alignment);
+    size_t GetBytesUsed() const;
+    void UpdatePeakUsage();
+    void SetCurrentChunk(ChunkHeader* chunk, size_t bytesUsedInPrevChunks);
+};
+
+
+NFE_FORCE_INLINE void* ArenaAllocator::Malloc(size_t size, size_t alignment)
+{
+    NFE_ASSERT(Math::IsPowerOfTwo(alignment), "Invalid alignment");
+
+    uint8* ptr = reinterpret_cast<uint8*>((reinterpret_cast<size_t>(mCurrentPtr) + alignment - 1) & ~(alignment - 1));
+    if (ptr + size <= mCurrentEnd && mCurrentPtr)
+    {
+        mCurrentPtr = ptr + size;
+        mLastAllocation = ptr;
+        return ptr;
+    }
+
+    return MallocSlow(size, alignment);
+}
+
+
+/**
+ * Restores arena allocation state on scope exit.
+ */
+class ArenaScope final
+{
+    NFE_MAKE_NONCOPYABLE(ArenaScope)
+
+public:
+    NFE_FORCE_INLINE explicit ArenaScope(ArenaAllocator& arena)
+        : mArena(arena)
+        , mMarker(arena.GetMarker())
+    { }
+
+    NFE_FORCE_INLINE ~ArenaScope()
+    {
+        mArena.Rewind(mMarker);
+    }
+
+private:
+    ArenaAllocator& mArena;
+    ArenaAllocator::Marker mMarker;
+};
+
+
+} // namespace Common
+} // namespace NFE
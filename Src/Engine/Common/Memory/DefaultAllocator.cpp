@@ -6,23 +6,58 @@
 
 #include "PCH.hpp"
 #include "DefaultAllocator.hpp"
+#include "AllocationTracker.hpp"
 #include "Logger/Logger.hpp"
 #include "Math/Math.hpp"
 
 
-// TODO
-// 1. Allocated size tracking in Release mode
-// 2. Usage of custom memory allocators (depending on allocation size).
+#include "../System/Memory.hpp"
+
 
 namespace NFE {
 namespace Common {
 
+namespace {
+
+// address space reserved for small blocks
+const size_t SmallBlocksRegionSize = sizeof(void*) == 8 ? (size_t(16) << 30) : (size_t(256) << 20);
+
+// stored right before every big (or tracked) block
+struct LargeBlockHeader
+{
+    size_t size;        // requested size
+    uint32 offset;      // offset from the beginning of the underlying allocation
+    uint32 flags;       // lower 16 bits: flags, upper 16 bits: memory tag
+};
+
+static_assert(sizeof(LargeBlockHeader) == SmallBlockAllocator::MinAlignment, "Invalid big block header size");
+
+const uint32 LargeBlockFlag_LargePages = 1 << 0;
+const uint32 LargeBlockFlag_Tracked = 1 << 1;
+const uint32 LargeBlockTagShift = 16;
+
+} // namespace
+
 
 DefaultAllocator::DefaultAllocator()
     : mAllocationsNum(0)
     , mBytesAllocated(0)
+    , mLargePageSize(0)
+    , mLargePagesEnabled(false)
     , mInitialized(true)
+    , mTrackingEnabled(false)
+    , mTrackingUsed(false)
 {
+    // if address space can't be reserved, all the blocks are allocated by the system
+    // Note: logger can't be used here, as it allocates memory
+    mSmallBlocks.Init(SmallBlocksRegionSize);
+
+    // allow tracking allocations made during static initialization
+    const char* trackMemory = getenv("NFE_TRACK_MEMORY");
+    if (trackMemory && trackMemory[0] == '1')
+    {
+        EnableTracking(true);
+    }
 }
 
 DefaultAllocator::~DefaultAllocator()
@@ -42,6 +77,27 @@ void DefaultAllocator::Shutdown()
     mInitialized = false;
 }
 
+bool DefaultAllocator::EnableLargePages()
+{
+    if (!mLargePagesEnabled && Common::EnableLargePages())
+    {
+        mLargePageSize = GetLargePageSize();
+        mLargePagesEnabled = mLargePageSize > 0;
+    }
+
+    return mLargePagesEnabled;
+}
+
+void DefaultAllocator::EnableTracking(bool enable)
+{
+    if (enable)
+    {
+        mTrackingUsed = true;
+    }
+
+    mTrackingEnabled.store(enable, std::memory_order_relaxed);
+}
+
 void* DefaultAllocator::Malloc(size_t size, size_t alignment, const char* sourceFile, int sourceLine)
 {
     NFE_ASSERT(mInitialized, "Default memory allocator is not initialized");
@@ -63,32 +119,97 @@ void* DefaultAllocator::Malloc(size_t size, size_t alignment, const char* source
         return nullptr;
     }
 
-    void* ptr = nullptr;
+    if (mTrackingEnabled.load(std::memory_order_relaxed))
+    {
+        return MallocTracked(size, alignment, sourceFile, sourceLine);
+    }
+
+    if (void* ptr = mSmallBlocks.Malloc(size, alignment))
+    {
+        return ptr;
+    }
 
-#if defined(NFE_PLATFORM_WINDOWS)
-    ptr = _aligned_malloc_dbg(size, alignment, sourceFile, sourceLine);
-#elif defined(NFE_PLATFORM_LINUX)
-    alignment = std::max(alignment, sizeof(void*));
-    int ret = posix_memalign(&ptr, alignment, size);
-    if (ret != 0)
+    return MallocLarge(size, alignment, sourceFile, sourceLine, 0);
+}
+
+void* DefaultAllocator::MallocTracked(size_t size, size_t alignment, const char* sourceFile, int sourceLine)
+{
+    // tag is stored in the block header, so small blocks can't be used here
+    const MemoryTag tag = AllocationTracker::GetCurrentTag();
+    void* ptr = MallocLarge(size, alignment, sourceFile, sourceLine, LargeBlockFlag_Tracked | (static_cast<uint32>(tag) << LargeBlockTagShift));
+    if (ptr)
+    {
+        AllocationTracker::GetInstance().OnAllocate(tag, size);
+    }
+
+    return ptr;
+}
+
+void* DefaultAllocator::MallocLarge(size_t size, size_t alignment, const char* sourceFile, int sourceLine, uint32 flags)
+{
+    // header is placed right before the returned pointer
+    alignment = Math::Max(alignment, sizeof(LargeBlockHeader));
+    const size_t headerSpace = alignment;
+    if (size > std::numeric_limits<size_t>::max() - headerSpace || headerSpace > std::numeric_limits<uint32>::max())
+    {
+        NFE_LOG_ERROR("Memory allocation requested from %s:%i is too big, size=%zu, alignment=%zu", sourceFile, sourceLine, size, alignment);
+        return nullptr;
+    }
+
+    size_t totalSize = size + headerSpace;
+
+    uint8* basePtr = nullptr;
+
+    if (mLargePagesEnabled && size >= LargePagesMinNumPages * mLargePageSize && alignment <= mLargePageSize &&
+        totalSize <= std::numeric_limits<size_t>::max() - mLargePageSize)
     {
-        NFE_LOG_ERROR("posix_memalign() returned %i", ret);
-        ptr = nullptr;
+        totalSize = Math::RoundUp(totalSize, mLargePageSize);
+        basePtr = static_cast<uint8*>(AllocateLargePages(totalSize));
+        if (basePtr)
+        {
+            flags |= LargeBlockFlag_LargePages;
+        }
+        else
+        {
+            totalSize = size + headerSpace;
+        }
     }
+
+    if (!basePtr)
+    {
+        void* ptr = nullptr;
+#if defined(NFE_PLATFORM_WINDOWS)
+        ptr = _aligned_malloc_dbg(totalSize, alignment, sourceFile, sourceLine);
+#elif defined(NFE_PLATFORM_LINUX)
+        int ret = posix_memalign(&ptr, alignment, totalSize);
+        if (ret != 0)
+        {
+            NFE_LOG_ERROR("posix_memalign() returned %i", ret);
+            ptr = nullptr;
+        }
 #else
 #error Invalid platform
 #endif // defined(NFE_PLATFORM_WINDOWS)
 
-    if (ptr)
-    {
-        mAllocationsNum++;
+        basePtr = static_cast<uint8*>(ptr);
     }
-    else
+
+    if (!basePtr)
     {
         NFE_LOG_ERROR("Memory allocation requested from %s:%i failed, size=%zu, alignment=%zu, errno=%i",
             sourceFile, sourceLine, size, alignment, errno);
+        return nullptr;
     }
 
+    uint8* ptr = basePtr + headerSpace;
+    LargeBlockHeader* header = reinterpret_cast<LargeBlockHeader*>(ptr) - 1;
+    header->size = size;
+    header->offset = static_cast<uint32>(headerSpace);
+    header->flags = flags;
+
+    mAllocationsNum++;
+    mBytesAllocated += size;
+
     return ptr;
 }
 
@@ -99,26 +220,66 @@ void DefaultAllocator::Free(void* ptr)
         return;
     }
 
+    if (mSmallBlocks.OwnsBlock(ptr))
+    {
+        mSmallBlocks.Free(ptr);
+    }
+    else
+    {
+        FreeLarge(ptr);
+    }
+}
+
+void DefaultAllocator::FreeLarge(void* ptr)
+{
+    const LargeBlockHeader* header = static_cast<const LargeBlockHeader*>(ptr) - 1;
+    const size_t size = header->size;
+    const uint32 flags = header->flags;
+    uint8* basePtr = static_cast<uint8*>(ptr) - header->offset;
+
     mAllocationsNum--;
+    mBytesAllocated -= size;
 
-#if defined(NFE_PLATFORM_WINDOWS)
-    _aligned_free(ptr);
+    if (flags & LargeBlockFlag_Tracked)
+    {
+        AllocationTracker::GetInstance().OnFree(static_cast<MemoryTag>(flags >> LargeBlockTagShift), size);
+    }
 
+    if (flags & LargeBlockFlag_LargePages)
+    {
+        ReleaseMemoryPages(basePtr, Math::RoundUp(size + header->offset, mLargePageSize));
+        return;
+    }
+
+#if defined(NFE_PLATFORM_WINDOWS)
+    _aligned_free(basePtr);
 #elif defined(NFE_PLATFORM_LINUX)
-    free(ptr);
+    free(basePtr);
 #endif // defined(NFE_PLATFORM_WINDOWS)
 }
 
 void DefaultAllocator::ReportAllocations()
 {
-    NFE_LOG_INFO("Allocated blocks: %zu", mAllocationsNum.load());
+    const AllocatorStats stats = GetStats();
+    const SmallBlockAllocatorStats smallBlocksStats = mSmallBlocks.GetStats();
+
+    NFE_LOG_INFO("Allocated blocks: %zu (%zu bytes)", stats.allocationsNum, stats.bytesAllocated);
+    NFE_LOG_INFO("Small blocks: %zu (%zu bytes), %u spans (%zu bytes) reserved",
+        smallBlocksStats.allocationsNum, smallBlocksStats.bytesAllocated, smallBlocksStats.spansNum, smallBlocksStats.bytesReserved);
+
+    if (mTrackingUsed)
+    {
+        AllocationTracker::GetInstance().Report();
+    }
 }
 
 AllocatorStats DefaultAllocator::GetStats() const
 {
+    const SmallBlockAllocatorStats smallBlocksStats = mSmallBlocks.GetStats();
+
     AllocatorStats stats;
-    stats.allocationsNum = mAllocationsNum;
-    stats.bytesAllocated = mBytesAllocated;
+    stats.allocationsNum = mAllocationsNum + smallBlocksStats.allocationsNum;
+    stats.bytesAllocated = mBytesAllocated + smallBlocksStats.bytesAllocated;
     return stats;
 }
 
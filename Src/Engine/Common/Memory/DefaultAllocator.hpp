@@ -7,6 +7,7 @@
 #pragma once
 #include "../nfCommon.hpp"
 #include "../System/Mutex.hpp"
+#include "SmallBlockAllocator.hpp"
 
 #include <atomic>
 
@@ -27,9 +28,18 @@ struct AllocatorStats
     size_t allocationsNum;
 };
 
+/**
+ * Global memory allocator.
+ *
+ * Small blocks (up to SmallBlockAllocator::MaxBlockSize) are served from size-class pools with per-thread
+ * caches. Bigger blocks go straight to the system allocator, optionally backed with large (huge) pages.
+ */
 class NFCOMMON_API DefaultAllocator
 {
 public:
+    // minimum block size to be backed with large pages (in multiples of large page size)
+    static constexpr size_t LargePagesMinNumPages = 4;
+
     /**
      * Get instance of default global memory allocator.
      */
@@ -68,12 +78,41 @@ public:
      */
     AllocatorStats GetStats() const;
 
+    /**
+     * Enable backing big memory blocks (e.g. bitmaps, BVH nodes) with large pages.
+     * @return  True if large pages are supported.
+     */
+    bool EnableLargePages();
+
+    /**
+     * Enable or disable tagged allocation tracking (see AllocationTracker).
+     * @note    Tracking can also be enabled at startup with NFE_TRACK_MEMORY=1 environment variable.
+     * @remarks Tracked blocks bypass the small block pool, so the allocator is slower when tracking is enabled.
+     *          Blocks allocated before enabling the tracking are not accounted.
+     */
+    void EnableTracking(bool enable);
+
+    NFE_FORCE_INLINE bool IsTrackingEnabled() const
+    {
+        return mTrackingEnabled.load(std::memory_order_relaxed);
+    }
+
 private:
+    SmallBlockAllocator mSmallBlocks;
 
+    // statistics of big blocks only
     std::atomic<size_t> mAllocationsNum;
     std::atomic<size_t> mBytesAllocated;
 
+    size_t mLargePageSize;
+    bool mLargePagesEnabled;
     bool mInitialized;
+    std::atomic<bool> mTrackingEnabled;
+    bool mTrackingUsed;
+
+    void* MallocTracked(size_t size, size_t alignment, const char* sourceFile, int sourceLine);
+    void* MallocLarge(size_t size, size_t alignment, const char* sourceFile, int sourceLine, uint32 flags);
+    void FreeLarge(void* ptr);
 
     DefaultAllocator();
     ~DefaultAllocator();
@@ -0,0 +1,91 @@
+/**
+ * @file
+ * @author Witek902 (witek902@gmail.com)
+ * @brief  Allocator with inline (small-buffer) storage.
+ */
+
+#pragma once
+
+#include "Allocator.hpp"
+#include "../System/Assertion.hpp"
+
+
+namespace NFE {
+namespace Common {
+
+/**
+ * Allocator holding a fixed-size buffer inside itself (e.g. on the stack).
+ * The buffer is handed out to a single allocation at a time, bigger or concurrent allocations
+ * fall back to the upstream allocator (the default allocator if null).
+ * Intended to back one container, e.g. a temporary HashSet or String in a hot function.
+ */
+template<size_t Size, size_t Alignment = 16>
+class InlineAllocator final : public IAllocator
+{
+public:
+    static_assert(Size > 0, "Inline buffer size must be greater than zero");
+
+    NFE_FORCE_INLINE explicit InlineAllocator(IAllocator* upstream = nullptr)
+        : mUpstream(upstream)
+        , mBufferUsed(false)
+    { }
+
+    ~InlineAllocator()
+    {
+        NFE_ASSERT(!mBufferUsed, "Inline buffer is still in use");
+    }
+
+    InlineAllocator(const InlineAllocator&) = delete;
+    InlineAllocator& operator = (const InlineAllocator&) = delete;
+
+    NFE_FORCE_INLINE bool IsBufferUsed() const { return mBufferUsed; }
+    NFE_FORCE_INLINE bool OwnsBlock(const void* ptr) const { return ptr == mBuffer; }
+
+    void* Malloc(size_t size, size_t alignment) override
+    {
+        if (!mBufferUsed && size <= Size && alignment <= Alignment)
+        {
+            mBufferUsed = true;
+            return mBuffer;
+        }
+
+        return AllocatorMalloc(mUpstream, size, alignment);
+    }
+
+    void Free(void* ptr) override
+    {
+        if (OwnsBlock(ptr))
+        {
+            NFE_ASSERT(mBufferUsed, "Inline buffer freed twice");
+            mBufferUsed = false;
+            return;
+        }
+
+        AllocatorFree(mUpstream, ptr);
+    }
+
+    bool TryResize(void* ptr, size_t oldSize, size_t newSize) override
+    {
+        if (OwnsBlock(ptr))
+        {
+            return newSize <= Size;
+        }
+
+        return AllocatorTryResize(mUpstream, ptr, oldSize, newSize);
+    }
+
+    bool IsTransferable() const override
+    {
+        // the buffer is destroyed together with the allocator's owner
+        return false;
+    }
+
+private:
+    alignas(Alignment) uint8 mBuffer[Size];
+    IAllocator* mUpstream;
+    bool mBufferUsed;
+};
+
+
+} // namespace Common
+} // namespace NFE
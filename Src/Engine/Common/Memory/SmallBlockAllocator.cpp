@@ -0,0 +1,463 @@
+/**
+ * @file
+ * @author Witek902 (witek902@gmail.com)
+ * @brief  Small block (size-class) allocator definition.
+ */
+
+#include "PCH.hpp"
+#include "SmallBlockAllocator.hpp"
+#include "../System/SpinLockImpl.hpp"
+#include "../System/Memory.hpp"
+#include "../Math/Math.hpp"
+
+
+namespace NFE {
+namespace Common {
+
+namespace {
+
+// 16-byte steps up to 128 bytes, then 4 classes per power of two
+const uint32 gSizeClasses[SmallBlockAllocator::NumSizeClasses] =
+{
+    16, 32, 48, 64, 80, 96, 112, 128,
+    160, 192, 224, 256,
+    320, 384, 448, 512,
+    640, 768, 896, 1024,
+    1280, 1536, 1792, 2048,
+    2560, 3072, 3584, 4096,
+};
+
+static_assert(SmallBlockAllocator::MaxBlockSize == 4096, "Size classes table must cover all small blocks");
+
+// number of blocks moved between a thread cache and the shared pool at once
+NFE_FORCE_INLINE uint32 GetBatchSize(uint32 sizeClass)
+{
+    return Math::Clamp<uint32>(static_cast<uint32>(16 * 1024) / gSizeClasses[sizeClass], 4u, 64u);
+}
+
+} // namespace
+
+
+struct SmallBlockAllocator::FreeBlock
+{
+    FreeBlock* next;
+};
+
+struct NFE_ALIGN(NFE_CACHE_LINE_SIZE) SmallBlockAllocator::SharedBin
+{
+    SpinLock lock;
+    FreeBlock* freeList = nullptr;
+    uint8* spanPtr = nullptr;   // free space in the most recent span
+    uint8* spanEnd = nullptr;
+};
+
+struct SmallBlockAllocator::ThreadCache
+{
+    struct Bin
+    {
+        FreeBlock* head;
+        uint32 count;
+    };
+
+    Bin bins[NumSizeClasses];
+
+    // written only by the owning thread, read by GetStats()
+    std::atomic<int64> bytesAllocated;
+    std::atomic<int64> allocationsNum;
+
+    ThreadCache* prev;
+    ThreadCache* next;
+    SmallBlockAllocator* owner;
+    bool released;
+};
+
+struct SmallBlockAllocator::ThreadCacheGuard
+{
+    bool active = false;
+
+    ~ThreadCacheGuard()
+    {
+        if (sThreadCache.owner)
+        {
+            sThreadCache.owner->ReleaseThreadCache(sThreadCache);
+        }
+    }
+};
+
+// zero-initialized, trivially destructible - it stays accessible until the thread really terminates
+thread_local SmallBlockAllocator::ThreadCache SmallBlockAllocator::sThreadCache;
+thread_local SmallBlockAllocator::ThreadCacheGuard SmallBlockAllocator::sThreadCacheGuard;
+
+
+SmallBlockAllocator::SmallBlockAllocator()
+    : mRegionBase(nullptr)
+    , mRegionSize(0)
+    , mBins(nullptr)
+    , mSpanSizeClasses(nullptr)
+    , mMaxSpans(0)
+    , mFirstSpan(0)
+    , mSpansNum(0)
+    , mThreadCaches(nullptr)
+    , mRetiredBytes(0)
+    , mRetiredAllocations(0)
+{
+    uint32 sizeClass = 0;
+    for (uint32 i = 0; i <= MaxBlockSize / MinAlignment; ++i)
+    {
+        while (gSizeClasses[sizeClass] < i * MinAlignment)
+        {
+            sizeClass++;
+        }
+        mSizeClassLookup[i] = static_cast<uint8>(sizeClass);
+    }
+}
+
+SmallBlockAllocator::~SmallBlockAllocator()
+{
+    // Address space is intentionally not released - blocks can still be freed by static objects
+    // destroyed later and the process is terminating anyway.
+}
+
+bool SmallBlockAllocator::Init(size_t regionSize)
+{
+    NFE_ASSERT(!mRegionBase, "Small block allocator is already initialized");
+    NFE_ASSERT(regionSize % SpanSize == 0, "Region size must be a multiple of span size");
+
+    uint8* regionBase = static_cast<uint8*>(ReserveMemoryPages(regionSize));
+    if (!regionBase)
+    {
+        return false;
+    }
+
+    // the first spans hold shared bins and size class table
+    const size_t binsSize = sizeof(SharedBin) * NumSizeClasses;
+    const uint32 maxSpans = static_cast<uint32>(regionSize / SpanSize);
+    const uint32 firstSpan = static_cast<uint32>((binsSize + maxSpans + SpanSize - 1) / SpanSize);
+    if (!CommitMemoryPages(regionBase, firstSpan * SpanSize))
+    {
+        ReleaseMemoryPages(regionBase, regionSize);
+        return false;
+    }
+
+    mBins = new (regionBase) SharedBin[NumSizeClasses];
+    mSpanSizeClasses = regionBase + binsSize;
+    mMaxSpans = maxSpans;
+    mFirstSpan = firstSpan;
+    mSpansNum = firstSpan;
+
+    // publish the region last, so OwnsBlock() does not claim anything before the pool is ready
+    mRegionSize = regionSize;
+    mRegionBase = regionBase;
+    return true;
+}
+
+void* SmallBlockAllocator::Malloc(size_t size, size_t alignment)
+{
+    if (size > MaxBlockSize || alignment > MaxBlockSize || !mRegionBase)
+    {
+        return nullptr;
+    }
+
+    if (alignment > MinAlignment)
+    {
+        // power-of-two blocks in a span are naturally aligned
+        size = Math::NextPowerOfTwo(static_cast<uint32>(Math::Max(size, alignment)));
+    }
+
+    const uint32 sizeClass = mSizeClassLookup[(size + MinAlignment - 1) / MinAlignment];
+
+    ThreadCache& cache = sThreadCache;
+    if (cache.owner != this && !InitThreadCache(cache))
+    {
+        return MallocShared(sizeClass);
+    }
+
+    ThreadCache::Bin& bin = cache.bins[sizeClass];
+    FreeBlock* block = bin.head;
+    if (block)
+    {
+        bin.head = block->next;
+        bin.count--;
+    }
+    else
+    {
+        block = Refill(cache, sizeClass);
+        if (!block)
+        {
+            return nullptr;
+        }
+    }
+
+    // only this thread writes the counters, so no atomic read-modify-write is needed
+    cache.bytesAllocated.store(cache.bytesAllocated.load(std::memory_order_relaxed) + gSizeClasses[sizeClass], std::memory_order_relaxed);
+    cache.allocationsNum.store(cache.allocationsNum.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+    return block;
+}
+
+void SmallBlockAllocator::Free(void* ptr)
+{
+    NFE_ASSERT(OwnsBlock(ptr), "Block does not belong to the small block allocator");
+
+    const size_t spanIndex = static_cast<size_t>(static_cast<uint8*>(ptr) - mRegionBase) / SpanSize;
+    NFE_ASSERT(spanIndex >= mFirstSpan, "Invalid block");
+    const uint32 sizeClass = mSpanSizeClasses[spanIndex];
+
+    FreeBlock* block = static_cast<FreeBlock*>(ptr);
+
+    ThreadCache& cache = sThreadCache;
+    if (cache.owner != this && !InitThreadCache(cache))
+    {
+        FreeShared(block, sizeClass);
+        return;
+    }
+
+    ThreadCache::Bin& bin = cache.bins[sizeClass];
+    block->next = bin.head;
+    bin.head = block;
+    bin.count++;
+
+    cache.bytesAllocated.store(cache.bytesAllocated.load(std::memory_order_relaxed) - gSizeClasses[sizeClass], std::memory_order_relaxed);
+    cache.allocationsNum.store(cache.allocationsNum.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+
+    const uint32 batchSize = GetBatchSize(sizeClass);
+    if (bin.count > 2 * batchSize)
+    {
+        ReleaseBlocks(cache, sizeClass, batchSize);
+    }
+}
+
+bool SmallBlockAllocator::InitThreadCache(ThreadCache& cache)
+{
+    if (cache.released)
+    {
+        // the thread is terminating
+        return false;
+    }
+
+    NFE_ASSERT(!cache.owner, "There can be only one small block allocator");
+
+    for (ThreadCache::Bin& bin : cache.bins)
+    {
+        bin.head = nullptr;
+        bin.count = 0;
+    }
+
+    cache.bytesAllocated = 0;
+    cache.allocationsNum = 0;
+    cache.owner = this;
+
+    // make sure the cache is flushed on thread exit
+    sThreadCacheGuard.active = true;
+
+    mThreadCachesLock.AcquireExclusive();
+    {
+        cache.prev = nullptr;
+        cache.next = mThreadCaches;
+        if (mThreadCaches)
+        {
+            mThreadCaches->prev = &cache;
+        }
+        mThreadCaches = &cache;
+    }
+    mThreadCachesLock.ReleaseExclusive();
+
+    return true;
+}
+
+void SmallBlockAllocator::ReleaseThreadCache(ThreadCache& cache)
+{
+    for (uint32 i = 0; i < NumSizeClasses; ++i)
+    {
+        if (cache.bins[i].count > 0)
+        {
+            ReleaseBlocks(cache, i, cache.bins[i].count);
+        }
+    }
+
+    mThreadCachesLock.AcquireExclusive();
+    {
+        if (cache.prev)
+        {
+            cache.prev->next = cache.next;
+        }
+        else
+        {
+            mThreadCaches = cache.next;
+        }
+
+        if (cache.next)
+        {
+            cache.next->prev = cache.prev;
+        }
+
+        mRetiredBytes += cache.bytesAllocated.load(std::memory_order_relaxed);
+        mRetiredAllocations += cache.allocationsNum.load(std::memory_order_relaxed);
+    }
+    mThreadCachesLock.ReleaseExclusive();
+
+    cache.owner = nullptr;
+    cache.released = true;
+}
+
+SmallBlockAllocator::FreeBlock* SmallBlockAllocator::CarveBlock(SharedBin& bin, uint32 sizeClass)
+{
+    const uint32 blockSize = gSizeClasses[sizeClass];
+
+    if (bin.spanPtr == bin.spanEnd)
+    {
+        if (mSpansNum.load(std::memory_order_relaxed) >= mMaxSpans)
+        {
+            return nullptr;
+        }
+
+        const uint32 spanIndex = mSpansNum++;
+        if (spanIndex >= mMaxSpans)
+        {
+            return nullptr;
+        }
+
+        uint8* span = mRegionBase + static_cast<size_t>(spanIndex) * SpanSize;
+        if (!CommitMemoryPages(span, SpanSize))
+        {
+            return nullptr;
+        }
+
+        mSpanSizeClasses[spanIndex] = static_cast<uint8>(sizeClass);
+        bin.spanPtr = span;
+        bin.spanEnd = span + (SpanSize / blockSize) * blockSize;
+    }
+
+    FreeBlock* block = reinterpret_cast<FreeBlock*>(bin.spanPtr);
+    bin.spanPtr += blockSize;
+    return block;
+}
+
+SmallBlockAllocator::FreeBlock* SmallBlockAllocator::Refill(ThreadCache& cache, uint32 sizeClass)
+{
+    SharedBin& sharedBin = mBins[sizeClass];
+    ThreadCache::Bin& bin = cache.bins[sizeClass];
+    const uint32 batchSize = GetBatchSize(sizeClass);
+
+    sharedBin.lock.AcquireExclusive();
+
+    for (uint32 i = 0; i < batchSize; ++i)
+    {
+        FreeBlock* block = sharedBin.freeList;
+        if (block)
+        {
+            sharedBin.freeList = block->next;
+        }
+        else
+        {
+            block = CarveBlock(sharedBin, sizeClass);
+            if (!block)
+            {
+                break;
+            }
+        }
+
+        block->next = bin.head;
+        bin.head = block;
+        bin.count++;
+    }
+
+    sharedBin.lock.ReleaseExclusive();
+
+    FreeBlock* block = bin.head;
+    if (block)
+    {
+        bin.head = block->next;
+        bin.count--;
+    }
+
+    return block;
+}
+
+void SmallBlockAllocator::ReleaseBlocks(ThreadCache& cache, uint32 sizeClass, uint32 count)
+{
+    ThreadCache::Bin& bin = cache.bins[sizeClass];
+    NFE_ASSERT(count > 0 && count <= bin.count, "Invalid number of blocks to release");
+
+    // detach a chain of blocks from the thread cache
+    FreeBlock* first = bin.head;
+    FreeBlock* last = first;
+    for (uint32 i = 1; i < count; ++i)
+    {
+        last = last->next;
+    }
+
+    bin.head = last->next;
+    bin.count -= count;
+
+    SharedBin& sharedBin = mBins[sizeClass];
+    sharedBin.lock.AcquireExclusive();
+    last->next = sharedBin.freeList;
+    sharedBin.freeList = first;
+    sharedBin.lock.ReleaseExclusive();
+}
+
+void* SmallBlockAllocator::MallocShared(uint32 sizeClass)
+{
+    SharedBin& sharedBin = mBins[sizeClass];
+
+    sharedBin.lock.AcquireExclusive();
+    FreeBlock* block = sharedBin.freeList;
+    if (block)
+    {
+        sharedBin.freeList = block->next;
+    }
+    else
+    {
+        block = CarveBlock(sharedBin, sizeClass);
+    }
+    sharedBin.lock.ReleaseExclusive();
+
+    if (block)
+    {
+        mRetiredBytes += gSizeClasses[sizeClass];
+        mRetiredAllocations++;
+    }
+
+    return block;
+}
+
+void SmallBlockAllocator::FreeShared(FreeBlock* block, uint32 sizeClass)
+{
+    SharedBin& sharedBin = mBins[sizeClass];
+
+    sharedBin.lock.AcquireExclusive();
+    block->next = sharedBin.freeList;
+    sharedBin.freeList = block;
+    sharedBin.lock.ReleaseExclusive();
+
+    mRetiredBytes -= gSizeClasses[sizeClass];
+    mRetiredAllocations--;
+}
+
+SmallBlockAllocatorStats SmallBlockAllocator::GetStats() const
+{
+    int64 bytesAllocated = mRetiredBytes.load();
+    int64 allocationsNum = mRetiredAllocations.load();
+
+    mThreadCachesLock.AcquireExclusive();
+    for (const ThreadCache* cache = mThreadCaches; cache; cache = cache->next)
+    {
+        bytesAllocated += cache->bytesAllocated.load(std::memory_order_relaxed);
+        allocationsNum += cache->allocationsNum.load(std::memory_order_relaxed);
+    }
+    mThreadCachesLock.ReleaseExclusive();
+
+    const uint32 spansNum = Math::Min(mSpansNum.load(), mMaxSpans) - mFirstSpan;
+
+    SmallBlockAllocatorStats stats;
+    stats.bytesAllocated = static_cast<size_t>(Math::Max<int64>(bytesAllocated, 0));
+    stats.allocationsNum = static_cast<size_t>(Math::Max<int64>(allocationsNum, 0));
+    stats.bytesReserved = static_cast<size_t>(spansNum) * SpanSize;
+    stats.spansNum = spansNum;
+    return stats;
+}
+
+
+} // namespace Common
+} // namespace NFE
@@ -0,0 +1,120 @@
+/**
+ * @file
+ * @author Witek902 (witek902@gmail.com)
+ * @brief  Small block (size-class) allocator declaration.
+ */
+
+#pragma once
+
+#include "../nfCommon.hpp"
+#include "../System/Mutex.hpp"
+
+#include <atomic>
+
+
+namespace NFE {
+namespace Common {
+
+struct SmallBlockAllocatorStats
+{
+    size_t bytesAllocated;  // sum of size class sizes of all live blocks
+    size_t allocationsNum;
+    size_t bytesReserved;   // memory committed for spans
+    uint32 spansNum;
+};
+
+/**
+ * Segregated size-class allocator used by the DefaultAllocator for small blocks.
+ *
+ * A range of address space is reserved up front and committed in spans. Each span serves blocks
+ * of a single size class, so size class of a block is found from its address (no block headers).
+ * Every thread keeps a cache of free blocks for each size class, so in a common case allocating
+ * and freeing is just a free list pop/push without any locks or atomic operations.
+ * Blocks are moved between thread caches and the shared pool in batches.
+ *
+ * @note    There can be only one instance of this class (thread caches are global).
+ */
+class SmallBlockAllocator final
+{
+    NFE_MAKE_NONCOPYABLE(SmallBlockAllocator)
+    NFE_MAKE_NONMOVEABLE(SmallBlockAllocator)
+
+public:
+    static constexpr size_t MinAlignment = 16;
+    static constexpr size_t MaxBlockSize = 4096;
+    static constexpr uint32 NumSizeClasses = 28;
+    static constexpr size_t SpanSize = 64 * 1024;
+
+    SmallBlockAllocator();
+    ~SmallBlockAllocator();
+
+    /**
+     * Reserve address space for the spans.
+     */
+    bool Init(size_t regionSize);
+
+    /**
+     * Allocate a block.
+     * @return  Pointer to the block or nullptr if the request is too big or the pool is exhausted.
+     */
+    void* Malloc(size_t size, size_t alignment);
+
+    /**
+     * Free a block owned by this allocator.
+     */
+    void Free(void* ptr);
+
+    /**
+     * Check if a block was allocated by this allocator.
+     */
+    NFE_FORCE_INLINE bool OwnsBlock(const void* ptr) const
+    {
+        return static_cast<size_t>(static_cast<const uint8*>(ptr) - mRegionBase) < mRegionSize;
+    }
+
+    SmallBlockAllocatorStats GetStats() const;
+
+private:
+    struct FreeBlock;
+    struct SharedBin;
+    struct ThreadCache;
+    struct ThreadCacheGuard;
+
+    static thread_local ThreadCache sThreadCache;
+    static thread_local ThreadCacheGuard sThreadCacheGuard;
+
+    uint8* mRegionBase;
+    size_t mRegionSize;
+    SharedBin* mBins;               // shared pool of every size class (stored in the first spans of the region)
+    uint8* mSpanSizeClasses;        // size class of every span (stored in the first spans of the region)
+    uint32 mMaxSpans;
+    uint32 mFirstSpan;
+    std::atomic<uint32> mSpansNum;
+
+    uint8 mSizeClassLookup[MaxBlockSize / MinAlignment + 1];
+
+    // registered thread caches (for statistics)
+    mutable Mutex mThreadCachesLock;
+    ThreadCache* mThreadCaches;
+
+    // statistics of exited threads and allocations made without thread cache
+    std::atomic<int64> mRetiredBytes;
+    std::atomic<int64> mRetiredAllocations;
+
+    bool InitThreadCache(ThreadCache& cache);
+    void ReleaseThreadCache(ThreadCache& cache);
+
+    // move blocks between thread cache and shared pool
+    FreeBlock* Refill(ThreadCache& cache, uint32 sizeClass);
+    void ReleaseBlocks(ThreadCache& cache, uint32 sizeClass, uint32 count);
+
+    // allocation without thread cache (during thread exit)
+    void* MallocShared(uint32 sizeClass);
+    void FreeShared(FreeBlock* block, uint32 sizeClass);
+
+    FreeBlock* CarveBlock(SharedBin& bin, uint32 sizeClass);
+};
+
+
+} // namespace Common
+} // namespace NFE
@@ -44,14 +44,17 @@ bool DynArrayType::ReserveArray(void* arrayObject, uint32 targetCapacity) const
         return true;
     }
 
-    uint32 newCapacity = accessor->mAllocSize;
-    while (targetCapacity > newCapacity)
+    // grow by at least 50%
+    const uint32 newCapacity = Math::Max<uint32>(targetCapacity, accessor->mAllocSize + accessor->mAllocSize / 2);
+
+    // try to grow the buffer without moving the objects
+    if (AllocatorTryResize(accessor->mAllocator, accessor->mElements, accessor->mAllocSize * objectSize, newCapacity * objectSize))
     {
-        // grow by 50%
-        newCapacity += Math::Max<uint32>(1, newCapacity / 2);
+        accessor->mAllocSize = newCapacity;
+        return true;
     }
 
-    char* newBuffer = (char*)NFE_MALLOC(newCapacity * objectSize, elementType->GetAlignment());
+    char* newBuffer = (char*)AllocatorMalloc(accessor->mAllocator, newCapacity * objectSize, elementType->GetAlignment());
     if (!newBuffer)
     {
         // memory allocation failed
@@ -68,7 +71,7 @@ bool DynArrayType::ReserveArray(void* arrayObject, uint32 targetCapacity) const
     }
 
     // replace buffer
-    NFE_FREE(accessor->mElements);
+    AllocatorFree(accessor->mAllocator, accessor->mElements);
     accessor->mElements = (char*)newBuffer;
     accessor->mAllocSize = newCapacity;
     return true;
@@ -62,8 +62,8 @@ public:
         typeInfo.size = sizeof(ObjectType);
         typeInfo.alignment = alignof(ObjectType);
         typeInfo.name = typeName.Str();
-        typeInfo.constructor = GetObjectConstructor<T>();
-        typeInfo.destructor = GetObjectDestructor<T>();
+        typeInfo.constructor = GetObjectConstructor<ObjectType>();
+        typeInfo.destructor = GetObjectDestructor<ObjectType>();
 
         type->Initialize(typeInfo);
     }
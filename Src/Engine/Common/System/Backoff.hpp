@@ -0,0 +1,77 @@
+/**
+ * @file
+ * @author Witek902 (witek902@gmail.com)
+ * @brief  Spin-wait helpers.
+ */
+
+#pragma once
+
+#include "../nfCommon.hpp"
+#include "Thread.hpp"
+
+
+// Hint for the CPU that the code is a spin-wait loop.
+// Reduces power usage and memory order violation penalty when leaving the loop, and gives way to SMT sibling.
+#if defined(NFE_PLATFORM_WINDOWS)
+    #define NFE_CPU_PAUSE() YieldProcessor()
+#elif defined(__x86_64__) || defined(__i386__)
+    #define NFE_CPU_PAUSE() __builtin_ia32_pause()
+#elif defined(__aarch64__) || defined(__arm__)
+    #define NFE_CPU_PAUSE() __asm__ __volatile__("yield")
+#else
+    #define NFE_CPU_PAUSE()
+#endif
+
+
+namespace NFE {
+namespace Common {
+
+/**
+ * Exponential backoff for spin-wait loops.
+ *
+ * Each Pause() call spins twice as long as the previous one (starting with a single pause instruction).
+ * After the spin budget is exhausted, the thread yields its time slice instead.
+ */
+class Backoff final
+{
+public:
+    // maximum number of pause instructions executed in a single Pause() call
+    static constexpr uint32 MaxSpinCount = 64;
+
+    NFE_FORCE_INLINE Backoff()
+        : mSpinCount(1)
+    { }
+
+    NFE_FORCE_INLINE void Pause()
+    {
+        if (mSpinCount <= MaxSpinCount)
+        {
+            for (uint32 i = 0; i < mSpinCount; ++i)
+            {
+                NFE_CPU_PAUSE();
+            }
+            mSpinCount *= 2;
+        }
+        else
+        {
+            Thread::YieldCurrentThread();
+        }
+    }
+
+    // Check if spinning stopped making sense (lock owner is probably descheduled or holds the lock for longer).
+    NFE_FORCE_INLINE bool IsSpinBudgetExhausted() const
+    {
+        return mSpinCount > MaxSpinCount;
+    }
+
+    NFE_FORCE_INLINE void Reset()
+    {
+        mSpinCount = 1;
+    }
+
+private:
+    uint32 mSpinCount;
+};
+
+} // namespace Common
+} // namespace NFE
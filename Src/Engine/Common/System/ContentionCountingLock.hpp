@@ -0,0 +1,133 @@
+/**
+ * @file
+ * @author Witek902 (witek902@gmail.com)
+ * @brief  ContentionCountingLock declaration.
+ */
+
+#pragma once
+
+#include "../nfCommon.hpp"
+#include "Timer.hpp"
+
+#include <atomic>
+
+namespace NFE {
+namespace Common {
+
+// Lock contention statistics (see ContentionCountingLock)
+struct LockContentionStats
+{
+    uint64 numAcquisitions = 0;
+    uint64 numContendedAcquisitions = 0;    // acquisitions that had to wait
+    double totalWaitTime = 0.0;             // in seconds
+
+    NFE_FORCE_INLINE double GetContentionRatio() const
+    {
+        return numAcquisitions > 0 ? static_cast<double>(numContendedAcquisitions) / static_cast<double>(numAcquisitions) : 0.0;
+    }
+};
+
+/**
+ * Lock wrapper counting contended acquisitions and time spent waiting, for profiling.
+ * Can wrap any exclusive or shared lock (SpinLock, HybridLock, RWSpinLock, Mutex, etc.).
+ *
+ * @remarks
+ * Counters are updated on every acquisition, which adds some overhead and cache traffic,
+ * so use it only to find contended locks and then switch back to the plain lock type.
+ */
+template<typename LockType>
+class ContentionCountingLock final
+{
+public:
+    ContentionCountingLock() = default;
+
+    NFE_FORCE_INLINE bool TryAcquireExclusive()
+    {
+        const bool result = mLock.TryAcquireExclusive();
+        if (result)
+        {
+            mNumAcquisitions.fetch_add(1, std::memory_order_relaxed);
+        }
+        return result;
+    }
+
+    NFE_FORCE_INLINE void AcquireExclusive()
+    {
+        mNumAcquisitions.fetch_add(1, std::memory_order_relaxed);
+
+        if (!mLock.TryAcquireExclusive())
+        {
+            Timer timer;
+            timer.Start();
+            mLock.AcquireExclusive();
+            OnContendedAcquisition(timer.Stop());
+        }
+    }
+
+    NFE_FORCE_INLINE void ReleaseExclusive()
+    {
+        mLock.ReleaseExclusive();
+    }
+
+    NFE_FORCE_INLINE bool TryAcquireShared()
+    {
+        const bool result = mLock.TryAcquireShared();
+        if (result)
+        {
+            mNumAcquisitions.fetch_add(1, std::memory_order_relaxed);
+        }
+        return result;
+    }
+
+    NFE_FORCE_INLINE void AcquireShared()
+    {
+        mNumAcquisitions.fetch_add(1, std::memory_order_relaxed);
+
+        if (!mLock.TryAcquireShared())
+        {
+            Timer timer;
+            timer.Start();
+            mLock.AcquireShared();
+            OnContendedAcquisition(timer.Stop());
+        }
+    }
+
+    NFE_FORCE_INLINE void ReleaseShared()
+    {
+        mLock.ReleaseShared();
+    }
+
+    LockContentionStats GetStats() const
+    {
+        LockContentionStats stats;
+        stats.numAcquisitions = mNumAcquisitions.load(std::memory_order_relaxed);
+        stats.numContendedAcquisitions = mNumContendedAcquisitions.load(std::memory_order_relaxed);
+        stats.totalWaitTime = 1.0e-9 * static_cast<double>(mTotalWaitTimeNs.load(std::memory_order_relaxed));
+        return stats;
+    }
+
+    void ResetStats()
+    {
+        mNumAcquisitions = 0;
+        mNumContendedAcquisitions = 0;
+        mTotalWaitTimeNs = 0;
+    }
+
+private:
+    ContentionCountingLock(const ContentionCountingLock&) = delete;
+    ContentionCountingLock& operator = (const ContentionCountingLock&) = delete;
+
+    void OnContendedAcquisition(double waitTime)
+    {
+        mNumContendedAcquisitions.fetch_add(1, std::memory_order_relaxed);
+        mTotalWaitTimeNs.fetch_add(static_cast<uint64>(waitTime * 1.0e9), std::memory_order_relaxed);
+    }
+
+    LockType mLock;
+    std::atomic<uint64> mNumAcquisitions{0};
+    std::atomic<uint64> mNumContendedAcquisitions{0};
+    std::atomic<uint64> mTotalWaitTimeNs{0};
+};
+
+} // namespace Common
+} // namespace NFE
@@ -0,0 +1,30 @@
+/**
+ * @file
+ * @author Witek902 (witek902@gmail.com)
+ * @brief  Address-based thread parking (futex) declarations.
+ */
+
+#pragma once
+
+#include "../nfCommon.hpp"
+
+#include <atomic>
+
+
+namespace NFE {
+namespace Common {
+
+static_assert(sizeof(std::atomic<uint32>) == sizeof(uint32), "Atomic must be lock-free and have the same size as the underlying type");
+
+// Block the calling thread as long as the value under the address is equal to "expectedValue".
+// NOTE: Spurious wake-ups are possible, so the caller has to check the value again.
+NFCOMMON_API void FutexWait(std::atomic<uint32>& address, uint32 expectedValue);
+
+// Wake up a single thread waiting on the address.
+NFCOMMON_API void FutexWakeOne(std::atomic<uint32>& address);
+
+// Wake up all the threads waiting on the address.
+NFCOMMON_API void FutexWakeAll(std::atomic<uint32>& address);
+
+} // namespace Common
+} // namespace NFE
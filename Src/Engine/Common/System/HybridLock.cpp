@@ -0,0 +1,55 @@
+/**
+ * @file
+ * @author Witek902 (witek902@gmail.com)
+ * @brief  HybridLock definitions.
+ */
+
+#include "PCH.hpp"
+#include "HybridLock.hpp"
+#include "Backoff.hpp"
+#include "Futex.hpp"
+
+
+namespace NFE {
+namespace Common {
+
+void HybridLock::AcquireExclusiveSlow()
+{
+    // spin phase - most critical sections are short, so the lock is likely to be released soon
+    Backoff backoff;
+    while (!backoff.IsSpinBudgetExhausted())
+    {
+        uint32 state = mState.load(std::memory_order_relaxed);
+        if (state == Unlocked)
+        {
+            if (mState.compare_exchange_weak(state, Locked, std::memory_order_acquire, std::memory_order_relaxed))
+            {
+                return;
+            }
+        }
+        else if (state == LockedWithWaiters)
+        {
+            // other threads already gave up spinning
+            break;
+        }
+
+        backoff.Pause();
+    }
+
+    // park phase
+    // Note: the lock is taken in "with waiters" state, because we can't know if there are other parked threads
+    uint32 state = mState.exchange(LockedWithWaiters, std::memory_order_acquire);
+    while (state != Unlocked)
+    {
+        FutexWait(mState, LockedWithWaiters);
+        state = mState.exchange(LockedWithWaiters, std::memory_order_acquire);
+    }
+}
+
+void HybridLock::WakeUpWaiter()
+{
+    FutexWakeOne(mState);
+}
+
+} // namespace Common
+} // namespace NFE
@@ -0,0 +1,80 @@
+/**
+ * @file
+ * @author Witek902 (witek902@gmail.com)
+ * @brief  HybridLock declaration.
+ */
+
+#pragma once
+
+#include "../nfCommon.hpp"
+
+#include <atomic>
+
+namespace NFE {
+namespace Common {
+
+/**
+ * Spin-then-park lock.
+ *
+ * Waiting thread spins with exponential backoff for a short while (like SpinLock) and then
+ * parks on the lock word (futex), so long waits don't burn CPU time. Unlike Mutex, it takes only 4 bytes,
+ * uncontended acquire/release is a single atomic operation and release does not enter the kernel
+ * when there are no parked threads.
+ */
+class NFCOMMON_API HybridLock final
+{
+public:
+    NFE_INLINE HybridLock() = default;
+
+    /**
+     * Try acquiring a lock in exclusive mode.
+     * @return  True if lock was successfully acquired.
+     */
+    NFE_FORCE_INLINE bool TryAcquireExclusive()
+    {
+        uint32 expected = Unlocked;
+        return mState.compare_exchange_strong(expected, Locked, std::memory_order_acquire, std::memory_order_relaxed);
+    }
+
+    /**
+     * Acquire a lock in exclusive mode.
+     */
+    NFE_FORCE_INLINE void AcquireExclusive()
+    {
+        uint32 expected = Unlocked;
+        if (!mState.compare_exchange_strong(expected, Locked, std::memory_order_acquire, std::memory_order_relaxed))
+        {
+            AcquireExclusiveSlow();
+        }
+    }
+
+    /**
+     * Release a lock that was acquired in exclusive mode.
+     */
+    NFE_FORCE_INLINE void ReleaseExclusive()
+    {
+        if (mState.exchange(Unlocked, std::memory_order_release) == LockedWithWaiters)
+        {
+            WakeUpWaiter();
+        }
+    }
+
+private:
+    static constexpr uint32 Unlocked = 0;
+    static constexpr uint32 Locked = 1;
+    static constexpr uint32 LockedWithWaiters = 2;    // some threads may be parked
+
+    HybridLock(const HybridLock&) = delete;
+    HybridLock(HybridLock&&) = delete;
+    HybridLock& operator = (const HybridLock&) = delete;
+    HybridLock& operator = (HybridLock&&) = delete;
+
+    void AcquireExclusiveSlow();
+    void WakeUpWaiter();
+
+    std::atomic<uint32> mState{Unlocked};
+};
+
+
+} // namespace Common
+} // namespace NFE
@@ -0,0 +1,46 @@
+/**
+ * @file
+ * @author Witek902 (witek902@gmail.com)
+ * @brief  Address-based thread parking (futex) Linux implementation.
+ */
+
+#include "PCH.hpp"
+#include "../Futex.hpp"
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <limits.h>
+
+
+namespace NFE {
+namespace Common {
+
+namespace {
+
+NFE_FORCE_INLINE long Futex(std::atomic<uint32>& address, int op, uint32 value)
+{
+    // Note: futexes are used only within the process, so private variant can be used
+    return ::syscall(SYS_futex, reinterpret_cast<uint32*>(&address), op | FUTEX_PRIVATE_FLAG, value, nullptr, nullptr, 0);
+}
+
+} // namespace
+
+void FutexWait(std::atomic<uint32>& address, uint32 expectedValue)
+{
+    // Note: returns immediately with EAGAIN if the value is different
+    Futex(address, FUTEX_WAIT, expectedValue);
+}
+
+void FutexWakeOne(std::atomic<uint32>& address)
+{
+    Futex(address, FUTEX_WAKE, 1);
+}
+
+void FutexWakeAll(std::atomic<uint32>& address)
+{
+    Futex(address, FUTEX_WAKE, INT_MAX);
+}
+
+} // namespace Common
+} // namespace NFE
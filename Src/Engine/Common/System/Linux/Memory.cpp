@@ -6,10 +6,15 @@
 
 #include "PCH.hpp"
 #include "../Memory.hpp"
+#include "../../Logger/Logger.hpp"
+#include "../Assertion.hpp"
 
 #include <sys/file.h>
 #include <sys/types.h>
+#include <sys/mman.h>
 #include <unistd.h>
+#include <sys/syscall.h>
+#include <fcntl.h>
 
 
 namespace NFE {
@@ -50,6 +55,112 @@ ret:
     return result;
 }
 
+bool BindMemoryToNumaNode(void* ptr, size_t size, uint32 numaNode)
+{
+    // constants from linux/mempolicy.h (libnuma is not required)
+    const int MPOL_PREFERRED_MODE = 1;
+    const unsigned MPOL_MF_MOVE_FLAG = 1u << 1;
+
+    unsigned long nodeMask = 0;
+    if (numaNode >= 8 * sizeof(nodeMask))
+    {
+        NFE_LOG_ERROR("Invalid NUMA node: %u", numaNode);
+        return false;
+    }
+    nodeMask = 1ul << numaNode;
+
+    const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t begin = (reinterpret_cast<size_t>(ptr) + pageSize - 1) & ~(pageSize - 1);
+    const size_t end = (reinterpret_cast<size_t>(ptr) + size) & ~(pageSize - 1);
+    if (end <= begin)
+    {
+        // no whole pages in the block
+        return true;
+    }
+
+    if (0 != syscall(SYS_mbind, begin, end - begin, MPOL_PREFERRED_MODE, &nodeMask, 8 * sizeof(nodeMask) + 1, MPOL_MF_MOVE_FLAG))
+    {
+        const int errorCode = errno;
+        NFE_LOG_WARNING("mbind failed (ptr=%p, size=%zu, node=%u), errno=%d", ptr, size, numaNode, errorCode);
+        return false;
+    }
+
+    return true;
+}
+
+void* ReserveMemoryPages(size_t size)
+{
+    void* ptr = ::mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    return ptr != MAP_FAILED ? ptr : nullptr;
+}
+
+bool CommitMemoryPages(void* ptr, size_t size)
+{
+    return 0 == ::mprotect(ptr, size, PROT_READ | PROT_WRITE);
+}
+
+void ReleaseMemoryPages(void* ptr, size_t size)
+{
+    if (ptr)
+    {
+        ::munmap(ptr, size);
+    }
+}
+
+bool EnableLargePages()
+{
+    // transparent huge pages must be enabled in "always" or "madvise" mode
+    char buffer[128] = { 0 };
+    const int fd = ::open("/sys/kernel/mm/transparent_hugepage/enabled", O_RDONLY);
+    if (fd < 0)
+    {
+        NFE_LOG_WARNING("Transparent huge pages are not supported");
+        return false;
+    }
+
+    const ssize_t bytesRead = ::read(fd, buffer, sizeof(buffer) - 1);
+    ::close(fd);
+
+    if (bytesRead <= 0 || (!strstr(buffer, "[always]") && !strstr(buffer, "[madvise]")))
+    {
+        NFE_LOG_WARNING("Transparent huge pages are disabled");
+        return false;
+    }
+
+    NFE_LOG_INFO("Large page support enabled. Large page size: %zu bytes", GetLargePageSize());
+    return true;
+}
+
+size_t GetLargePageSize()
+{
+    // transparent huge pages are always PMD-sized
+    return 2u * 1024u * 1024u;
+}
+
+void* AllocateLargePages(size_t size)
+{
+    const size_t largePageSize = GetLargePageSize();
+    NFE_ASSERT(size % largePageSize == 0, "Size must be a multiple of large page size");
+
+    // over-allocate, so the block can be aligned to huge page boundary
+    uint8* ptr = static_cast<uint8*>(::mmap(nullptr, size + largePageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    if (ptr == MAP_FAILED)
+    {
+        return nullptr;
+    }
+
+    uint8* alignedPtr = reinterpret_cast<uint8*>((reinterpret_cast<size_t>(ptr) + largePageSize - 1) & ~(largePageSize - 1));
+    if (alignedPtr > ptr)
+    {
+        ::munmap(ptr, alignedPtr - ptr);
+    }
+    ::munmap(alignedPtr + size, ptr + largePageSize - alignedPtr);
+
+    // this is only a hint, the block is usable even if it fails
+    ::madvise(alignedPtr, size, MADV_HUGEPAGE);
+
+    return alignedPtr;
+}
 
 } // namespace Common
 } // namespace NFE
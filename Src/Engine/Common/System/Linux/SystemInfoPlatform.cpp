@@ -14,6 +14,8 @@
 #include <streambuf>
 #include <fstream>
 #include <sys/utsname.h>
+#include <sched.h>
+#include <dirent.h>
 
 
 namespace NFE {
@@ -50,8 +52,87 @@ bool ReadFileToString(const String& path, String& outString)
     return true;
 }
 
+uint32 ReadSysfsValue(const char* path, uint32 defaultValue)
+{
+    FILE* file = fopen(path, "r");
+    if (!file)
+    {
+        return defaultValue;
+    }
+
+    unsigned int value = defaultValue;
+    if (fscanf(file, "%u", &value) != 1)
+    {
+        value = defaultValue;
+    }
+
+    fclose(file);
+    return value;
+}
+
+// CPU's sysfs directory contains "nodeX" link pointing to its NUMA node
+uint32 FindNumaNode(uint32 cpu)
+{
+    char path[128];
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u", cpu);
+
+    DIR* dir = opendir(path);
+    if (!dir)
+    {
+        return 0;
+    }
+
+    uint32 node = 0;
+    while (const dirent* entry = readdir(dir))
+    {
+        unsigned int value;
+        if (sscanf(entry->d_name, "node%u", &value) == 1)
+        {
+            node = value;
+            break;
+        }
+    }
+
+    closedir(dir);
+    return node;
+}
+
 } // namespace
 
+void SystemInfo::InitTopologyPlatform()
+{
+    // take only processors the process is allowed to run on
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    if (0 != sched_getaffinity(0, sizeof(cpuSet), &cpuSet))
+    {
+        NFE_LOG_WARNING("Failed to get process affinity mask, errno=%d", errno);
+        return;
+    }
+
+    for (uint32 cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+    {
+        if (!CPU_ISSET(cpu, &cpuSet))
+        {
+            continue;
+        }
+
+        char path[128];
+        LogicalCoreInfo info;
+        info.id = cpu;
+
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/topology/core_id", cpu);
+        info.coreId = ReadSysfsValue(path, cpu);
+
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/topology/physical_package_id", cpu);
+        info.packageId = ReadSysfsValue(path, 0);
+
+        info.numaNode = FindNumaNode(cpu);
+
+        mLogicalCores.PushBack(info);
+    }
+}
+
 void SystemInfo::InitCPUInfoPlatform()
 {
     //get CPU information
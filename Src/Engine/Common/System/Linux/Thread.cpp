@@ -164,6 +164,33 @@ bool Thread::SetName(const char* name)
     return true;
 }
 
+bool Thread::SetAffinity(uint32 logicalCoreId)
+{
+    if (!mThreadData || !mThreadData->callback)
+    {
+        return false;
+    }
+
+    if (logicalCoreId >= CPU_SETSIZE)
+    {
+        NFE_LOG_ERROR("Invalid logical core ID: %u", logicalCoreId);
+        return false;
+    }
+
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(logicalCoreId, &cpuSet);
+
+    auto retVal = pthread_setaffinity_np(mThreadData->id, sizeof(cpuSet), &cpuSet);
+    if (retVal != 0)
+    {
+        NFE_LOG_ERROR("Error while setting threads affinity to core %u: %s", logicalCoreId, strerror(retVal));
+        return false;
+    }
+
+    return true;
+}
+
 bool Thread::SetCurrentThreadName(const char* name)
 {
     auto retVal = pthread_setname_np(pthread_self(), name);
@@ -29,5 +29,53 @@ bool MemoryCheck(const T* ptr)
 {
     return MemoryCheck(ptr, sizeof(T));
 }
+
+/**
+ * Move memory pages to a given NUMA node (so accessing them from the node's processors is faster).
+ * Only pages fully contained in the block are moved.
+ * @param ptr      Pointer to the beginning of a block
+ * @param size     Block size
+ * @param numaNode NUMA node index (see LogicalCoreInfo::numaNode)
+ * @return True on success. Not supported on Windows.
+ */
+NFCOMMON_API bool BindMemoryToNumaNode(void* ptr, size_t size, uint32 numaNode);
+
+/**
+ * Reserve a range of virtual address space without backing it with physical memory.
+ * @note Page management functions below do not log errors, as they are used by the memory allocator.
+ * @param size Size of the range. Must be a multiple of the page size.
+ * @return Pointer to the beginning of the range or nullptr on failure.
+ */
+NFCOMMON_API void* ReserveMemoryPages(size_t size);
+
+/**
+ * Make pages in a range previously reserved with ReserveMemoryPages() accessible (read/write).
+ */
+NFCOMMON_API bool CommitMemoryPages(void* ptr, size_t size);
+
+/**
+ * Release a range of pages allocated with ReserveMemoryPages() or AllocateLargePages().
+ */
+NFCOMMON_API void ReleaseMemoryPages(void* ptr, size_t size);
+
+/**
+ * Try to enable large (huge) pages support for the process.
+ * On Windows it requires "Lock pages in memory" privilege, on Linux transparent huge pages are used.
+ * @return True if large pages are available.
+ */
+NFCOMMON_API bool EnableLargePages();
+
+/**
+ * Get minimum size of a large (huge) page.
+ */
+NFCOMMON_API size_t GetLargePageSize();
+
+/**
+ * Allocate read/write memory backed with large pages.
+ * @param size Size of the block. Must be a multiple of GetLargePageSize().
+ * @return Pointer to a block aligned to the large page size or nullptr if large pages are unavailable.
+ */
+NFCOMMON_API void* AllocateLargePages(size_t size);
+
 } // namespace Common
 } // namespace NFE
@@ -16,6 +16,9 @@ namespace Common {
  * Reader/writer spin lock.
  * There can be multiple shared locks or only one exclusive lock acquired at the same time.
  *
+ * The lock is writer-preferring: a waiting writer blocks new readers from entering, so a steady stream
+ * of readers can't starve it. Waiting threads use exponential backoff (see Backoff class).
+ *
  * @remarks
  * RWSpinLock should be used ONLY when locking occurs very rarely and for very short period of time.
  * Otherwise, use RWLock.
@@ -58,15 +61,17 @@ public:
     NFE_INLINE void ReleaseShared();
 
 private:
-    static constexpr int32 UnlockValue = 0;
-    static constexpr int32 WriteLockValue = -1;
+    static constexpr uint32 UnlockValue = 0;
+    static constexpr uint32 WriterBit = 1u << 31;           // locked in exclusive mode
+    static constexpr uint32 WriterPendingBit = 1u << 30;    // a writer is waiting (new readers must wait)
+    static constexpr uint32 ReadersMask = WriterPendingBit - 1; // number of shared locks
 
     RWSpinLock(const RWSpinLock&) = delete;
     RWSpinLock(RWSpinLock&&) = delete;
     RWSpinLock& operator = (const RWSpinLock&) = delete;
     RWSpinLock& operator = (RWSpinLock&&) = delete;
 
-    std::atomic<int32> mValue{UnlockValue};
+    std::atomic<uint32> mValue{UnlockValue};
 };
 
 
@@ -6,7 +6,7 @@
 #pragma once
 
 #include "RWSpinLock.hpp"
-#include "Thread.hpp"
+#include "Backoff.hpp"
 #include "Assertion.hpp"
 
 namespace NFE {
@@ -15,15 +15,10 @@ namespace Common {
 
 bool RWSpinLock::TryAcquireShared()
 {
-    int32 expected = mValue.load(std::memory_order_relaxed);
-    if (expected != WriteLockValue)
+    uint32 expected = mValue.load(std::memory_order_relaxed);
+    if ((expected & (WriterBit | WriterPendingBit)) == 0)
     {
-        int32 desired = 1 + expected;
-        if (atomic_compare_exchange_weak_explicit(&mValue, &expected, desired, std::memory_order_relaxed, std::memory_order_relaxed))
-        {
-            atomic_thread_fence(std::memory_order_acquire);
-            return true;
-        }
+        return mValue.compare_exchange_strong(expected, expected + 1, std::memory_order_acquire, std::memory_order_relaxed);
     }
 
     return false;
@@ -31,67 +26,65 @@ bool RWSpinLock::TryAcquireShared()
 
 void RWSpinLock::AcquireShared()
 {
+    Backoff backoff;
     for (;;)
     {
-        int32 expected = mValue.load(std::memory_order_relaxed);
-        if (expected != WriteLockValue)
+        uint32 expected = mValue.load(std::memory_order_relaxed);
+        if ((expected & (WriterBit | WriterPendingBit)) == 0)
         {
-            int32 desired = 1 + expected;
-            if (atomic_compare_exchange_weak_explicit(&mValue, &expected, desired, std::memory_order_relaxed, std::memory_order_relaxed))
+            if (mValue.compare_exchange_weak(expected, expected + 1, std::memory_order_acquire, std::memory_order_relaxed))
             {
-                break;
+                return;
             }
         }
 
-        Thread::YieldCurrentThread();
+        backoff.Pause();
     }
-
-    atomic_thread_fence(std::memory_order_acquire);
 }
 
 void RWSpinLock::ReleaseShared()
 {
-    atomic_thread_fence(std::memory_order_release);
-
-    const uint32 prevValue = mValue--;
-    NFE_ASSERT(prevValue > 0, "Invalid lock usage");
+    const uint32 prevValue = mValue.fetch_sub(1, std::memory_order_release);
+    NFE_ASSERT((prevValue & ReadersMask) > 0, "Invalid lock usage");
+    NFE_UNUSED(prevValue);
 }
 
 bool RWSpinLock::TryAcquireExclusive()
 {
-    int32 expected = UnlockValue;
-    int32 desired = WriteLockValue;
-    if (atomic_compare_exchange_weak_explicit(&mValue, &expected, desired, std::memory_order_relaxed, std::memory_order_relaxed))
-    {
-        atomic_thread_fence(std::memory_order_acquire);
-        return true;
-    }
-
-    return false;
+    uint32 expected = UnlockValue;
+    return mValue.compare_exchange_strong(expected, WriterBit, std::memory_order_acquire, std::memory_order_relaxed);
 }
 
 void RWSpinLock::AcquireExclusive()
 {
+    Backoff backoff;
     for (;;)
     {
-        int32 expected = UnlockValue;
-        int32 desired = WriteLockValue;
-        if (atomic_compare_exchange_weak_explicit(&mValue, &expected, desired, std::memory_order_relaxed, std::memory_order_relaxed))
+        uint32 expected = mValue.load(std::memory_order_relaxed);
+        if ((expected & ~WriterPendingBit) == 0)
+        {
+            // no readers nor writer - take the lock (clears the pending flag, other waiting writers will set it again)
+            if (mValue.compare_exchange_weak(expected, WriterBit, std::memory_order_acquire, std::memory_order_relaxed))
+            {
+                return;
+            }
+        }
+        else if ((expected & WriterPendingBit) == 0)
         {
-            break;
+            // stop new readers from entering
+            mValue.fetch_or(WriterPendingBit, std::memory_order_relaxed);
         }
 
-        Thread::YieldCurrentThread();
+        backoff.Pause();
     }
-
-    atomic_thread_fence(std::memory_order_acquire);
 }
 
 void RWSpinLock::ReleaseExclusive()
 {
-    atomic_thread_fence(std::memory_order_release);
+    NFE_ASSERT(mValue.load(std::memory_order_relaxed) & WriterBit, "Invalid lock usage");
 
-    mValue = UnlockValue;
+    // Note: other writers could have set the pending flag in the meantime
+    mValue.fetch_and(~WriterBit, std::memory_order_release);
 }
 
 } // namespace Common
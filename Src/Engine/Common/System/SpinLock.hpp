@@ -15,9 +15,12 @@ namespace Common {
 /**
  * SpinLock
  *
+ * Test-and-test-and-set lock with exponential backoff (see Backoff class). Waiting threads spin on a read
+ * (without invalidating the cache line) and yield after the spin budget is exhausted, but they never sleep.
+ *
  * @remarks
  * SpinLock should be used ONLY when locking occurs very rarely and for very short period of time.
- * Otherwise, use Mutex.
+ * Otherwise, use HybridLock or Mutex.
  */
 class SpinLock final
 {
@@ -47,7 +50,7 @@ private:
     SpinLock& operator = (const SpinLock&) = delete;
     SpinLock& operator = (SpinLock&&) = delete;
 
-    std::atomic_flag mLocked = ATOMIC_FLAG_INIT;
+    std::atomic<bool> mLocked{false};
 };
 
 
@@ -6,24 +6,43 @@
 #pragma once
 
 #include "SpinLock.hpp"
+#include "Backoff.hpp"
 
 namespace NFE {
 namespace Common {
 
 bool SpinLock::TryAcquireExclusive()
 {
-    return !mLocked.test_and_set(std::memory_order_acquire);
+    // check first, so failed attempts don't take the cache line ownership
+    return !mLocked.load(std::memory_order_relaxed) && !mLocked.exchange(true, std::memory_order_acquire);
 }
 
 void SpinLock::AcquireExclusive()
 {
-    while (mLocked.test_and_set(std::memory_order_acquire))
-    { }
+    if (!mLocked.exchange(true, std::memory_order_acquire))
+    {
+        return;
+    }
+
+    Backoff backoff;
+    for (;;)
+    {
+        // wait until the lock looks free (spinning on a read does not generate cache coherency traffic)
+        while (mLocked.load(std::memory_order_relaxed))
+        {
+            backoff.Pause();
+        }
+
+        if (!mLocked.exchange(true, std::memory_order_acquire))
+        {
+            return;
+        }
+    }
 }
 
 void SpinLock::ReleaseExclusive()
 {
-    mLocked.clear(std::memory_order_release);
+    mLocked.store(false, std::memory_order_release);
 }
 
 } // namespace Common
@@ -8,15 +8,20 @@
 #include "SystemInfo.hpp"
 #include "SystemInfoConstants.hpp"
 #include "../Utils/StringUtils.hpp"
+#include "../Math/Math.hpp"
+
+#include <algorithm>
 
 
 namespace NFE {
 namespace Common {
 
 SystemInfo::SystemInfo()
+    : mNumNumaNodes(1)
 {
     InitCPUInfoCommon();
     InitCPUInfoPlatform();
+    InitTopology();
     InitOSVersion();
     InitCompilerInfo();
     InitMemoryInfo();
@@ -162,6 +167,52 @@ void SystemInfo::InitMap()
     mCpuidFeatureMap.Insert("EM64T", CpuidFeature(4, 1<<29)); // Support for 64bit OS
 }
 
+void SystemInfo::InitTopology()
+{
+    InitTopologyPlatform();
+
+    if (mLogicalCores.Empty())
+    {
+        // topology is unknown - assume a single node with no SMT
+        for (uint32 i = 0; i < static_cast<uint32>(mCPUCoreNo); ++i)
+        {
+            LogicalCoreInfo info;
+            info.id = i;
+            info.coreId = i;
+            mLogicalCores.PushBack(info);
+        }
+    }
+
+    // compute index of each hardware thread within its physical core
+    for (uint32 i = 0; i < mLogicalCores.Size(); ++i)
+    {
+        LogicalCoreInfo& info = mLogicalCores[i];
+        info.smtIndex = 0;
+        for (uint32 j = 0; j < i; ++j)
+        {
+            if (mLogicalCores[j].packageId == info.packageId && mLogicalCores[j].coreId == info.coreId)
+            {
+                info.smtIndex++;
+            }
+        }
+    }
+
+    std::sort(mLogicalCores.Begin(), mLogicalCores.End(), [] (const LogicalCoreInfo& a, const LogicalCoreInfo& b)
+    {
+        if (a.numaNode != b.numaNode) return a.numaNode < b.numaNode;
+        if (a.smtIndex != b.smtIndex) return a.smtIndex < b.smtIndex;
+        if (a.packageId != b.packageId) return a.packageId < b.packageId;
+        if (a.coreId != b.coreId) return a.coreId < b.coreId;
+        return a.id < b.id;
+    });
+
+    mNumNumaNodes = 1;
+    for (const LogicalCoreInfo& info : mLogicalCores)
+    {
+        mNumNumaNodes = Math::Max(mNumNumaNodes, info.numaNode + 1);
+    }
+}
+
 String SystemInfo::ConstructAllInfoString()
 {
     // Building output string
@@ -175,6 +226,8 @@ String SystemInfo::ConstructAllInfoString()
     outputStr += "CPU cores no.:   " + ToString(mCPUCoreNo) + '\n';
     outputStr += "Page size:       " + ToString(mPageSize) + " bytes\n";
     outputStr += "Cache line size: " + ToString(mCacheLineSize) + "bytes\n";
+    outputStr += "Logical cores:   " + ToString(mLogicalCores.Size()) + '\n';
+    outputStr += "NUMA nodes:      " + ToString(mNumNumaNodes) + '\n';
 
     outputStr += "\n..::MEMORY::..\n";
     outputStr += "Free (total):         " + ToString(GetFreeMemoryKb()) + " kB\n";
@@ -254,5 +307,15 @@ uint64 SystemInfo::GetMemTotalSwapKb() const
     return mMemTotalSwapKb;
 }
 
+const DynArray<LogicalCoreInfo>& SystemInfo::GetLogicalCores() const
+{
+    return mLogicalCores;
+}
+
+uint32 SystemInfo::GetNumNumaNodes() const
+{
+    return mNumNumaNodes;
+}
+
 } // namespace Common
 } // namespace NFE
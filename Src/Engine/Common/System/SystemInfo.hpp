@@ -8,6 +8,7 @@
 
 #include "../nfCommon.hpp"
 #include "../Containers/HashMap.hpp"
+#include "../Containers/DynArray.hpp"
 #include "../Containers/String.hpp"
 #include "../Containers/StringView.hpp"
 
@@ -32,6 +33,18 @@ struct CpuidFeature
     CpuidFeature(int x, int y) : AddressNo(x), FeatureNo(y) {}
 };
 
+/**
+ * Logical processor (hardware thread) description
+ */
+struct LogicalCoreInfo
+{
+    uint32 id = 0;          // OS logical processor index (used for setting threads affinity)
+    uint32 coreId = 0;      // physical core index within the package
+    uint32 packageId = 0;   // physical package (socket) index
+    uint32 numaNode = 0;    // NUMA node index
+    uint32 smtIndex = 0;    // index of the hardware thread within its physical core
+};
+
 /**
  * Class used to gather information about hardware
  */
@@ -54,6 +67,8 @@ private:
     uint64 mMemTotalVirtKb;
     uint64 mMemFreeVirtKb;
     uint64 mCpuidFeatures[5];
+    DynArray<LogicalCoreInfo> mLogicalCores;
+    uint32 mNumNumaNodes;
 
     void Cpuid(int cpuInfo[4], int function_id);
     uint64 Rdtsc();
@@ -64,6 +79,8 @@ private:
     void InitMap();
     void InitCPUInfoPlatform();
     void InitMemoryInfo();
+    void InitTopology();
+    void InitTopologyPlatform();
 
     bool CheckFeature(CpuidFeature feature) const;
 
@@ -118,6 +135,13 @@ public:
     uint64 GetMemTotalPhysKb() const;
     uint64 GetMemTotalVirtKb() const;
     uint64 GetMemTotalSwapKb() const;
+
+    /**
+     * Get logical processors available to the process.
+     * The list is sorted by NUMA node and then by SMT index, so the first entries of each node are distinct physical cores.
+     */
+    const DynArray<LogicalCoreInfo>& GetLogicalCores() const;
+    uint32 GetNumNumaNodes() const;
 };
 
 /**
@@ -81,6 +81,9 @@ public:
     // Name can be MAX_THREAD_NAME_LENGTH characters long at max (including '\0')
     bool SetName(const char* name);
 
+    // Pin the thread to a single logical processor (see LogicalCoreInfo::id)
+    bool SetAffinity(uint32 logicalCoreId);
+
     // Get thread's ID
     uint32 GetID() const;
 
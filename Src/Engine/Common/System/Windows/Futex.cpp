@@ -0,0 +1,34 @@
+/**
+ * @file
+ * @author Witek902 (witek902@gmail.com)
+ * @brief  Address-based thread parking (futex) Windows implementation.
+ */
+
+#include "PCH.hpp"
+#include "../Futex.hpp"
+
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+
+
+namespace NFE {
+namespace Common {
+
+void FutexWait(std::atomic<uint32>& address, uint32 expectedValue)
+{
+    ::WaitOnAddress(&address, &expectedValue, sizeof(uint32), INFINITE);
+}
+
+void FutexWakeOne(std::atomic<uint32>& address)
+{
+    ::WakeByAddressSingle(&address);
+}
+
+void FutexWakeAll(std::atomic<uint32>& address)
+{
+    ::WakeByAddressAll(&address);
+}
+
+} // namespace Common
+} // namespace NFE
@@ -8,6 +8,7 @@
 #include "PCH.hpp"
 #include "../Memory.hpp"
 #include "../../Logger/Logger.hpp"
+#include "../Assertion.hpp"
 
 #define WIN32_LEAN_AND_MEAN
 #define NOMINMAX
@@ -35,6 +36,92 @@ bool MemoryCheck(const void* ptr, size_t size)
            info.Protect == PAGE_READONLY || info.Protect == PAGE_READWRITE;
 }
 
+bool BindMemoryToNumaNode(void* ptr, size_t size, uint32 numaNode)
+{
+    // Windows does not provide a way to migrate already committed pages
+    NFE_UNUSED(ptr);
+    NFE_UNUSED(size);
+    NFE_UNUSED(numaNode);
+    return false;
+}
+
+void* ReserveMemoryPages(size_t size)
+{
+    return ::VirtualAlloc(NULL, size, MEM_RESERVE, PAGE_NOACCESS);
+}
+
+bool CommitMemoryPages(void* ptr, size_t size)
+{
+    return NULL != ::VirtualAlloc(ptr, size, MEM_COMMIT, PAGE_READWRITE);
+}
+
+void ReleaseMemoryPages(void* ptr, size_t size)
+{
+    NFE_UNUSED(size);
+
+    if (ptr)
+    {
+        ::VirtualFree(ptr, 0, MEM_RELEASE);
+    }
+}
+
+static bool TogglePrivilege(const TCHAR* privilegeName, bool enable)
+{
+    HANDLE token;
+    if (!::OpenProcessToken(::GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token))
+    {
+        NFE_LOG_ERROR("OpenProcessToken failed, error code: %u", ::GetLastError());
+        return false;
+    }
+
+    TOKEN_PRIVILEGES tp;
+    if (!::LookupPrivilegeValue(NULL, privilegeName, &tp.Privileges[0].Luid))
+    {
+        NFE_LOG_ERROR("LookupPrivilegeValue failed, error code: %u", ::GetLastError());
+        ::CloseHandle(token);
+        return false;
+    }
+
+    tp.PrivilegeCount = 1;
+    tp.Privileges[0].Attributes = enable ? SE_PRIVILEGE_ENABLED : 0;
+
+    // It is possible for AdjustTokenPrivileges to return TRUE and still not succeed.
+    // So always check for the last error value.
+    const BOOL status = ::AdjustTokenPrivileges(token, FALSE, &tp, 0, NULL, 0);
+    const DWORD errorCode = ::GetLastError();
+    ::CloseHandle(token);
+
+    if (!status || errorCode != ERROR_SUCCESS)
+    {
+        NFE_LOG_WARNING("AdjustTokenPrivileges failed, error code: %u", errorCode);
+        return false;
+    }
+
+    return true;
+}
+
+bool EnableLargePages()
+{
+    if (::GetLargePageMinimum() == 0 || !TogglePrivilege(SE_LOCK_MEMORY_NAME, true))
+    {
+        NFE_LOG_WARNING("Failed to enable large page support");
+        return false;
+    }
+
+    NFE_LOG_INFO("Large page support enabled. Minimum large page size: %zu bytes", GetLargePageSize());
+    return true;
+}
+
+size_t GetLargePageSize()
+{
+    return ::GetLargePageMinimum();
+}
+
+void* AllocateLargePages(size_t size)
+{
+    NFE_ASSERT(size % GetLargePageSize() == 0, "Size must be a multiple of large page size");
+    return ::VirtualAlloc(NULL, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+}
 
 } // namespace Common
 } // namespace NFE
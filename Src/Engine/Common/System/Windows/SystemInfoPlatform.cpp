@@ -9,6 +9,7 @@
 #include "../Library.hpp"
 #include "Common.hpp"
 #include "../../Utils/StringUtils.hpp"
+#include "../../Logger/Logger.hpp"
 
 #include <intrin.h>
 
@@ -73,6 +74,75 @@ void SystemInfo::InitCPUInfoPlatform()
     mPageSize = sysInfo.dwPageSize;
 }
 
+void SystemInfo::InitTopologyPlatform()
+{
+    DWORD length = 0;
+    ::GetLogicalProcessorInformation(nullptr, &length);
+    if (length == 0)
+    {
+        NFE_LOG_WARNING("Failed to get logical processors information size, error code: %u", ::GetLastError());
+        return;
+    }
+
+    DynArray<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> buffer;
+    buffer.Resize(length / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+    if (!::GetLogicalProcessorInformation(buffer.Data(), &length))
+    {
+        NFE_LOG_WARNING("Failed to get logical processors information, error code: %u", ::GetLastError());
+        return;
+    }
+
+    // Note: only the current processor group is reported (up to 64 logical processors)
+    const uint32 maxLogicalCores = 8 * sizeof(ULONG_PTR);
+    LogicalCoreInfo cores[maxLogicalCores];
+    bool present[maxLogicalCores] = { false };
+
+    uint32 coreIndex = 0;
+    uint32 packageIndex = 0;
+    for (const SYSTEM_LOGICAL_PROCESSOR_INFORMATION& info : buffer)
+    {
+        for (uint32 i = 0; i < maxLogicalCores; ++i)
+        {
+            if ((info.ProcessorMask & (static_cast<ULONG_PTR>(1) << i)) == 0)
+            {
+                continue;
+            }
+
+            switch (info.Relationship)
+            {
+            case RelationProcessorCore:
+                present[i] = true;
+                cores[i].coreId = coreIndex;
+                break;
+            case RelationProcessorPackage:
+                cores[i].packageId = packageIndex;
+                break;
+            case RelationNumaNode:
+                cores[i].numaNode = info.NumaNode.NodeNumber;
+                break;
+            }
+        }
+
+        if (info.Relationship == RelationProcessorCore)
+        {
+            coreIndex++;
+        }
+        else if (info.Relationship == RelationProcessorPackage)
+        {
+            packageIndex++;
+        }
+    }
+
+    for (uint32 i = 0; i < maxLogicalCores; ++i)
+    {
+        if (present[i])
+        {
+            cores[i].id = i;
+            mLogicalCores.PushBack(cores[i]);
+        }
+    }
+}
+
 void SystemInfo::InitOSVersion()
 {
     OSVERSIONINFOEX os;
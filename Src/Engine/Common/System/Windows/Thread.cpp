@@ -193,6 +193,29 @@ bool Thread::SetName(const char* name)
     return true;
 }
 
+bool Thread::SetAffinity(uint32 logicalCoreId)
+{
+    if (!mThreadData || mThreadData->handle == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    if (logicalCoreId >= 8 * sizeof(DWORD_PTR))
+    {
+        NFE_LOG_ERROR("Invalid logical core ID: %u", logicalCoreId);
+        return false;
+    }
+
+    if (0 != ::SetThreadAffinityMask(mThreadData->handle, static_cast<DWORD_PTR>(1) << logicalCoreId))
+    {
+        return true;
+    }
+
+    const DWORD errorCode = ::GetLastError();
+    NFE_LOG_ERROR("Failed to change thread %0X affinity. Error code: %u", mThreadData->id, errorCode);
+    return false;
+}
+
 bool Thread::SetCurrentThreadName(const char* name)
 {
     ::ThreadNameInfo info;
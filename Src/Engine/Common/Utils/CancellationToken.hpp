@@ -0,0 +1,57 @@
+/**
+ * @file
+ * @author Witek902 (witek902@gmail.com)
+ * @brief  CancellationToken class declaration.
+ */
+
+#pragma once
+
+#include "../nfCommon.hpp"
+
+#include <atomic>
+
+
+namespace NFE {
+namespace Common {
+
+/**
+ * @class CancellationToken
+ * Flag used to request early termination of ongoing work (eg. tasks pushed via TaskBuilder).
+ *
+ * The work is not interrupted - tasks are expected to poll IsCancelled() at reasonable granularity
+ * and return early. Cancelled tasks still finish normally, so waiting for them works as usual.
+ */
+class CancellationToken final
+{
+    NFE_MAKE_NONCOPYABLE(CancellationToken)
+    NFE_MAKE_NONMOVEABLE(CancellationToken)
+
+public:
+    CancellationToken()
+        : mCancelled(false)
+    { }
+
+    // request cancellation (can be called from any thread)
+    NFE_FORCE_INLINE void Cancel()
+    {
+        mCancelled.store(true, std::memory_order_relaxed);
+    }
+
+    // clear cancellation request, so the token can be reused
+    // NOTE: must not be called while the work using the token is in progress
+    NFE_FORCE_INLINE void Reset()
+    {
+        mCancelled.store(false, std::memory_order_relaxed);
+    }
+
+    NFE_FORCE_INLINE bool IsCancelled() const
+    {
+        return mCancelled.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<bool> mCancelled;
+};
+
+} // namespace Common
+} // namespace NFE
@@ -1,11 +1,64 @@
 #include "PCH.hpp"
 #include "TaskBuilder.hpp"
 #include "ThreadPool.hpp"
+#include "CancellationToken.hpp"
+#include "ScopedLock.hpp"
+#include "../System/SpinLock.hpp"
+#include "../Math/Math.hpp"
 
 
 namespace NFE {
 namespace Common {
 
+namespace {
+
+// pool of parallel-for states (released states are reused, never freed until shutdown)
+class ParallelForStatePool
+{
+public:
+    ~ParallelForStatePool()
+    {
+        while (mFirstFree)
+        {
+            ParallelForState* state = mFirstFree;
+            mFirstFree = state->nextFree;
+            state->~ParallelForState();
+            NFE_FREE(state);
+        }
+    }
+
+    ParallelForState* Acquire()
+    {
+        {
+            NFE_SCOPED_LOCK(mLock);
+            if (ParallelForState* state = mFirstFree)
+            {
+                mFirstFree = state->nextFree;
+                return state;
+            }
+        }
+
+        void* memory = NFE_MALLOC(sizeof(ParallelForState), alignof(ParallelForState));
+        NFE_ASSERT(memory, "Failed to allocate parallel-for state");
+        return new (memory) ParallelForState;
+    }
+
+    void Release(ParallelForState* state)
+    {
+        NFE_SCOPED_LOCK(mLock);
+        state->nextFree = mFirstFree;
+        mFirstFree = state;
+    }
+
+private:
+    SpinLock mLock;
+    ParallelForState* mFirstFree = nullptr;
+};
+
+static ParallelForStatePool gParallelForStatePool;
+
+} // namespace
+
 TaskBuilder::TaskBuilder(const TaskID parentTask)
     : mParentTask(parentTask)
 {
@@ -76,21 +129,61 @@ void TaskBuilder::Fence(Waitable* waitable)
     mDependencyTask = dependency;
 }
 
-void TaskBuilder::Task(const char* debugName, const TaskFunction& func)
+bool TaskBuilder::IsPendingTask(TaskID taskID) const
+{
+    if (taskID == InvalidTaskID)
+    {
+        return true;
+    }
+
+    for (const TaskID pendingTask : mPendingTasks)
+    {
+        if (pendingTask == taskID)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+TaskID TaskBuilder::Task(const char* debugName, const TaskFunction& func, const ArrayView<const TaskID> dependencies)
 {
     ThreadPool& tp = ThreadPool::GetInstance();
 
+    for (const TaskID dependency : dependencies)
+    {
+        NFE_ASSERT(IsPendingTask(dependency), "Dependency must be a task pushed to this builder after the last fence");
+        NFE_UNUSED(dependency);
+    }
+
     TaskDesc desc;
-    desc.function = func;
     desc.debugName = debugName;
     desc.parent = mParentTask;
     desc.dependency = mDependencyTask;
+    desc.dependencies = dependencies;
+
+    if (const CancellationToken* token = mCancellationToken)
+    {
+        desc.function = [token, func] (const TaskContext& context)
+        {
+            if (!token->IsCancelled())
+            {
+                func(context);
+            }
+        };
+    }
+    else
+    {
+        desc.function = func;
+    }
 
     TaskID taskID = tp.CreateTask(desc);
     mPendingTasks.PushBack(taskID);
+    return taskID;
 }
 
-void TaskBuilder::CustomTask(TaskID customTask)
+TaskID TaskBuilder::CustomTask(TaskID customTask)
 {
     ThreadPool& tp = ThreadPool::GetInstance();
 
@@ -101,90 +194,174 @@ void TaskBuilder::CustomTask(TaskID customTask)
 
     TaskID taskID = tp.CreateTask(desc);
     mPendingTasks.PushBack(taskID);
+    return taskID;
 }
 
-void TaskBuilder::ParallelFor(const char* debugName, uint32 arraySize, const ParallelForTaskFunction& func)
+ParallelForState* TaskBuilder::AcquireParallelForState(size_t callableSize, size_t callableAlignment)
 {
-    ThreadPool& tp = ThreadPool::GetInstance();
+    ParallelForState* state = gParallelForStatePool.Acquire();
 
-    if (arraySize == 0)
+    if (callableSize <= ParallelForState::InlineCallableSize && callableAlignment <= alignof(decltype(state->inlineStorage)))
     {
-        return;
+        state->callable = state->inlineStorage;
+    }
+    else
+    {
+        state->callable = NFE_MALLOC(callableSize, callableAlignment);
+        NFE_ASSERT(state->callable, "Failed to allocate parallel-for callable");
     }
 
-    TaskDesc desc;
-    desc.debugName = debugName;
-    desc.parent = mParentTask;
-    desc.dependency = mDependencyTask;
-
-    TaskID parallelForTask = tp.CreateTask(desc);
-    mPendingTasks.PushBack(parallelForTask);
+    return state;
+}
 
-    uint32 numTasksToSpawn = Math::Min(arraySize, tp.GetNumThreads());
+void TaskBuilder::ReleaseParallelForState(ParallelForState* state)
+{
+    state->destroy(state->callable);
 
-    struct NFE_ALIGN(64) ThreadData
+    if (state->callable != state->inlineStorage)
     {
-        uint32 elementOffset = 0; // base element
-        uint32 numElements = 0;
-        std::atomic<int32> counter = 0;
-        uint32 threadDataIndex = 0;
+        NFE_FREE(state->callable);
+    }
+    state->callable = nullptr;
 
-        ThreadData() = default;
-        ThreadData(const ThreadData& other)
-            : elementOffset(other.elementOffset)
-            , numElements(other.numElements)
-            , counter(other.counter.load())
-            , threadDataIndex(other.threadDataIndex)
-        {}
-    };
+    gParallelForStatePool.Release(state);
+}
 
-    // TODO get rid of dynamic allocation, e.g. by using some kind of pool
-    using Counter = std::atomic<uint32>;
-    using ThreadDataPtr = SharedPtr<DynArray<ThreadData>>;
-    ThreadDataPtr threadDataPtr = MakeSharedPtr<DynArray<ThreadData>>();
-    threadDataPtr->Resize(tp.GetNumThreads());
+void TaskBuilder::ExecuteParallelFor(ParallelForState* state, const TaskContext& context, uint32 taskIndex)
+{
+    const uint32 arraySize = state->arraySize;
+    const uint32 grainSize = state->grainSize;
+    const CancellationToken* token = state->cancellationToken;
 
-    // subdivide work
+    switch (state->schedule)
     {
-        uint32 totalElements = 0;
-        for (uint32 i = 0; i < numTasksToSpawn; ++i)
+        case ParallelForSchedule::Static:
         {
-            ThreadData& threadData = (*threadDataPtr)[i];
-            threadData.numElements = (arraySize / numTasksToSpawn) + ((arraySize % numTasksToSpawn > i) ? 1 : 0);
-            threadData.elementOffset = totalElements;
-            totalElements += threadData.numElements;
+            const uint32 begin = static_cast<uint32>(static_cast<uint64>(arraySize) * taskIndex / state->numTasks);
+            const uint32 end = static_cast<uint32>(static_cast<uint64>(arraySize) * (taskIndex + 1) / state->numTasks);
+            if (!token || !token->IsCancelled())
+            {
+                state->invoke(state->callable, context, begin, end);
+            }
+            break;
         }
-    }
 
-    for (uint32 i = 0; i < numTasksToSpawn; ++i)
-    {
-        TaskDesc subTaskDesc;
-        subTaskDesc.debugName = debugName;
-        subTaskDesc.parent = parallelForTask;
-        subTaskDesc.dependency = mDependencyTask;
-        subTaskDesc.function = [func, threadDataPtr, numTasksToSpawn] (const TaskContext& context)
+        case ParallelForSchedule::Dynamic:
         {
-            // consume elements assigned to each thread (starting from self)
-            for (uint32 threadDataOffset = 0; threadDataOffset < numTasksToSpawn; ++threadDataOffset)
+            for (;;)
             {
-                uint32 threadDataIndex = context.threadId + threadDataOffset;
-                if (threadDataIndex >= numTasksToSpawn)
+                if (token && token->IsCancelled())
                 {
-                    threadDataIndex -= numTasksToSpawn;
+                    break;
                 }
 
-                ThreadData& threadData = threadDataPtr->Data()[threadDataIndex];
+                const uint64 begin = state->nextElement.fetch_add(grainSize, std::memory_order_relaxed);
+                if (begin >= arraySize)
+                {
+                    break;
+                }
+
+                const uint32 end = static_cast<uint32>(Math::Min<uint64>(begin + grainSize, arraySize));
+                state->invoke(state->callable, context, static_cast<uint32>(begin), end);
+            }
+            break;
+        }
 
-                uint32 index;
-                while ((index = threadData.counter++) < threadData.numElements)
+        case ParallelForSchedule::Guided:
+        {
+            uint64 begin = state->nextElement.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                if (begin >= arraySize || (token && token->IsCancelled()))
                 {
-                    func(context, static_cast<uint32>(threadData.elementOffset + index));
+                    break;
+                }
+
+                // take a half of the remaining work divided evenly between the tasks
+                const uint64 chunkSize = Math::Max<uint64>(grainSize, (arraySize - begin) / (2u * state->numTasks));
+                const uint64 end = Math::Min<uint64>(begin + chunkSize, arraySize);
+
+                if (state->nextElement.compare_exchange_weak(begin, end, std::memory_order_relaxed))
+                {
+                    state->invoke(state->callable, context, static_cast<uint32>(begin), static_cast<uint32>(end));
+                    begin = state->nextElement.load(std::memory_order_relaxed);
                 }
             }
+            break;
+        }
+    }
+
+    // the last finished task releases the state
+    if (state->numActiveTasks.fetch_sub(1) == 1)
+    {
+        ReleaseParallelForState(state);
+    }
+}
+
+TaskID TaskBuilder::DispatchParallelFor(const char* debugName, uint32 arraySize, const ParallelForParams& params, ParallelForState* state)
+{
+    ThreadPool& tp = ThreadPool::GetInstance();
+
+    TaskDesc desc;
+    desc.debugName = debugName;
+    desc.parent = mParentTask;
+    desc.dependency = mDependencyTask;
+
+    TaskID parallelForTask = tp.CreateTask(desc);
+    mPendingTasks.PushBack(parallelForTask);
+
+    // sub-tasks wait for a single task gathering all the dependencies
+    TaskID startTask = mDependencyTask;
+    if (!params.dependencies.Empty())
+    {
+        for (const TaskID dependency : params.dependencies)
+        {
+            NFE_ASSERT(IsPendingTask(dependency), "Dependency must be a task pushed to this builder after the last fence");
+            NFE_UNUSED(dependency);
+        }
+
+        TaskDesc startDesc;
+        startDesc.debugName = "TaskBuilder::ParallelFor/Dependencies";
+        startDesc.dependency = mDependencyTask;
+        startDesc.dependencies = params.dependencies;
+        startTask = tp.CreateTask(startDesc);
+    }
+
+    const uint32 grainSize = Math::Max(1u, params.grainSize);
+    const uint32 numChunks = arraySize / grainSize + (arraySize % grainSize > 0 ? 1 : 0);
+    const uint32 numThreads = params.numaNode < tp.GetNumNumaNodes() ? tp.GetNumNodeWorkerThreads(params.numaNode) : tp.GetNumThreads();
+    const uint32 numTasksToSpawn = Math::Min(numChunks, Math::Max(1u, numThreads));
+
+    state->nextElement = 0;
+    state->numActiveTasks = numTasksToSpawn;
+    state->arraySize = arraySize;
+    state->grainSize = grainSize;
+    state->numTasks = numTasksToSpawn;
+    state->schedule = params.schedule;
+    state->cancellationToken = mCancellationToken;
+
+    for (uint32 i = 0; i < numTasksToSpawn; ++i)
+    {
+        TaskDesc subTaskDesc;
+        subTaskDesc.debugName = debugName;
+        subTaskDesc.parent = parallelForTask;
+        subTaskDesc.dependency = startTask;
+        subTaskDesc.numaNode = params.numaNode;
+        // Note: small capture, so std::function does not allocate
+        subTaskDesc.function = [state, i] (const TaskContext& context)
+        {
+            ExecuteParallelFor(state, context, i);
         };
 
         tp.CreateAndDispatchTask(subTaskDesc);
     }
+
+    if (startTask != mDependencyTask)
+    {
+        tp.DispatchTask(startTask);
+    }
+
+    return parallelForTask;
 }
 
 } // namespace Common
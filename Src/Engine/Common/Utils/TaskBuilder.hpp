@@ -3,10 +3,67 @@
 #include "../nfCommon.hpp"
 #include "ThreadPoolTask.hpp"
 #include "../Containers/StaticArray.hpp"
+#include "../Containers/ArrayView.hpp"
+
+#include <new>
+#include <type_traits>
 
 namespace NFE {
 namespace Common {
 
+class CancellationToken;
+
+// Specifies how parallel-for array elements are distributed between the tasks
+enum class ParallelForSchedule : uint8
+{
+    Static,     // array is split evenly between the tasks up-front (lowest overhead, good for uniform work)
+    Dynamic,    // tasks grab chunks of "grainSize" elements until the array is exhausted
+    Guided,     // like Dynamic, but chunk size is proportional to the remaining work (not smaller than "grainSize")
+};
+
+struct ParallelForParams
+{
+    // minimum number of elements processed at once
+    uint32 grainSize = 1;
+
+    ParallelForSchedule schedule = ParallelForSchedule::Guided;
+
+    // locality hint for the spawned tasks (see TaskDesc::numaNode)
+    uint8 numaNode = AnyNumaNode;
+
+    // additional tasks that must finish before the parallel-for starts (see TaskBuilder::Task)
+    ArrayView<const TaskID> dependencies;
+
+    NFE_INLINE ParallelForParams() = default;
+    NFE_INLINE ParallelForParams(ParallelForSchedule schedule, uint32 grainSize = 1) : grainSize(grainSize), schedule(schedule) { }
+};
+
+// Internal state of a single parallel-for call
+// States are pooled, so calling parallel-for does not require dynamic allocations.
+struct NFE_ALIGN(NFE_CACHE_LINE_SIZE) ParallelForState
+{
+    static constexpr size_t InlineCallableSize = 128;
+
+    // call the callable for all elements in [begin, end) range
+    using InvokeFunction = void(*)(void* callable, const TaskContext& context, uint32 begin, uint32 end);
+    using DestroyFunction = void(*)(void* callable);
+
+    std::atomic<uint64> nextElement;        // first element not yet taken by any task
+    std::atomic<uint32> numActiveTasks;     // the state is released when this reaches zero
+    uint32 arraySize;
+    uint32 grainSize;
+    uint32 numTasks;
+    ParallelForSchedule schedule;
+    const CancellationToken* cancellationToken; // remaining elements are skipped if cancelled
+
+    InvokeFunction invoke;
+    DestroyFunction destroy;
+    void* callable;                         // points to "inlineStorage" or to a heap allocation if the callable is too big
+    ParallelForState* nextFree;
+
+    alignas(16) uint8 inlineStorage[InlineCallableSize];
+};
+
 // helper class that allows easy task-graph building
 class NFCOMMON_API TaskBuilder
 {
@@ -21,16 +78,27 @@ public:
     explicit TaskBuilder(Waitable& waitable);
     ~TaskBuilder();
 
-    // push a new task
+    // Push a new task
     // Note: multiple pushed tasks can run in parallel
-    void Task(const char* debugName, const TaskFunction& func);
+    // Besides the last fence, the task can wait for any number of other tasks pushed to this builder, which allows
+    // building fine-grained graphs (eg. per-tile dependencies) without global sync points.
+    // Returned task ID can be used as a dependency of tasks pushed to the builder until the next fence.
+    TaskID Task(const char* debugName, const TaskFunction& func, const ArrayView<const TaskID> dependencies = ArrayView<const TaskID>());
 
     // Push a custom task
     // Note: The task must be created, but not yet dispatched
-    void CustomTask(TaskID customTask);
+    TaskID CustomTask(TaskID customTask);
 
     // push parallel-for task
-    void ParallelFor(const char* debugName, uint32 arraySize, const ParallelForTaskFunction& func);
+    // The callable is invoked for each array element with (const TaskContext& context, uint32 arrayIndex) arguments.
+    // Returned task ID (finished when all the elements are processed) can be used as a dependency like in Task().
+    template<typename Func>
+    TaskID ParallelFor(const char* debugName, uint32 arraySize, Func&& func, const ParallelForParams& params = ParallelForParams());
+
+    // Set cancellation token for tasks pushed after this call (can be null)
+    // If the token gets cancelled, pending tasks are not executed and parallel-for tasks stop processing remaining elements.
+    NFE_FORCE_INLINE void SetCancellationToken(const CancellationToken* token) { mCancellationToken = token; }
+    NFE_FORCE_INLINE const CancellationToken* GetCancellationToken() const { return mCancellationToken; }
 
     // Push a sync point
     // All tasks pushed after the fence will start only when all the tasks pushed before the fence finish execution
@@ -38,6 +106,14 @@ public:
     void Fence(Waitable* waitable = nullptr);
 
 private:
+    static ParallelForState* AcquireParallelForState(size_t callableSize, size_t callableAlignment);
+    static void ReleaseParallelForState(ParallelForState* state);
+    static void ExecuteParallelFor(ParallelForState* state, const TaskContext& context, uint32 taskIndex);
+    TaskID DispatchParallelFor(const char* debugName, uint32 arraySize, const ParallelForParams& params, ParallelForState* state);
+
+    // check if the task can be used as a dependency (was pushed after the last fence)
+    bool IsPendingTask(TaskID taskID) const;
+
     // forbid dynamic allocation (only stack allocation is allowed)
     void* operator new(size_t size) = delete;
     void operator delete(void* ptr) = delete;
@@ -49,10 +125,42 @@ private:
     Waitable* mWaitable = nullptr;
     const TaskID mParentTask = InvalidTaskID;
     TaskID mDependencyTask = InvalidTaskID;
+    const CancellationToken* mCancellationToken = nullptr;
 
     // tasks that has to be synchronized after instering a fence or synchronizing with waitable object
     StaticArray<TaskID, MaxTasks> mPendingTasks;
 };
 
+
+template<typename Func>
+TaskID TaskBuilder::ParallelFor(const char* debugName, uint32 arraySize, Func&& func, const ParallelForParams& params)
+{
+    using CallableType = std::decay_t<Func>;
+
+    if (arraySize == 0)
+    {
+        return InvalidTaskID;
+    }
+
+    ParallelForState* state = AcquireParallelForState(sizeof(CallableType), alignof(CallableType));
+    new (state->callable) CallableType(std::forward<Func>(func));
+
+    state->invoke = [] (void* callable, const TaskContext& context, uint32 begin, uint32 end)
+    {
+        CallableType& typedCallable = *static_cast<CallableType*>(callable);
+        for (uint32 i = begin; i < end; ++i)
+        {
+            typedCallable(context, i);
+        }
+    };
+
+    state->destroy = [] (void* callable)
+    {
+        static_cast<CallableType*>(callable)->~CallableType();
+    };
+
+    return DispatchParallelFor(debugName, arraySize, params, state);
+}
+
 } // namespace Common
 } // namespace NFE
@@ -0,0 +1,457 @@
+/**
+ * @file
+ * @author Witek902 (witek902@gmail.com)
+ * @brief  TaskTracer class definition.
+ */
+
+#include "PCH.hpp"
+#include "TaskTracer.hpp"
+#include "Logger/Logger.hpp"
+#include "FileSystem/File.hpp"
+#include "../Math/Math.hpp"
+
+#include <chrono>
+#include <algorithm>
+#include <stdarg.h>
+
+#ifdef NFE_ENABLE_TASK_TRACING
+
+namespace NFE {
+namespace Common {
+
+namespace {
+
+const int32 InvalidIndex = -1;
+
+int32 FindEventIndex(const DynArray<TaskTraceEvent>& events, uint64 id)
+{
+    if (id == 0)
+    {
+        return InvalidIndex;
+    }
+
+    const auto iter = std::lower_bound(events.Begin(), events.End(), id, [] (const TaskTraceEvent& event, uint64 value)
+    {
+        return event.id < value;
+    });
+
+    if (iter != events.End() && iter->id == id)
+    {
+        return static_cast<int32>(iter - events.Begin());
+    }
+
+    return InvalidIndex;
+}
+
+void AppendFormat(DynArray<char>& output, const char* format, ...)
+{
+    char buffer[512];
+
+    va_list args;
+    va_start(args, format);
+    const int length = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+
+    if (length > 0)
+    {
+        const uint32 numChars = Math::Min<uint32>(static_cast<uint32>(length), sizeof(buffer) - 1);
+        output.PushBackArray(ArrayView<const char>(buffer, numChars));
+    }
+}
+
+void AppendEscapedName(DynArray<char>& output, const char* name)
+{
+    if (!name)
+    {
+        name = "<unnamed>";
+    }
+
+    for (const char* ptr = name; *ptr; ++ptr)
+    {
+        if (*ptr == '"' || *ptr == '\\')
+        {
+            output.PushBack('\\');
+        }
+        output.PushBack(*ptr);
+    }
+}
+
+NFE_FORCE_INLINE double NanosecondsToMicroseconds(uint64 time)
+{
+    return 1.0e-3 * static_cast<double>(time);
+}
+
+} // namespace
+
+
+TaskTracer::TaskTracer(uint32 numThreads)
+    : mCapacityPerThread(0)
+    , mNextTaskId(1)
+    , mEnabled(false)
+{
+    mThreadBuffers.Reserve(numThreads);
+    for (uint32 i = 0; i < numThreads; ++i)
+    {
+        mThreadBuffers.PushBack(MakeUniquePtr<ThreadBuffer>());
+    }
+}
+
+TaskTracer::~TaskTracer() = default;
+
+uint64 TaskTracer::GetTimestamp()
+{
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+}
+
+void TaskTracer::Start(uint32 capacityPerThread)
+{
+    NFE_ASSERT(capacityPerThread > 0, "Invalid trace buffer capacity");
+
+    mCapacityPerThread = capacityPerThread;
+
+    for (const UniquePtr<ThreadBuffer>& buffer : mThreadBuffers)
+    {
+        buffer->events.Resize_SkipConstructor(capacityPerThread);
+        buffer->dependencies.Resize_SkipConstructor(capacityPerThread);
+        buffer->numEvents = 0;
+        buffer->numDependencies = 0;
+    }
+
+    mEnabled.store(true, std::memory_order_release);
+}
+
+void TaskTracer::Stop()
+{
+    mEnabled.store(false, std::memory_order_release);
+}
+
+uint64 TaskTracer::GenerateTaskId()
+{
+    return mNextTaskId.fetch_add(1, std::memory_order_relaxed);
+}
+
+void TaskTracer::RecordTask(uint32 threadId, const TaskTraceEvent& event)
+{
+    if (!IsEnabled())
+    {
+        return;
+    }
+
+    NFE_ASSERT(threadId < mThreadBuffers.Size(), "Invalid thread ID");
+    ThreadBuffer& buffer = *mThreadBuffers[threadId];
+    buffer.events[static_cast<uint32>(buffer.numEvents % mCapacityPerThread)] = event;
+    buffer.numEvents++;
+}
+
+void TaskTracer::RecordDependency(uint32 threadId, uint64 from, uint64 to)
+{
+    if (!IsEnabled())
+    {
+        return;
+    }
+
+    NFE_ASSERT(threadId < mThreadBuffers.Size(), "Invalid thread ID");
+    ThreadBuffer& buffer = *mThreadBuffers[threadId];
+    buffer.dependencies[static_cast<uint32>(buffer.numDependencies % mCapacityPerThread)] = TaskTraceDependency{ from, to };
+    buffer.numDependencies++;
+}
+
+void TaskTracer::CollectEvents(DynArray<TaskTraceEvent>& outEvents, DynArray<TaskTraceDependency>& outDependencies, uint32& outNumDropped) const
+{
+    outEvents.Clear();
+    outDependencies.Clear();
+    outNumDropped = 0;
+
+    if (mCapacityPerThread == 0)
+    {
+        return;
+    }
+
+    for (const UniquePtr<ThreadBuffer>& buffer : mThreadBuffers)
+    {
+        const uint32 numEvents = static_cast<uint32>(Math::Min<uint64>(buffer->numEvents, mCapacityPerThread));
+        for (uint32 i = 0; i < numEvents; ++i)
+        {
+            outEvents.PushBack(buffer->events[i]);
+        }
+        outNumDropped += static_cast<uint32>(buffer->numEvents - numEvents);
+
+        const uint32 numDependencies = static_cast<uint32>(Math::Min<uint64>(buffer->numDependencies, mCapacityPerThread));
+        for (uint32 i = 0; i < numDependencies; ++i)
+        {
+            outDependencies.PushBack(buffer->dependencies[i]);
+        }
+    }
+
+    std::sort(outEvents.Begin(), outEvents.End(), [] (const TaskTraceEvent& a, const TaskTraceEvent& b)
+    {
+        return a.id < b.id;
+    });
+
+    std::sort(outDependencies.Begin(), outDependencies.End(), [] (const TaskTraceDependency& a, const TaskTraceDependency& b)
+    {
+        return a.to < b.to;
+    });
+}
+
+void TaskTracer::GetSummary(TaskTraceSummary& outSummary) const
+{
+    DynArray<TaskTraceEvent> events;
+    DynArray<TaskTraceDependency> dependencies;
+
+    outSummary = TaskTraceSummary();
+    CollectEvents(events, dependencies, outSummary.numDroppedEvents);
+
+    outSummary.threadUtilization.Resize(mThreadBuffers.Size(), 0.0f);
+    outSummary.numTasks = events.Size();
+    if (events.Empty())
+    {
+        return;
+    }
+
+    // wall time and threads utilization
+    uint64 traceStart = UINT64_MAX;
+    uint64 traceEnd = 0;
+    uint64 totalWorkTime = 0;
+    DynArray<uint64> threadBusyTime;
+    threadBusyTime.Resize(mThreadBuffers.Size(), 0);
+    for (const TaskTraceEvent& event : events)
+    {
+        traceStart = Math::Min(traceStart, event.startTime);
+        traceEnd = Math::Max(traceEnd, event.endTime);
+        totalWorkTime += event.endTime - event.startTime;
+        threadBusyTime[event.threadId] += event.endTime - event.startTime;
+    }
+
+    const uint64 wallTime = traceEnd - traceStart;
+    outSummary.wallTime = 1.0e-9 * static_cast<double>(wallTime);
+    outSummary.totalWorkTime = 1.0e-9 * static_cast<double>(totalWorkTime);
+    for (uint32 i = 0; i < threadBusyTime.Size(); ++i)
+    {
+        outSummary.threadUtilization[i] = wallTime > 0 ? static_cast<float>(static_cast<double>(threadBusyTime[i]) / static_cast<double>(wallTime)) : 0.0f;
+    }
+
+    // Critical path computation.
+    // A task can start when all its dependencies finished and (if it was spawned by another task)
+    // when its parent reached the point at which the task was created. A task is finished when its callback
+    // and all its child tasks are finished. Tasks are processed in start time order, so all the predecessors
+    // are already processed (except for the children, which propagate their finish time upwards when processed).
+
+    const uint32 numEvents = events.Size();
+
+    struct NodeInfo
+    {
+        uint64 pathStart = 0;           // earliest possible start time on the longest path
+        uint64 pathFinish = 0;          // earliest possible finish time (including children)
+        int32 startPredecessor = InvalidIndex;
+        int32 finishPredecessor = InvalidIndex;   // child which determines the finish time (or invalid if the task itself)
+        int32 parent = InvalidIndex;
+    };
+
+    DynArray<NodeInfo> nodes;
+    nodes.Resize(numEvents);
+
+    DynArray<uint32> order;
+    order.Resize(numEvents);
+    for (uint32 i = 0; i < numEvents; ++i)
+    {
+        order[i] = i;
+        nodes[i].parent = FindEventIndex(events, events[i].parentId);
+    }
+
+    std::sort(order.Begin(), order.End(), [&events] (uint32 a, uint32 b)
+    {
+        return events[a].startTime < events[b].startTime;
+    });
+
+    for (const uint32 index : order)
+    {
+        const TaskTraceEvent& event = events[index];
+        NodeInfo& node = nodes[index];
+
+        // dependencies
+        const auto range = std::equal_range(dependencies.Begin(), dependencies.End(), TaskTraceDependency{ 0, event.id },
+            [] (const TaskTraceDependency& a, const TaskTraceDependency& b)
+            {
+                return a.to < b.to;
+            });
+
+        for (auto iter = range.first; iter != range.second; ++iter)
+        {
+            const int32 dependencyIndex = FindEventIndex(events, iter->from);
+            if (dependencyIndex != InvalidIndex && nodes[dependencyIndex].pathFinish > node.pathStart)
+            {
+                node.pathStart = nodes[dependencyIndex].pathFinish;
+                node.startPredecessor = dependencyIndex;
+            }
+        }
+
+        // parent
+        if (node.parent != InvalidIndex)
+        {
+            const TaskTraceEvent& parentEvent = events[node.parent];
+            if (event.createTime >= parentEvent.startTime && event.createTime <= parentEvent.endTime)
+            {
+                const uint64 pathStart = nodes[node.parent].pathStart + (event.createTime - parentEvent.startTime);
+                if (pathStart > node.pathStart)
+                {
+                    node.pathStart = pathStart;
+                    node.startPredecessor = node.parent;
+                }
+            }
+        }
+
+        const uint64 pathEnd = node.pathStart + (event.endTime - event.startTime);
+        if (pathEnd >= node.pathFinish)
+        {
+            node.pathFinish = pathEnd;
+            node.finishPredecessor = InvalidIndex;
+        }
+
+        // propagate finish time to the parents
+        int32 childIndex = static_cast<int32>(index);
+        int32 parentIndex = node.parent;
+        while (parentIndex != InvalidIndex && nodes[parentIndex].pathFinish < node.pathFinish)
+        {
+            nodes[parentIndex].pathFinish = node.pathFinish;
+            nodes[parentIndex].finishPredecessor = childIndex;
+            childIndex = parentIndex;
+            parentIndex = nodes[parentIndex].parent;
+        }
+    }
+
+    uint32 lastIndex = 0;
+    for (uint32 i = 1; i < numEvents; ++i)
+    {
+        if (nodes[i].pathFinish > nodes[lastIndex].pathFinish)
+        {
+            lastIndex = i;
+        }
+    }
+
+    outSummary.criticalPathTime = 1.0e-9 * static_cast<double>(nodes[lastIndex].pathFinish);
+
+    // walk the path backwards
+    int32 current = static_cast<int32>(lastIndex);
+    for (uint32 i = 0; current != InvalidIndex && i < 2 * numEvents; ++i)
+    {
+        // descend to the child which finished last
+        while (nodes[current].finishPredecessor != InvalidIndex)
+        {
+            current = nodes[current].finishPredecessor;
+        }
+
+        const TaskTraceEvent& event = events[current];
+        TaskTraceCriticalPathEntry entry;
+        entry.debugName = event.debugName;
+        entry.threadId = event.threadId;
+        entry.startTime = 1.0e-9 * static_cast<double>(event.startTime - traceStart);
+        entry.duration = 1.0e-9 * static_cast<double>(event.endTime - event.startTime);
+        outSummary.criticalPath.PushBack(entry);
+
+        // if the task was started by its parent, continue from the parent's start, without descending again
+        while (nodes[current].startPredecessor != InvalidIndex && nodes[current].startPredecessor == nodes[current].parent)
+        {
+            current = nodes[current].parent;
+
+            const TaskTraceEvent& parentEvent = events[current];
+            entry.debugName = parentEvent.debugName;
+            entry.threadId = parentEvent.threadId;
+            entry.startTime = 1.0e-9 * static_cast<double>(parentEvent.startTime - traceStart);
+            entry.duration = 1.0e-9 * static_cast<double>(parentEvent.endTime - parentEvent.startTime);
+            outSummary.criticalPath.PushBack(entry);
+        }
+
+        current = nodes[current].startPredecessor;
+    }
+
+    std::reverse(outSummary.criticalPath.Begin(), outSummary.criticalPath.End());
+}
+
+bool TaskTracer::ExportChromeTrace(const StringView path) const
+{
+    DynArray<TaskTraceEvent> events;
+    DynArray<TaskTraceDependency> dependencies;
+    uint32 numDropped = 0;
+    CollectEvents(events, dependencies, numDropped);
+
+    uint64 traceStart = UINT64_MAX;
+    for (const TaskTraceEvent& event : events)
+    {
+        traceStart = Math::Min(traceStart, event.createTime);
+    }
+
+    DynArray<char> output;
+    AppendFormat(output, "{\"traceEvents\":[\n");
+
+    const uint32 numThreads = mThreadBuffers.Size();
+    for (uint32 i = 0; i < numThreads; ++i)
+    {
+        if (i + 1 < numThreads)
+        {
+            AppendFormat(output, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"Worker #%u\"}},\n", i, i);
+        }
+        else
+        {
+            AppendFormat(output, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"External thread\"}},\n", i);
+        }
+    }
+
+    for (const TaskTraceEvent& event : events)
+    {
+        AppendFormat(output, "{\"name\":\"");
+        AppendEscapedName(output, event.debugName);
+        AppendFormat(output, "\",\"cat\":\"task\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"id\":%llu,\"parent\":%llu,\"queueWait\":%.3f,\"dependencyWait\":%.3f}},\n",
+                     event.threadId,
+                     NanosecondsToMicroseconds(event.startTime - traceStart),
+                     NanosecondsToMicroseconds(event.endTime - event.startTime),
+                     static_cast<unsigned long long>(event.id),
+                     static_cast<unsigned long long>(event.parentId),
+                     NanosecondsToMicroseconds(event.startTime - Math::Min(event.startTime, event.queueTime)),
+                     NanosecondsToMicroseconds(Math::Max(event.queueTime, event.createTime) - event.createTime));
+    }
+
+    // dependencies are presented as flow arrows
+    uint32 flowId = 0;
+    for (const TaskTraceDependency& dependency : dependencies)
+    {
+        const int32 fromIndex = FindEventIndex(events, dependency.from);
+        const int32 toIndex = FindEventIndex(events, dependency.to);
+        if (fromIndex == InvalidIndex || toIndex == InvalidIndex)
+        {
+            continue;
+        }
+
+        const TaskTraceEvent& from = events[fromIndex];
+        const TaskTraceEvent& to = events[toIndex];
+
+        AppendFormat(output, "{\"name\":\"dependency\",\"cat\":\"dependency\",\"ph\":\"s\",\"id\":%u,\"pid\":0,\"tid\":%u,\"ts\":%.3f},\n",
+                     flowId, from.threadId, NanosecondsToMicroseconds(from.endTime - traceStart));
+        AppendFormat(output, "{\"name\":\"dependency\",\"cat\":\"dependency\",\"ph\":\"f\",\"bp\":\"e\",\"id\":%u,\"pid\":0,\"tid\":%u,\"ts\":%.3f},\n",
+                     flowId, to.threadId, NanosecondsToMicroseconds(to.startTime - traceStart));
+        flowId++;
+    }
+
+    AppendFormat(output, "{\"name\":\"dropped_events\",\"ph\":\"M\",\"pid\":0,\"args\":{\"count\":%u}}\n]}\n", numDropped);
+
+    File file(path, AccessMode::Write, true);
+    if (!file.IsOpened())
+    {
+        NFE_LOG_ERROR("Failed to open task trace file '%.*s'", path.Length(), path.Data());
+        return false;
+    }
+
+    if (file.Write(output.Data(), output.Size()) != output.Size())
+    {
+        NFE_LOG_ERROR("Failed to write task trace file '%.*s'", path.Length(), path.Data());
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace Common
+} // namespace NFE
+
+#endif // NFE_ENABLE_TASK_TRACING
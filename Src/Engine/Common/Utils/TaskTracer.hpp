@@ -0,0 +1,134 @@
+/**
+ * @file
+ * @author Witek902 (witek902@gmail.com)
+ * @brief  TaskTracer class declaration.
+ */
+
+#pragma once
+
+#include "../nfCommon.hpp"
+#include "ThreadPoolTask.hpp"
+#include "../Containers/DynArray.hpp"
+#include "../Containers/UniquePtr.hpp"
+#include "../Containers/StringView.hpp"
+
+#ifdef NFE_ENABLE_TASK_TRACING
+
+namespace NFE {
+namespace Common {
+
+// Single task execution record
+struct TaskTraceEvent
+{
+    uint64 id;
+    uint64 parentId;
+    const char* debugName;
+    uint64 createTime;      // all the times are in nanoseconds (see TaskTracer::GetTimestamp)
+    uint64 queueTime;       // dependencies fulfilled
+    uint64 startTime;
+    uint64 endTime;
+    uint32 threadId;
+};
+
+// "Task 'to' waited for task 'from' to finish" record
+struct TaskTraceDependency
+{
+    uint64 from;
+    uint64 to;
+};
+
+struct TaskTraceCriticalPathEntry
+{
+    const char* debugName;
+    uint32 threadId;
+    double startTime;       // relative to the trace start (in seconds)
+    double duration;        // in seconds
+};
+
+struct TaskTraceSummary
+{
+    uint32 numTasks = 0;
+    uint32 numDroppedEvents = 0;        // events overwritten due to ring buffers overflow
+
+    double wallTime = 0.0;              // time between the first task start and the last task end (in seconds)
+    double totalWorkTime = 0.0;         // sum of all tasks execution time
+    double criticalPathTime = 0.0;      // length of the longest chain of dependent tasks (lower bound of wall time)
+
+    // tasks on the critical path (in execution order)
+    DynArray<TaskTraceCriticalPathEntry> criticalPath;
+
+    // busy time to wall time ratio for each thread
+    DynArray<float> threadUtilization;
+
+    // maximum speedup achievable with infinite number of threads
+    NFE_FORCE_INLINE double GetParallelism() const
+    {
+        return criticalPathTime > 0.0 ? totalWorkTime / criticalPathTime : 0.0;
+    }
+};
+
+/**
+ * @class TaskTracer
+ * Records thread pool tasks execution timeline.
+ *
+ * Each thread writes to its own ring buffer, so recording does not require any synchronization
+ * (when buffers are full, the oldest events are overwritten). Tracing is disabled by default and has
+ * negligible overhead then. The whole tracer is compiled out in Final configuration.
+ *
+ * NOTE: Start(), Stop(), GetSummary() and Export() must not be called while tasks are being executed.
+ */
+class NFCOMMON_API TaskTracer final
+{
+    NFE_MAKE_NONCOPYABLE(TaskTracer)
+    NFE_MAKE_NONMOVEABLE(TaskTracer)
+
+public:
+    static constexpr uint32 DefaultCapacityPerThread = 16 * 1024;
+
+    explicit TaskTracer(uint32 numThreads);
+    ~TaskTracer();
+
+    // clear recorded events and start recording
+    void Start(uint32 capacityPerThread = DefaultCapacityPerThread);
+
+    // stop recording (recorded events are preserved)
+    void Stop();
+
+    NFE_FORCE_INLINE bool IsEnabled() const { return mEnabled.load(std::memory_order_relaxed); }
+
+    // compute critical path and threads utilization of the recorded events
+    void GetSummary(TaskTraceSummary& outSummary) const;
+
+    // export recorded events to JSON file in Chrome tracing format (chrome://tracing, Perfetto UI)
+    bool ExportChromeTrace(const StringView path) const;
+
+    // get current timestamp in nanoseconds
+    static uint64 GetTimestamp();
+
+    // Recording functions (called by the thread pool)
+    uint64 GenerateTaskId();
+    void RecordTask(uint32 threadId, const TaskTraceEvent& event);
+    void RecordDependency(uint32 threadId, uint64 from, uint64 to);
+
+private:
+    struct NFE_ALIGN(NFE_CACHE_LINE_SIZE) ThreadBuffer
+    {
+        DynArray<TaskTraceEvent> events;
+        DynArray<TaskTraceDependency> dependencies;
+        uint64 numEvents = 0;           // total number of recorded events (including overwritten)
+        uint64 numDependencies = 0;
+    };
+
+    // collect events from all the threads (sorted by ID)
+    void CollectEvents(DynArray<TaskTraceEvent>& outEvents, DynArray<TaskTraceDependency>& outDependencies, uint32& outNumDropped) const;
+
+    DynArray<UniquePtr<ThreadBuffer>> mThreadBuffers;
+    uint32 mCapacityPerThread;
+    std::atomic<uint64> mNextTaskId;
+    std::atomic<bool> mEnabled;
+};
+
+} // namespace Common
+} // namespace NFE
+
+#endif // NFE_ENABLE_TASK_TRACING
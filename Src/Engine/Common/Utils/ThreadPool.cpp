@@ -7,19 +7,39 @@
 #include "PCH.hpp"
 #include "ThreadPool.hpp"
 #include "Waitable.hpp"
+#include "../Math/Math.hpp"
+#include "../System/SystemInfo.hpp"
 
 namespace NFE {
 namespace Common {
 
+namespace {
+
+// maximum number of tasks moved from the global queue to worker's local queue at once
+const uint32 MaxGlobalQueueBatchSize = 16;
+
+// number of task queues checks before a worker thread goes to sleep
+const uint32 NumSpinsBeforeSleep = 64;
+
+// worker thread running on the current thread (if any)
+thread_local WorkerThread* tCurrentWorker = nullptr;
+
+// used for picking a victim for stealing by non-worker threads
+thread_local uint32 tRandomSeed = 0x2545F491u;
+
+// priority of the task being executed on the current thread (lowest one if not executing a task)
+thread_local uint32 tCurrentTaskPriority = ThreadPool::MaxPriority;
+
+} // namespace
+
 WorkerThread::WorkerThread(ThreadPool* pool, uint32 id)
-    : mId(id)
+    : mPool(pool)
+    , mId(id)
+    , mLogicalCoreId(0)
+    , mNumaNode(0)
+    , mRandomSeed(id * 0x9E3779B9u + 1u)
     , mStarted(true)
 {
-    mThread.Run(&ThreadPool::SchedulerCallback, pool, this);
-
-    char threadName[64];
-    snprintf(threadName, sizeof(threadName), "NFE::Common::ThreadPool worker #%u", id);
-    mThread.SetName(threadName);
 }
 
 WorkerThread::~WorkerThread()
@@ -36,199 +56,745 @@ ThreadPool& ThreadPool::GetInstance()
 }
 
 ThreadPool::ThreadPool()
-    : mFirstFreeTask(InvalidTaskID)
+    : ThreadPool(0)
+{
+}
+
+ThreadPool::ThreadPool(uint32 numThreads)
+    : mOwnerThreadID(Thread::GetCurrentThreadID())
+    , mNumNumaNodes(1)
+    , mNumTaskGroups(0)
+    , mNumWakeUpTokens(0)
+    , mNumSleepingThreads(0)
+    , mHelpersWakeUpCounter(0)
+    , mNumSleepingHelpers(0)
+    , mNumTasksPages(0)
+    , mFreeTasksHead(InvalidTaskID)
 {
-    // TODO make it configurable
-    InitTasksTable(TasksCapacity);
-    SpawnWorkerThreads(Thread::GetSystemThreadsCount());
+    for (uint32 i = 0; i < MaxTasksPages; ++i)
+    {
+        mTasksPages[i] = nullptr;
+    }
+
+    AllocateTasksPage();
+    SpawnWorkerThreads(numThreads > 0 ? numThreads : Thread::GetSystemThreadsCount());
 }
 
 ThreadPool::~ThreadPool()
 {
+    for (const WorkerThreadPtr& thread : mThreads)
     {
-        NFE_SCOPED_LOCK(mTasksQueueMutex);
+        thread->mStarted = false;
+    }
 
-        for (const WorkerThreadPtr& thread : mThreads)
-        {
-            thread->mStarted = false;
-        }
+    {
+        NFE_SCOPED_LOCK(mSleepMutex);
+        mSleepCV.SignalAll();
+    }
 
-        mTaskQueueCV.SignalAll();
+    // workers steal from each other's queues, so all of them must exit before any of them is destroyed
+    for (const WorkerThreadPtr& thread : mThreads)
+    {
+        thread->mThread.Wait();
     }
 
     // cleanup
     mThreads.Clear();
-}
-
-bool ThreadPool::InitTasksTable(uint32 newSize)
-{
-    /*
-    const uint32 oldSize = mTasks.Size();
-    newSize = Math::Max(1u, newSize);
 
-    if (oldSize < newSize)
+    for (uint32 i = 0; i < mNumTasksPages; ++i)
     {
-        if (!mTasks.Reserve(newSize))
+        Task* page = mTasksPages[i].load();
+        for (uint32 j = 0; j < TasksPageSize; ++j)
         {
-            NFE_LOG_ERROR("Failed to reserve space for threadpool's tasks buffer");
-            return false;
+            page[j].~Task();
         }
+        NFE_FREE(page);
+    }
+}
 
-        uint32 lastFreeTask = mFirstFreeTask;
-        for (uint32 i = oldSize; i < newSize; ++i)
-        {
-            Task newTask;
-            newTask.mNextFree = lastFreeTask;
-            lastFreeTask = i;
+bool ThreadPool::AllocateTasksPage()
+{
+    NFE_SCOPED_LOCK(mTasksPagesMutex);
 
-            mTasks.PushBack(std::move(newTask));
-        }
-        mFirstFreeTask = lastFreeTask;
+    // other thread could have allocated a new page in the meantime
+    if (static_cast<TaskID>(mFreeTasksHead.load()) != InvalidTaskID)
+    {
+        return true;
+    }
+
+    if (mNumTasksPages >= MaxTasksPages)
+    {
+        NFE_LOG_ERROR("Failed to allocate threadpool's tasks page - maximum number of tasks reached");
+        return false;
     }
-    */
 
-    if (!mTasks.Resize(newSize))
+    Task* page = static_cast<Task*>(NFE_MALLOC(sizeof(Task) * TasksPageSize, NFE_CACHE_LINE_SIZE));
+    if (!page)
     {
-        NFE_LOG_ERROR("Failed to reserve space for threadpool's tasks buffer");
+        NFE_LOG_ERROR("Failed to allocate threadpool's tasks page");
         return false;
     }
 
-    mFirstFreeTask = 0;
-    for (uint32 i = 0; i < newSize - 1; ++i)
+    const TaskID firstTaskID = mNumTasksPages << TasksPageSizeBits;
+    for (uint32 i = 0; i < TasksPageSize; ++i)
     {
-        mTasks[i].mNextFree = i + 1;
+        new (page + i) Task;
+        page[i].mNextFree = firstTaskID + i + 1;
     }
-    mTasks[newSize - 1].mNextFree = InvalidTaskID;
+
+    mTasksPages[mNumTasksPages].store(page, std::memory_order_release);
+    mNumTasksPages++;
+
+    PushFreeTasks(firstTaskID, firstTaskID + TasksPageSize - 1);
 
     return true;
 }
 
+void ThreadPool::PushFreeTasks(TaskID first, TaskID last)
+{
+    Task& lastTask = GetTask(last);
+
+    uint64 oldHead = mFreeTasksHead.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        lastTask.mNextFree.store(static_cast<TaskID>(oldHead), std::memory_order_relaxed);
+
+        const uint64 newTag = (oldHead >> 32) + 1;
+        const uint64 newHead = (newTag << 32) | first;
+        if (mFreeTasksHead.compare_exchange_weak(oldHead, newHead, std::memory_order_release, std::memory_order_relaxed))
+        {
+            break;
+        }
+    }
+}
+
 void ThreadPool::SpawnWorkerThreads(uint32 num)
 {
+    NFE_ASSERT(mThreads.Empty(), "Worker threads already spawned");
+
+    const DynArray<LogicalCoreInfo>& logicalCores = SystemInfo::Instance().GetLogicalCores();
+
+    // all the workers must exist before any of them starts, because they access each other's queues
+    mNumNumaNodes = 1;
     for (uint32 i = 0; i < num; ++i)
     {
-        mThreads.PushBack(MakeUniquePtr<WorkerThread>(this, i));
+        WorkerThreadPtr thread = MakeUniquePtr<WorkerThread>(this, i);
+
+        if (!logicalCores.Empty())
+        {
+            const LogicalCoreInfo& core = logicalCores[i % logicalCores.Size()];
+            thread->mLogicalCoreId = core.id;
+            thread->mNumaNode = core.numaNode;
+            mNumNumaNodes = Math::Max(mNumNumaNodes, core.numaNode + 1);
+        }
+
+        mThreads.PushBack(std::move(thread));
     }
+
+#ifdef NFE_ENABLE_TASK_TRACING
+    mTracer = MakeUniquePtr<TaskTracer>(GetNumThreads());
+#endif // NFE_ENABLE_TASK_TRACING
+
+    // per-node queues, "any node" queue and task groups queue
+    for (uint32 i = 0; i <= GetGroupQueueIndex(); ++i)
+    {
+        mSharedQueues.PushBack(MakeUniquePtr<SharedQueue>());
+    }
+
+    for (const WorkerThreadPtr& thread : mThreads)
+    {
+        thread->mThread.Run(&ThreadPool::SchedulerCallback, this, thread.Get());
+
+        char threadName[64];
+        snprintf(threadName, sizeof(threadName), "NFE::Common::ThreadPool worker #%u", thread->mId);
+        thread->mThread.SetName(threadName);
+    }
+}
+
+bool ThreadPool::PinWorkerThreads()
+{
+    bool success = true;
+    for (const WorkerThreadPtr& thread : mThreads)
+    {
+        success &= thread->mThread.SetAffinity(thread->mLogicalCoreId);
+    }
+    return success;
+}
+
+uint32 ThreadPool::GetThreadNumaNode(uint32 threadId) const
+{
+    // Note: the owner thread is not pinned, so its node is unknown
+    return threadId < mThreads.Size() ? mThreads[threadId]->mNumaNode : 0u;
+}
+
+uint32 ThreadPool::GetNumNodeWorkerThreads(uint32 numaNode) const
+{
+    uint32 count = 0;
+    for (const WorkerThreadPtr& thread : mThreads)
+    {
+        if (thread->mNumaNode == numaNode)
+        {
+            count++;
+        }
+    }
+    return count;
 }
 
 void ThreadPool::SchedulerCallback(WorkerThread* thread)
 {
+    tCurrentWorker = thread;
+
     TaskContext context;
     context.pool = this;
     context.threadId = thread->mId;
 
-    for (;;)
+    while (thread->mStarted)
     {
-        Task* task = nullptr;
+        if (FindTask(thread, context.taskId, MaxPriority, true))
         {
-            ScopedExclusiveLock<Mutex> lock(mTasksQueueMutex);
+            ExecuteTask(context);
+        }
+        else
+        {
+            WaitForTask(thread);
+        }
+    }
 
-            Deque<TaskID>* queue = nullptr;
+    tCurrentWorker = nullptr;
+}
 
-            // wait for new task
-            while (thread->mStarted)
-            {
-                // find queue with pending tasks
-                queue = nullptr;
-                for (uint32 i = 0; i < NumPriorities; ++i)
-                {
-                    if (!mTasksQueues[i].Empty())
-                    {
-                        queue = &mTasksQueues[i];
-                        break;
-                    }
-                }
+void ThreadPool::ExecuteTask(const TaskContext& context)
+{
+    Task* task = &GetTask(context.taskId);
 
-                if (queue != nullptr)
-                {
-                    break;
-                }
+    const TaskGroupID groupID = task->mGroup;
+    if (groupID != InvalidTaskGroupID)
+    {
+        OnGroupTaskStarted(*task);
+    }
 
-                mTaskQueueCV.Wait(lock);
-            }
+#ifdef NFE_ENABLE_TASK_TRACING
+    const TaskTraceInfo traceInfo = task->mTraceInfo;
+    const uint64 traceStartTime = traceInfo.id ? TaskTracer::GetTimestamp() : 0;
+#endif // NFE_ENABLE_TASK_TRACING
 
-            if (!thread->mStarted)
-            {
-                break;
-            }
+    if (task->mCallback)
+    {
+        // Queued -> Executing
+        {
+            const Task::State oldState = task->mState.exchange(Task::State::Executing);
+            NFE_ASSERT(Task::State::Queued == oldState, "Task is expected to be in 'Queued' state");
+        }
+
+        // execute
+        {
+            // allocations made by the task are attributed to the subsystem that created it,
+            // not to whatever the executing thread is doing (eg. waiting for other tasks)
+            const MemoryTagScope memoryTagScope(task->mMemoryTag);
 
-            // pop a task from the queue
-            context.taskId = queue->Front();
-            task = &mTasks[context.taskId];
-            queue->PopFront();
+            // the task can be executed while waiting inside other task
+            const uint32 prevTaskPriority = tCurrentTaskPriority;
+            tCurrentTaskPriority = task->mPriority;
+            task->mCallback(context);
+            tCurrentTaskPriority = prevTaskPriority;
         }
 
-        if (task->mCallback)
+        // Executing -> Finished
         {
-            // Queued -> Executing
+            const Task::State oldState = task->mState.exchange(Task::State::Finished);
+            NFE_ASSERT(Task::State::Executing == oldState, "Task is expected to be in 'Executing' state");
+        }
+    }
+    else
+    {
+        // Queued -> Finished
+
+        const Task::State oldState = task->mState.exchange(Task::State::Finished);
+        NFE_ASSERT(Task::State::Queued == oldState, "Task is expected to be in 'Queued' state");
+    }
+
+    // release the group's slot before finishing, so the next task of the group can start right away
+    if (groupID != InvalidTaskGroupID)
+    {
+        OnGroupTaskFinished(groupID);
+    }
+
+#ifdef NFE_ENABLE_TASK_TRACING
+    if (traceInfo.id)
+    {
+        TaskTraceEvent event;
+        event.id = traceInfo.id;
+        event.parentId = traceInfo.parentId;
+        event.debugName = task->mDebugName;
+        event.createTime = traceInfo.createTime;
+        event.queueTime = traceInfo.queueTime;
+        event.startTime = traceStartTime;
+        event.endTime = TaskTracer::GetTimestamp();
+        event.threadId = context.threadId;
+        mTracer->RecordTask(context.threadId, event);
+    }
+#endif // NFE_ENABLE_TASK_TRACING
+
+    FinishTask(context.taskId, context.threadId);
+}
+
+TaskGroupID ThreadPool::CreateTaskGroup(const char* name, uint32 maxConcurrency)
+{
+    NFE_ASSERT(maxConcurrency > 0, "Task group must allow at least one running task");
+
+    NFE_SCOPED_LOCK(mTaskGroupsMutex);
+
+    const uint32 numGroups = mNumTaskGroups.load(std::memory_order_relaxed);
+    if (numGroups >= MaxTaskGroups)
+    {
+        NFE_LOG_ERROR("Failed to create task group '%s' - maximum number of groups reached", name ? name : "");
+        return InvalidTaskGroupID;
+    }
+
+    UniquePtr<TaskGroup> group = MakeUniquePtr<TaskGroup>();
+    group->name = name ? name : "";
+    group->stats.maxConcurrency = Math::Max(1u, maxConcurrency);
+
+    mTaskGroups[numGroups] = std::move(group);
+    mNumTaskGroups.store(numGroups + 1, std::memory_order_release);
+
+    return static_cast<TaskGroupID>(numGroups);
+}
+
+const char* ThreadPool::GetTaskGroupName(TaskGroupID groupID) const
+{
+    if (groupID >= mNumTaskGroups.load(std::memory_order_acquire))
+    {
+        return nullptr;
+    }
+
+    return mTaskGroups[groupID]->name.Str();
+}
+
+bool ThreadPool::GetTaskGroupStats(TaskGroupID groupID, TaskGroupStats& outStats) const
+{
+    if (groupID >= mNumTaskGroups.load(std::memory_order_acquire))
+    {
+        NFE_LOG_ERROR("Invalid task group ID: %u", static_cast<uint32>(groupID));
+        return false;
+    }
+
+    const TaskGroup& group = *mTaskGroups[groupID];
+    NFE_SCOPED_LOCK(group.mutex);
+    outStats = group.stats;
+    return true;
+}
+
+void ThreadPool::ResetTaskGroupStats(TaskGroupID groupID)
+{
+    if (groupID >= mNumTaskGroups.load(std::memory_order_acquire))
+    {
+        NFE_LOG_ERROR("Invalid task group ID: %u", static_cast<uint32>(groupID));
+        return;
+    }
+
+    TaskGroup& group = *mTaskGroups[groupID];
+    NFE_SCOPED_LOCK(group.mutex);
+
+    TaskGroupStats& stats = group.stats;
+    stats.maxQueueDepth = stats.queueDepth;
+    stats.numExecuted = 0;
+    stats.numDeferred = 0;
+    stats.totalWaitTime = 0.0;
+    stats.maxWaitTime = 0.0;
+}
+
+void ThreadPool::OnGroupTaskStarted(Task& task)
+{
+    const double waitTime = task.mReadyTimer.Stop();
+
+    TaskGroup& group = *mTaskGroups[task.mGroup];
+    NFE_SCOPED_LOCK(group.mutex);
+
+    TaskGroupStats& stats = group.stats;
+    stats.numExecuted++;
+    stats.totalWaitTime += waitTime;
+    stats.maxWaitTime = Math::Max(stats.maxWaitTime, waitTime);
+}
+
+void ThreadPool::OnGroupTaskFinished(TaskGroupID groupID)
+{
+    TaskGroup& group = *mTaskGroups[groupID];
+
+    TaskID nextTaskID = InvalidTaskID;
+    {
+        NFE_SCOPED_LOCK(group.mutex);
+
+        // pass the slot to the next waiting task
+        if (!group.pendingTasks.Empty())
+        {
+            nextTaskID = group.pendingTasks.Front();
+            group.pendingTasks.PopFront();
+            group.stats.queueDepth = group.pendingTasks.Size();
+        }
+        else
+        {
+            NFE_ASSERT(group.stats.numRunning > 0, "Task group's running tasks counter underflow");
+            group.stats.numRunning--;
+        }
+    }
+
+    if (nextTaskID != InvalidTaskID)
+    {
+        PushTaskToQueue(nextTaskID);
+    }
+}
+
+ThreadPool* ThreadPool::GetCurrentThreadPool()
+{
+    if (tCurrentWorker)
+    {
+        return tCurrentWorker->mPool;
+    }
+
+    if (gThreadPool.mOwnerThreadID == Thread::GetCurrentThreadID())
+    {
+        return &gThreadPool;
+    }
+
+    return nullptr;
+}
+
+bool ThreadPool::TryExecuteTask()
+{
+    WorkerThread* thread = tCurrentWorker;
+    if (thread && thread->mPool != this)
+    {
+        thread = nullptr;
+    }
+
+    NFE_ASSERT(thread || mOwnerThreadID == Thread::GetCurrentThreadID(), "Tasks can be executed only on worker threads or on the owner thread");
+
+    TaskContext context;
+    context.pool = this;
+    context.threadId = thread ? thread->mId : mThreads.Size();
+
+    // Long-running tasks (e.g. resource loading in a throttled group) or less important tasks
+    // would delay the waiting thread, so they are left for the worker threads
+    if (!FindTask(thread, context.taskId, tCurrentTaskPriority, false))
+    {
+        return false;
+    }
+
+    ExecuteTask(context);
+    return true;
+}
+
+void ThreadPool::WaitForHelpableTask(Waitable& waitable)
+{
+    const uint32 maxPriority = tCurrentTaskPriority;
+
+    // Note: the enqueuing (or finishing) thread modifies the counters first and then checks number of sleeping helpers,
+    // so either we see the change here, or the other thread sees us sleeping and wakes us up
+    mNumSleepingHelpers.fetch_add(1);
+    {
+        ScopedExclusiveLock<Mutex> lock(mSleepMutex);
+
+        const uint64 wakeUpCounter = mHelpersWakeUpCounter;
+        while (!waitable.IsFinished() && !HasHelpableTasks(maxPriority) && wakeUpCounter == mHelpersWakeUpCounter)
+        {
+            mHelpersCV.Wait(lock);
+        }
+    }
+    mNumSleepingHelpers.fetch_sub(1);
+}
+
+void ThreadPool::WakeUpHelpers()
+{
+    NFE_SCOPED_LOCK(mSleepMutex);
+    mHelpersWakeUpCounter++;
+    mHelpersCV.SignalAll();
+}
+
+bool ThreadPool::FindTask(WorkerThread* thread, TaskID& outTaskID, uint32 maxPriority, bool allowGroupTasks)
+{
+    for (uint32 priority = 0; priority <= maxPriority; ++priority)
+    {
+        if (FindTaskWithPriority(thread, priority, outTaskID))
+        {
+            return true;
+        }
+
+        // tasks of concurrency-limited groups are checked last
+        if (allowGroupTasks && PopSharedTask(thread, GetGroupQueueIndex(), priority, outTaskID))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool ThreadPool::FindTaskWithPriority(WorkerThread* thread, uint32 priority, TaskID& outTaskID)
+{
+    const uint32 anyNodeQueueIndex = mNumNumaNodes;
+
+    if (mNumPendingTasks[priority].value.load(std::memory_order_relaxed) <= 0)
+    {
+        return false;
+    }
+
+    if (thread && thread->mQueues[priority].Pop(outTaskID))
+    {
+        mNumPendingTasks[priority].value.fetch_sub(1);
+        return true;
+    }
+
+    if (thread && PopSharedTask(thread, thread->mNumaNode, priority, outTaskID))
+    {
+        return true;
+    }
+
+    if (PopSharedTask(thread, anyNodeQueueIndex, priority, outTaskID))
+    {
+        return true;
+    }
+
+    if (StealTask(thread, priority, outTaskID))
+    {
+        return true;
+    }
+
+    // finally, take tasks intended for other nodes
+    for (uint32 node = 0; node < mNumNumaNodes; ++node)
+    {
+        if ((!thread || node != thread->mNumaNode) && PopSharedTask(thread, node, priority, outTaskID))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool ThreadPool::PopSharedTask(WorkerThread* thread, uint32 queueIndex, uint32 priority, TaskID& outTaskID)
+{
+    SharedQueue& sharedQueue = *mSharedQueues[queueIndex];
+
+    if (sharedQueue.numTasks[priority].value.load(std::memory_order_relaxed) <= 0)
+    {
+        return false;
+    }
+
+    NFE_SCOPED_LOCK(sharedQueue.mutex);
+
+    Deque<TaskID>& queue = sharedQueue.tasks[priority];
+    if (queue.Empty())
+    {
+        return false;
+    }
+
+    outTaskID = queue.Front();
+    queue.PopFront();
+
+    // move a batch of tasks to the local queue, so other workers can steal them without taking the lock
+    // (but don't move tasks intended for other NUMA nodes)
+    uint32 batchSize = 0;
+    if (thread && (queueIndex == mNumNumaNodes || queueIndex == thread->mNumaNode))
+    {
+        batchSize = Math::Min(queue.Size() / mThreads.Size(), MaxGlobalQueueBatchSize);
+    }
+
+    for (uint32 i = 0; i < batchSize; ++i)
+    {
+        if (!thread->mQueues[priority].Push(queue.Front()))
+        {
+            break;
+        }
+        queue.PopFront();
+    }
+
+    sharedQueue.numTasks[priority].value.store(static_cast<int32>(queue.Size()), std::memory_order_relaxed);
+
+    AlignedCounter* pendingCounters = queueIndex == GetGroupQueueIndex() ? mNumPendingGroupTasks : mNumPendingTasks;
+    pendingCounters[priority].value.fetch_sub(1);
+    return true;
+}
+
+bool ThreadPool::StealTask(WorkerThread* thread, uint32 priority, TaskID& outTaskID)
+{
+    const uint32 numThreads = mThreads.Size();
+
+    // start from a random victim, so the thieves don't compete for the same queue
+    uint32& seedRef = thread ? thread->mRandomSeed : tRandomSeed;
+    uint32 seed = seedRef;
+    seed ^= seed << 13u;
+    seed ^= seed >> 17u;
+    seed ^= seed << 5u;
+    seedRef = seed;
+
+    // steal from workers of the same NUMA node first
+    const bool hasMultipleNodes = mNumNumaNodes > 1 && thread;
+    for (uint32 pass = 0; pass < (hasMultipleNodes ? 2u : 1u); ++pass)
+    {
+        uint32 victimIndex = seed % numThreads;
+        for (uint32 i = 0; i < numThreads; ++i)
+        {
+            WorkerThread* victim = mThreads[victimIndex].Get();
+
+            if (++victimIndex == numThreads)
             {
-                const Task::State oldState = task->mState.exchange(Task::State::Executing);
-                NFE_ASSERT(Task::State::Queued == oldState, "Task is expected to be in 'Queued' state");
+                victimIndex = 0;
             }
 
-            // execute
-            task->mCallback(context);
+            if (victim == thread)
+            {
+                continue;
+            }
+
+            if (hasMultipleNodes && (victim->mNumaNode == thread->mNumaNode) != (pass == 0))
+            {
+                continue;
+            }
 
-            // Executing -> Finished
+            WorkStealingQueue<TaskID, WorkerThread::LocalQueueCapacity>& queue = victim->mQueues[priority];
+            if (!queue.Empty() && queue.Steal(outTaskID))
             {
-                const Task::State oldState = task->mState.exchange(Task::State::Finished);
-                NFE_ASSERT(Task::State::Executing == oldState, "Task is expected to be in 'Executing' state");
+                mNumPendingTasks[priority].value.fetch_sub(1);
+                return true;
             }
         }
-        else
+    }
+
+    return false;
+}
+
+bool ThreadPool::HasPendingTasks() const
+{
+    for (uint32 priority = 0; priority < NumPriorities; ++priority)
+    {
+        if (mNumPendingTasks[priority].value.load() > 0 || mNumPendingGroupTasks[priority].value.load() > 0)
         {
-            // Queued -> Finished
+            return true;
+        }
+    }
 
-            const Task::State oldState = task->mState.exchange(Task::State::Finished);
-            NFE_ASSERT(Task::State::Queued == oldState, "Task is expected to be in 'Queued' state");
+    return false;
+}
+
+bool ThreadPool::HasHelpableTasks(uint32 maxPriority) const
+{
+    for (uint32 priority = 0; priority <= maxPriority; ++priority)
+    {
+        if (mNumPendingTasks[priority].value.load() > 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ThreadPool::WaitForTask(WorkerThread* thread)
+{
+    // new tasks are often enqueued shortly after, so don't go to sleep immediately
+    for (uint32 i = 0; i < NumSpinsBeforeSleep; ++i)
+    {
+        if (!thread->mStarted || HasPendingTasks())
+        {
+            return;
+        }
+
+        Thread::YieldCurrentThread();
+    }
+
+    // Note: the enqueuing thread increments pending tasks counter first and then checks number of sleeping threads,
+    // so either we see the new task here, or the enqueuing thread sees us sleeping and wakes us up
+    mNumSleepingThreads.fetch_add(1);
+
+    if (!HasPendingTasks())
+    {
+        ScopedExclusiveLock<Mutex> lock(mSleepMutex);
+
+        while (thread->mStarted && mNumWakeUpTokens == 0)
+        {
+            mSleepCV.Wait(lock);
         }
 
-        FinishTask(context.taskId);
+        if (mNumWakeUpTokens > 0)
+        {
+            mNumWakeUpTokens--;
+        }
     }
+
+    mNumSleepingThreads.fetch_sub(1);
+}
+
+void ThreadPool::WakeUpWorker()
+{
+    NFE_SCOPED_LOCK(mSleepMutex);
+
+    // a worker can go back to work on its own, without consuming a token, so limit the number of tokens
+    if (mNumWakeUpTokens < mThreads.Size())
+    {
+        mNumWakeUpTokens++;
+    }
+
+    mSleepCV.SignalOne();
 }
 
-void ThreadPool::FinishTask(TaskID taskID)
+void ThreadPool::FinishTask(TaskID taskID, uint32 threadId)
 {
+    NFE_UNUSED(threadId);
+
     TaskID taskToFinish = taskID;
 
     // Note: loop instead of recursion to avoid stack overflow in case of long dependency chains
     while (taskToFinish != InvalidTaskID)
     {
-        TaskID parentTask;
-        Waitable* waitable = nullptr;
+        Task& task = GetTask(taskToFinish);
 
+        const int32 tasksLeft = --task.mTasksLeft;
+        NFE_ASSERT(tasksLeft >= 0, "Tasks counter underflow");
+        if (tasksLeft > 0)
         {
-            NFE_SCOPED_LOCK(mTaskListMutex); // TODO lockless
+            return;
+        }
 
-            Task& task = mTasks[taskToFinish];
+        const TaskID parentTask = task.mParent;
+        Waitable* waitable = task.mWaitable;
 
-            parentTask = task.mParent;
-            waitable = task.mWaitable;
+        // close the dependent tasks list and notify about fullfilling the dependency
+        {
+            TaskID link = task.mHead.exchange(Task::ClosedListTaskID);
+            NFE_ASSERT(link != Task::ClosedListTaskID, "Task finished twice");
 
-            const int32 tasksLeft = --task.mTasksLeft;
-            NFE_ASSERT(tasksLeft >= 0, "Tasks counter underflow");
-            if (tasksLeft > 0)
+            while (link != InvalidTaskID)
             {
-                return;
-            }
+                // Note: the sibling can be executed and freed right after its dependency is fullfilled
+                const TaskID siblingID = Task::GetLinkTask(link);
+                const TaskID nextLink = GetTask(siblingID).mSiblings[Task::GetLinkSlot(link)];
 
-            // notify about fullfilling the dependency
-            {
-                TaskID siblingID = task.mHead;
-                while (siblingID != InvalidTaskID)
+#ifdef NFE_ENABLE_TASK_TRACING
+                const uint64 siblingTraceId = GetTask(siblingID).mTraceInfo.id;
+                if (task.mTraceInfo.id && siblingTraceId)
                 {
-                    OnTaskDependencyFullfilled_NoLock(siblingID);
-                    siblingID = mTasks[siblingID].mSibling;
+                    mTracer->RecordDependency(threadId, task.mTraceInfo.id, siblingTraceId);
                 }
-            }
+#endif // NFE_ENABLE_TASK_TRACING
 
-            FreeTask_NoLock(taskToFinish);
+                OnTaskDependencyFullfilled(siblingID);
+                link = nextLink;
+            }
         }
 
+        FreeTask(taskToFinish);
+
         // notify waitable object
         if (waitable)
         {
             waitable->OnFinished();
+
+            // the waiting thread could go to sleep while helping with tasks
+            if (mNumSleepingHelpers.load() > 0)
+            {
+                WakeUpHelpers();
+            }
         }
 
         // update parent (without recursion)
@@ -236,61 +802,129 @@ void ThreadPool::FinishTask(TaskID taskID)
     }
 }
 
-void ThreadPool::EnqueueTaskInternal_NoLock(TaskID taskID)
+void ThreadPool::EnqueueTaskInternal(TaskID taskID)
 {
-    Task& task = mTasks[taskID];
+    Task& task = GetTask(taskID);
 
     const Task::State oldState = task.mState.exchange(Task::State::Queued);
     NFE_ASSERT(Task::State::Created == oldState, "Task is expected to be in 'Created' state");
     NFE_ASSERT((Task::Flag_IsDispatched | Task::Flag_DependencyFullfilled) == task.mDependencyState, "Invalid dependency state");
 
-    // push to queue
+#ifdef NFE_ENABLE_TASK_TRACING
+    if (task.mTraceInfo.id)
+    {
+        task.mTraceInfo.queueTime = TaskTracer::GetTimestamp();
+    }
+#endif // NFE_ENABLE_TASK_TRACING
+
+    if (task.mGroup != InvalidTaskGroupID)
     {
-        ScopedExclusiveLock<Mutex> lock(mTasksQueueMutex);
-        mTasksQueues[task.mPriority].PushBack(taskID);
-        mTaskQueueCV.SignalAll();
+        task.mReadyTimer.Start();
+
+        TaskGroup& group = *mTaskGroups[task.mGroup];
+        NFE_SCOPED_LOCK(group.mutex);
+
+        TaskGroupStats& stats = group.stats;
+        if (stats.numRunning >= stats.maxConcurrency)
+        {
+            // limit reached - the task will be pushed to the queue when one of the group's tasks finishes
+            group.pendingTasks.PushBack(taskID);
+            stats.queueDepth = group.pendingTasks.Size();
+            stats.maxQueueDepth = Math::Max(stats.maxQueueDepth, stats.queueDepth);
+            stats.numDeferred++;
+            return;
+        }
+
+        stats.numRunning++;
     }
+
+    PushTaskToQueue(taskID);
 }
 
-void ThreadPool::FreeTask_NoLock(TaskID taskID)
+void ThreadPool::PushTaskToQueue(TaskID taskID)
 {
-    NFE_ASSERT(taskID < mTasks.Size(), "Invalid task ID");
+    Task& task = GetTask(taskID);
+
+    const uint32 priority = task.mPriority;
+    const bool isGroupTask = task.mGroup != InvalidTaskGroupID;
+    (isGroupTask ? mNumPendingGroupTasks : mNumPendingTasks)[priority].value.fetch_add(1);
+
+    // tasks enqueued by a worker thread go to its local queue (if the locality hint allows),
+    // other threads use the shared queue
+    // tasks of concurrency-limited groups always go to a separate shared queue (ignoring the locality hint),
+    // so threads helping while waiting can skip them
+    WorkerThread* worker = tCurrentWorker;
+    bool pushed = false;
+    if (!isGroupTask && worker && worker->mPool == this && (task.mNumaNode == mNumNumaNodes || task.mNumaNode == worker->mNumaNode))
+    {
+        pushed = worker->mQueues[priority].Push(taskID);
+    }
 
-    Task& task = mTasks[taskID];
+    if (!pushed)
+    {
+        SharedQueue& sharedQueue = *mSharedQueues[isGroupTask ? GetGroupQueueIndex() : task.mNumaNode];
+        NFE_SCOPED_LOCK(sharedQueue.mutex);
+        sharedQueue.tasks[priority].PushBack(taskID);
+        sharedQueue.numTasks[priority].value.store(static_cast<int32>(sharedQueue.tasks[priority].Size()), std::memory_order_relaxed);
+    }
+
+    // targeted wakeup - only a single sleeping worker is notified about the new task
+    if (mNumSleepingThreads.load() > 0)
+    {
+        WakeUpWorker();
+    }
+
+    if (!isGroupTask && mNumSleepingHelpers.load() > 0)
+    {
+        WakeUpHelpers();
+    }
+}
+
+void ThreadPool::FreeTask(TaskID taskID)
+{
+    Task& task = GetTask(taskID);
 
     const Task::State oldState = task.mState.exchange(Task::State::Invalid);
     NFE_ASSERT(Task::State::Finished == oldState, "Task is expected to be in 'Finished' state");
 
-    task.mNextFree = mFirstFreeTask;
-    mFirstFreeTask = taskID;
+    PushFreeTasks(taskID, taskID);
 }
 
-TaskID ThreadPool::AllocateTask_NoLock()
+TaskID ThreadPool::AllocateTask()
 {
-    if (mFirstFreeTask == InvalidTaskID)
+    uint64 oldHead = mFreeTasksHead.load(std::memory_order_acquire);
+    for (;;)
     {
-        return InvalidTaskID;
-    }
-
-    Task& task = mTasks[mFirstFreeTask];
+        const TaskID taskID = static_cast<TaskID>(oldHead);
+        if (taskID == InvalidTaskID)
+        {
+            // free list is empty - grow the tasks table
+            if (!AllocateTasksPage())
+            {
+                return InvalidTaskID;
+            }
 
-    const Task::State oldState = task.mState.exchange(Task::State::Queued);
-    NFE_ASSERT(Task::State::Invalid == oldState, "Task is expected to be in 'Invalid' state");
+            oldHead = mFreeTasksHead.load(std::memory_order_acquire);
+            continue;
+        }
 
-    TaskID newNextFree = task.mNextFree;
-    TaskID taskID = mFirstFreeTask;
-    mFirstFreeTask = newNextFree;
-    return taskID;
+        // Note: the task can be popped by other thread in the meantime, but the tag will not match then
+        const TaskID nextFree = GetTask(taskID).mNextFree.load(std::memory_order_relaxed);
+        const uint64 newTag = (oldHead >> 32) + 1;
+        const uint64 newHead = (newTag << 32) | nextFree;
+        if (mFreeTasksHead.compare_exchange_weak(oldHead, newHead, std::memory_order_acquire, std::memory_order_acquire))
+        {
+            return taskID;
+        }
+    }
 }
 
 TaskID ThreadPool::CreateTask(const TaskDesc& desc)
 {
     NFE_ASSERT(desc.priority < NumPriorities, "Invalid priority");
+    NFE_ASSERT(desc.group == InvalidTaskGroupID || desc.group < mNumTaskGroups.load(std::memory_order_acquire), "Invalid task group");
 
-    // TODO lockless
-    NFE_SCOPED_LOCK(mTaskListMutex);
-
-    TaskID taskID = AllocateTask_NoLock();
+    TaskID taskID = AllocateTask();
     NFE_ASSERT(taskID != InvalidTaskID, "Failed to allocate task - is threadpool full?");
 
     if (taskID == InvalidTaskID)
@@ -298,67 +932,118 @@ TaskID ThreadPool::CreateTask(const TaskDesc& desc)
         return InvalidTaskID;
     }
 
-    Task& task = mTasks[taskID];
+    Task& task = GetTask(taskID);
     task.Reset();
-    task.mDependencyState = 0;
     task.mPriority = desc.priority;
+    task.mNumaNode = static_cast<uint8>(desc.numaNode < mNumNumaNodes ? desc.numaNode : mNumNumaNodes);
     task.mTasksLeft = 1;
     task.mCallback = desc.function;
     task.mParent = desc.parent;
-    task.mDependency = desc.dependency;
     task.mWaitable = desc.waitable;
-    task.mHead = InvalidTaskID;
-    task.mState = Task::State::Created;
+    if (desc.waitable)
+    {
+        desc.waitable->mPool.store(this);
+    }
     task.mDebugName = desc.debugName;
+    task.mGroup = desc.group;
+    task.mMemoryTag = AllocationTracker::GetCurrentTag();
 
-    if (desc.parent != InvalidTaskID)
+#ifdef NFE_ENABLE_TASK_TRACING
+    if (mTracer->IsEnabled())
     {
-        mTasks[desc.parent].mTasksLeft++;
+        task.mTraceInfo.id = mTracer->GenerateTaskId();
+        task.mTraceInfo.parentId = desc.parent != InvalidTaskID ? GetTask(desc.parent).mTraceInfo.id : 0;
+        task.mTraceInfo.createTime = TaskTracer::GetTimestamp();
     }
+#endif // NFE_ENABLE_TASK_TRACING
 
-    TaskID dependencyID = mTasks[taskID].mDependency;
+    const Task::State oldState = task.mState.exchange(Task::State::Created);
+    NFE_ASSERT(Task::State::Invalid == oldState, "Task is expected to be in 'Invalid' state");
 
-    bool dependencyFullfilled = true;
-    if (dependencyID != InvalidTaskID)
+    if (desc.parent != InvalidTaskID)
     {
-        Task& dependency = mTasks[dependencyID];
+        Task& parent = GetTask(desc.parent);
+        NFE_ASSERT(Task::State::Invalid != parent.mState, "Invalid state of parent task");
+        parent.mTasksLeft++;
+    }
 
-        NFE_ASSERT(Task::State::Invalid != dependency.mState, "Invalid state of dependency task");
+    // Note: the counter is held at non-zero value until all the dependencies are registered
+    task.mDependenciesLeft = 1;
 
-        //NFE_SCOPED_LOCK(mFinishedTasksMutex); // TODO: how to get rid of it?
-        if (dependency.mTasksLeft > 0)
-        {
-            // update dependency list
-            if (dependency.mTail != InvalidTaskID)
-            {
-                mTasks[dependency.mTail].mSibling = taskID;
-            }
-            else
-            {
-                dependency.mHead = taskID;
-            }
+    const uint32 numDependencies = (desc.dependency != InvalidTaskID ? 1u : 0u) + desc.dependencies.Size();
+    const uint32 numDirectDependencies = numDependencies > Task::MaxDependencies ? Task::MaxDependencies - 1u : numDependencies;
 
-            dependency.mTail = taskID;
-            dependencyFullfilled = false;
+    for (uint32 i = 0; i < numDirectDependencies; ++i)
+    {
+        if (desc.dependency != InvalidTaskID)
+        {
+            AddDependency(taskID, i, i == 0 ? desc.dependency : desc.dependencies[i - 1]);
+        }
+        else
+        {
+            AddDependency(taskID, i, desc.dependencies[i]);
         }
     }
 
-    if (dependencyFullfilled)
+    // the remaining dependencies are merged into a join task (it can recursively spawn more join tasks)
+    if (numDirectDependencies < numDependencies)
+    {
+        const uint32 offset = numDirectDependencies - (desc.dependency != InvalidTaskID ? 1u : 0u);
+
+        TaskDesc joinDesc;
+        joinDesc.debugName = "ThreadPool::Join";
+        joinDesc.priority = desc.priority;
+        joinDesc.dependencies = ArrayView<const TaskID>(desc.dependencies.Data() + offset, desc.dependencies.Size() - offset);
+
+        const TaskID joinTask = CreateTask(joinDesc);
+        AddDependency(taskID, numDirectDependencies, joinTask);
+        DispatchTask(joinTask);
+    }
+
+    // Note: if the task was appended to any list, the flag is set when the last dependency finishes
+    if (--task.mDependenciesLeft == 0)
     {
-        task.mDependencyState = Task::Flag_DependencyFullfilled;
+        task.mDependencyState.fetch_or(Task::Flag_DependencyFullfilled);
     }
 
     return taskID;
 }
 
+void ThreadPool::AddDependency(TaskID taskID, uint32 slot, TaskID dependencyID)
+{
+    NFE_ASSERT(slot < Task::MaxDependencies, "Invalid dependency slot");
+
+    if (dependencyID == InvalidTaskID)
+    {
+        return;
+    }
+
+    Task& task = GetTask(taskID);
+    Task& dependency = GetTask(dependencyID);
+    NFE_ASSERT(Task::State::Invalid != dependency.mState, "Invalid state of dependency task");
+
+    // Note: must be incremented before appending, because the dependency can finish right after that
+    task.mDependenciesLeft++;
+
+    TaskID head = dependency.mHead.load();
+    while (head != Task::ClosedListTaskID)
+    {
+        task.mSiblings[slot] = head;
+        if (dependency.mHead.compare_exchange_weak(head, Task::MakeLink(taskID, slot)))
+        {
+            return;
+        }
+    }
+
+    // dependency is already finished
+    task.mDependenciesLeft--;
+}
+
 void ThreadPool::DispatchTask(TaskID taskID)
 {
     NFE_ASSERT(taskID != InvalidTaskID, "Invalid task");
 
-    // TODO lockless
-    NFE_SCOPED_LOCK(mTaskListMutex);
-
-    Task& task = mTasks[taskID];
+    Task& task = GetTask(taskID);
 
     NFE_ASSERT(Task::State::Created == task.mState, "Task is expected to be in 'Created' state");
 
@@ -369,18 +1054,25 @@ void ThreadPool::DispatchTask(TaskID taskID)
     // can enqueue only if not dispatched yet, but dependency was fullfilled
     if (Task::Flag_DependencyFullfilled == oldDependencyState)
     {
-        EnqueueTaskInternal_NoLock(taskID);
+        EnqueueTaskInternal(taskID);
     }
 }
 
-void ThreadPool::OnTaskDependencyFullfilled_NoLock(TaskID taskID)
+void ThreadPool::OnTaskDependencyFullfilled(TaskID taskID)
 {
     NFE_ASSERT(taskID != InvalidTaskID, "Invalid task");
 
-    Task& task = mTasks[taskID];
+    Task& task = GetTask(taskID);
 
     NFE_ASSERT(Task::State::Created == task.mState, "Task is expected to be in 'Created' state");
 
+    const int32 dependenciesLeft = --task.mDependenciesLeft;
+    NFE_ASSERT(dependenciesLeft >= 0, "Dependencies counter underflow");
+    if (dependenciesLeft > 0)
+    {
+        return;
+    }
+
     const uint8 oldDependencyState = task.mDependencyState.fetch_or(Task::Flag_DependencyFullfilled);
 
     NFE_ASSERT((oldDependencyState & Task::Flag_DependencyFullfilled) == 0, "Task should not have dependency fullfilled");
@@ -388,7 +1080,7 @@ void ThreadPool::OnTaskDependencyFullfilled_NoLock(TaskID taskID)
     // can enqueue only if was dispatched
     if (Task::Flag_IsDispatched == oldDependencyState)
     {
-        EnqueueTaskInternal_NoLock(taskID);
+        EnqueueTaskInternal(taskID);
     }
 }
 
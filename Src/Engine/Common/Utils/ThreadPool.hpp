@@ -8,11 +8,15 @@
 
 #include "../nfCommon.hpp"
 #include "ThreadPoolTask.hpp"
+#include "TaskTracer.hpp"
+#include "WorkStealingQueue.hpp"
 #include "../System/ConditionVariable.hpp"
 #include "../System/Thread.hpp"
 #include "../Containers/UniquePtr.hpp"
 #include "../Containers/DynArray.hpp"
+#include "../Containers/ArrayView.hpp"
 #include "../Containers/Deque.hpp"
+#include "../Containers/String.hpp"
 
 #include <inttypes.h>
 
@@ -35,43 +39,60 @@ struct TaskDesc
     // dependency task (optional)
     TaskID dependency = InvalidTaskID;
 
+    // additional dependency tasks (optional)
+    // The task starts when all of the dependencies are finished. Invalid IDs are ignored.
+    // NOTE: the array is accessed only during ThreadPool::CreateTask call
+    ArrayView<const TaskID> dependencies;
+
     // Specifies target queue
     // Task with higher priority are always popped from the queues first.
     // Valid range is 0...(ThreadPool::NumPriorities-1)
     uint8 priority = 1;
 
+    // Locality hint - NUMA node the task should be executed on (optional)
+    // Worker threads of the node execute such tasks first, but other threads can still pick them up when idle.
+    // Valid range is 0...(ThreadPool::GetNumNumaNodes()-1)
+    uint8 numaNode = AnyNumaNode;
+
     const char* debugName = nullptr;
 
-    // TODO limiting number of parallel running tasks of certain type
-    // (eg. long-running resource loading tasks)
+    // Concurrency-limited group the task belongs to (optional, see ThreadPool::CreateTaskGroup)
+    // If the group's limit of running tasks is reached, the task waits in the group's queue without occupying a worker.
+    TaskGroupID group = InvalidTaskGroupID;
 
     NFE_INLINE TaskDesc() = default;
     NFE_INLINE TaskDesc(const TaskFunction& func) : function(func) { }
 };
 
-// Thread pool's worker thread
-class WorkerThread
+// Task group statistics (see ThreadPool::GetTaskGroupStats).
+struct TaskGroupStats
 {
-    friend class ThreadPool;
-
-    NFE_MAKE_NONCOPYABLE(WorkerThread)
-    NFE_MAKE_NONMOVEABLE(WorkerThread)
-
-    Thread mThread;
-    uint32 mId;                     // thread number
-    std::atomic<bool> mStarted;     // if set to false, exit the thread
-
-public:
-    WorkerThread(ThreadPool* pool, uint32 id);
-    ~WorkerThread();
+    uint32 maxConcurrency = 0;
+    uint32 numRunning = 0;          // tasks being executed right now
+    uint32 queueDepth = 0;          // ready tasks waiting for a free slot in the group
+    uint32 maxQueueDepth = 0;
+    uint64 numExecuted = 0;
+    uint64 numDeferred = 0;         // tasks that had to wait in the group's queue
+    double totalWaitTime = 0.0;     // time between becoming ready and starting execution (in seconds)
+    double maxWaitTime = 0.0;
+
+    NFE_FORCE_INLINE double GetAverageWaitTime() const
+    {
+        return numExecuted > 0 ? totalWaitTime / static_cast<double>(numExecuted) : 0.0;
+    }
 };
 
+class WorkerThread;
 using WorkerThreadPtr = UniquePtr<WorkerThread>;
 
 
 /**
  * @class ThreadPool
  * @brief Class enabling parallel tasks execution.
+ *
+ * Each worker thread owns a lock-free queue per priority. Tasks enqueued by a worker thread
+ * are pushed to its own queue, tasks enqueued by other threads go to a global queue.
+ * Idle workers steal tasks from other workers' queues and sleep only if there are no pending tasks.
  */
 class NFCOMMON_API ThreadPool final
 {
@@ -81,17 +102,81 @@ class NFCOMMON_API ThreadPool final
 
 public:
 
-    static constexpr uint32 TasksCapacity = 1024 * 128;
+    // tasks table grows on demand by pages of fixed size (existing pages are never moved)
+    static constexpr uint32 TasksPageSizeBits = 12;
+    static constexpr uint32 TasksPageSize = 1u << TasksPageSizeBits;
+    static constexpr uint32 MaxTasksPages = 1024;
+    static constexpr uint32 TasksCapacity = TasksPageSize * MaxTasksPages;
     static constexpr uint32 NumPriorities = 3;
     static constexpr uint32 MaxPriority = NumPriorities - 1;
+    static constexpr uint32 MaxTaskGroups = 64;
+
+    static_assert(TasksCapacity <= (1u << Task::LinkSlotShift), "Task ID does not fit dependency list link");
 
     ThreadPool();
+
+    // Create thread pool with given number of worker threads (0 means one thread per logical CPU).
+    explicit ThreadPool(uint32 numThreads);
+
     ~ThreadPool();
 
     static ThreadPool& GetInstance();
 
+    // Get number of threads that can execute tasks (worker threads and the thread that created the pool).
+    // Thread IDs passed via TaskContext are in [0, GetNumThreads()) range.
+    NFE_FORCE_INLINE uint32 GetNumThreads() const { return mThreads.Size() + 1; }
+
     // Get number of worker threads in the pool.
-    NFE_FORCE_INLINE uint32 GetNumThreads() const { return mThreads.Size(); }
+    NFE_FORCE_INLINE uint32 GetNumWorkerThreads() const { return mThreads.Size(); }
+
+    // Get thread pool which tasks can be executed on the calling thread:
+    // the pool owning the calling worker thread, or the global pool if called on the thread that created it.
+    // Returns nullptr for other threads.
+    static ThreadPool* GetCurrentThreadPool();
+
+    // Get number of NUMA nodes that worker threads are assigned to.
+    NFE_FORCE_INLINE uint32 GetNumNumaNodes() const { return mNumNumaNodes; }
+
+    // Get NUMA node of a thread (by thread ID from TaskContext).
+    uint32 GetThreadNumaNode(uint32 threadId) const;
+
+    // Get number of worker threads assigned to a NUMA node.
+    uint32 GetNumNodeWorkerThreads(uint32 numaNode) const;
+
+    // Pin worker threads to logical cores assigned to them.
+    // Workers are assigned to cores of one NUMA node first, using distinct physical cores before SMT siblings.
+    bool PinWorkerThreads();
+
+    // Create a named group of tasks with limited number of concurrently running tasks (eg. long-running resource loading).
+    // Excess tasks of the group are queued without blocking worker threads.
+    // Returns InvalidTaskGroupID if the maximum number of groups is reached.
+    // NOTE This function is thread-safe.
+    TaskGroupID CreateTaskGroup(const char* name, uint32 maxConcurrency);
+
+    // Get task group's name.
+    const char* GetTaskGroupName(TaskGroupID groupID) const;
+
+    // Get task group's statistics (queue depth, wait times, etc.).
+    bool GetTaskGroupStats(TaskGroupID groupID, TaskGroupStats& outStats) const;
+
+    // Reset task group's accumulated statistics (current number of running and queued tasks is preserved).
+    void ResetTaskGroupStats(TaskGroupID groupID);
+
+    // Execute a single pending task on the calling thread (used for helping while waiting).
+    // Only tasks that can't delay the waiting thread much are executed: tasks of concurrency-limited groups
+    // and tasks with lower priority than the task being executed on the calling thread are skipped.
+    // Returns false if there was no task to execute.
+    // NOTE: Can be called only on pool's worker threads or on the thread that created the pool.
+    // NOTE: The task runs with the same thread ID as the task that is waiting (if called from a task).
+    bool TryExecuteTask();
+
+    // Sleep until a task that can be executed via TryExecuteTask is enqueued or the waitable object is finished.
+    void WaitForHelpableTask(Waitable& waitable);
+
+#ifdef NFE_ENABLE_TASK_TRACING
+    // Get tasks execution tracer (tracing has to be started explicitly).
+    NFE_FORCE_INLINE TaskTracer& GetTracer() { return *mTracer; }
+#endif // NFE_ENABLE_TASK_TRACING
 
     // Create a new task.
     // The task will not be queued immidiately - it has to be queued manually via DispatchTask call
@@ -109,30 +194,159 @@ public:
 
 private:
 
+    // cache line aligned counter (avoids false sharing between frequently modified counters)
+    struct NFE_ALIGN(NFE_CACHE_LINE_SIZE) AlignedCounter
+    {
+        std::atomic<int32> value;
+
+        AlignedCounter() : value(0) { }
+    };
+
+    // concurrency-limited group of tasks
+    struct TaskGroup
+    {
+        String name;
+        TaskGroupStats stats;
+        Deque<TaskID> pendingTasks;     // ready tasks waiting for a free slot
+        mutable Mutex mutex;
+    };
+
     void SchedulerCallback(WorkerThread* thread);
+    void ExecuteTask(const TaskContext& context);
+
+    // find a task to execute, checking the priorities from the highest one up to 'maxPriority'
+    // for each priority: own queue -> global queue -> other workers' queues -> task groups queue
+    // NOTE: "thread" is null when called on the pool's owner thread
+    bool FindTask(WorkerThread* thread, TaskID& outTaskID, uint32 maxPriority, bool allowGroupTasks);
+    bool FindTaskWithPriority(WorkerThread* thread, uint32 priority, TaskID& outTaskID);
+    bool PopSharedTask(WorkerThread* thread, uint32 queueIndex, uint32 priority, TaskID& outTaskID);
+    bool StealTask(WorkerThread* thread, uint32 priority, TaskID& outTaskID);
+
+    bool HasPendingTasks() const;
+
+    // check if there are tasks that can be executed via TryExecuteTask
+    bool HasHelpableTasks(uint32 maxPriority) const;
 
-    TaskID AllocateTask_NoLock();
-    void FreeTask_NoLock(TaskID taskID);
-    void FinishTask(TaskID taskID);
-    void EnqueueTaskInternal_NoLock(TaskID taskID);
-    void OnTaskDependencyFullfilled_NoLock(TaskID taskID);
+    // spin for a while and then sleep until a new task is enqueued
+    void WaitForTask(WorkerThread* thread);
 
-    // create "num" additional worker threads
+    // wake up a single sleeping worker thread
+    void WakeUpWorker();
+
+    // wake up all threads sleeping in WaitForHelpableTask
+    void WakeUpHelpers();
+
+    // shared queue for ready tasks of concurrency-limited groups (not executed by threads helping while waiting)
+    NFE_FORCE_INLINE uint32 GetGroupQueueIndex() const { return mNumNumaNodes + 1; }
+
+    NFE_FORCE_INLINE Task& GetTask(TaskID taskID) const
+    {
+        NFE_ASSERT(taskID < TasksCapacity, "Invalid task ID");
+        Task* page = mTasksPages[taskID >> TasksPageSizeBits].load(std::memory_order_acquire);
+        NFE_ASSERT(page, "Invalid task ID");
+        return page[taskID & (TasksPageSize - 1)];
+    }
+
+    TaskID AllocateTask();
+    void FreeTask(TaskID taskID);
+    void FinishTask(TaskID taskID, uint32 threadId);
+    void EnqueueTaskInternal(TaskID taskID);
+    void PushTaskToQueue(TaskID taskID);
+
+    // called when a task of a group starts/ends execution
+    void OnGroupTaskStarted(Task& task);
+    void OnGroupTaskFinished(TaskGroupID groupID);
+    void OnTaskDependencyFullfilled(TaskID taskID);
+
+    // append task to the dependency's list of dependent tasks (unless the dependency is already finished)
+    void AddDependency(TaskID taskID, uint32 slot, TaskID dependencyID);
+
+    // push a list of free tasks (linked via Task::mNextFree) to the free list
+    void PushFreeTasks(TaskID first, TaskID last);
+
+    // create "num" worker threads (can be called only once)
     void SpawnWorkerThreads(uint32 num);
 
-    bool InitTasksTable(uint32 newSize);
+    // allocate new page of tasks and put them to the free list
+    bool AllocateTasksPage();
 
     // Worker threads variables:
     DynArray<WorkerThreadPtr> mThreads;
 
-    // queues for tasks with "Queued" state
-    Deque<TaskID> mTasksQueues[NumPriorities];
-    Mutex mTasksQueueMutex;                 //< lock for "mTasksQueue" access
-    ConditionVariable mTaskQueueCV;         //< CV for notifying about a new task in the queue
+    // thread that created the pool (it can help executing tasks while waiting)
+    uint32 mOwnerThreadID;
 
-    Mutex mTaskListMutex;
-    DynArray<Task> mTasks; // TODO growable fixed-size allocator
-    TaskID mFirstFreeTask;
+    // number of tasks with "Queued" state (in global and local queues)
+    AlignedCounter mNumPendingTasks[NumPriorities];
+
+    // number of tasks of concurrency-limited groups with "Queued" state (not included in mNumPendingTasks)
+    AlignedCounter mNumPendingGroupTasks[NumPriorities];
+
+    // queues for tasks enqueued outside of worker threads or with a locality hint
+    struct SharedQueue
+    {
+        Deque<TaskID> tasks[NumPriorities];
+        AlignedCounter numTasks[NumPriorities];
+        Mutex mutex;
+    };
+
+    // one shared queue per NUMA node + one for tasks without locality hint + the last one for task groups
+    DynArray<UniquePtr<SharedQueue>> mSharedQueues;
+    uint32 mNumNumaNodes;
+
+    // task groups (never removed, so they can be accessed without locking the list)
+    UniquePtr<TaskGroup> mTaskGroups[MaxTaskGroups];
+    std::atomic<uint32> mNumTaskGroups;
+    Mutex mTaskGroupsMutex;
+
+#ifdef NFE_ENABLE_TASK_TRACING
+    UniquePtr<TaskTracer> mTracer;
+#endif // NFE_ENABLE_TASK_TRACING
+
+    // sleeping worker threads
+    Mutex mSleepMutex;
+    ConditionVariable mSleepCV;             //< CV for waking up sleeping workers
+    uint32 mNumWakeUpTokens;                //< number of workers allowed to wake up
+    std::atomic<uint32> mNumSleepingThreads;
+
+    // threads waiting for a Waitable that went to sleep because there was nothing to help with
+    ConditionVariable mHelpersCV;
+    uint64 mHelpersWakeUpCounter;           //< incremented on every wake up (protected by mSleepMutex)
+    std::atomic<uint32> mNumSleepingHelpers;
+
+    // tasks table
+    std::atomic<Task*> mTasksPages[MaxTasksPages];
+    uint32 mNumTasksPages;
+    Mutex mTasksPagesMutex;
+
+    // lock-free list of free tasks
+    // lower 32 bits contain the first free task ID, upper 32 bits contain a tag preventing ABA problem
+    std::atomic<uint64> mFreeTasksHead;
+};
+
+// Thread pool's worker thread
+class WorkerThread
+{
+    friend class ThreadPool;
+
+    NFE_MAKE_NONCOPYABLE(WorkerThread)
+    NFE_MAKE_NONMOVEABLE(WorkerThread)
+
+    static constexpr uint32 LocalQueueCapacity = 4096;
+
+    WorkStealingQueue<TaskID, LocalQueueCapacity> mQueues[ThreadPool::NumPriorities];
+
+    ThreadPool* mPool;
+    Thread mThread;
+    uint32 mId;                     // thread number
+    uint32 mLogicalCoreId;          // logical processor assigned to the thread
+    uint32 mNumaNode;               // NUMA node of the assigned logical processor
+    uint32 mRandomSeed;             // used for picking a victim for stealing
+    std::atomic<bool> mStarted;     // if set to false, exit the thread
+
+public:
+    WorkerThread(ThreadPool* pool, uint32 id);
+    ~WorkerThread();
 };
 
 } // namespace Common
@@ -21,24 +21,21 @@ void Task::Reset()
     mDependencyState = 0;
     mTasksLeft = 0;
     mParent = InvalidTaskID;
-    mDependency = InvalidTaskID;
+    mNextFree = InvalidTaskID;
     mHead = InvalidTaskID;
-    mTail = InvalidTaskID;
-    mSibling = InvalidTaskID;
+    mDependenciesLeft = 0;
+    for (TaskID& sibling : mSiblings)
+    {
+        sibling = InvalidTaskID;
+    }
     mWaitable = nullptr;
     mDebugName = nullptr;
-}
+    mGroup = InvalidTaskGroupID;
+    mMemoryTag = AllocationTracker::UntaggedTag;
 
-Task::Task(Task&& other)
-{
-    mState = other.mState.load();
-    mTasksLeft = other.mTasksLeft.load();
-    mParent = other.mParent;
-    mDependency = other.mDependency;
-    mHead = other.mHead;
-    mTail = other.mTail;
-    mSibling = other.mSibling;
-    mWaitable = other.mWaitable;
+#ifdef NFE_ENABLE_TASK_TRACING
+    mTraceInfo = TaskTraceInfo();
+#endif // NFE_ENABLE_TASK_TRACING
 }
 
 } // namespace Common
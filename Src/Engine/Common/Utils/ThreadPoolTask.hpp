@@ -9,12 +9,20 @@
 #include "../nfCommon.hpp"
 #include "../System/Mutex.hpp"
 #include "../System/ConditionVariable.hpp"
+#include "../System/Timer.hpp"
+#include "../Memory/AllocationTracker.hpp"
 #include "../Containers/SharedPtr.hpp"
 
 #include <functional>
 #include <atomic>
 
 
+#ifndef NFE_CONFIGURATION_FINAL
+// record tasks execution timeline (see TaskTracer)
+#define NFE_ENABLE_TASK_TRACING
+#endif // NFE_CONFIGURATION_FINAL
+
+
 namespace NFE {
 namespace Common {
 
@@ -27,12 +35,33 @@ using TaskID = uint32;
 
 static constexpr TaskID InvalidTaskID = UINT32_MAX;
 
+/**
+ * Thread pool task group unique identifier.
+ */
+using TaskGroupID = uint16;
+
+static constexpr TaskGroupID InvalidTaskGroupID = UINT16_MAX;
+
+// Task locality hint meaning that the task can be executed on any NUMA node.
+static constexpr uint8 AnyNumaNode = UINT8_MAX;
+
 // Function object representing a task.
 using TaskFunction = std::function<void(const TaskContext& context)>;
 
 // Parallel-for callback
 using ParallelForTaskFunction = std::function<void(const TaskContext& context, uint32 arrayIndex)>;
 
+#ifdef NFE_ENABLE_TASK_TRACING
+// Task's tracing data collected before execution
+struct TaskTraceInfo
+{
+    uint64 id = 0;              // unique task ID (task IDs are reused), zero if the task is not traced
+    uint64 parentId = 0;
+    uint64 createTime = 0;
+    uint64 queueTime = 0;
+};
+#endif // NFE_ENABLE_TASK_TRACING
+
 /**
  * Task execution context.
  */
@@ -62,6 +91,20 @@ public:
         Finished,
     };
 
+    // marks list of dependent tasks as closed (the task is finished, no more dependent tasks can be added)
+    static constexpr TaskID ClosedListTaskID = InvalidTaskID - 1;
+
+    // maximum number of dependencies stored in the task (more dependencies are handled via additional join tasks)
+    static constexpr uint32 MaxDependencies = 4;
+
+    // Dependent tasks lists' nodes are (task ID, dependency slot) pairs packed into 32 bits,
+    // so a task can be linked into lists of all its dependencies at the same time.
+    static constexpr uint32 LinkSlotShift = 24;
+
+    NFE_FORCE_INLINE static TaskID MakeLink(TaskID taskID, uint32 slot) { return taskID | (slot << LinkSlotShift); }
+    NFE_FORCE_INLINE static TaskID GetLinkTask(TaskID link) { return link & ((1u << LinkSlotShift) - 1u); }
+    NFE_FORCE_INLINE static uint32 GetLinkSlot(TaskID link) { return link >> LinkSlotShift; }
+
     static const uint8 Flag_IsDispatched = 1;
     static const uint8 Flag_DependencyFullfilled = 2;
 
@@ -74,11 +117,9 @@ public:
     // If reaches 0, then whole task is considered as finished.
     std::atomic<int32> mTasksLeft;
 
-    union
-    {
-        TaskID mParent;
-        TaskID mNextFree;   //< free tasks list
-    };
+    TaskID mParent;
+
+    std::atomic<TaskID> mNextFree;  //< free tasks list
 
     // optional waitable object (it gets notified in the task is finished)
     Waitable* mWaitable;
@@ -86,17 +127,24 @@ public:
     const char* mDebugName;
 
     // Dependency pointers:
-    TaskID mDependency;  //< dependency tasks ID
-    TaskID mHead;        //< the first task that is dependent on this task
-    TaskID mTail;        //< the last task that is dependent on this task
-    TaskID mSibling;     //< the next task that is dependent on the same "mDependency" task
+    std::atomic<TaskID> mHead;                  //< lock-free list of tasks that are dependent on this task (links)
+    TaskID mSiblings[MaxDependencies];          //< the next links in the lists of task's dependencies (one per dependency slot)
+    std::atomic<int32> mDependenciesLeft;       //< number of unfinished dependencies
 
     uint8 mPriority;
+    uint8 mNumaNode;    //< target shared queue index (NUMA node or "any node" queue)
+    TaskGroupID mGroup; //< concurrency-limited group the task belongs to (optional)
+    MemoryTag mMemoryTag; //< memory tag of the thread that created the task (applied during execution)
+
+    Timer mReadyTimer;  //< started when the task becomes ready (used for group's wait time statistics)
+
+#ifdef NFE_ENABLE_TASK_TRACING
+    TaskTraceInfo mTraceInfo;
+#endif // NFE_ENABLE_TASK_TRACING
 
     // TODO: alignment
 
     Task();
-    Task(Task&& other);
     void Reset();
 };
 
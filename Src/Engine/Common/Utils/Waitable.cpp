@@ -1,38 +1,80 @@
 #include "PCH.hpp"
 #include "Waitable.hpp"
+#include "ThreadPool.hpp"
+#include "../System/Thread.hpp"
 
 namespace NFE {
 namespace Common {
 
+namespace {
+
+// number of failed attempts to find a task before the waiting thread goes to sleep
+const uint32 NumSpinsBeforeSleep = 64;
+
+} // namespace
+
 Waitable::Waitable()
     : mFinished(false)
+    , mPool(nullptr)
 { }
 
 Waitable::~Waitable()
 {
     Wait();
+
+    // the finishing thread may still hold the mutex after setting the flag
+    ScopedExclusiveLock<Mutex> lock(mMutex);
 }
 
 void Waitable::Wait()
 {
-    if (!mFinished)
+    if (mFinished)
     {
-        ScopedExclusiveLock<Mutex> lock(mMutex);
+        return;
+    }
+
+    // help executing pending tasks instead of idling
+    // (only if the waitable will be finished by the same pool, otherwise the helping thread would not be woken up)
+    ThreadPool* pool = mPool.load();
+    if (pool && pool == ThreadPool::GetCurrentThreadPool())
+    {
+        uint32 numIdleIterations = 0;
         while (!mFinished)
         {
-            mConditionVariable.Wait(lock);
+            if (pool->TryExecuteTask())
+            {
+                numIdleIterations = 0;
+                continue;
+            }
+
+            if (++numIdleIterations < NumSpinsBeforeSleep)
+            {
+                Thread::YieldCurrentThread();
+                continue;
+            }
+
+            // no pending tasks for a while - sleep until a new task is enqueued or the waitable is finished
+            pool->WaitForHelpableTask(*this);
         }
+
+        return;
+    }
+
+    ScopedExclusiveLock<Mutex> lock(mMutex);
+    while (!mFinished)
+    {
+        mConditionVariable.Wait(lock);
     }
 }
 
 void Waitable::OnFinished()
 {
+    ScopedExclusiveLock<Mutex> lock(mMutex);
+
     const bool oldState = mFinished.exchange(true);
     NFE_ASSERT(!oldState, "OnFinished can be called only once on waitable object");
 
-    ScopedExclusiveLock<Mutex> lock(mMutex);
     mConditionVariable.SignalAll();
-
 }
 
 } // namespace Common
@@ -14,6 +14,8 @@ namespace Common {
  */
 class NFCOMMON_API Waitable final
 {
+    friend class ThreadPool;
+
     NFE_MAKE_NONCOPYABLE(Waitable)
     NFE_MAKE_NONMOVEABLE(Waitable)
 
@@ -25,7 +27,10 @@ public:
     NFE_INLINE bool IsFinished() { return mFinished.load(); }
 
     // Wait for a task to finish.
-    // NOTE This can be called only on the main thread!
+    // When called on a worker thread (e.g. from inside a task) or on the thread pool's owner thread,
+    // pending tasks of the pool that finishes the waitable are executed on the calling thread while waiting
+    // (see ThreadPool::TryExecuteTask for which tasks can be executed).
+    // NOTE: Don't wait while holding a lock that other tasks may acquire.
     void Wait();
 
     void OnFinished();
@@ -35,6 +40,9 @@ private:
     Mutex mMutex;
     ConditionVariable mConditionVariable;
     std::atomic<bool> mFinished;
+
+    // thread pool executing the task the waitable is attached to
+    std::atomic<ThreadPool*> mPool;
 };
 
 
@@ -0,0 +1,126 @@
+/**
+ * @file
+ * @author Witek902 (witek902@gmail.com)
+ * @brief  WorkStealingQueue class declaration.
+ */
+
+#pragma once
+
+#include "../nfCommon.hpp"
+
+#include <atomic>
+
+
+namespace NFE {
+namespace Common {
+
+/**
+ * @class WorkStealingQueue
+ * Fixed-capacity lock-free Chase-Lev deque.
+ *
+ * The owner thread pushes and pops elements at the bottom (LIFO), other threads
+ * steal elements from the top (FIFO). Based on "Correct and Efficient Work-Stealing
+ * for Weak Memory Models" (Le, Pop, Cohen, Zappa Nardelli).
+ */
+template<typename T, uint32 Capacity>
+class WorkStealingQueue final
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static_assert(std::is_trivially_copyable<T>::value, "Element type must be trivially copyable");
+
+    NFE_MAKE_NONCOPYABLE(WorkStealingQueue)
+    NFE_MAKE_NONMOVEABLE(WorkStealingQueue)
+
+public:
+    WorkStealingQueue()
+        : mTop(0)
+        , mBottom(0)
+    { }
+
+    // Get approximate number of elements in the queue.
+    NFE_FORCE_INLINE uint32 Size() const
+    {
+        const int64 bottom = mBottom.load(std::memory_order_relaxed);
+        const int64 top = mTop.load(std::memory_order_relaxed);
+        return bottom > top ? static_cast<uint32>(bottom - top) : 0u;
+    }
+
+    NFE_FORCE_INLINE bool Empty() const
+    {
+        return Size() == 0;
+    }
+
+    // Push an element at the bottom. Returns false if the queue is full.
+    // NOTE: Can be called only by the owner thread.
+    bool Push(const T& value)
+    {
+        const int64 bottom = mBottom.load(std::memory_order_relaxed);
+        const int64 top = mTop.load(std::memory_order_acquire);
+        if (bottom - top >= static_cast<int64>(Capacity))
+        {
+            return false;
+        }
+
+        mElements[bottom & Mask].store(value, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        mBottom.store(bottom + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Pop an element from the bottom.
+    // NOTE: Can be called only by the owner thread.
+    bool Pop(T& outValue)
+    {
+        const int64 bottom = mBottom.load(std::memory_order_relaxed) - 1;
+        mBottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64 top = mTop.load(std::memory_order_relaxed);
+
+        if (top > bottom)
+        {
+            // queue was empty
+            mBottom.store(bottom + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        outValue = mElements[bottom & Mask].load(std::memory_order_relaxed);
+
+        if (top == bottom)
+        {
+            // the last element - race against thieves
+            const bool won = mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            mBottom.store(bottom + 1, std::memory_order_relaxed);
+            return won;
+        }
+
+        return true;
+    }
+
+    // Steal an element from the top.
+    // NOTE: Can be called by any thread.
+    bool Steal(T& outValue)
+    {
+        int64 top = mTop.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64 bottom = mBottom.load(std::memory_order_acquire);
+
+        if (top >= bottom)
+        {
+            return false;
+        }
+
+        outValue = mElements[top & Mask].load(std::memory_order_relaxed);
+        return mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr int64 Mask = static_cast<int64>(Capacity) - 1;
+
+    // top and bottom are modified by different threads, so keep them in separate cache lines
+    alignas(NFE_CACHE_LINE_SIZE) std::atomic<int64> mTop;
+    alignas(NFE_CACHE_LINE_SIZE) std::atomic<int64> mBottom;
+    alignas(NFE_CACHE_LINE_SIZE) std::atomic<T> mElements[Capacity];
+};
+
+} // namespace Common
+} // namespace NFE
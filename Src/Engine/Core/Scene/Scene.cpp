@@ -62,10 +62,14 @@ void Scene::Update(const SceneUpdateInfo& info)
     // TODO this should be thread pool tasks
     // TODO systems update graph (right now it's very serial...)
 
+    // previous frame's temporary data is no longer needed
+    mFrameAllocator.Reset();
+
     SystemUpdateContext updateContext;
     updateContext.timeDelta = info.timeDelta;
     updateContext.totalTime = mTotalTime;
     updateContext.frameNumber = mFrameNumber;
+    updateContext.frameAllocator = &mFrameAllocator;
 
     mFrameNumber++;
     mTotalTime += static_cast<double>(info.timeDelta);
@@ -12,6 +12,7 @@
 #include "../../Common/Math/Vec4f.hpp"
 #include "../../Common/Containers/UniquePtr.hpp"
 #include "../../Common/Containers/String.hpp"
+#include "../../Common/Memory/ArenaAllocator.hpp"
 
 
 namespace NFE {
@@ -74,6 +75,9 @@ private:
     uint64 mFrameNumber;    // number of frames processed
     double mTotalTime;      // total time elapsed
 
+    // frame-scoped memory for systems' temporary data
+    Common::ArenaAllocator mFrameAllocator;
+
     void ReleaseSystems();
 };
 
@@ -20,10 +20,14 @@ struct SystemUpdateContext
     double totalTime;
     float timeDelta;
 
+    // allocator for temporary data valid only during current frame (reset at frame begin)
+    Common::ArenaAllocator* frameAllocator;
+
     SystemUpdateContext()
         : frameNumber(0)
         , totalTime(0.0)
         , timeDelta(0.0f)
+        , frameAllocator(nullptr)
     { }
 };
 
@@ -9,6 +9,8 @@
 #include "EventSystem.hpp"
 #include "../Scene.hpp"
 #include "../Events/Event_Trigger.hpp"
+#include "../../../Common/Containers/DynArray.hpp"
+#include "../../../Common/Memory/ArenaAllocator.hpp"
 
 namespace NFE {
 namespace Scene {
@@ -96,11 +98,9 @@ void TriggerSystem::InvalidateArea(const Math::Box& box)
 
 void TriggerSystem::Update(const SystemUpdateContext& context)
 {
-    NFE_UNUSED(context);
-
     // Resolve ID to actual trigger object pointers in order to reduce number of Map accesses
-    // from N^2 to N.
-    Common::DynArray<const TriggerObject*> invalidatedTriggers;
+    // from N^2 to N. The list lives only during this frame, so use the frame allocator.
+    Common::DynArray<const TriggerObject*> invalidatedTriggers(context.frameAllocator);
     {
         invalidatedTriggers.Reserve(mInvalidatedTriggerIDs.Size());
         for (const TriggerID id : mInvalidatedTriggerIDs)
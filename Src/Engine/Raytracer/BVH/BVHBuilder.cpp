@@ -1,6 +1,7 @@
 #include "PCH.h"
 #include "BVHBuilder.h"
 #include "../Common/System/Timer.hpp"
+#include "../Common/Memory/AllocationTracker.hpp"
 #include "../Common/Utils/TaskBuilder.hpp"
 #include "../Common/Utils/Waitable.hpp"
 #include "../Common/Utils/ThreadPool.hpp"
@@ -37,6 +38,8 @@ bool BVHBuilder::Build(const Box* data, const uint32 numLeaves,
                        const BvhBuildingParams& params,
                        DynArray<uint32>& outLeavesOrder)
 {
+    NFE_MEMORY_TAG_SCOPE("BVH");
+
     mLeafBoxes = data;
     mNumLeaves = numLeaves;
     mParams = params;
@@ -13,21 +13,34 @@ Film::Film()
     : mFilmSize(Vec4f::Zero())
     , mSum(nullptr)
     , mSecondarySum(nullptr)
+    , mPassesPerPixel(nullptr)
+    , mCompactSecondarySum(false)
+    , mIsEvenPass(true)
+    , mHasSplats(false)
     , mWidth(0)
     , mHeight(0)
 {}
 
-Film::Film(Bitmap& sum, Bitmap* secondarySum)
+Film::Film(Bitmap& sum, Bitmap* secondarySum, const uint32* passesPerPixel, uint32 passIndex)
     : mFilmSize((float)sum.GetWidth(), (float)sum.GetHeight())
     , mSum(&sum)
     , mSecondarySum(secondarySum) 
+    , mPassesPerPixel(passesPerPixel)
+    , mCompactSecondarySum(false)
+    , mIsEvenPass(passIndex % 2 == 0)
+    , mHasSplats(false)
     , mWidth(sum.GetWidth())
     , mHeight(sum.GetHeight())
 {
+    NFE_ASSERT(sum.GetFormat() == Bitmap::Format::R32G32B32_Float, "");
+
     if (mSecondarySum)
     {
         NFE_ASSERT(mSecondarySum->GetWidth() == mWidth, "");
         NFE_ASSERT(mSecondarySum->GetHeight() == mHeight, "");
+
+        mCompactSecondarySum = mSecondarySum->GetFormat() == Bitmap::Format::R16G16B16_Half;
+        NFE_ASSERT(mCompactSecondarySum || mSecondarySum->GetFormat() == Bitmap::Format::R32G32B32_Float, "");
     }
 }
 
@@ -37,7 +50,22 @@ NFE_FORCE_INLINE static void AccumulateToFloat3(Vec3f& target, const Vec4f& valu
     target = (original + value).ToVec3f();
 }
 
+NFE_FORCE_INLINE static void AccumulateToHalf3(Half3& target, const Vec4f& value)
+{
+    // clamp to the largest finite half value, so a single firefly does not turn the pixel into infinity
+    const Vec4f original = Vec4f_Load_Half3(target);
+    const Half4 result = Vec4f::Clamp(original + value, Vec4f(-65504.0f), Vec4f(65504.0f)).ToHalf4();
+    target = { result.x, result.y, result.z };
+}
+
 void Film::AccumulateColor(const uint32 x, const uint32 y, const Vec4f& sampleColor)
+{
+    // the pixel counter is only written by the calling thread
+    const bool isEvenSample = !mPassesPerPixel || (mPassesPerPixel[mWidth * y + x] % 2 == 0);
+    AccumulateColor(x, y, sampleColor, isEvenSample);
+}
+
+void Film::AccumulateColor(const uint32 x, const uint32 y, const Vec4f& sampleColor, bool isEvenSample)
 {
     if (!mSum)
     {
@@ -45,15 +73,21 @@ void Film::AccumulateColor(const uint32 x, const uint32 y, const Vec4f& sampleCo
     }
 
     Vec3f* sumPixel = &(mSum->GetPixelRef<Vec3f>(x, y));
-    Vec3f* secondarySumPixel = mSecondarySum ? &(mSecondarySum->GetPixelRef<Vec3f>(x, y)) : nullptr;
 
     //LockPixel(x, y);
     {
         AccumulateToFloat3(*sumPixel, sampleColor);
 
-        if (secondarySumPixel)
+        if (mSecondarySum)
         {
-            AccumulateToFloat3(*secondarySumPixel, sampleColor);
+            if (mCompactSecondarySum)
+            {
+                AccumulateToHalf3(mSecondarySum->GetPixelRef<Half3>(x, y), isEvenSample ? -sampleColor : sampleColor);
+            }
+            else if (isEvenSample)
+            {
+                AccumulateToFloat3(mSecondarySum->GetPixelRef<Vec3f>(x, y), sampleColor);
+            }
         }
     }
     //UnlockPixel(x, y);
@@ -93,7 +127,14 @@ void Film::AccumulateColor(const Vec4f& pos, const Vec4f& sampleColor, Random& r
 
     if (uint32(x) < mWidth && uint32(y) < mHeight)
     {
-        AccumulateColor(x, y, sampleColor);
+        if (!mHasSplats.load(std::memory_order_relaxed))
+        {
+            mHasSplats.store(true, std::memory_order_relaxed);
+        }
+
+        // splatted samples can land on a pixel that is being rendered by other thread,
+        // so they are assigned to the half of samples selected by the pass index
+        AccumulateColor(x, y, sampleColor, mIsEvenPass);
     }
 }
 
@@ -4,6 +4,8 @@
 #include "../../Common/Math/Vec4f.hpp"
 #include "../../Common/System/SpinLock.hpp"
 
+#include <atomic>
+
 namespace NFE {
 namespace RT {
 
@@ -11,7 +13,12 @@ class Film
 {
 public:
     NFE_RAYTRACER_API Film();
-    NFE_RAYTRACER_API Film(Bitmap& sum, Bitmap* secondarySum = nullptr);
+
+    // Secondary sum is used for error estimation. It can be either R32G32B32_Float (sum of even samples)
+    // or R16G16B16_Half (compact, odd minus even samples). Sample parity is taken from per-pixel pass counts
+    // (if not provided, all samples are treated as even). Splatted samples use parity of the pass index instead,
+    // because the pixel counters are written by the threads rendering the pixels.
+    NFE_RAYTRACER_API Film(Bitmap& sum, Bitmap* secondarySum = nullptr, const uint32* passesPerPixel = nullptr, uint32 passIndex = 0);
 
     NFE_FORCE_INLINE uint32 GetWidth() const
     {
@@ -23,14 +30,29 @@ public:
         return mHeight;
     }
 
-    void AccumulateColor(const Math::Vec4f& pos, const Math::Vec4f& sampleColor, Math::Random& randomGenerator);
+    // check if any sample was splatted (accumulated at arbitrary film position)
+    NFE_FORCE_INLINE bool HasSplats() const
+    {
+        return mHasSplats.load(std::memory_order_relaxed);
+    }
+
+    // splat a sample (can be called for any pixel from any thread)
+    NFE_RAYTRACER_API void AccumulateColor(const Math::Vec4f& pos, const Math::Vec4f& sampleColor, Math::Random& randomGenerator);
+
+    // accumulate sample of a pixel owned by the calling thread
     void AccumulateColor(const uint32 x, const uint32 y, const Math::Vec4f& sampleColor);
 
 private:
+    void AccumulateColor(const uint32 x, const uint32 y, const Math::Vec4f& sampleColor, bool isEvenSample);
+
     Math::Vec4f mFilmSize;
 
     Bitmap* mSum;
     Bitmap* mSecondarySum;
+    const uint32* mPassesPerPixel;
+    bool mCompactSecondarySum;
+    bool mIsEvenPass;
+    std::atomic<bool> mHasSplats;
 
     const uint32 mWidth;
     const uint32 mHeight;
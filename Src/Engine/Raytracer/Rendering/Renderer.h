@@ -9,6 +9,7 @@
 #include "../../Common/Containers/StringView.hpp"
 #include "../../Common/Containers/ArrayView.hpp"
 #include "../../Common/Memory/Aligned.hpp"
+#include "../../Common/Utils/CancellationToken.hpp"
 #include "../../Common/Reflection/ReflectionClassDeclare.hpp"
 #include "../../Common/Reflection/Object.hpp"
 
@@ -30,27 +31,33 @@ public:
         const Camera& camera;
         uint32 iteration;
         Film& film;
+        const Common::CancellationToken* cancellationToken = nullptr;
+
+        // renderers doing long-running work should poll this and return early if set
+        NFE_FORCE_INLINE bool IsCancelled() const
+        {
+            return cancellationToken && cancellationToken->IsCancelled();
+        }
     };
 
-    IRenderer();
+    NFE_RAYTRACER_API IRenderer();
 
     NFE_RAYTRACER_API virtual ~IRenderer();
 
     // TODO batch & multisample rendering
-    // TODO cancelation of ongoing rendering
 
     // create per-thread context
-    virtual RendererContextPtr CreateContext() const;
+    NFE_RAYTRACER_API virtual RendererContextPtr CreateContext() const;
 
     // optional rendering pre-pass, called once before all RenderPixel
     // can build custom tasks graph for internal state update
-    virtual void PreRender(Common::TaskBuilder& builder, const RenderParam& renderParams, Common::ArrayView<RenderingContext> contexts);
+    NFE_RAYTRACER_API virtual void PreRender(Common::TaskBuilder& builder, const RenderParam& renderParams, Common::ArrayView<RenderingContext> contexts);
 
     // called for every pixel on screen during rendering
     // Note: this will be called from multiple threads, each thread provides own RenderingContext
     virtual const RayColor RenderPixel(const Math::Ray& ray, const RenderParam& param, RenderingContext& ctx) const = 0;
 
-    virtual void Raytrace_Packet(RayPacket& packet, const RenderParam& param, RenderingContext& context) const;
+    NFE_RAYTRACER_API virtual void Raytrace_Packet(RayPacket& packet, const RenderParam& param, RenderingContext& context) const;
 
 private:
     IRenderer(const IRenderer&) = delete;
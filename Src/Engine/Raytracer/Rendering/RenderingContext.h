@@ -10,6 +10,7 @@
 #include "../../Common/Math/Random.hpp"
 #include "../../Common/Containers/UniquePtr.hpp"
 #include "../../Common/Memory/Aligned.hpp"
+#include "../../Common/Memory/ArenaAllocator.hpp"
 #include "../../Common/Reflection/ReflectionClassDeclare.hpp"
 #include "../../Common/Reflection/ReflectionEnumMacros.hpp"
 
@@ -35,14 +36,16 @@ struct NFE_RAYTRACER_API SpectrumDebugData
 /**
  * A structure with local (per-thread) data.
  * It's like a hub for all global params (read only) and local state (read write).
+ * Aligned to memory page size, so contexts stored in an array don't share pages
+ * and each one can be bound to NUMA node of its thread.
  */
-struct NFE_ALIGN(64) RenderingContext
+struct NFE_ALIGN(4096) RenderingContext
 {
     NFE_MAKE_NONCOPYABLE(RenderingContext)
 
 public:
 
-    NFE_ALIGNED_CLASS(64)
+    NFE_ALIGNED_CLASS(4096)
 
     NFE_RAYTRACER_API RenderingContext();
     NFE_RAYTRACER_API RenderingContext(RenderingContext&& other) = default;
@@ -56,6 +59,9 @@ public:
     // per-thread pseudo-random number generator
     Math::Random randomGenerator;
 
+    // per-thread scratch memory (e.g. path vertices), reset at the beginning of every pass
+    Common::ArenaAllocator arena;
+
     // renderer-specific context, can be null
     RendererContextPtr rendererContext;
 
@@ -47,5 +47,6 @@ NFE_DEFINE_CLASS(NFE::RT::RenderingParams)
     NFE_CLASS_MEMBER(visualizeTimePerPixel);
     NFE_CLASS_MEMBER(samplingParams);
     NFE_CLASS_MEMBER(adaptiveSettings);
+    NFE_CLASS_MEMBER(compactAccumulation);
 }
 NFE_END_DEFINE_CLASS()
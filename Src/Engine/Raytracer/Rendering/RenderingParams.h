@@ -92,6 +92,11 @@ public:
 
     // adaptive rendering settings
     AdaptiveRenderingSettings adaptiveSettings;
+
+    // Store secondary accumulation buffer (used for error estimation) as half-float difference
+    // between odd and even passes instead of a full float sum. Saves 6 bytes per pixel.
+    // NOTE: changing this resets the accumulated image
+    bool compactAccumulation = false;
 };
 
 } // namespace RT
@@ -58,8 +58,6 @@ NFE_FORCE_INLINE static constexpr float PdfWtoA(const float pdfW, const float di
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
-static constexpr uint32 g_MaxLightVertices = 256;
-
 class NFE_ALIGN(64) VertexConnectionAndMergingContext : public IRendererContext
 {
 public:
@@ -71,11 +69,13 @@ public:
     // list of photons recorded from a single thread
     DynArray<Photon> photons;
 
-    // list of light vertices used in current pixel processing
+    // list of light vertices used in current pixel processing (allocated from the thread's arena)
     uint32 numLightVertices = 0;
-    LightVertex lightVertices[g_MaxLightVertices];
+    LightVertex* lightVertices = nullptr;
 };
 
+static_assert(std::is_trivially_destructible<VertexConnectionAndMerging::LightVertex>::value, "Light vertices are never destroyed");
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 static_assert(sizeof(VertexConnectionAndMerging::Photon) == 32, "Invalid photon size");
@@ -207,6 +207,9 @@ void VertexConnectionAndMerging::PreRender(Common::TaskBuilder& builder, const R
 
 const RayColor VertexConnectionAndMerging::RenderPixel(const Math::Ray& ray, const RenderParam& param, RenderingContext& ctx) const
 {
+    // light path vertices are released after the pixel is processed
+    ArenaScope arenaScope(ctx.arena);
+
     // step 1: trace light paths & record photons
 
     TraceLightPath(param, ctx);
@@ -356,6 +359,7 @@ void VertexConnectionAndMerging::TraceLightPath(const RenderParam& param, Render
     VertexConnectionAndMergingContext& rendererContext = *static_cast<VertexConnectionAndMergingContext*>(ctx.rendererContext.Get());
 
     rendererContext.numLightVertices = 0;
+    rendererContext.lightVertices = ctx.arena.AllocateArray<LightVertex>(mMaxPathLength);
 
     PathState pathState;
 
@@ -385,8 +389,8 @@ void VertexConnectionAndMerging::TraceLightPath(const RenderParam& param, Render
             break; // we hit a light directly
         }
 
-        NFE_ASSERT(rendererContext.numLightVertices < g_MaxLightVertices, "");
-        LightVertex& vertex = rendererContext.lightVertices[rendererContext.numLightVertices];
+        NFE_ASSERT(rendererContext.numLightVertices < mMaxPathLength, "");
+        LightVertex& vertex = *new (rendererContext.lightVertices + rendererContext.numLightVertices) LightVertex;
 
         // fill up structure with shading data
         ShadingData& shadingData = vertex.shadingData;
@@ -9,6 +9,8 @@
 #include "Utils/BitmapUtils.h"
 #include "Utils/Profiler.h"
 #include "../Common/System/Timer.hpp"
+#include "../Common/System/Memory.hpp"
+#include "../Common/Memory/AllocationTracker.hpp"
 #include "../Common/Math/SamplingHelpers.hpp"
 #include "../Common/Math/PackedLoadVec4f.hpp"
 #include "../Common/Math/Transcendental.hpp"
@@ -44,10 +46,20 @@ Viewport::~Viewport() = default;
 
 void Viewport::InitThreadData()
 {
-    const uint32 numThreads = ThreadPool::GetInstance().GetNumThreads();
+    const ThreadPool& threadPool = ThreadPool::GetInstance();
+    const uint32 numThreads = threadPool.GetNumThreads();
 
     mThreadData.Resize(numThreads);
 
+    // move per-thread contexts close to the worker threads using them
+    if (threadPool.GetNumNumaNodes() > 1)
+    {
+        for (uint32 i = 0; i < numThreads; ++i)
+        {
+            BindMemoryToNumaNode(&mThreadData[i], sizeof(RenderingContext), threadPool.GetThreadNumaNode(i));
+        }
+    }
+
     mSamplers.Clear();
     mSamplers.Reserve(numThreads);
 
@@ -56,14 +68,53 @@ void Viewport::InitThreadData()
         RenderingContext& ctx = mThreadData[i];
         ctx.randomGenerator.Reset();
         ctx.sampler.fallbackGenerator = &ctx.randomGenerator;
+    }
 
-        if (mRenderer)
+    if (!mRenderer)
+    {
+        return;
+    }
+
+    if (threadPool.GetNumNumaNodes() > 1)
+    {
+        // renderer contexts are allocated by the renderer, so create them on the thread's node to let the first touch place them there
+        // Note: idle workers of other nodes can still pick up the task, so this is only a hint
+        Waitable waitable;
+        {
+            TaskBuilder builder(waitable);
+            for (uint32 i = 0; i < numThreads; ++i)
+            {
+                ParallelForParams params;
+                params.numaNode = static_cast<uint8>(threadPool.GetThreadNumaNode(i));
+
+                builder.ParallelFor("Viewport/CreateRendererContext", 1, [this, i] (const TaskContext&, uint32)
+                {
+                    mThreadData[i].rendererContext = mRenderer->CreateContext();
+                }, params);
+            }
+        }
+        waitable.Wait();
+    }
+    else
+    {
+        for (RenderingContext& ctx : mThreadData)
         {
             ctx.rendererContext = mRenderer->CreateContext();
         }
     }
 }
 
+bool Viewport::InitSecondarySum()
+{
+    Bitmap::InitData initData;
+    initData.linearSpace = true;
+    initData.width = GetWidth();
+    initData.height = GetHeight();
+    initData.format = mParams.compactAccumulation ? Bitmap::Format::R16G16B16_Half : Bitmap::Format::R32G32B32_Float;
+
+    return mSecondarySum.Init(initData);
+}
+
 bool Viewport::InitBluredImages()
 {
     Bitmap::InitData initData;
@@ -76,6 +127,10 @@ bool Viewport::InitBluredImages()
     {
         if (!blurredImage.Init(initData))
         {
+            for (Bitmap& image : mBlurredImages)
+            {
+                image.Release();
+            }
             return false;
         }
     }
@@ -83,6 +138,19 @@ bool Viewport::InitBluredImages()
     return true;
 }
 
+bool Viewport::HasBlurredImages() const
+{
+    for (const Bitmap& blurredImage : mBlurredImages)
+    {
+        if (blurredImage.GetWidth() != GetWidth() || blurredImage.GetHeight() != GetHeight())
+        {
+            return false;
+        }
+    }
+
+    return !mBlurredImages.Empty();
+}
+
 bool Viewport::Resize(uint32 width, uint32 height)
 {
     if (width > MAX_IMAGE_SZIE || height > MAX_IMAGE_SZIE || width == 0 || height == 0)
@@ -107,12 +175,15 @@ bool Viewport::Resize(uint32 width, uint32 height)
         return false;
     }
 
-    if (!mSecondarySum.Init(initData))
+    if (!InitSecondarySum())
     {
         return false;
     }
 
-    InitBluredImages();
+    for (Bitmap& blurredImage : mBlurredImages)
+    {
+        blurredImage.Release();
+    }
 
     initData.linearSpace = false;
     initData.format = Bitmap::Format::B8G8R8A8_UNorm;
@@ -122,12 +193,9 @@ bool Viewport::Resize(uint32 width, uint32 height)
     }
     NFE_ASSERT(GetFrontBuffer().GetFormat() == Bitmap::Format::B8G8R8A8_UNorm, "");
 
-    mPassesPerPixel.Resize(width * height);
-
-    mPixelSalt.Resize(width * height);
-    for (uint32 i = 0; i < width * height; ++i)
+    if (!mPassesPerPixel.Resize(width * height))
     {
-        mPixelSalt[i] = mRandomGenerator.GetVec4f().ToVec2f();
+        return false;
     }
 
     Reset();
@@ -157,7 +225,10 @@ void Viewport::Reset()
     mSum.Clear();
     mSecondarySum.Clear();
 
-    memset(mPassesPerPixel.Data(), 0, sizeof(uint32) * GetWidth() * GetHeight());
+    if (!mPassesPerPixel.Empty())
+    {
+        memset(mPassesPerPixel.Data(), 0, sizeof(uint32) * mPassesPerPixel.Size());
+    }
 
     BuildInitialBlocksList();
 }
@@ -203,10 +274,22 @@ bool Viewport::SetRenderingParams(const RenderingParams& params)
     NFE_ASSERT(params.antiAliasingSpread >= 0.0f, "");
     NFE_ASSERT(params.motionBlurStrength >= 0.0f && params.motionBlurStrength <= 1.0f, "");
 
+    const bool accumulationModeChanged = mParams.compactAccumulation != params.compactAccumulation;
+
     mParams = params;
 
     PrepareHilbertCurve(mParams.tileSize);
 
+    if (accumulationModeChanged && GetWidth() > 0 && GetHeight() > 0)
+    {
+        if (!InitSecondarySum())
+        {
+            return false;
+        }
+
+        Reset();
+    }
+
     return true;
 }
 
@@ -215,7 +298,6 @@ bool Viewport::SetPostprocessParams(const PostprocessParams& params)
     if (mBlurredImages.Size() != params.bloom.elements.Size())
     {
         mBlurredImages.Resize(params.bloom.elements.Size());
-        InitBluredImages();
     }
 
     if (!RTTI::Compare(mPostprocessParams.params.lutParams, params.lutParams) ||
@@ -242,9 +324,10 @@ void Viewport::ComputeError()
     mProgress.averageError = ComputeBlockError(fullImageBlock);
 }
 
-bool Viewport::Render(const Scene& scene, const Camera& camera)
+bool Viewport::Render(const Scene& scene, const Camera& camera, const CancellationToken* cancellationToken)
 {
     NFE_SCOPED_TIMER(Render);
+    NFE_MEMORY_TAG_SCOPE("Viewport");
 
     const uint32 width = GetWidth();
     const uint32 height = GetHeight();
@@ -268,17 +351,24 @@ bool Viewport::Render(const Scene& scene, const Camera& camera)
         mHaltonSequence.NextSampleLeap();
     }
 
-    Film film(mSum, mProgress.passesFinished % 2 == 0 ? &mSecondarySum : nullptr);
-    const IRenderer::RenderParam renderParam = { scene, camera, mProgress.passesFinished, film };
+    // Secondary image holds even samples of each pixel (or difference between odd and even samples in compact mode).
+    // Sample parity is tracked per pixel, so a partially rendered pass does not break the error estimation.
+    Film film(mSum, &mSecondarySum, mPassesPerPixel.Data(), mProgress.passesFinished);
+    const IRenderer::RenderParam renderParam = { scene, camera, mProgress.passesFinished, film, cancellationToken };
+
+    // used to detect if the pass was cancelled before all the tiles were rendered
+    std::atomic<uint32> numTilesRendered(0);
 
     Waitable waitable;
     {
         TaskBuilder taskBuilder(waitable);
+        taskBuilder.SetCancellationToken(cancellationToken);
 
         for (uint32 i = 0; i < mThreadData.Size(); ++i)
         {
             RenderingContext& ctx = mThreadData[i];
             ctx.counters.Reset();
+            ctx.arena.Reset();
             ctx.params = &mParams;
             ctx.camera = &camera;
 #ifndef NFE_CONFIGURATION_FINAL
@@ -307,7 +397,7 @@ bool Viewport::Render(const Scene& scene, const Camera& camera)
         taskBuilder.Fence();
 
         // render tiles
-        taskBuilder.ParallelFor("Render", mRenderingTiles.Size(), [pixelOffset, this, &renderParam] (const TaskContext& context, uint32 index)
+        const auto renderTiles = [pixelOffset, this, &renderParam, &numTilesRendered] (const TaskContext& context, uint32 index)
         {
             const TileRenderingContext tileContext =
             {
@@ -315,8 +405,50 @@ bool Viewport::Render(const Scene& scene, const Camera& camera)
                 renderParam,
                 pixelOffset* mThreadData[0].params->antiAliasingSpread
             };
-            RenderTile(tileContext, mThreadData[context.threadId], mRenderingTiles[index]);
-        });
+
+            if (RenderTile(tileContext, mThreadData[context.threadId], mRenderingTiles[index]))
+            {
+                numTilesRendered.fetch_add(1, std::memory_order_relaxed);
+            }
+        };
+
+        // tiles cost varies a lot, so balance them dynamically
+        ParallelForParams renderParams(ParallelForSchedule::Dynamic);
+
+        const ThreadPool& threadPool = ThreadPool::GetInstance();
+        const uint32 numNumaNodes = threadPool.GetNumNumaNodes();
+        if (numNumaNodes > 1)
+        {
+            // split tiles into contiguous ranges (neighbouring tiles on Hilbert curve) proportional to node's worker count,
+            // so each node works on a compact image region
+            const uint32 numTiles = mRenderingTiles.Size();
+            const uint32 numWorkers = Max(1u, threadPool.GetNumWorkerThreads());
+
+            uint32 firstTile = 0;
+            uint32 workersSoFar = 0;
+            for (uint32 node = 0; node < numNumaNodes; ++node)
+            {
+                workersSoFar += threadPool.GetNumNodeWorkerThreads(node);
+                const uint32 lastTile = node + 1 == numNumaNodes ? numTiles :
+                    static_cast<uint32>(static_cast<uint64>(numTiles) * workersSoFar / numWorkers);
+                if (lastTile <= firstTile)
+                {
+                    continue;
+                }
+
+                renderParams.numaNode = static_cast<uint8>(node);
+                taskBuilder.ParallelFor("Render", lastTile - firstTile, [firstTile, renderTiles] (const TaskContext& context, uint32 index)
+                {
+                    renderTiles(context, firstTile + index);
+                }, renderParams);
+
+                firstTile = lastTile;
+            }
+        }
+        else
+        {
+            taskBuilder.ParallelFor("Render", mRenderingTiles.Size(), renderTiles, renderParams);
+        }
 
         taskBuilder.Fence();
 
@@ -324,6 +456,23 @@ bool Viewport::Render(const Scene& scene, const Camera& camera)
     }
     waitable.Wait();
 
+    if (cancellationToken && cancellationToken->IsCancelled())
+    {
+        // post-processing could be interrupted
+        mPostprocessParams.fullUpdateRequired = true;
+    }
+
+    // Partially rendered pass is kept. Pixels that were not rendered just have one sample less.
+    const bool passCompleted = numTilesRendered.load() == mRenderingTiles.Size();
+
+    if (!passCompleted && film.HasSplats())
+    {
+        // Splatted samples are normalized by the number of passes, not by pixel's own samples,
+        // so a partial pass of a splatting renderer (e.g. light tracer) would bias the image.
+        Reset();
+        return false;
+    }
+
     mProgress.passesFinished++;
 
     if ((mProgress.passesFinished > 0) && (mProgress.passesFinished % 2 == 0))
@@ -346,10 +495,10 @@ bool Viewport::Render(const Scene& scene, const Camera& camera)
         mCounters.Append(ctx.counters);
     }
 
-    return true;
+    return passCompleted;
 }
 
-void Viewport::RenderTile(const TileRenderingContext& tileContext, RenderingContext& ctx, const Block& tile)
+bool Viewport::RenderTile(const TileRenderingContext& tileContext, RenderingContext& ctx, const Block& tile)
 {
     NFE_SCOPED_TIMER(Viewport_RenderTile);
 
@@ -363,6 +512,11 @@ void Viewport::RenderTile(const TileRenderingContext& tileContext, RenderingCont
     const Vec4f filmSize = Vec4f::FromIntegers(GetWidth(), GetHeight(), 1, 1);
     const Vec4f invSize = VECTOR_ONE2 / filmSize;
 
+    if (tileContext.renderParam.IsCancelled())
+    {
+        return false;
+    }
+
     if (ctx.params->traversalMode == TraversalMode::Single)
     {
         uint32 x = tile.minX;
@@ -378,6 +532,11 @@ void Viewport::RenderTile(const TileRenderingContext& tileContext, RenderingCont
                 continue;
             }
 
+            if (tileContext.renderParam.IsCancelled())
+            {
+                return false;
+            }
+
             const uint32 realY = GetHeight() - 1u - y;
 
 #ifndef NFE_CONFIGURATION_FINAL
@@ -420,6 +579,7 @@ void Viewport::RenderTile(const TileRenderingContext& tileContext, RenderingCont
 #endif // NFE_ENABLE_SPECTRAL_RENDERING
 
             tileContext.renderParam.film.AccumulateColor(x, y, sampleColor);
+            mPassesPerPixel[GetWidth() * y + x]++;
         }
     }
     else if (ctx.params->traversalMode == TraversalMode::Packet)
@@ -548,9 +708,19 @@ void Viewport::RenderTile(const TileRenderingContext& tileContext, RenderingCont
         ctx.localCounters.Reset();
         tileContext.renderer.Raytrace_Packet(primaryPacket, tileContext.renderParam, ctx);
         ctx.counters.Append(ctx.localCounters);
+
+        for (uint32 y = tile.minY; y < tile.maxY; ++y)
+        {
+            for (uint32 x = tile.minX; x < tile.maxX; ++x)
+            {
+                mPassesPerPixel[GetWidth() * y + x]++;
+            }
+        }
     }
 
     ctx.counters.numPrimaryRays += (uint64)(tile.maxY - tile.minY) * (uint64)(tile.maxX - tile.minX);
+
+    return true;
 }
 
 void Viewport::PerformPostProcess(TaskBuilder& taskBuilder)
@@ -558,6 +728,19 @@ void Viewport::PerformPostProcess(TaskBuilder& taskBuilder)
     NFE_SCOPED_TIMER(PerformPostProcess);
 
     if (!mBlurredImages.Empty() && mPostprocessParams.params.bloom.factor > 0.0f)
+    {
+        if (!HasBlurredImages() && InitBluredImages())
+        {
+            // newly allocated images must be fully processed
+            mPostprocessParams.fullUpdateRequired = true;
+        }
+    }
+
+    // Bloom levels form a chain (each one blurs the previous one), so instead of global fences
+    // each level waits only for the previous one and the post-process waits only for the last one.
+    TaskID bloomTask = InvalidTaskID;
+
+    if (HasBlurredImages() && mPostprocessParams.params.bloom.factor > 0.0f)
     {
         for (uint32 i = 0; i < mBlurredImages.Size(); ++i)
         {
@@ -566,12 +749,13 @@ void Viewport::PerformPostProcess(TaskBuilder& taskBuilder)
             BitmapUtils::GaussianBlurParams blurParams;
             blurParams.numPasses = mPostprocessParams.params.bloom.elements[i].numBlurPasses;
             blurParams.sigma = mPostprocessParams.params.bloom.elements[i].sigma;     
-            BitmapUtils::GaussianBlur(mBlurredImages[i], sourceBitmap, blurParams, taskBuilder);
-
-            taskBuilder.Fence();
+            BitmapUtils::GaussianBlur(mBlurredImages[i], sourceBitmap, blurParams, taskBuilder, ArrayView<const TaskID>(&bloomTask, 1), &bloomTask);
         }
     }
 
+    ParallelForParams postProcessParams;
+    postProcessParams.dependencies = ArrayView<const TaskID>(&bloomTask, 1);
+
     mPostprocessParams.colorScale = Vec4f(exp2f(mPostprocessParams.params.exposure));
 
     if (!mPostprocessLUT.IsGenerated() || mPostprocessParams.lutGenerationRequired)
@@ -597,7 +781,7 @@ void Viewport::PerformPostProcess(TaskBuilder& taskBuilder)
             PostProcessTile(block, context.threadId);
         };
 
-        taskBuilder.ParallelFor("PostProcess_Full", numTiles, taskCallback);
+        taskBuilder.ParallelFor("PostProcess_Full", numTiles, taskCallback, postProcessParams);
 
         mPostprocessParams.fullUpdateRequired = false;
     }
@@ -612,7 +796,7 @@ void Viewport::PerformPostProcess(TaskBuilder& taskBuilder)
                 PostProcessTile(mRenderingTiles[index], context.threadId);
             };
 
-            taskBuilder.ParallelFor("PostProcess", mRenderingTiles.Size(), taskCallback);
+            taskBuilder.ParallelFor("PostProcess", mRenderingTiles.Size(), taskCallback, postProcessParams);
         }
     }
 }
@@ -655,14 +839,13 @@ void Viewport::PostProcessTile(const Block& block, uint32 threadID)
     const PostprocessParams& params = mPostprocessParams.params;
     NFE_ASSERT(params.tonemapper, "Tonemapper missing");
 
-    const bool useBloom = params.bloom.factor > 0.0f && !mBlurredImages.Empty();
+    const bool useBloom = params.bloom.factor > 0.0f && HasBlurredImages();
 
-    const float pixelScaling = 1.0f / (float)(1u + mProgress.passesFinished);
-  
     for (uint32 y = block.minY; y < block.maxY; ++y)
     {
         for (uint32 x = block.minX; x < block.maxX; ++x)
         {
+            const uint32 numPasses = mPassesPerPixel[GetWidth() * y + x];
             const Vec4f rawValue = Vec4f_Load_Vec3f_Unsafe(mSum.GetPixelRef<Vec3f>(x, y));
 
 #ifdef NFE_ENABLE_SPECTRAL_RENDERING
@@ -696,9 +879,11 @@ void Viewport::PostProcessTile(const Block& block, uint32 threadID)
                 rgbColor = Vec4f::Lerp(rgbColor, bloomColor, params.bloom.factor);
             }
 
-            // scale down by number of rendering passes finished
-            // TODO support different number of passes per-pixel (adaptive rendering)
-            rgbColor *= pixelScaling;
+            // scale down by number of samples accumulated in the pixel
+            if (numPasses > 1)
+            {
+                rgbColor /= static_cast<float>(numPasses);
+            }
 
             // apply exposure
             rgbColor *= mPostprocessParams.colorScale;
@@ -732,9 +917,7 @@ float Viewport::ComputeBlockError(const Block& block) const
         return std::numeric_limits<float>::max();
     }
 
-    NFE_ASSERT(mProgress.passesFinished % 2 == 0, "This funcion can be only called after even number of passes");
-
-    const float imageScalingFactor = 1.0f / (float)mProgress.passesFinished;
+    const bool compactSecondarySum = mSecondarySum.GetFormat() == Bitmap::Format::R16G16B16_Half;
 
     float totalError = 0.0f;
     for (uint32 y = block.minY; y < block.maxY; ++y)
@@ -742,9 +925,33 @@ float Viewport::ComputeBlockError(const Block& block) const
         float rowError = 0.0f;
         for (uint32 x = block.minX; x < block.maxX; ++x)
         {
-            const Vec4f a = imageScalingFactor * Vec4f_Load_Vec3f_Unsafe(mSum.GetPixelRef<Vec3f>(x, y));
-            const Vec4f b = (2.0f * imageScalingFactor) * Vec4f_Load_Vec3f_Unsafe(mSecondarySum.GetPixelRef<Vec3f>(x, y));
+            // pixels can have different number of samples (e.g. after cancelled pass)
+            const uint32 numPasses = mPassesPerPixel[GetWidth() * y + x];
+            if (numPasses < 2)
+            {
+                // not enough samples to estimate the error
+                return std::numeric_limits<float>::max();
+            }
+
+            const Vec4f sum = Vec4f_Load_Vec3f_Unsafe(mSum.GetPixelRef<Vec3f>(x, y));
+
+            // sum of even samples (secondary image in compact mode holds odd samples minus even samples)
+            Vec4f evenSum;
+            if (compactSecondarySum)
+            {
+                evenSum = 0.5f * (sum - Vec4f_Load_Half3(mSecondarySum.GetPixelRef<Half3>(x, y)));
+            }
+            else
+            {
+                evenSum = Vec4f_Load_Vec3f_Unsafe(mSecondarySum.GetPixelRef<Vec3f>(x, y));
+            }
+
+            // compare average of all samples with average of even samples
+            const uint32 numEvenPasses = (numPasses + 1) / 2;
+            const Vec4f a = sum / static_cast<float>(numPasses);
+            const Vec4f b = evenSum / static_cast<float>(numEvenPasses);
             const Vec4f diff = Vec4f::Abs(a - b);
+
             const float aLuminance = Vec4f::Dot3(c_rgbIntensityWeights, a);
             const float diffLuminance = Vec4f::Dot3(c_rgbIntensityWeights, diff);
             const float error = diffLuminance / Sqrt(NFE_MATH_EPSILON + aLuminance);
@@ -915,6 +1122,29 @@ void Viewport::UpdateBlocksList()
     mProgress.activeBlocks = mBlocks.Size();
 }
 
+ViewportMemoryStats Viewport::GetMemoryStats() const
+{
+    ViewportMemoryStats stats;
+    stats.sum = mSum.GetDataSize();
+    stats.secondarySum = mSecondarySum.GetDataSize();
+    stats.frontBuffer = mFrontBuffer.GetDataSize();
+    stats.passesPerPixel = sizeof(uint32) * mPassesPerPixel.Size();
+
+    for (const Bitmap& blurredImage : mBlurredImages)
+    {
+        stats.blurredImages += blurredImage.GetDataSize();
+    }
+
+    for (const RenderingContext& ctx : mThreadData)
+    {
+        const ArenaAllocatorStats arenaStats = ctx.arena.GetStats();
+        stats.scratchReserved += arenaStats.bytesReserved;
+        stats.scratchPeak += arenaStats.peakBytesUsed;
+    }
+
+    return stats;
+}
+
 void Viewport::VisualizeActiveBlocks(Bitmap& bitmap) const
 {
     NFE_SCOPED_TIMER(VisualizeActiveBlocks);
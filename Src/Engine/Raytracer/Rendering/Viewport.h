@@ -30,6 +30,23 @@ struct RenderingProgress
     float averageError = std::numeric_limits<float>::infinity();
 };
 
+// memory used by viewport's image buffers and per-thread scratch arenas (in bytes)
+struct ViewportMemoryStats
+{
+    size_t sum = 0;
+    size_t secondarySum = 0;
+    size_t frontBuffer = 0;
+    size_t blurredImages = 0;
+    size_t passesPerPixel = 0;
+    size_t scratchReserved = 0;     // total size of the arenas
+    size_t scratchPeak = 0;         // sum of arenas' high-water marks
+
+    NFE_FORCE_INLINE size_t GetTotal() const
+    {
+        return sum + secondarySum + frontBuffer + blurredImages + passesPerPixel + scratchReserved;
+    }
+};
+
 class NFE_ALIGN(32) Viewport
 {
     NFE_MAKE_NONCOPYABLE(Viewport)
@@ -45,7 +62,12 @@ public:
     NFE_RAYTRACER_API bool SetRenderingParams(const RenderingParams& params);
     NFE_RAYTRACER_API bool SetRenderer(IRenderer* renderer);
     NFE_RAYTRACER_API bool SetPostprocessParams(const PostprocessParams& params);
-    NFE_RAYTRACER_API bool Render(const Scene& scene, const Camera& camera);
+    // Render a single pass (one sample per pixel of active blocks).
+    // Rendering stops early if the cancellation token is cancelled. Samples of partially rendered pass are kept
+    // (pixels are normalized by their own number of samples). Returns false in such case.
+    // If the renderer splatted any samples (e.g. light tracer), the partial pass is discarded by resetting the accumulation.
+    // NOTE: accumulation is not reset automatically, call Reset() when the scene or camera changes.
+    NFE_RAYTRACER_API bool Render(const Scene& scene, const Camera& camera, const Common::CancellationToken* cancellationToken = nullptr);
     NFE_RAYTRACER_API void Reset();
 
     NFE_RAYTRACER_API void SetPixelBreakpoint(uint32 x, uint32 y);
@@ -59,6 +81,9 @@ public:
     NFE_FORCE_INLINE const RenderingProgress& GetProgress() const { return mProgress; }
     NFE_FORCE_INLINE const RayTracingCounters& GetCounters() const { return mCounters; }
 
+    // get memory usage report
+    NFE_RAYTRACER_API ViewportMemoryStats GetMemoryStats() const;
+
     NFE_RAYTRACER_API void VisualizeActiveBlocks(Bitmap& bitmap) const;
 
 private:
@@ -103,9 +128,14 @@ private:
     void UpdateBlocksList();
 
     // raytrace single image tile (will be called from multiple threads)
-    void RenderTile(const TileRenderingContext& tileContext, RenderingContext& renderingContext, const Block& tile);
+    // returns false if rendering was cancelled before finishing the tile
+    bool RenderTile(const TileRenderingContext& tileContext, RenderingContext& renderingContext, const Block& tile);
+
+    bool InitSecondarySum();
 
+    // blurred images are allocated on first use, so they take no memory when bloom is disabled
     bool InitBluredImages();
+    bool HasBlurredImages() const;
     void PerformPostProcess(Common::TaskBuilder& taskBuilder);
 
     // generate "front buffer" image from "sum" image
@@ -122,11 +152,10 @@ private:
     Common::DynArray<RenderingContext> mThreadData;
 
     Bitmap mSum;                        // image with accumulated samples (floating point, high dynamic range)
-    Bitmap mSecondarySum;               // contains image with every second sample - required for adaptive rendering
+    Bitmap mSecondarySum;               // contains image with every second sample (or odd/even passes difference in compact mode) - required for adaptive rendering
     Bitmap mFrontBuffer;                // postprocesses image (low dynamic range)
     Common::DynArray<Bitmap> mBlurredImages;    // blurred images for bloom
-    Common::DynArray<uint32> mPassesPerPixel;
-    Common::DynArray<Math::Vec2f> mPixelSalt; // salt value for each pixel
+    Common::DynArray<uint32> mPassesPerPixel;   // number of samples accumulated in each pixel
     Common::DynArray<TileOffset> mTileOffsets;
 
     RenderingParams mParams;
@@ -140,12 +140,16 @@ bool BitmapTexture::MakeSamplable()
     DynArray<float> importancePdf;
     importancePdf.Resize(width * height);
 
+    DynArray<Vec4f> row;
+    row.Resize(width);
+
     for (uint32 j = 0; j < height; ++j)
     {
+        mBitmap->ReadRow(j, row.Data());
+
         for (uint32 i = 0; i < width; ++i)
         {
-            const Vec4f value = mBitmap->GetPixel(i, j);
-            importancePdf[width * j + i] = Vec4f::Dot3(c_rgbIntensityWeights, value);
+            importancePdf[width * j + i] = Vec4f::Dot3(c_rgbIntensityWeights, row[i]);
         }
     }
 
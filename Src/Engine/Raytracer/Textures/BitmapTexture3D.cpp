@@ -16,8 +16,18 @@ BitmapTexture3D::BitmapTexture3D(const BitmapPtr& bitmap)
     , mFilter(BitmapTextureFilter::Linear)
 {}
 
+BitmapTexture3D::BitmapTexture3D(const SparseVolumePtr& volume)
+    : mVolume(volume)
+    , mFilter(BitmapTextureFilter::Linear)
+{}
+
 const char* BitmapTexture3D::GetName() const
 {
+    if (mVolume)
+    {
+        return mVolume->GetDebugName();
+    }
+
     if (!mBitmap)
     {
         return "<none>";
@@ -26,8 +36,48 @@ const char* BitmapTexture3D::GetName() const
     return mBitmap->GetDebugName();
 }
 
+const Vec4f BitmapTexture3D::EvaluateSparse(const Vec4f& warpedCoords) const
+{
+    const SparseVolume* volumePtr = mVolume.Get();
+
+    // volume is not initialized (or failed to load)
+    if (volumePtr->GetNumTotalBricks() == 0)
+    {
+        return Vec4f(volumePtr->GetBackground());
+    }
+
+    Vec4f result;
+
+    if (mFilter == BitmapTextureFilter::NearestNeighbor)
+    {
+        const Vec4ui texelCoords = Vec4ui::Min(Vec4ui::TruncateAndConvert(warpedCoords * volumePtr->GetFloatSize()), volumePtr->GetSize() - 1u);
+        result = Vec4f(volumePtr->GetVoxel(texelCoords.x, texelCoords.y, texelCoords.z));
+    }
+    else if (mFilter == BitmapTextureFilter::Linear)
+    {
+        result = Vec4f(volumePtr->SampleTrilinear(warpedCoords * volumePtr->GetFloatSize()));
+    }
+    else
+    {
+        NFE_FATAL("Invalid bitmap filter mode");
+        result = Vec4f::Zero();
+    }
+
+    NFE_ASSERT(result.IsValid(), "");
+
+    return result;
+}
+
 const Vec4f BitmapTexture3D::Evaluate(const Vec4f& coords) const
 {
+    // wrap to 0..1 range
+    const Vec4f warpedCoords = Vec4f::Mod1(coords * Vec4f(0.5f/1.25f, 0.5f/0.85f, 0.5f/1.53f) + Vec4f(0.5f, 0.5f, 0.5f));
+
+    if (mVolume)
+    {
+        return EvaluateSparse(warpedCoords);
+    }
+
     const Bitmap* bitmapPtr = mBitmap.Get();
 
     if (!bitmapPtr)
@@ -38,9 +88,6 @@ const Vec4f BitmapTexture3D::Evaluate(const Vec4f& coords) const
     // bitmap size
     const Vec4i size(bitmapPtr->GetSize());
 
-    // wrap to 0..1 range
-    const Vec4f warpedCoords = Vec4f::Mod1(coords * Vec4f(0.5f/1.25f, 0.5f/0.85f, 0.5f/1.53f) + Vec4f(0.5f, 0.5f, 0.5f));
-
     // compute texel coordinates
     const Vec4f scaledCoords = warpedCoords * bitmapPtr->mFloatSize;
     const Vec4i intCoords = Vec4i::TruncateAndConvert(scaledCoords);
@@ -1,16 +1,18 @@
 #pragma once
 
 #include "BitmapTexture.h"
+#include "../Utils/SparseVolume.h"
 
 namespace NFE {
 namespace RT {
 
-// 3D texture wrapper for Bitmap class
+// 3D texture wrapper for Bitmap and SparseVolume classes
 class BitmapTexture3D : public ITexture
 {
 public:
     NFE_RAYTRACER_API BitmapTexture3D();
     NFE_RAYTRACER_API BitmapTexture3D(const BitmapPtr& bitmap);
+    NFE_RAYTRACER_API BitmapTexture3D(const SparseVolumePtr& volume);
     ~BitmapTexture3D();
 
     virtual const char* GetName() const override;
@@ -21,7 +23,10 @@ public:
     virtual bool IsSamplable() const override;
 
 private:
+    const Math::Vec4f EvaluateSparse(const Math::Vec4f& warpedCoords) const;
+
     BitmapPtr mBitmap;
+    SparseVolumePtr mVolume;
     BitmapTextureFilter mFilter;
 };
 
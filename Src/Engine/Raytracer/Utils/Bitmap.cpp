@@ -1,9 +1,11 @@
 #include "PCH.h"
 #include "Bitmap.h"
 #include "BlockCompression.h"
+#include "../Common/Containers/DynArray.hpp"
 #include "../Common/Math/ColorHelpers.hpp"
 #include "../Common/Math/PackedLoadVec4f.hpp"
 #include "../Common/Logger/Logger.hpp"
+#include "../Common/Memory/AllocationTracker.hpp"
 #include "../Common/System/Timer.hpp"
 
 namespace NFE {
@@ -86,7 +88,8 @@ const char* Bitmap::FormatToString(Format format)
 size_t Bitmap::ComputeDataSize(const InitData& initData)
 {
     const uint32 stride = Max(initData.stride, ComputeDataStride(initData.width, initData.format));
-    const uint64 dataSize = (uint64)initData.depth * (uint64)initData.height * (uint64)stride;
+    const uint64 numRows = ComputeNumDataRows(initData.height, initData.format);
+    const uint64 dataSize = (uint64)initData.depth * numRows * (uint64)stride;
 
     if (dataSize >= (uint64)std::numeric_limits<size_t>::max())
     {
@@ -98,6 +101,13 @@ size_t Bitmap::ComputeDataSize(const InitData& initData)
 
 uint32 Bitmap::ComputeDataStride(uint32 width, Format format)
 {
+    if (IsBlockCompressed(format))
+    {
+        // round up, so dimensions that are not multiple of 4 are supported
+        const uint32 numBlocks = (width + 3u) / 4u;
+        return numBlocks * 16u * BitsPerPixel(format) / 8u;
+    }
+
     return width * (uint64)BitsPerPixel(format) / 8;
 }
 
@@ -175,7 +185,7 @@ void Bitmap::Release()
     if (mPalette)
     {
         NFE_FREE(mPalette);
-        mData = nullptr;
+        mPalette = nullptr;
     }
 
     mSize = Vec4ui::Zero();
@@ -263,7 +273,7 @@ bool Bitmap::Copy(Bitmap& target, const Bitmap& source)
     else
     {
         uint32 rowSize = ComputeDataStride(source.GetWidth(), source.mFormat);
-        size_t numRows = (size_t)source.GetHeight() * (size_t)source.GetDepth();
+        size_t numRows = (size_t)ComputeNumDataRows(source.GetHeight(), source.mFormat) * (size_t)source.GetDepth();
         for (size_t i = 0; i < numRows; ++i)
         {
             memcpy(target.GetData() + size_t(target.GetStride()) * i, source.GetData() + size_t(source.GetStride()) * i, rowSize);
@@ -278,9 +288,12 @@ bool Bitmap::Copy(Bitmap& target, const Bitmap& source)
     return true;
 }
 
-bool Bitmap::Load(const char* path)
+bool Bitmap::Load(const char* path, TaskBuilder* taskBuilder)
 {
+    NFE_MEMORY_TAG_SCOPE("Bitmap");
+
     Timer timer;
+    timer.Start();
 
     FILE* file = fopen(path, "rb");
     if (!file)
@@ -289,29 +302,41 @@ bool Bitmap::Load(const char* path)
         return false;
     }
 
-    if (!LoadBMP(file, path))
+    // pick the loader based on file signature, so the file is parsed only once
+    uint32 magic = 0;
+    if (fread(&magic, sizeof(magic), 1, file) != 1)
     {
-        fseek(file, SEEK_SET, 0);
-
-        if (!LoadDDS(file, path))
-        {
-            fseek(file, SEEK_SET, 0);
+        NFE_LOG_ERROR("Failed to read file signature of '%hs'", path);
+        fclose(file);
+        return false;
+    }
+    fseek(file, 0, SEEK_SET);
 
-            if (!LoadEXR(file, path))
-            {
-                //if (!LoadVDB(file, path))
-                //{
-                //    NFE_LOG_ERROR("Failed to load '%hs' - unknown format", path);
-                //    fclose(file);
-                //    return false;
-                //}
-                return false;
-            }
-        }
+    bool result = false;
+    if ((magic & 0xFFFF) == 0x4D42) // "BM"
+    {
+        result = LoadBMP(file, path);
+    }
+    else if (magic == 0x20534444) // "DDS "
+    {
+        result = LoadDDS(file, path);
+    }
+    else if (magic == 0x01312F76) // OpenEXR
+    {
+        result = LoadEXR(file, path, taskBuilder);
+    }
+    else
+    {
+        NFE_LOG_ERROR("Failed to load '%hs' - unknown format", path);
     }
 
     fclose(file);
 
+    if (!result)
+    {
+        return false;
+    }
+
     const float elapsedTime = static_cast<float>(1000.0 * timer.Stop());
     NFE_LOG_INFO("Bitmap '%hs' loaded in %.3fms: width=%u, height=%u, depth=%u, format=%s, %s",
         path, elapsedTime, GetWidth(), GetHeight(), GetDepth(), FormatToString(mFormat),
@@ -485,19 +510,19 @@ const Vec4f Bitmap::GetPixel(uint32 x, uint32 y) const
 
     case Format::BC1:
     {
-        color = DecodeBC1(reinterpret_cast<const uint8*>(mData), x, y, GetWidth());
+        color = DecodeBC(mFormat, mData, x, y, GetWidth());
         break;
     }
 
     case Format::BC4:
     {
-        color = DecodeBC4(reinterpret_cast<const uint8*>(mData), x, y, GetWidth());
+        color = DecodeBC(mFormat, mData, x, y, GetWidth());
         break;
     }
 
     case Format::BC5:
     {
-        color = DecodeBC5(reinterpret_cast<const uint8*>(mData), x, y, GetWidth());
+        color = DecodeBC(mFormat, mData, x, y, GetWidth());
         break;
     }
 
@@ -799,28 +824,19 @@ void Bitmap::GetPixelBlock(const Vec4ui coords, Vec4f* outColors) const
 
     case Format::BC1:
     {
-        color[0] = DecodeBC1(mData, coords.x, coords.y, GetWidth());
-        color[1] = DecodeBC1(mData, coords.z, coords.y, GetWidth());
-        color[2] = DecodeBC1(mData, coords.x, coords.w, GetWidth());
-        color[3] = DecodeBC1(mData, coords.z, coords.w, GetWidth());
+        DecodeBCPixelBlock(mFormat, mData, coords, GetWidth(), color);
         break;
     }
 
     case Format::BC4:
     {
-        color[0] = DecodeBC4(mData, coords.x, coords.y, GetWidth());
-        color[1] = DecodeBC4(mData, coords.z, coords.y, GetWidth());
-        color[2] = DecodeBC4(mData, coords.x, coords.w, GetWidth());
-        color[3] = DecodeBC4(mData, coords.z, coords.w, GetWidth());
+        DecodeBCPixelBlock(mFormat, mData, coords, GetWidth(), color);
         break;
     }
 
     case Format::BC5:
     {
-        color[0] = DecodeBC5(mData, coords.x, coords.y, GetWidth());
-        color[1] = DecodeBC5(mData, coords.z, coords.y, GetWidth());
-        color[2] = DecodeBC5(mData, coords.x, coords.w, GetWidth());
-        color[3] = DecodeBC5(mData, coords.z, coords.w, GetWidth());
+        DecodeBCPixelBlock(mFormat, mData, coords, GetWidth(), color);
         break;
     }
 
@@ -962,38 +978,55 @@ bool Bitmap::Scale(const Math::Vec4f& factor)
 {
     const uint32 width = GetWidth();
     const uint32 height = GetHeight();
+    const uint32 depth = GetDepth();
 
-    if (mFormat == Format::R32G32B32_Float)
+    if (IsBlockCompressed(mFormat) || mFormat == Format::B8G8R8A8_UNorm_Palette)
     {
-        for (uint32 y = 0; y < height; ++y)
+        NFE_LOG_ERROR("Bitmap::Scale: Unsupported texture format: %s", FormatToString(mFormat));
+        return false;
+    }
+
+    if (mFormat == Format::R32G32B32A32_Float)
+    {
+        for (uint32 z = 0; z < depth; ++z)
         {
-            for (uint32 x = 0; x < width; ++x)
+            for (uint32 y = 0; y < height; ++y)
             {
-                Vec3f& pixelPtr = GetPixelRef<Vec3f>(x, y);
-                pixelPtr.x *= factor.x;
-                pixelPtr.y *= factor.y;
-                pixelPtr.z *= factor.z;
+                for (uint32 x = 0; x < width; ++x)
+                {
+                    GetPixelRef<Vec4f>(x, y, z) *= factor;
+                }
             }
         }
         return true;
     }
-    else if (mFormat == Format::R32G32B32A32_Float)
+
+    DynArray<Vec4f> row;
+    row.Resize(width);
+
+    for (uint32 z = 0; z < depth; ++z)
     {
         for (uint32 y = 0; y < height; ++y)
         {
+            if (!ReadRow(y, row.Data(), z))
+            {
+                return false;
+            }
+
             for (uint32 x = 0; x < width; ++x)
             {
-                Vec4f& pixelPtr = GetPixelRef<Vec4f>(x, y);
-                pixelPtr *= factor;
+                row[x] *= factor;
+            }
+
+            if (!WriteRow(y, row.Data(), z))
+            {
+                return false;
             }
         }
-        return true;
     }
 
-    NFE_LOG_ERROR("Bitmap::Scale: Unsupported texture format");
-    return false;
+    return true;
 }
 
-
 } // namespace RT
 } // namespace NFE
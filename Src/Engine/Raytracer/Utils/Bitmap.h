@@ -117,10 +117,23 @@ public:
     NFE_FORCE_INLINE Format GetFormat() const { return mFormat; }
 
     // get allocated size
-    NFE_FORCE_INLINE size_t GetDataSize() const { return (size_t)GetStride() * (size_t)GetHeight() * (size_t)GetDepth(); }
+    NFE_FORCE_INLINE size_t GetDataSize() const { return (size_t)GetStride() * (size_t)ComputeNumDataRows(GetHeight(), mFormat) * (size_t)GetDepth(); }
 
     static size_t ComputeDataSize(const InitData& initData);
-    static uint32 ComputeDataStride(uint32 width, Format format);
+
+    // NOTE: for block-compressed formats, stride is the size of a row of 4x4 blocks
+    NFE_RAYTRACER_API static uint32 ComputeDataStride(uint32 width, Format format);
+
+    // get number of data rows in a single slice (number of block rows for block-compressed formats)
+    NFE_FORCE_INLINE static uint32 ComputeNumDataRows(uint32 height, Format format)
+    {
+        return IsBlockCompressed(format) ? (height + 3u) / 4u : height;
+    }
+
+    NFE_FORCE_INLINE static bool IsBlockCompressed(Format format)
+    {
+        return format == Format::BC1 || format == Format::BC4 || format == Format::BC5;
+    }
 
     // initialize bitmap with data (or clean if passed nullptr)
     NFE_RAYTRACER_API bool Init(const InitData& initData);
@@ -133,20 +146,23 @@ public:
     NFE_RAYTRACER_API static bool Copy(Bitmap& target, const Bitmap& source);
 
     // load from file
-    NFE_RAYTRACER_API bool Load(const char* path);
+    // If task builder is provided, pixel format conversion may be split into tasks pushed to the builder.
+    // In such case, bitmap data is valid only after all the builder's tasks are finished.
+    NFE_RAYTRACER_API bool Load(const char* path, Common::TaskBuilder* taskBuilder = nullptr);
 
     // save to BMP file
+    // NOTE: pixels are converted to 8-bit BGR if needed
     NFE_RAYTRACER_API bool SaveBMP(const char* path, bool flipVertically) const;
 
     // save to OpenEXR file
-    // NOTE: must be float or Half format
+    // NOTE: pixels of non-float formats are converted to floats
     NFE_RAYTRACER_API bool SaveEXR(const char* path, const float exposure = 1.0f) const;
 
     // calculate number of bits per pixel for given format
-    static uint8 BitsPerPixel(Format format);
+    NFE_RAYTRACER_API static uint8 BitsPerPixel(Format format);
 
     // get bitmap format description
-    static const char* FormatToString(Format format);
+    NFE_RAYTRACER_API static const char* FormatToString(Format format);
 
     // get single pixel
     NFE_RAYTRACER_API const Math::Vec4f GetPixel(uint32 x, uint32 y) const;
@@ -158,6 +174,20 @@ public:
     // get 2x2x2 pixel block
     NFE_RAYTRACER_API void GetPixelBlock3D(const Math::Vec4ui coordsA, const Math::Vec4ui coordsB, Math::Vec4f* outColors) const;
 
+    // convert tightly packed pixels to floats (produces the same values as GetPixel)
+    // NOTE: palette is required for B8G8R8A8_UNorm_Palette format, block-compressed formats are not supported
+    NFE_RAYTRACER_API static bool DecodePixels(Format format, const void* source, Math::Vec4f* target, uint32 numPixels, const uint8* palette = nullptr);
+
+    // convert floats to tightly packed pixels (normalized formats are clamped to 0...1 range)
+    // NOTE: palette and block-compressed formats are not supported
+    NFE_RAYTRACER_API static bool EncodePixels(Format format, const Math::Vec4f* source, void* target, uint32 numPixels);
+
+    // decode whole row of pixels (outPixels must hold GetWidth() elements)
+    NFE_RAYTRACER_API bool ReadRow(uint32 y, Math::Vec4f* outPixels, uint32 z = 0) const;
+
+    // encode whole row of pixels (pixels must hold GetWidth() elements)
+    NFE_RAYTRACER_API bool WriteRow(uint32 y, const Math::Vec4f* pixels, uint32 z = 0);
+
     // fill with zeros
     NFE_RAYTRACER_API void Clear();
 
@@ -172,7 +202,7 @@ private:
 
     bool LoadBMP(FILE* file, const char* path);
     bool LoadDDS(FILE* file, const char* path);
-    bool LoadEXR(FILE* file, const char* path);
+    bool LoadEXR(FILE* file, const char* path, Common::TaskBuilder* taskBuilder);
     bool LoadVDB(FILE* file, const char* path);
 
     Math::Vec4ui mSize = Math::Vec4ui::Zero(); // width, height, depth, stride
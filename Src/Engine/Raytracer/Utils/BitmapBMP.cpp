@@ -147,38 +147,37 @@ bool Bitmap::SaveBMP(const char* path, bool flipVertically) const
         return false;
     }
 
-    uint32 dataSize = 3 * GetWidth() * GetHeight();
+    const uint32 width = GetWidth();
+    const uint32 height = GetHeight();
+    const uint32 rowSize = 3 * width;
+    const uint32 dataSize = rowSize * height;
 
     Common::DynArray<uint8> tmpData(dataSize);
-    const uint8* dataPtr = nullptr;
+    Common::DynArray<Vec4f> row;
+    if (mFormat != Format::B8G8R8_UNorm)
+    {
+        row.Resize(width);
+    }
 
-    if (mFormat == Format::B8G8R8A8_UNorm)
+    for (uint32 y = 0; y < height; ++y)
     {
-        const uint8* rawData = reinterpret_cast<const uint8*>(mData);
+        const uint32 realY = flipVertically ? height - 1 - y : y;
+        uint8* targetRow = tmpData.Data() + static_cast<size_t>(rowSize) * y;
 
-        uint32 i = 0;
-        for (uint32 y = 0; y < (uint32)GetHeight(); ++y)
+        if (mFormat == Format::B8G8R8_UNorm)
         {
-            const uint32 realY = flipVertically ? GetHeight() - 1 - y : y;
-            for (uint32 x = 0; x < (uint32)GetWidth(); ++x)
-            {
-                const uint32 p = GetWidth() * realY + x;
-                tmpData[i++] = rawData[4 * p];
-                tmpData[i++] = rawData[4 * p + 1];
-                tmpData[i++] = rawData[4 * p + 2];
-            }
+            memcpy(targetRow, mData + static_cast<size_t>(GetStride()) * realY, rowSize);
+            continue;
         }
 
-        dataPtr = tmpData.Data();
-    }
-    else if (mFormat == Format::B8G8R8_UNorm)
-    {
-        dataPtr = reinterpret_cast<const uint8*>(mData);
-    }
-    else
-    {
-        NFE_LOG_ERROR("Bitmap::SaveBMP: Unsupported format: %s", FormatToString(mFormat));
-        return false;
+        // any other format is converted through floats
+        if (!ReadRow(realY, row.Data()))
+        {
+            NFE_LOG_ERROR("Bitmap::SaveBMP: Unsupported format: %s", FormatToString(mFormat));
+            return false;
+        }
+
+        EncodePixels(Format::B8G8R8_UNorm, row.Data(), targetRow, width);
     }
 
     const BMPHeader header =
@@ -219,7 +218,7 @@ bool Bitmap::SaveBMP(const char* path, bool flipVertically) const
         return false;
     }
 
-    if (fwrite(dataPtr, dataSize, 1, file) != 1)
+    if (fwrite(tmpData.Data(), dataSize, 1, file) != 1)
     {
         NFE_LOG_ERROR("Failed to write bitmap image data to file '%s', code = %u", path, stderr);
         fclose(file);
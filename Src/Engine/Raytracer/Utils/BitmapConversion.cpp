@@ -0,0 +1,834 @@
+#include "PCH.h"
+#include "Bitmap.h"
+#include "BlockCompression.h"
+#include "../Common/Math/PackedLoadVec4f.hpp"
+#include "../Common/Logger/Logger.hpp"
+
+namespace NFE {
+namespace RT {
+
+using namespace Math;
+
+namespace {
+
+#ifdef NFE_USE_AVX2
+
+// store 8 values as 8 pixels with the value replicated in all channels
+NFE_FORCE_INLINE void StoreSplat8(const __m256 v, Vec4f* target)
+{
+    float* out = reinterpret_cast<float*>(target);
+    _mm256_storeu_ps(out +  0, _mm256_permutevar8x32_ps(v, _mm256_setr_epi32(0, 0, 0, 0, 1, 1, 1, 1)));
+    _mm256_storeu_ps(out +  8, _mm256_permutevar8x32_ps(v, _mm256_setr_epi32(2, 2, 2, 2, 3, 3, 3, 3)));
+    _mm256_storeu_ps(out + 16, _mm256_permutevar8x32_ps(v, _mm256_setr_epi32(4, 4, 4, 4, 5, 5, 5, 5)));
+    _mm256_storeu_ps(out + 24, _mm256_permutevar8x32_ps(v, _mm256_setr_epi32(6, 6, 6, 6, 7, 7, 7, 7)));
+}
+
+// store 8 pixels given as planar channels
+NFE_FORCE_INLINE void StoreTransposed8(const __m256 x, const __m256 y, const __m256 z, const __m256 w, Vec4f* target)
+{
+    const __m256 t0 = _mm256_unpacklo_ps(x, y);
+    const __m256 t1 = _mm256_unpackhi_ps(x, y);
+    const __m256 t2 = _mm256_unpacklo_ps(z, w);
+    const __m256 t3 = _mm256_unpackhi_ps(z, w);
+
+    // pixels (0,4), (1,5), (2,6), (3,7)
+    const __m256 p0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 p1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m256 p2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 p3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+
+    float* out = reinterpret_cast<float*>(target);
+    _mm256_storeu_ps(out +  0, _mm256_permute2f128_ps(p0, p1, 0x20));
+    _mm256_storeu_ps(out +  8, _mm256_permute2f128_ps(p2, p3, 0x20));
+    _mm256_storeu_ps(out + 16, _mm256_permute2f128_ps(p0, p1, 0x31));
+    _mm256_storeu_ps(out + 24, _mm256_permute2f128_ps(p2, p3, 0x31));
+}
+
+// load 8 pixels as planar channels
+NFE_FORCE_INLINE void LoadTransposed8(const Vec4f* source, __m256& x, __m256& y, __m256& z, __m256& w)
+{
+    const float* in = reinterpret_cast<const float*>(source);
+    const __m256 r0 = _mm256_loadu_ps(in +  0);
+    const __m256 r1 = _mm256_loadu_ps(in +  8);
+    const __m256 r2 = _mm256_loadu_ps(in + 16);
+    const __m256 r3 = _mm256_loadu_ps(in + 24);
+
+    // pixels (0,4), (1,5), (2,6), (3,7)
+    const __m256 a0 = _mm256_permute2f128_ps(r0, r2, 0x20);
+    const __m256 a1 = _mm256_permute2f128_ps(r0, r2, 0x31);
+    const __m256 a2 = _mm256_permute2f128_ps(r1, r3, 0x20);
+    const __m256 a3 = _mm256_permute2f128_ps(r1, r3, 0x31);
+
+    const __m256 t0 = _mm256_unpacklo_ps(a0, a1);
+    const __m256 t1 = _mm256_unpackhi_ps(a0, a1);
+    const __m256 t2 = _mm256_unpacklo_ps(a2, a3);
+    const __m256 t3 = _mm256_unpackhi_ps(a2, a3);
+
+    x = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+    y = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    z = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    w = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+}
+
+NFE_FORCE_INLINE __m256 ConvertUint8ToFloat(const __m128i v)
+{
+    return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(v));
+}
+
+// decode unsigned float with 5-bit exponent (zero exponent encodes denormal value)
+NFE_FORCE_INLINE __m256 DecodeUFloat8(const __m256i packed, const int mantissaShift, const int mantissaBits)
+{
+    const __m256i mantissa = _mm256_and_si256(_mm256_srli_epi32(packed, mantissaShift), _mm256_set1_epi32((1 << mantissaBits) - 1));
+    const __m256i exponent = _mm256_and_si256(_mm256_srli_epi32(packed, mantissaShift + mantissaBits), _mm256_set1_epi32(0x1F));
+
+    const __m256i normal = _mm256_or_si256(
+        _mm256_slli_epi32(_mm256_add_epi32(exponent, _mm256_set1_epi32(112)), 23),
+        _mm256_sll_epi32(mantissa, _mm_cvtsi32_si128(23 - mantissaBits)));
+    const __m256 denormal = _mm256_mul_ps(_mm256_cvtepi32_ps(mantissa), _mm256_set1_ps(1.0f / static_cast<float>(1u << (14 + mantissaBits))));
+
+    const __m256 isDenormal = _mm256_castsi256_ps(_mm256_cmpeq_epi32(exponent, _mm256_setzero_si256()));
+    return _mm256_blendv_ps(_mm256_castsi256_ps(normal), denormal, isDenormal);
+}
+
+#endif // NFE_USE_AVX2
+
+NFE_FORCE_INLINE uint8 FloatToUNorm8(float v)
+{
+    return static_cast<uint8>(Clamp(v, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+NFE_FORCE_INLINE uint16 FloatToUNorm16(float v)
+{
+    return static_cast<uint16>(Clamp(v, 0.0f, 1.0f) * 65535.0f + 0.5f);
+}
+
+NFE_FORCE_INLINE uint32 FloatToUNorm(float v, float maxValue)
+{
+    return static_cast<uint32>(Clamp(v, 0.0f, 1.0f) * maxValue + 0.5f);
+}
+
+// encode non-negative float to unsigned float with 5-bit exponent
+NFE_FORCE_INLINE uint32 EncodeUFloat(float value, uint32 mantissaBits)
+{
+    const uint32 maxBits = ((30u + 112u) << 23) | (((1u << mantissaBits) - 1u) << (23u - mantissaBits));
+
+    if (!(value > 0.0f)) // also catches NaN
+    {
+        return 0;
+    }
+
+    uint32 bits;
+    memcpy(&bits, &value, sizeof(uint32));
+    bits = Min(bits, maxBits);
+
+    const uint32 exponent = bits >> 23;
+    if (exponent <= 112u)
+    {
+        // denormal
+        return static_cast<uint32>(value * static_cast<float>(1u << (14u + mantissaBits)) + 0.5f);
+    }
+
+    const uint32 mantissa = (bits & 0x7FFFFFu) >> (23u - mantissaBits);
+    return ((exponent - 112u) << mantissaBits) | mantissa;
+}
+
+void DecodePixels_R8_UNorm(const uint8* source, Vec4f* target, const uint32 numPixels)
+{
+    uint32 i = 0;
+#ifdef NFE_USE_AVX2
+    for (; i + 8 <= numPixels; i += 8)
+    {
+        const __m256 v = _mm256_mul_ps(ConvertUint8ToFloat(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(source + i))), _mm256_set1_ps(1.0f / 255.0f));
+        StoreSplat8(v, target + i);
+    }
+#endif // NFE_USE_AVX2
+    for (; i < numPixels; ++i)
+    {
+        target[i] = Vec4f::FromInteger(source[i]) * (1.0f / 255.0f);
+    }
+}
+
+void DecodePixels_R8G8_UNorm(const uint8* source, Vec4f* target, const uint32 numPixels)
+{
+    uint32 i = 0;
+#ifdef NFE_USE_AVX2
+    const __m128i deinterleave = _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+    const __m256 scale = _mm256_set1_ps(1.0f / 255.0f);
+    for (; i + 8 <= numPixels; i += 8)
+    {
+        const __m128i v = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source + 2u * i)), deinterleave);
+        const __m256 x = _mm256_mul_ps(ConvertUint8ToFloat(v), scale);
+        const __m256 y = _mm256_mul_ps(ConvertUint8ToFloat(_mm_srli_si128(v, 8)), scale);
+        StoreTransposed8(x, y, _mm256_setzero_ps(), _mm256_setzero_ps(), target + i);
+    }
+#endif // NFE_USE_AVX2
+    for (; i < numPixels; ++i)
+    {
+        target[i] = Vec4f_Load_2xUint8_Norm(source + 2u * i);
+    }
+}
+
+void DecodePixels_B8G8R8_UNorm(const uint8* source, Vec4f* target, const uint32 numPixels)
+{
+    uint32 i = 0;
+#ifdef NFE_USE_AVX2
+    // gather (R, G, B) channels of 4 pixels, second load is shifted by 8 bytes to stay within the span
+    const __m128i deinterleaveLo = _mm_setr_epi8(2, 5, 8, 11, 1, 4, 7, 10, 0, 3, 6, 9, -1, -1, -1, -1);
+    const __m128i deinterleaveHi = _mm_setr_epi8(6, 9, 12, 15, 5, 8, 11, 14, 4, 7, 10, 13, -1, -1, -1, -1);
+    const __m256 scale = _mm256_set1_ps(1.0f / 255.0f);
+    for (; i + 8 <= numPixels; i += 8)
+    {
+        const uint8* pixels = source + 3u * i;
+        const __m128i lo = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels)), deinterleaveLo);
+        const __m128i hi = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + 8)), deinterleaveHi);
+        const __m128i rg = _mm_unpacklo_epi32(lo, hi);
+        const __m128i b = _mm_unpackhi_epi32(lo, hi);
+        const __m256 x = _mm256_mul_ps(ConvertUint8ToFloat(rg), scale);
+        const __m256 y = _mm256_mul_ps(ConvertUint8ToFloat(_mm_srli_si128(rg, 8)), scale);
+        const __m256 z = _mm256_mul_ps(ConvertUint8ToFloat(b), scale);
+        StoreTransposed8(x, y, z, _mm256_setzero_ps(), target + i);
+    }
+#endif // NFE_USE_AVX2
+    for (; i < numPixels; ++i)
+    {
+        const uint8* pixel = source + 3u * i;
+        target[i] = Vec4f::FromIntegers(pixel[2], pixel[1], pixel[0], 0) * (1.0f / 255.0f);
+    }
+}
+
+template<bool SwapRedBlue>
+void DecodePixels_RGBA8_UNorm(const uint8* source, Vec4f* target, const uint32 numPixels)
+{
+    uint32 i = 0;
+#ifdef NFE_USE_AVX2
+    const __m256i deinterleave = _mm256_setr_epi8(
+        0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15,
+        0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+    const __m256i gatherChannels = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    const __m256 scale = _mm256_set1_ps(1.0f / 255.0f);
+    for (; i + 8 <= numPixels; i += 8)
+    {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + 4u * i));
+        v = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(v, deinterleave), gatherChannels);
+
+        const __m128i c01 = _mm256_castsi256_si128(v);
+        const __m128i c23 = _mm256_extracti128_si256(v, 1);
+        const __m256 c0 = _mm256_mul_ps(ConvertUint8ToFloat(c01), scale);
+        const __m256 c1 = _mm256_mul_ps(ConvertUint8ToFloat(_mm_srli_si128(c01, 8)), scale);
+        const __m256 c2 = _mm256_mul_ps(ConvertUint8ToFloat(c23), scale);
+        const __m256 c3 = _mm256_mul_ps(ConvertUint8ToFloat(_mm_srli_si128(c23, 8)), scale);
+
+        if (SwapRedBlue)
+        {
+            StoreTransposed8(c2, c1, c0, c3, target + i);
+        }
+        else
+        {
+            StoreTransposed8(c0, c1, c2, c3, target + i);
+        }
+    }
+#endif // NFE_USE_AVX2
+    for (; i < numPixels; ++i)
+    {
+        const Vec4f color = Vec4f_Load_4xUint8(source + 4u * i) * (1.0f / 255.0f);
+        target[i] = SwapRedBlue ? color.Swizzle<2, 1, 0, 3>() : color;
+    }
+}
+
+void DecodePixels_R16_UNorm(const uint16* source, Vec4f* target, const uint32 numPixels)
+{
+    uint32 i = 0;
+#ifdef NFE_USE_AVX2
+    for (; i + 8 <= numPixels; i += 8)
+    {
+        const __m256i ints = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i)));
+        StoreSplat8(_mm256_mul_ps(_mm256_cvtepi32_ps(ints), _mm256_set1_ps(1.0f / 65535.0f)), target + i);
+    }
+#endif // NFE_USE_AVX2
+    for (; i < numPixels; ++i)
+    {
+        target[i] = Vec4f::FromInteger(source[i]) * (1.0f / 65535.0f);
+    }
+}
+
+void DecodePixels_R16G16B16A16_UNorm(const uint16* source, Vec4f* target, const uint32 numPixels)
+{
+    uint32 i = 0;
+#ifdef NFE_USE_AVX2
+    for (; i + 2 <= numPixels; i += 2)
+    {
+        const __m256i ints = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source + 4u * i)));
+        _mm256_storeu_ps(reinterpret_cast<float*>(target + i), _mm256_mul_ps(_mm256_cvtepi32_ps(ints), _mm256_set1_ps(1.0f / 65535.0f)));
+    }
+#endif // NFE_USE_AVX2
+    for (; i < numPixels; ++i)
+    {
+        target[i] = Vec4f_Load_4xUint16(source + 4u * i) * (1.0f / 65535.0f);
+    }
+}
+
+void DecodePixels_R32_Float(const float* source, Vec4f* target, const uint32 numPixels)
+{
+    uint32 i = 0;
+#ifdef NFE_USE_AVX2
+    for (; i + 8 <= numPixels; i += 8)
+    {
+        StoreSplat8(_mm256_loadu_ps(source + i), target + i);
+    }
+#endif // NFE_USE_AVX2
+    for (; i < numPixels; ++i)
+    {
+        target[i] = Vec4f(source[i]);
+    }
+}
+
+void DecodePixels_R16_Half(const Half* source, Vec4f* target, const uint32 numPixels)
+{
+    uint32 i = 0;
+#ifdef NFE_USE_AVX2
+    for (; i + 8 <= numPixels; i += 8)
+    {
+        StoreSplat8(_mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i))), target + i);
+    }
+#endif // NFE_USE_AVX2
+    for (; i < numPixels; ++i)
+    {
+        target[i] = Vec4f(source[i].ToFloat());
+    }
+}
+
+void DecodePixels_R16G16B16_Half(const Half3* source, Vec4f* target, const uint32 numPixels)
+{
+    uint32 i = 0;
+#ifdef NFE_USE_AVX2
+    // two pixels per iteration, loads are overlapping so no bytes past the last pixel are read
+    const __m128i expand = _mm_setr_epi8(0, 1, 2, 3, 4, 5, -1, -1, 10, 11, 12, 13, 14, 15, -1, -1);
+    for (; i + 2 <= numPixels; i += 2)
+    {
+        const uint8* pixels = reinterpret_cast<const uint8*>(source + i);
+        const __m128i lo = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(pixels));
+        const __m128i hi = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(pixels + 4));
+        const __m128i halfs = _mm_shuffle_epi8(_mm_unpacklo_epi64(lo, hi), expand);
+        _mm256_storeu_ps(reinterpret_cast<float*>(target + i), _mm256_cvtph_ps(halfs));
+    }
+#endif // NFE_USE_AVX2
+    for (; i < numPixels; ++i)
+    {
+        const Half4 value = { source[i].x, source[i].y, source[i].z, Half(static_cast<uint16>(0)) };
+        target[i] = Vec4f_Load_Half4(value);
+    }
+}
+
+void DecodePixels_R16G16B16A16_Half(const Half4* source, Vec4f* target, const uint32 numPixels)
+{
+    uint32 i = 0;
+#ifdef NFE_USE_AVX2
+    for (; i + 2 <= numPixels; i += 2)
+    {
+        _mm256_storeu_ps(reinterpret_cast<float*>(target + i), _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i))));
+    }
+#endif // NFE_USE_AVX2
+    for (; i < numPixels; ++i)
+    {
+        target[i] = Vec4f_Load_Half4(source[i]);
+    }
+}
+
+void DecodePixels_R11G11B10_Float(const PackedUFloat3_11_11_10* source, Vec4f* target, const uint32 numPixels)
+{
+    uint32 i = 0;
+#ifdef NFE_USE_AVX2
+    for (; i + 8 <= numPixels; i += 8)
+    {
+        const __m256i packed = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i));
+        const __m256 x = DecodeUFloat8(packed, 0, 6);
+        const __m256 y = DecodeUFloat8(packed, 11, 6);
+        const __m256 z = DecodeUFloat8(packed, 22, 5);
+        StoreTransposed8(x, y, z, _mm256_setzero_ps(), target + i);
+    }
+#endif // NFE_USE_AVX2
+    for (; i < numPixels; ++i)
+    {
+        target[i] = LoadVec4f(source[i]);
+    }
+}
+
+void DecodePixels_R9G9B9E5_SharedExp(const PackedUFloat3_9_9_9_5* source, Vec4f* target, const uint32 numPixels)
+{
+    uint32 i = 0;
+#ifdef NFE_USE_AVX2
+    const __m256i mantissaMask = _mm256_set1_epi32(0x1FF);
+    for (; i + 8 <= numPixels; i += 8)
+    {
+        const __m256i packed = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i));
+
+        // 2^(exponent - 15 - 9)
+        const __m256 scale = _mm256_castsi256_ps(_mm256_add_epi32(_mm256_set1_epi32(0x33800000), _mm256_slli_epi32(_mm256_srli_epi32(packed, 27), 23)));
+
+        const __m256 x = _mm256_mul_ps(scale, _mm256_cvtepi32_ps(_mm256_and_si256(packed, mantissaMask)));
+        const __m256 y = _mm256_mul_ps(scale, _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(packed, 9), mantissaMask)));
+        const __m256 z = _mm256_mul_ps(scale, _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(packed, 18), mantissaMask)));
+        StoreTransposed8(x, y, z, _mm256_setzero_ps(), target + i);
+    }
+#endif // NFE_USE_AVX2
+    for (; i < numPixels; ++i)
+    {
+        target[i] = LoadVec4f(source[i]);
+    }
+}
+
+template<bool SwapRedBlue>
+void EncodePixels_RGBA8_UNorm(const Vec4f* source, uint8* target, const uint32 numPixels)
+{
+    uint32 i = 0;
+#ifdef NFE_USE_AVX2
+    const __m256 scale = _mm256_set1_ps(255.0f);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256i interleave = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    for (; i + 8 <= numPixels; i += 8)
+    {
+        __m256i ints[4];
+        for (uint32 j = 0; j < 4; ++j)
+        {
+            // two pixels per register
+            __m256 v = _mm256_loadu_ps(reinterpret_cast<const float*>(source + i + 2u * j));
+            if (SwapRedBlue)
+            {
+                v = _mm256_permute_ps(v, _MM_SHUFFLE(3, 0, 1, 2));
+            }
+            v = _mm256_min_ps(_mm256_max_ps(v, _mm256_setzero_ps()), one);
+            ints[j] = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(v, scale), half));
+        }
+
+        // lanes hold pixels (0, 2, 4, 6) and (1, 3, 5, 7)
+        const __m256i words01 = _mm256_packus_epi32(ints[0], ints[1]);
+        const __m256i words23 = _mm256_packus_epi32(ints[2], ints[3]);
+        const __m256i bytes = _mm256_packus_epi16(words01, words23);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(target + 4u * i), _mm256_permutevar8x32_epi32(bytes, interleave));
+    }
+#endif // NFE_USE_AVX2
+    for (; i < numPixels; ++i)
+    {
+        const Vec4f& color = source[i];
+        uint8* pixel = target + 4u * i;
+        pixel[0] = FloatToUNorm8(SwapRedBlue ? color.z : color.x);
+        pixel[1] = FloatToUNorm8(color.y);
+        pixel[2] = FloatToUNorm8(SwapRedBlue ? color.x : color.z);
+        pixel[3] = FloatToUNorm8(color.w);
+    }
+}
+
+void EncodePixels_R16_Half(const Vec4f* source, Half* target, const uint32 numPixels)
+{
+    uint32 i = 0;
+#ifdef NFE_USE_AVX2
+    for (; i + 8 <= numPixels; i += 8)
+    {
+        __m256 x, y, z, w;
+        LoadTransposed8(source + i, x, y, z, w);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(target + i), _mm256_cvtps_ph(x, _MM_FROUND_TO_NEAREST_INT));
+    }
+#endif // NFE_USE_AVX2
+    for (; i < numPixels; ++i)
+    {
+        target[i] = Half(source[i].x);
+    }
+}
+
+void EncodePixels_R16G16B16A16_Half(const Vec4f* source, Half4* target, const uint32 numPixels)
+{
+    uint32 i = 0;
+#ifdef NFE_USE_AVX2
+    for (; i + 2 <= numPixels; i += 2)
+    {
+        const __m256 pixels = _mm256_loadu_ps(reinterpret_cast<const float*>(source + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(target + i), _mm256_cvtps_ph(pixels, _MM_FROUND_TO_NEAREST_INT));
+    }
+#endif // NFE_USE_AVX2
+    for (; i < numPixels; ++i)
+    {
+        target[i] = { Half(source[i].x), Half(source[i].y), Half(source[i].z), Half(source[i].w) };
+    }
+}
+
+} // namespace
+
+bool Bitmap::DecodePixels(Format format, const void* source, Vec4f* target, uint32 numPixels, const uint8* palette)
+{
+    const uint8* data = reinterpret_cast<const uint8*>(source);
+
+    switch (format)
+    {
+    case Format::R8_UNorm:
+        DecodePixels_R8_UNorm(data, target, numPixels);
+        return true;
+
+    case Format::R8G8_UNorm:
+        DecodePixels_R8G8_UNorm(data, target, numPixels);
+        return true;
+
+    case Format::B8G8R8_UNorm:
+        DecodePixels_B8G8R8_UNorm(data, target, numPixels);
+        return true;
+
+    case Format::B8G8R8A8_UNorm:
+        DecodePixels_RGBA8_UNorm<true>(data, target, numPixels);
+        return true;
+
+    case Format::R8G8B8A8_UNorm:
+        DecodePixels_RGBA8_UNorm<false>(data, target, numPixels);
+        return true;
+
+    case Format::B8G8R8A8_UNorm_Palette:
+    {
+        if (!palette)
+        {
+            NFE_LOG_ERROR("Bitmap::DecodePixels: Palette is required for %s format", FormatToString(format));
+            return false;
+        }
+
+        for (uint32 i = 0; i < numPixels; ++i)
+        {
+            target[i] = Vec4f_Load_4xUint8(palette + 4u * data[i]).Swizzle<2, 1, 0, 3>() * (1.0f / 255.0f);
+        }
+        return true;
+    }
+
+    case Format::R10G10B10A2_UNorm:
+    {
+        const Packed_10_10_10_2* typedSource = reinterpret_cast<const Packed_10_10_10_2*>(source);
+        for (uint32 i = 0; i < numPixels; ++i)
+        {
+            target[i] = LoadVec4fUNorm(typedSource[i]);
+        }
+        return true;
+    }
+
+    case Format::B5G6R5_UNorm:
+    {
+        const Packed_5_6_5* typedSource = reinterpret_cast<const Packed_5_6_5*>(source);
+        for (uint32 i = 0; i < numPixels; ++i)
+        {
+            target[i] = LoadVec4fUNorm(typedSource[i]);
+        }
+        return true;
+    }
+
+    case Format::B4G4R4A4_UNorm:
+    {
+        const Packed_4_4_4_4* typedSource = reinterpret_cast<const Packed_4_4_4_4*>(source);
+        for (uint32 i = 0; i < numPixels; ++i)
+        {
+            target[i] = LoadVec4fUNorm(typedSource[i]);
+        }
+        return true;
+    }
+
+    case Format::R16_UNorm:
+        DecodePixels_R16_UNorm(reinterpret_cast<const uint16*>(source), target, numPixels);
+        return true;
+
+    case Format::R16G16_UNorm:
+    {
+        const uint16* typedSource = reinterpret_cast<const uint16*>(source);
+        for (uint32 i = 0; i < numPixels; ++i)
+        {
+            target[i] = Vec4f_Load_2xUint16_Norm(typedSource + 2u * i);
+        }
+        return true;
+    }
+
+    case Format::R16G16B16A16_UNorm:
+        DecodePixels_R16G16B16A16_UNorm(reinterpret_cast<const uint16*>(source), target, numPixels);
+        return true;
+
+    case Format::R32_Float:
+        DecodePixels_R32_Float(reinterpret_cast<const float*>(source), target, numPixels);
+        return true;
+
+    case Format::R32G32_Float:
+    {
+        const Vec2f* typedSource = reinterpret_cast<const Vec2f*>(source);
+        for (uint32 i = 0; i < numPixels; ++i)
+        {
+            target[i] = Vec4f(typedSource[i].x, typedSource[i].y, 0.0f, 0.0f);
+        }
+        return true;
+    }
+
+    case Format::R32G32B32_Float:
+    {
+        const Vec3f* typedSource = reinterpret_cast<const Vec3f*>(source);
+        for (uint32 i = 0; i < numPixels; ++i)
+        {
+            target[i] = Vec4f(typedSource[i]);
+        }
+        return true;
+    }
+
+    case Format::R32G32B32A32_Float:
+        memcpy(target, source, sizeof(Vec4f) * numPixels);
+        return true;
+
+    case Format::R11G11B10_Float:
+        DecodePixels_R11G11B10_Float(reinterpret_cast<const PackedUFloat3_11_11_10*>(source), target, numPixels);
+        return true;
+
+    case Format::R16_Half:
+        DecodePixels_R16_Half(reinterpret_cast<const Half*>(source), target, numPixels);
+        return true;
+
+    case Format::R16G16_Half:
+    {
+        const Half2* typedSource = reinterpret_cast<const Half2*>(source);
+        for (uint32 i = 0; i < numPixels; ++i)
+        {
+            target[i] = Vec4f_Load_Half2(typedSource[i]);
+        }
+        return true;
+    }
+
+    case Format::R16G16B16_Half:
+        DecodePixels_R16G16B16_Half(reinterpret_cast<const Half3*>(source), target, numPixels);
+        return true;
+
+    case Format::R16G16B16A16_Half:
+        DecodePixels_R16G16B16A16_Half(reinterpret_cast<const Half4*>(source), target, numPixels);
+        return true;
+
+    case Format::R9G9B9E5_SharedExp:
+        DecodePixels_R9G9B9E5_SharedExp(reinterpret_cast<const PackedUFloat3_9_9_9_5*>(source), target, numPixels);
+        return true;
+    }
+
+    NFE_LOG_ERROR("Bitmap::DecodePixels: Unsupported format: %s", FormatToString(format));
+    return false;
+}
+
+bool Bitmap::EncodePixels(Format format, const Vec4f* source, void* target, uint32 numPixels)
+{
+    uint8* data = reinterpret_cast<uint8*>(target);
+
+    switch (format)
+    {
+    case Format::R8_UNorm:
+    {
+        for (uint32 i = 0; i < numPixels; ++i)
+        {
+            data[i] = FloatToUNorm8(source[i].x);
+        }
+        return true;
+    }
+
+    case Format::R8G8_UNorm:
+    {
+        for (uint32 i = 0; i < numPixels; ++i)
+        {
+            data[2u * i] = FloatToUNorm8(source[i].x);
+            data[2u * i + 1] = FloatToUNorm8(source[i].y);
+        }
+        return true;
+    }
+
+    case Format::B8G8R8_UNorm:
+    {
+        for (uint32 i = 0; i < numPixels; ++i)
+        {
+            data[3u * i] = FloatToUNorm8(source[i].z);
+            data[3u * i + 1] = FloatToUNorm8(source[i].y);
+            data[3u * i + 2] = FloatToUNorm8(source[i].x);
+        }
+        return true;
+    }
+
+    case Format::B8G8R8A8_UNorm:
+        EncodePixels_RGBA8_UNorm<true>(source, data, numPixels);
+        return true;
+
+    case Format::R8G8B8A8_UNorm:
+        EncodePixels_RGBA8_UNorm<false>(source, data, numPixels);
+        return true;
+
+    case Format::R10G10B10A2_UNorm:
+    {
+        Packed_10_10_10_2* typedTarget = reinterpret_cast<Packed_10_10_10_2*>(target);
+        for (uint32 i = 0; i < numPixels; ++i)
+        {
+            const Vec4f& color = source[i];
+            typedTarget[i].v = FloatToUNorm(color.x, 1023.0f) | (FloatToUNorm(color.y, 1023.0f) << 10) | (FloatToUNorm(color.z, 1023.0f) << 20) | (FloatToUNorm(color.w, 3.0f) << 30);
+        }
+        return true;
+    }
+
+    case Format::B5G6R5_UNorm:
+    {
+        Packed_5_6_5* typedTarget = reinterpret_cast<Packed_5_6_5*>(target);
+        for (uint32 i = 0; i < numPixels; ++i)
+        {
+            const Vec4f& color = source[i];
+            typedTarget[i].v = static_cast<uint16>((FloatToUNorm(color.x, 31.0f) << 11) | (FloatToUNorm(color.y, 63.0f) << 5) | FloatToUNorm(color.z, 31.0f));
+        }
+        return true;
+    }
+
+    case Format::B4G4R4A4_UNorm:
+    {
+        Packed_4_4_4_4* typedTarget = reinterpret_cast<Packed_4_4_4_4*>(target);
+        for (uint32 i = 0; i < numPixels; ++i)
+        {
+            const Vec4f& color = source[i];
+            typedTarget[i].v = static_cast<uint16>((FloatToUNorm(color.x, 15.0f) << 8) | (FloatToUNorm(color.y, 15.0f) << 4) | FloatToUNorm(color.z, 15.0f) | (FloatToUNorm(color.w, 15.0f) << 12));
+        }
+        return true;
+    }
+
+    case Format::R16_UNorm:
+    {
+        uint16* typedTarget = reinterpret_cast<uint16*>(target);
+        for (uint32 i = 0; i < numPixels; ++i)
+        {
+            typedTarget[i] = FloatToUNorm16(source[i].x);
+        }
+        return true;
+    }
+
+    case Format::R16G16_UNorm:
+    {
+        uint16* typedTarget = reinterpret_cast<uint16*>(target);
+        for (uint32 i = 0; i < numPixels; ++i)
+        {
+            typedTarget[2u * i] = FloatToUNorm16(source[i].x);
+            typedTarget[2u * i + 1] = FloatToUNorm16(source[i].y);
+        }
+        return true;
+    }
+
+    case Format::R16G16B16A16_UNorm:
+    {
+        uint16* typedTarget = reinterpret_cast<uint16*>(target);
+        for (uint32 i = 0; i < numPixels; ++i)
+        {
+            typedTarget[4u * i] = FloatToUNorm16(source[i].x);
+            typedTarget[4u * i + 1] = FloatToUNorm16(source[i].y);
+            typedTarget[4u * i + 2] = FloatToUNorm16(source[i].z);
+            typedTarget[4u * i + 3] = FloatToUNorm16(source[i].w);
+        }
+        return true;
+    }
+
+    case Format::R32_Float:
+    {
+        float* typedTarget = reinterpret_cast<float*>(target);
+        for (uint32 i = 0; i < numPixels; ++i)
+        {
+            typedTarget[i] = source[i].x;
+        }
+        return true;
+    }
+
+    case Format::R32G32_Float:
+    {
+        Vec2f* typedTarget = reinterpret_cast<Vec2f*>(target);
+        for (uint32 i = 0; i < numPixels; ++i)
+        {
+            typedTarget[i] = Vec2f(source[i].x, source[i].y);
+        }
+        return true;
+    }
+
+    case Format::R32G32B32_Float:
+    {
+        Vec3f* typedTarget = reinterpret_cast<Vec3f*>(target);
+        for (uint32 i = 0; i < numPixels; ++i)
+        {
+            typedTarget[i] = source[i].ToVec3f();
+        }
+        return true;
+    }
+
+    case Format::R32G32B32A32_Float:
+        memcpy(target, source, sizeof(Vec4f) * numPixels);
+        return true;
+
+    case Format::R11G11B10_Float:
+    {
+        PackedUFloat3_11_11_10* typedTarget = reinterpret_cast<PackedUFloat3_11_11_10*>(target);
+        for (uint32 i = 0; i < numPixels; ++i)
+        {
+            const Vec4f& color = source[i];
+            typedTarget[i].v = EncodeUFloat(color.x, 6) | (EncodeUFloat(color.y, 6) << 11) | (EncodeUFloat(color.z, 5) << 22);
+        }
+        return true;
+    }
+
+    case Format::R16_Half:
+        EncodePixels_R16_Half(source, reinterpret_cast<Half*>(target), numPixels);
+        return true;
+
+    case Format::R16G16_Half:
+    {
+        Half2* typedTarget = reinterpret_cast<Half2*>(target);
+        for (uint32 i = 0; i < numPixels; ++i)
+        {
+            typedTarget[i] = { Half(source[i].x), Half(source[i].y) };
+        }
+        return true;
+    }
+
+    case Format::R16G16B16_Half:
+    {
+        Half3* typedTarget = reinterpret_cast<Half3*>(target);
+        for (uint32 i = 0; i < numPixels; ++i)
+        {
+            typedTarget[i] = { Half(source[i].x), Half(source[i].y), Half(source[i].z) };
+        }
+        return true;
+    }
+
+    case Format::R16G16B16A16_Half:
+        EncodePixels_R16G16B16A16_Half(source, reinterpret_cast<Half4*>(target), numPixels);
+        return true;
+
+    case Format::R9G9B9E5_SharedExp:
+    {
+        PackedUFloat3_9_9_9_5* typedTarget = reinterpret_cast<PackedUFloat3_9_9_9_5*>(target);
+        for (uint32 i = 0; i < numPixels; ++i)
+        {
+            typedTarget[i] = PackedUFloat3_9_9_9_5::FromVector(source[i]);
+        }
+        return true;
+    }
+    }
+
+    NFE_LOG_ERROR("Bitmap::EncodePixels: Unsupported format: %s", FormatToString(format));
+    return false;
+}
+
+bool Bitmap::ReadRow(uint32 y, Vec4f* outPixels, uint32 z) const
+{
+    NFE_ASSERT(y < GetHeight() && z < GetDepth(), "");
+
+    if (IsBlockCompressed(mFormat))
+    {
+        for (uint32 x = 0; x < GetWidth(); ++x)
+        {
+            outPixels[x] = DecodeBC(mFormat, mData + GetStride() * ComputeNumDataRows(GetHeight(), mFormat) * static_cast<size_t>(z), x, y, GetWidth());
+        }
+        return true;
+    }
+
+    const uint8* rowData = mData + GetStride() * (static_cast<size_t>(y) + GetHeight() * static_cast<size_t>(z));
+    return DecodePixels(mFormat, rowData, outPixels, GetWidth(), mPalette);
+}
+
+bool Bitmap::WriteRow(uint32 y, const Vec4f* pixels, uint32 z)
+{
+    NFE_ASSERT(y < GetHeight() && z < GetDepth(), "");
+
+    uint8* rowData = mData + GetStride() * (static_cast<size_t>(y) + GetHeight() * static_cast<size_t>(z));
+    return EncodePixels(mFormat, pixels, rowData, GetWidth());
+}
+
+} // namespace RT
+} // namespace NFE
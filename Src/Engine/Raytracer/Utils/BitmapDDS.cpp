@@ -545,7 +545,7 @@ bool Bitmap::LoadDDS(FILE* file, const char* path)
         return false;
     }
 
-    // TODO support for DXT textures that has dimension non-4-multiply
+    // NOTE: block-compressed data size is rounded up to whole 4x4 blocks
     const size_t dataSize = ComputeDataSize(initData);
     if (fread(mData, dataSize, 1, file) != 1)
     {
@@ -1,6 +1,8 @@
 #include "PCH.h"
 #include "Bitmap.h"
 #include "../Common/Containers/DynArray.hpp"
+#include "../Common/Containers/SharedPtr.hpp"
+#include "../Common/Utils/TaskBuilder.hpp"
 #include "tinyexr/tinyexr.h"
 
 namespace NFE {
@@ -9,7 +11,78 @@ namespace RT {
 using namespace Common;
 using namespace Math;
 
-bool Bitmap::LoadEXR(FILE* file, const char* path)
+namespace {
+
+// number of scanlines converted by a single task
+constexpr uint32 EXRRowsPerTask = 64;
+
+// decoded EXR image (shared between conversion tasks)
+struct EXRImageData
+{
+    EXRHeader header;
+    EXRImage image;
+    bool headerLoaded = false;
+    bool imageLoaded = false;
+
+    EXRImageData()
+    {
+        InitEXRHeader(&header);
+        InitEXRImage(&image);
+    }
+
+    ~EXRImageData()
+    {
+        Free();
+    }
+
+    void Free()
+    {
+        if (imageLoaded)
+        {
+            FreeEXRImage(&image);
+            imageLoaded = false;
+        }
+
+        if (headerLoaded)
+        {
+            FreeEXRHeader(&header);
+            headerLoaded = false;
+        }
+    }
+};
+
+using EXRImageDataPtr = SharedPtr<EXRImageData>;
+using EXRConvertFunction = void(*)(const EXRImage& image, uint8* data, size_t stride, uint32 firstRow, uint32 lastRow);
+
+// convert range of scanlines from planar (A)BGR layout to interleaved RGB(A)
+template<typename T, uint32 NumChannels>
+void ConvertEXRRows(const EXRImage& image, uint8* data, size_t stride, uint32 firstRow, uint32 lastRow)
+{
+    const size_t width = (size_t)image.width;
+
+    const T* channels[NumChannels];
+    for (uint32 c = 0; c < NumChannels; ++c)
+    {
+        channels[c] = reinterpret_cast<const T*>(image.images[NumChannels - 1 - c]);
+    }
+
+    for (size_t y = firstRow; y < lastRow; ++y)
+    {
+        T* typedData = reinterpret_cast<T*>(data + stride * y);
+        const size_t rowOffset = y * width;
+        for (size_t x = 0; x < width; ++x)
+        {
+            for (uint32 c = 0; c < NumChannels; ++c)
+            {
+                typedData[NumChannels * x + c] = channels[c][rowOffset + x];
+            }
+        }
+    }
+}
+
+} // namespace
+
+bool Bitmap::LoadEXR(FILE* file, const char* path, TaskBuilder* taskBuilder)
 {
     NFE_UNUSED(file);
 
@@ -30,168 +103,124 @@ bool Bitmap::LoadEXR(FILE* file, const char* path)
     }
 
     // 2. Read EXR header
-    EXRHeader exrHeader;
-    InitEXRHeader(&exrHeader);
+    const EXRImageDataPtr exrData = MakeSharedPtr<EXRImageData>();
 
     const char* err = NULL;
-    ret = ParseEXRHeaderFromFile(&exrHeader, &exrVersion, path, &err);
+    ret = ParseEXRHeaderFromFile(&exrData->header, &exrVersion, path, &err);
     if (ret != 0)
     {
         NFE_LOG_ERROR("Parse EXR error: %s", err);
         FreeEXRErrorMessage(err);
-        return ret;
+        return false;
     }
+    exrData->headerLoaded = true;
 
-    EXRImage exrImage;
-    InitEXRImage(&exrImage);
-
-    ret = LoadEXRImageFromFile(&exrImage, &exrHeader, path, &err);
+    // 3. Read EXR image
+    ret = LoadEXRImageFromFile(&exrData->image, &exrData->header, path, &err);
     if (ret != 0)
     {
         NFE_LOG_ERROR("Load EXR error: %s", err);
         FreeEXRErrorMessage(err);
-        return ret;
+        return false;
     }
+    exrData->imageLoaded = true;
+
+    const EXRHeader& exrHeader = exrData->header;
+    const EXRImage& exrImage = exrData->image;
 
     if (!exrImage.images)
     {
         NFE_LOG_ERROR("Tiled EXR are not supported: %s", path);
-        FreeEXRImage(&exrImage);
         return false;
     }
 
+    if (exrHeader.num_channels != 3 && exrHeader.num_channels != 4)
+    {
+        NFE_LOG_ERROR("Unsupported EXR format: %s", path);
+        return false;
+    }
+
+    for (int i = 1; i < exrHeader.num_channels; ++i)
+    {
+        if (exrHeader.pixel_types[i] != exrHeader.pixel_types[0])
+        {
+            NFE_LOG_ERROR("Unsupported EXR format. All channels must be of the same type");
+            return false;
+        }
+    }
+
     InitData initData;
     initData.linearSpace = true;
     initData.width = exrImage.width;
     initData.height = exrImage.height;
 
-    if (exrHeader.num_channels == 3)
+    EXRConvertFunction convertFunction = nullptr;
+
+    if (exrHeader.pixel_types[0] == TINYEXR_PIXELTYPE_FLOAT)
     {
-        const bool sameFormat = exrHeader.pixel_types[0] == exrHeader.pixel_types[1] && exrHeader.pixel_types[0] == exrHeader.pixel_types[2];
-        if (!sameFormat)
+        if (exrHeader.num_channels == 3)
         {
-            NFE_LOG_ERROR("Unsupported EXR format. All channels must be of the same type");
-            goto exrImageError;
+            initData.format = Format::R32G32B32_Float;
+            convertFunction = ConvertEXRRows<float, 3>;
         }
-
-        if (exrHeader.pixel_types[0] == TINYEXR_PIXELTYPE_FLOAT)
+        else
         {
-            initData.format = Format::R32G32B32_Float;
-            if (!Init(initData))
-            {
-                goto exrImageError;
-            }
-
-            for (size_t y = 0; y < (size_t)exrImage.height; ++y)
-            {
-                float* typedData = reinterpret_cast<float*>(mData + (size_t)GetStride() * y);
-                for (size_t x = 0; x < (size_t)exrImage.width; ++x)
-                {
-                    const size_t index = y * exrImage.width + x;
-                    typedData[3 * x    ] = reinterpret_cast<const float*>(exrImage.images[2])[index];
-                    typedData[3 * x + 1] = reinterpret_cast<const float*>(exrImage.images[1])[index];
-                    typedData[3 * x + 2] = reinterpret_cast<const float*>(exrImage.images[0])[index];
-                }
-            }
+            initData.format = Format::R32G32B32A32_Float;
+            convertFunction = ConvertEXRRows<float, 4>;
         }
-        else if (exrHeader.pixel_types[0] == TINYEXR_PIXELTYPE_HALF)
+    }
+    else if (exrHeader.pixel_types[0] == TINYEXR_PIXELTYPE_HALF)
+    {
+        if (exrHeader.num_channels == 3)
         {
             initData.format = Format::R16G16B16_Half;
-            if (!Init(initData))
-            {
-                goto exrImageError;
-            }
-
-            for (size_t y = 0; y < (size_t)exrImage.height; ++y)
-            {
-                uint16* typedData = reinterpret_cast<uint16*>(mData + GetStride() * y);
-                for (size_t x = 0; x < (size_t)exrImage.width; ++x)
-                {
-                    const size_t index = y * exrImage.width + x;
-                    typedData[3 * x    ] = reinterpret_cast<const uint16*>(exrImage.images[2])[index];
-                    typedData[3 * x + 1] = reinterpret_cast<const uint16*>(exrImage.images[1])[index];
-                    typedData[3 * x + 2] = reinterpret_cast<const uint16*>(exrImage.images[0])[index];
-                }
-            }
+            convertFunction = ConvertEXRRows<uint16, 3>;
         }
         else
         {
-            NFE_LOG_ERROR("Unsupported EXR format: %i", exrHeader.pixel_types[0]);
-            goto exrImageError;
+            initData.format = Format::R16G16B16A16_Half;
+            convertFunction = ConvertEXRRows<uint16, 4>;
         }
     }
-    else if (exrHeader.num_channels == 4)
+    else
     {
-        const bool sameFormat = exrHeader.pixel_types[0] == exrHeader.pixel_types[1]
-            && exrHeader.pixel_types[0] == exrHeader.pixel_types[2]
-            && exrHeader.pixel_types[0] == exrHeader.pixel_types[3];
-        if (!sameFormat)
-        {
-            NFE_LOG_ERROR("Unsupported EXR format. All channels must be of the same type");
-            goto exrImageError;
-        }
+        NFE_LOG_ERROR("Unsupported EXR format: %i", exrHeader.pixel_types[0]);
+        return false;
+    }
 
-        if (exrHeader.pixel_types[0] == TINYEXR_PIXELTYPE_FLOAT)
-        {
-            initData.format = Format::R32G32B32A32_Float;
-            if (!Init(initData))
-            {
-                goto exrImageError;
-            }
+    if (!Init(initData))
+    {
+        return false;
+    }
 
-            for (size_t y = 0; y < (size_t)exrImage.height; ++y)
-            {
-                float* typedData = reinterpret_cast<float*>(mData + GetStride() * y);
-                for (size_t x = 0; x < (size_t)exrImage.width; ++x)
-                {
-                    const size_t index = y * exrImage.width + x;
-                    typedData[4 * x    ] = reinterpret_cast<const float*>(exrImage.images[3])[index];
-                    typedData[4 * x + 1] = reinterpret_cast<const float*>(exrImage.images[2])[index];
-                    typedData[4 * x + 2] = reinterpret_cast<const float*>(exrImage.images[1])[index];
-                    typedData[4 * x + 3] = reinterpret_cast<const float*>(exrImage.images[0])[index];
-                }
-            }
-        }
-        else if (exrHeader.pixel_types[0] == TINYEXR_PIXELTYPE_HALF)
-        {
-            initData.format = Format::R16G16B16A16_Half;
-            if (!Init(initData))
-            {
-                goto exrImageError;
-            }
+    // 4. Convert to interleaved layout
+    const uint32 height = initData.height;
+    uint8* data = mData;
+    const size_t stride = GetStride();
 
-            for (size_t y = 0; y < (size_t)exrImage.height; ++y)
-            {
-                uint16* typedData = reinterpret_cast<uint16*>(mData + GetStride() * y);
-                for (size_t x = 0; x < (size_t)exrImage.width; ++x)
-                {
-                    const size_t index = y * exrImage.width + x;
-                    typedData[4 * x    ] = reinterpret_cast<const uint16*>(exrImage.images[3])[index];
-                    typedData[4 * x + 1] = reinterpret_cast<const uint16*>(exrImage.images[2])[index];
-                    typedData[4 * x + 2] = reinterpret_cast<const uint16*>(exrImage.images[1])[index];
-                    typedData[4 * x + 3] = reinterpret_cast<const uint16*>(exrImage.images[0])[index];
-                }
-            }
-        }
-        else
+    if (taskBuilder && height > EXRRowsPerTask)
+    {
+        const uint32 numTasks = (height + EXRRowsPerTask - 1) / EXRRowsPerTask;
+        taskBuilder->ParallelFor("Bitmap::LoadEXR/Convert", numTasks, [=] (const TaskContext&, uint32 taskIndex)
         {
-            NFE_LOG_ERROR("Unsupported EXR format: %i", exrHeader.pixel_types[0]);
-            goto exrImageError;
-        }
+            const uint32 firstRow = taskIndex * EXRRowsPerTask;
+            const uint32 lastRow = Min(height, firstRow + EXRRowsPerTask);
+            convertFunction(exrData->image, data, stride, firstRow, lastRow);
+        });
+
+        // release decoded image as soon as the conversion is done
+        taskBuilder->Fence();
+        taskBuilder->Task("Bitmap::LoadEXR/Free", [exrData] (const TaskContext&)
+        {
+            exrData->Free();
+        });
     }
     else
     {
-        NFE_LOG_ERROR("Unsupported EXR format.", path);
-        goto exrImageError;
+        convertFunction(exrImage, data, stride, 0, height);
     }
 
-    // 4. Free image data
-    FreeEXRImage(&exrImage);
     return true;
-
-exrImageError:
-    FreeEXRImage(&exrImage);
-    return false;
 }
 
 bool Bitmap::SaveEXR(const char* path, const float exposure) const
@@ -208,16 +237,6 @@ bool Bitmap::SaveEXR(const char* path, const float exposure) const
         return false;
     }
 
-    if (mFormat != Format::R32G32B32_Float)
-    {
-        NFE_LOG_ERROR("Bitmap::SaveEXR: Unsupported format: %s", FormatToString(mFormat));
-        return false;
-    }
-
-    // TODO support more types
-
-    const Vec3f* data = reinterpret_cast<const Vec3f*>(mData);
-
     EXRHeader header;
     InitEXRHeader(&header);
 
@@ -226,18 +245,33 @@ bool Bitmap::SaveEXR(const char* path, const float exposure) const
 
     image.num_channels = 3;
 
+    const uint32 width = GetWidth();
+    const uint32 height = GetHeight();
+
     DynArray<float> images[3];
-    images[0].Resize(GetWidth() * GetHeight());
-    images[1].Resize(GetWidth() * GetHeight());
-    images[2].Resize(GetWidth() * GetHeight());
+    images[0].Resize(width * height);
+    images[1].Resize(width * height);
+    images[2].Resize(width * height);
+
+    DynArray<Vec4f> row;
+    row.Resize(width);
 
     // Split RGBRGBRGB... into R, G and B layer
-    const uint32 numPixels = GetWidth() * GetHeight();
-    for (uint32 i = 0; i < numPixels; i++)
+    for (uint32 y = 0; y < height; ++y)
     {
-        images[0][i] = exposure * data[i].x;
-        images[1][i] = exposure * data[i].y;
-        images[2][i] = exposure * data[i].z;
+        if (!ReadRow(y, row.Data()))
+        {
+            NFE_LOG_ERROR("Bitmap::SaveEXR: Unsupported format: %s", FormatToString(mFormat));
+            return false;
+        }
+
+        const uint32 rowOffset = width * y;
+        for (uint32 x = 0; x < width; ++x)
+        {
+            images[0][rowOffset + x] = exposure * row[x].x;
+            images[1][rowOffset + x] = exposure * row[x].y;
+            images[2][rowOffset + x] = exposure * row[x].z;
+        }
     }
 
     float* image_ptr[3];
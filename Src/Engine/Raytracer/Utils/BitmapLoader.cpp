@@ -0,0 +1,119 @@
+#include "PCH.h"
+#include "BitmapLoader.h"
+#include "../Common/Containers/DynArray.hpp"
+#include "../Common/Logger/Logger.hpp"
+#include "../Common/Math/Math.hpp"
+#include "../Common/Utils/ScopedLock.hpp"
+#include "../Common/Utils/TaskBuilder.hpp"
+#include "../Common/Utils/ThreadPool.hpp"
+
+namespace NFE {
+namespace RT {
+
+using namespace Common;
+
+namespace {
+
+// Limit number of concurrent bitmap loads (shared by all the loaders), so that loading doesn't occupy
+// all the worker threads and stall rendering tasks.
+// Note: format conversion sub-tasks are not part of the group.
+TaskGroupID GetLoadingTaskGroup()
+{
+    static const TaskGroupID group = []()
+    {
+        ThreadPool& threadPool = ThreadPool::GetInstance();
+        const uint32 maxConcurrentLoads = Math::Max(1u, threadPool.GetNumWorkerThreads() / 2u);
+        return threadPool.CreateTaskGroup("BitmapLoader", maxConcurrentLoads);
+    }();
+
+    return group;
+}
+
+} // namespace
+
+BitmapLoader::BitmapLoader() = default;
+
+BitmapLoader::~BitmapLoader()
+{
+    WaitForAll();
+}
+
+BitmapLoader::EntryPtr BitmapLoader::RequestInternal(const StringView path)
+{
+    const String key(path);
+
+    NFE_SCOPED_LOCK(mMutex);
+
+    const auto iter = mEntries.Find(key);
+    if (iter != mEntries.End())
+    {
+        return iter->second;
+    }
+
+    EntryPtr entry = MakeSharedPtr<Entry>();
+    entry->bitmap = MakeSharedPtr<Bitmap>(key.Str());
+    entry->success = false;
+    mEntries.Insert(key, entry);
+
+    TaskDesc desc;
+    desc.debugName = "BitmapLoader::Load";
+    desc.waitable = &entry->waitable;
+    desc.group = GetLoadingTaskGroup();
+    desc.function = [entry] (const TaskContext& context)
+    {
+        // format conversion tasks are attached to this task, so the waitable is notified after they finish
+        TaskBuilder taskBuilder(context);
+        entry->success = entry->bitmap->Load(entry->bitmap->GetDebugName(), &taskBuilder);
+    };
+
+    ThreadPool::GetInstance().CreateAndDispatchTask(desc);
+
+    return entry;
+}
+
+void BitmapLoader::Request(const StringView path)
+{
+    RequestInternal(path);
+}
+
+BitmapPtr BitmapLoader::Get(const StringView path)
+{
+    const EntryPtr entry = RequestInternal(path);
+    entry->waitable.Wait();
+
+    if (!entry->success)
+    {
+        return nullptr;
+    }
+
+    return entry->bitmap;
+}
+
+void BitmapLoader::WaitForAll()
+{
+    DynArray<EntryPtr> entries;
+    {
+        NFE_SCOPED_LOCK(mMutex);
+        entries.Reserve(mEntries.Size());
+        for (const auto& iter : mEntries)
+        {
+            entries.PushBack(iter.second);
+        }
+    }
+
+    for (const EntryPtr& entry : entries)
+    {
+        entry->waitable.Wait();
+    }
+}
+
+void BitmapLoader::Clear()
+{
+    WaitForAll();
+
+    NFE_SCOPED_LOCK(mMutex);
+    mEntries.Clear();
+}
+
+} // namespace RT
+} // namespace NFE
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Bitmap.h"
+#include "../../Common/Containers/HashMap.hpp"
+#include "../../Common/Containers/String.hpp"
+#include "../../Common/System/Mutex.hpp"
+#include "../../Common/Utils/Waitable.hpp"
+
+#include <atomic>
+
+namespace NFE {
+namespace RT {
+
+/**
+ * Helper class for loading multiple bitmaps in parallel.
+ *
+ * Each requested bitmap is loaded by a separate thread pool task (large images are additionally
+ * converted in parallel). Bitmaps are cached by path, so each file is loaded only once.
+ */
+class BitmapLoader
+{
+    NFE_MAKE_NONCOPYABLE(BitmapLoader)
+    NFE_MAKE_NONMOVEABLE(BitmapLoader)
+
+public:
+    NFE_RAYTRACER_API BitmapLoader();
+    NFE_RAYTRACER_API ~BitmapLoader();
+
+    // start loading a bitmap in the background (does nothing if the path was already requested)
+    NFE_RAYTRACER_API void Request(const Common::StringView path);
+
+    // get loaded bitmap (requests it if needed and waits for loading to finish)
+    // returns nullptr if the bitmap failed to load
+    NFE_RAYTRACER_API BitmapPtr Get(const Common::StringView path);
+
+    // wait for all requested bitmaps to be loaded
+    // NOTE: this can be called only on the main thread
+    NFE_RAYTRACER_API void WaitForAll();
+
+    // wait for pending loads and release cached bitmaps
+    NFE_RAYTRACER_API void Clear();
+
+private:
+    struct Entry
+    {
+        BitmapPtr bitmap;
+        Common::Waitable waitable;
+        std::atomic<bool> success;
+    };
+
+    using EntryPtr = Common::SharedPtr<Entry>;
+
+    EntryPtr RequestInternal(const Common::StringView path);
+
+    Common::Mutex mMutex;
+    Common::HashMap<Common::String, EntryPtr> mEntries;
+};
+
+} // namespace RT
+} // namespace NFE
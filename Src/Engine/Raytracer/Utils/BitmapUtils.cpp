@@ -58,7 +58,8 @@ using TempLineType = Vec4f[NumColumnsPerTask][MaxLineSize];
 static thread_local TempLineType gTempLineA;
 static thread_local TempLineType gTempLineB;
 
-bool BitmapUtils::GaussianBlur(Bitmap& targetBitmap, const Bitmap& sourceBitmap, const GaussianBlurParams params, Common::TaskBuilder& taskBuilder)
+bool BitmapUtils::GaussianBlur(Bitmap& targetBitmap, const Bitmap& sourceBitmap, const GaussianBlurParams params, Common::TaskBuilder& taskBuilder,
+                               const ArrayView<const TaskID> dependencies, TaskID* outTask)
 {
     NFE_ASSERT(params.numPasses > 0, "");
 
@@ -104,7 +105,10 @@ bool BitmapUtils::GaussianBlur(Bitmap& targetBitmap, const Bitmap& sourceBitmap,
     const uint32 height = targetBitmap.GetHeight();
 
     // horizontal blur
-    taskBuilder.ParallelFor("BitmapUtils::GaussianBlur/Horizontal", height, [=, &sourceBitmap, &targetBitmap] (const TaskContext&, const uint32 y)
+    ParallelForParams horizontalParams;
+    horizontalParams.dependencies = dependencies;
+
+    const TaskID horizontalTask = taskBuilder.ParallelFor("BitmapUtils::GaussianBlur/Horizontal", height, [=, &sourceBitmap, &targetBitmap] (const TaskContext&, const uint32 y)
     {
         Vec4f* sourceLinePtr = gTempLineB[0];
         Vec4f* targetLinePtr = gTempLineA[0];
@@ -127,13 +131,14 @@ bool BitmapUtils::GaussianBlur(Bitmap& targetBitmap, const Bitmap& sourceBitmap,
         {
             *(targetRowPtr + x) = sourceLinePtr[x].ToVec3f();
         }
-    });
+    }, horizontalParams);
 
-    taskBuilder.Fence();
+    // vertical blur (waits only for the horizontal pass, not for all the tasks pushed to the builder)
+    ParallelForParams verticalParams;
+    verticalParams.dependencies = ArrayView<const TaskID>(&horizontalTask, 1);
 
-    // vertical blur
     const uint32 numTasksForVerticalBlur = (width + NumColumnsPerTask - 1) / NumColumnsPerTask;
-    taskBuilder.ParallelFor("BitmapUtils::GaussianBlur/Vertical", numTasksForVerticalBlur, [=, &targetBitmap] (const TaskContext&, const uint32 columnGroupIndex)
+    const TaskID verticalTask = taskBuilder.ParallelFor("BitmapUtils::GaussianBlur/Vertical", numTasksForVerticalBlur, [=, &targetBitmap] (const TaskContext&, const uint32 columnGroupIndex)
     {
         // Note: in opossite to horizontal blur, vertical blur is done in batches of few columns to improve cache performance
 
@@ -174,7 +179,12 @@ bool BitmapUtils::GaussianBlur(Bitmap& targetBitmap, const Bitmap& sourceBitmap,
                 pixels[i] = srcLine[i][y].ToVec3f();
             }
         }
-    });
+    }, verticalParams);
+
+    if (outTask)
+    {
+        *outTask = verticalTask;
+    }
 
     return true;
 }
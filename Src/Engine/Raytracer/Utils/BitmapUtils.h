@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Bitmap.h"
+#include "../../Common/Containers/ArrayView.hpp"
 
 namespace NFE {
 namespace RT {
@@ -17,7 +18,11 @@ public:
         uint32 numPasses;
     };
 
-    static bool GaussianBlur(Bitmap& targetBitmap, const Bitmap& sourceBitmap, const GaussianBlurParams params, Common::TaskBuilder& taskBuilder);
+    // Push blur tasks to the task builder. The blur starts when "dependencies" (tasks pushed to the same builder) finish.
+    // Optionally returns the task that finishes the blur, so it can be used as a dependency too.
+    static bool GaussianBlur(Bitmap& targetBitmap, const Bitmap& sourceBitmap, const GaussianBlurParams params, Common::TaskBuilder& taskBuilder,
+                             const Common::ArrayView<const Common::TaskID> dependencies = Common::ArrayView<const Common::TaskID>(),
+                             Common::TaskID* outTask = nullptr);
 };
 
 
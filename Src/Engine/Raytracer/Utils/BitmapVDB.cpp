@@ -1,5 +1,6 @@
 #include "PCH.h"
 #include "Bitmap.h"
+#include "SparseVolume.h"
 
 #ifdef USE_OPENVDB
 #include <openvdb/openvdb.h>
@@ -96,5 +97,71 @@ bool Bitmap::LoadVDB(FILE*, const char* path)
 #endif // USE_OPENVDB
 }
 
+bool SparseVolume::LoadVDB(const char* path)
+{
+#ifdef USE_OPENVDB
+    openvdb::io::File file(path);
+    if (!file.open())
+    {
+        return false;
+    }
+
+    openvdb::GridBase::Ptr baseGrid;
+    for (openvdb::io::File::NameIterator nameIter = file.beginName(); nameIter != file.endName(); ++nameIter)
+    {
+        baseGrid = file.readGrid(nameIter.gridName());
+        NFE_LOG_INFO("SparseVolume: Found grid: %s", nameIter.gridName().c_str());
+    }
+
+    file.close();
+
+    if (!baseGrid)
+    {
+        NFE_LOG_ERROR("Unsupported VDB file '%hs': no grids found", path);
+        return false;
+    }
+
+    if (baseGrid->valueType() != "float")
+    {
+        NFE_LOG_ERROR("Unsupported VDB format in file '%hs': %s", path, baseGrid->valueType().c_str());
+        return false;
+    }
+
+    const openvdb::CoordBBox box = baseGrid->evalActiveVoxelBoundingBox();
+    NFE_LOG_INFO("SparseVolume: min=[%i,%i,%i], max=[%i,%i,%i]",
+        box.min().x(), box.min().y(), box.min().z(),
+        box.max().x(), box.max().y(), box.max().z());
+
+    // no dense allocation here, so dimensions are not limited to 16 bits
+    InitData initData;
+    initData.width = box.max().x() - box.min().x() + 1;
+    initData.height = box.max().y() - box.min().y() + 1;
+    initData.depth = box.max().z() - box.min().z() + 1;
+    initData.format = Bitmap::Format::R16_Half;
+
+    if (!Init(initData))
+    {
+        return false;
+    }
+
+    openvdb::FloatGrid::Ptr grid = openvdb::gridPtrCast<openvdb::FloatGrid>(baseGrid);
+
+    for (openvdb::FloatGrid::ValueOnCIter iter = grid->cbeginValueOn(); iter; ++iter)
+    {
+        const openvdb::Coord coord = iter.getCoord() - box.min();
+        SetVoxel(coord.x(), coord.y(), coord.z(), iter.getValue());
+    }
+
+    return true;
+
+#else
+
+    NFE_UNUSED(path);
+
+    return false;
+
+#endif // USE_OPENVDB
+}
+
 } // namespace RT
 } // namespace NFE
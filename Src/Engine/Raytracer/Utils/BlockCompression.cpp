@@ -1,148 +1,250 @@
 #include "PCH.h"
+#include "BlockCompression.h"
 #include "../Common/Math/Vec4i.hpp"
+#include "../Common/Math/Vec8f.hpp"
+#include "../Common/Math/Vec8i.hpp"
 
 namespace NFE {
 namespace RT {
 
 using namespace Math;
 
-NFE_FORCE_NOINLINE
-const Vec4f DecodeBC1(const uint8* data, uint32 x, uint32 y, const uint32 width)
+namespace helper
 {
-    // FPU version
-    /*
-    const uint8 weights0[] = { 0, 3, 1, 2 };
-    const uint8 weights1[] = { 3, 0, 2, 1 };
 
-    const uint32 blocksInRow = width / 4; // TODO non-4-multiply width support
-    const uint32 blockX = x / 4u;
-    const uint32 blockY = y / 4u;
+NFE_FORCE_INLINE static uint16 LoadUint16(const uint8* data)
+{
+    uint16 result;
+    memcpy(&result, data, sizeof(uint16));
+    return result;
+}
 
-    // calculate position inside block
-    x %= 4;
-    y %= 4;
+NFE_FORCE_INLINE static uint32 LoadUint32(const uint8* data)
+{
+    uint32 result;
+    memcpy(&result, data, sizeof(uint32));
+    return result;
+}
 
-    const uint16* blockData = reinterpret_cast<const uint16*>(data + 8 * (blocksInRow * blockY + blockX));
-    const uint32 code = *reinterpret_cast<const uint32*>(blockData + 2);
+NFE_FORCE_INLINE static uint64 LoadUint64(const uint8* data)
+{
+    uint64 result;
+    memcpy(&result, data, sizeof(uint64));
+    return result;
+}
 
-    const uint16 color0 = blockData[0];
-    const uint32 blue0  = (color0 & 0x001Fu);
-    const uint32 green0 = (color0 & 0x07E0u) >> 5u;
-    const uint32 red0   = (color0 & 0xF800u) >> 11u;
+NFE_FORCE_INLINE static uint32 GetBlockSizeInBytes(Bitmap::Format format)
+{
+    return format == Bitmap::Format::BC5 ? 16u : 8u;
+}
 
-    const uint16 color1 = blockData[1];
-    const uint32 blue1  = (color1 & 0x001Fu);
-    const uint32 green1 = (color1 & 0x07E0u) >> 5u;
-    const uint32 red1   = (color1 & 0xF800u) >> 11u;
+NFE_FORCE_INLINE static const uint8* GetBlockData(Bitmap::Format format, const uint8* data, uint32 x, uint32 y, const uint32 width)
+{
+    // round up, so dimensions that are not multiple of 4 are supported
+    const size_t blocksInRow = (width + BlockCompressionBlockSize - 1u) / BlockCompressionBlockSize;
+    const size_t blockX = x / BlockCompressionBlockSize;
+    const size_t blockY = y / BlockCompressionBlockSize;
+
+    return data + GetBlockSizeInBytes(format) * (blocksInRow * blockY + blockX);
+}
+
+NFE_FORCE_INLINE static uint32 GetTexelIndexInBlock(uint32 x, uint32 y)
+{
+    return BlockCompressionBlockSize * (y % BlockCompressionBlockSize) + (x % BlockCompressionBlockSize);
+}
 
-    const uint32 positionCode = (code >> 2u * (4u * y + x)) % 4;
+// decode BC4-like 8-entry grayscale block into 16 floats
+static void DecodeBC_Grayscale(const uint8* blockData, float* outValues)
+{
+    const uint32 intColor0 = blockData[0];
+    const uint32 intColor1 = blockData[1];
+    const float color0 = static_cast<float>(intColor0) / 255.0f;
+    const float color1 = static_cast<float>(intColor1) / 255.0f;
 
-    const uint32 weight1 = weights0[positionCode];
-    const uint32 weight0 = weights1[positionCode];
+    // build palette for all 8 indices at once
+    Vec8f palette;
+    if (intColor0 > intColor1)
+    {
+        const Vec8f weights0(1.0f, 0.0f, 6.0f / 7.0f, 5.0f / 7.0f, 4.0f / 7.0f, 3.0f / 7.0f, 2.0f / 7.0f, 1.0f / 7.0f);
+        const Vec8f weights1(0.0f, 1.0f, 1.0f / 7.0f, 2.0f / 7.0f, 3.0f / 7.0f, 4.0f / 7.0f, 5.0f / 7.0f, 6.0f / 7.0f);
+        palette = Vec8f::MulAndAdd(weights0, color0, weights1 * color1);
+    }
+    else
+    {
+        const Vec8f weights0(1.0f, 0.0f, 4.0f / 5.0f, 3.0f / 5.0f, 2.0f / 5.0f, 1.0f / 5.0f, 0.0f, 0.0f);
+        const Vec8f weights1(0.0f, 1.0f, 1.0f / 5.0f, 2.0f / 5.0f, 3.0f / 5.0f, 4.0f / 5.0f, 0.0f, 0.0f);
+        const Vec8f offset(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f);
+        palette = Vec8f::MulAndAdd(weights0, color0, Vec8f::MulAndAdd(weights1, color1, offset));
+    }
 
-    const uint32 blue  = (weight0 * blue0 + weight1 * blue1) / 3u;
-    const uint32 green = (weight0 * green0 + weight1 * green1) / 3u;
-    const uint32 red   = (weight0 * red0 + weight1 * red1) / 3u;
-    const uint32 rgba =  ((blue << 19) | (green << 10)) | (red << 3);
+    const float* paletteValues = reinterpret_cast<const float*>(&palette);
 
-    return Vec4f::Load4((const uint8*)&rgba) * (1.0f / 255.0f);
-    */
+    // 48-bit index data, 3 bits per texel, split into two 24-bit halves
+    // NOTE: indices occupy the last 6 bytes of the block, so loading 8 bytes would read past its end
+    const uint64 code = static_cast<uint64>(LoadUint32(blockData + 2)) | (static_cast<uint64>(LoadUint16(blockData + 6)) << 32u);
+    const Vec8i shifts(0, 3, 6, 9, 12, 15, 18, 21);
+    const Vec8i indexMask(7);
 
-    const size_t blocksInRow = width / 4u; // TODO non-4-multiply width support
-    const size_t blockX = x / 4u;
-    const size_t blockY = y / 4u;
+    const Vec8i indices0 = (Vec8i(static_cast<int32>(code & 0xFFFFFFu)) >> shifts) & indexMask;
+    const Vec8i indices1 = (Vec8i(static_cast<int32>((code >> 24u) & 0xFFFFFFu)) >> shifts) & indexMask;
 
-    // calculate position inside block
-    x %= 4u;
-    y %= 4u;
+    // NOTE: output must be 32-byte aligned
+    reinterpret_cast<Vec8f*>(outValues)[0] = Gather8(paletteValues, indices0);
+    reinterpret_cast<Vec8f*>(outValues)[1] = Gather8(paletteValues, indices1);
+}
 
-    const uint8* blockData = data + 8u * (blocksInRow * blockY + blockX);
+} // helper
 
+void DecodeBC1Block(const uint8* blockData, Vec4f* outColors)
+{
     // extract base colors for given block
     const Vec4i mask = { 0x1F << 11, 0x3F << 5, 0x1F, 0 };
     const Vec4i raw0 = Vec4i(*reinterpret_cast<const int32*>(blockData + 0)) & mask;
     const Vec4i raw1 = Vec4i(*reinterpret_cast<const int32*>(blockData + 2)) & mask;
-    const Vec4f color0 = raw0.ConvertToVec4f();
-    const Vec4f color1 = raw1.ConvertToVec4f();
-    // TODO alpha support
 
-    // extract color index for given pixel
-    const uint32 code = *reinterpret_cast<const uint32*>(blockData + 4);
-    const uint32 codeOffset = 2u * (4u * y + x);
-    const uint32 index = (code >> codeOffset) % 4;
-
-    // calculate final color by blending base colors + scale down from 5,6,5 bit ranges to 0...1 float range
-    const float weights[] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+    // scale down from 5,6,5 bit ranges to 0...1 float range
     const Vec4f scale{ 1.0f / 2048.0f / 31.0f, 1.0f / 32.0f / 63.0f, 1.0f / 31.0f, 0.0f };
-    return Vec4f::Lerp(color0, color1, weights[index]) * scale;
-}
+    const Vec4f alpha{ 0.0f, 0.0f, 0.0f, 1.0f };
+    const Vec4f color0 = Vec4f::MulAndAdd(raw0.ConvertToVec4f(), scale, alpha);
+    const Vec4f color1 = Vec4f::MulAndAdd(raw1.ConvertToVec4f(), scale, alpha);
 
-namespace helper
-{
+    Vec4f palette[4];
+    palette[0] = color0;
+    palette[1] = color1;
 
-static float DecodeBC_Grayscale(const uint8* blockData, const uint32 x, const uint32 y)
+    uint16 intColor0, intColor1;
+    memcpy(&intColor0, blockData + 0, sizeof(uint16));
+    memcpy(&intColor1, blockData + 2, sizeof(uint16));
+
+    if (intColor0 > intColor1)
+    {
+        palette[2] = Vec4f::Lerp(color0, color1, 1.0f / 3.0f);
+        palette[3] = Vec4f::Lerp(color0, color1, 2.0f / 3.0f);
+    }
+    else
+    {
+        // 3-color mode with transparent black
+        palette[2] = Vec4f::Lerp(color0, color1, 0.5f);
+        palette[3] = Vec4f::Zero();
+    }
+
+    // extract color indices
+    uint32 code;
+    memcpy(&code, blockData + 4, sizeof(uint32));
+
+    for (uint32 i = 0; i < BlockCompressionTexelsPerBlock; ++i)
+    {
+        outColors[i] = palette[(code >> (2u * i)) & 0x3u];
+    }
+}
+
+void DecodeBC4Block(const uint8* blockData, Vec4f* outColors)
 {
-    const float intColor0 = blockData[0];
-    const float intColor1 = blockData[1];
-    const float color0 = static_cast<float>(intColor0) / 255.0f;
-    const float color1 = static_cast<float>(intColor1) / 255.0f;
+    NFE_ALIGN(32) float values[BlockCompressionTexelsPerBlock];
+    helper::DecodeBC_Grayscale(blockData, values);
 
-    const uint64 code = *reinterpret_cast<const uint64*>(blockData + 2);
-    const uint32 index = (code >> (uint64)(3 * (4 * y + x))) % 8;
+    for (uint32 i = 0; i < BlockCompressionTexelsPerBlock; ++i)
+    {
+        outColors[i] = Vec4f(values[i], values[i], values[i], 1.0f);
+    }
+}
 
-    // TODO SSE
+void DecodeBC5Block(const uint8* blockData, Vec4f* outColors)
+{
+    NFE_ALIGN(32) float red[BlockCompressionTexelsPerBlock];
+    NFE_ALIGN(32) float green[BlockCompressionTexelsPerBlock];
+    helper::DecodeBC_Grayscale(blockData, red);
+    helper::DecodeBC_Grayscale(blockData + 8, green);
 
-    if (index == 0)
-        return color0;
-    else if (index == 1)
-        return color1;
-    else if (intColor0 > intColor1)
-        return (color0 * (8 - index) + color1 * (index - 1)) / 7.0f;
-    else
+    for (uint32 i = 0; i < BlockCompressionTexelsPerBlock; ++i)
     {
-        if (index == 6)
-            return 0.0f;
-        else if (index == 7)
-            return 1.0f;
-        else
-            return (color0 * (6 - index) + color1 * (index - 1)) / 5.0f;
+        outColors[i] = Vec4f(green[i], red[i], 0.0f, 1.0f);
     }
 }
 
-} // helper
+namespace {
+
+// number of decoded blocks kept per thread (must be power of two)
+constexpr uint32 DecodedBlockCacheSizeLog2 = 5;
+constexpr uint32 DecodedBlockCacheSize = 1u << DecodedBlockCacheSizeLog2;
 
-const Vec4f DecodeBC4(const uint8* data, uint32 x, uint32 y, const uint32 width)
+// Entries are keyed by raw compressed block bits (not by address), so they never go stale
+// when bitmap memory is released and reused. Identical blocks in different bitmaps share an entry.
+struct DecodedBlockCacheEntry
 {
-    const size_t blocksInRow = width / 4; // TODO non-4-multiply width support
-    const size_t blockX = x / 4u;
-    const size_t blockY = y / 4u;
+    Vec4f colors[BlockCompressionTexelsPerBlock];
+    uint64 key[2];
+    Bitmap::Format format;
+};
 
-    // calculate position inside block
-    x %= 4;
-    y %= 4;
+struct DecodedBlockCache
+{
+    DecodedBlockCacheEntry entries[DecodedBlockCacheSize];
+};
 
-    const uint8* blockData = reinterpret_cast<const uint8*>(data + 8 * (blocksInRow * blockY + blockX));
-    const float value = helper::DecodeBC_Grayscale(blockData, x, y);
-    return Vec4f(value, value, value, 1.0f);
-}
+thread_local DecodedBlockCache gDecodedBlockCache;
 
-const Vec4f DecodeBC5(const uint8* data, uint32 x, uint32 y, const uint32 width)
+} // namespace
+
+const Vec4f* FetchBCBlock(Bitmap::Format format, const uint8* data, uint32 x, uint32 y, const uint32 width)
 {
-    const size_t blocksInRow = width / 4; // TODO non-4-multiply width support
-    const size_t blockX = x / 4u;
-    const size_t blockY = y / 4u;
+    const uint8* blockData = helper::GetBlockData(format, data, x, y, width);
+
+    const uint64 key0 = helper::LoadUint64(blockData);
+    const uint64 key1 = format == Bitmap::Format::BC5 ? helper::LoadUint64(blockData + 8) : 0;
 
-    // calculate position inside block
-    x %= 4;
-    y %= 4;
+    const uint64 hash = (key0 ^ (key1 * 0xC2B2AE3D27D4EB4Full) ^ static_cast<uint64>(format)) * 0x9E3779B97F4A7C15ull;
+    DecodedBlockCacheEntry& entry = gDecodedBlockCache.entries[hash >> (64u - DecodedBlockCacheSizeLog2)];
 
-    const uint8* blockDataRed = reinterpret_cast<const uint8*>(data + 16 * (blocksInRow * blockY + blockX));
-    const float red = helper::DecodeBC_Grayscale(blockDataRed, x, y);
+    if (entry.format != format || entry.key[0] != key0 || entry.key[1] != key1)
+    {
+        switch (format)
+        {
+        case Bitmap::Format::BC1:
+            DecodeBC1Block(blockData, entry.colors);
+            break;
+        case Bitmap::Format::BC4:
+            DecodeBC4Block(blockData, entry.colors);
+            break;
+        case Bitmap::Format::BC5:
+            DecodeBC5Block(blockData, entry.colors);
+            break;
+        default:
+            NFE_FATAL("Unsupported block compression format");
+        }
+
+        entry.key[0] = key0;
+        entry.key[1] = key1;
+        entry.format = format;
+    }
+
+    return entry.colors;
+}
 
-    const uint8* blockDataGreen = blockDataRed + 8;
-    const float green = helper::DecodeBC_Grayscale(blockDataGreen, x, y);
+const Vec4f DecodeBC(Bitmap::Format format, const uint8* data, uint32 x, uint32 y, const uint32 width)
+{
+    const Vec4f* block = FetchBCBlock(format, data, x, y, width);
+    return block[helper::GetTexelIndexInBlock(x, y)];
+}
 
-    return Vec4f(green, red, 0.0f, 1.0f);
+void DecodeBCPixelBlock(Bitmap::Format format, const uint8* data, const Vec4ui coords, const uint32 width, Vec4f* outColors)
+{
+    if ((coords.x / BlockCompressionBlockSize) == (coords.z / BlockCompressionBlockSize) &&
+        (coords.y / BlockCompressionBlockSize) == (coords.w / BlockCompressionBlockSize))
+    {
+        const Vec4f* block = FetchBCBlock(format, data, coords.x, coords.y, width);
+        outColors[0] = block[helper::GetTexelIndexInBlock(coords.x, coords.y)];
+        outColors[1] = block[helper::GetTexelIndexInBlock(coords.z, coords.y)];
+        outColors[2] = block[helper::GetTexelIndexInBlock(coords.x, coords.w)];
+        outColors[3] = block[helper::GetTexelIndexInBlock(coords.z, coords.w)];
+    }
+    else
+    {
+        outColors[0] = DecodeBC(format, data, coords.x, coords.y, width);
+        outColors[1] = DecodeBC(format, data, coords.z, coords.y, width);
+        outColors[2] = DecodeBC(format, data, coords.x, coords.w, width);
+        outColors[3] = DecodeBC(format, data, coords.z, coords.w, width);
+    }
 }
 
 } // namespace RT
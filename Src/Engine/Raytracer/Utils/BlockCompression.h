@@ -1,15 +1,30 @@
 #pragma once
 
-#include "../Raytracer.h"
+#include "Bitmap.h"
 #include "../../Common/Math/Vec4f.hpp"
 
 
 namespace NFE {
 namespace RT {
 
-const Math::Vec4f DecodeBC1(const uint8* data, uint32 x, uint32 y, const uint32 width);
-const Math::Vec4f DecodeBC4(const uint8* data, uint32 x, uint32 y, const uint32 width);
-const Math::Vec4f DecodeBC5(const uint8* data, uint32 x, uint32 y, const uint32 width);
+static constexpr uint32 BlockCompressionBlockSize = 4;
+static constexpr uint32 BlockCompressionTexelsPerBlock = BlockCompressionBlockSize * BlockCompressionBlockSize;
+
+// decode whole 4x4 block (texels are written in row-major order)
+void DecodeBC1Block(const uint8* blockData, Math::Vec4f* outColors);
+void DecodeBC4Block(const uint8* blockData, Math::Vec4f* outColors);
+void DecodeBC5Block(const uint8* blockData, Math::Vec4f* outColors);
+
+// get decoded 4x4 block containing given texel
+// NOTE: decoded blocks are kept in a small per-thread cache, so the returned pointer is valid only until next fetch
+const Math::Vec4f* FetchBCBlock(Bitmap::Format format, const uint8* data, uint32 x, uint32 y, const uint32 width);
+
+// decode single texel
+const Math::Vec4f DecodeBC(Bitmap::Format format, const uint8* data, uint32 x, uint32 y, const uint32 width);
+
+// decode 2x2 texel neighborhood, coords = (x0, y0, x1, y1)
+// if all four texels lie in the same block, the block is decoded (or fetched from the cache) only once
+void DecodeBCPixelBlock(Bitmap::Format format, const uint8* data, const Math::Vec4ui coords, const uint32 width, Math::Vec4f* outColors);
 
 } // namespace RT
 } // namespace NFE
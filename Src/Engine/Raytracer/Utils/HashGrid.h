@@ -40,6 +40,9 @@ public:
             // TODO tweak this
             uint32 hashTableSize = Math::NextPowerOfTwo(particles.Size());
             mHashTableMask = hashTableSize - 1;
+
+            // old content is overwritten anyway, so clear first to avoid moving it when growing
+            mCellEnds.Clear();
             mCellEnds.Resize(hashTableSize);
 
             memset(mCellEnds.Data(), 0, mCellEnds.Size() * sizeof(uint32));
@@ -64,6 +67,7 @@ public:
         }
 
         // fill up particle indices
+        mIndices.Clear();
         mIndices.Resize(particles.Size());
         for (uint32 i = 0; i < particles.Size(); i++)
         {
@@ -0,0 +1,464 @@
+#include "PCH.h"
+#include "SparseVolume.h"
+#include "../Common/Math/Half.hpp"
+#include "../Common/Logger/Logger.hpp"
+#include "../Common/System/Timer.hpp"
+
+namespace NFE {
+namespace RT {
+
+using namespace Common;
+using namespace Math;
+
+uint32 SparseVolume::BytesPerVoxel(Bitmap::Format format)
+{
+    switch (format)
+    {
+    case Bitmap::Format::R8_UNorm:      return sizeof(uint8);
+    case Bitmap::Format::R16_Half:      return sizeof(Half);
+    case Bitmap::Format::R32_Float:     return sizeof(float);
+    }
+
+    return 0;
+}
+
+SparseVolume::SparseVolume(const char* debugName)
+    : mNumAllocatedBricks(0)
+    , mBytesPerVoxel(0)
+    , mBackground(0.0f)
+    , mMaxValue(0.0f)
+    , mFormat(Bitmap::Format::Unknown)
+{
+    NFE_ASSERT(debugName, "Invalid debug name");
+    mDebugName = strdup(debugName);
+}
+
+SparseVolume::~SparseVolume()
+{
+    free(mDebugName);
+
+    Release();
+}
+
+SparseVolume::SparseVolume(SparseVolume&& other)
+    : mSize(other.mSize)
+    , mNumBricks(other.mNumBricks)
+    , mFloatSize(other.mFloatSize)
+    , mBrickIndices(std::move(other.mBrickIndices))
+    , mBrickPages(std::move(other.mBrickPages))
+    , mDebugName(other.mDebugName)
+    , mNumAllocatedBricks(other.mNumAllocatedBricks)
+    , mBytesPerVoxel(other.mBytesPerVoxel)
+    , mBackground(other.mBackground)
+    , mMaxValue(other.mMaxValue)
+    , mFormat(other.mFormat)
+{
+    other.mDebugName = strdup(mDebugName);
+    other.Release();
+}
+
+SparseVolume& SparseVolume::operator = (SparseVolume&& other)
+{
+    if (this != &other)
+    {
+        Release();
+        free(mDebugName);
+
+        mSize = other.mSize;
+        mNumBricks = other.mNumBricks;
+        mFloatSize = other.mFloatSize;
+        mBrickIndices = std::move(other.mBrickIndices);
+        mBrickPages = std::move(other.mBrickPages);
+        mDebugName = strdup(other.mDebugName);
+        mNumAllocatedBricks = other.mNumAllocatedBricks;
+        mBytesPerVoxel = other.mBytesPerVoxel;
+        mBackground = other.mBackground;
+        mMaxValue = other.mMaxValue;
+        mFormat = other.mFormat;
+
+        other.Release();
+    }
+
+    return *this;
+}
+
+size_t SparseVolume::GetMemorySize() const
+{
+    const size_t pageSize = size_t(VoxelsPerBrick) * BricksPerPage * mBytesPerVoxel;
+    return sizeof(uint32) * mBrickIndices.Size() + pageSize * mBrickPages.Size();
+}
+
+void SparseVolume::Release()
+{
+    for (uint8* page : mBrickPages)
+    {
+        NFE_FREE(page);
+    }
+
+    mBrickPages.Clear(true);
+    mBrickIndices.Clear(true);
+
+    mSize = Vec4ui::Zero();
+    mNumBricks = Vec4ui::Zero();
+    mFloatSize = Vec4f::Zero();
+    mNumAllocatedBricks = 0;
+    mBytesPerVoxel = 0;
+    mBackground = 0.0f;
+    mMaxValue = 0.0f;
+    mFormat = Bitmap::Format::Unknown;
+}
+
+bool SparseVolume::Init(const InitData& initData)
+{
+    const uint32 bytesPerVoxel = BytesPerVoxel(initData.format);
+    if (bytesPerVoxel == 0)
+    {
+        NFE_LOG_ERROR("SparseVolume: Unsupported format: %s", Bitmap::FormatToString(initData.format));
+        return false;
+    }
+
+    if (initData.width == 0 || initData.height == 0 || initData.depth == 0)
+    {
+        NFE_LOG_ERROR("SparseVolume: Invalid dimensions (%ux%ux%u)", initData.width, initData.height, initData.depth);
+        return false;
+    }
+
+    const Vec4ui numBricks(
+        (initData.width + BrickMask) >> BrickSizeLog2,
+        (initData.height + BrickMask) >> BrickSizeLog2,
+        (initData.depth + BrickMask) >> BrickSizeLog2,
+        0);
+
+    const uint64 totalBricks = uint64(numBricks.x) * uint64(numBricks.y) * uint64(numBricks.z);
+    if (totalBricks >= uint64(EmptyBrick))
+    {
+        NFE_LOG_ERROR("SparseVolume: Volume is too big (%ux%ux%u)", initData.width, initData.height, initData.depth);
+        return false;
+    }
+
+    Release();
+
+    if (!mBrickIndices.Resize(static_cast<uint32>(totalBricks), EmptyBrick))
+    {
+        NFE_LOG_ERROR("SparseVolume: Memory allocation failed");
+        return false;
+    }
+
+    mSize = Vec4ui(initData.width, initData.height, initData.depth, 0);
+    mNumBricks = numBricks;
+    mFloatSize = Vec4f::FromIntegers(initData.width, initData.height, initData.depth, 0);
+    mBytesPerVoxel = bytesPerVoxel;
+    mBackground = initData.background;
+    mMaxValue = initData.background;
+    mFormat = initData.format;
+
+    return true;
+}
+
+uint32 SparseVolume::AllocateBrick()
+{
+    const uint32 brick = mNumAllocatedBricks;
+    const uint32 page = brick / BricksPerPage;
+
+    if (page >= mBrickPages.Size())
+    {
+        const size_t pageSize = size_t(VoxelsPerBrick) * BricksPerPage * mBytesPerVoxel;
+        uint8* pageData = (uint8*)NFE_MALLOC(pageSize, NFE_CACHE_LINE_SIZE);
+        if (!pageData)
+        {
+            NFE_LOG_ERROR("SparseVolume: Memory allocation failed");
+            return EmptyBrick;
+        }
+
+        mBrickPages.PushBack(pageData);
+    }
+
+    uint8* brickData = GetBrickData(brick);
+    for (uint32 i = 0; i < VoxelsPerBrick; ++i)
+    {
+        EncodeVoxel(brickData, i, mBackground);
+    }
+
+    mNumAllocatedBricks++;
+    return brick;
+}
+
+float SparseVolume::DecodeVoxel(const uint8* brickData, uint32 offset) const
+{
+    switch (mFormat)
+    {
+    case Bitmap::Format::R8_UNorm:
+        return static_cast<float>(brickData[offset]) * (1.0f / 255.0f);
+    case Bitmap::Format::R16_Half:
+        return reinterpret_cast<const Half*>(brickData)[offset].ToFloat();
+    case Bitmap::Format::R32_Float:
+        return reinterpret_cast<const float*>(brickData)[offset];
+    }
+
+    NFE_FATAL("Unsupported volume format");
+    return 0.0f;
+}
+
+void SparseVolume::EncodeVoxel(uint8* brickData, uint32 offset, float value) const
+{
+    switch (mFormat)
+    {
+    case Bitmap::Format::R8_UNorm:
+        brickData[offset] = static_cast<uint8>(Clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+        break;
+    case Bitmap::Format::R16_Half:
+        reinterpret_cast<Half*>(brickData)[offset] = Half(value);
+        break;
+    case Bitmap::Format::R32_Float:
+        reinterpret_cast<float*>(brickData)[offset] = value;
+        break;
+    default:
+        NFE_FATAL("Unsupported volume format");
+    }
+}
+
+void SparseVolume::SetVoxel(uint32 x, uint32 y, uint32 z, float value)
+{
+    NFE_ASSERT(x < GetWidth() && y < GetHeight() && z < GetDepth(), "");
+
+    const uint32 bx = x >> BrickSizeLog2;
+    const uint32 by = y >> BrickSizeLog2;
+    const uint32 bz = z >> BrickSizeLog2;
+    uint32& brick = mBrickIndices[bx + mNumBricks.x * (by + mNumBricks.y * bz)];
+
+    if (brick == EmptyBrick)
+    {
+        if (value == mBackground)
+        {
+            return;
+        }
+
+        brick = AllocateBrick();
+        if (brick == EmptyBrick)
+        {
+            return;
+        }
+    }
+
+    EncodeVoxel(GetBrickData(brick), GetVoxelOffset(x, y, z), value);
+    mMaxValue = Max(mMaxValue, value);
+}
+
+float SparseVolume::GetVoxel(uint32 x, uint32 y, uint32 z) const
+{
+    NFE_ASSERT(x < GetWidth() && y < GetHeight() && z < GetDepth(), "");
+
+    const uint32 brick = GetBrickIndex(x, y, z);
+    if (brick == EmptyBrick)
+    {
+        return mBackground;
+    }
+
+    return DecodeVoxel(GetBrickData(brick), GetVoxelOffset(x, y, z));
+}
+
+void SparseVolume::GetVoxelBlock(const Vec4ui coordsA, const Vec4ui coordsB, float* outValues) const
+{
+    NFE_ASSERT((coordsA < mSize).All3(), "");
+    NFE_ASSERT((coordsB < mSize).All3(), "");
+
+    const uint32 brick = GetBrickIndex(coordsA.x, coordsA.y, coordsA.z);
+
+    // fast path: all 8 voxels lie in the same brick
+    if ((coordsA.x >> BrickSizeLog2) == (coordsB.x >> BrickSizeLog2) &&
+        (coordsA.y >> BrickSizeLog2) == (coordsB.y >> BrickSizeLog2) &&
+        (coordsA.z >> BrickSizeLog2) == (coordsB.z >> BrickSizeLog2))
+    {
+        if (brick == EmptyBrick)
+        {
+            for (uint32 i = 0; i < 8u; ++i)
+            {
+                outValues[i] = mBackground;
+            }
+            return;
+        }
+
+        const uint8* brickData = GetBrickData(brick);
+        outValues[0] = DecodeVoxel(brickData, GetVoxelOffset(coordsA.x, coordsA.y, coordsA.z));
+        outValues[1] = DecodeVoxel(brickData, GetVoxelOffset(coordsB.x, coordsA.y, coordsA.z));
+        outValues[2] = DecodeVoxel(brickData, GetVoxelOffset(coordsA.x, coordsB.y, coordsA.z));
+        outValues[3] = DecodeVoxel(brickData, GetVoxelOffset(coordsB.x, coordsB.y, coordsA.z));
+        outValues[4] = DecodeVoxel(brickData, GetVoxelOffset(coordsA.x, coordsA.y, coordsB.z));
+        outValues[5] = DecodeVoxel(brickData, GetVoxelOffset(coordsB.x, coordsA.y, coordsB.z));
+        outValues[6] = DecodeVoxel(brickData, GetVoxelOffset(coordsA.x, coordsB.y, coordsB.z));
+        outValues[7] = DecodeVoxel(brickData, GetVoxelOffset(coordsB.x, coordsB.y, coordsB.z));
+        return;
+    }
+
+    outValues[0] = GetVoxel(coordsA.x, coordsA.y, coordsA.z);
+    outValues[1] = GetVoxel(coordsB.x, coordsA.y, coordsA.z);
+    outValues[2] = GetVoxel(coordsA.x, coordsB.y, coordsA.z);
+    outValues[3] = GetVoxel(coordsB.x, coordsB.y, coordsA.z);
+    outValues[4] = GetVoxel(coordsA.x, coordsA.y, coordsB.z);
+    outValues[5] = GetVoxel(coordsB.x, coordsA.y, coordsB.z);
+    outValues[6] = GetVoxel(coordsA.x, coordsB.y, coordsB.z);
+    outValues[7] = GetVoxel(coordsB.x, coordsB.y, coordsB.z);
+}
+
+float SparseVolume::SampleTrilinear(const Vec4f& texelCoords) const
+{
+    // volume is not initialized (or failed to load)
+    if (mBrickIndices.Empty())
+    {
+        return mBackground;
+    }
+
+    const Vec4f floorCoords = Vec4f::Floor(texelCoords);
+    const Vec4i intCoords = Vec4i::Convert(floorCoords);
+
+    // wrap to volume size
+    const auto wrap = [](int32 coord, uint32 size)
+    {
+        const int32 wrapped = coord % static_cast<int32>(size);
+        return static_cast<uint32>(wrapped < 0 ? wrapped + static_cast<int32>(size) : wrapped);
+    };
+
+    const Vec4ui coordsA(wrap(intCoords.x, mSize.x), wrap(intCoords.y, mSize.y), wrap(intCoords.z, mSize.z), 0);
+    const Vec4ui coordsB(wrap(intCoords.x + 1, mSize.x), wrap(intCoords.y + 1, mSize.y), wrap(intCoords.z + 1, mSize.z), 0);
+
+    float values[8];
+    GetVoxelBlock(coordsA, coordsB, values);
+
+    const Vec4f weights = texelCoords - floorCoords;
+
+    const float value00 = Lerp(values[0], values[1], weights.x);
+    const float value01 = Lerp(values[2], values[3], weights.x);
+    const float value10 = Lerp(values[4], values[5], weights.x);
+    const float value11 = Lerp(values[6], values[7], weights.x);
+
+    const float value0 = Lerp(value00, value01, weights.y);
+    const float value1 = Lerp(value10, value11, weights.y);
+
+    return Lerp(value0, value1, weights.z);
+}
+
+bool SparseVolume::InitFromBitmap(const Bitmap& source, const ConversionParams& params)
+{
+    Timer timer;
+    timer.Start();
+
+    Bitmap::Format format = params.format;
+    if (format == Bitmap::Format::Unknown)
+    {
+        format = BytesPerVoxel(source.GetFormat()) > 0 ? source.GetFormat() : Bitmap::Format::R16_Half;
+    }
+
+    // Bitmap::GetPixel3D supports only these formats
+    if (source.GetFormat() != Bitmap::Format::R8_UNorm && source.GetFormat() != Bitmap::Format::R32_Float)
+    {
+        NFE_LOG_ERROR("SparseVolume: Unsupported source bitmap format: %s", Bitmap::FormatToString(source.GetFormat()));
+        return false;
+    }
+
+    InitData initData;
+    initData.width = source.GetWidth();
+    initData.height = source.GetHeight();
+    initData.depth = source.GetDepth();
+    initData.format = format;
+    initData.background = params.background;
+
+    if (!Init(initData))
+    {
+        return false;
+    }
+
+    float brickValues[VoxelsPerBrick];
+
+    for (uint32 bz = 0; bz < mNumBricks.z; ++bz)
+    {
+        for (uint32 by = 0; by < mNumBricks.y; ++by)
+        {
+            for (uint32 bx = 0; bx < mNumBricks.x; ++bx)
+            {
+                const uint32 startX = bx << BrickSizeLog2;
+                const uint32 startY = by << BrickSizeLog2;
+                const uint32 startZ = bz << BrickSizeLog2;
+                const uint32 endX = Min(startX + BrickSize, GetWidth());
+                const uint32 endY = Min(startY + BrickSize, GetHeight());
+                const uint32 endZ = Min(startZ + BrickSize, GetDepth());
+
+                bool isEmpty = true;
+                float brickMaxValue = mBackground;
+
+                for (uint32 i = 0; i < VoxelsPerBrick; ++i)
+                {
+                    brickValues[i] = mBackground;
+                }
+
+                for (uint32 z = startZ; z < endZ; ++z)
+                {
+                    for (uint32 y = startY; y < endY; ++y)
+                    {
+                        for (uint32 x = startX; x < endX; ++x)
+                        {
+                            const float value = source.GetPixel3D(x, y, z).x;
+                            brickValues[GetVoxelOffset(x, y, z)] = value;
+                            brickMaxValue = Max(brickMaxValue, value);
+
+                            if (Abs(value - mBackground) > params.tolerance)
+                            {
+                                isEmpty = false;
+                            }
+                        }
+                    }
+                }
+
+                if (isEmpty)
+                {
+                    continue;
+                }
+
+                const uint32 brick = AllocateBrick();
+                if (brick == EmptyBrick)
+                {
+                    Release();
+                    return false;
+                }
+
+                uint8* brickData = GetBrickData(brick);
+                for (uint32 i = 0; i < VoxelsPerBrick; ++i)
+                {
+                    EncodeVoxel(brickData, i, brickValues[i]);
+                }
+
+                mBrickIndices[bx + mNumBricks.x * (by + mNumBricks.y * bz)] = brick;
+                mMaxValue = Max(mMaxValue, brickMaxValue);
+            }
+        }
+    }
+
+    const float elapsedTime = static_cast<float>(1000.0 * timer.Stop());
+    NFE_LOG_INFO("SparseVolume '%s' converted in %.3fms: %ux%ux%u, %u/%u bricks allocated, dense size=%.2f MB, sparse size=%.2f MB",
+        mDebugName, elapsedTime, GetWidth(), GetHeight(), GetDepth(),
+        mNumAllocatedBricks, GetNumTotalBricks(),
+        static_cast<float>(source.GetDataSize()) / (1024.0f * 1024.0f),
+        static_cast<float>(GetMemorySize()) / (1024.0f * 1024.0f));
+
+    return true;
+}
+
+bool SparseVolume::Load(const char* path)
+{
+    Timer timer;
+    timer.Start();
+
+    if (!LoadVDB(path))
+    {
+        NFE_LOG_ERROR("Failed to load sparse volume from file '%hs'", path);
+        return false;
+    }
+
+    const float elapsedTime = static_cast<float>(1000.0 * timer.Stop());
+    NFE_LOG_INFO("SparseVolume '%hs' loaded in %.3fms: width=%u, height=%u, depth=%u, format=%s, %u/%u bricks allocated (%.2f MB)",
+        path, elapsedTime, GetWidth(), GetHeight(), GetDepth(), Bitmap::FormatToString(mFormat),
+        mNumAllocatedBricks, GetNumTotalBricks(), static_cast<float>(GetMemorySize()) / (1024.0f * 1024.0f));
+    return true;
+}
+
+} // namespace RT
+} // namespace NFE
@@ -0,0 +1,159 @@
+#pragma once
+
+#include "Bitmap.h"
+#include "../../Common/Containers/DynArray.hpp"
+
+namespace NFE {
+namespace RT {
+
+/**
+ * Class representing sparse, single-channel 3D volume.
+ *
+ * Voxels are grouped into 8x8x8 bricks. Top-level index maps brick coordinates to allocated bricks,
+ * bricks containing only background value are not stored at all.
+ */
+class NFE_ALIGN(16) SparseVolume
+{
+public:
+    NFE_ALIGNED_CLASS(16)
+
+    static constexpr uint32 BrickSizeLog2 = 3;
+    static constexpr uint32 BrickSize = 1u << BrickSizeLog2;
+    static constexpr uint32 BrickMask = BrickSize - 1u;
+    static constexpr uint32 VoxelsPerBrick = BrickSize * BrickSize * BrickSize;
+
+    // number of bricks allocated at once
+    static constexpr uint32 BricksPerPage = 64;
+
+    // top-level index value for a brick that is not allocated
+    static constexpr uint32 EmptyBrick = UINT32_MAX;
+
+    struct InitData
+    {
+        uint32 width = 0;
+        uint32 height = 0;
+        uint32 depth = 0;
+
+        // supported formats: R8_UNorm, R16_Half, R32_Float
+        Bitmap::Format format = Bitmap::Format::R8_UNorm;
+
+        // value returned for voxels in non-allocated bricks
+        float background = 0.0f;
+    };
+
+    struct ConversionParams
+    {
+        // supported formats: R8_UNorm, R16_Half, R32_Float
+        // if Unknown, source bitmap format will be used (if possible)
+        Bitmap::Format format = Bitmap::Format::Unknown;
+
+        // bricks with all voxels within this distance from background value are skipped
+        float tolerance = 0.0f;
+
+        float background = 0.0f;
+    };
+
+    NFE_RAYTRACER_API SparseVolume(const char* debugName = "<unnamed>");
+    NFE_RAYTRACER_API ~SparseVolume();
+    NFE_RAYTRACER_API SparseVolume(SparseVolume&&);
+    NFE_RAYTRACER_API SparseVolume& operator = (SparseVolume&&);
+
+    NFE_MAKE_NONCOPYABLE(SparseVolume)
+
+    NFE_FORCE_INLINE const char* GetDebugName() const { return mDebugName; }
+
+    NFE_FORCE_INLINE const Math::Vec4ui& GetSize() const { return mSize; }
+    NFE_FORCE_INLINE const Math::Vec4f& GetFloatSize() const { return mFloatSize; }
+    NFE_FORCE_INLINE uint32 GetWidth() const { return mSize.x; }
+    NFE_FORCE_INLINE uint32 GetHeight() const { return mSize.y; }
+    NFE_FORCE_INLINE uint32 GetDepth() const { return mSize.z; }
+    NFE_FORCE_INLINE Bitmap::Format GetFormat() const { return mFormat; }
+    NFE_FORCE_INLINE float GetBackground() const { return mBackground; }
+
+    // get maximum voxel value (including background)
+    NFE_FORCE_INLINE float GetMaxValue() const { return mMaxValue; }
+
+    NFE_FORCE_INLINE uint32 GetNumAllocatedBricks() const { return mNumAllocatedBricks; }
+    NFE_FORCE_INLINE uint32 GetNumTotalBricks() const { return mBrickIndices.Size(); }
+
+    // get number of bytes used by the volume (index + bricks)
+    NFE_RAYTRACER_API size_t GetMemorySize() const;
+
+    // initialize empty volume (all voxels set to background value)
+    NFE_RAYTRACER_API bool Init(const InitData& initData);
+
+    // release memory
+    NFE_RAYTRACER_API void Release();
+
+    // convert dense 3D bitmap
+    NFE_RAYTRACER_API bool InitFromBitmap(const Bitmap& source, const ConversionParams& params);
+
+    // load from file (OpenVDB)
+    NFE_RAYTRACER_API bool Load(const char* path);
+
+    // set single voxel value (allocates brick if needed)
+    NFE_RAYTRACER_API void SetVoxel(uint32 x, uint32 y, uint32 z, float value);
+
+    // get single voxel value
+    NFE_RAYTRACER_API float GetVoxel(uint32 x, uint32 y, uint32 z) const;
+
+    // get 2x2x2 voxel block
+    NFE_RAYTRACER_API void GetVoxelBlock(const Math::Vec4ui coordsA, const Math::Vec4ui coordsB, float* outValues) const;
+
+    // sample volume with trilinear filtering
+    // NOTE: coordinates are in texel space and are wrapped, empty volume returns background value
+    NFE_RAYTRACER_API float SampleTrilinear(const Math::Vec4f& texelCoords) const;
+
+private:
+
+    static uint32 BytesPerVoxel(Bitmap::Format format);
+
+    bool LoadVDB(const char* path);
+
+    NFE_FORCE_INLINE uint32 GetBrickIndex(uint32 x, uint32 y, uint32 z) const
+    {
+        const uint32 bx = x >> BrickSizeLog2;
+        const uint32 by = y >> BrickSizeLog2;
+        const uint32 bz = z >> BrickSizeLog2;
+        return mBrickIndices[bx + mNumBricks.x * (by + mNumBricks.y * bz)];
+    }
+
+    NFE_FORCE_INLINE static uint32 GetVoxelOffset(uint32 x, uint32 y, uint32 z)
+    {
+        return (x & BrickMask) | ((y & BrickMask) << BrickSizeLog2) | ((z & BrickMask) << (2 * BrickSizeLog2));
+    }
+
+    NFE_FORCE_INLINE const uint8* GetBrickData(uint32 brick) const
+    {
+        const size_t brickSize = size_t(VoxelsPerBrick) * mBytesPerVoxel;
+        return mBrickPages[brick / BricksPerPage] + brickSize * (brick % BricksPerPage);
+    }
+
+    NFE_FORCE_INLINE uint8* GetBrickData(uint32 brick)
+    {
+        const size_t brickSize = size_t(VoxelsPerBrick) * mBytesPerVoxel;
+        return mBrickPages[brick / BricksPerPage] + brickSize * (brick % BricksPerPage);
+    }
+
+    float DecodeVoxel(const uint8* brickData, uint32 offset) const;
+    void EncodeVoxel(uint8* brickData, uint32 offset, float value) const;
+
+    uint32 AllocateBrick();
+
+    Math::Vec4ui mSize = Math::Vec4ui::Zero();      // width, height, depth
+    Math::Vec4ui mNumBricks = Math::Vec4ui::Zero(); // number of bricks in each dimension
+    Math::Vec4f mFloatSize = Math::Vec4f::Zero();
+    Common::DynArray<uint32> mBrickIndices;         // top-level index
+    Common::DynArray<uint8*> mBrickPages;
+    char* mDebugName;
+    uint32 mNumAllocatedBricks;
+    uint32 mBytesPerVoxel;
+    float mBackground;
+    float mMaxValue;
+    Bitmap::Format mFormat;
+};
+
+using SparseVolumePtr = Common::SharedPtr<SparseVolume>;
+
+} // namespace RT
+} // namespace NFE
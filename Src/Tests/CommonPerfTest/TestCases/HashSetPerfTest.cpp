@@ -1,13 +1,14 @@
 /**
  * @file
  * @author Witek902 (witek902@gmail.com)
- * @brief  Performance tests for HashSet
+ * @brief  Performance tests for HashSet and FlatHashSet
  */
 
 #include "PCH.hpp"
 
 #include "Engine/Common/nfCommon.hpp"
 #include "Engine/Common/Containers/HashSet.hpp"
+#include "Engine/Common/Containers/FlatHashSet.hpp"
 #include "Engine/Common/System/Timer.hpp"
 #include "Engine/Common/Math/Random.hpp"
 
@@ -22,10 +23,11 @@ namespace {
 
 volatile int gVolatileTempValue = 0;
 
-void HashSetPerfTest(size_t setSize, const std::vector<int>& values)
+template<typename SetType>
+void NfeSetPerfTest(size_t setSize, const std::vector<int>& values, const std::vector<int>& missingValues)
 {
     Timer timer;
-    HashSet<int> set;
+    SetType set;
 
     // insert keys
     {
@@ -50,6 +52,18 @@ void HashSetPerfTest(size_t setSize, const std::vector<int>& values)
         std::cout << std::setprecision(3) << std::left << std::setw(10) << (1000.0 * t);
     }
 
+    // find non-existing keys
+    {
+        timer.Start();
+        for (size_t i = 0; i < setSize; ++i)
+        {
+            const auto iter = set.Find(missingValues[i]);
+            ASSERT_EQ(set.End(), iter);
+        }
+        double t = timer.Stop();
+        std::cout << std::setprecision(3) << std::left << std::setw(10) << (1000.0 * t);
+    }
+
     // iterate the whole set
     {
         timer.Start();
@@ -87,11 +101,9 @@ void HashSetPerfTest(size_t setSize, const std::vector<int>& values)
         double t = timer.Stop();
         std::cout << std::setprecision(3) << std::left << std::setw(10) << (1000.0 * t);
     }
-
-    std::cout << std::left << std::setw(13) << set.CalculateHashCollisions();
 }
 
-void StlUnorderedSetPerfTest(size_t setSize, const std::vector<int>& values)
+void StlUnorderedSetPerfTest(size_t setSize, const std::vector<int>& values, const std::vector<int>& missingValues)
 {
     Timer timer;
     std::unordered_set<int> set;
@@ -119,6 +131,18 @@ void StlUnorderedSetPerfTest(size_t setSize, const std::vector<int>& values)
         std::cout << std::setprecision(3) << std::left << std::setw(10) << (1000.0 * t);
     }
 
+    // find non-existing keys
+    {
+        timer.Start();
+        for (size_t i = 0; i < setSize; ++i)
+        {
+            const auto iter = set.find(missingValues[i]);
+            ASSERT_EQ(set.end(), iter);
+        }
+        double t = timer.Stop();
+        std::cout << std::setprecision(3) << std::left << std::setw(10) << (1000.0 * t);
+    }
+
     // iterate the whole set
     {
         timer.Start();
@@ -162,20 +186,21 @@ void StlUnorderedSetPerfTest(size_t setSize, const std::vector<int>& values)
 
 TEST(HashSet, Basic)
 {
-    Timer timer;
-
     // prepare random data
-    const size_t minValues = 64;
-    const size_t maxValues = 16 * 1024 * 1024;
+    const size_t minValues = 10 * 1000;
+    const size_t maxValues = 10 * 1000 * 1000;
     std::vector<int> values;
-    std::vector<int> valuesToErase;
+    std::vector<int> missingValues;
     {
         values.reserve(maxValues);
+        missingValues.reserve(maxValues);
 
+        // inserted keys are odd, missing keys are even
         Math::Random random;
         for (size_t i = 0; i < maxValues; ++i)
         {
-            values.push_back(random.GetInt());
+            values.push_back(random.GetInt() | 1);
+            missingValues.push_back(random.GetInt() & ~1);
         }
 
         random.ShuffleContainer(values.begin(), values.end(), maxValues);
@@ -183,32 +208,30 @@ TEST(HashSet, Basic)
 
     std::cout
         << "1 - inserting [ms]" << std::endl
-        << "2 - finding [ms]" << std::endl
-        << "3 - iterating [ms]" << std::endl
-        << "4 - erasing [ms]" << std::endl
-        << "C - number of hash collisions" << std::endl
-        << "---------------------------------------------------------------------" << std::endl
-        << "Num keys | 1       | 2       | 3       | 4       | 5       | C" << std::endl
-        << "---------------------------------------------------------------------" << std::endl
-        << "NFE::Common::HashSet" << std::endl
-        << "---------------------------------------------------------------------" << std::endl;
-
-    for (size_t numValues = minValues; numValues <= maxValues; numValues *= 2)
-    {
-        std::cout << std::left << std::setw(11) << numValues;
-        HashSetPerfTest(numValues, values);
-        std::cout << std::endl;
-    }
+        << "2 - finding existing keys [ms]" << std::endl
+        << "3 - finding non-existing keys [ms]" << std::endl
+        << "4 - iterating [ms]" << std::endl
+        << "5 - erasing [ms]" << std::endl
+        << "6 - iterating after erase [ms]" << std::endl;
 
-    std::cout
-        << "---------------------------------------------------------------------" << std::endl
-        << "std::unordered_set " << std::endl
-        << "---------------------------------------------------------------------" << std::endl;
-
-    for (size_t numValues = minValues; numValues <= maxValues; numValues *= 2)
+    const auto runTest = [&](const char* name, void(*testFunc)(size_t, const std::vector<int>&, const std::vector<int>&))
     {
-        std::cout << std::left << std::setw(11) << numValues;
-        StlUnorderedSetPerfTest(numValues, values);
-        std::cout << std::endl;
-    }
-}
\ No newline at end of file
+        std::cout
+            << "-------------------------------------------------------------------------" << std::endl
+            << name << std::endl
+            << "-------------------------------------------------------------------------" << std::endl
+            << "Num keys | 1       | 2       | 3       | 4       | 5       | 6" << std::endl
+            << "-------------------------------------------------------------------------" << std::endl;
+
+        for (size_t numValues = minValues; numValues <= maxValues; numValues *= 10)
+        {
+            std::cout << std::left << std::setw(11) << numValues;
+            testFunc(numValues, values, missingValues);
+            std::cout << std::endl;
+        }
+    };
+
+    runTest("NFE::Common::HashSet", NfeSetPerfTest<HashSet<int>>);
+    runTest("NFE::Common::FlatHashSet", NfeSetPerfTest<FlatHashSet<int>>);
+    runTest("std::unordered_set", StlUnorderedSetPerfTest);
+}
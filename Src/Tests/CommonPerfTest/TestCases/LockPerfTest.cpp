@@ -0,0 +1,191 @@
+/**
+ * @file
+ * @author Witek902 (witek902@gmail.com)
+ * @brief  Performance tests for locking primitives.
+ */
+
+#include "PCH.hpp"
+#include "Engine/Common/System/Mutex.hpp"
+#include "Engine/Common/System/RWLock.hpp"
+#include "Engine/Common/System/SpinLock.hpp"
+#include "Engine/Common/System/RWSpinLock.hpp"
+#include "Engine/Common/System/HybridLock.hpp"
+#include "Engine/Common/System/ContentionCountingLock.hpp"
+#include "Engine/Common/System/Thread.hpp"
+#include "Engine/Common/System/Timer.hpp"
+#include "Engine/Common/Utils/ScopedLock.hpp"
+#include "Engine/Common/Containers/DynArray.hpp"
+
+using namespace NFE;
+using namespace NFE::Common;
+
+namespace {
+
+const uint32 MinThreads = 2;
+const uint32 MaxThreads = 128;
+
+// total number of lock acquisitions (split between the threads)
+const uint32 NumOperations = 1000000;
+
+// measure throughput of exclusive locking (in millions of acquisitions per second)
+template<typename LockType>
+double MeasureExclusiveThroughput(uint32 numThreads)
+{
+    alignas(NFE_CACHE_LINE_SIZE) LockType lock;
+    alignas(NFE_CACHE_LINE_SIZE) uint64 counter = 0;
+    std::atomic<bool> start(false);
+
+    const uint32 numOperationsPerThread = NumOperations / numThreads;
+
+    const auto func = [&]()
+    {
+        while (!start)
+        {
+            Thread::YieldCurrentThread();
+        }
+
+        for (uint32 i = 0; i < numOperationsPerThread; ++i)
+        {
+            NFE_SCOPED_LOCK(lock);
+            counter++;
+        }
+    };
+
+    DynArray<Thread> threads(numThreads);
+    for (uint32 i = 0; i < numThreads; ++i)
+    {
+        threads[i].Run(func);
+    }
+
+    Timer timer;
+    timer.Start();
+    start = true;
+    threads.Clear(); // joins the threads
+    const double time = timer.Stop();
+
+    EXPECT_EQ(static_cast<uint64>(numOperationsPerThread) * numThreads, counter);
+
+    return 1.0e-6 * static_cast<double>(counter) / time;
+}
+
+// measure throughput of mixed shared/exclusive locking (one in "writeRatio" operations is exclusive)
+template<typename LockType>
+double MeasureSharedThroughput(uint32 numThreads, uint32 writeRatio)
+{
+    alignas(NFE_CACHE_LINE_SIZE) LockType lock;
+    alignas(NFE_CACHE_LINE_SIZE) uint64 value = 0;
+    std::atomic<uint64> readSum(0);
+    std::atomic<bool> start(false);
+
+    const uint32 numOperationsPerThread = NumOperations / numThreads;
+
+    const auto func = [&]()
+    {
+        while (!start)
+        {
+            Thread::YieldCurrentThread();
+        }
+
+        uint64 localSum = 0;
+        for (uint32 i = 0; i < numOperationsPerThread; ++i)
+        {
+            if (i % writeRatio == 0)
+            {
+                ScopedExclusiveLock<LockType> scopedLock(lock);
+                value++;
+            }
+            else
+            {
+                ScopedSharedLock<LockType> scopedLock(lock);
+                localSum += value;
+            }
+        }
+
+        readSum += localSum;
+    };
+
+    DynArray<Thread> threads(numThreads);
+    for (uint32 i = 0; i < numThreads; ++i)
+    {
+        threads[i].Run(func);
+    }
+
+    Timer timer;
+    timer.Start();
+    start = true;
+    threads.Clear();
+    const double time = timer.Stop();
+
+    return 1.0e-6 * static_cast<double>(numOperationsPerThread) * numThreads / time;
+}
+
+} // namespace
+
+
+TEST(Lock, ExclusiveThroughput)
+{
+    std::cout << "Threads | Mutex [Mops/s] | SpinLock [Mops/s] | HybridLock [Mops/s] | RWSpinLock [Mops/s]" << std::endl;
+
+    for (uint32 numThreads = MinThreads; numThreads <= MaxThreads; numThreads *= 2)
+    {
+        std::cout << std::setw(7) << numThreads << " | "
+            << std::setw(14) << std::setprecision(3) << MeasureExclusiveThroughput<Mutex>(numThreads) << " | "
+            << std::setw(17) << std::setprecision(3) << MeasureExclusiveThroughput<SpinLock>(numThreads) << " | "
+            << std::setw(19) << std::setprecision(3) << MeasureExclusiveThroughput<HybridLock>(numThreads) << " | "
+            << std::setw(19) << std::setprecision(3) << MeasureExclusiveThroughput<RWSpinLock>(numThreads) << std::endl;
+    }
+}
+
+TEST(Lock, SharedThroughput)
+{
+    const uint32 writeRatio = 16;
+
+    std::cout << "Threads | RWLock [Mops/s] | RWSpinLock [Mops/s]   (1/" << writeRatio << " exclusive)" << std::endl;
+
+    for (uint32 numThreads = MinThreads; numThreads <= MaxThreads; numThreads *= 2)
+    {
+        std::cout << std::setw(7) << numThreads << " | "
+            << std::setw(15) << std::setprecision(3) << MeasureSharedThroughput<RWLock>(numThreads, writeRatio) << " | "
+            << std::setw(19) << std::setprecision(3) << MeasureSharedThroughput<RWSpinLock>(numThreads, writeRatio) << std::endl;
+    }
+}
+
+TEST(Lock, Contention)
+{
+    std::cout << "Threads | SpinLock contention | HybridLock contention | HybridLock wait time [ms]" << std::endl;
+
+    for (uint32 numThreads = MinThreads; numThreads <= MaxThreads; numThreads *= 4)
+    {
+        ContentionCountingLock<SpinLock> spinLock;
+        ContentionCountingLock<HybridLock> hybridLock;
+
+        const auto func = [&]()
+        {
+            for (uint32 i = 0; i < NumOperations / MaxThreads; ++i)
+            {
+                {
+                    NFE_SCOPED_LOCK(spinLock);
+                }
+                {
+                    NFE_SCOPED_LOCK(hybridLock);
+                }
+            }
+        };
+
+        {
+            DynArray<Thread> threads(numThreads);
+            for (uint32 i = 0; i < numThreads; ++i)
+            {
+                threads[i].Run(func);
+            }
+        }
+
+        const LockContentionStats spinLockStats = spinLock.GetStats();
+        const LockContentionStats hybridLockStats = hybridLock.GetStats();
+
+        std::cout << std::setw(7) << numThreads << " | "
+            << std::setw(18) << std::setprecision(3) << 100.0 * spinLockStats.GetContentionRatio() << "% | "
+            << std::setw(20) << std::setprecision(3) << 100.0 * hybridLockStats.GetContentionRatio() << "% | "
+            << std::setw(25) << std::setprecision(3) << 1000.0 * hybridLockStats.totalWaitTime << std::endl;
+    }
+}
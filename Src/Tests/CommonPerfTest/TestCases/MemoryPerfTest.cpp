@@ -0,0 +1,112 @@
+/**
+ * @file
+ * @author Witek902 (witek902@gmail.com)
+ * @brief  Performance tests for the default memory allocator
+ */
+
+#include "PCH.hpp"
+
+#include "Engine/Common/nfCommon.hpp"
+#include "Engine/Common/Memory/DefaultAllocator.hpp"
+#include "Engine/Common/System/Timer.hpp"
+#include "Engine/Common/Math/Math.hpp"
+
+#include <thread>
+
+
+using namespace NFE;
+using namespace NFE::Common;
+
+namespace {
+
+const uint32 NumOperations = 4000000;
+const uint32 WindowSize = 256;
+
+// Allocate and free small blocks of mixed sizes, each thread keeps a window of live blocks
+// (so the blocks are not immediately reused), simulating events, shared pointer blocks, components, etc.
+template<typename AllocFunc, typename FreeFunc>
+void MixedSizeAllocations(uint32 numOperations, const AllocFunc& allocFunc, const FreeFunc& freeFunc)
+{
+    void* blocks[WindowSize] = { nullptr };
+
+    for (uint32 i = 0; i < numOperations; ++i)
+    {
+        const uint32 slot = i % WindowSize;
+        freeFunc(blocks[slot]);
+        blocks[slot] = allocFunc(16 + (i * 7919u) % 1024u);
+    }
+
+    for (void* ptr : blocks)
+    {
+        freeFunc(ptr);
+    }
+}
+
+template<typename AllocFunc, typename FreeFunc>
+void AllocatorPerfTest(const char* name, const AllocFunc& allocFunc, const FreeFunc& freeFunc)
+{
+    std::cout << std::left << std::setw(20) << name;
+
+    const uint32 maxThreads = Math::Max(1u, std::thread::hardware_concurrency());
+    for (uint32 numThreads = 1; numThreads <= 16; numThreads *= 2)
+    {
+        if (numThreads > maxThreads)
+        {
+            std::cout << std::left << std::setw(10) << "-";
+            continue;
+        }
+
+        // the same total number of operations is split between the threads
+        Timer timer;
+        timer.Start();
+        {
+            std::vector<std::thread> threads;
+            for (uint32 i = 0; i < numThreads; ++i)
+            {
+                threads.emplace_back([numThreads, &allocFunc, &freeFunc] ()
+                {
+                    MixedSizeAllocations(NumOperations / numThreads, allocFunc, freeFunc);
+                });
+            }
+            for (std::thread& thread : threads)
+            {
+                thread.join();
+            }
+        }
+        const double t = timer.Stop();
+        std::cout << std::setprecision(3) << std::left << std::setw(10) << (1000.0 * t);
+    }
+
+    std::cout << std::endl;
+}
+
+} // namespace
+
+
+TEST(Memory, MultithreadedAllocations)
+{
+    std::cout
+        << "Number of allocations: " << NumOperations << std::endl
+        << "Total time [ms] for given number of threads:" << std::endl
+        << "-------------------------------------------------------------------" << std::endl
+        << "                    1         2         4         8         16" << std::endl
+        << "-------------------------------------------------------------------" << std::endl;
+
+    AllocatorPerfTest("NFE_MALLOC", [] (size_t size)
+    {
+        return NFE_MALLOC(size, 16);
+    },
+    [] (void* ptr)
+    {
+        NFE_FREE(ptr);
+    });
+
+    AllocatorPerfTest("malloc", [] (size_t size)
+    {
+        return malloc(size);
+    },
+    [] (void* ptr)
+    {
+        free(ptr);
+    });
+}
@@ -0,0 +1,182 @@
+/**
+ * @file
+ * @author Witek902 (witek902@gmail.com)
+ * @brief  Performance tests for concurrent queues.
+ */
+
+#include "PCH.hpp"
+#include "Engine/Common/Containers/SPSCQueue.hpp"
+#include "Engine/Common/Containers/MPMCQueue.hpp"
+#include "Engine/Common/Containers/MPSCQueue.hpp"
+#include "Engine/Common/Containers/Deque.hpp"
+#include "Engine/Common/Containers/DynArray.hpp"
+#include "Engine/Common/System/Mutex.hpp"
+#include "Engine/Common/System/Thread.hpp"
+#include "Engine/Common/System/Timer.hpp"
+#include "Engine/Common/Utils/ScopedLock.hpp"
+
+using namespace NFE;
+using namespace NFE::Common;
+
+namespace {
+
+// total number of elements passed through a queue
+const uint32 NumOperations = 1000000;
+const uint32 QueueCapacity = 1024;
+
+// baseline: mutex-protected deque
+class LockedQueue
+{
+public:
+    LockedQueue(uint32 capacity)
+        : mCapacity(capacity)
+    { }
+
+    bool Push(uint32 value)
+    {
+        NFE_SCOPED_LOCK(mLock);
+        return mDeque.Size() < mCapacity && mDeque.PushBack(value);
+    }
+
+    bool Pop(uint32& outValue)
+    {
+        NFE_SCOPED_LOCK(mLock);
+        if (mDeque.Empty())
+        {
+            return false;
+        }
+
+        outValue = mDeque.Front();
+        return mDeque.PopFront();
+    }
+
+private:
+    Mutex mLock;
+    Deque<uint32> mDeque;
+    uint32 mCapacity;
+};
+
+// measure throughput (in millions of elements per second)
+template<typename QueueType>
+double MeasureThroughput(QueueType& queue, uint32 numProducers, uint32 numConsumers)
+{
+    std::atomic<bool> start(false);
+    std::atomic<uint32> poppedNum(0);
+    std::atomic<uint64> sum(0);
+
+    const uint32 numOperationsPerProducer = NumOperations / numProducers;
+    const uint32 numElements = numOperationsPerProducer * numProducers;
+
+    const auto producerFunc = [&]()
+    {
+        while (!start)
+        {
+            Thread::YieldCurrentThread();
+        }
+
+        for (uint32 i = 0; i < numOperationsPerProducer; ++i)
+        {
+            while (!queue.Push(i))
+            {
+                Thread::YieldCurrentThread();
+            }
+        }
+    };
+
+    const auto consumerFunc = [&]()
+    {
+        while (!start)
+        {
+            Thread::YieldCurrentThread();
+        }
+
+        uint64 localSum = 0;
+        while (poppedNum.load(std::memory_order_relaxed) < numElements)
+        {
+            uint32 value;
+            if (queue.Pop(value))
+            {
+                localSum += value;
+                poppedNum.fetch_add(1, std::memory_order_relaxed);
+            }
+            else
+            {
+                Thread::YieldCurrentThread();
+            }
+        }
+
+        sum += localSum;
+    };
+
+    DynArray<Thread> threads(numProducers + numConsumers);
+    for (uint32 i = 0; i < numProducers; ++i)
+    {
+        threads[i].Run(producerFunc);
+    }
+    for (uint32 i = 0; i < numConsumers; ++i)
+    {
+        threads[numProducers + i].Run(consumerFunc);
+    }
+
+    Timer timer;
+    timer.Start();
+    start = true;
+    threads.Clear(); // joins the threads
+    const double time = timer.Stop();
+
+    EXPECT_EQ(static_cast<uint64>(numProducers) * numOperationsPerProducer * (numOperationsPerProducer - 1) / 2, sum.load());
+
+    return 1.0e-6 * static_cast<double>(numElements) / time;
+}
+
+template<typename QueueType>
+double MeasureBoundedQueue(uint32 numProducers, uint32 numConsumers)
+{
+    QueueType queue(QueueCapacity);
+    return MeasureThroughput(queue, numProducers, numConsumers);
+}
+
+double MeasureUnboundedQueue(uint32 numProducers)
+{
+    MPSCQueue<uint32> queue;
+    return MeasureThroughput(queue, numProducers, 1);
+}
+
+} // namespace
+
+
+TEST(Queue, SingleProducerSingleConsumer)
+{
+    std::cout << "Mutex+Deque [Mops/s] | SPSCQueue [Mops/s] | MPMCQueue [Mops/s] | MPSCQueue [Mops/s]" << std::endl;
+
+    std::cout
+        << std::setw(20) << std::setprecision(3) << MeasureBoundedQueue<LockedQueue>(1, 1) << " | "
+        << std::setw(18) << std::setprecision(3) << MeasureBoundedQueue<SPSCQueue<uint32>>(1, 1) << " | "
+        << std::setw(18) << std::setprecision(3) << MeasureBoundedQueue<MPMCQueue<uint32>>(1, 1) << " | "
+        << std::setw(18) << std::setprecision(3) << MeasureUnboundedQueue(1) << std::endl;
+}
+
+TEST(Queue, MultipleProducersSingleConsumer)
+{
+    std::cout << "Producers | Mutex+Deque [Mops/s] | MPMCQueue [Mops/s] | MPSCQueue [Mops/s]" << std::endl;
+
+    for (uint32 numProducers = 2; numProducers <= 16; numProducers *= 2)
+    {
+        std::cout << std::setw(9) << numProducers << " | "
+            << std::setw(20) << std::setprecision(3) << MeasureBoundedQueue<LockedQueue>(numProducers, 1) << " | "
+            << std::setw(18) << std::setprecision(3) << MeasureBoundedQueue<MPMCQueue<uint32>>(numProducers, 1) << " | "
+            << std::setw(18) << std::setprecision(3) << MeasureUnboundedQueue(numProducers) << std::endl;
+    }
+}
+
+TEST(Queue, MultipleProducersMultipleConsumers)
+{
+    std::cout << "Threads | Mutex+Deque [Mops/s] | MPMCQueue [Mops/s]   (the same number of producers and consumers)" << std::endl;
+
+    for (uint32 numThreads = 2; numThreads <= 16; numThreads *= 2)
+    {
+        std::cout << std::setw(7) << numThreads << " | "
+            << std::setw(20) << std::setprecision(3) << MeasureBoundedQueue<LockedQueue>(numThreads, numThreads) << " | "
+            << std::setw(18) << std::setprecision(3) << MeasureBoundedQueue<MPMCQueue<uint32>>(numThreads, numThreads) << std::endl;
+    }
+}
@@ -1,13 +1,15 @@
 /**
  * @file
  * @author Witek902 (witek902@gmail.com)
- * @brief  Performance tests for Set
+ * @brief  Performance tests for Set, BTreeSet and FlatSet
  */
 
 #include "PCH.hpp"
 
 #include "Engine/Common/nfCommon.hpp"
 #include "Engine/Common/Containers/Set.hpp"
+#include "Engine/Common/Containers/BTreeSet.hpp"
+#include "Engine/Common/Containers/FlatSet.hpp"
 #include "Engine/Common/System/Timer.hpp"
 #include "Engine/Common/Math/Random.hpp"
 
@@ -16,10 +18,135 @@ using namespace NFE;
 using namespace NFE::Common;
 using namespace NFE::Math;
 
-TEST(Set, Basic)
+namespace {
+
+volatile int gVolatileTempValue = 0;
+
+template<typename SetType>
+void FillSet(SetType& set, const std::vector<int>& values, int numValues)
+{
+    for (int i = 0; i < numValues; ++i)
+    {
+        set.Insert(values[i]);
+    }
+}
+
+// inserting unsorted keys one by one to a flat set takes O(n^2) time, so build it at once
+void FillSet(FlatSet<int>& set, const std::vector<int>& values, int numValues)
+{
+    set.Build(DynArray<int>(values.data(), static_cast<uint32>(numValues)));
+}
+
+template<typename SetType>
+void NfeSetPerfTest(int numValues, const std::vector<int>& values)
+{
+    Timer timer;
+    SetType set;
+
+    // insert keys
+    {
+        timer.Start();
+        FillSet(set, values, numValues);
+        double t = timer.Stop();
+        std::cout << std::setprecision(5) << std::left << std::setw(12) << 1000.0 * t;
+    }
+
+    // find keys
+    {
+        timer.Start();
+        for (int i = 0; i < numValues; ++i)
+        {
+            auto iter = set.Find(values[i]);
+            ASSERT_EQ(values[i], *iter);
+        }
+        double t = timer.Stop();
+        std::cout << std::setprecision(5) << std::left << std::setw(12) << 1000.0 * t;
+    }
+
+    // iterate the whole set
+    {
+        timer.Start();
+        int sum = 0;
+        for (int val : set)
+        {
+            sum += val;
+        }
+        gVolatileTempValue = sum; // force the compiler to not optimize the loop out
+        double t = timer.Stop();
+        std::cout << std::setprecision(5) << std::left << std::setw(12) << 1000.0 * t;
+    }
+
+    // erase some keys
+    {
+        const int numValuesToErase = std::min(numValues / 10, 1000);
+        timer.Start();
+        for (int i = 0; i < numValuesToErase; ++i)
+        {
+            set.Erase(values[i]);
+        }
+        double t = timer.Stop();
+        std::cout << std::setprecision(5) << std::left << std::setw(12) << 1000.0 * t;
+    }
+}
+
+void StlSetPerfTest(int numValues, const std::vector<int>& values)
 {
     Timer timer;
+    std::set<int> set;
+
+    // insert keys
+    {
+        timer.Start();
+        for (int i = 0; i < numValues; ++i)
+        {
+            set.insert(values[i]);
+        }
+        double t = timer.Stop();
+        std::cout << std::setprecision(5) << std::left << std::setw(12) << 1000.0 * t;
+    }
 
+    // find keys
+    {
+        timer.Start();
+        for (int i = 0; i < numValues; ++i)
+        {
+            auto iter = set.find(values[i]);
+            ASSERT_EQ(values[i], *iter);
+        }
+        double t = timer.Stop();
+        std::cout << std::setprecision(5) << std::left << std::setw(12) << 1000.0 * t;
+    }
+
+    // iterate the whole set
+    {
+        timer.Start();
+        int sum = 0;
+        for (int val : set)
+        {
+            sum += val;
+        }
+        gVolatileTempValue = sum; // force the compiler to not optimize the loop out
+        double t = timer.Stop();
+        std::cout << std::setprecision(5) << std::left << std::setw(12) << 1000.0 * t;
+    }
+
+    // erase some keys
+    {
+        const int numValuesToErase = std::min(numValues / 10, 1000);
+        timer.Start();
+        for (int i = 0; i < numValuesToErase; ++i)
+        {
+            set.erase(values[i]);
+        }
+        double t = timer.Stop();
+        std::cout << std::setprecision(5) << std::left << std::setw(12) << 1000.0 * t;
+    }
+}
+
+} // namespace
+
+TEST(Set, Basic)
+{
     // prepare random data
     const int MAX_NUM_VALUES = 2 * 1024 * 1024;
     std::vector<int> values;
@@ -31,61 +158,31 @@ TEST(Set, Basic)
     Math::Random random;
     random.ShuffleContainer(values.begin(), values.end(), MAX_NUM_VALUES);
 
+    std::cout
+        << "1 - inserting (FlatSet: building from unsorted array) [ms]" << std::endl
+        << "2 - finding [ms]" << std::endl
+        << "3 - iterating [ms]" << std::endl
+        << "4 - erasing (up to 1000 keys) [ms]" << std::endl;
 
-    std::cout << "Values  | Insert (NFE) | Find (NFE)   | Insert (std) | Find (std) " << std::endl;
-    for (int numValues = 16; numValues <= MAX_NUM_VALUES; numValues *= 2)
+    const auto runTest = [&](const char* name, void(*testFunc)(int, const std::vector<int>&))
     {
-        std::cout << std::left << std::setw(10) << numValues;
-
-        // NFE::Common::Set
+        std::cout
+            << "-------------------------------------------------------" << std::endl
+            << name << std::endl
+            << "-------------------------------------------------------" << std::endl
+            << "Values  | 1         | 2         | 3         | 4" << std::endl
+            << "-------------------------------------------------------" << std::endl;
+
+        for (int numValues = 16; numValues <= MAX_NUM_VALUES; numValues *= 4)
         {
-            Set<int> set;
-
-            // insert leaves
-            timer.Start();
-            for (int i = 0; i < numValues; ++i)
-            {
-                set.Insert(values[i]);
-            }
-            double insertTime = timer.Stop();
-            std::cout << std::setprecision(5) << std::left << std::setw(15) << 1000.0 * insertTime;
-
-            // find leaves
-            timer.Start();
-            for (int i = 0; i < numValues; ++i)
-            {
-                auto iter = set.Find(values[i]);
-                ASSERT_EQ(values[i], *iter);
-            }
-            double findTime = timer.Stop();
-            std::cout << std::setprecision(5) << std::left << std::setw(15) << 1000.0 * findTime;
+            std::cout << std::left << std::setw(10) << numValues;
+            testFunc(numValues, values);
+            std::cout << std::endl;
         }
+    };
 
-        // std::set
-        {
-            std::set<int> set;
-
-            // insert leaves
-            timer.Start();
-            for (int i = 0; i < numValues; ++i)
-            {
-                set.insert(values[i]);
-            }
-            double insertTime = timer.Stop();
-            std::cout << std::setprecision(5) << std::left << std::setw(15) << 1000.0 * insertTime;
-
-            // find leaves
-            timer.Start();
-            for (int i = 0; i < numValues; ++i)
-            {
-                auto iter = set.find(values[i]);
-                ASSERT_EQ(values[i], *iter);
-            }
-            double findTime = timer.Stop();
-            std::cout << std::setprecision(5) << std::left << std::setw(15) << 1000.0 * findTime;
-        }
-
-        // tree stats
-        std::cout << std::endl;
-    }
-}
\ No newline at end of file
+    runTest("NFE::Common::Set", NfeSetPerfTest<Set<int>>);
+    runTest("NFE::Common::BTreeSet", NfeSetPerfTest<BTreeSet<int>>);
+    runTest("NFE::Common::FlatSet", NfeSetPerfTest<FlatSet<int>>);
+    runTest("std::set", StlSetPerfTest);
+}
@@ -0,0 +1,158 @@
+/**
+ * @file
+ * @author Witek902 (witek902@gmail.com)
+ * @brief  Performance tests for SharedPtr and WeakPtr
+ */
+
+#include "PCH.hpp"
+
+#include "Engine/Common/nfCommon.hpp"
+#include "Engine/Common/Containers/SharedPtr.hpp"
+#include "Engine/Common/Containers/WeakPtr.hpp"
+#include "Engine/Common/System/Timer.hpp"
+
+#include <memory>
+
+
+using namespace NFE;
+using namespace NFE::Common;
+
+namespace {
+
+const uint32 NumObjects = 1000000;
+
+volatile int gVolatileTempValue = 0;
+
+struct TestObject
+{
+    int value[4];
+
+    TestObject(int x) : value{ x, x, x, x } { }
+};
+
+NFE_FORCE_INLINE TestObject* NewRawObject(int x)
+{
+    void* memory = NFE_MALLOC(sizeof(TestObject), alignof(TestObject));
+    return new (memory) TestObject(x);
+}
+
+template<typename PtrType, typename CreateFunc>
+void SharedPtrPerfTest(const char* name, const CreateFunc& createFunc)
+{
+    Timer timer;
+    std::vector<PtrType> pointers;
+    pointers.reserve(NumObjects);
+
+    std::cout << std::left << std::setw(28) << name;
+
+    // create objects
+    {
+        timer.Start();
+        for (uint32 i = 0; i < NumObjects; ++i)
+        {
+            pointers.push_back(createFunc(static_cast<int>(i)));
+        }
+        double t = timer.Stop();
+        std::cout << std::setprecision(3) << std::left << std::setw(10) << (1000.0 * t);
+    }
+
+    // access objects
+    {
+        timer.Start();
+        int sum = 0;
+        for (const PtrType& ptr : pointers)
+        {
+            sum += ptr->value[0];
+        }
+        gVolatileTempValue = sum;
+        double t = timer.Stop();
+        std::cout << std::setprecision(3) << std::left << std::setw(10) << (1000.0 * t);
+    }
+
+    // copy and release pointers (reference counting only)
+    {
+        timer.Start();
+        for (const PtrType& ptr : pointers)
+        {
+            PtrType copy(ptr);
+            gVolatileTempValue = copy->value[1];
+        }
+        double t = timer.Stop();
+        std::cout << std::setprecision(3) << std::left << std::setw(10) << (1000.0 * t);
+    }
+
+    // release objects
+    {
+        timer.Start();
+        pointers.clear();
+        double t = timer.Stop();
+        std::cout << std::setprecision(3) << std::left << std::setw(10) << (1000.0 * t);
+    }
+
+    std::cout << std::endl;
+}
+
+} // namespace
+
+
+TEST(SharedPtr, CreateAndRelease)
+{
+    std::cout
+        << "Number of objects: " << NumObjects << std::endl
+        << "1 - creating [ms]" << std::endl
+        << "2 - accessing [ms]" << std::endl
+        << "3 - copying and releasing copy [ms]" << std::endl
+        << "4 - releasing [ms]" << std::endl
+        << "-------------------------------------------------------------------" << std::endl
+        << "                            1         2         3         4" << std::endl
+        << "-------------------------------------------------------------------" << std::endl;
+
+    SharedPtrPerfTest<SharedPtr<TestObject>>("MakeSharedPtr", [] (int x)
+    {
+        return MakeSharedPtr<TestObject>(x);
+    });
+
+    SharedPtrPerfTest<SharedPtr<TestObject>>("SharedPtr from raw pointer", [] (int x)
+    {
+        return SharedPtr<TestObject>(NewRawObject(x));
+    });
+
+    SharedPtrPerfTest<std::shared_ptr<TestObject>>("std::make_shared", [] (int x)
+    {
+        return std::make_shared<TestObject>(x);
+    });
+}
+
+TEST(SharedPtr, WeakPtrLock)
+{
+    const uint32 numIterations = 10000000;
+    Timer timer;
+
+    {
+        SharedPtr<TestObject> sharedPtr = MakeSharedPtr<TestObject>(1);
+        WeakPtr<TestObject> weakPtr(sharedPtr);
+
+        timer.Start();
+        for (uint32 i = 0; i < numIterations; ++i)
+        {
+            SharedPtr<TestObject> locked = weakPtr.Lock();
+            gVolatileTempValue = locked->value[0];
+        }
+        double t = timer.Stop();
+        std::cout << std::left << std::setw(28) << "WeakPtr::Lock" << std::setprecision(3) << (1000.0 * t) << " ms" << std::endl;
+    }
+
+    {
+        std::shared_ptr<TestObject> sharedPtr = std::make_shared<TestObject>(1);
+        std::weak_ptr<TestObject> weakPtr(sharedPtr);
+
+        timer.Start();
+        for (uint32 i = 0; i < numIterations; ++i)
+        {
+            std::shared_ptr<TestObject> locked = weakPtr.lock();
+            gVolatileTempValue = locked->value[0];
+        }
+        double t = timer.Stop();
+        std::cout << std::left << std::setw(28) << "std::weak_ptr::lock" << std::setprecision(3) << (1000.0 * t) << " ms" << std::endl;
+    }
+}
@@ -10,6 +10,8 @@
 #include "Engine/Common/Utils/Waitable.hpp"
 #include "Engine/Common/Utils/Latch.hpp"
 #include "Engine/Common/System/Timer.hpp"
+#include "Engine/Common/System/Thread.hpp"
+#include "Engine/Common/Math/Math.hpp"
 
 using namespace NFE;
 using namespace NFE::Common;
@@ -22,7 +24,7 @@ TEST(ThreadPool, SpawnTasks)
 
     ThreadPool& tp = ThreadPool::GetInstance();
 
-    for (uint32 numTasks = 2; numTasks < ThreadPool::TasksCapacity - 2; numTasks *= 2)
+    for (uint32 numTasks = 2; numTasks <= 1024 * 1024; numTasks *= 2)
     {
         Waitable waitable;
 
@@ -130,3 +132,224 @@ TEST(ThreadPool, ParallelFor)
     NFE_LOG_INFO("Computed hash: %x", hash);
     NFE_LOG_INFO("Parallel for: %.3f ms", waitTime);
 }
+
+namespace {
+
+NFE_FORCE_NOINLINE uint32 SimulateWork(uint32 seed, uint32 numIterations)
+{
+    for (uint32 i = 0; i < numIterations; ++i)
+    {
+        seed = XorShift(seed);
+    }
+    return seed;
+}
+
+// many small tasks enqueued from the main thread
+double MeasureFlatTasks(ThreadPool& tp, uint32 numTasks, uint32 workPerTask)
+{
+    std::atomic<uint32> result = 0;
+
+    Timer timer;
+    timer.Start();
+
+    Waitable waitable;
+    {
+        TaskDesc rootDesc;
+        rootDesc.waitable = &waitable;
+        const TaskID rootTask = tp.CreateTask(rootDesc);
+
+        for (uint32 i = 0; i < numTasks; ++i)
+        {
+            TaskDesc desc;
+            desc.parent = rootTask;
+            desc.function = [&result, i, workPerTask] (const TaskContext&)
+            {
+                result ^= SimulateWork(i + 1, workPerTask);
+            };
+            tp.CreateAndDispatchTask(desc);
+        }
+
+        tp.DispatchTask(rootTask);
+    }
+    waitable.Wait();
+
+    return 1000.0 * timer.Stop();
+}
+
+// tasks recursively spawning sub-tasks from worker threads
+double MeasureNestedTasks(ThreadPool& tp, uint32 numTasksPerLevel, uint32 workPerTask)
+{
+    std::atomic<uint32> result = 0;
+
+    Timer timer;
+    timer.Start();
+
+    Waitable waitable;
+    {
+        TaskDesc rootDesc;
+        rootDesc.waitable = &waitable;
+        rootDesc.function = [&result, numTasksPerLevel, workPerTask] (const TaskContext& ctx)
+        {
+            for (uint32 i = 0; i < numTasksPerLevel; ++i)
+            {
+                TaskDesc desc;
+                desc.parent = ctx.taskId;
+                desc.function = [&result, i, numTasksPerLevel, workPerTask] (const TaskContext& ctx)
+                {
+                    for (uint32 j = 0; j < numTasksPerLevel; ++j)
+                    {
+                        TaskDesc desc;
+                        desc.parent = ctx.taskId;
+                        desc.function = [&result, i, j, workPerTask] (const TaskContext&)
+                        {
+                            result ^= SimulateWork(i * 1024 + j + 1, workPerTask);
+                        };
+                        ctx.pool->CreateAndDispatchTask(desc);
+                    }
+                };
+                ctx.pool->CreateAndDispatchTask(desc);
+            }
+        };
+        tp.CreateAndDispatchTask(rootDesc);
+    }
+    waitable.Wait();
+
+    return 1000.0 * timer.Stop();
+}
+
+} // namespace
+
+TEST(ThreadPool, Scaling)
+{
+    const uint32 maxThreads = Thread::GetSystemThreadsCount();
+    const uint32 numFlatTasks = 64 * 1024;
+    const uint32 numNestedTasksPerLevel = 256;
+    const uint32 workPerTask = 2000;
+
+    std::cout << "Workers | Flat tasks time | Speedup | Nested tasks time | Speedup" << std::endl;
+
+    double flatBaseTime = 0.0;
+    double nestedBaseTime = 0.0;
+
+    for (uint32 numThreads = 1; ; numThreads = Math::Min(2 * numThreads, maxThreads))
+    {
+        ThreadPool tp(numThreads);
+        ASSERT_EQ(numThreads, tp.GetNumWorkerThreads());
+
+        const double flatTime = MeasureFlatTasks(tp, numFlatTasks, workPerTask);
+        const double nestedTime = MeasureNestedTasks(tp, numNestedTasksPerLevel, workPerTask);
+
+        if (numThreads == 1)
+        {
+            flatBaseTime = flatTime;
+            nestedBaseTime = nestedTime;
+        }
+
+        std::cout << std::setprecision(4) << std::left
+                  << std::setw(7) << numThreads << " | "
+                  << std::setw(15) << flatTime << " | "
+                  << std::setw(7) << flatBaseTime / flatTime << " | "
+                  << std::setw(17) << nestedTime << " | "
+                  << nestedBaseTime / nestedTime << std::endl;
+
+        if (numThreads == maxThreads)
+        {
+            break;
+        }
+    }
+}
+
+namespace {
+
+const char* ScheduleToString(ParallelForSchedule schedule)
+{
+    switch (schedule)
+    {
+    case ParallelForSchedule::Static: return "Static";
+    case ParallelForSchedule::Dynamic: return "Dynamic";
+    case ParallelForSchedule::Guided: return "Guided";
+    }
+    return "";
+}
+
+const ParallelForSchedule gSchedules[] =
+{
+    ParallelForSchedule::Static,
+    ParallelForSchedule::Dynamic,
+    ParallelForSchedule::Guided,
+};
+
+} // namespace
+
+TEST(ThreadPool, ParallelForOverhead)
+{
+    const uint32 numCalls = 2000;
+    const uint32 arraySizes[] = { 1, 64, 4096 };
+
+    std::cout << "Schedule | Array size | Time per call (us)" << std::endl;
+
+    for (const ParallelForSchedule schedule : gSchedules)
+    {
+        for (const uint32 arraySize : arraySizes)
+        {
+            std::atomic<uint32> counter = 0;
+
+            Timer timer;
+            timer.Start();
+            for (uint32 i = 0; i < numCalls; ++i)
+            {
+                Waitable waitable;
+                {
+                    TaskBuilder taskBuilder(waitable);
+                    taskBuilder.ParallelFor("ParallelForOverhead", arraySize, [&counter] (const TaskContext&, uint32)
+                    {
+                        counter.fetch_add(1, std::memory_order_relaxed);
+                    }, ParallelForParams(schedule));
+                }
+                waitable.Wait();
+            }
+            const double timePerCall = 1.0e6 * timer.Stop() / numCalls;
+
+            ASSERT_EQ(numCalls * arraySize, counter.load());
+
+            std::cout << std::setprecision(4) << std::left
+                      << std::setw(8) << ScheduleToString(schedule) << " | "
+                      << std::setw(10) << arraySize << " | "
+                      << timePerCall << std::endl;
+        }
+    }
+}
+
+TEST(ThreadPool, ParallelForUnevenWork)
+{
+    // cost of an element grows with its index, like image tiles with a bright object in the bottom part
+    const uint32 numElements = 4096;
+
+    std::cout << "Schedule | Grain size | Time (ms)" << std::endl;
+
+    for (const ParallelForSchedule schedule : gSchedules)
+    {
+        for (const uint32 grainSize : { 1u, 16u })
+        {
+            std::atomic<uint32> result = 0;
+
+            Timer timer;
+            timer.Start();
+            Waitable waitable;
+            {
+                TaskBuilder taskBuilder(waitable);
+                taskBuilder.ParallelFor("ParallelForUnevenWork", numElements, [&result] (const TaskContext&, uint32 i)
+                {
+                    result ^= SimulateWork(i + 1, 10 * i);
+                }, ParallelForParams(schedule, grainSize));
+            }
+            waitable.Wait();
+            const double time = 1000.0 * timer.Stop();
+
+            std::cout << std::setprecision(4) << std::left
+                      << std::setw(8) << ScheduleToString(schedule) << " | "
+                      << std::setw(10) << grainSize << " | "
+                      << time << std::endl;
+        }
+    }
+}
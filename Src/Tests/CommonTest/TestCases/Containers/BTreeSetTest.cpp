@@ -0,0 +1,202 @@
+/**
+ * @file
+ * @author Witek902 (witek902@gmail.com)
+ * @brief  Unit tests for BTreeSet, FlatSet and maps based on them
+ */
+
+#include "PCH.hpp"
+#include "Engine/Common/Containers/BTreeSet.hpp"
+#include "Engine/Common/Containers/BTreeMap.hpp"
+#include "Engine/Common/Containers/FlatSet.hpp"
+#include "Engine/Common/Containers/FlatMap.hpp"
+#include "Engine/Common/Containers/String.hpp"
+#include "Engine/Common/Math/Random.hpp"
+
+#include <set>
+
+
+using namespace NFE;
+using namespace NFE::Common;
+
+namespace {
+
+// big key, so B-tree nodes are small and the tree is deep
+struct BigKey
+{
+    int value;
+    char padding[124];
+
+    BigKey(int value = 0) : value(value) { }
+    bool operator < (const BigKey& other) const { return value < other.value; }
+    bool operator == (const BigKey& other) const { return value == other.value; }
+};
+
+} // namespace
+
+
+TEST(BTreeSet, RandomCompareWithStl)
+{
+    static_assert(BTreeSet<BigKey>::MaxKeys == 3, "Test requires minimal B-tree nodes");
+
+    Math::Random random;
+
+    BTreeSet<BigKey> set;
+    std::set<int> referenceSet;
+
+    for (uint32 i = 0; i < 20000; ++i)
+    {
+        const int key = static_cast<int>(random.GetInt() % 2048);
+        if (random.GetInt() % 3 == 0)
+        {
+            const bool erased = set.Erase(BigKey(key));
+            ASSERT_EQ(referenceSet.erase(key) > 0, erased) << "i=" << i;
+        }
+        else
+        {
+            const bool inserted = set.Insert(BigKey(key)).iterator != set.End();
+            ASSERT_EQ(referenceSet.insert(key).second, inserted) << "i=" << i;
+        }
+
+        if (i % 1000 == 0)
+        {
+            ASSERT_TRUE(set.Verify());
+        }
+    }
+
+    ASSERT_EQ(static_cast<uint32>(referenceSet.size()), set.Size());
+    ASSERT_TRUE(set.Verify());
+
+    // iteration order must match
+    auto referenceIter = referenceSet.begin();
+    for (const BigKey& key : set)
+    {
+        ASSERT_NE(referenceSet.end(), referenceIter);
+        EXPECT_EQ(*referenceIter, key.value);
+        ++referenceIter;
+    }
+    EXPECT_EQ(referenceSet.end(), referenceIter);
+
+    // erase everything
+    for (const int key : referenceSet)
+    {
+        ASSERT_TRUE(set.Erase(BigKey(key)));
+    }
+    EXPECT_TRUE(set.Empty());
+    EXPECT_EQ(set.Begin(), set.End());
+    EXPECT_TRUE(set.Verify());
+}
+
+TEST(BTreeSet, EraseByIterator)
+{
+    BTreeSet<int> set;
+    for (int i = 0; i < 1000; ++i)
+    {
+        ASSERT_NE(set.End(), set.Insert(i).iterator);
+    }
+
+    // keys may move between nodes when erasing, so find the key again after each erasure
+    for (int i = 0; i < 1000; i += 2)
+    {
+        const auto iter = set.Find(i);
+        ASSERT_NE(set.End(), iter);
+        ASSERT_TRUE(set.Erase(iter));
+    }
+
+    EXPECT_EQ(500u, set.Size());
+    EXPECT_TRUE(set.Verify());
+
+    int expected = 1;
+    for (const int key : set)
+    {
+        EXPECT_EQ(expected, key);
+        expected += 2;
+    }
+}
+
+TEST(BTreeSet, Strings)
+{
+    BTreeSet<String> set;
+    for (uint32 i = 0; i < 1000; ++i)
+    {
+        ASSERT_NE(set.End(), set.Insert(String::Printf("key_%04u", i)).iterator);
+    }
+
+    BTreeSet<String> copy(set);
+    ASSERT_TRUE(copy.Verify());
+
+    for (uint32 i = 0; i < 1000; i += 3)
+    {
+        ASSERT_TRUE(set.Erase(String::Printf("key_%04u", i)));
+    }
+
+    EXPECT_TRUE(set.Verify());
+    EXPECT_EQ(1000u, copy.Size());
+    EXPECT_TRUE(copy.Exists(String("key_0000")));
+    EXPECT_FALSE(set.Exists(String("key_0000")));
+    EXPECT_EQ(String("key_0001"), *set.Begin());
+}
+
+TEST(FlatSet, Build)
+{
+    DynArray<int> keys = { 5, 3, 8, 3, 1, 5, 9 };
+
+    FlatSet<int> set;
+    set.Build(std::move(keys));
+
+    ASSERT_EQ(5u, set.Size());
+    EXPECT_TRUE(set.Verify());
+
+    const int expected[] = { 1, 3, 5, 8, 9 };
+    for (uint32 i = 0; i < 5; ++i)
+    {
+        EXPECT_EQ(expected[i], set.GetKeys()[i]);
+    }
+
+    EXPECT_TRUE(set.Exists(8));
+    EXPECT_FALSE(set.Exists(7));
+}
+
+template<typename T>
+class SortedMapTest : public ::testing::Test
+{
+};
+
+using SortedMapTestTypes = ::testing::Types<BTreeMap<int, String>, FlatMap<int, String>>;
+TYPED_TEST_SUITE(SortedMapTest, SortedMapTestTypes);
+
+TYPED_TEST(SortedMapTest, InsertFindErase)
+{
+    TypeParam map;
+
+    ASSERT_NE(map.End(), map.Insert(2, String("two")).iterator);
+    ASSERT_NE(map.End(), map.Insert(1, String("one")).iterator);
+    ASSERT_EQ(map.End(), map.Insert(1, String("uno")).iterator);
+    EXPECT_EQ(String("one"), map[1]);
+
+    {
+        const auto result = map.InsertOrReplace(1, String("uno"));
+        ASSERT_NE(map.End(), result.iterator);
+        EXPECT_TRUE(result.replaced);
+        EXPECT_EQ(String("uno"), map[1]);
+    }
+
+    EXPECT_TRUE(map.Exists(2));
+    EXPECT_FALSE(map.Exists(3));
+    EXPECT_EQ(2u, map.Size());
+
+    // sorted iteration
+    auto iter = map.Begin();
+    ASSERT_NE(map.End(), iter);
+    EXPECT_EQ(1, (*iter).first);
+    ++iter;
+    ASSERT_NE(map.End(), iter);
+    EXPECT_EQ(2, (*iter).first);
+    EXPECT_EQ(String("two"), (*iter).second);
+    ++iter;
+    EXPECT_EQ(map.End(), iter);
+
+    EXPECT_TRUE(map.Erase(2));
+    EXPECT_FALSE(map.Erase(2));
+    EXPECT_TRUE(map.Erase(1));
+    EXPECT_TRUE(map.Empty());
+}
@@ -0,0 +1,324 @@
+/**
+ * @file
+ * @author Witek902 (witek902@gmail.com)
+ * @brief  Unit tests for FlatHashSet and FlatHashMap
+ */
+
+#include "PCH.hpp"
+#include "Engine/Common/Containers/FlatHashSet.hpp"
+#include "Engine/Common/Containers/FlatHashMap.hpp"
+#include "Engine/Common/Containers/String.hpp"
+#include "Engine/Common/Containers/UniquePtr.hpp"
+#include "Engine/Common/Math/Random.hpp"
+
+#include <unordered_set>
+
+
+using namespace NFE;
+using namespace NFE::Common;
+
+namespace {
+
+// all the keys have the same hash, to exercise probing and tombstones
+struct CollidingHashPolicy
+{
+    uint32 operator() (const int&) const
+    {
+        return 0;
+    }
+};
+
+} // namespace
+
+
+TEST(FlatHashSet, Empty)
+{
+    FlatHashSet<int> set;
+
+    EXPECT_EQ(0u, set.Size());
+    EXPECT_TRUE(set.Empty());
+    EXPECT_EQ(set.Begin(), set.End());
+    EXPECT_EQ(set.End(), set.Find(0));
+    EXPECT_FALSE(set.Erase(0));
+    EXPECT_FALSE(set.Erase(set.End()));
+    EXPECT_TRUE(set.Verify());
+}
+
+TEST(FlatHashSet, InsertOrReplace)
+{
+    FlatHashSet<int> set;
+
+    {
+        const auto result = set.InsertOrReplace(1);
+        ASSERT_NE(set.End(), result.iterator);
+        EXPECT_FALSE(result.replaced);
+        EXPECT_EQ(1, *result.iterator);
+    }
+
+    {
+        const auto result = set.InsertOrReplace(1);
+        ASSERT_NE(set.End(), result.iterator);
+        EXPECT_TRUE(result.replaced);
+        EXPECT_EQ(1, *result.iterator);
+    }
+
+    EXPECT_EQ(1u, set.Size());
+}
+
+TEST(FlatHashSet, CopyAndMove)
+{
+    FlatHashSet<int> set;
+    for (int i = 0; i < 100; ++i)
+    {
+        ASSERT_NE(set.End(), set.Insert(i).iterator);
+    }
+
+    FlatHashSet<int> copy(set);
+    EXPECT_EQ(100u, copy.Size());
+    EXPECT_TRUE(copy.Verify());
+
+    FlatHashSet<int> assigned;
+    ASSERT_NE(assigned.End(), assigned.Insert(1000).iterator);
+    assigned = set;
+    EXPECT_EQ(100u, assigned.Size());
+    EXPECT_FALSE(assigned.Exists(1000));
+
+    FlatHashSet<int> moved(std::move(set));
+    EXPECT_EQ(100u, moved.Size());
+    EXPECT_TRUE(set.Empty());
+    EXPECT_EQ(set.Begin(), set.End());
+
+    set = std::move(moved);
+    EXPECT_EQ(100u, set.Size());
+    EXPECT_TRUE(moved.Empty());
+
+    for (int i = 0; i < 100; ++i)
+    {
+        EXPECT_TRUE(set.Exists(i));
+        EXPECT_TRUE(copy.Exists(i));
+        EXPECT_TRUE(assigned.Exists(i));
+    }
+}
+
+TEST(FlatHashSet, Reserve)
+{
+    FlatHashSet<int> set;
+    ASSERT_TRUE(set.Reserve(1000));
+
+    const uint32 capacity = set.GetCapacity();
+    EXPECT_GE(capacity * 7 / 8, 1000u);
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        ASSERT_NE(set.End(), set.Insert(i).iterator);
+    }
+
+    // no rehash should happen
+    EXPECT_EQ(capacity, set.GetCapacity());
+    EXPECT_EQ(1000u, set.Size());
+    EXPECT_TRUE(set.Verify());
+
+    set.Clear();
+    EXPECT_EQ(0u, set.GetCapacity());
+    EXPECT_TRUE(set.Verify());
+}
+
+TEST(FlatHashSet, CollidingKeys)
+{
+    const int numKeys = 500;
+
+    FlatHashSet<int, CollidingHashPolicy> set;
+    for (int i = 0; i < numKeys; ++i)
+    {
+        ASSERT_NE(set.End(), set.Insert(i).iterator);
+    }
+    ASSERT_TRUE(set.Verify());
+
+    // erase every other key, so tombstones are left in the full groups
+    for (int i = 0; i < numKeys; i += 2)
+    {
+        ASSERT_TRUE(set.Erase(i));
+    }
+    ASSERT_TRUE(set.Verify());
+
+    for (int i = 0; i < numKeys; ++i)
+    {
+        EXPECT_EQ(i % 2 != 0, set.Exists(i)) << "i=" << i;
+    }
+
+    // reinsert - tombstones should be reused
+    const uint32 capacity = set.GetCapacity();
+    for (int i = 0; i < numKeys; i += 2)
+    {
+        ASSERT_NE(set.End(), set.Insert(i).iterator);
+    }
+    EXPECT_EQ(capacity, set.GetCapacity());
+    EXPECT_EQ(static_cast<uint32>(numKeys), set.Size());
+    ASSERT_TRUE(set.Verify());
+}
+
+TEST(FlatHashSet, EraseAndInsertDoesNotGrow)
+{
+    FlatHashSet<int> set;
+    for (int i = 0; i < 100; ++i)
+    {
+        ASSERT_NE(set.End(), set.Insert(i).iterator);
+    }
+
+    const uint32 capacity = set.GetCapacity();
+
+    // constant number of keys with lots of churn - tombstones must be cleaned up by in-place rehash
+    for (int i = 100; i < 100000; ++i)
+    {
+        ASSERT_TRUE(set.Erase(i - 100));
+        ASSERT_NE(set.End(), set.Insert(i).iterator);
+    }
+
+    EXPECT_EQ(capacity, set.GetCapacity());
+    EXPECT_EQ(100u, set.Size());
+    EXPECT_TRUE(set.Verify());
+}
+
+TEST(FlatHashSet, IterateAndErase)
+{
+    FlatHashSet<int> set;
+    for (int i = 0; i < 1000; ++i)
+    {
+        ASSERT_NE(set.End(), set.Insert(i).iterator);
+    }
+
+    // erasing does not move the keys, so iteration can continue
+    uint32 numVisited = 0;
+    for (auto iter = set.Begin(); iter != set.End(); ++iter)
+    {
+        numVisited++;
+        if (*iter % 3 == 0)
+        {
+            ASSERT_TRUE(set.Erase(iter));
+        }
+    }
+
+    EXPECT_EQ(1000u, numVisited);
+    EXPECT_EQ(666u, set.Size());
+    EXPECT_TRUE(set.Verify());
+
+    for (const int key : set)
+    {
+        EXPECT_NE(0, key % 3);
+    }
+}
+
+TEST(FlatHashSet, Strings)
+{
+    FlatHashSet<String> set;
+
+    ASSERT_NE(set.End(), set.Insert(String("aaa")).iterator);
+    ASSERT_NE(set.End(), set.Insert(String("bbb")).iterator);
+    ASSERT_EQ(set.End(), set.Insert(String("aaa")).iterator);
+
+    for (uint32 i = 0; i < 1000; ++i)
+    {
+        ASSERT_NE(set.End(), set.Insert(String::Printf("key_%u", i)).iterator);
+    }
+
+    EXPECT_NE(set.End(), set.Find(String("aaa")));
+    EXPECT_NE(set.End(), set.Find(String("key_123")));
+    EXPECT_EQ(set.End(), set.Find(String("ccc")));
+    EXPECT_TRUE(set.Verify());
+
+    FlatHashSet<String> setCopy(set);
+    EXPECT_EQ(set.Size(), setCopy.Size());
+    EXPECT_TRUE(setCopy.Exists(String("key_999")));
+
+    ASSERT_TRUE(set.Erase(String("aaa")));
+    ASSERT_FALSE(set.Erase(String("aaa")));
+    EXPECT_TRUE(setCopy.Exists(String("aaa")));
+}
+
+TEST(FlatHashSet, UniquePtrs)
+{
+    using KeyType = UniquePtr<int>;
+    FlatHashSet<KeyType> set;
+
+    for (int i = 0; i < 100; ++i)
+    {
+        ASSERT_NE(set.End(), set.Insert(MakeUniquePtr<int>(i)).iterator);
+    }
+
+    int sum = 0;
+    for (const KeyType& key : set)
+    {
+        sum += *key;
+    }
+    EXPECT_EQ(99 * 100 / 2, sum);
+}
+
+TEST(FlatHashSet, RandomCompareWithStl)
+{
+    Math::Random random;
+
+    FlatHashSet<uint32> set;
+    std::unordered_set<uint32> referenceSet;
+
+    for (uint32 i = 0; i < 100000; ++i)
+    {
+        const uint32 key = random.GetInt() % 4096;
+        if (random.GetInt() % 3 == 0)
+        {
+            const bool erased = set.Erase(key);
+            ASSERT_EQ(referenceSet.erase(key) > 0, erased);
+        }
+        else
+        {
+            const bool inserted = set.Insert(key).iterator != set.End();
+            ASSERT_EQ(referenceSet.insert(key).second, inserted);
+        }
+    }
+
+    ASSERT_EQ(static_cast<uint32>(referenceSet.size()), set.Size());
+    ASSERT_TRUE(set.Verify());
+
+    for (const uint32 key : referenceSet)
+    {
+        EXPECT_TRUE(set.Exists(key));
+    }
+
+    uint32 numIterated = 0;
+    for (const uint32 key : set)
+    {
+        EXPECT_EQ(1u, referenceSet.count(key));
+        numIterated++;
+    }
+    EXPECT_EQ(set.Size(), numIterated);
+}
+
+TEST(FlatHashMap, InsertFindErase)
+{
+    FlatHashMap<int, String> map;
+
+    ASSERT_NE(map.End(), map.Insert(1, String("one")).iterator);
+    ASSERT_NE(map.End(), map.Insert(2, String("two")).iterator);
+    ASSERT_EQ(map.End(), map.Insert(1, String("uno")).iterator);
+    EXPECT_EQ(String("one"), map[1]);
+
+    {
+        const auto result = map.InsertOrReplace(1, String("uno"));
+        ASSERT_NE(map.End(), result.iterator);
+        EXPECT_TRUE(result.replaced);
+        EXPECT_EQ(String("uno"), map[1]);
+    }
+
+    EXPECT_TRUE(map.Exists(2));
+    EXPECT_FALSE(map.Exists(3));
+    EXPECT_EQ(2u, map.Size());
+
+    const auto iter = map.Find(2);
+    ASSERT_NE(map.End(), iter);
+    EXPECT_EQ(2, iter->first);
+    EXPECT_EQ(String("two"), iter->second);
+
+    EXPECT_TRUE(map.Erase(iter));
+    EXPECT_FALSE(map.Erase(2));
+    EXPECT_TRUE(map.Erase(1));
+    EXPECT_TRUE(map.Empty());
+}
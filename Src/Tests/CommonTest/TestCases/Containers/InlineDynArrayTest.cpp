@@ -0,0 +1,148 @@
+/**
+ * @file
+ * @author Witek902 (witek902@gmail.com)
+ * @brief  Unit tests for InlineDynArray
+ */
+
+#include "PCH.hpp"
+#include "Engine/Common/Containers/InlineDynArray.hpp"
+#include "Engine/Common/Containers/String.hpp"
+
+
+using namespace NFE;
+using namespace NFE::Common;
+
+namespace {
+
+// function taking a regular DynArray
+void FillArray(DynArray<int>& array, int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        ASSERT_NE(array.End(), array.PushBack(i));
+    }
+}
+
+} // namespace
+
+
+TEST(InlineDynArray, StaysInline)
+{
+    InlineDynArray<int, 16> array;
+    EXPECT_TRUE(array.IsInline());
+    EXPECT_EQ(16u, array.Capacity());
+
+    FillArray(array, 16);
+    EXPECT_TRUE(array.IsInline());
+    EXPECT_EQ(16u, array.Size());
+
+    for (int i = 0; i < 16; ++i)
+    {
+        EXPECT_EQ(i, array[i]);
+    }
+}
+
+TEST(InlineDynArray, SpillToHeap)
+{
+    InlineDynArray<int, 4> array;
+    FillArray(array, 100);
+
+    EXPECT_FALSE(array.IsInline());
+    ASSERT_EQ(100u, array.Size());
+    for (int i = 0; i < 100; ++i)
+    {
+        EXPECT_EQ(i, array[i]);
+    }
+
+    // after freeing the heap buffer the inline buffer is used again
+    array.Clear(true);
+    FillArray(array, 3);
+    EXPECT_TRUE(array.IsInline());
+    EXPECT_EQ(3u, array.Size());
+}
+
+TEST(InlineDynArray, CopyAndMove)
+{
+    InlineDynArray<String, 4> array;
+    array.PushBack(String("a"));
+    array.PushBack(String("this is a long string"));
+
+    InlineDynArray<String, 4> copy(array);
+    EXPECT_TRUE(copy.IsInline());
+    ASSERT_EQ(2u, copy.Size());
+    EXPECT_EQ(String("this is a long string"), copy[1]);
+
+    InlineDynArray<String, 4> moved(std::move(array));
+    EXPECT_TRUE(moved.IsInline());
+    ASSERT_EQ(2u, moved.Size());
+    EXPECT_EQ(String("a"), moved[0]);
+    EXPECT_EQ(0u, array.Size());
+
+    // move to regular DynArray (the inline buffer can't be taken over, elements are moved)
+    DynArray<String> regular(std::move(moved));
+    EXPECT_EQ(nullptr, regular.GetAllocator());
+    ASSERT_EQ(2u, regular.Size());
+    EXPECT_EQ(String("this is a long string"), regular[1]);
+    EXPECT_EQ(0u, moved.Size());
+
+    // move from regular DynArray (bigger than inline capacity)
+    for (uint32 i = 0; i < 10; ++i)
+    {
+        regular.PushBack(String::Printf("%u", i));
+    }
+    moved = std::move(regular);
+    EXPECT_FALSE(moved.IsInline());
+    ASSERT_EQ(12u, moved.Size());
+    EXPECT_EQ(String("9"), moved[11]);
+}
+
+TEST(InlineDynArray, MoveThroughBaseReference)
+{
+    DynArray<String> regular;
+    {
+        InlineDynArray<String, 4> array;
+        array.PushBack(String("a"));
+        array.PushBack(String("this is a long string"));
+        ASSERT_TRUE(array.IsInline());
+
+        DynArray<String>& ref = array;
+        DynArray<String> moved(std::move(ref));
+        EXPECT_EQ(nullptr, moved.GetAllocator());
+        EXPECT_NE(array.Data(), moved.Data());
+        EXPECT_EQ(0u, array.Size());
+        ASSERT_EQ(2u, moved.Size());
+        EXPECT_EQ(String("a"), moved[0]);
+
+        // spilled inline array still can't give its buffer away
+        for (uint32 i = 0; i < 10; ++i)
+        {
+            array.PushBack(String::Printf("%u", i));
+        }
+        ASSERT_FALSE(array.IsInline());
+
+        DynArray<String> movedSpilled(std::move(ref));
+        EXPECT_EQ(nullptr, movedSpilled.GetAllocator());
+        EXPECT_EQ(0u, array.Size());
+        ASSERT_EQ(10u, movedSpilled.Size());
+
+        regular = std::move(movedSpilled);
+    }
+
+    // the elements outlive the inline array
+    ASSERT_EQ(10u, regular.Size());
+    EXPECT_EQ(String("9"), regular[9]);
+}
+
+TEST(InlineDynArray, Swap)
+{
+    InlineDynArray<int, 8> a = { 1, 2, 3 };
+    DynArray<int> b = { 4, 5 };
+
+    a.Swap(b);
+
+    ASSERT_EQ(2u, a.Size());
+    ASSERT_EQ(3u, b.Size());
+    EXPECT_EQ(4, a[0]);
+    EXPECT_EQ(3, b[2]);
+    EXPECT_TRUE(a.IsInline());
+}
@@ -0,0 +1,153 @@
+/**
+ * @file
+ * @author Witek902
+ * @brief  Unit tests for MPMCQueue
+ */
+
+#include "PCH.hpp"
+#include "Engine/Common/Containers/MPMCQueue.hpp"
+
+#include "TestClasses.hpp"
+
+#include <thread>
+#include <vector>
+
+using namespace NFE;
+using namespace NFE::Common;
+
+
+TEST(MPMCQueue, Empty)
+{
+    MPMCQueue<uint32> queue(1);
+
+    uint32 value = 0;
+    EXPECT_EQ(2u, queue.GetCapacity());
+    EXPECT_EQ(0u, queue.Size());
+    EXPECT_TRUE(queue.Empty());
+    EXPECT_FALSE(queue.Pop(value));
+}
+
+TEST(MPMCQueue, PushPop)
+{
+    const uint32 capacity = 8;
+    MPMCQueue<uint32> queue(capacity);
+
+    // wrap around the ring buffer a few times
+    for (uint32 lap = 0; lap < 4; ++lap)
+    {
+        for (uint32 i = 0; i < capacity; ++i)
+        {
+            ASSERT_TRUE(queue.Push(lap * 100 + i));
+        }
+        EXPECT_FALSE(queue.Push(0u));
+        EXPECT_EQ(capacity, queue.Size());
+
+        for (uint32 i = 0; i < capacity; ++i)
+        {
+            uint32 value = 0;
+            ASSERT_TRUE(queue.Pop(value));
+            EXPECT_EQ(lap * 100 + i, value);
+        }
+        EXPECT_TRUE(queue.Empty());
+    }
+}
+
+TEST(MPMCQueue, ElementsLifetime)
+{
+    using ElementType = MoveOnlyTestClass<uint32>;
+    ClassMethodCallCounters counters;
+    {
+        MPMCQueue<ElementType> queue(4);
+        ASSERT_TRUE(queue.Emplace(&counters, 1u));
+        ASSERT_TRUE(queue.Emplace(&counters, 2u));
+        ASSERT_TRUE(queue.Push(ElementType(&counters, 3u)));
+
+        ElementType element(nullptr);
+        ASSERT_TRUE(queue.Pop(element));
+        EXPECT_EQ(ElementType(nullptr, 1u), element);
+    }
+
+    // remaining elements are destroyed with the queue
+    EXPECT_EQ(3, counters.destructor);
+}
+
+TEST(MPMCQueue, Stress)
+{
+    const uint32 numProducers = 4;
+    const uint32 numConsumers = 4;
+    const uint32 numElementsPerProducer = 200000;
+    const uint32 numElements = numProducers * numElementsPerProducer;
+
+    // element = producer index in the upper bits, sequence number in the lower bits
+    MPMCQueue<uint32> queue(256);
+    std::atomic<uint32> poppedNum(0);
+    std::atomic<uint32> errors(0);
+    std::vector<uint64> sums(numConsumers, 0);
+
+    std::vector<std::thread> threads;
+    for (uint32 i = 0; i < numProducers; ++i)
+    {
+        threads.emplace_back([&queue, i] ()
+        {
+            for (uint32 j = 0; j < numElementsPerProducer; ++j)
+            {
+                while (!queue.Push((i << 24) | j))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    for (uint32 i = 0; i < numConsumers; ++i)
+    {
+        threads.emplace_back([&, i] ()
+        {
+            // elements of a single producer are seen in order by every consumer
+            uint32 lastSequence[numProducers];
+            for (uint32& sequence : lastSequence)
+            {
+                sequence = UINT32_MAX;
+            }
+
+            while (poppedNum.load() < numElements)
+            {
+                uint32 value;
+                if (!queue.Pop(value))
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                poppedNum++;
+
+                const uint32 producer = value >> 24;
+                const uint32 sequence = value & 0xFFFFFF;
+                if (producer >= numProducers || (lastSequence[producer] != UINT32_MAX && sequence <= lastSequence[producer]))
+                {
+                    errors++;
+                    continue;
+                }
+
+                lastSequence[producer] = sequence;
+                sums[i] += sequence;
+            }
+        });
+    }
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    uint64 totalSum = 0;
+    for (uint64 sum : sums)
+    {
+        totalSum += sum;
+    }
+
+    EXPECT_EQ(0u, errors.load());
+    EXPECT_EQ(numElements, poppedNum.load());
+    EXPECT_EQ(static_cast<uint64>(numProducers) * numElementsPerProducer * (numElementsPerProducer - 1) / 2, totalSum);
+    EXPECT_TRUE(queue.Empty());
+}
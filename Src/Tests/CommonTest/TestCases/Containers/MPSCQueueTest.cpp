@@ -0,0 +1,124 @@
+/**
+ * @file
+ * @author Witek902
+ * @brief  Unit tests for MPSCQueue
+ */
+
+#include "PCH.hpp"
+#include "Engine/Common/Containers/MPSCQueue.hpp"
+
+#include "TestClasses.hpp"
+
+#include <thread>
+#include <vector>
+
+using namespace NFE;
+using namespace NFE::Common;
+
+
+TEST(MPSCQueue, Empty)
+{
+    MPSCQueue<uint32> queue;
+
+    uint32 value = 0;
+    EXPECT_TRUE(queue.Empty());
+    EXPECT_FALSE(queue.Pop(value));
+}
+
+TEST(MPSCQueue, PushPop)
+{
+    const uint32 numElements = 1000;
+    MPSCQueue<uint32> queue;
+
+    for (uint32 i = 0; i < numElements; ++i)
+    {
+        ASSERT_TRUE(queue.Push(i));
+    }
+    EXPECT_FALSE(queue.Empty());
+
+    for (uint32 i = 0; i < numElements; ++i)
+    {
+        uint32 value = 0;
+        ASSERT_TRUE(queue.Pop(value));
+        EXPECT_EQ(i, value);
+    }
+
+    uint32 value = 0;
+    EXPECT_TRUE(queue.Empty());
+    EXPECT_FALSE(queue.Pop(value));
+
+    // the queue is usable after being drained
+    ASSERT_TRUE(queue.Push(123u));
+    ASSERT_TRUE(queue.Pop(value));
+    EXPECT_EQ(123u, value);
+}
+
+TEST(MPSCQueue, ElementsLifetime)
+{
+    using ElementType = MoveOnlyTestClass<uint32>;
+    ClassMethodCallCounters counters;
+    {
+        MPSCQueue<ElementType> queue;
+        ASSERT_TRUE(queue.Emplace(&counters, 1u));
+        ASSERT_TRUE(queue.Emplace(&counters, 2u));
+        ASSERT_TRUE(queue.Push(ElementType(&counters, 3u)));
+
+        ElementType element(nullptr);
+        ASSERT_TRUE(queue.Pop(element));
+        EXPECT_EQ(ElementType(nullptr, 1u), element);
+    }
+
+    // remaining elements are destroyed with the queue
+    EXPECT_EQ(3, counters.destructor);
+}
+
+TEST(MPSCQueue, Stress)
+{
+    const uint32 numProducers = 4;
+    const uint32 numElementsPerProducer = 200000;
+    const uint32 numElements = numProducers * numElementsPerProducer;
+
+    // element = producer index in the upper bits, sequence number in the lower bits
+    MPSCQueue<uint32> queue;
+
+    std::vector<std::thread> producers;
+    for (uint32 i = 0; i < numProducers; ++i)
+    {
+        producers.emplace_back([&queue, i] ()
+        {
+            for (uint32 j = 0; j < numElementsPerProducer; ++j)
+            {
+                queue.Push((i << 24) | j);
+            }
+        });
+    }
+
+    // elements of every producer must arrive in order, without losses nor duplicates
+    uint32 expectedSequence[numProducers] = { 0 };
+    uint32 errors = 0;
+    for (uint32 poppedNum = 0; poppedNum < numElements; )
+    {
+        uint32 value;
+        if (!queue.Pop(value))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        poppedNum++;
+
+        const uint32 producer = value >> 24;
+        if (producer >= numProducers || (value & 0xFFFFFF) != expectedSequence[producer]++)
+        {
+            errors++;
+        }
+    }
+
+    for (std::thread& thread : producers)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(0u, errors);
+    EXPECT_TRUE(queue.Empty());
+}
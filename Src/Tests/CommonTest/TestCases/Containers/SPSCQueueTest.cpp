@@ -0,0 +1,111 @@
+/**
+ * @file
+ * @author Witek902
+ * @brief  Unit tests for SPSCQueue
+ */
+
+#include "PCH.hpp"
+#include "Engine/Common/Containers/SPSCQueue.hpp"
+
+#include "TestClasses.hpp"
+
+#include <thread>
+
+using namespace NFE;
+using namespace NFE::Common;
+
+
+TEST(SPSCQueue, Empty)
+{
+    SPSCQueue<uint32> queue(10);
+
+    uint32 value = 0;
+    EXPECT_EQ(16u, queue.GetCapacity());
+    EXPECT_EQ(0u, queue.Size());
+    EXPECT_TRUE(queue.Empty());
+    EXPECT_FALSE(queue.Pop(value));
+}
+
+TEST(SPSCQueue, PushPop)
+{
+    const uint32 capacity = 8;
+    SPSCQueue<uint32> queue(capacity);
+
+    // wrap around the ring buffer a few times
+    for (uint32 lap = 0; lap < 4; ++lap)
+    {
+        for (uint32 i = 0; i < capacity; ++i)
+        {
+            ASSERT_TRUE(queue.Push(lap * 100 + i));
+        }
+        EXPECT_FALSE(queue.Push(0u));
+        EXPECT_EQ(capacity, queue.Size());
+
+        for (uint32 i = 0; i < capacity; ++i)
+        {
+            uint32 value = 0;
+            ASSERT_TRUE(queue.Pop(value));
+            EXPECT_EQ(lap * 100 + i, value);
+        }
+        EXPECT_TRUE(queue.Empty());
+    }
+}
+
+TEST(SPSCQueue, ElementsLifetime)
+{
+    using ElementType = MoveOnlyTestClass<uint32>;
+    ClassMethodCallCounters counters;
+    {
+        SPSCQueue<ElementType> queue(4);
+        ASSERT_TRUE(queue.Emplace(&counters, 1u));
+        ASSERT_TRUE(queue.Emplace(&counters, 2u));
+        ASSERT_TRUE(queue.Push(ElementType(&counters, 3u)));
+        EXPECT_EQ(1, counters.moveConstructor);
+
+        ElementType element(nullptr);
+        ASSERT_TRUE(queue.Pop(element));
+        EXPECT_EQ(ElementType(nullptr, 1u), element);
+        EXPECT_EQ(1, counters.moveAssignment);
+    }
+
+    // remaining elements are destroyed with the queue
+    EXPECT_EQ(3, counters.destructor);
+}
+
+TEST(SPSCQueue, Stress)
+{
+    const uint32 numElements = 1000000;
+    SPSCQueue<uint32> queue(64);
+
+    std::thread producer([&queue, numElements] ()
+    {
+        for (uint32 i = 0; i < numElements; ++i)
+        {
+            while (!queue.Push(i))
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    // elements must arrive in order, without losses nor duplicates
+    uint32 expected = 0;
+    uint32 errors = 0;
+    while (expected < numElements)
+    {
+        uint32 value;
+        if (queue.Pop(value))
+        {
+            errors += value != expected;
+            expected++;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    producer.join();
+    EXPECT_EQ(0u, errors);
+    EXPECT_TRUE(queue.Empty());
+}
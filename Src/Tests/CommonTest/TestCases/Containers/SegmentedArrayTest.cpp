@@ -0,0 +1,253 @@
+/**
+ * @file
+ * @author Witek902
+ * @brief  Unit tests for SegmentedArray
+ */
+
+#include "PCH.hpp"
+#include "Engine/Common/Containers/SegmentedArray.hpp"
+
+#include "TestClasses.hpp"
+
+#include <thread>
+#include <vector>
+
+using namespace NFE;
+using namespace NFE::Common;
+
+namespace {
+
+// small segments, so the tests cross segment boundaries often
+const uint32 TestSegmentSize = 16;
+
+using TestArray = SegmentedArray<uint32, TestSegmentSize>;
+
+// allocator counting live memory blocks
+class CountingAllocator : public IAllocator
+{
+public:
+    uint32 numLiveBlocks = 0;
+
+    void* Malloc(size_t size, size_t alignment) override
+    {
+        numLiveBlocks++;
+        return NFE_MALLOC(size, alignment);
+    }
+
+    void Free(void* ptr) override
+    {
+        EXPECT_GT(numLiveBlocks, 0u);
+        numLiveBlocks--;
+        NFE_FREE(ptr);
+    }
+};
+
+} // namespace
+
+
+TEST(SegmentedArray, Empty)
+{
+    TestArray array;
+
+    EXPECT_EQ(0u, array.Size());
+    EXPECT_TRUE(array.Empty());
+    EXPECT_EQ(0u, array.GetCapacity());
+    EXPECT_FALSE(array.PopBack());
+    EXPECT_TRUE(array.Begin() == array.End());
+}
+
+TEST(SegmentedArray, PushBack)
+{
+    const uint32 numElements = 1000u;
+    TestArray array;
+
+    for (uint32 i = 0; i < numElements; ++i)
+    {
+        ASSERT_EQ(i, array.PushBack(i));
+        ASSERT_EQ(i + 1u, array.Size());
+        ASSERT_EQ(i, array.Back());
+        ASSERT_EQ(0u, array.Front());
+    }
+
+    EXPECT_GE(array.GetCapacity(), numElements);
+    EXPECT_LT(array.GetCapacity(), numElements + TestSegmentSize);
+
+    uint32 expected = 0;
+    for (uint32 value : array)
+    {
+        EXPECT_EQ(expected++, value);
+    }
+    EXPECT_EQ(numElements, expected);
+}
+
+TEST(SegmentedArray, StableAddresses)
+{
+    const uint32 numElements = 1000u;
+    TestArray array;
+    std::vector<const uint32*> pointers;
+
+    for (uint32 i = 0; i < numElements; ++i)
+    {
+        array.PushBack(i);
+        pointers.push_back(&array[i]);
+    }
+
+    // growing never moves the elements
+    for (uint32 i = 0; i < numElements; ++i)
+    {
+        ASSERT_EQ(pointers[i], &array[i]);
+        ASSERT_EQ(i, *pointers[i]);
+    }
+}
+
+TEST(SegmentedArray, PopBack_Resize)
+{
+    TestArray array;
+
+    ASSERT_TRUE(array.Resize(100));
+    EXPECT_EQ(100u, array.Size());
+    array[99] = 123u;
+
+    EXPECT_TRUE(array.PopBack());
+    EXPECT_EQ(99u, array.Size());
+
+    const uint32 capacity = array.GetCapacity();
+    ASSERT_TRUE(array.Resize(10));
+    EXPECT_EQ(10u, array.Size());
+    EXPECT_EQ(capacity, array.GetCapacity());
+
+    ASSERT_TRUE(array.Reserve(1000));
+    EXPECT_EQ(10u, array.Size());
+    EXPECT_GE(array.GetCapacity(), 1000u);
+
+    array.Clear();
+    EXPECT_TRUE(array.Empty());
+    EXPECT_GE(array.GetCapacity(), 1000u);
+
+    array.Clear(true);
+    EXPECT_EQ(0u, array.GetCapacity());
+}
+
+TEST(SegmentedArray, CopyAndMove)
+{
+    const uint32 numElements = 100u;
+    TestArray array;
+    for (uint32 i = 0; i < numElements; ++i)
+    {
+        array.PushBack(i);
+    }
+
+    TestArray copy(array);
+    ASSERT_EQ(numElements, copy.Size());
+    for (uint32 i = 0; i < numElements; ++i)
+    {
+        EXPECT_EQ(i, copy[i]);
+    }
+
+    const uint32* firstElement = &array[0];
+    TestArray moved(std::move(array));
+    EXPECT_EQ(0u, array.Size());
+    ASSERT_EQ(numElements, moved.Size());
+    EXPECT_EQ(firstElement, &moved[0]);
+
+    array = copy;
+    ASSERT_EQ(numElements, array.Size());
+    EXPECT_EQ(numElements - 1, array.Back());
+}
+
+TEST(SegmentedArray, ElementsLifetime)
+{
+    using ElementType = MoveOnlyTestClass<uint32>;
+    ClassMethodCallCounters counters;
+    {
+        SegmentedArray<ElementType, TestSegmentSize> array;
+        for (uint32 i = 0; i < 50; ++i)
+        {
+            array.EmplaceBack(&counters, i);
+        }
+        EXPECT_EQ(50, counters.constructor);
+        EXPECT_EQ(0, counters.moveConstructor);
+
+        array.PopBack();
+        EXPECT_EQ(1, counters.destructor);
+    }
+    EXPECT_EQ(50, counters.destructor);
+}
+
+TEST(SegmentedArray, Clear_ReleasesRetiredTables)
+{
+    CountingAllocator allocator;
+    {
+        TestArray array(&allocator);
+
+        // grow the segment table a few times
+        const uint32 numSegments = 100;
+        for (uint32 i = 0; i < numSegments * TestSegmentSize; ++i)
+        {
+            ASSERT_NE(TestArray::InvalidIndex, array.PushBack(i));
+        }
+
+        // only the segments and the current table are kept
+        array.Clear();
+        EXPECT_EQ(numSegments + 1, allocator.numLiveBlocks);
+        EXPECT_EQ(numSegments * TestSegmentSize, array.GetCapacity());
+
+        // the segments are reused
+        for (uint32 i = 0; i < numSegments * TestSegmentSize; ++i)
+        {
+            ASSERT_NE(TestArray::InvalidIndex, array.PushBack(i));
+        }
+        EXPECT_EQ(numSegments + 1, allocator.numLiveBlocks);
+
+        array.Clear(true);
+        EXPECT_EQ(0u, allocator.numLiveBlocks);
+    }
+    EXPECT_EQ(0u, allocator.numLiveBlocks);
+}
+
+TEST(SegmentedArray, ReserveRange_Multithreaded)
+{
+    const uint32 numThreads = 4;
+    const uint32 numRanges = 1000;
+    const uint32 rangeSize = 7;
+    TestArray array;
+
+    std::vector<std::thread> threads;
+    for (uint32 i = 0; i < numThreads; ++i)
+    {
+        threads.emplace_back([&array, i] ()
+        {
+            for (uint32 j = 0; j < numRanges; ++j)
+            {
+                // each thread fills its own ranges without locking
+                const uint32 first = array.ReserveRange(rangeSize);
+                ASSERT_NE(TestArray::InvalidIndex, first);
+                for (uint32 k = 0; k < rangeSize; ++k)
+                {
+                    array[first + k] = i;
+                }
+
+                ASSERT_NE(TestArray::InvalidIndex, array.EmplaceBackConcurrent(i));
+            }
+        });
+    }
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    ASSERT_EQ(numThreads * numRanges * (rangeSize + 1), array.Size());
+
+    std::vector<uint32> elementsPerThread(numThreads, 0);
+    for (uint32 value : array)
+    {
+        ASSERT_LT(value, numThreads);
+        elementsPerThread[value]++;
+    }
+
+    for (uint32 count : elementsPerThread)
+    {
+        EXPECT_EQ(numRanges * (rangeSize + 1), count);
+    }
+}
@@ -7,6 +7,8 @@
 #include "PCH.hpp"
 #include "Engine/Common/Containers/Set.hpp"
 #include "Engine/Common/Containers/HashSet.hpp"
+#include "Engine/Common/Containers/BTreeSet.hpp"
+#include "Engine/Common/Containers/FlatSet.hpp"
 #include "Engine/Common/Math/Random.hpp"
 
 #include "TestClasses.hpp"
@@ -20,7 +22,7 @@ class SetTest : public ::testing::Test
 };
 
 using SetKeyType = int;
-using SetTestTypes = ::testing::Types<Set<SetKeyType>, HashSet<SetKeyType>>;
+using SetTestTypes = ::testing::Types<Set<SetKeyType>, HashSet<SetKeyType>, BTreeSet<SetKeyType>, FlatSet<SetKeyType>>;
 TYPED_TEST_SUITE(SetTest, SetTestTypes);
 
 
@@ -500,3 +500,20 @@ TEST(SharedPtr, CastToBaseClass_Reference)
     }
     ASSERT_EQ(1, counter);
 }
+
+TEST(SharedPtr, MakeSharedPtr_OverAligned)
+{
+    struct alignas(64) AlignedType
+    {
+        int value;
+        AlignedType(int value) : value(value) { }
+    };
+
+    for (int i = 0; i < 16; ++i)
+    {
+        const auto ptr = MakeSharedPtr<AlignedType>(i);
+        ASSERT_TRUE(ptr);
+        EXPECT_EQ(0u, reinterpret_cast<size_t>(ptr.Get()) % 64);
+        EXPECT_EQ(i, ptr->value);
+    }
+}
@@ -0,0 +1,149 @@
+/**
+ * @file
+ * @author Witek902 (witek902@gmail.com)
+ * @brief  Unit tests for StringId.
+ */
+
+#include "PCH.hpp"
+#include "Engine/Common/Containers/StringId.hpp"
+#include "Engine/Common/Containers/String.hpp"
+#include "Engine/Common/Containers/HashSet.hpp"
+
+#include <thread>
+#include <vector>
+
+
+using namespace NFE;
+using namespace NFE::Common;
+
+namespace {
+
+// The intern table is global and never shrinks, so strings interned by previous runs of a test
+// (eg. with --gtest_repeat) or by other tests stay there. Generate a string that is not interned yet.
+String MakeUniqueString(const char* prefix)
+{
+    for (uint32 i = 0; ; ++i)
+    {
+        String str = String::Printf("%s.%u", prefix, i);
+        if (StringId::Find(str.ToView()).Empty())
+        {
+            return str;
+        }
+    }
+}
+
+} // namespace
+
+
+TEST(StringId, Empty)
+{
+    const StringId id;
+
+    EXPECT_TRUE(id.Empty());
+    EXPECT_EQ(0u, id.Length());
+    EXPECT_STREQ("", id.Str());
+    EXPECT_TRUE(id.ToView().Empty());
+    EXPECT_EQ(id, StringId(""));
+    EXPECT_EQ(id, StringId::Find(""));
+}
+
+TEST(StringId, Intern)
+{
+    const String strA = MakeUniqueString("StringIdTest.Intern.A");
+    const String strB = MakeUniqueString("StringIdTest.Intern.B");
+    const uint32 numStringsBefore = StringId::GetInternedStringsNum();
+
+    const StringId a(strA.Str());
+    const StringId b(strB.ToView());
+    const StringId a2(String(strA).ToView());
+
+    EXPECT_FALSE(a.Empty());
+    EXPECT_NE(a, b);
+    EXPECT_EQ(a, a2);
+    EXPECT_EQ(a.Str(), a2.Str());
+    EXPECT_STREQ(strA.Str(), a.Str());
+    EXPECT_EQ(strB.ToView(), b.ToView());
+    EXPECT_EQ(strA.Length(), a.Length());
+    EXPECT_EQ(numStringsBefore + 2, StringId::GetInternedStringsNum());
+
+    // interning the same string again does not add an entry
+    const StringId a3(strA.ToView());
+    EXPECT_EQ(a, a3);
+    EXPECT_EQ(numStringsBefore + 2, StringId::GetInternedStringsNum());
+
+    // the hash is the same as for string view
+    EXPECT_EQ(GetHash(strA.ToView()), GetHash(a));
+}
+
+TEST(StringId, Find)
+{
+    const String str = MakeUniqueString("StringIdTest.Find");
+    const String otherStr = MakeUniqueString("StringIdTest.Find.Other");
+    EXPECT_TRUE(StringId::Find(str.ToView()).Empty());
+
+    const StringId id(str.ToView());
+    EXPECT_EQ(id, StringId::Find(str.ToView()));
+    EXPECT_TRUE(StringId::Find(otherStr.ToView()).Empty());
+}
+
+TEST(StringId, ManyStrings)
+{
+    const uint32 numStrings = 10000;
+
+    // forces growing the table and allocating multiple chunks
+    std::vector<StringId> ids;
+    for (uint32 i = 0; i < numStrings; ++i)
+    {
+        ids.emplace_back(String::Printf("StringIdTest.ManyStrings.%u", i).ToView());
+    }
+
+    // a long string is allocated separately
+    const String longString = String::Printf("%16384u", 123u);
+    const StringId longId(longString.ToView());
+    EXPECT_EQ(longString.ToView(), longId.ToView());
+
+    HashSet<StringId> set;
+    for (uint32 i = 0; i < numStrings; ++i)
+    {
+        const String str = String::Printf("StringIdTest.ManyStrings.%u", i);
+        ASSERT_EQ(ids[i], StringId(str.ToView()));
+        ASSERT_EQ(str, ids[i].ToView());
+        set.Insert(ids[i]);
+    }
+
+    EXPECT_EQ(numStrings, set.Size());
+    EXPECT_TRUE(set.Exists(StringId("StringIdTest.ManyStrings.123")));
+}
+
+TEST(StringId, Multithreaded)
+{
+    const uint32 numThreads = 4;
+    const uint32 numStrings = 1000;
+
+    // all the threads intern the same set of strings at once
+    std::vector<std::vector<StringId>> ids(numThreads);
+    std::vector<std::thread> threads;
+    for (uint32 i = 0; i < numThreads; ++i)
+    {
+        threads.emplace_back([&threadIds = ids[i], numStrings] ()
+        {
+            for (uint32 j = 0; j < numStrings; ++j)
+            {
+                threadIds.emplace_back(String::Printf("StringIdTest.Multithreaded.%u", j).ToView());
+            }
+        });
+    }
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (uint32 j = 0; j < numStrings; ++j)
+    {
+        for (uint32 i = 1; i < numThreads; ++i)
+        {
+            ASSERT_EQ(ids[0][j], ids[i][j]);
+        }
+    }
+}
@@ -15,14 +15,14 @@ using namespace NFE::Common;
 #define TEST_STRING_SHORT "A"
 
 // a string that fits internal buffer (but any additional character won't)
-#define TEST_STRING_MID_A "AAAAAAAAAAA"
-#define TEST_STRING_MID_B "BBBBBBBBBBB"
-#define TEST_STRING__LEN 11u
+#define TEST_STRING_MID_A "AAAAAAAAAAAAAAAAAAA"
+#define TEST_STRING_MID_B "BBBBBBBBBBBBBBBBBBB"
+#define TEST_STRING__LEN 19u
 
 // a string that won't fit internal buffer
-#define TEST_STRING_LONG_A "AAAAAAAAAAAA"
-#define TEST_STRING_LONG_B "BBBBBBBBBBBB"
-#define TEST_STRING_LONG_LEN 12u
+#define TEST_STRING_LONG_A "AAAAAAAAAAAAAAAAAAAA"
+#define TEST_STRING_LONG_B "BBBBBBBBBBBBBBBBBBBB"
+#define TEST_STRING_LONG_LEN 20u
 
 TEST(String, Constructor_Default)
 {
@@ -335,14 +335,14 @@ TEST(String, Append_Char_Short)
 TEST(String, Append_Char_Long)
 {
     String string(TEST_STRING_MID_A);
-    ASSERT_EQ(11u, string.Length());
+    ASSERT_EQ(TEST_STRING__LEN, string.Length());
     ASSERT_EQ(String::MaxInternalLength + 1, string.Capacity());
 
     string += 'b';
 
     ASSERT_FALSE(string.Empty());
-    ASSERT_EQ(12u, string.Length());
-    ASSERT_LE(13u, string.Capacity());
+    ASSERT_EQ(TEST_STRING__LEN + 1u, string.Length());
+    ASSERT_LE(TEST_STRING__LEN + 2u, string.Capacity());
     ASSERT_STREQ(TEST_STRING_MID_A "b", string.Str());
 }
 
@@ -432,7 +432,7 @@ TEST(String, Concatenate_StringView_StringView_Long0)
     const String c = a + b;
 
     ASSERT_FALSE(c.Empty());
-    ASSERT_EQ(12u, c.Length());
+    ASSERT_EQ(TEST_STRING__LEN + 1u, c.Length());
     ASSERT_STREQ("a" TEST_STRING_MID_B, c.Str());
 }
 
@@ -443,7 +443,7 @@ TEST(String, Concatenate_StringView_StringView_Long1)
     const String c = a + b;
 
     ASSERT_FALSE(c.Empty());
-    ASSERT_EQ(12u, c.Length());
+    ASSERT_EQ(TEST_STRING__LEN + 1u, c.Length());
     ASSERT_STREQ(TEST_STRING_MID_A "b", c.Str());
 }
 
@@ -593,7 +593,7 @@ TEST(String, Concatenate_Char_StringView)
     const String c = 'a' + b;
 
     ASSERT_FALSE(c.Empty());
-    ASSERT_EQ(12u, c.Length());
+    ASSERT_EQ(TEST_STRING__LEN + 1u, c.Length());
     ASSERT_STREQ("a" TEST_STRING_MID_B, c.Str());
 }
 
@@ -603,7 +603,7 @@ TEST(String, Concatenate_StringView_Char)
     const String c = a + 'b';
 
     ASSERT_FALSE(c.Empty());
-    ASSERT_EQ(12u, c.Length());
+    ASSERT_EQ(TEST_STRING__LEN + 1u, c.Length());
     ASSERT_STREQ(TEST_STRING_MID_A "b", c.Str());
 }
 
@@ -241,6 +241,24 @@ TEST(WeakPtr, SharedPointerFromExpiredWeakPointer)
     EXPECT_EQ(0u, sharedPtr2.WeakRefCount());
 }
 
+TEST(WeakPtr, ExpiredWeakPointerOutlivesInlineObject)
+{
+    int counter = 0;
+    SharedPtr<TestClass> sharedPtr = MakeSharedPtr<TestClass>(counter);
+    WeakPtr<TestClass> weakPtr(sharedPtr);
+
+    // object is destroyed when the last strong reference is released, even though the weak pointer keeps its memory
+    sharedPtr.Reset();
+    ASSERT_EQ(1, counter);
+    EXPECT_FALSE(weakPtr.Valid());
+    EXPECT_EQ(1u, weakPtr.WeakRefCount());
+    EXPECT_FALSE(weakPtr.Lock());
+
+    weakPtr.Reset();
+    ASSERT_EQ(1, counter);
+    EXPECT_EQ(0u, weakPtr.WeakRefCount());
+}
+
 TEST(WeakPtr, CastToBaseClassViaWeakPtr)
 {
     int counter = 0;
@@ -1,6 +1,7 @@
 #include "PCH.hpp"
 #include "Engine/Common/Math/Vec4f.hpp"
 #include "Engine/Common/Math/Vec4i.hpp"
+#include "Engine/Common/Math/Half.hpp"
 
 using namespace NFE;
 using namespace NFE::Math;
@@ -87,6 +88,29 @@ TEST(MathTest, Vec4f_ToFromFloat3)
     EXPECT_TRUE((Vec4f(f3) == Vec4f(1.0f, 2.0f, 3.0f, 0.0f)).All());
 }
 
+TEST(MathTest, Vec4f_ToHalf4)
+{
+    // values exactly representable as half
+    {
+        const Half4 h = Vec4f(1.0f, -2.0f, 0.5f, 65504.0f).ToHalf4();
+        EXPECT_EQ(0x3C00u, h.x.value);
+        EXPECT_EQ(0xC000u, h.y.value);
+        EXPECT_EQ(0x3800u, h.z.value);
+        EXPECT_EQ(0x7BFFu, h.w.value);
+    }
+
+    // every component must match scalar conversion
+    {
+        const Vec4f v(0.1f, -123.456f, 1.0e-5f, 3.14159f);
+        const Half4 h = v.ToHalf4();
+        EXPECT_EQ(Half(v.x).value, h.x.value);
+        EXPECT_EQ(Half(v.y).value, h.y.value);
+        EXPECT_EQ(Half(v.z).value, h.z.value);
+        EXPECT_EQ(Half(v.w).value, h.w.value);
+        EXPECT_NEAR(v.w, h.w.ToFloat(), 0.001f);
+    }
+}
+
 TEST(MathTest, Vec4f_Splat)
 {
     EXPECT_TRUE((Vec4f(1.0f, 1.0f, 1.0f, 1.0f) == vecB.SplatX()).All());
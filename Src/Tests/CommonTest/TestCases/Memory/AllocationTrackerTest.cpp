@@ -0,0 +1,240 @@
+#include "PCH.hpp"
+#include "Engine/Common/Memory/AllocationTracker.hpp"
+#include "Engine/Common/Memory/DefaultAllocator.hpp"
+#include "Engine/Common/Utils/ThreadPool.hpp"
+#include "Engine/Common/Utils/Waitable.hpp"
+
+#include <thread>
+
+
+using namespace NFE;
+using namespace NFE::Common;
+
+namespace {
+
+MemoryTagStats GetStats(MemoryTag tag)
+{
+    AllocationTracker& tracker = AllocationTracker::GetInstance();
+    tracker.Flush();
+
+    MemoryTagStats stats;
+    EXPECT_TRUE(tracker.GetTagStats(tag, stats));
+    return stats;
+}
+
+// enables tracking for a scope
+class TrackingScope
+{
+public:
+    TrackingScope()
+    {
+        DefaultAllocator::GetInstance().EnableTracking(true);
+    }
+
+    ~TrackingScope()
+    {
+        DefaultAllocator::GetInstance().EnableTracking(false);
+    }
+};
+
+} // namespace
+
+
+TEST(AllocationTrackerTest, RegisterTag)
+{
+    AllocationTracker& tracker = AllocationTracker::GetInstance();
+
+    const MemoryTag tagA = tracker.RegisterTag("AllocationTrackerTest.A");
+    const MemoryTag tagB = tracker.RegisterTag("AllocationTrackerTest.B");
+
+    EXPECT_NE(AllocationTracker::UntaggedTag, tagA);
+    EXPECT_NE(AllocationTracker::UntaggedTag, tagB);
+    EXPECT_NE(tagA, tagB);
+    EXPECT_EQ(tagA, tracker.RegisterTag("AllocationTrackerTest.A"));
+    EXPECT_LT(tagB, tracker.GetTagsNum());
+
+    MemoryTagStats stats;
+    EXPECT_TRUE(tracker.GetTagStats(tagA, stats));
+    EXPECT_STREQ("AllocationTrackerTest.A", stats.name);
+    EXPECT_FALSE(tracker.GetTagStats(static_cast<MemoryTag>(AllocationTracker::MaxTags), stats));
+}
+
+TEST(AllocationTrackerTest, Scope)
+{
+    const MemoryTag tag = AllocationTracker::GetInstance().RegisterTag("AllocationTrackerTest.Scope");
+
+    EXPECT_EQ(AllocationTracker::UntaggedTag, AllocationTracker::GetCurrentTag());
+    {
+        MemoryTagScope scope(tag);
+        EXPECT_EQ(tag, AllocationTracker::GetCurrentTag());
+        {
+            NFE_MEMORY_TAG_SCOPE("AllocationTrackerTest.Nested");
+            EXPECT_NE(tag, AllocationTracker::GetCurrentTag());
+        }
+        EXPECT_EQ(tag, AllocationTracker::GetCurrentTag());
+    }
+    EXPECT_EQ(AllocationTracker::UntaggedTag, AllocationTracker::GetCurrentTag());
+}
+
+TEST(AllocationTrackerTest, Disabled)
+{
+    const MemoryTag tag = AllocationTracker::GetInstance().RegisterTag("AllocationTrackerTest.Disabled");
+    ASSERT_FALSE(DefaultAllocator::GetInstance().IsTrackingEnabled());
+
+    const MemoryTagStats statsBefore = GetStats(tag);
+    {
+        MemoryTagScope scope(tag);
+        void* ptr = NFE_MALLOC(100, 1);
+        ASSERT_NE(nullptr, ptr);
+        NFE_FREE(ptr);
+    }
+    const MemoryTagStats statsAfter = GetStats(tag);
+
+    EXPECT_EQ(statsBefore.totalAllocationsNum, statsAfter.totalAllocationsNum);
+    EXPECT_EQ(statsBefore.totalBytesAllocated, statsAfter.totalBytesAllocated);
+}
+
+TEST(AllocationTrackerTest, TaggedAllocations)
+{
+    const MemoryTag tag = AllocationTracker::GetInstance().RegisterTag("AllocationTrackerTest.Tagged");
+    const uint32 numBlocks = 1000;
+    const size_t blockSize = 100;
+
+    // allocated before tracking was enabled
+    void* untrackedBlock = NFE_MALLOC(blockSize, 1);
+    ASSERT_NE(nullptr, untrackedBlock);
+
+    TrackingScope trackingScope;
+    const MemoryTagStats statsBefore = GetStats(tag);
+
+    std::vector<void*> blocks(numBlocks);
+    {
+        MemoryTagScope scope(tag);
+        for (void*& ptr : blocks)
+        {
+            ptr = NFE_MALLOC(blockSize, 16);
+            ASSERT_NE(nullptr, ptr);
+        }
+        NFE_FREE(untrackedBlock);
+    }
+
+    MemoryTagStats stats = GetStats(tag);
+    EXPECT_EQ(statsBefore.allocationsNum + numBlocks, stats.allocationsNum);
+    EXPECT_EQ(statsBefore.bytesAllocated + numBlocks * blockSize, stats.bytesAllocated);
+    EXPECT_EQ(statsBefore.totalAllocationsNum + numBlocks, stats.totalAllocationsNum);
+    EXPECT_EQ(statsBefore.totalBytesAllocated + numBlocks * blockSize, stats.totalBytesAllocated);
+    EXPECT_GE(stats.peakBytesAllocated, stats.bytesAllocated);
+
+    // blocks are released to the tag they were allocated with
+    for (void* ptr : blocks)
+    {
+        NFE_FREE(ptr);
+    }
+
+    stats = GetStats(tag);
+    EXPECT_EQ(statsBefore.allocationsNum, stats.allocationsNum);
+    EXPECT_EQ(statsBefore.bytesAllocated, stats.bytesAllocated);
+    EXPECT_EQ(statsBefore.totalAllocationsNum + numBlocks, stats.totalAllocationsNum);
+    EXPECT_GE(stats.peakBytesAllocated, statsBefore.bytesAllocated + numBlocks * blockSize);
+
+    AllocationTracker::GetInstance().Report();
+}
+
+TEST(AllocationTrackerTest, Multithreaded)
+{
+    const MemoryTag tag = AllocationTracker::GetInstance().RegisterTag("AllocationTrackerTest.Multithreaded");
+    const uint32 numThreads = 4;
+    const uint32 numBlocks = 10000;
+    const size_t blockSize = 32;
+
+    TrackingScope trackingScope;
+    const MemoryTagStats statsBefore = GetStats(tag);
+
+    std::vector<std::vector<void*>> blocks(numThreads);
+    std::vector<std::thread> threads;
+    for (uint32 i = 0; i < numThreads; ++i)
+    {
+        threads.emplace_back([&threadBlocks = blocks[i], tag, numBlocks, blockSize] ()
+        {
+            MemoryTagScope scope(tag);
+
+            // blocks are freed both on this thread and on the main thread
+            std::vector<void*> tempBlocks;
+            for (uint32 j = 0; j < numBlocks; ++j)
+            {
+                void* ptr = NFE_MALLOC(blockSize, 1);
+                (j % 2 ? threadBlocks : tempBlocks).push_back(ptr);
+            }
+            for (void* ptr : tempBlocks)
+            {
+                NFE_FREE(ptr);
+            }
+        });
+    }
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    // counters of finished threads are flushed
+    MemoryTagStats stats = GetStats(tag);
+    EXPECT_EQ(statsBefore.allocationsNum + numThreads * numBlocks / 2, stats.allocationsNum);
+    EXPECT_EQ(statsBefore.bytesAllocated + numThreads * numBlocks / 2 * blockSize, stats.bytesAllocated);
+    EXPECT_EQ(statsBefore.totalAllocationsNum + numThreads * numBlocks, stats.totalAllocationsNum);
+
+    for (const std::vector<void*>& threadBlocks : blocks)
+    {
+        for (void* ptr : threadBlocks)
+        {
+            NFE_FREE(ptr);
+        }
+    }
+
+    stats = GetStats(tag);
+    EXPECT_EQ(statsBefore.allocationsNum, stats.allocationsNum);
+    EXPECT_EQ(statsBefore.bytesAllocated, stats.bytesAllocated);
+}
+
+TEST(AllocationTrackerTest, ThreadPoolTasks)
+{
+    const MemoryTag taskTag = AllocationTracker::GetInstance().RegisterTag("AllocationTrackerTest.Task");
+    const MemoryTag waitTag = AllocationTracker::GetInstance().RegisterTag("AllocationTrackerTest.Wait");
+    const uint32 numTasks = 1000;
+
+    ThreadPool tp(2);
+
+    std::vector<MemoryTag> tags(2 * numTasks, waitTag);
+    Waitable waitable;
+    {
+        TaskDesc rootDesc;
+        rootDesc.waitable = &waitable;
+        const TaskID rootTask = tp.CreateTask(rootDesc);
+
+        // half of the tasks is created with a tag, the other half without
+        for (uint32 i = 0; i < 2 * numTasks; ++i)
+        {
+            const MemoryTag tag = i < numTasks ? taskTag : AllocationTracker::UntaggedTag;
+            MemoryTagScope scope(tag);
+
+            TaskDesc desc;
+            desc.parent = rootTask;
+            desc.function = [&tags, i] (const TaskContext&) { tags[i] = AllocationTracker::GetCurrentTag(); };
+            tp.CreateAndDispatchTask(desc);
+        }
+
+        tp.DispatchTask(rootTask);
+    }
+
+    // tasks executed by the waiting thread must not inherit its tag
+    {
+        MemoryTagScope scope(waitTag);
+        waitable.Wait();
+        EXPECT_EQ(waitTag, AllocationTracker::GetCurrentTag());
+    }
+
+    for (uint32 i = 0; i < 2 * numTasks; ++i)
+    {
+        ASSERT_EQ(i < numTasks ? taskTag : AllocationTracker::UntaggedTag, tags[i]);
+    }
+}
@@ -0,0 +1,195 @@
+#include "PCH.hpp"
+#include "Engine/Common/Memory/InlineAllocator.hpp"
+#include "Engine/Common/Containers/DynArray.hpp"
+#include "Engine/Common/Containers/HashSet.hpp"
+#include "Engine/Common/Containers/HashMap.hpp"
+#include "Engine/Common/Containers/String.hpp"
+
+
+using namespace NFE;
+using namespace NFE::Common;
+
+namespace {
+
+// allocator counting live allocations, supports in-place growth of the last allocated block
+class CountingAllocator : public IAllocator
+{
+public:
+    uint32 numAllocations = 0;
+    uint32 numLiveBlocks = 0;
+    uint32 numResizes = 0;
+    void* lastBlock = nullptr;
+    size_t lastBlockSize = 0;
+
+    void* Malloc(size_t size, size_t alignment) override
+    {
+        numAllocations++;
+        numLiveBlocks++;
+        lastBlockSize = size * 2; // leave room for growth
+        lastBlock = NFE_MALLOC(lastBlockSize, alignment);
+        return lastBlock;
+    }
+
+    void Free(void* ptr) override
+    {
+        EXPECT_GT(numLiveBlocks, 0u);
+        numLiveBlocks--;
+        if (ptr == lastBlock)
+        {
+            lastBlock = nullptr;
+        }
+        NFE_FREE(ptr);
+    }
+
+    bool TryResize(void* ptr, size_t oldSize, size_t newSize) override
+    {
+        NFE_UNUSED(oldSize);
+        if (ptr == lastBlock && newSize <= lastBlockSize)
+        {
+            numResizes++;
+            return true;
+        }
+        return false;
+    }
+};
+
+} // namespace
+
+
+TEST(AllocatorTest, InlineAllocator)
+{
+    InlineAllocator<64> allocator;
+
+    void* first = allocator.Malloc(32, 16);
+    EXPECT_TRUE(allocator.OwnsBlock(first));
+    EXPECT_TRUE(allocator.IsBufferUsed());
+
+    // buffer is in use - fallback to default allocator
+    void* second = allocator.Malloc(32, 16);
+    EXPECT_FALSE(allocator.OwnsBlock(second));
+
+    EXPECT_TRUE(allocator.TryResize(first, 32, 64));
+    EXPECT_FALSE(allocator.TryResize(first, 64, 65));
+
+    allocator.Free(second);
+    allocator.Free(first);
+    EXPECT_FALSE(allocator.IsBufferUsed());
+
+    // too big
+    void* third = allocator.Malloc(65, 16);
+    EXPECT_FALSE(allocator.OwnsBlock(third));
+    allocator.Free(third);
+}
+
+TEST(AllocatorTest, DynArray)
+{
+    CountingAllocator allocator;
+    {
+        DynArray<int> array(&allocator);
+        EXPECT_EQ(&allocator, array.GetAllocator());
+
+        for (int i = 0; i < 100; ++i)
+        {
+            ASSERT_NE(array.End(), array.PushBack(i));
+        }
+
+        EXPECT_GT(allocator.numResizes, 0u);
+        EXPECT_EQ(1u, allocator.numLiveBlocks);
+
+        // move constructor takes over the buffer together with the allocator
+        const int* buffer = array.Data();
+        const uint32 numAllocations = allocator.numAllocations;
+        DynArray<int> movedArray(std::move(array));
+        EXPECT_EQ(&allocator, movedArray.GetAllocator());
+        EXPECT_EQ(buffer, movedArray.Data());
+        EXPECT_EQ(numAllocations, allocator.numAllocations);
+        EXPECT_EQ(100u, movedArray.Size());
+        EXPECT_EQ(0u, array.Size());
+
+        // moving to an array with different allocator must move the elements
+        DynArray<int> defaultArray;
+        defaultArray = std::move(movedArray);
+        EXPECT_EQ(nullptr, defaultArray.GetAllocator());
+        EXPECT_EQ(100u, defaultArray.Size());
+        EXPECT_EQ(0u, movedArray.Size());
+
+        for (int i = 0; i < 100; ++i)
+        {
+            EXPECT_EQ(i, defaultArray[i]);
+        }
+
+        // moving between arrays with the same allocator takes over the buffer
+        DynArray<int> array2(&allocator);
+        array = std::move(defaultArray);
+        array2 = std::move(array);
+        EXPECT_EQ(100u, array2.Size());
+        EXPECT_EQ(&allocator, array2.GetAllocator());
+    }
+    EXPECT_EQ(0u, allocator.numLiveBlocks);
+}
+
+TEST(AllocatorTest, HashSet)
+{
+    CountingAllocator allocator;
+    {
+        HashSet<int> set(&allocator);
+        for (int i = 0; i < 1000; ++i)
+        {
+            ASSERT_NE(set.End(), set.Insert(i).iterator);
+        }
+        EXPECT_GT(allocator.numAllocations, 0u);
+        EXPECT_TRUE(set.Verify());
+
+        // move constructor takes over the allocator
+        HashSet<int> movedSet(std::move(set));
+        EXPECT_EQ(1000u, movedSet.Size());
+
+        // different allocator - keys are moved one by one
+        HashSet<int> defaultSet;
+        defaultSet = std::move(movedSet);
+        EXPECT_EQ(1000u, defaultSet.Size());
+        EXPECT_TRUE(defaultSet.Exists(999));
+        EXPECT_EQ(0u, allocator.numLiveBlocks);
+    }
+    EXPECT_EQ(0u, allocator.numLiveBlocks);
+}
+
+TEST(AllocatorTest, HashMap)
+{
+    CountingAllocator allocator;
+    {
+        HashMap<int, String> map(&allocator);
+        ASSERT_NE(map.End(), map.Insert(1, String("one")).iterator);
+        EXPECT_GT(allocator.numLiveBlocks, 0u);
+        EXPECT_EQ(String("one"), map[1]);
+    }
+    EXPECT_EQ(0u, allocator.numLiveBlocks);
+}
+
+TEST(AllocatorTest, String)
+{
+    CountingAllocator allocator;
+    {
+        String str(&allocator);
+        str = "this string is too long to be stored internally";
+        EXPECT_FALSE(str.IsInternal());
+        EXPECT_EQ(1u, allocator.numLiveBlocks);
+
+        str += " and grows";
+        EXPECT_EQ(1u, allocator.numLiveBlocks);
+        EXPECT_EQ(StringView("this string is too long to be stored internally and grows"), str.ToView());
+
+        // move constructor takes over the allocator
+        String moved(std::move(str));
+        EXPECT_EQ(&allocator, moved.GetAllocator());
+
+        // different allocator - content is copied
+        String defaultString;
+        defaultString = std::move(moved);
+        EXPECT_EQ(nullptr, defaultString.GetAllocator());
+        EXPECT_EQ(StringView("this string is too long to be stored internally and grows"), defaultString.ToView());
+        EXPECT_TRUE(moved.Empty());
+        EXPECT_EQ(0u, allocator.numLiveBlocks);
+    }
+    EXPECT_EQ(0u, allocator.numLiveBlocks);
+}
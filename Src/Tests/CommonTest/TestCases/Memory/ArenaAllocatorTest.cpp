@@ -0,0 +1,169 @@
+#include "PCH.hpp"
+#include "Engine/Common/Memory/ArenaAllocator.hpp"
+#include "Engine/Common/Containers/DynArray.hpp"
+#include "Engine/Common/Containers/String.hpp"
+
+
+using namespace NFE;
+using namespace NFE::Common;
+
+
+TEST(ArenaAllocatorTest, Empty)
+{
+    ArenaAllocator arena;
+
+    const ArenaAllocatorStats stats = arena.GetStats();
+    EXPECT_EQ(0u, stats.bytesUsed);
+    EXPECT_EQ(0u, stats.peakBytesUsed);
+    EXPECT_EQ(0u, stats.bytesReserved);
+    EXPECT_EQ(0u, stats.chunksNum);
+
+    arena.Reset();
+    EXPECT_EQ(0u, arena.GetStats().chunksNum);
+}
+
+TEST(ArenaAllocatorTest, Alignment)
+{
+    ArenaAllocator arena(1024);
+
+    for (size_t alignment = 1; alignment <= 256; alignment *= 2)
+    {
+        void* a = arena.Malloc(1, 1);
+        void* b = arena.Malloc(3, alignment);
+        ASSERT_NE(nullptr, a);
+        ASSERT_NE(nullptr, b);
+        EXPECT_EQ(0u, reinterpret_cast<size_t>(b) % alignment);
+        EXPECT_NE(a, b);
+    }
+
+    // bigger than chunk size
+    void* big = arena.Malloc(4000, 64);
+    ASSERT_NE(nullptr, big);
+    EXPECT_EQ(0u, reinterpret_cast<size_t>(big) % 64);
+    memset(big, 0xAB, 4000);
+}
+
+TEST(ArenaAllocatorTest, ResetCoalescesChunks)
+{
+    ArenaAllocator arena(256);
+
+    for (uint32 i = 0; i < 100; ++i)
+    {
+        ASSERT_NE(nullptr, arena.Malloc(100, 4));
+    }
+
+    ArenaAllocatorStats stats = arena.GetStats();
+    EXPECT_GT(stats.chunksNum, 1u);
+    EXPECT_GE(stats.bytesUsed, 10000u);
+    EXPECT_GE(stats.bytesReserved, stats.bytesUsed);
+
+    arena.Reset();
+
+    stats = arena.GetStats();
+    EXPECT_EQ(1u, stats.chunksNum);
+    EXPECT_EQ(0u, stats.bytesUsed);
+    EXPECT_GE(stats.peakBytesUsed, 10000u);
+    EXPECT_EQ(1u, stats.resetsNum);
+
+    // the same workload fits into the merged chunk
+    for (uint32 i = 0; i < 100; ++i)
+    {
+        ASSERT_NE(nullptr, arena.Malloc(100, 4));
+    }
+    EXPECT_EQ(1u, arena.GetStats().chunksNum);
+}
+
+TEST(ArenaAllocatorTest, Rewind)
+{
+    ArenaAllocator arena(256);
+
+    void* first = arena.Malloc(16, 16);
+    const ArenaAllocator::Marker marker = arena.GetMarker();
+    const size_t bytesUsed = arena.GetStats().bytesUsed;
+
+    void* second = arena.Malloc(16, 16);
+    for (uint32 i = 0; i < 10; ++i)
+    {
+        // spill into other chunks
+        ASSERT_NE(nullptr, arena.Malloc(200, 16));
+    }
+
+    arena.Rewind(marker);
+    EXPECT_EQ(bytesUsed, arena.GetStats().bytesUsed);
+    EXPECT_EQ(second, arena.Malloc(16, 16));
+
+    // chunks are kept for reuse
+    const uint32 chunksNum = arena.GetStats().chunksNum;
+    for (uint32 i = 0; i < 10; ++i)
+    {
+        ASSERT_NE(nullptr, arena.Malloc(200, 16));
+    }
+    EXPECT_EQ(chunksNum, arena.GetStats().chunksNum);
+
+    {
+        ArenaScope scope(arena);
+        arena.Malloc(1000, 1);
+    }
+    EXPECT_NE(first, arena.Malloc(16, 16));
+}
+
+TEST(ArenaAllocatorTest, FreeAndResizeLastBlock)
+{
+    ArenaAllocator arena(1024);
+
+    void* a = arena.Malloc(64, 8);
+    void* b = arena.Malloc(64, 8);
+
+    // only the last block can grow
+    EXPECT_FALSE(arena.TryResize(a, 64, 128));
+    EXPECT_TRUE(arena.TryResize(b, 64, 128));
+    EXPECT_FALSE(arena.TryResize(b, 128, 2048));
+
+    // freeing the last block gives back its memory
+    arena.Free(b);
+    EXPECT_EQ(b, arena.Malloc(64, 8));
+
+    // freeing other blocks is a no-op
+    arena.Free(a);
+    EXPECT_NE(a, arena.Malloc(64, 8));
+}
+
+TEST(ArenaAllocatorTest, Containers)
+{
+    ArenaAllocator arena;
+    {
+        DynArray<uint32> array(&arena);
+        for (uint32 i = 0; i < 1000; ++i)
+        {
+            ASSERT_NE(array.End(), array.PushBack(i));
+        }
+
+        String str(&arena);
+        str = "this string is too long to be stored internally";
+
+        for (uint32 i = 0; i < 1000; ++i)
+        {
+            ASSERT_EQ(i, array[i]);
+        }
+        EXPECT_EQ(StringView("this string is too long to be stored internally"), str.ToView());
+    }
+
+    // array grows in place, so only a little more than its final size is used
+    EXPECT_EQ(1u, arena.GetStats().chunksNum);
+    EXPECT_LT(arena.GetStats().peakBytesUsed, 8192u);
+}
+
+TEST(ArenaAllocatorTest, Move)
+{
+    ArenaAllocator arena;
+    void* ptr = arena.Malloc(16, 16);
+    ASSERT_NE(nullptr, ptr);
+
+    ArenaAllocator other(std::move(arena));
+    EXPECT_EQ(0u, arena.GetStats().chunksNum);
+    EXPECT_EQ(1u, other.GetStats().chunksNum);
+
+    arena = std::move(other);
+    EXPECT_EQ(1u, arena.GetStats().chunksNum);
+    EXPECT_EQ(16u, arena.GetStats().bytesUsed);
+}
@@ -2,8 +2,10 @@
 #include "Engine/Common/System/Memory.hpp"
 #include "Engine/Common/Memory/DefaultAllocator.hpp"
 
+#include <thread>
 
 
+using namespace NFE;
 using namespace NFE::Common;
 
 using BufferUniquePtr = std::unique_ptr<char[], std::function<void(char*)>>;
@@ -49,6 +51,120 @@ TEST(MemoryTest, MallocInvalidAlignment)
     EXPECT_EQ(nullptr, NFE_MALLOC(1, 5));
 }
 
+TEST(MemoryTest, MallocStats)
+{
+    DefaultAllocator& allocator = DefaultAllocator::GetInstance();
+
+    // small and big blocks
+    for (size_t size : { 1, 24, 100, 4096, 4097, 100000 })
+    {
+        const AllocatorStats statsBefore = allocator.GetStats();
+
+        void* ptr = NFE_MALLOC(size, 8);
+        ASSERT_NE(nullptr, ptr);
+        memset(ptr, 0xFF, size);
+
+        const AllocatorStats stats = allocator.GetStats();
+        EXPECT_EQ(statsBefore.allocationsNum + 1, stats.allocationsNum);
+        EXPECT_GE(stats.bytesAllocated, statsBefore.bytesAllocated + size);
+
+        NFE_FREE(ptr);
+
+        const AllocatorStats statsAfter = allocator.GetStats();
+        EXPECT_EQ(statsBefore.allocationsNum, statsAfter.allocationsNum);
+        EXPECT_EQ(statsBefore.bytesAllocated, statsAfter.bytesAllocated);
+    }
+}
+
+TEST(MemoryTest, MallocSmallBlocks)
+{
+    const uint32 numBlocks = 10000;
+    std::vector<uint8*> blocks(numBlocks);
+
+    for (uint32 i = 0; i < numBlocks; ++i)
+    {
+        const size_t size = 1 + i % 1000;
+        blocks[i] = static_cast<uint8*>(NFE_MALLOC(size, 1));
+        ASSERT_NE(nullptr, blocks[i]);
+        memset(blocks[i], static_cast<int>(i & 0xFF), size);
+    }
+
+    // blocks must not overlap
+    for (uint32 i = 0; i < numBlocks; ++i)
+    {
+        const size_t size = 1 + i % 1000;
+        for (size_t j = 0; j < size; ++j)
+        {
+            ASSERT_EQ(static_cast<uint8>(i & 0xFF), blocks[i][j]);
+        }
+        NFE_FREE(blocks[i]);
+    }
+}
+
+TEST(MemoryTest, MallocMultithreaded)
+{
+    const uint32 numThreads = 4;
+    const uint32 numBlocks = 10000;
+
+    const AllocatorStats statsBefore = DefaultAllocator::GetInstance().GetStats();
+
+    // each thread frees blocks allocated by its neighbour, so the blocks migrate between thread caches
+    std::vector<std::vector<void*>> blocks(numThreads);
+    {
+        std::vector<std::thread> threads;
+        for (uint32 i = 0; i < numThreads; ++i)
+        {
+            threads.emplace_back([i, &blocks] ()
+            {
+                for (uint32 j = 0; j < numBlocks; ++j)
+                {
+                    blocks[i].push_back(NFE_MALLOC(16 + (i * numBlocks + j) % 2000, 16));
+                }
+            });
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    {
+        std::vector<std::thread> threads;
+        for (uint32 i = 0; i < numThreads; ++i)
+        {
+            threads.emplace_back([i, &blocks] ()
+            {
+                for (void* ptr : blocks[(i + 1) % numThreads])
+                {
+                    ASSERT_NE(nullptr, ptr);
+                    NFE_FREE(ptr);
+                }
+            });
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    const AllocatorStats statsAfter = DefaultAllocator::GetInstance().GetStats();
+    EXPECT_EQ(statsBefore.allocationsNum, statsAfter.allocationsNum);
+    EXPECT_EQ(statsBefore.bytesAllocated, statsAfter.bytesAllocated);
+}
+
+TEST(MemoryTest, ReserveAndCommitPages)
+{
+    const size_t size = 1024 * 1024;
+    uint8* ptr = static_cast<uint8*>(ReserveMemoryPages(size));
+    ASSERT_NE(nullptr, ptr);
+
+    ASSERT_TRUE(CommitMemoryPages(ptr, size / 2));
+    EXPECT_TRUE(MemoryCheck(ptr, size / 2));
+    memset(ptr, 0xAB, size / 2);
+
+    ReleaseMemoryPages(ptr, size);
+}
+
 TEST(MemoryTest, AccessValid)
 {
     const size_t ARRAY_SIZE = 4096;
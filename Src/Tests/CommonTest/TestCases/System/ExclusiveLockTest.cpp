@@ -10,6 +10,8 @@
 #include "Engine/Common/System/SpinLock.hpp"
 #include "Engine/Common/System/RWLock.hpp"
 #include "Engine/Common/System/RWSpinLock.hpp"
+#include "Engine/Common/System/HybridLock.hpp"
+#include "Engine/Common/System/ContentionCountingLock.hpp"
 #include "Engine/Common/System/Thread.hpp"
 #include "Engine/Common/Containers/DynArray.hpp"
 
@@ -22,7 +24,7 @@ class ExclusiveLockTest : public ::testing::Test
 {
 };
 
-using LockTestTypes = ::testing::Types<Mutex, RWLock, SpinLock, RWSpinLock>;
+using LockTestTypes = ::testing::Types<Mutex, RWLock, SpinLock, RWSpinLock, HybridLock, ContentionCountingLock<SpinLock>>;
 TYPED_TEST_SUITE(ExclusiveLockTest, LockTestTypes);
 
 
@@ -95,3 +97,94 @@ TYPED_TEST(ExclusiveLockTest, Multithreaded)
 
     ASSERT_EQ(counter, static_cast<uint32>(numThreads) * maxIterations);
 }
+
+// many threads fighting for a lock, so waiting threads have to park
+TEST(HybridLockTest, Multithreaded_Oversubscribed)
+{
+    const uint32 maxIterations = 10000u;
+    const uint32 numThreads = 16u;
+
+    uint32 counter = 0;
+    HybridLock lock;
+
+    const auto func = [&]()
+    {
+        for (uint32 i = 0; i < maxIterations; ++i)
+        {
+            NFE_SCOPED_LOCK(lock);
+            counter++;
+
+            // make the critical section longer sometimes
+            if (i % 1000 == 0)
+            {
+                Thread::YieldCurrentThread();
+            }
+        }
+    };
+
+    DynArray<Thread> threads(numThreads);
+    for (uint32 i = 0; i < numThreads; ++i)
+    {
+        threads[i].Run(func);
+    }
+
+    threads.Clear();
+
+    ASSERT_EQ(numThreads * maxIterations, counter);
+}
+
+TEST(ContentionCountingLockTest, Stats)
+{
+    ContentionCountingLock<HybridLock> lock;
+
+    lock.AcquireExclusive();
+    lock.ReleaseExclusive();
+    ASSERT_TRUE(lock.TryAcquireExclusive());
+    ASSERT_FALSE(lock.TryAcquireExclusive());
+
+    // the second thread has to wait for the lock
+    // Note: the thread can be preempted after starting the acquisition and reach the lock after it's released,
+    // so the handoff is repeated until a contended acquisition is recorded
+    const uint32 maxAttempts = 100;
+    uint32 numAttempts = 0;
+    uint64 numAcquisitions = 2;
+    while (numAttempts < maxAttempts)
+    {
+        Thread thread;
+        thread.Run([&lock]()
+        {
+            lock.AcquireExclusive();
+            lock.ReleaseExclusive();
+        });
+
+        // wait until the thread starts acquiring the lock
+        while (lock.GetStats().numAcquisitions <= numAcquisitions)
+        {
+            Thread::YieldCurrentThread();
+        }
+        numAcquisitions++;
+        numAttempts++;
+
+        Thread::SleepCurrentThread(0.001);
+        lock.ReleaseExclusive();
+        thread.Wait();
+
+        if (lock.GetStats().numContendedAcquisitions > 0)
+        {
+            break;
+        }
+
+        ASSERT_TRUE(lock.TryAcquireExclusive());
+        numAcquisitions++;
+    }
+
+    LockContentionStats stats = lock.GetStats();
+    EXPECT_EQ(numAcquisitions, stats.numAcquisitions);
+    EXPECT_EQ(1u, stats.numContendedAcquisitions);
+    EXPECT_GT(stats.totalWaitTime, 0.0);
+
+    lock.ResetStats();
+    stats = lock.GetStats();
+    EXPECT_EQ(0u, stats.numAcquisitions);
+    EXPECT_EQ(0u, stats.numContendedAcquisitions);
+}
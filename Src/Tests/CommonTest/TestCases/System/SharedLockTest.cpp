@@ -8,6 +8,7 @@
 #include "Engine/Common/Utils/Latch.hpp"
 #include "Engine/Common/System/RWLock.hpp"
 #include "Engine/Common/System/RWSpinLock.hpp"
+#include "Engine/Common/System/ContentionCountingLock.hpp"
 #include "Engine/Common/Math/Math.hpp"
 #include "Engine/Common/Containers/DynArray.hpp"
 
@@ -20,8 +21,7 @@ class SharedLockTest : public ::testing::Test
 {
 };
 
-// TODO RWSpinLock
-using LockTestTypes = ::testing::Types<RWLock, RWSpinLock>;
+using LockTestTypes = ::testing::Types<RWLock, RWSpinLock, ContentionCountingLock<RWSpinLock>>;
 TYPED_TEST_SUITE(SharedLockTest, LockTestTypes);
 
 
@@ -224,3 +224,40 @@ TYPED_TEST(SharedLockTest, Multithreaded_Validate)
 
     ASSERT_FALSE(errorFound);
 }
+
+// writer must be able to acquire the lock even if readers keep it locked in shared mode all the time
+TEST(RWSpinLockTest, WriterNotStarved)
+{
+    const uint32 numReaderThreads = 4;
+    const uint32 numWriterIterations = 100;
+
+    RWSpinLock lock;
+    std::atomic<bool> finish(false);
+    std::atomic<uint32> numReadersInside(0);
+
+    const auto readerFunc = [&]()
+    {
+        while (!finish)
+        {
+            ScopedSharedLock<RWSpinLock> scopedLock(lock);
+            numReadersInside++;
+            Thread::YieldCurrentThread();
+            numReadersInside--;
+        }
+    };
+
+    DynArray<Thread> readerThreads(numReaderThreads);
+    for (uint32 i = 0; i < numReaderThreads; ++i)
+    {
+        readerThreads[i].Run(readerFunc);
+    }
+
+    for (uint32 i = 0; i < numWriterIterations; ++i)
+    {
+        ScopedExclusiveLock<RWSpinLock> scopedLock(lock);
+        ASSERT_EQ(0u, numReadersInside.load());
+    }
+
+    finish = true;
+    readerThreads.Clear();
+}
@@ -44,3 +44,22 @@ TEST(SystemInfoTest, FeatureSupportTest)
     result = sysInfoPtr.IsFeatureSupported(StringView("Should return false"));
     ASSERT_FALSE(result);
 }
+
+TEST(SystemInfoTest, TopologyTest)
+{
+    SystemInfo& sysInfoPtr = SystemInfo::Instance();
+    const DynArray<LogicalCoreInfo>& logicalCores = sysInfoPtr.GetLogicalCores();
+    ASSERT_FALSE(logicalCores.Empty());
+    ASSERT_GE(sysInfoPtr.GetNumNumaNodes(), 1u);
+
+    for (NFE::uint32 i = 0; i < logicalCores.Size(); ++i)
+    {
+        EXPECT_LT(logicalCores[i].numaNode, sysInfoPtr.GetNumNumaNodes());
+
+        // sorted by NUMA node
+        if (i > 0)
+        {
+            EXPECT_LE(logicalCores[i - 1].numaNode, logicalCores[i].numaNode);
+        }
+    }
+}
@@ -8,7 +8,13 @@
 #include "Engine/Common/Utils/Latch.hpp"
 #include "Engine/Common/Utils/Waitable.hpp"
 #include "Engine/Common/Utils/TaskBuilder.hpp"
+#include "Engine/Common/Utils/CancellationToken.hpp"
 #include "Engine/Common/Utils/ParallelAlgorithms.hpp"
+#include "Engine/Common/Utils/TaskTracer.hpp"
+#include "Engine/Common/FileSystem/File.hpp"
+#include "Engine/Common/FileSystem/FileSystem.hpp"
+
+#include <thread>
 #include "Engine/Common/System/Timer.hpp"
 #include "Engine/Common/Math/Random.hpp"
 
@@ -255,6 +261,123 @@ TEST(ThreadPoolSimple, DependencyChain)
     }
 }
 
+// Task waiting for many other tasks (more than fits in a single task, so join tasks are used)
+TEST(ThreadPoolSimple, MultipleDependencies)
+{
+    const uint32 numIterations = 100;
+    const uint32 numDependencies = 20;
+
+    ThreadPool& tp = ThreadPool::GetInstance();
+
+    for (uint32 iteration = 0; iteration < numIterations; ++iteration)
+    {
+        Latch latch;
+        std::atomic<uint32> counter(0);
+        std::atomic<uint32> finalTaskCounter(0);
+
+        TaskID dependencies[numDependencies + 1];
+        for (uint32 i = 0; i < numDependencies; ++i)
+        {
+            TaskDesc desc;
+            desc.function = [&] (const TaskContext&)
+            {
+                latch.Wait();
+                counter++;
+            };
+            dependencies[i] = tp.CreateTask(desc);
+        }
+
+        // invalid IDs are ignored
+        dependencies[numDependencies] = InvalidTaskID;
+
+        Waitable waitable;
+        {
+            TaskDesc desc;
+            desc.function = [&] (const TaskContext&)
+            {
+                EXPECT_EQ(numDependencies, counter.load());
+                finalTaskCounter++;
+            };
+            desc.dependency = dependencies[0];
+            desc.dependencies = ArrayView<const TaskID>(dependencies + 1, numDependencies);
+            desc.waitable = &waitable;
+            tp.CreateAndDispatchTask(desc);
+        }
+
+        for (uint32 i = 0; i < numDependencies; ++i)
+        {
+            tp.DispatchTask(dependencies[i]);
+        }
+
+        EXPECT_EQ(0u, finalTaskCounter.load());
+
+        latch.Set();
+        waitable.Wait();
+
+        EXPECT_EQ(numDependencies, counter.load());
+        EXPECT_EQ(1u, finalTaskCounter.load());
+    }
+}
+
+// Per-tile dependencies in TaskBuilder (without fences)
+TEST(ThreadPoolSimple, TaskBuilderDependencies)
+{
+    const uint32 numIterations = 100;
+    const uint32 numTiles = 16;
+    const uint32 arraySize = 1000;
+
+    for (uint32 iteration = 0; iteration < numIterations; ++iteration)
+    {
+        std::atomic<uint32> stageA[numTiles];
+        std::atomic<uint32> stageB[numTiles];
+        std::atomic<uint32> parallelForCounter(0);
+        std::atomic<uint32> finalTaskCounter(0);
+
+        for (uint32 i = 0; i < numTiles; ++i)
+        {
+            stageA[i] = 0;
+            stageB[i] = 0;
+        }
+
+        Waitable waitable;
+        {
+            TaskBuilder builder(waitable);
+
+            TaskID stageBTasks[numTiles];
+            for (uint32 i = 0; i < numTiles; ++i)
+            {
+                const TaskID stageATask = builder.Task("A", [&stageA, i] (const TaskContext&) { stageA[i]++; });
+
+                stageBTasks[i] = builder.Task("B", [&stageA, &stageB, i] (const TaskContext&)
+                {
+                    EXPECT_EQ(1u, stageA[i].load());
+                    stageB[i]++;
+                }, ArrayView<const TaskID>(&stageATask, 1));
+            }
+
+            ParallelForParams params;
+            params.dependencies = ArrayView<const TaskID>(stageBTasks, numTiles);
+            const TaskID parallelForTask = builder.ParallelFor("ParallelFor", arraySize, [&] (const TaskContext&, uint32)
+            {
+                parallelForCounter++;
+            }, params);
+
+            builder.Task("Final", [&] (const TaskContext&)
+            {
+                for (uint32 i = 0; i < numTiles; ++i)
+                {
+                    EXPECT_EQ(1u, stageB[i].load());
+                }
+                EXPECT_EQ(arraySize, parallelForCounter.load());
+                finalTaskCounter++;
+            }, ArrayView<const TaskID>(&parallelForTask, 1));
+        }
+        waitable.Wait();
+
+        EXPECT_EQ(1u, finalTaskCounter.load());
+    }
+}
+
 // Spawn a child task inside another recursively
 TEST(ThreadPoolSimple, EnqueueInsideTaskRecursive)
 {
@@ -363,3 +486,391 @@ TEST(ThreadPoolSimple, ParallelSort)
         ASSERT_EQ(reference[i], array[i]) << "i=" << std::to_string(i);
     }
 }
+
+// Wait for nested tasks inside a task (more waiting tasks than worker threads)
+TEST(ThreadPoolSimple, NestedWaitInsideTask)
+{
+    ThreadPool& tp = ThreadPool::GetInstance();
+
+    const uint32 numOuterTasks = 4 * tp.GetNumThreads();
+    const uint32 numInnerElements = 100;
+
+    std::atomic<uint32> counter(0);
+
+    Waitable waitable;
+    {
+        TaskBuilder builder(waitable);
+        builder.ParallelFor("Outer", numOuterTasks, [&counter, numInnerElements] (const TaskContext&, uint32)
+        {
+            Waitable innerWaitable;
+            {
+                TaskBuilder innerBuilder(innerWaitable);
+                innerBuilder.ParallelFor("Inner", numInnerElements, [&counter] (const TaskContext&, uint32)
+                {
+                    counter++;
+                });
+            }
+            innerWaitable.Wait();
+            ASSERT_TRUE(innerWaitable.IsFinished());
+        }, ParallelForParams(ParallelForSchedule::Dynamic));
+    }
+    waitable.Wait();
+
+    EXPECT_EQ(numOuterTasks * numInnerElements, counter.load());
+}
+
+// Thread waiting inside a task does not execute tasks of concurrency-limited groups and lower-priority tasks
+TEST(ThreadPoolSimple, NestedWaitSkipsGroupAndLowPriorityTasks)
+{
+    ThreadPool tp(2);
+
+    const TaskGroupID group = tp.CreateTaskGroup("TestGroup", 1);
+    ASSERT_NE(InvalidTaskGroupID, group);
+
+    std::atomic<bool> blockerStarted(false);
+    std::atomic<uint32> waitingThreadID(0);
+    std::atomic<uint32> groupTaskThreadID(0);
+    std::atomic<uint32> lowPriorityTaskThreadID(0);
+    std::atomic<uint32> normalTaskThreadID(0);
+
+    Waitable waitable;
+    {
+        TaskDesc rootDesc;
+        rootDesc.waitable = &waitable;
+        const TaskID rootTask = tp.CreateTask(rootDesc);
+
+        // keep the other worker busy for a while, so the skipped tasks can only be executed by the waiting thread
+        TaskDesc blockerDesc;
+        blockerDesc.parent = rootTask;
+        blockerDesc.function = [&] (const TaskContext&)
+        {
+            blockerStarted = true;
+            Thread::SleepCurrentThread(0.05);
+        };
+        tp.CreateAndDispatchTask(blockerDesc);
+
+        TaskDesc waitingDesc;
+        waitingDesc.parent = rootTask;
+        waitingDesc.priority = 1;
+        waitingDesc.function = [&] (const TaskContext&)
+        {
+            while (!blockerStarted)
+            {
+                Thread::YieldCurrentThread();
+            }
+
+            waitingThreadID = Thread::GetCurrentThreadID();
+
+            Waitable innerWaitable;
+            {
+                TaskDesc innerRootDesc;
+                innerRootDesc.waitable = &innerWaitable;
+                const TaskID innerRootTask = tp.CreateTask(innerRootDesc);
+
+                TaskDesc groupTaskDesc;
+                groupTaskDesc.parent = innerRootTask;
+                groupTaskDesc.group = group;
+                groupTaskDesc.function = [&] (const TaskContext&) { groupTaskThreadID = Thread::GetCurrentThreadID(); };
+                tp.CreateAndDispatchTask(groupTaskDesc);
+
+                TaskDesc lowPriorityTaskDesc;
+                lowPriorityTaskDesc.parent = innerRootTask;
+                lowPriorityTaskDesc.priority = 2;
+                lowPriorityTaskDesc.function = [&] (const TaskContext&) { lowPriorityTaskThreadID = Thread::GetCurrentThreadID(); };
+                tp.CreateAndDispatchTask(lowPriorityTaskDesc);
+
+                TaskDesc normalTaskDesc;
+                normalTaskDesc.parent = innerRootTask;
+                normalTaskDesc.priority = 1;
+                normalTaskDesc.function = [&] (const TaskContext&) { normalTaskThreadID = Thread::GetCurrentThreadID(); };
+                tp.CreateAndDispatchTask(normalTaskDesc);
+
+                tp.DispatchTask(innerRootTask);
+            }
+            innerWaitable.Wait();
+        };
+        tp.CreateAndDispatchTask(waitingDesc);
+
+        tp.DispatchTask(rootTask);
+    }
+    waitable.Wait();
+
+    ASSERT_NE(0u, waitingThreadID.load());
+    EXPECT_NE(0u, groupTaskThreadID.load());
+    EXPECT_NE(0u, lowPriorityTaskThreadID.load());
+    EXPECT_NE(0u, normalTaskThreadID.load());
+    EXPECT_NE(waitingThreadID.load(), groupTaskThreadID.load());
+    EXPECT_NE(waitingThreadID.load(), lowPriorityTaskThreadID.load());
+}
+
+// Tasks with locality hints are executed (also when workers are pinned)
+TEST(ThreadPoolSimple, NumaLocalityHint)
+{
+    ThreadPool tp(4);
+    ASSERT_GE(tp.GetNumNumaNodes(), 1u);
+    tp.PinWorkerThreads();
+
+    const uint32 numTasksPerNode = 1000;
+    std::atomic<uint32> counter(0);
+
+    Waitable waitable;
+    {
+        TaskDesc rootDesc;
+        rootDesc.waitable = &waitable;
+        const TaskID rootTask = tp.CreateTask(rootDesc);
+
+        // the last node index is out of range - such hint is ignored
+        for (uint32 node = 0; node <= tp.GetNumNumaNodes(); ++node)
+        {
+            for (uint32 i = 0; i < numTasksPerNode; ++i)
+            {
+                TaskDesc desc;
+                desc.parent = rootTask;
+                desc.numaNode = static_cast<uint8>(node);
+                desc.function = [&counter] (const TaskContext&) { counter++; };
+                tp.CreateAndDispatchTask(desc);
+            }
+        }
+
+        tp.DispatchTask(rootTask);
+    }
+    waitable.Wait();
+
+    EXPECT_EQ(numTasksPerNode * (tp.GetNumNumaNodes() + 1), counter.load());
+}
+
+// Destroying a pool while its workers are busy looking for tasks in each other's queues
+TEST(ThreadPoolSimple, DestroyWhileStealing)
+{
+    for (uint32 iteration = 0; iteration < 50; ++iteration)
+    {
+        std::atomic<uint32> counter(0);
+
+        ThreadPool tp(4);
+
+        // tasks enqueued from worker threads land in the workers' local queues
+        TaskDesc desc;
+        desc.function = [&counter] (const TaskContext& context)
+        {
+            for (uint32 i = 0; i < 16; ++i)
+            {
+                TaskDesc childDesc;
+                childDesc.function = [&counter] (const TaskContext&) { counter++; };
+                context.pool->CreateAndDispatchTask(childDesc);
+            }
+        };
+
+        for (uint32 i = 0; i < 16; ++i)
+        {
+            tp.CreateAndDispatchTask(desc);
+        }
+
+        // the pool is destroyed with tasks still pending
+    }
+}
+
+// Number of running tasks of a group never exceeds group's limit
+TEST(ThreadPoolSimple, TaskGroupConcurrencyLimit)
+{
+    ThreadPool tp(4);
+
+    const uint32 maxConcurrency = 2;
+    const uint32 numTasks = 200;
+
+    const TaskGroupID group = tp.CreateTaskGroup("TestGroup", maxConcurrency);
+    ASSERT_NE(InvalidTaskGroupID, group);
+    EXPECT_STREQ("TestGroup", tp.GetTaskGroupName(group));
+
+    std::atomic<uint32> numRunning(0);
+    std::atomic<uint32> maxRunning(0);
+    std::atomic<uint32> counter(0);
+
+    Waitable waitable;
+    {
+        TaskDesc rootDesc;
+        rootDesc.waitable = &waitable;
+        const TaskID rootTask = tp.CreateTask(rootDesc);
+
+        for (uint32 i = 0; i < numTasks; ++i)
+        {
+            TaskDesc desc;
+            desc.parent = rootTask;
+            desc.group = group;
+            desc.function = [&] (const TaskContext&)
+            {
+                const uint32 running = ++numRunning;
+                uint32 prevMax = maxRunning.load();
+                while (running > prevMax && !maxRunning.compare_exchange_weak(prevMax, running)) { }
+
+                Thread::YieldCurrentThread();
+
+                counter++;
+                numRunning--;
+            };
+            tp.CreateAndDispatchTask(desc);
+        }
+
+        tp.DispatchTask(rootTask);
+    }
+    waitable.Wait();
+
+    EXPECT_EQ(numTasks, counter.load());
+    EXPECT_LE(maxRunning.load(), maxConcurrency);
+
+    TaskGroupStats stats;
+    ASSERT_TRUE(tp.GetTaskGroupStats(group, stats));
+    EXPECT_EQ(maxConcurrency, stats.maxConcurrency);
+    EXPECT_EQ(0u, stats.numRunning);
+    EXPECT_EQ(0u, stats.queueDepth);
+    EXPECT_LE(stats.maxQueueDepth, numTasks);
+    EXPECT_EQ(numTasks, stats.numExecuted);
+    EXPECT_LE(stats.maxWaitTime, stats.totalWaitTime);
+
+    tp.ResetTaskGroupStats(group);
+    ASSERT_TRUE(tp.GetTaskGroupStats(group, stats));
+    EXPECT_EQ(0u, stats.numExecuted);
+    EXPECT_EQ(0u, stats.numDeferred);
+}
+
+// Cancelled tasks pushed via TaskBuilder are skipped, but waiting for them still works
+TEST(ThreadPoolSimple, TaskBuilderCancellation)
+{
+    const uint32 arraySize = 100000;
+
+    for (const ParallelForSchedule schedule : { ParallelForSchedule::Static, ParallelForSchedule::Dynamic, ParallelForSchedule::Guided })
+    {
+        CancellationToken token;
+        token.Cancel();
+
+        std::atomic<uint32> counter(0);
+
+        Waitable waitable;
+        {
+            TaskBuilder builder(waitable);
+            builder.SetCancellationToken(&token);
+
+            builder.Task("Task", [&counter] (const TaskContext&) { counter++; });
+            builder.ParallelFor("ParallelFor", arraySize, [&counter] (const TaskContext&, uint32) { counter++; }, ParallelForParams(schedule));
+        }
+        waitable.Wait();
+
+        EXPECT_EQ(0u, counter.load());
+    }
+
+    // cancel in the middle of parallel-for
+    {
+        CancellationToken token;
+        std::atomic<uint32> counter(0);
+
+        Waitable waitable;
+        {
+            TaskBuilder builder(waitable);
+            builder.SetCancellationToken(&token);
+
+            builder.ParallelFor("ParallelFor", arraySize, [&counter, &token] (const TaskContext&, uint32)
+            {
+                if (++counter == 100)
+                {
+                    token.Cancel();
+                }
+            }, ParallelForParams(ParallelForSchedule::Dynamic));
+
+            // tasks after the fence are not executed
+            builder.Fence();
+            builder.Task("Task", [&counter] (const TaskContext&) { counter += arraySize; });
+        }
+        waitable.Wait();
+
+        EXPECT_GE(counter.load(), 100u);
+        EXPECT_LT(counter.load(), arraySize);
+    }
+}
+
+#ifdef NFE_ENABLE_TASK_TRACING
+
+TEST(ThreadPoolSimple, TaskTracing)
+{
+    const uint32 numParallelTasks = 4;
+
+    ThreadPool pool(2);
+    TaskTracer& tracer = pool.GetTracer();
+    tracer.Start();
+
+    const auto sleepFunc = [] (uint32 milliseconds)
+    {
+        return [milliseconds] (const TaskContext&)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+        };
+    };
+
+    // "Root" has no callback and waits for all the children; A -> B -> C chain is the critical path
+    Waitable waitable;
+    {
+        TaskDesc desc;
+        desc.debugName = "Root";
+        desc.waitable = &waitable;
+        const TaskID root = pool.CreateTask(desc);
+
+        desc.waitable = nullptr;
+        desc.parent = root;
+
+        desc.debugName = "A";
+        desc.function = sleepFunc(10);
+        const TaskID taskA = pool.CreateTask(desc);
+
+        desc.debugName = "B";
+        desc.dependency = taskA;
+        const TaskID taskB = pool.CreateTask(desc);
+
+        desc.debugName = "C";
+        desc.dependency = taskB;
+        const TaskID taskC = pool.CreateTask(desc);
+
+        desc.debugName = "Parallel";
+        desc.dependency = InvalidTaskID;
+        desc.function = sleepFunc(1);
+        for (uint32 i = 0; i < numParallelTasks; ++i)
+        {
+            pool.CreateAndDispatchTask(desc);
+        }
+
+        pool.DispatchTask(taskC);
+        pool.DispatchTask(taskB);
+        pool.DispatchTask(taskA);
+        pool.DispatchTask(root);
+    }
+    waitable.Wait();
+
+    // tasks created after stopping are not recorded
+    tracer.Stop();
+    pool.CreateAndDispatchTask(TaskDesc());
+
+    TaskTraceSummary summary;
+    tracer.GetSummary(summary);
+
+    EXPECT_EQ(4u + numParallelTasks, summary.numTasks);
+    EXPECT_EQ(0u, summary.numDroppedEvents);
+    EXPECT_EQ(pool.GetNumThreads(), summary.threadUtilization.Size());
+    EXPECT_GE(summary.criticalPathTime, 0.03);
+    EXPECT_LE(summary.criticalPathTime, summary.wallTime);
+    EXPECT_GE(summary.totalWorkTime, summary.criticalPathTime);
+
+    ASSERT_EQ(3u, summary.criticalPath.Size());
+    EXPECT_STREQ("A", summary.criticalPath[0].debugName);
+    EXPECT_STREQ("B", summary.criticalPath[1].debugName);
+    EXPECT_STREQ("C", summary.criticalPath[2].debugName);
+    EXPECT_LE(summary.criticalPath[0].startTime, summary.criticalPath[1].startTime);
+    EXPECT_LE(summary.criticalPath[1].startTime, summary.criticalPath[2].startTime);
+
+    const String tracePath("task_trace.json");
+    ASSERT_TRUE(tracer.ExportChromeTrace(tracePath));
+    {
+        File file(tracePath, AccessMode::Read);
+        ASSERT_TRUE(file.IsOpened());
+        EXPECT_GT(file.GetSize(), 0);
+    }
+    EXPECT_TRUE(FileSystem::Remove(tracePath));
+}
+
+#endif // NFE_ENABLE_TASK_TRACING
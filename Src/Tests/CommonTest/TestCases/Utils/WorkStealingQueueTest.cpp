@@ -0,0 +1,204 @@
+/**
+ * @file
+ * @author Witek902 (witek902@gmail.com)
+ * @brief  Unit tests for WorkStealingQueue.
+ */
+
+#include "PCH.hpp"
+#include "Engine/Common/Utils/WorkStealingQueue.hpp"
+
+#include <thread>
+#include <vector>
+
+using namespace NFE;
+using namespace NFE::Common;
+
+
+TEST(WorkStealingQueue, Empty)
+{
+    WorkStealingQueue<uint32, 16> queue;
+
+    uint32 value = 0;
+    EXPECT_TRUE(queue.Empty());
+    EXPECT_EQ(0u, queue.Size());
+    EXPECT_FALSE(queue.Pop(value));
+    EXPECT_FALSE(queue.Steal(value));
+
+    // failed pop must not corrupt the queue
+    EXPECT_TRUE(queue.Empty());
+    ASSERT_TRUE(queue.Push(1u));
+    EXPECT_EQ(1u, queue.Size());
+}
+
+TEST(WorkStealingQueue, PopAndSteal)
+{
+    WorkStealingQueue<uint32, 16> queue;
+
+    for (uint32 i = 0; i < 6; ++i)
+    {
+        ASSERT_TRUE(queue.Push(i));
+    }
+    EXPECT_EQ(6u, queue.Size());
+
+    uint32 value = 0;
+
+    // owner pops from the bottom (LIFO)
+    ASSERT_TRUE(queue.Pop(value));
+    EXPECT_EQ(5u, value);
+    ASSERT_TRUE(queue.Pop(value));
+    EXPECT_EQ(4u, value);
+
+    // thieves steal from the top (FIFO)
+    ASSERT_TRUE(queue.Steal(value));
+    EXPECT_EQ(0u, value);
+    ASSERT_TRUE(queue.Steal(value));
+    EXPECT_EQ(1u, value);
+
+    ASSERT_TRUE(queue.Pop(value));
+    EXPECT_EQ(3u, value);
+    ASSERT_TRUE(queue.Steal(value));
+    EXPECT_EQ(2u, value);
+
+    EXPECT_TRUE(queue.Empty());
+    EXPECT_FALSE(queue.Pop(value));
+    EXPECT_FALSE(queue.Steal(value));
+}
+
+TEST(WorkStealingQueue, Full)
+{
+    const uint32 capacity = 16;
+    WorkStealingQueue<uint32, capacity> queue;
+
+    for (uint32 i = 0; i < capacity; ++i)
+    {
+        ASSERT_TRUE(queue.Push(i));
+    }
+
+    // the queue has fixed capacity - overflow must be handled by the caller
+    EXPECT_FALSE(queue.Push(capacity));
+    EXPECT_EQ(capacity, queue.Size());
+
+    // stealing frees a slot
+    uint32 value = 0;
+    ASSERT_TRUE(queue.Steal(value));
+    EXPECT_EQ(0u, value);
+    ASSERT_TRUE(queue.Push(capacity));
+    EXPECT_FALSE(queue.Push(capacity + 1));
+
+    for (uint32 i = capacity; i > 0; --i)
+    {
+        ASSERT_TRUE(queue.Pop(value));
+        EXPECT_EQ(i, value);
+    }
+    EXPECT_TRUE(queue.Empty());
+}
+
+TEST(WorkStealingQueue, Wraparound)
+{
+    const uint32 capacity = 8;
+    WorkStealingQueue<uint32, capacity> queue;
+
+    // indices go far beyond the capacity, so the ring buffer wraps around many times
+    uint32 pushed = 0;
+    uint32 stolen = 0;
+    for (uint32 iteration = 0; iteration < 1000; ++iteration)
+    {
+        while (queue.Push(pushed))
+        {
+            pushed++;
+        }
+        ASSERT_EQ(capacity, queue.Size());
+
+        for (uint32 i = 0; i < capacity / 2 + iteration % 3; ++i)
+        {
+            uint32 value = 0;
+            ASSERT_TRUE(queue.Steal(value));
+            ASSERT_EQ(stolen, value);
+            stolen++;
+        }
+    }
+
+    EXPECT_EQ(pushed - stolen, queue.Size());
+}
+
+TEST(WorkStealingQueue, Stress)
+{
+    const uint32 numThieves = 3;
+    const uint32 numElements = 1000000;
+
+    // small capacity forces the owner to hit the full queue and the indices to wrap around
+    WorkStealingQueue<uint32, 64> queue;
+
+    // every element must be taken exactly once
+    std::vector<std::atomic<uint32>> taken(numElements);
+    for (std::atomic<uint32>& counter : taken)
+    {
+        counter = 0;
+    }
+
+    std::atomic<uint32> numTaken(0);
+
+    std::vector<std::thread> thieves;
+    for (uint32 i = 0; i < numThieves; ++i)
+    {
+        thieves.emplace_back([&] ()
+        {
+            while (numTaken.load(std::memory_order_relaxed) < numElements)
+            {
+                uint32 value;
+                if (queue.Steal(value))
+                {
+                    taken[value]++;
+                    numTaken++;
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // owner thread: push elements and pop some of them (racing with thieves for the last element)
+    for (uint32 i = 0; i < numElements; )
+    {
+        const bool pushed = queue.Push(i);
+        if (pushed)
+        {
+            i++;
+        }
+
+        if (!pushed || i % 3 == 0)
+        {
+            uint32 value;
+            if (queue.Pop(value))
+            {
+                taken[value]++;
+                numTaken++;
+            }
+        }
+    }
+
+    // drain the remaining elements
+    uint32 value;
+    while (queue.Pop(value))
+    {
+        taken[value]++;
+        numTaken++;
+    }
+
+    for (std::thread& thread : thieves)
+    {
+        thread.join();
+    }
+
+    uint32 errors = 0;
+    for (const std::atomic<uint32>& counter : taken)
+    {
+        errors += counter.load() != 1;
+    }
+
+    EXPECT_EQ(0u, errors);
+    EXPECT_EQ(numElements, numTaken.load());
+    EXPECT_TRUE(queue.Empty());
+}
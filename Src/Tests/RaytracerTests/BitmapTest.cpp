@@ -1,10 +1,12 @@
 #include "PCH.h"
-#include "../Core/Utils/Bitmap.h"
-#include "../Core/Math/Half.h"
-#include "../Core/Math/Packed.h"
+#include "Engine/Raytracer/Utils/Bitmap.h"
+#include "Engine/Common/Math/Half.hpp"
+#include "Engine/Common/Math/Packed.hpp"
+#include "Engine/Common/Math/Random.hpp"
 
-using namespace rt;
-using namespace rt::math;
+using namespace NFE;
+using namespace NFE::RT;
+using namespace NFE::Math;
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -18,16 +20,26 @@ TEST(BitmapTest, Empty)
     EXPECT_EQ(nullptr, bitmap.GetData());
 }
 
-void CompareVector(const Vector4& ref, const Vector4& val, float maxError = 0.0f)
+static bool InitBitmap(Bitmap& bitmap, uint32 width, uint32 height, Bitmap::Format format, const void* data)
 {
-    const Vector4 diff = Vector4::Abs(ref - val);
+    Bitmap::InitData initData;
+    initData.width = width;
+    initData.height = height;
+    initData.format = format;
+    initData.data = data;
+    return bitmap.Init(initData);
+}
+
+void CompareVector(const Vec4f& ref, const Vec4f& val, float maxError = 0.0f)
+{
+    const Vec4f diff = Vec4f::Abs(ref - val);
     EXPECT_LE(diff.x, maxError);
     EXPECT_LE(diff.y, maxError);
     EXPECT_LE(diff.z, maxError);
     EXPECT_LE(diff.w, maxError);
 }
 
-static void Validate_GetPixel(const Bitmap& bitmap, const Vector4* expectedValues, float maxError = 0.0f, uint32 width = 2, uint32 height = 2)
+static void Validate_GetPixel(const Bitmap& bitmap, const Vec4f* expectedValues, float maxError = 0.0f, uint32 width = 2, uint32 height = 2)
 {
     for (uint32 y = 0; y < height; ++y)
     {
@@ -37,8 +49,8 @@ static void Validate_GetPixel(const Bitmap& bitmap, const Vector4* expectedValue
         {
             SCOPED_TRACE("x=" + std::to_string(x));
 
-            const Vector4& expected = expectedValues[y * width + x];
-            const Vector4 actual = bitmap.GetPixel(x, y);
+            const Vec4f& expected = expectedValues[y * width + x];
+            const Vec4f actual = bitmap.GetPixel(x, y);
 
             EXPECT_NEAR(expected.x, actual.x, maxError);
             EXPECT_NEAR(expected.y, actual.y, maxError);
@@ -48,17 +60,17 @@ static void Validate_GetPixel(const Bitmap& bitmap, const Vector4* expectedValue
     }
 }
 
-static void Validate_GetPixelBlock(const Bitmap& bitmap, const Vector4* expectedValues, float maxError = 0.0f, uint32 x = 0, uint32 y = 0)
+static void Validate_GetPixelBlock(const Bitmap& bitmap, const Vec4f* expectedValues, float maxError = 0.0f, uint32 x = 0, uint32 y = 0)
 {
-    Vector4 actual[4];
+    Vec4f actual[4];
 
-    bitmap.GetPixelBlock(VectorInt4(x, y, x + 1, y + 1), actual);
+    bitmap.GetPixelBlock(Vec4ui(x, y, x + 1, y + 1), actual);
 
     for (uint32 i = 0; i < 4; ++i)
     {
         SCOPED_TRACE("i=" + std::to_string(i));
 
-        const Vector4& expected = expectedValues[i];
+        const Vec4f& expected = expectedValues[i];
 
         EXPECT_NEAR(expected.x, actual[i].x, maxError);
         EXPECT_NEAR(expected.y, actual[i].y, maxError);
@@ -80,16 +92,16 @@ TEST(BitmapTest, Format_R8_UNorm)
             128,
             255,
         };
-        ASSERT_TRUE(bitmap.Init({ 2, 2, Bitmap::Format::R8_UNorm, data }));
+        ASSERT_TRUE(InitBitmap(bitmap, 2, 2, Bitmap::Format::R8_UNorm, data));
         ASSERT_EQ(2u, bitmap.GetStride());
     }
 
-    const Vector4 expected[] =
+    const Vec4f expected[] =
     {
-        Vector4(0.0f),
-        Vector4(13.0f / 255.0f),
-        Vector4(128.0f / 255.0f),
-        Vector4(1.0f),
+        Vec4f(0.0f),
+        Vec4f(13.0f / 255.0f),
+        Vec4f(128.0f / 255.0f),
+        Vec4f(1.0f),
     };
     Validate_GetPixel(bitmap, expected, 0.00001f);
     Validate_GetPixelBlock(bitmap, expected, 0.00001f);
@@ -106,16 +118,16 @@ TEST(BitmapTest, Format_R8G8_UNorm)
             128,    255,
             255,    13
         };
-        ASSERT_TRUE(bitmap.Init({ 2, 2, Bitmap::Format::R8G8_UNorm, data }));
+        ASSERT_TRUE(InitBitmap(bitmap, 2, 2, Bitmap::Format::R8G8_UNorm, data));
         ASSERT_EQ(4u, bitmap.GetStride());
     }
 
-    const Vector4 expected[] =
+    const Vec4f expected[] =
     {
-        Vector4(0.0f, 123.0f / 255.0f),
-        Vector4(13.0f / 255.0f, 0.0f),
-        Vector4(128.0f / 255.0f, 1.0f),
-        Vector4(1.0f, 13.0f / 255.0f),
+        Vec4f(0.0f, 123.0f / 255.0f),
+        Vec4f(13.0f / 255.0f, 0.0f),
+        Vec4f(128.0f / 255.0f, 1.0f),
+        Vec4f(1.0f, 13.0f / 255.0f),
     };
     Validate_GetPixel(bitmap, expected, 0.00001f);
     Validate_GetPixelBlock(bitmap, expected, 0.00001f);
@@ -132,16 +144,16 @@ TEST(BitmapTest, Format_B8G8R8_UNorm)
             128,    255,    201,
             255,    13,     0,
         };
-        ASSERT_TRUE(bitmap.Init({ 2, 2, Bitmap::Format::B8G8R8_UNorm, data }));
+        ASSERT_TRUE(InitBitmap(bitmap, 2, 2, Bitmap::Format::B8G8R8_UNorm, data));
         ASSERT_EQ(6u, bitmap.GetStride());
     }
 
-    const Vector4 expected[] =
+    const Vec4f expected[] =
     {
-        Vector4(17.0f / 255.0f, 123.0f / 255.0f, 0.0f),
-        Vector4(1.0f, 0.0f, 13.0f / 255.0f),
-        Vector4(201.0f / 255.0f, 1.0f, 128.0f / 255.0f),
-        Vector4(0.0f, 13.0f / 255.0f, 1.0f),
+        Vec4f(17.0f / 255.0f, 123.0f / 255.0f, 0.0f),
+        Vec4f(1.0f, 0.0f, 13.0f / 255.0f),
+        Vec4f(201.0f / 255.0f, 1.0f, 128.0f / 255.0f),
+        Vec4f(0.0f, 13.0f / 255.0f, 1.0f),
     };
     Validate_GetPixel(bitmap, expected, 0.00001f);
     Validate_GetPixelBlock(bitmap, expected, 0.00001f);
@@ -158,16 +170,16 @@ TEST(BitmapTest, Format_B8G8R8A8_UNorm)
             128,    255,    201,    0,
             255,    13,     0,      190,
         };
-        ASSERT_TRUE(bitmap.Init({ 2, 2, Bitmap::Format::B8G8R8A8_UNorm, data }));
+        ASSERT_TRUE(InitBitmap(bitmap, 2, 2, Bitmap::Format::B8G8R8A8_UNorm, data));
         ASSERT_EQ(8u, bitmap.GetStride());
     }
 
-    const Vector4 expected[] =
+    const Vec4f expected[] =
     {
-        Vector4(17.0f / 255.0f, 123.0f / 255.0f, 0.0f, 1.0f),
-        Vector4(1.0f, 0.0f, 13.0f / 255.0f, 30.0f / 255.0f),
-        Vector4(201.0f / 255.0f, 1.0f, 128.0f / 255.0f, 0.0f),
-        Vector4(0.0f, 13.0f / 255.0f, 1.0f, 190.0f / 255.0f),
+        Vec4f(17.0f / 255.0f, 123.0f / 255.0f, 0.0f, 1.0f),
+        Vec4f(1.0f, 0.0f, 13.0f / 255.0f, 30.0f / 255.0f),
+        Vec4f(201.0f / 255.0f, 1.0f, 128.0f / 255.0f, 0.0f),
+        Vec4f(0.0f, 13.0f / 255.0f, 1.0f, 190.0f / 255.0f),
     };
     Validate_GetPixel(bitmap, expected, 0.00001f);
     Validate_GetPixelBlock(bitmap, expected, 0.00001f);
@@ -179,23 +191,23 @@ TEST(BitmapTest, Format_B5G6R5_UNorm)
 {
     Bitmap bitmap;
     {
-        const Packed565 data[] =
+        const Packed_5_6_5 data[] =
         {
-            Packed565( 0, 59, 29),
-            Packed565( 2,  0, 31),
-            Packed565(29, 63,  2),
-            Packed565(31,  7,  0),
+            Packed_5_6_5( 0, 59, 29),
+            Packed_5_6_5( 2,  0, 31),
+            Packed_5_6_5(29, 63,  2),
+            Packed_5_6_5(31,  7,  0),
         };
-        ASSERT_TRUE(bitmap.Init({ 2, 2, Bitmap::Format::B5G6R5_UNorm, data }));
+        ASSERT_TRUE(InitBitmap(bitmap, 2, 2, Bitmap::Format::B5G6R5_UNorm, data));
         ASSERT_EQ(4u, bitmap.GetStride());
     }
 
-    const Vector4 expected[] =
+    const Vec4f expected[] =
     {
-        Vector4(29.0f / 31.0f, 59.0f / 63.0f, 0.0f / 31.0f),
-        Vector4(31.0f / 31.0f, 0.0f / 63.0f, 2.0f / 31.0f),
-        Vector4(2.0f / 31.0f, 63.0f / 63.0f, 29.0f / 31.0f),
-        Vector4(0.0f / 31.0f, 7.0f / 63.0f, 31.0f / 31.0f),
+        Vec4f(29.0f / 31.0f, 59.0f / 63.0f, 0.0f / 31.0f),
+        Vec4f(31.0f / 31.0f, 0.0f / 63.0f, 2.0f / 31.0f),
+        Vec4f(2.0f / 31.0f, 63.0f / 63.0f, 29.0f / 31.0f),
+        Vec4f(0.0f / 31.0f, 7.0f / 63.0f, 31.0f / 31.0f),
     };
     Validate_GetPixel(bitmap, expected, 0.001f);
     Validate_GetPixelBlock(bitmap, expected, 0.001f);
@@ -214,16 +226,16 @@ TEST(BitmapTest, Format_R16_UNorm)
             47813,
             65535,
         };
-        ASSERT_TRUE(bitmap.Init({ 2, 2, Bitmap::Format::R16_UNorm, data }));
+        ASSERT_TRUE(InitBitmap(bitmap, 2, 2, Bitmap::Format::R16_UNorm, data));
         ASSERT_EQ(4u, bitmap.GetStride());
     }
 
-    const Vector4 expected[] =
+    const Vec4f expected[] =
     {
-        Vector4(0.0f),
-        Vector4(120.0f / 65535.0f),
-        Vector4(47813.0f / 65535.0f),
-        Vector4(1.0f),
+        Vec4f(0.0f),
+        Vec4f(120.0f / 65535.0f),
+        Vec4f(47813.0f / 65535.0f),
+        Vec4f(1.0f),
     };
     Validate_GetPixel(bitmap, expected, 0.00001f);
     Validate_GetPixelBlock(bitmap, expected, 0.00001f);
@@ -240,16 +252,16 @@ TEST(BitmapTest, Format_R16G16_UNorm)
             47813,  65535,
             65535,  47813,
         };
-        ASSERT_TRUE(bitmap.Init({ 2, 2, Bitmap::Format::R16G16_UNorm, data }));
+        ASSERT_TRUE(InitBitmap(bitmap, 2, 2, Bitmap::Format::R16G16_UNorm, data));
         ASSERT_EQ(8u, bitmap.GetStride());
     }
 
-    const Vector4 expected[] =
+    const Vec4f expected[] =
     {
-        Vector4(0.0f, 120.0f) / 65535.0f,
-        Vector4(120.0f, 0.0f) / 65535.0f,
-        Vector4(47813.0f, 65535.0f) / 65535.0f,
-        Vector4(65535.0f, 47813.0f) / 65535.0f,
+        Vec4f(0.0f, 120.0f) / 65535.0f,
+        Vec4f(120.0f, 0.0f) / 65535.0f,
+        Vec4f(47813.0f, 65535.0f) / 65535.0f,
+        Vec4f(65535.0f, 47813.0f) / 65535.0f,
     };
     Validate_GetPixel(bitmap, expected, 0.00001f);
     Validate_GetPixelBlock(bitmap, expected, 0.00001f);
@@ -266,16 +278,16 @@ TEST(BitmapTest, Format_R16G16B16A16_UNorm)
             47813,  65535,  120,    0,
             65535,  47813,  0,      120,
         };
-        ASSERT_TRUE(bitmap.Init({ 2, 2, Bitmap::Format::R16G16B16A16_UNorm, data }));
+        ASSERT_TRUE(InitBitmap(bitmap, 2, 2, Bitmap::Format::R16G16B16A16_UNorm, data));
         ASSERT_EQ(16u, bitmap.GetStride());
     }
 
-    const Vector4 expected[] =
+    const Vec4f expected[] =
     {
-        Vector4(0.0f, 120.0f, 47813.0f, 65535.0f) / 65535.0f,
-        Vector4(120.0f, 0.0f, 65535.0f, 47813.0f) / 65535.0f,
-        Vector4(47813.0f, 65535.0f, 120.0f, 0.0f) / 65535.0f,
-        Vector4(65535.0f, 47813.0f, 0.0f, 120.0f) / 65535.0f,
+        Vec4f(0.0f, 120.0f, 47813.0f, 65535.0f) / 65535.0f,
+        Vec4f(120.0f, 0.0f, 65535.0f, 47813.0f) / 65535.0f,
+        Vec4f(47813.0f, 65535.0f, 120.0f, 0.0f) / 65535.0f,
+        Vec4f(65535.0f, 47813.0f, 0.0f, 120.0f) / 65535.0f,
     };
     Validate_GetPixel(bitmap, expected, 0.00001f);
     Validate_GetPixelBlock(bitmap, expected, 0.00001f);
@@ -294,16 +306,16 @@ TEST(BitmapTest, Format_R32_Float)
             0.2f,
             10000.0f
         };
-        ASSERT_TRUE(bitmap.Init({ 2, 2, Bitmap::Format::R32_Float, data }));
+        ASSERT_TRUE(InitBitmap(bitmap, 2, 2, Bitmap::Format::R32_Float, data));
         ASSERT_EQ(8u, bitmap.GetStride());
     }
 
-    const Vector4 expected[] =
+    const Vec4f expected[] =
     {
-        Vector4(0.0f),
-        Vector4(-123.0f),
-        Vector4(0.2f),
-        Vector4(10000.0f),
+        Vec4f(0.0f),
+        Vec4f(-123.0f),
+        Vec4f(0.2f),
+        Vec4f(10000.0f),
     };
     Validate_GetPixel(bitmap, expected, 0.00001f);
     Validate_GetPixelBlock(bitmap, expected, 0.00001f);
@@ -320,16 +332,16 @@ TEST(BitmapTest, Format_R32G32_Float)
             0.2f,       1000.0f,
             10000.0f,   0.25f,
         };
-        ASSERT_TRUE(bitmap.Init({ 2, 2, Bitmap::Format::R32G32_Float, data }));
+        ASSERT_TRUE(InitBitmap(bitmap, 2, 2, Bitmap::Format::R32G32_Float, data));
         ASSERT_EQ(16u, bitmap.GetStride());
     }
 
-    const Vector4 expected[] =
+    const Vec4f expected[] =
     {
-        Vector4(0.0f, 123.0f),
-        Vector4(-123.0f, 0.0f),
-        Vector4(0.2f, 1000.0f),
-        Vector4(10000.0f, 0.25f),
+        Vec4f(0.0f, 123.0f),
+        Vec4f(-123.0f, 0.0f),
+        Vec4f(0.2f, 1000.0f),
+        Vec4f(10000.0f, 0.25f),
     };
     Validate_GetPixel(bitmap, expected, 0.00001f);
     Validate_GetPixelBlock(bitmap, expected, 0.00001f);
@@ -346,16 +358,16 @@ TEST(BitmapTest, Format_R32G32B32_Float)
             0.2f,       1000.0f,    0.0f,
             10000.0f,   0.25f,      -10.0f,
         };
-        ASSERT_TRUE(bitmap.Init({ 2, 2, Bitmap::Format::R32G32B32_Float, data }));
+        ASSERT_TRUE(InitBitmap(bitmap, 2, 2, Bitmap::Format::R32G32B32_Float, data));
         ASSERT_EQ(24u, bitmap.GetStride());
     }
 
-    const Vector4 expected[] =
+    const Vec4f expected[] =
     {
-        Vector4(0.0f, 123.0f, 100.0f),
-        Vector4(-123.0f, 0.0f, 0.1f),
-        Vector4(0.2f, 1000.0f, 0.0f),
-        Vector4(10000.0f, 0.25f, -10.0f),
+        Vec4f(0.0f, 123.0f, 100.0f),
+        Vec4f(-123.0f, 0.0f, 0.1f),
+        Vec4f(0.2f, 1000.0f, 0.0f),
+        Vec4f(10000.0f, 0.25f, -10.0f),
     };
     Validate_GetPixel(bitmap, expected, 0.00001f);
     Validate_GetPixelBlock(bitmap, expected, 0.00001f);
@@ -372,16 +384,16 @@ TEST(BitmapTest, Format_R32G32B32A32_Float)
             0.2f,       1000.0f,    0.0f,       0.8f,
             10000.0f,   0.25f,      -10.0f,     0.0f,
         };
-        ASSERT_TRUE(bitmap.Init({ 2, 2, Bitmap::Format::R32G32B32A32_Float, data }));
+        ASSERT_TRUE(InitBitmap(bitmap, 2, 2, Bitmap::Format::R32G32B32A32_Float, data));
         ASSERT_EQ(32u, bitmap.GetStride());
     }
 
-    const Vector4 expected[] =
+    const Vec4f expected[] =
     {
-        Vector4(0.0f, 123.0f, 100.0f, -0.1f),
-        Vector4(-123.0f, 0.0f, 0.1f, 200.0f),
-        Vector4(0.2f, 1000.0f, 0.0f, 0.8f),
-        Vector4(10000.0f, 0.25f, -10.0f, 0.0f),
+        Vec4f(0.0f, 123.0f, 100.0f, -0.1f),
+        Vec4f(-123.0f, 0.0f, 0.1f, 200.0f),
+        Vec4f(0.2f, 1000.0f, 0.0f, 0.8f),
+        Vec4f(10000.0f, 0.25f, -10.0f, 0.0f),
     };
     Validate_GetPixel(bitmap, expected, 0.00001f);
     Validate_GetPixelBlock(bitmap, expected, 0.00001f);
@@ -400,16 +412,16 @@ TEST(BitmapTest, Format_R16_Half)
             0.2f,
             1000.0f
         };
-        ASSERT_TRUE(bitmap.Init({ 2, 2, Bitmap::Format::R16_Half, data }));
+        ASSERT_TRUE(InitBitmap(bitmap, 2, 2, Bitmap::Format::R16_Half, data));
         ASSERT_EQ(4u, bitmap.GetStride());
     }
 
-    const Vector4 expected[] =
+    const Vec4f expected[] =
     {
-        Vector4(0.0f),
-        Vector4(-123.0f),
-        Vector4(0.2f),
-        Vector4(1000.0f),
+        Vec4f(0.0f),
+        Vec4f(-123.0f),
+        Vec4f(0.2f),
+        Vec4f(1000.0f),
     };
     Validate_GetPixel(bitmap, expected, 0.001f);
     Validate_GetPixelBlock(bitmap, expected, 0.001f);
@@ -426,16 +438,16 @@ TEST(BitmapTest, Format_R16G16_Half)
             0.2f,       1000.0f,
             1000.0f,    0.25f,
         };
-        ASSERT_TRUE(bitmap.Init({ 2, 2, Bitmap::Format::R16G16_Half, data }));
+        ASSERT_TRUE(InitBitmap(bitmap, 2, 2, Bitmap::Format::R16G16_Half, data));
         ASSERT_EQ(8u, bitmap.GetStride());
     }
 
-    const Vector4 expected[] =
+    const Vec4f expected[] =
     {
-        Vector4(0.0f, 123.0f),
-        Vector4(-123.0f, 0.0f),
-        Vector4(0.2f, 1000.0f),
-        Vector4(1000.0f, 0.25f),
+        Vec4f(0.0f, 123.0f),
+        Vec4f(-123.0f, 0.0f),
+        Vec4f(0.2f, 1000.0f),
+        Vec4f(1000.0f, 0.25f),
     };
     Validate_GetPixel(bitmap, expected, 0.001f);
     Validate_GetPixelBlock(bitmap, expected, 0.001f);
@@ -452,16 +464,16 @@ TEST(BitmapTest, Format_R16G16B16_Half)
             0.2f,       1000.0f,    0.0f,
             1000.0f,    0.25f,      -10.0f,
         };
-        ASSERT_TRUE(bitmap.Init({ 2, 2, Bitmap::Format::R16G16B16_Half, data }));
+        ASSERT_TRUE(InitBitmap(bitmap, 2, 2, Bitmap::Format::R16G16B16_Half, data));
         ASSERT_EQ(12u, bitmap.GetStride());
     }
 
-    const Vector4 expected[] =
+    const Vec4f expected[] =
     {
-        Vector4(0.0f, 123.0f, 100.0f),
-        Vector4(-123.0f, 0.0f, 0.1f),
-        Vector4(0.2f, 1000.0f, 0.0f),
-        Vector4(1000.0f, 0.25f, -10.0f),
+        Vec4f(0.0f, 123.0f, 100.0f),
+        Vec4f(-123.0f, 0.0f, 0.1f),
+        Vec4f(0.2f, 1000.0f, 0.0f),
+        Vec4f(1000.0f, 0.25f, -10.0f),
     };
     Validate_GetPixel(bitmap, expected, 0.001f);
     Validate_GetPixelBlock(bitmap, expected, 0.001f);
@@ -478,17 +490,259 @@ TEST(BitmapTest, Format_R16G16B16A16_Half)
             0.2f,       1000.0f,    0.0f,       0.8f,
             1000.0f,    0.25f,      -10.0f,     0.0f,
         };
-        ASSERT_TRUE(bitmap.Init({ 2, 2, Bitmap::Format::R16G16B16A16_Half, data }));
+        ASSERT_TRUE(InitBitmap(bitmap, 2, 2, Bitmap::Format::R16G16B16A16_Half, data));
         ASSERT_EQ(16u, bitmap.GetStride());
     }
 
-    const Vector4 expected[] =
+    const Vec4f expected[] =
     {
-        Vector4(0.0f, 123.0f, 100.0f, -0.1f),
-        Vector4(-123.0f, 0.0f, 0.1f, 200.0f),
-        Vector4(0.2f, 1000.0f, 0.0f, 0.8f),
-        Vector4(1000.0f, 0.25f, -10.0f, 0.0f),
+        Vec4f(0.0f, 123.0f, 100.0f, -0.1f),
+        Vec4f(-123.0f, 0.0f, 0.1f, 200.0f),
+        Vec4f(0.2f, 1000.0f, 0.0f, 0.8f),
+        Vec4f(1000.0f, 0.25f, -10.0f, 0.0f),
     };
     Validate_GetPixel(bitmap, expected, 0.001f);
     Validate_GetPixelBlock(bitmap, expected, 0.001f);
 }
+
+TEST(BitmapTest, Format_R11G11B10_Float)
+{
+    Bitmap bitmap;
+    {
+        PackedUFloat3_11_11_10 data[4];
+
+        // normal values (z channel has 5-bit mantissa)
+        data[0].xe = 15; data[0].xm = 0;
+        data[0].ye = 14; data[0].ym = 32;
+        data[0].ze = 16; data[0].zm = 16;
+
+        // denormal values
+        data[1].xe = 0; data[1].xm = 32;
+        data[1].ye = 0; data[1].ym = 1;
+        data[1].ze = 0; data[1].zm = 16;
+
+        // zero
+        data[2].v = 0;
+
+        // maximum values
+        data[3].xe = 30; data[3].xm = 63;
+        data[3].ye = 30; data[3].ym = 0;
+        data[3].ze = 30; data[3].zm = 31;
+
+        ASSERT_TRUE(InitBitmap(bitmap, 2, 2, Bitmap::Format::R11G11B10_Float, data));
+        ASSERT_EQ(8u, bitmap.GetStride());
+    }
+
+    const Vec4f expected[] =
+    {
+        Vec4f(1.0f, 0.75f, 3.0f),
+        Vec4f(32.0f / 1048576.0f, 1.0f / 1048576.0f, 16.0f / 524288.0f),
+        Vec4f(0.0f),
+        Vec4f(65024.0f, 32768.0f, 64512.0f),
+    };
+    Validate_GetPixel(bitmap, expected, 0.0f);
+    Validate_GetPixelBlock(bitmap, expected, 0.0f);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+struct FormatInfo
+{
+    Bitmap::Format format;
+    uint32 numChannels;     // number of channels stored in the format
+    float maxEncodingError; // for values in the test range
+    bool isNormalized;      // values are clamped to 0...1 range
+    bool isUnsigned;        // negative values are clamped to zero
+};
+
+const FormatInfo TestedFormats[] =
+{
+    { Bitmap::Format::R8_UNorm,             1, 0.5f / 255.0f,       true,   true    },
+    { Bitmap::Format::R8G8_UNorm,           2, 0.5f / 255.0f,       true,   true    },
+    { Bitmap::Format::B8G8R8_UNorm,         3, 0.5f / 255.0f,       true,   true    },
+    { Bitmap::Format::B8G8R8A8_UNorm,       4, 0.5f / 255.0f,       true,   true    },
+    { Bitmap::Format::R8G8B8A8_UNorm,       4, 0.5f / 255.0f,       true,   true    },
+    { Bitmap::Format::R10G10B10A2_UNorm,    4, 0.5f / 3.0f,         true,   true    },
+    { Bitmap::Format::B5G6R5_UNorm,         3, 0.5f / 31.0f,        true,   true    },
+    { Bitmap::Format::B4G4R4A4_UNorm,       4, 0.5f / 15.0f,        true,   true    },
+    { Bitmap::Format::R16_UNorm,            1, 0.5f / 65535.0f,     true,   true    },
+    { Bitmap::Format::R16G16_UNorm,         2, 0.5f / 65535.0f,     true,   true    },
+    { Bitmap::Format::R16G16B16A16_UNorm,   4, 0.5f / 65535.0f,     true,   true    },
+    { Bitmap::Format::R32_Float,            1, 0.0f,                false,  false   },
+    { Bitmap::Format::R32G32_Float,         2, 0.0f,                false,  false   },
+    { Bitmap::Format::R32G32B32_Float,      3, 0.0f,                false,  false   },
+    { Bitmap::Format::R32G32B32A32_Float,   4, 0.0f,                false,  false   },
+    { Bitmap::Format::R11G11B10_Float,      3, 0.04f,               false,  true    },
+    { Bitmap::Format::R16_Half,             1, 0.001f,              false,  false   },
+    { Bitmap::Format::R16G16_Half,          2, 0.001f,              false,  false   },
+    { Bitmap::Format::R16G16B16_Half,       3, 0.001f,              false,  false   },
+    { Bitmap::Format::R16G16B16A16_Half,    4, 0.001f,              false,  false   },
+    { Bitmap::Format::R9G9B9E5_SharedExp,   3, 0.01f,               false,  true    },
+};
+
+// not a multiple of SIMD width, so both vectorized loops and scalar tails are executed
+const uint32 TestBitmapWidth = 37;
+const uint32 TestBitmapHeight = 3;
+
+bool IsSameValue(float expected, float actual, float maxError)
+{
+    if (expected == actual)
+    {
+        return true;
+    }
+
+    // random bit patterns can encode NaNs
+    if (expected != expected && actual != actual)
+    {
+        return true;
+    }
+
+    return Abs(expected - actual) <= maxError;
+}
+
+void ExpectSamePixel(const Vec4f& expected, const Vec4f& actual, uint32 numChannels, float maxError)
+{
+    for (uint32 i = 0; i < numChannels; ++i)
+    {
+        EXPECT_PRED3(IsSameValue, expected[i], actual[i], maxError) << "channel=" << i;
+    }
+}
+
+// fill bitmap with random bytes
+void InitRandomBitmap(Bitmap& bitmap, Bitmap::Format format, Random& random)
+{
+    std::vector<uint8> data(Bitmap::ComputeDataStride(TestBitmapWidth, format) * TestBitmapHeight);
+    for (uint8& value : data)
+    {
+        value = random.Get<uint8>();
+    }
+
+    ASSERT_TRUE(InitBitmap(bitmap, TestBitmapWidth, TestBitmapHeight, format, data.data()));
+}
+
+} // namespace
+
+TEST(BitmapTest, DecodePixels)
+{
+    Random random;
+
+    for (const FormatInfo& info : TestedFormats)
+    {
+        SCOPED_TRACE(Bitmap::FormatToString(info.format));
+
+        Bitmap bitmap;
+        InitRandomBitmap(bitmap, info.format, random);
+
+        std::vector<Vec4f> row(TestBitmapWidth);
+        std::vector<Vec4f> singlePixel(1);
+
+        for (uint32 y = 0; y < TestBitmapHeight; ++y)
+        {
+            SCOPED_TRACE("y=" + std::to_string(y));
+
+            ASSERT_TRUE(bitmap.ReadRow(y, row.data()));
+
+            for (uint32 x = 0; x < TestBitmapWidth; ++x)
+            {
+                SCOPED_TRACE("x=" + std::to_string(x));
+
+                // bulk conversion must match the per-pixel path in all the channels
+                ExpectSamePixel(bitmap.GetPixel(x, y), row[x], 4, 1.0e-6f);
+
+                // decode the same pixel alone (scalar path)
+                const uint8* pixelData = bitmap.GetData() + bitmap.GetStride() * y + x * Bitmap::BitsPerPixel(info.format) / 8;
+                ASSERT_TRUE(Bitmap::DecodePixels(info.format, pixelData, singlePixel.data(), 1));
+                ExpectSamePixel(row[x], singlePixel[0], 4, 0.0f);
+            }
+        }
+    }
+}
+
+TEST(BitmapTest, DecodePixels_Palette)
+{
+    Random random;
+
+    const uint32 paletteSize = 256;
+    std::vector<uint8> palette(4 * paletteSize);
+    for (uint8& value : palette)
+    {
+        value = random.Get<uint8>();
+    }
+
+    std::vector<uint8> indices(TestBitmapWidth);
+    std::vector<uint8> colors(4 * TestBitmapWidth);
+    for (uint32 i = 0; i < TestBitmapWidth; ++i)
+    {
+        indices[i] = random.Get<uint8>();
+        memcpy(&colors[4 * i], &palette[4 * indices[i]], 4);
+    }
+
+    std::vector<Vec4f> expected(TestBitmapWidth);
+    std::vector<Vec4f> actual(TestBitmapWidth);
+    ASSERT_TRUE(Bitmap::DecodePixels(Bitmap::Format::B8G8R8A8_UNorm, colors.data(), expected.data(), TestBitmapWidth));
+    ASSERT_TRUE(Bitmap::DecodePixels(Bitmap::Format::B8G8R8A8_UNorm_Palette, indices.data(), actual.data(), TestBitmapWidth, palette.data()));
+
+    for (uint32 i = 0; i < TestBitmapWidth; ++i)
+    {
+        SCOPED_TRACE("i=" + std::to_string(i));
+        ExpectSamePixel(expected[i], actual[i], 4, 0.0f);
+    }
+
+    // palette is required
+    EXPECT_FALSE(Bitmap::DecodePixels(Bitmap::Format::B8G8R8A8_UNorm_Palette, indices.data(), actual.data(), TestBitmapWidth));
+}
+
+TEST(BitmapTest, EncodePixels)
+{
+    Random random;
+
+    // values slightly out of 0...1 range to test clamping
+    std::vector<Vec4f> pixels(TestBitmapWidth * TestBitmapHeight);
+    for (Vec4f& pixel : pixels)
+    {
+        pixel = random.GetVec4f() * 1.5f - Vec4f(0.25f);
+    }
+
+    for (const FormatInfo& info : TestedFormats)
+    {
+        SCOPED_TRACE(Bitmap::FormatToString(info.format));
+
+        Bitmap bitmap;
+        ASSERT_TRUE(InitBitmap(bitmap, TestBitmapWidth, TestBitmapHeight, info.format, nullptr));
+
+        const uint32 bytesPerPixel = Bitmap::BitsPerPixel(info.format) / 8;
+        std::vector<uint8> singlePixelData(bytesPerPixel);
+
+        for (uint32 y = 0; y < TestBitmapHeight; ++y)
+        {
+            SCOPED_TRACE("y=" + std::to_string(y));
+
+            const Vec4f* rowPixels = pixels.data() + y * TestBitmapWidth;
+            ASSERT_TRUE(bitmap.WriteRow(y, rowPixels));
+
+            for (uint32 x = 0; x < TestBitmapWidth; ++x)
+            {
+                SCOPED_TRACE("x=" + std::to_string(x));
+
+                Vec4f expected = rowPixels[x];
+                if (info.isNormalized)
+                {
+                    expected = Vec4f::Clamp(expected, Vec4f::Zero(), Vec4f(1.0f));
+                }
+                else if (info.isUnsigned)
+                {
+                    expected = Vec4f::Max(expected, Vec4f::Zero());
+                }
+
+                ExpectSamePixel(expected, bitmap.GetPixel(x, y), info.numChannels, info.maxEncodingError);
+
+                // encoding the same pixel alone (scalar path) must produce exactly the same bits
+                ASSERT_TRUE(Bitmap::EncodePixels(info.format, rowPixels + x, singlePixelData.data(), 1));
+                const uint8* pixelData = bitmap.GetData() + bitmap.GetStride() * y + x * bytesPerPixel;
+                EXPECT_EQ(0, memcmp(pixelData, singlePixelData.data(), bytesPerPixel));
+            }
+        }
+    }
+}
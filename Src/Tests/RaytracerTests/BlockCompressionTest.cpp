@@ -0,0 +1,339 @@
+#include "PCH.h"
+#include "Engine/Raytracer/Utils/Bitmap.h"
+#include "Engine/Common/Math/Random.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace NFE;
+using namespace NFE::RT;
+using namespace NFE::Math;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+// reference (scalar) decoders, following the BC format specification
+
+const Vec4f DecodeRGB565(uint16 color)
+{
+    return Vec4f(static_cast<float>(color >> 11u) / 31.0f,
+                 static_cast<float>((color >> 5u) & 0x3Fu) / 63.0f,
+                 static_cast<float>(color & 0x1Fu) / 31.0f,
+                 1.0f);
+}
+
+const Vec4f DecodeBC1Texel(const uint8* blockData, uint32 texelIndex)
+{
+    uint16 intColor0, intColor1;
+    uint32 code;
+    memcpy(&intColor0, blockData + 0, sizeof(uint16));
+    memcpy(&intColor1, blockData + 2, sizeof(uint16));
+    memcpy(&code, blockData + 4, sizeof(uint32));
+
+    const Vec4f color0 = DecodeRGB565(intColor0);
+    const Vec4f color1 = DecodeRGB565(intColor1);
+
+    switch ((code >> (2u * texelIndex)) & 0x3u)
+    {
+    case 0: return color0;
+    case 1: return color1;
+    case 2: return intColor0 > intColor1 ? (2.0f * color0 + color1) / 3.0f : (color0 + color1) / 2.0f;
+    default: return intColor0 > intColor1 ? (color0 + 2.0f * color1) / 3.0f : Vec4f::Zero();
+    }
+}
+
+float DecodeBC4Texel(const uint8* blockData, uint32 texelIndex)
+{
+    const uint32 intColor0 = blockData[0];
+    const uint32 intColor1 = blockData[1];
+    const float color0 = static_cast<float>(intColor0) / 255.0f;
+    const float color1 = static_cast<float>(intColor1) / 255.0f;
+
+    uint64 code = 0;
+    memcpy(&code, blockData + 2, 6);
+    const uint32 index = static_cast<uint32>(code >> (3u * texelIndex)) & 0x7u;
+
+    if (index == 0) return color0;
+    if (index == 1) return color1;
+
+    if (intColor0 > intColor1)
+    {
+        return (static_cast<float>(8u - index) * color0 + static_cast<float>(index - 1u) * color1) / 7.0f;
+    }
+
+    if (index == 6) return 0.0f;
+    if (index == 7) return 1.0f;
+    return (static_cast<float>(6u - index) * color0 + static_cast<float>(index - 1u) * color1) / 5.0f;
+}
+
+const Vec4f DecodeReferenceTexel(Bitmap::Format format, const uint8* data, uint32 x, uint32 y, uint32 width)
+{
+    const uint32 blockSize = format == Bitmap::Format::BC5 ? 16u : 8u;
+    const uint32 blocksInRow = (width + 3u) / 4u;
+    const uint8* blockData = data + blockSize * (blocksInRow * (y / 4u) + (x / 4u));
+    const uint32 texelIndex = 4u * (y % 4u) + (x % 4u);
+
+    switch (format)
+    {
+    case Bitmap::Format::BC1:
+        return DecodeBC1Texel(blockData, texelIndex);
+    case Bitmap::Format::BC4:
+    {
+        const float value = DecodeBC4Texel(blockData, texelIndex);
+        return Vec4f(value, value, value, 1.0f);
+    }
+    case Bitmap::Format::BC5:
+        // NOTE: channels are swapped, as in the decoder
+        return Vec4f(DecodeBC4Texel(blockData + 8, texelIndex), DecodeBC4Texel(blockData, texelIndex), 0.0f, 1.0f);
+    default:
+        return Vec4f::Zero();
+    }
+}
+
+void ExpectNearVector(const Vec4f& expected, const Vec4f& actual, float maxError = 1.0e-5f)
+{
+    EXPECT_NEAR(expected.x, actual.x, maxError);
+    EXPECT_NEAR(expected.y, actual.y, maxError);
+    EXPECT_NEAR(expected.z, actual.z, maxError);
+    EXPECT_NEAR(expected.w, actual.w, maxError);
+}
+
+bool InitRandomBitmap(Bitmap& bitmap, uint32 width, uint32 height, Bitmap::Format format, Random& random)
+{
+    Bitmap::InitData initData;
+    initData.width = width;
+    initData.height = height;
+    initData.format = format;
+
+    if (!bitmap.Init(initData))
+    {
+        return false;
+    }
+
+    uint8* data = bitmap.GetData();
+    for (size_t i = 0; i < bitmap.GetDataSize(); ++i)
+    {
+        data[i] = random.Get<uint8>();
+    }
+
+    return true;
+}
+
+void ValidateBitmap(const Bitmap& bitmap)
+{
+    for (uint32 y = 0; y < bitmap.GetHeight(); ++y)
+    {
+        for (uint32 x = 0; x < bitmap.GetWidth(); ++x)
+        {
+            SCOPED_TRACE("x=" + std::to_string(x) + ", y=" + std::to_string(y));
+
+            const Vec4f expected = DecodeReferenceTexel(bitmap.GetFormat(), bitmap.GetData(), x, y, bitmap.GetWidth());
+            ExpectNearVector(expected, bitmap.GetPixel(x, y));
+        }
+    }
+}
+
+const Bitmap::Format TestedFormats[] =
+{
+    Bitmap::Format::BC1,
+    Bitmap::Format::BC4,
+    Bitmap::Format::BC5,
+};
+
+} // namespace
+
+TEST(BlockCompressionTest, DataSize)
+{
+    // dimensions that are not multiple of 4 are rounded up to full blocks
+    EXPECT_EQ(8u, Bitmap::ComputeDataStride(1, Bitmap::Format::BC1));
+    EXPECT_EQ(8u, Bitmap::ComputeDataStride(4, Bitmap::Format::BC4));
+    EXPECT_EQ(16u, Bitmap::ComputeDataStride(5, Bitmap::Format::BC4));
+    EXPECT_EQ(32u, Bitmap::ComputeDataStride(6, Bitmap::Format::BC5));
+
+    EXPECT_EQ(1u, Bitmap::ComputeNumDataRows(1, Bitmap::Format::BC1));
+    EXPECT_EQ(1u, Bitmap::ComputeNumDataRows(4, Bitmap::Format::BC1));
+    EXPECT_EQ(2u, Bitmap::ComputeNumDataRows(5, Bitmap::Format::BC1));
+
+    Bitmap bitmap;
+    Random random;
+    ASSERT_TRUE(InitRandomBitmap(bitmap, 6, 5, Bitmap::Format::BC4, random));
+    EXPECT_EQ(16u, bitmap.GetStride());
+    EXPECT_EQ(32u, bitmap.GetDataSize());
+}
+
+TEST(BlockCompressionTest, DecodeBC4_KnownValues)
+{
+    // single block: endpoints 255 and 0, interpolated in 8-value mode
+    const uint8 block8[8] = { 255, 0, 0x88, 0xC6, 0xFA, 0x88, 0xC6, 0xFA };
+
+    // single block: endpoints 0 and 255, 6-value mode with explicit 0 and 1
+    const uint8 block6[8] = { 51, 204, 0x88, 0xC6, 0xFA, 0x88, 0xC6, 0xFA };
+
+    // indices are 0,1,2,...,7,0,1,2,...,7 (3 bits each)
+    const float expected8[8] = { 1.0f, 0.0f, 6.0f / 7.0f, 5.0f / 7.0f, 4.0f / 7.0f, 3.0f / 7.0f, 2.0f / 7.0f, 1.0f / 7.0f };
+    const float expected6[8] = { 0.2f, 0.8f, 0.32f, 0.44f, 0.56f, 0.68f, 0.0f, 1.0f };
+
+    for (uint32 mode = 0; mode < 2; ++mode)
+    {
+        SCOPED_TRACE("mode=" + std::to_string(mode));
+
+        Bitmap::InitData initData;
+        initData.width = 4;
+        initData.height = 4;
+        initData.format = Bitmap::Format::BC4;
+        initData.data = mode == 0 ? block8 : block6;
+
+        Bitmap bitmap;
+        ASSERT_TRUE(bitmap.Init(initData));
+
+        const float* expected = mode == 0 ? expected8 : expected6;
+        for (uint32 i = 0; i < 16; ++i)
+        {
+            SCOPED_TRACE("i=" + std::to_string(i));
+            const float value = expected[i % 8];
+            ExpectNearVector(Vec4f(value, value, value, 1.0f), bitmap.GetPixel(i % 4, i / 4));
+        }
+    }
+}
+
+TEST(BlockCompressionTest, NonMultipleOfFourDimensions)
+{
+    Random random;
+
+    for (const Bitmap::Format format : TestedFormats)
+    {
+        SCOPED_TRACE(Bitmap::FormatToString(format));
+
+        const uint32 sizes[][2] = { { 1, 1 }, { 3, 7 }, { 6, 5 }, { 9, 2 }, { 13, 11 } };
+        for (const auto& size : sizes)
+        {
+            SCOPED_TRACE("width=" + std::to_string(size[0]) + ", height=" + std::to_string(size[1]));
+
+            Bitmap bitmap;
+            ASSERT_TRUE(InitRandomBitmap(bitmap, size[0], size[1], format, random));
+            ValidateBitmap(bitmap);
+        }
+    }
+}
+
+TEST(BlockCompressionTest, GetPixelBlock)
+{
+    Random random;
+
+    for (const Bitmap::Format format : TestedFormats)
+    {
+        SCOPED_TRACE(Bitmap::FormatToString(format));
+
+        Bitmap bitmap;
+        ASSERT_TRUE(InitRandomBitmap(bitmap, 10, 7, format, random));
+
+        // all 2x2 neighborhoods, including ones crossing block borders and wrapping around the edges
+        for (uint32 y = 0; y < bitmap.GetHeight(); ++y)
+        {
+            for (uint32 x = 0; x < bitmap.GetWidth(); ++x)
+            {
+                SCOPED_TRACE("x=" + std::to_string(x) + ", y=" + std::to_string(y));
+
+                const uint32 x1 = (x + 1) % bitmap.GetWidth();
+                const uint32 y1 = (y + 1) % bitmap.GetHeight();
+
+                Vec4f colors[4];
+                bitmap.GetPixelBlock(Vec4ui(x, y, x1, y1), colors);
+
+                ExpectNearVector(bitmap.GetPixel(x, y), colors[0]);
+                ExpectNearVector(bitmap.GetPixel(x1, y), colors[1]);
+                ExpectNearVector(bitmap.GetPixel(x, y1), colors[2]);
+                ExpectNearVector(bitmap.GetPixel(x1, y1), colors[3]);
+            }
+        }
+    }
+}
+
+TEST(BlockCompressionTest, CacheCollisions)
+{
+    Random random;
+
+    // much more blocks than the per-thread cache can hold
+    Bitmap bitmap;
+    ASSERT_TRUE(InitRandomBitmap(bitmap, 64, 64, Bitmap::Format::BC4, random));
+
+    for (uint32 i = 0; i < 10000; ++i)
+    {
+        const uint32 x = random.GetInt() % bitmap.GetWidth();
+        const uint32 y = random.GetInt() % bitmap.GetHeight();
+
+        const Vec4f expected = DecodeReferenceTexel(bitmap.GetFormat(), bitmap.GetData(), x, y, bitmap.GetWidth());
+        const Vec4f actual = bitmap.GetPixel(x, y);
+        ASSERT_NEAR(expected.x, actual.x, 1.0e-5f) << "x=" << x << ", y=" << y;
+    }
+}
+
+TEST(BlockCompressionTest, CacheContentChange)
+{
+    Random random;
+
+    for (const Bitmap::Format format : TestedFormats)
+    {
+        SCOPED_TRACE(Bitmap::FormatToString(format));
+
+        Bitmap bitmap;
+        ASSERT_TRUE(InitRandomBitmap(bitmap, 4, 4, format, random));
+        ValidateBitmap(bitmap);
+
+        // cached blocks must not be returned after the data changes under the same address
+        uint8* data = bitmap.GetData();
+        for (size_t i = 0; i < bitmap.GetDataSize(); ++i)
+        {
+            data[i] = static_cast<uint8>(~data[i]);
+        }
+        ValidateBitmap(bitmap);
+
+        // identical blocks in different bitmaps (different formats) must not be mixed up
+        Bitmap otherBitmap;
+        ASSERT_TRUE(InitRandomBitmap(otherBitmap, 4, 4, format == Bitmap::Format::BC1 ? Bitmap::Format::BC4 : Bitmap::Format::BC1, random));
+        memcpy(otherBitmap.GetData(), data, otherBitmap.GetDataSize());
+        ValidateBitmap(otherBitmap);
+        ValidateBitmap(bitmap);
+    }
+}
+
+TEST(BlockCompressionTest, Multithreaded)
+{
+    const uint32 numThreads = 4;
+
+    Random random;
+    Bitmap bitmap;
+    ASSERT_TRUE(InitRandomBitmap(bitmap, 64, 64, Bitmap::Format::BC5, random));
+
+    // each thread has its own cache, so concurrent fetches must not interfere
+    std::atomic<uint32> numErrors(0);
+    std::vector<std::thread> threads;
+    for (uint32 i = 0; i < numThreads; ++i)
+    {
+        threads.emplace_back([&bitmap, &numErrors] ()
+        {
+            Random threadRandom;
+            for (uint32 j = 0; j < 10000; ++j)
+            {
+                const uint32 x = threadRandom.GetInt() % bitmap.GetWidth();
+                const uint32 y = threadRandom.GetInt() % bitmap.GetHeight();
+
+                const Vec4f expected = DecodeReferenceTexel(bitmap.GetFormat(), bitmap.GetData(), x, y, bitmap.GetWidth());
+                const Vec4f actual = bitmap.GetPixel(x, y);
+                if (Abs(expected.x - actual.x) > 1.0e-5f || Abs(expected.y - actual.y) > 1.0e-5f)
+                {
+                    numErrors++;
+                }
+            }
+        });
+    }
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(0u, numErrors.load());
+}
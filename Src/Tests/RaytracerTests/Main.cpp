@@ -1,14 +1,14 @@
 #include "PCH.h"
-#include "../Core/Math/Math.h"
+#include "Engine/Common/Math/Math.hpp"
 
 int main(int argc, char **argv)
 {
-    rt::math::SetFlushDenormalsToZero();
+    NFE::Math::SetFlushDenormalsToZero();
 
     testing::InitGoogleTest(&argc, argv);
     const int result = RUN_ALL_TESTS();
 
-    RT_ASSERT(rt::math::GetFlushDenormalsToZero(), "Something disabled flushing denormal float to zero");
+    NFE_ASSERT(NFE::Math::GetFlushDenormalsToZero(), "Something disabled flushing denormal float to zero");
 
     return result;
 }
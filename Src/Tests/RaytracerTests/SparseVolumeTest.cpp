@@ -0,0 +1,321 @@
+#include "PCH.h"
+#include "Engine/Raytracer/Utils/SparseVolume.h"
+#include "Engine/Common/Math/Random.hpp"
+
+using namespace NFE;
+using namespace NFE::RT;
+using namespace NFE::Math;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+// not a multiple of brick size, so partial bricks at the volume edges are tested
+const uint32 TestVolumeWidth = 20;
+const uint32 TestVolumeHeight = 12;
+const uint32 TestVolumeDepth = 9;
+
+// create dense R32_Float volume with only some of the bricks filled with random values
+bool InitTestBitmap(Bitmap& bitmap, Random& random, float background)
+{
+    Bitmap::InitData initData;
+    initData.width = TestVolumeWidth;
+    initData.height = TestVolumeHeight;
+    initData.depth = TestVolumeDepth;
+    initData.format = Bitmap::Format::R32_Float;
+
+    if (!bitmap.Init(initData))
+    {
+        return false;
+    }
+
+    for (uint32 z = 0; z < TestVolumeDepth; ++z)
+    {
+        for (uint32 y = 0; y < TestVolumeHeight; ++y)
+        {
+            float* row = reinterpret_cast<float*>(bitmap.GetData() + bitmap.GetStride() * (y + TestVolumeHeight * z));
+            for (uint32 x = 0; x < TestVolumeWidth; ++x)
+            {
+                const uint32 bx = x / SparseVolume::BrickSize;
+                const uint32 by = y / SparseVolume::BrickSize;
+                const uint32 bz = z / SparseVolume::BrickSize;
+
+                // checkerboard of empty and non-empty bricks
+                row[x] = ((bx + by + bz) % 2 == 0) ? random.GetFloat() : background;
+            }
+        }
+    }
+
+    return true;
+}
+
+// number of bricks set by InitTestBitmap
+uint32 GetNumNonEmptyTestBricks()
+{
+    uint32 num = 0;
+    for (uint32 bz = 0; bz < 2; ++bz)
+    {
+        for (uint32 by = 0; by < 2; ++by)
+        {
+            for (uint32 bx = 0; bx < 3; ++bx)
+            {
+                num += (bx + by + bz) % 2 == 0;
+            }
+        }
+    }
+    return num;
+}
+
+// reference trilinear filtering with coordinates wrapping
+float SampleTrilinearReference(const SparseVolume& volume, const Vec4f& coords)
+{
+    const auto wrap = [](int32 coord, uint32 size)
+    {
+        const int32 wrapped = coord % static_cast<int32>(size);
+        return static_cast<uint32>(wrapped < 0 ? wrapped + static_cast<int32>(size) : wrapped);
+    };
+
+    const float fx = floorf(coords.x);
+    const float fy = floorf(coords.y);
+    const float fz = floorf(coords.z);
+    const int32 ix = static_cast<int32>(fx);
+    const int32 iy = static_cast<int32>(fy);
+    const int32 iz = static_cast<int32>(fz);
+
+    float result = 0.0f;
+    for (uint32 i = 0; i < 8; ++i)
+    {
+        const uint32 dx = i & 1u;
+        const uint32 dy = (i >> 1u) & 1u;
+        const uint32 dz = (i >> 2u) & 1u;
+
+        const float weight =
+            (dx ? coords.x - fx : 1.0f - (coords.x - fx)) *
+            (dy ? coords.y - fy : 1.0f - (coords.y - fy)) *
+            (dz ? coords.z - fz : 1.0f - (coords.z - fz));
+
+        result += weight * volume.GetVoxel(wrap(ix + dx, volume.GetWidth()), wrap(iy + dy, volume.GetHeight()), wrap(iz + dz, volume.GetDepth()));
+    }
+
+    return result;
+}
+
+} // namespace
+
+TEST(SparseVolumeTest, Empty)
+{
+    SparseVolume volume;
+
+    EXPECT_EQ(0u, volume.GetWidth());
+    EXPECT_EQ(0u, volume.GetHeight());
+    EXPECT_EQ(0u, volume.GetDepth());
+    EXPECT_EQ(0u, volume.GetNumAllocatedBricks());
+    EXPECT_EQ(0u, volume.GetNumTotalBricks());
+    EXPECT_EQ(0u, volume.GetMemorySize());
+
+    // sampling uninitialized volume must not crash
+    EXPECT_EQ(0.0f, volume.SampleTrilinear(Vec4f(0.0f)));
+    EXPECT_EQ(0.0f, volume.SampleTrilinear(Vec4f(1.5f, -2.5f, 3.25f)));
+}
+
+TEST(SparseVolumeTest, LoadFailure)
+{
+    SparseVolume volume;
+
+    EXPECT_FALSE(volume.Load("non_existing_file.vdb"));
+    EXPECT_EQ(0u, volume.GetNumTotalBricks());
+    EXPECT_EQ(0.0f, volume.SampleTrilinear(Vec4f(1.5f, 2.5f, 3.5f)));
+}
+
+TEST(SparseVolumeTest, InvalidInit)
+{
+    SparseVolume volume;
+
+    SparseVolume::InitData initData;
+    initData.width = 0;
+    initData.height = 4;
+    initData.depth = 4;
+    EXPECT_FALSE(volume.Init(initData));
+
+    initData.width = 4;
+    initData.format = Bitmap::Format::B8G8R8A8_UNorm;
+    EXPECT_FALSE(volume.Init(initData));
+
+    initData.format = Bitmap::Format::R16_Half;
+    EXPECT_TRUE(volume.Init(initData));
+    EXPECT_EQ(1u, volume.GetNumTotalBricks());
+}
+
+TEST(SparseVolumeTest, SetVoxel)
+{
+    SparseVolume volume;
+
+    SparseVolume::InitData initData;
+    initData.width = TestVolumeWidth;
+    initData.height = TestVolumeHeight;
+    initData.depth = TestVolumeDepth;
+    initData.format = Bitmap::Format::R32_Float;
+    initData.background = 0.25f;
+    ASSERT_TRUE(volume.Init(initData));
+
+    EXPECT_EQ(12u, volume.GetNumTotalBricks());
+    EXPECT_EQ(0u, volume.GetNumAllocatedBricks());
+    EXPECT_EQ(0.25f, volume.GetVoxel(19, 11, 8));
+
+    // setting background value does not allocate a brick
+    volume.SetVoxel(1, 2, 3, 0.25f);
+    EXPECT_EQ(0u, volume.GetNumAllocatedBricks());
+
+    volume.SetVoxel(1, 2, 3, 0.5f);
+    volume.SetVoxel(7, 7, 7, 0.75f);
+    EXPECT_EQ(1u, volume.GetNumAllocatedBricks());
+
+    volume.SetVoxel(19, 11, 8, 2.0f);
+    EXPECT_EQ(2u, volume.GetNumAllocatedBricks());
+
+    EXPECT_EQ(0.5f, volume.GetVoxel(1, 2, 3));
+    EXPECT_EQ(0.75f, volume.GetVoxel(7, 7, 7));
+    EXPECT_EQ(2.0f, volume.GetVoxel(19, 11, 8));
+    EXPECT_EQ(2.0f, volume.GetMaxValue());
+
+    // other voxels in allocated bricks keep the background value
+    EXPECT_EQ(0.25f, volume.GetVoxel(0, 0, 0));
+    EXPECT_EQ(0.25f, volume.GetVoxel(16, 8, 8));
+}
+
+TEST(SparseVolumeTest, DenseToSparse)
+{
+    Random random;
+
+    const float background = 0.0f;
+    Bitmap bitmap;
+    ASSERT_TRUE(InitTestBitmap(bitmap, random, background));
+
+    const Bitmap::Format formats[] = { Bitmap::Format::R32_Float, Bitmap::Format::R16_Half, Bitmap::Format::R8_UNorm };
+    const float maxErrors[] = { 0.0f, 0.0005f, 0.5f / 255.0f };
+
+    for (uint32 i = 0; i < 3; ++i)
+    {
+        SCOPED_TRACE(Bitmap::FormatToString(formats[i]));
+
+        SparseVolume::ConversionParams params;
+        params.format = formats[i];
+        params.background = background;
+
+        SparseVolume volume;
+        ASSERT_TRUE(volume.InitFromBitmap(bitmap, params));
+
+        EXPECT_EQ(TestVolumeWidth, volume.GetWidth());
+        EXPECT_EQ(TestVolumeHeight, volume.GetHeight());
+        EXPECT_EQ(TestVolumeDepth, volume.GetDepth());
+        EXPECT_EQ(formats[i], volume.GetFormat());
+
+        // bricks containing only background value are not allocated
+        EXPECT_EQ(12u, volume.GetNumTotalBricks());
+        EXPECT_EQ(GetNumNonEmptyTestBricks(), volume.GetNumAllocatedBricks());
+
+        for (uint32 z = 0; z < TestVolumeDepth; ++z)
+        {
+            for (uint32 y = 0; y < TestVolumeHeight; ++y)
+            {
+                for (uint32 x = 0; x < TestVolumeWidth; ++x)
+                {
+                    ASSERT_NEAR(bitmap.GetPixel3D(x, y, z).x, volume.GetVoxel(x, y, z), maxErrors[i]) << "x=" << x << ", y=" << y << ", z=" << z;
+                }
+            }
+        }
+    }
+}
+
+TEST(SparseVolumeTest, EmptyBricks)
+{
+    Random random;
+
+    // all voxels set to background
+    {
+        Bitmap bitmap;
+        ASSERT_TRUE(InitTestBitmap(bitmap, random, 0.5f));
+        memset(bitmap.GetData(), 0, bitmap.GetDataSize());
+
+        SparseVolume::ConversionParams params;
+        SparseVolume volume;
+        ASSERT_TRUE(volume.InitFromBitmap(bitmap, params));
+
+        EXPECT_EQ(12u, volume.GetNumTotalBricks());
+        EXPECT_EQ(0u, volume.GetNumAllocatedBricks());
+        EXPECT_EQ(0.0f, volume.GetVoxel(5, 6, 7));
+        EXPECT_EQ(0.0f, volume.SampleTrilinear(Vec4f(5.5f, 6.5f, 7.5f)));
+    }
+
+    // values within tolerance from background are skipped
+    {
+        Bitmap bitmap;
+        ASSERT_TRUE(InitTestBitmap(bitmap, random, 0.5f));
+
+        // slightly disturb background values
+        float* data = reinterpret_cast<float*>(bitmap.GetData());
+        for (size_t i = 0; i < bitmap.GetDataSize() / sizeof(float); ++i)
+        {
+            if (data[i] == 0.5f)
+            {
+                data[i] += 0.01f * random.GetFloatBipolar();
+            }
+        }
+
+        SparseVolume::ConversionParams params;
+        params.background = 0.5f;
+        params.tolerance = 0.01f;
+
+        SparseVolume volume;
+        ASSERT_TRUE(volume.InitFromBitmap(bitmap, params));
+        EXPECT_EQ(GetNumNonEmptyTestBricks(), volume.GetNumAllocatedBricks());
+        EXPECT_EQ(0.5f, volume.GetVoxel(8, 0, 0));
+    }
+}
+
+TEST(SparseVolumeTest, SampleTrilinear)
+{
+    Random random;
+
+    Bitmap bitmap;
+    ASSERT_TRUE(InitTestBitmap(bitmap, random, 0.0f));
+
+    SparseVolume::ConversionParams params;
+    SparseVolume volume;
+    ASSERT_TRUE(volume.InitFromBitmap(bitmap, params));
+
+    const float maxError = 1.0e-5f;
+
+    // exactly at voxel corners
+    EXPECT_NEAR(volume.GetVoxel(3, 4, 5), volume.SampleTrilinear(Vec4f(3.0f, 4.0f, 5.0f)), maxError);
+    EXPECT_NEAR(volume.GetVoxel(8, 0, 0), volume.SampleTrilinear(Vec4f(8.0f, 0.0f, 0.0f)), maxError);
+
+    // across brick borders (in all directions at once)
+    {
+        const Vec4f coords(7.5f, 7.25f, 7.75f);
+        EXPECT_NEAR(SampleTrilinearReference(volume, coords), volume.SampleTrilinear(coords), maxError);
+    }
+
+    // at the wrap edge (last and first voxel are blended)
+    {
+        const Vec4f coords(TestVolumeWidth - 0.5f, TestVolumeHeight - 0.25f, TestVolumeDepth - 0.75f);
+        const float expected = SampleTrilinearReference(volume, coords);
+        EXPECT_NEAR(expected, volume.SampleTrilinear(coords), maxError);
+
+        const float expectedX = Lerp(volume.GetVoxel(TestVolumeWidth - 1, 0, 0), volume.GetVoxel(0, 0, 0), 0.5f);
+        EXPECT_NEAR(expectedX, volume.SampleTrilinear(Vec4f(TestVolumeWidth - 0.5f, 0.0f, 0.0f)), maxError);
+    }
+
+    // negative and out of range coordinates are wrapped
+    {
+        const Vec4f coords(-0.5f, -12.25f, 2.0f * TestVolumeDepth + 1.5f);
+        EXPECT_NEAR(SampleTrilinearReference(volume, coords), volume.SampleTrilinear(coords), maxError);
+    }
+
+    for (uint32 i = 0; i < 1000; ++i)
+    {
+        const Vec4f coords = random.GetVec4f() * volume.GetFloatSize();
+        ASSERT_NEAR(SampleTrilinearReference(volume, coords), volume.SampleTrilinear(coords), maxError)
+            << "coords=" << coords.x << "," << coords.y << "," << coords.z;
+    }
+}
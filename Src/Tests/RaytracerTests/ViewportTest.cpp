@@ -0,0 +1,252 @@
+#include "PCH.h"
+#include "Engine/Raytracer/Rendering/Viewport.h"
+#include "Engine/Raytracer/Rendering/Renderer.h"
+#include "Engine/Raytracer/Rendering/Film.h"
+#include "Engine/Raytracer/Scene/Scene.h"
+#include "Engine/Raytracer/Scene/Camera.h"
+#include "Engine/Common/Utils/CancellationToken.hpp"
+#include "Engine/Common/Math/Random.hpp"
+
+using namespace NFE;
+using namespace NFE::RT;
+using namespace NFE::Math;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+// Renders grayscale noise that depends only on the ray direction and the pass index,
+// so the result does not depend on how tiles are distributed between threads.
+class NoiseRenderer : public IRenderer
+{
+public:
+    virtual const RayColor RenderPixel(const Ray& ray, const RenderParam& param, RenderingContext& ctx) const override
+    {
+        NFE_UNUSED(ctx);
+
+        uint32 bits[3];
+        memcpy(bits, &ray.dir, sizeof(bits));
+
+        uint32 hash = param.iteration * 0x9E3779B9u;
+        for (uint32 i = 0; i < 3; ++i)
+        {
+            hash = (hash ^ bits[i]) * 0x85EBCA6Bu;
+            hash ^= hash >> 13u;
+        }
+
+        // values in [0.5, 1.5) range
+        return RayColor(0.5f + static_cast<float>(hash >> 8u) / 16777216.0f);
+    }
+};
+
+// Cancels the rendering pass after given number of pixels were rendered.
+class CancellingRenderer : public NoiseRenderer
+{
+public:
+    CancellingRenderer(Common::CancellationToken& token, uint32 numPixels)
+        : mToken(token)
+        , mPixelsLeft(numPixels)
+    { }
+
+    virtual const RayColor RenderPixel(const Ray& ray, const RenderParam& param, RenderingContext& ctx) const override
+    {
+        if (mPixelsLeft.fetch_sub(1) <= 1)
+        {
+            mToken.Cancel();
+        }
+
+        return NoiseRenderer::RenderPixel(ray, param, ctx);
+    }
+
+private:
+    Common::CancellationToken& mToken;
+    mutable std::atomic<int32> mPixelsLeft;
+};
+
+// Renders constant color and splats one sample to the top-left pixel in every pass.
+class SplattingRenderer : public CancellingRenderer
+{
+public:
+    using CancellingRenderer::CancellingRenderer;
+
+    virtual void PreRender(Common::TaskBuilder& builder, const RenderParam& param, Common::ArrayView<RenderingContext> contexts) override
+    {
+        NFE_UNUSED(builder);
+        NFE_UNUSED(contexts);
+
+        const float height = static_cast<float>(param.film.GetHeight());
+        Random randomGenerator;
+        param.film.AccumulateColor(Vec4f(0.0f, (height - 1.0f) / height), Vec4f(1.0f), randomGenerator);
+    }
+
+    virtual const RayColor RenderPixel(const Ray& ray, const RenderParam& param, RenderingContext& ctx) const override
+    {
+        CancellingRenderer::RenderPixel(ray, param, ctx);
+        return RayColor(0.5f);
+    }
+};
+
+const uint32 TestViewportWidth = 67;
+const uint32 TestViewportHeight = 45;
+
+void InitViewport(Viewport& viewport, IRenderer& renderer, bool compactAccumulation)
+{
+    RenderingParams params;
+    params.compactAccumulation = compactAccumulation;
+    params.antiAliasingSpread = 0.0f;
+    params.motionBlurStrength = 0.0f;
+    params.tileSize = 16;
+
+    ASSERT_TRUE(viewport.SetRenderer(&renderer));
+    ASSERT_TRUE(viewport.SetRenderingParams(params));
+    ASSERT_TRUE(viewport.Resize(TestViewportWidth, TestViewportHeight));
+}
+
+} // namespace
+
+TEST(ViewportTest, CompactAccumulationError)
+{
+    NoiseRenderer renderer;
+    Scene scene;
+    Camera camera;
+    camera.SetPerspective(static_cast<float>(TestViewportWidth) / static_cast<float>(TestViewportHeight), DegToRad(60.0f));
+
+    Viewport floatViewport;
+    InitViewport(floatViewport, renderer, false);
+    EXPECT_EQ(TestViewportWidth * TestViewportHeight * sizeof(Vec3f), floatViewport.GetMemoryStats().secondarySum);
+
+    Viewport compactViewport;
+    InitViewport(compactViewport, renderer, true);
+    EXPECT_EQ(TestViewportWidth * TestViewportHeight * sizeof(Half3), compactViewport.GetMemoryStats().secondarySum);
+
+    for (uint32 pass = 1; pass <= 8; ++pass)
+    {
+        SCOPED_TRACE("pass=" + std::to_string(pass));
+
+        ASSERT_TRUE(floatViewport.Render(scene, camera));
+        ASSERT_TRUE(compactViewport.Render(scene, camera));
+
+        // the error is estimated after every even pass
+        if (pass % 2 == 0)
+        {
+            const float floatError = floatViewport.GetProgress().averageError;
+            const float compactError = compactViewport.GetProgress().averageError;
+
+            EXPECT_GT(floatError, 0.0f);
+            EXPECT_LT(floatError, 1.0f);
+
+            // compact mode stores the difference in half precision
+            EXPECT_NEAR(floatError, compactError, 0.001f * floatError);
+        }
+    }
+}
+
+TEST(ViewportTest, CancelledPass)
+{
+    Scene scene;
+    Camera camera;
+    camera.SetPerspective(static_cast<float>(TestViewportWidth) / static_cast<float>(TestViewportHeight), DegToRad(60.0f));
+
+    for (const bool compactAccumulation : { false, true })
+    {
+        SCOPED_TRACE(compactAccumulation ? "compact" : "float");
+
+        NoiseRenderer renderer;
+        Viewport viewport;
+        InitViewport(viewport, renderer, compactAccumulation);
+
+        ASSERT_TRUE(viewport.Render(scene, camera));
+        ASSERT_TRUE(viewport.Render(scene, camera));
+
+        const Bitmap& sum = viewport.GetSumBuffer();
+        std::vector<Vec3f> sumBefore;
+        for (uint32 y = 0; y < TestViewportHeight; ++y)
+        {
+            for (uint32 x = 0; x < TestViewportWidth; ++x)
+            {
+                sumBefore.push_back(sum.GetPixelRef<Vec3f>(x, y));
+            }
+        }
+
+        // cancel in the middle of the pass
+        {
+            Common::CancellationToken token;
+            CancellingRenderer cancellingRenderer(token, TestViewportWidth * TestViewportHeight / 2);
+            ASSERT_TRUE(viewport.SetRenderer(&cancellingRenderer));
+            EXPECT_FALSE(viewport.Render(scene, camera, &token));
+            ASSERT_TRUE(viewport.SetRenderer(&renderer));
+        }
+
+        // the accumulated samples are kept, some of the pixels received one more sample
+        uint32 numPixelsRendered = 0;
+        for (uint32 y = 0; y < TestViewportHeight; ++y)
+        {
+            for (uint32 x = 0; x < TestViewportWidth; ++x)
+            {
+                const float before = sumBefore[TestViewportWidth * y + x].x;
+                const float after = sum.GetPixelRef<Vec3f>(x, y).x;
+                if (after != before)
+                {
+                    EXPECT_GE(after, before + 0.5f);
+                    numPixelsRendered++;
+                }
+            }
+        }
+        EXPECT_GT(numPixelsRendered, 0u);
+        EXPECT_LT(numPixelsRendered, TestViewportWidth * TestViewportHeight);
+
+        // rendering can be continued
+        ASSERT_TRUE(viewport.Render(scene, camera));
+        EXPECT_EQ(4u, viewport.GetProgress().passesFinished);
+        EXPECT_GT(viewport.GetProgress().averageError, 0.0f);
+        EXPECT_LT(viewport.GetProgress().averageError, 1.0f);
+
+        // each pixel is normalized by its own number of samples, so the image is not darkened
+        const Bitmap& frontBuffer = viewport.GetFrontBuffer();
+        for (uint32 y = 0; y < TestViewportHeight; ++y)
+        {
+            for (uint32 x = 0; x < TestViewportWidth; ++x)
+            {
+                ASSERT_NE(0u, frontBuffer.GetPixelRef<uint32>(x, y) & 0xFFFFFFu);
+            }
+        }
+    }
+}
+
+TEST(ViewportTest, CancelledPassWithSplatting)
+{
+    Scene scene;
+    Camera camera;
+    camera.SetPerspective(static_cast<float>(TestViewportWidth) / static_cast<float>(TestViewportHeight), DegToRad(60.0f));
+
+    Common::CancellationToken token;
+    SplattingRenderer renderer(token, 3 * TestViewportWidth * TestViewportHeight - 100);
+
+    Viewport viewport;
+    InitViewport(viewport, renderer, false);
+
+    ASSERT_TRUE(viewport.Render(scene, camera, &token));
+    ASSERT_TRUE(viewport.Render(scene, camera, &token));
+
+    // splats of the partial pass can't be normalized per pixel, so the accumulation is discarded
+    EXPECT_FALSE(viewport.Render(scene, camera, &token));
+    EXPECT_EQ(0u, viewport.GetProgress().passesFinished);
+
+    token.Reset();
+    SplattingRenderer nonCancellingRenderer(token, 1u << 30u);
+    ASSERT_TRUE(viewport.SetRenderer(&nonCancellingRenderer));
+    ASSERT_TRUE(viewport.Render(scene, camera, &token));
+    ASSERT_TRUE(viewport.Render(scene, camera, &token));
+    ASSERT_EQ(2u, viewport.GetProgress().passesFinished);
+
+    // each pixel has exactly two samples and the splatted pixel has two splats
+    const Bitmap& sum = viewport.GetSumBuffer();
+    for (uint32 y = 0; y < TestViewportHeight; ++y)
+    {
+        for (uint32 x = 0; x < TestViewportWidth; ++x)
+        {
+            const float expected = (x == 0 && y == 0) ? 3.0f : 1.0f;
+            ASSERT_EQ(expected, sum.GetPixelRef<Vec3f>(x, y).x) << "x=" << x << " y=" << y;
+        }
+    }
+}